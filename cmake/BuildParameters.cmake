@@ -29,6 +29,11 @@ if(DISABLE_BUILD_DATE OR openSUSE)
 endif()
 
 option(USE_VTUNE "Plug VTUNE to profile GSdx JIT.")
+option(ENABLE_TRACE "Keep the trace logs in release builds (for binary traces)")
+
+if(ENABLE_TRACE)
+    add_definitions(-DPCSX2_TRACE)
+endif()
 
 #-------------------------------------------------------------------------------
 # Graphical option
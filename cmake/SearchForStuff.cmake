@@ -107,6 +107,10 @@ if(OPENCL_API)
 endif()
 check_lib(PORTAUDIO portaudio portaudio.h pa_linux_alsa.h)
 check_lib(SOUNDTOUCH SoundTouch soundtouch/SoundTouch.h)
+# Optional, enables the seekable zstd iso reader/writer
+check_lib(ZSTD zstd zstd.h)
+# Optional, enables booting images from http servers (HttpFileReader)
+check_lib(CURL libcurl curl/curl.h)
 
 if(SDL2_API)
     check_lib(SDL2 SDL2 SDL.h PATH_SUFFIXES SDL2)
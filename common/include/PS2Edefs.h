@@ -55,6 +55,13 @@
 #define FREEZE_SAVE 1
 #define FREEZE_SIZE 2
 
+// Incremental save/load (GS only): the buffer is the one of the plugin's last incremental
+// save or load, and the caller left it untouched since, so the plugin may only write (or
+// read back) what changed.  Returns 1 if the mode was handled, plugins that don't know it
+// return 0 and the caller must then use the plain FREEZE_SAVE/FREEZE_LOAD.
+#define FREEZE_SAVE_INCREMENTAL 3
+#define FREEZE_LOAD_INCREMENTAL 4
+
 // event values:
 #define KEYPRESS 1
 #define KEYRELEASE 2
@@ -357,6 +364,14 @@ void CALLBACK SPU2irqCallback(void (*SPU2callback)(), void (*DMA4callback)(), vo
 // for now, pData is not used
 int CALLBACK SPU2setupRecording(int start, void *pData);
 
+// if enable is non zero, output is muted (emulation keeps running unthrottled)
+// called once per frame, so it needs to be cheap when nothing changes
+void CALLBACK SPU2setFastForward(int enable);
+
+// if mute is non zero, the mixed output is dropped, and a state load keeps the output
+// buffer playing (used for frames that are emulated, then rolled back)
+void CALLBACK SPU2setMute(int mute);
+
 void CALLBACK SPU2setClockPtr(u32 *ptr);
 void CALLBACK SPU2setTimeStretcher(short int enable);
 
@@ -537,6 +552,7 @@ typedef void(CALLBACK *_PS2EsetEmuVersion)(const char *emuId, u32 version); // H
 typedef void(CALLBACK *_GSosdLog)(const char *utf8, u32 color);
 typedef void(CALLBACK *_GSosdMonitor)(const char *key, const char *value, u32 color);
 typedef s32(CALLBACK *_GSopen)(void *pDsp, const char *Title, int multithread);
+// flags: 1 multithreaded, 4 renderer switch, 8 no window in pDsp (headless)
 typedef s32(CALLBACK *_GSopen2)(void *pDsp, u32 flags);
 typedef void(CALLBACK *_GSvsync)(int field);
 typedef void(CALLBACK *_GSgifTransfer)(const u32 *pMem, u32 size);
@@ -593,6 +609,8 @@ typedef u32(CALLBACK *_SPU2ReadMemAddr)(int core);
 typedef void(CALLBACK *_SPU2WriteMemAddr)(int core, u32 value);
 
 typedef int(CALLBACK *_SPU2setupRecording)(int, void *);
+typedef void(CALLBACK *_SPU2setFastForward)(int enable);
+typedef void(CALLBACK *_SPU2setMute)(int mute);
 
 typedef void(CALLBACK *_SPU2setClockPtr)(u32 *ptr);
 typedef void(CALLBACK *_SPU2setTimeStretcher)(short int enable);
@@ -742,6 +760,8 @@ extern _SPU2irqCallback SPU2irqCallback;
 extern _SPU2irqCallback SPU2irqCallback;
 
 extern _SPU2setupRecording SPU2setupRecording;
+extern _SPU2setFastForward SPU2setFastForward;
+extern _SPU2setMute SPU2setMute;
 
 extern _SPU2setClockPtr SPU2setClockPtr;
 extern _SPU2setTimeStretcher SPU2setTimeStretcher;
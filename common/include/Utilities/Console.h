@@ -238,6 +238,14 @@ extern void Console_SetStdout(FILE *fp);
 #endif
 extern void Console_SetActiveHandler(const IConsoleWriter &writer, FILE *flushfp = NULL);
 
+// Queues console writes of threads other than the main thread, and forwards them to the
+// active handler from a background thread.  Main thread only.
+extern void Console_SetAsync(bool enabled);
+
+// Limits each WriteLn/Error/Warning call site (by format string) to this many messages per
+// second on every thread but the main thread.  0 disables the limit.
+extern void Console_SetRateLimit(uint perSecond);
+
 extern const IConsoleWriter ConsoleWriter_Null;
 extern const IConsoleWriter ConsoleWriter_Stdout;
 extern const IConsoleWriter ConsoleWriter_Assert;
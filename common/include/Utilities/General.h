@@ -246,6 +246,20 @@ extern void Munmap(uptr base, size_t size);
 
 extern void MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mode);
 
+// Asks the OS to back a committed block with large (2mb) pages.  Returns false if the host
+// can't do it, in which case the block keeps its normal pages; it works the same either way.
+extern bool MmapAdviseLargePages(void *base, size_t size);
+
+// Maps the first size bytes of a file over a committed block, copy-on-write: the pages are
+// shared with every other process mapping the same file until they are written to.  size
+// must be a multiple of the page size and no larger than the file.  Returns false (leaving
+// the block as it was) if the host can't do it.
+extern bool MmapFilePrivatePtr(void *base, size_t size, const wxString &filename);
+
+// Bytes of the block that are resident in physical memory (pages shared with other processes
+// included), or -1 if the host can't tell.
+extern s64 GetResidentBytes(const void *base, size_t size);
+
 extern void Munmap(void *base, size_t size);
 
 template <uint size>
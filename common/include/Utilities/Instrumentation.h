@@ -0,0 +1,173 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+
+// --------------------------------------------------------------------------------------
+//  Instrumentation
+// --------------------------------------------------------------------------------------
+// Counters and scoped timers for the emulator's hot paths, published in a shared memory
+// segment so that an external tool can watch a running instance without pausing it.
+//
+// The segment is per process, named "pcsx2-instr-<pid>" (a POSIX shm object, or a
+// "Local\" file mapping on Windows).  The emulator creates it with Create(); plugins link
+// their own copy of Utilities and map the same segment with Attach(), so every module
+// writes to the same slots.  With no segment mapped, every counter is a null check.
+//
+// Layout (SharedSegment): a header, one Slot of running totals per Counter, then a ring of
+// Snapshot records.  Publish() is called once per vsync by the emulator and copies the
+// totals into the next record.  All 64-bit fields sit at 8-byte offsets, so 32 and 64-bit
+// readers agree on the layout.
+//
+// Reading the ring (seqlock): take n = ringWrite - 1, copy ring[n % ringSize], and keep the
+// copy only if its seq was 2n+2 both before and after copying.  An odd seq means that the
+// record is being written.  Tick counts are in units of header.tickFrequency.
+//
+namespace Instrumentation
+{
+    enum Counter
+    {
+        Counter_EERecCompile = 0, // ticks spent compiling EE blocks (events = blocks)
+        Counter_MTGSStall,        // ticks spent waiting for room in (or for) the MTGS ring
+        Counter_MTVUWait,         // ticks the EE spent waiting for the VU1 thread
+        Counter_VifUnpackBytes,   // bytes of VIF unpack data (events = unpacks)
+        Counter_CdvdRead,         // ticks spent in CDVD reads (events = sector reads)
+        Counter_SPU2Mix,          // ticks spent mixing SPU2 output
+        Counter_EEEventTest,      // EE events dispatched (events = event tests)
+        Counter_PatchWrite,       // memory writes made by patches (events = patch lines applied)
+        Counter_IopHleCall,       // bytes handled by the native IOP sysclib functions (events = calls)
+        Counter_InputToVsync,     // ticks from a changed pad reply to the next vsync (events = changes)
+        Counter_InputToPresent,   // ticks from a changed pad reply until the GS finished that vsync
+        Counter_VsyncToPresent,   // ticks from each vsync until the GS finished it (events = frames)
+        Counter_ConsoleWrite,     // ticks spent formatting and writing console lines (events = lines)
+        Counter_ConsoleDropped,   // console lines suppressed by the rate limit or a full queue (events)
+        Counter_VUFlagInsts,      // flag instances updated by recompiled VU code (events = instructions)
+        Counter_FramePace100us,   // limited frames within 0.1 ms of the target length (total = deviation ticks)
+        Counter_FramePace500us,   // ... within 0.5 ms
+        Counter_FramePace1ms,     // ... within 1 ms
+        Counter_FramePace2ms,     // ... within 2 ms
+        Counter_FramePaceOver,    // ... off by 2 ms or more
+        Counter_FrameLimitSpin,   // ticks the frame limiter spun after sleeping (events = frames)
+        Counter_FrameLimitLate,   // ticks the frame limiter's sleep overshot the target (events = oversleeps)
+        Counter_RunAheadSave,     // ticks spent saving the run-ahead state (events = saves)
+        Counter_RunAheadLoad,     // ticks spent rolling back to it (events = rollbacks)
+        Counter_StartupToFrame,   // ticks from the app init to the first vsync (once)
+        Counter_MFIFOWait,        // event tests saved by waiting for SPR0 on an empty GIF MFIFO (events = waits)
+        Counter_EEThreadTime,     // cpu ticks used by the EE thread, added at each vsync (events = frames)
+        Counter_MTGSThreadTime,   // ... by the MTGS thread (GS plugin included)
+        Counter_MTVUThreadTime,   // ... by the VU1 thread, when it runs
+        Counter_MTGSQueueBytes,   // bytes queued in the MTGS ring, sampled at each vsync (events = vsyncs)
+        Counter_Count
+    };
+
+    static const u32 SharedMagic = 0x52534e49; // 'INSR'
+    static const u32 SharedVersion = 1;
+    static const u32 RingSize = 256;           // power of two
+    static const u32 CounterNameSize = 24;
+
+    struct Slot
+    {
+        std::atomic<u64> events;
+        std::atomic<u64> total;
+    };
+
+    struct SharedHeader
+    {
+        u32 magic;                 // written last, once the rest of the header is valid
+        u32 version;
+        u32 counterCount;
+        u32 ringSize;
+        u64 tickFrequency;
+        u32 pid;
+        u32 reserved;
+        char names[Counter_Count][CounterNameSize];
+        std::atomic<u64> ringWrite; // number of snapshots published so far
+    };
+
+    struct Snapshot
+    {
+        std::atomic<u64> seq;
+        u64 ticks;                 // when the snapshot was taken
+        u64 frame;
+        u64 events[Counter_Count];
+        u64 total[Counter_Count];
+    };
+
+    struct SharedSegment
+    {
+        SharedHeader header;
+        Slot slots[Counter_Count];
+        Snapshot ring[RingSize];
+    };
+
+    // Slots of the mapped segment, or NULL.
+    extern Slot *g_slots;
+
+    // Creates (and owns) the segment of this process.  Returns false if it could not be created.
+    extern bool Create();
+
+    // Maps the segment created by the emulator, if there is one.  Used by plugins; may be
+    // called again to pick up a segment that was recreated.
+    extern bool Attach();
+
+    // Unmaps the segment (and removes it, if this module created it).  No counter may be
+    // updated concurrently.
+    extern void Close();
+
+    // Appends a snapshot of all the counters to the ring.  Owner only; single writer.
+    extern void Publish(u64 frame);
+
+    // High resolution timestamp, in units of tickFrequency.
+    extern u64 GetTicks();
+    extern u64 GetFrequency();
+
+    __fi bool IsEnabled()
+    {
+        return g_slots != NULL;
+    }
+
+    __fi void Add(Counter counter, u64 amount, u32 events = 1)
+    {
+        if (Slot *slots = g_slots) {
+            slots[counter].events.fetch_add(events, std::memory_order_relaxed);
+            slots[counter].total.fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    // Adds the time spent in the enclosing scope to a counter.
+    class ScopedTimer
+    {
+    protected:
+        Counter m_counter;
+        u32 m_events;
+        u64 m_start;
+
+    public:
+        ScopedTimer(Counter counter, u32 events = 1)
+            : m_counter(counter)
+            , m_events(events)
+            , m_start(IsEnabled() ? GetTicks() : 0)
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            if (m_start)
+                Add(m_counter, GetTicks() - m_start, m_events);
+        }
+    };
+}
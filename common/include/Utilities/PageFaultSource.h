@@ -155,6 +155,12 @@ protected:
     // as well.
     bool m_allow_writes;
 
+    // Request large pages when committing (see HostSys::MmapAdviseLargePages).
+    bool m_large_pages;
+
+    // Outcome of the last large page request (-1: none yet), so that it's logged on changes only.
+    int m_large_pages_result;
+
 public:
     VirtualMemoryReserve(const wxString &name = wxEmptyString, size_t size = 0);
     virtual ~VirtualMemoryReserve()
@@ -192,6 +198,7 @@ public:
     VirtualMemoryReserve &SetName(const wxString &newname);
     VirtualMemoryReserve &SetBaseAddr(uptr newaddr);
     VirtualMemoryReserve &SetPageAccessOnCommit(const PageProtectionMode &mode);
+    VirtualMemoryReserve &SetLargePages(bool enabled);
 
     operator void *() { return m_baseptr; }
     operator const void *() const { return m_baseptr; }
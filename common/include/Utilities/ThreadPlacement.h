@@ -0,0 +1,50 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Threading.h"
+
+namespace Threading
+{
+// --------------------------------------------------------------------------------------
+//  Thread placement
+// --------------------------------------------------------------------------------------
+// Which host cpus the named emulator threads (EE Core, MTGS, MTVU...) run on and at which
+// priority, for hosts where the scheduler places them badly: EE and VU threads on the SMT
+// siblings of one core, or migrating between sockets.  pxThread applies the placement of its
+// name when it starts and reports where the thread actually ended up.
+//
+// A spec is a ';' separated list of "<thread>=<cpus>[@<priority>]" entries.  <thread> matches
+// the leading words of a thread name, without case ("EE" is "EE Core").  <cpus> is one or
+// more '+' separated terms, each narrowing the set:
+//   0,2,4-7   a cpu list
+//   node<N>   the cpus of NUMA node N
+//   nosmt     one logical cpu per physical core, so that two such threads never share one
+// <priority> is low, normal or high.  Example: "EE=2@high;MTVU=4;MTGS=node0+nosmt".
+//
+struct ThreadPlacement
+{
+    u64 affinity; // 0 for any cpu
+    int priority; // see SetCurrentThreadPriority
+};
+
+// Replaces all the placements with the ones of spec.  On a malformed spec, returns false with
+// the reason in error and changes nothing.
+extern bool SetThreadPlacements(const wxString &spec, wxString &error);
+
+// Applies the placement of name, if there is one, to the calling thread and reports it.
+extern void ApplyThreadPlacement(const wxString &name);
+}
@@ -0,0 +1,105 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Threading.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Threading
+{
+// --------------------------------------------------------------------------------------
+//  ThreadPool
+// --------------------------------------------------------------------------------------
+// A fixed set of worker threads for background jobs (compression, decoding, prefetching...),
+// so that the subsystems don't each start threads of their own and oversubscribe the host.
+//
+// Every worker has its own queue (one deque per priority).  Tasks submitted from a worker go
+// to its own queue and are taken back newest first; the others are spread over the queues.
+// An idle worker takes the oldest task of another queue (work stealing).  Higher priorities
+// are always served first, but a running task is never interrupted.
+//
+// Tasks must not block on other tasks of the pool (ParallelFor is the exception: the waiting
+// thread runs the jobs itself).  Exceptions must not leave a task.
+//
+class ThreadPool
+{
+    DeclareNoncopyableObject(ThreadPool);
+
+public:
+    enum Priority {
+        Priority_High = 0, // latency sensitive (prefetching what the emulation waits for)
+        Priority_Normal,
+        Priority_Low, // bulk work nobody waits for (dumps, background compression)
+        Priority_Count
+    };
+
+    typedef std::function<void()> Task;
+
+protected:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<Task> tasks[Priority_Count];
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues; // one per worker
+    std::vector<std::thread> m_threads;
+    std::atomic<uint> m_next_queue;
+
+    std::mutex m_sleep_lock;
+    std::condition_variable m_sleep_cond;
+    std::atomic<uint> m_queued; // tasks in all the queues
+    bool m_exit;                // m_sleep_lock
+
+    bool Pop(uint self, Task &task);
+    void WorkerThread(uint self, u64 affinity, const char *name);
+
+public:
+    // threads: number of workers (at least one).  affinity: host cpus the workers may run
+    // on (bit n = logical cpu n), 0 for no restriction.
+    ThreadPool(uint threads, u64 affinity = 0, const char *name = "PoolWorker");
+
+    // Runs the tasks that are still queued, then stops the workers.
+    virtual ~ThreadPool();
+
+    void Submit(Task task, Priority priority = Priority_Normal);
+
+    // Runs job(0..count-1) and returns once all of them are done.  The calling thread runs
+    // jobs too, so it may be a worker of the pool itself.
+    void ParallelFor(uint count, const std::function<void(uint)> &job, Priority priority = Priority_Normal);
+
+    uint GetThreadCount() const { return (uint)m_threads.size(); }
+
+    // True if the calling thread is one of the workers of this pool.
+    bool IsWorkerThread() const;
+
+    // The pool shared by the whole program, started on first use.  By default it has one
+    // worker per host cpu minus one (the thread that waits on ParallelFor works as well).
+    static ThreadPool &GetShared();
+
+    // Sets the size (0 for the default) and the affinity of the shared pool.  Must be called
+    // before its first use, usually from the command line.  Returns false if it was too late.
+    static bool ConfigureShared(uint threads, u64 affinity);
+};
+}
@@ -177,6 +177,34 @@ extern void DisableHiresScheduler();
 // sleeps the current thread for the given number of milliseconds.
 extern void Sleep(int ms);
 
+// sleeps the current thread for the given number of microseconds, with the finest timer the
+// OS offers (it may still oversleep by the scheduler's wakeup latency).
+extern void SleepPrecise(u64 us);
+
+// Names the calling thread for the debuggers and the system tools (16 bytes at most on Linux).
+extern void SetCurrentThreadName(const char *name);
+
+// Restricts the calling thread to the host cpus of the mask (bit n = logical cpu n).  Does
+// nothing where the OS has no hard affinity (OSX), or if it refuses the mask.
+extern void SetCurrentThreadAffinity(u64 mask);
+
+// The host cpus the calling thread may run on, 0 if the OS can't tell.
+extern u64 GetCurrentThreadAffinity();
+
+// The host cpu the calling thread runs on right now, -1 if the OS can't tell.
+extern int GetCurrentCpu();
+
+// Scheduling priority of the calling thread relative to the others of the process: below
+// normal (< 0), normal (0) or above normal (> 0).  Returns false if the OS refused it (raising
+// the priority needs privileges on Linux).
+extern bool SetCurrentThreadPriority(int priority);
+
+// One logical cpu of each physical core (the first of its SMT siblings), 0 if unknown.
+extern u64 GetHostCoreCpus();
+
+// The logical cpus of a NUMA node, 0 if there is no such node.
+extern u64 GetNumaNodeCpus(int node);
+
 // pthread Cond is an evil api that is not suited for Pcsx2 needs.
 // Let's not use it. Use mutexes and semaphores instead to create waits. (Air)
 #if 0
@@ -259,6 +287,44 @@ public:
     bool Wait(const wxTimeSpan &timeout);
 };
 
+// --------------------------------------------------------------------------------------
+//  LightSemaphore
+// --------------------------------------------------------------------------------------
+// Semaphore for the hand-offs between the emulation threads, where the other side usually
+// answers within microseconds.  The waiter spins for a while before it parks (longer when
+// spinning paid off the last time, shorter when it didn't), and a post only enters the
+// kernel if a thread is parked.  Parks on a futex on Linux, on a Semaphore elsewhere.
+//
+// There are no timeouts and no GUI yields, so not for the main thread.  The wait is a
+// cancellation point once parked.  Meant for a single waiter (the spin length is not shared
+// safely), any number of posters.
+//
+class LightSemaphore
+{
+    DeclareNoncopyableObject(LightSemaphore);
+
+protected:
+    std::atomic<s32> m_count; // available posts, or minus the parked (or parking) waiters
+    s32 m_spin;               // waiter only
+
+#ifdef __linux__
+    std::atomic<s32> m_wakeups; // futex word: unparks not taken yet
+#else
+    Semaphore m_park;
+#endif
+
+    void Park();
+    void Unpark();
+
+public:
+    LightSemaphore();
+
+    void Post();
+    void WaitWithoutYield();
+    bool TryWait();
+    int Count() const;
+};
+
 class Mutex
 {
 protected:
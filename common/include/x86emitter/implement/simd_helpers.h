@@ -26,6 +26,11 @@ namespace x86Emitter
 // For implementing SSE-only logic operations that have xmmreg,xmmreg/rm forms only,
 // like ANDPS/ANDPD
 //
+// The three operand forms (to = from1 op from2) are VEX encoded when the cpu has AVX, and
+// emulated with a copy of from1 into to otherwise, so 'to' may only be the same register as
+// from2 if it's also from1.  They're only valid for the two-source ops (not for the unary
+// packed ones like SQRT.PS or RCP.PS, nor PTEST/MOVSLDUP/etc).
+//
 struct xImplSimd_DestRegSSE
 {
     u8 Prefix;
@@ -33,6 +38,9 @@ struct xImplSimd_DestRegSSE
 
     void operator()(const xRegisterSSE &to, const xRegisterSSE &from) const;
     void operator()(const xRegisterSSE &to, const xIndirectVoid &from) const;
+
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2) const;
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2) const;
 };
 
 // ------------------------------------------------------------------------
@@ -61,6 +69,8 @@ struct xImplSimd_DestSSE_CmpImm
 // For implementing SSE operations that have reg,reg/rm forms only,
 // but accept either MM or XMM destinations (most PADD/PSUB and other P arithmetic ops).
 //
+// Same three operand forms as xImplSimd_DestRegSSE.
+//
 struct xImplSimd_DestRegEither
 {
     u8 Prefix;
@@ -68,6 +78,9 @@ struct xImplSimd_DestRegEither
 
     void operator()(const xRegisterSSE &to, const xRegisterSSE &from) const;
     void operator()(const xRegisterSSE &to, const xIndirectVoid &from) const;
+
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2) const;
+    void operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2) const;
 };
 
 } // end namespace x86Emitter
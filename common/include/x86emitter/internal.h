@@ -25,20 +25,49 @@ namespace x86Emitter
 #define OpWriteSSE(pre, op) xOpWrite0F(pre, op, to, from)
 
 extern void SimdPrefix(u8 prefix, u16 opcode);
-extern void EmitSibMagic(uint regfield, const void *address);
-extern void EmitSibMagic(uint regfield, const xIndirectVoid &info);
-extern void EmitSibMagic(uint reg1, const xRegisterBase &reg2);
-extern void EmitSibMagic(const xRegisterBase &reg1, const xRegisterBase &reg2);
-extern void EmitSibMagic(const xRegisterBase &reg1, const void *src);
-extern void EmitSibMagic(const xRegisterBase &reg1, const xIndirectVoid &sib);
+extern void EmitSibMagic(uint regfield, const void *address, int extraRIPOffset = 0);
+extern void EmitSibMagic(uint regfield, const xIndirectVoid &info, int extraRIPOffset = 0);
+extern void EmitSibMagic(const xRegisterBase &reg1, const void *src, int extraRIPOffset = 0);
+extern void EmitSibMagic(const xRegisterBase &reg1, const xIndirectVoid &sib, int extraRIPOffset = 0);
 
 extern void EmitRex(uint regfield, const void *address);
 extern void EmitRex(uint regfield, const xIndirectVoid &info);
-extern void EmitRex(uint reg1, const xRegisterBase &reg2);
-extern void EmitRex(const xRegisterBase &reg1, const xRegisterBase &reg2);
 extern void EmitRex(const xRegisterBase &reg1, const void *src);
 extern void EmitRex(const xRegisterBase &reg1, const xIndirectVoid &sib);
 
+// The [reg,reg] forms are by far the most common ones, and only ever need a single
+// ModRM byte (and no REX at all on x86-32), so they're inlined into the instructions.
+__fi void EmitRex(bool w, bool r, bool x, bool b)
+{
+#ifdef __x86_64__
+    u8 rex = 0x40 | (w << 3) | (r << 2) | (x << 1) | b;
+    if (rex != 0x40)
+        xWrite8(rex);
+#endif
+}
+
+__fi void EmitRex(uint reg1, const xRegisterBase &reg2)
+{
+    EmitRex(reg2.IsWide(), false, false, reg2.IsExtended());
+}
+
+__fi void EmitRex(const xRegisterBase &reg1, const xRegisterBase &reg2)
+{
+    EmitRex(reg1.IsWide(), reg1.IsExtended(), false, reg2.IsExtended());
+}
+
+// Writes a ModRM byte for "Direct" register access forms, which is used for all
+// instructions taking a form of [reg,reg].
+__fi void EmitSibMagic(uint reg1, const xRegisterBase &reg2, int = 0)
+{
+    xWrite8((Mod_Direct << 6) | (reg1 << 3) | reg2.Id);
+}
+
+__fi void EmitSibMagic(const xRegisterBase &reg1, const xRegisterBase &reg2, int = 0)
+{
+    xWrite8((Mod_Direct << 6) | (reg1.Id << 3) | reg2.Id);
+}
+
 extern void _xMovRtoR(const xRegisterInt &to, const xRegisterInt &from);
 
 template <typename T>
@@ -48,8 +77,10 @@ inline void xWrite(T val)
     x86Ptr += sizeof(T);
 }
 
+// extraRIPOffset must be the size of any immediate the caller writes after the operands,
+// so that rip-relative addresses can be computed on x86_64 (see EmitSibMagic).
 template <typename T1, typename T2>
-__emitinline void xOpWrite(u8 prefix, u8 opcode, const T1 &param1, const T2 &param2)
+__emitinline void xOpWrite(u8 prefix, u8 opcode, const T1 &param1, const T2 &param2, int extraRIPOffset = 0)
 {
     if (prefix != 0)
         xWrite8(prefix);
@@ -57,7 +88,7 @@ __emitinline void xOpWrite(u8 prefix, u8 opcode, const T1 &param1, const T2 &par
 
     xWrite8(opcode);
 
-    EmitSibMagic(param1, param2);
+    EmitSibMagic(param1, param2, extraRIPOffset);
 }
 
 template <typename T1, typename T2>
@@ -96,7 +127,13 @@ __emitinline void xOpWrite0F(u8 prefix, u16 opcode, const T1 &param1, const T2 &
 template <typename T1, typename T2>
 __emitinline void xOpWrite0F(u8 prefix, u16 opcode, const T1 &param1, const T2 &param2, u8 imm8)
 {
-    xOpWrite0F(prefix, opcode, param1, param2);
+    if (prefix != 0)
+        xWrite8(prefix);
+    EmitRex(param1, param2);
+
+    SimdPrefix(0, opcode);
+
+    EmitSibMagic(param1, param2, 1);
     xWrite8(imm8);
 }
 
@@ -118,7 +155,7 @@ __emitinline void xOpWriteC5(u8 prefix, u8 opcode, const T1 &param1, const T2 &p
 {
     pxAssert(prefix == 0 || prefix == 0x66 || prefix == 0xF3 || prefix == 0xF2);
 
-    const xRegisterInt &reg = param1.IsReg() ? param1 : param2;
+    const xRegisterBase &reg = param1.IsReg() ? param1 : param2;
 
 #ifdef __x86_64__
     u8 nR = reg.IsExtended() ? 0x00 : 0x80;
@@ -147,7 +184,7 @@ __emitinline void xOpWriteC4(u8 prefix, u8 mb_prefix, u8 opcode, const T1 &param
     pxAssert(prefix == 0 || prefix == 0x66 || prefix == 0xF3 || prefix == 0xF2);
     pxAssert(mb_prefix == 0x0F || mb_prefix == 0x38 || mb_prefix == 0x3A);
 
-    const xRegisterInt &reg = param1.IsReg() ? param1 : param2;
+    const xRegisterBase &reg = param1.IsReg() ? param1 : param2;
 
 #ifdef __x86_64__
     u8 nR = reg.IsExtended() ? 0x00 : 0x80;
@@ -68,10 +68,32 @@ extern __tls_emit XMMSSEType g_xmmtypes[iREGCNT_XMM];
 namespace x86Emitter
 {
 
-extern void xWrite8(u8 val);
-extern void xWrite16(u16 val);
-extern void xWrite32(u32 val);
-extern void xWrite64(u64 val);
+// These are inlined into every emitter function, since they're called several times for
+// each instruction.  Bounds are not checked here: the recompilers make sure there's room
+// for a whole block before starting to emit it.
+__fi void xWrite8(u8 val)
+{
+    *x86Ptr = val;
+    x86Ptr += 1;
+}
+
+__fi void xWrite16(u16 val)
+{
+    *(u16 *)x86Ptr = val;
+    x86Ptr += 2;
+}
+
+__fi void xWrite32(u32 val)
+{
+    *(u32 *)x86Ptr = val;
+    x86Ptr += 4;
+}
+
+__fi void xWrite64(u64 val)
+{
+    *(u64 *)x86Ptr = val;
+    x86Ptr += 8;
+}
 
 extern const char *xGetRegName(int regid, int operandSize);
 
@@ -210,6 +232,9 @@ public:
             xWrite8(0x66);
     }
 
+    // Number of bytes written by xWriteImm (needed for rip-relative addressing).
+    int GetImmSize() const { return GetOperandSize(); }
+
     void xWriteImm(int imm) const
     {
         switch (GetOperandSize()) {
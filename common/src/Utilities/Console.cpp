@@ -16,9 +16,18 @@
 #include "PrecompiledHeader.h"
 #include "Threading.h"
 #include "TraceLog.h"
+#include "Instrumentation.h"
 
 #include "RedtapeWindows.h" // nneded for OutputDebugString
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 using namespace Threading;
 
 // thread-local console indentation setting.
@@ -36,6 +45,8 @@ void Console_SetStdout(FILE *fp)
 }
 #endif
 
+static bool ConsoleAsync_SetTarget(const IConsoleWriter &writer);
+
 // This function re-assigns the console log writer(s) to the specified target.  It makes sure
 // to flush any contents from the buffered console log (which typically accumulates due to
 // log suspension during log file/window re-init operations) into the new log.
@@ -51,6 +62,11 @@ void Console_SetActiveHandler(const IConsoleWriter &writer, FILE *flushfp)
             (writer.DoSetColor != NULL),
         "Invalid IConsoleWriter object!  All function pointer interfaces must be implemented.");
 
+    // With the async sink running the writer only becomes its target; queued writes are
+    // flushed to the old one first.
+    if (ConsoleAsync_SetTarget(writer))
+        return;
+
     Console = writer;
     DevConWriter = writer;
 
@@ -231,6 +247,364 @@ const IConsoleWriter ConsoleWriter_Assert =
         0, // instance-level indentation (should always be 0)
 };
 
+// --------------------------------------------------------------------------------------
+//  ConsoleAsync
+// --------------------------------------------------------------------------------------
+// Writes from threads other than the main thread are queued (one lock-free queue per
+// thread) and forwarded to the real writer by a background thread, so that a log storm
+// on the EE thread doesn't wait on the log window's locks or on the disk.  Entries keep
+// the color of the thread that wrote them.  A full queue drops writes; the count is
+// reported once there is room again.
+
+enum ConsoleAsyncKind {
+    ConsoleAsync_WriteRaw = 0,
+    ConsoleAsync_DoWriteLn,
+    ConsoleAsync_DoWriteFromStdout,
+    ConsoleAsync_Newline,
+    ConsoleAsync_SetTitle,
+};
+
+struct ConsoleAsyncEntry
+{
+    ConsoleAsyncKind kind;
+    ConsoleColors color;
+    wxString text;
+};
+
+// Single producer (the owning thread), single consumer (the forwarding thread).
+struct ConsoleAsyncQueue
+{
+    static const u32 Size = 1024;
+
+    ConsoleAsyncEntry entries[Size];
+    std::atomic<u32> head;
+    std::atomic<u32> tail;
+    std::atomic<u32> dropped;
+    std::atomic<bool> owned;
+
+    ConsoleAsyncQueue()
+        : head(0)
+        , tail(0)
+        , dropped(0)
+        , owned(true)
+    {
+    }
+};
+
+struct ConsoleAsyncThread
+{
+    ConsoleAsyncQueue *queue;
+
+    ConsoleAsyncThread()
+        : queue(NULL)
+    {
+    }
+
+    // The queue is handed to the next thread that writes, once drained.
+    ~ConsoleAsyncThread()
+    {
+        if (queue)
+            queue->owned.store(false, std::memory_order_release);
+    }
+};
+
+// The forwarding thread wakes at this interval, or sooner when a queue is half full.
+static const std::chrono::milliseconds ConsoleAsyncInterval(10);
+
+static std::mutex s_asyncLock; // queue list, target changes and forwarding
+static std::condition_variable s_asyncWake;
+static std::vector<ConsoleAsyncQueue *> s_asyncQueues;
+static std::thread s_asyncThread;
+static std::atomic<bool> s_asyncRunning(false);
+static bool s_asyncStop = false;
+static IConsoleWriter s_asyncTarget;
+
+static thread_local ConsoleAsyncThread conlog_AsyncThread;
+
+// Set on the forwarding thread.
+static DeclareTls(bool) conlog_AsyncDirect(false);
+
+static bool ConsoleAsync_IsDirect()
+{
+    return !s_asyncRunning.load(std::memory_order_acquire) || conlog_AsyncDirect || wxThread::IsMain();
+}
+
+static ConsoleAsyncQueue *ConsoleAsync_GetQueue()
+{
+    ConsoleAsyncThread &thread = conlog_AsyncThread;
+    if (thread.queue)
+        return thread.queue;
+
+    std::lock_guard<std::mutex> lock(s_asyncLock);
+
+    for (ConsoleAsyncQueue *queue : s_asyncQueues) {
+        bool owned = false;
+        if (queue->head.load(std::memory_order_relaxed) == queue->tail.load(std::memory_order_acquire) &&
+            queue->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+            return thread.queue = queue;
+    }
+
+    s_asyncQueues.push_back(new ConsoleAsyncQueue);
+    return thread.queue = s_asyncQueues.back();
+}
+
+static void ConsoleAsync_Push(ConsoleAsyncKind kind, const wxString &text)
+{
+    ConsoleAsyncQueue &queue = *ConsoleAsync_GetQueue();
+
+    const u32 head = queue.head.load(std::memory_order_relaxed);
+    const u32 used = head - queue.tail.load(std::memory_order_acquire);
+    if (used >= ConsoleAsyncQueue::Size) {
+        queue.dropped.fetch_add(1, std::memory_order_relaxed);
+        Instrumentation::Add(Instrumentation::Counter_ConsoleDropped, 0);
+        return;
+    }
+
+    ConsoleAsyncEntry &entry = queue.entries[head % ConsoleAsyncQueue::Size];
+    entry.kind = kind;
+    entry.color = conlog_Color;
+    entry.text = text;
+
+    queue.head.store(head + 1, std::memory_order_release);
+
+    if (used + 1 == ConsoleAsyncQueue::Size / 2)
+        s_asyncWake.notify_one();
+}
+
+static void ConsoleAsync_Forward(const ConsoleAsyncEntry &entry)
+{
+    // The target reads the color back with Console.GetColor().
+    if (entry.color != conlog_Color)
+        s_asyncTarget.DoSetColor(conlog_Color = entry.color);
+
+    switch (entry.kind) {
+        case ConsoleAsync_WriteRaw:
+            s_asyncTarget.WriteRaw(entry.text);
+            break;
+        case ConsoleAsync_DoWriteLn:
+            s_asyncTarget.DoWriteLn(entry.text);
+            break;
+        case ConsoleAsync_DoWriteFromStdout:
+            if (s_asyncTarget.DoWriteFromStdout)
+                s_asyncTarget.DoWriteFromStdout(entry.text);
+            break;
+        case ConsoleAsync_Newline:
+            s_asyncTarget.Newline();
+            break;
+        case ConsoleAsync_SetTitle:
+            s_asyncTarget.SetTitle(entry.text);
+            break;
+    }
+}
+
+// Forwards everything queued so far.  Called with s_asyncLock held.
+static void ConsoleAsync_Drain()
+{
+    const ConsoleColors color = conlog_Color;
+
+    for (ConsoleAsyncQueue *queue : s_asyncQueues) {
+        const u32 head = queue->head.load(std::memory_order_acquire);
+        for (u32 tail = queue->tail.load(std::memory_order_relaxed); tail != head; ++tail) {
+            ConsoleAsyncEntry &entry = queue->entries[tail % ConsoleAsyncQueue::Size];
+            ConsoleAsync_Forward(entry);
+            entry.text.clear();
+            queue->tail.store(tail + 1, std::memory_order_release);
+        }
+
+        if (const u32 dropped = queue->dropped.exchange(0, std::memory_order_relaxed)) {
+            if (conlog_Color != Color_StrongOrange)
+                s_asyncTarget.DoSetColor(conlog_Color = Color_StrongOrange);
+            s_asyncTarget.DoWriteLn(pxsFmt(L"(Console) %u messages were dropped; the console queue was full.", dropped));
+        }
+    }
+
+    if (conlog_Color != color)
+        s_asyncTarget.DoSetColor(conlog_Color = color);
+}
+
+static void ConsoleAsync_ThreadProc()
+{
+    conlog_AsyncDirect = true;
+
+    std::unique_lock<std::mutex> lock(s_asyncLock);
+    while (!s_asyncStop) {
+        s_asyncWake.wait_for(lock, ConsoleAsyncInterval);
+        ConsoleAsync_Drain();
+    }
+}
+
+static bool ConsoleAsync_SetTarget(const IConsoleWriter &writer)
+{
+    if (!s_asyncRunning.load(std::memory_order_acquire))
+        return false;
+
+    std::lock_guard<std::mutex> lock(s_asyncLock);
+    ConsoleAsync_Drain();
+    s_asyncTarget = writer;
+    return true;
+}
+
+static void __concall ConsoleAsync_DoWrite(const wxString &fmt)
+{
+    if (ConsoleAsync_IsDirect())
+        s_asyncTarget.WriteRaw(fmt);
+    else
+        ConsoleAsync_Push(ConsoleAsync_WriteRaw, fmt);
+}
+
+static void __concall ConsoleAsync_DoWriteLn(const wxString &fmt)
+{
+    if (ConsoleAsync_IsDirect())
+        s_asyncTarget.DoWriteLn(fmt);
+    else
+        ConsoleAsync_Push(ConsoleAsync_DoWriteLn, fmt);
+}
+
+// Queued writes carry their own color.
+static void __concall ConsoleAsync_DoSetColor(ConsoleColors color)
+{
+    if (ConsoleAsync_IsDirect())
+        s_asyncTarget.DoSetColor(color);
+}
+
+static void __concall ConsoleAsync_DoWriteFromStdout(const wxString &fmt)
+{
+    if (!ConsoleAsync_IsDirect())
+        ConsoleAsync_Push(ConsoleAsync_DoWriteFromStdout, fmt);
+    else if (s_asyncTarget.DoWriteFromStdout)
+        s_asyncTarget.DoWriteFromStdout(fmt);
+}
+
+static void __concall ConsoleAsync_Newline()
+{
+    if (ConsoleAsync_IsDirect())
+        s_asyncTarget.Newline();
+    else
+        ConsoleAsync_Push(ConsoleAsync_Newline, wxEmptyString);
+}
+
+static void __concall ConsoleAsync_SetTitle(const wxString &title)
+{
+    if (ConsoleAsync_IsDirect())
+        s_asyncTarget.SetTitle(title);
+    else
+        ConsoleAsync_Push(ConsoleAsync_SetTitle, title);
+}
+
+static const IConsoleWriter ConsoleWriter_Async =
+    {
+        ConsoleAsync_DoWrite,
+        ConsoleAsync_DoWriteLn,
+        ConsoleAsync_DoSetColor,
+
+        ConsoleAsync_DoWriteFromStdout,
+        ConsoleAsync_Newline,
+        ConsoleAsync_SetTitle,
+
+        0, // instance-level indentation (should always be 0)
+};
+
+void Console_SetAsync(bool enabled)
+{
+    pxAssert(wxThread::IsMain());
+
+    if (enabled == s_asyncRunning.load(std::memory_order_relaxed))
+        return;
+
+    if (enabled) {
+        s_asyncTarget = Console;
+        s_asyncStop = false;
+        s_asyncThread = std::thread(ConsoleAsync_ThreadProc);
+        s_asyncRunning.store(true, std::memory_order_release);
+
+        Console = ConsoleWriter_Async;
+        DevConWriter = ConsoleWriter_Async;
+#ifdef PCSX2_DEBUG
+        DbgCon = ConsoleWriter_Async;
+#endif
+    } else {
+        Console = s_asyncTarget;
+        DevConWriter = s_asyncTarget;
+#ifdef PCSX2_DEBUG
+        DbgCon = s_asyncTarget;
+#endif
+
+        {
+            std::lock_guard<std::mutex> lock(s_asyncLock);
+            s_asyncStop = true;
+        }
+        s_asyncWake.notify_one();
+        s_asyncThread.join();
+
+        s_asyncRunning.store(false, std::memory_order_release);
+
+        // Writes that were already on their way to a queue.
+        std::lock_guard<std::mutex> lock(s_asyncLock);
+        ConsoleAsync_Drain();
+    }
+}
+
+// --------------------------------------------------------------------------------------
+//  Rate limiting
+// --------------------------------------------------------------------------------------
+// Messages are limited per call site (format string) and per thread, on threads other
+// than the main thread.  The number of messages held back is written ahead of the next
+// one that gets through.
+
+struct ConsoleSiteStats
+{
+    std::chrono::steady_clock::time_point windowStart;
+    u32 count;
+    u32 suppressed;
+};
+
+// Sites beyond this many (per thread) are not limited.
+static const size_t ConsoleMaxLimitedSites = 256;
+
+static std::atomic<uint> s_rateLimit(0);
+
+static thread_local std::unordered_map<const void *, ConsoleSiteStats> conlog_Sites;
+
+void Console_SetRateLimit(uint perSecond)
+{
+    s_rateLimit.store(perSecond, std::memory_order_relaxed);
+}
+
+static bool ConsoleSite_Suppressed(const IConsoleWriter &writer, const void *site)
+{
+    const uint limit = s_rateLimit.load(std::memory_order_relaxed);
+    if (!limit || wxThread::IsMain())
+        return false;
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    auto it = conlog_Sites.find(site);
+    if (it == conlog_Sites.end()) {
+        if (conlog_Sites.size() >= ConsoleMaxLimitedSites)
+            return false;
+        const ConsoleSiteStats fresh = {now, 0, 0};
+        it = conlog_Sites.insert(std::make_pair(site, fresh)).first;
+    }
+
+    ConsoleSiteStats &stats = it->second;
+    if (now - stats.windowStart >= std::chrono::seconds(1)) {
+        if (stats.suppressed) {
+            ConsoleColorScope cs(Color_StrongOrange);
+            writer.DoWriteLn(pxsFmt(L"(Console) %u more messages like the next one were suppressed.", stats.suppressed));
+        }
+        stats.windowStart = now;
+        stats.count = 0;
+        stats.suppressed = 0;
+    }
+
+    if (++stats.count <= limit)
+        return false;
+
+    ++stats.suppressed;
+    Instrumentation::Add(Instrumentation::Counter_ConsoleDropped, 0);
+    return true;
+}
+
 // =====================================================================================================
 //  IConsoleWriter  (implementations)
 // =====================================================================================================
@@ -307,12 +681,16 @@ const IConsoleWriter &IConsoleWriter::ClearColor() const
 
 bool IConsoleWriter::FormatV(const char *fmt, va_list args) const
 {
+    Instrumentation::ScopedTimer timer(Instrumentation::Counter_ConsoleWrite);
     DoWriteLn(_addIndentation(pxsFmtV(fmt, args), conlog_Indent));
     return false;
 }
 
 bool IConsoleWriter::WriteLn(const char *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     FormatV(fmt, args);
@@ -323,6 +701,9 @@ bool IConsoleWriter::WriteLn(const char *fmt, ...) const
 
 bool IConsoleWriter::WriteLn(ConsoleColors color, const char *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     ConsoleColorScope cs(color);
@@ -334,6 +715,9 @@ bool IConsoleWriter::WriteLn(ConsoleColors color, const char *fmt, ...) const
 
 bool IConsoleWriter::Error(const char *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     ConsoleColorScope cs(Color_StrongRed);
@@ -345,6 +729,9 @@ bool IConsoleWriter::Error(const char *fmt, ...) const
 
 bool IConsoleWriter::Warning(const char *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     ConsoleColorScope cs(Color_StrongOrange);
@@ -360,12 +747,16 @@ bool IConsoleWriter::Warning(const char *fmt, ...) const
 
 bool IConsoleWriter::FormatV(const wxChar *fmt, va_list args) const
 {
+    Instrumentation::ScopedTimer timer(Instrumentation::Counter_ConsoleWrite);
     DoWriteLn(_addIndentation(pxsFmtV(fmt, args), conlog_Indent));
     return false;
 }
 
 bool IConsoleWriter::WriteLn(const wxChar *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     FormatV(fmt, args);
@@ -376,6 +767,9 @@ bool IConsoleWriter::WriteLn(const wxChar *fmt, ...) const
 
 bool IConsoleWriter::WriteLn(ConsoleColors color, const wxChar *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     ConsoleColorScope cs(color);
@@ -387,6 +781,9 @@ bool IConsoleWriter::WriteLn(ConsoleColors color, const wxChar *fmt, ...) const
 
 bool IConsoleWriter::Error(const wxChar *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     ConsoleColorScope cs(Color_StrongRed);
@@ -398,6 +795,9 @@ bool IConsoleWriter::Error(const wxChar *fmt, ...) const
 
 bool IConsoleWriter::Warning(const wxChar *fmt, ...) const
 {
+    if (ConsoleSite_Suppressed(*this, fmt))
+        return false;
+
     va_list args;
     va_start(args, fmt);
     ConsoleColorScope cs(Color_StrongOrange);
@@ -17,6 +17,8 @@
 #include "PersistentThread.h"
 
 #include <unistd.h>
+#include <time.h>
+#include <errno.h>
 
 #if !defined(__APPLE__)
 #error "DarwinThreads.cpp should only be compiled by projects or makefiles targeted at OSX."
@@ -35,6 +37,16 @@ __forceinline void Threading::Sleep(int ms)
     usleep(1000 * ms);
 }
 
+void Threading::SleepPrecise(u64 us)
+{
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
 // For use in spin/wait loops, acts as a hint to Intel CPUs and should, in theory
 // improve performance and reduce cpu power consumption.
 __forceinline void Threading::SpinWait()
@@ -125,10 +137,46 @@ void Threading::pxThread::_platform_specific_OnCleanupInThread()
     mach_port_deallocate(mach_task_self(), (thread_port_t)m_native_id);
 }
 
-// name can be up to 16 bytes
 void Threading::pxThread::_DoSetThreadName(const char *name)
+{
+    SetCurrentThreadName(name);
+}
+
+// name can be up to 16 bytes
+void Threading::SetCurrentThreadName(const char *name)
 {
     pthread_setname_np(name);
 }
 
+void Threading::SetCurrentThreadAffinity(u64 mask)
+{
+    // Only affinity tags (hints) on OSX
+}
+
+u64 Threading::GetCurrentThreadAffinity()
+{
+    return 0;
+}
+
+int Threading::GetCurrentCpu()
+{
+    return -1;
+}
+
+bool Threading::SetCurrentThreadPriority(int priority)
+{
+    // QoS classes would be the OSX way, not worth it for now
+    return priority == 0;
+}
+
+u64 Threading::GetHostCoreCpus()
+{
+    return 0;
+}
+
+u64 Threading::GetNumaNodeCpus(int node)
+{
+    return 0;
+}
+
 #endif
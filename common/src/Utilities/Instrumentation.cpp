@@ -0,0 +1,300 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Instrumentation.h"
+
+#include <cstddef>
+
+#ifdef _WIN32
+#include "RedtapeWindows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// The layout is shared with other processes (and possibly other word sizes).
+static_assert(offsetof(Instrumentation::SharedHeader, tickFrequency) == 16, "Instrumentation header layout");
+static_assert(offsetof(Instrumentation::SharedHeader, ringWrite) % 8 == 0, "Instrumentation header layout");
+static_assert(sizeof(Instrumentation::SharedHeader) % 8 == 0, "Instrumentation header layout");
+static_assert(sizeof(Instrumentation::Slot) == 16, "Instrumentation slot layout");
+static_assert(sizeof(Instrumentation::Snapshot) == (3 + 2 * Instrumentation::Counter_Count) * 8, "Instrumentation snapshot layout");
+
+namespace Instrumentation
+{
+
+Slot *g_slots = NULL;
+
+static const char *const CounterNames[Counter_Count] = {
+    "ee_rec_compile",
+    "mtgs_stall",
+    "mtvu_wait",
+    "vif_unpack_bytes",
+    "cdvd_read",
+    "spu2_mix",
+    "ee_event_test",
+    "patch_write",
+    "iop_hle_call",
+    "input_to_vsync",
+    "input_to_present",
+    "vsync_to_present",
+    "console_write",
+    "console_dropped",
+    "vu_flag_insts",
+    "frame_pace_lt_100us",
+    "frame_pace_lt_500us",
+    "frame_pace_lt_1ms",
+    "frame_pace_lt_2ms",
+    "frame_pace_ge_2ms",
+    "frame_limit_spin",
+    "frame_limit_late",
+    "run_ahead_save",
+    "run_ahead_load",
+    "startup_to_frame",
+    "mfifo_wait",
+    "ee_thread_time",
+    "mtgs_thread_time",
+    "mtvu_thread_time",
+    "mtgs_queue_bytes",
+};
+
+static SharedSegment *s_segment = NULL;
+static bool s_owner = false;
+
+// --------------------------------------------------------------------------------------
+//  Platform specifics
+// --------------------------------------------------------------------------------------
+#ifdef _WIN32
+
+static HANDLE s_mapping = NULL;
+
+u64 GetFrequency()
+{
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    return freq.QuadPart;
+}
+
+u64 GetTicks()
+{
+    LARGE_INTEGER count;
+    QueryPerformanceCounter(&count);
+    return count.QuadPart;
+}
+
+static u32 GetPid()
+{
+    return GetCurrentProcessId();
+}
+
+static SharedSegment *MapSegment(bool create)
+{
+    wchar_t name[64];
+    swprintf(name, ArraySize(name), L"Local\\pcsx2-instr-%u", GetPid());
+
+    if (create)
+        s_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SharedSegment), name);
+    else
+        s_mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, name);
+
+    if (!s_mapping)
+        return NULL;
+
+    void *ptr = MapViewOfFile(s_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedSegment));
+    if (!ptr) {
+        CloseHandle(s_mapping);
+        s_mapping = NULL;
+    }
+    return (SharedSegment *)ptr;
+}
+
+static void UnmapSegment(bool remove)
+{
+    UnmapViewOfFile(s_segment);
+    CloseHandle(s_mapping);
+    s_mapping = NULL;
+}
+
+#else
+
+u64 GetFrequency()
+{
+    return 1000000000;
+}
+
+u64 GetTicks()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static u32 GetPid()
+{
+    return getpid();
+}
+
+static void GetSegmentName(char (&name)[64])
+{
+    snprintf(name, sizeof(name), "/pcsx2-instr-%u", GetPid());
+}
+
+static SharedSegment *MapSegment(bool create)
+{
+    char name[64];
+    GetSegmentName(name);
+
+    // Anything left under our name belongs to a dead process that happened to have our pid.
+    if (create)
+        shm_unlink(name);
+
+    const int fd = shm_open(name, create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600);
+    if (fd < 0)
+        return NULL;
+
+    if (create && ftruncate(fd, sizeof(SharedSegment)) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    void *ptr = mmap(NULL, sizeof(SharedSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (ptr == MAP_FAILED) {
+        if (create)
+            shm_unlink(name);
+        return NULL;
+    }
+    return (SharedSegment *)ptr;
+}
+
+static void UnmapSegment(bool remove)
+{
+    munmap(s_segment, sizeof(SharedSegment));
+
+    if (remove) {
+        char name[64];
+        GetSegmentName(name);
+        shm_unlink(name);
+    }
+}
+
+#endif
+
+// --------------------------------------------------------------------------------------
+//  Segment management
+// --------------------------------------------------------------------------------------
+bool Create()
+{
+    if (s_segment && s_owner)
+        return true;
+
+    Close();
+
+    SharedSegment *segment = MapSegment(true);
+    if (!segment) {
+        Console.Error("(Instrumentation) Could not create the shared memory segment.");
+        return false;
+    }
+
+    memset(segment, 0, sizeof(SharedSegment));
+
+    SharedHeader &header = segment->header;
+    header.version = SharedVersion;
+    header.counterCount = Counter_Count;
+    header.ringSize = RingSize;
+    header.tickFrequency = GetFrequency();
+    header.pid = GetPid();
+    for (int i = 0; i < Counter_Count; ++i)
+        strncpy(header.names[i], CounterNames[i], CounterNameSize - 1);
+
+    std::atomic_thread_fence(std::memory_order_release);
+    header.magic = SharedMagic;
+
+    s_segment = segment;
+    s_owner = true;
+    g_slots = segment->slots;
+
+    Console.WriteLn("(Instrumentation) Counters published as pcsx2-instr-%u.", header.pid);
+    return true;
+}
+
+bool Attach()
+{
+    // A plugin may end up sharing our globals (symbol interposition), in which case the
+    // segment is already here.
+    if (s_owner)
+        return true;
+
+    Close();
+
+    SharedSegment *segment = MapSegment(false);
+    if (!segment)
+        return false;
+
+    s_segment = segment;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (segment->header.magic != SharedMagic || segment->header.version != SharedVersion) {
+        UnmapSegment(false);
+        s_segment = NULL;
+        return false;
+    }
+
+    g_slots = segment->slots;
+    return true;
+}
+
+void Close()
+{
+    if (!s_segment)
+        return;
+
+    g_slots = NULL;
+
+    if (s_owner)
+        s_segment->header.magic = 0;
+
+    UnmapSegment(s_owner);
+    s_segment = NULL;
+    s_owner = false;
+}
+
+void Publish(u64 frame)
+{
+    if (!s_segment || !s_owner)
+        return;
+
+    SharedHeader &header = s_segment->header;
+    const u64 n = header.ringWrite.load(std::memory_order_relaxed);
+    Snapshot &snap = s_segment->ring[n & (RingSize - 1)];
+
+    snap.seq.store(n * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    snap.ticks = GetTicks();
+    snap.frame = frame;
+    for (int i = 0; i < Counter_Count; ++i) {
+        snap.events[i] = s_segment->slots[i].events.load(std::memory_order_relaxed);
+        snap.total[i] = s_segment->slots[i].total.load(std::memory_order_relaxed);
+    }
+
+    snap.seq.store(n * 2 + 2, std::memory_order_release);
+    header.ringWrite.store(n + 1, std::memory_order_release);
+}
+}
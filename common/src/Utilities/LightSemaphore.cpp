@@ -0,0 +1,136 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Threading.h"
+
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Spin lengths, in SpinWait() iterations (a few tens of ns each).  The longest one stays
+// well under a scheduler timeslice, so that a spinning waiter never costs more than a park.
+// No spinning at all on a single cpu host, where the poster can't run meanwhile.
+static const s32 LightSemaphoreMinSpin = 64;
+static const s32 LightSemaphoreMaxSpin = 8192;
+
+static s32 GetMaxSpin()
+{
+    static const s32 spin = std::thread::hardware_concurrency() > 1 ? LightSemaphoreMaxSpin : 0;
+    return spin;
+}
+
+// --------------------------------------------------------------------------------------
+//  LightSemaphore
+// --------------------------------------------------------------------------------------
+Threading::LightSemaphore::LightSemaphore()
+    : m_count(0)
+    , m_spin(GetMaxSpin() / 8)
+#ifdef __linux__
+    , m_wakeups(0)
+#endif
+{
+}
+
+bool Threading::LightSemaphore::TryWait()
+{
+    s32 count = m_count.load(std::memory_order_relaxed);
+
+    while (count > 0) {
+        if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+    }
+
+    return false;
+}
+
+void Threading::LightSemaphore::Post()
+{
+    if (m_count.fetch_add(1, std::memory_order_release) < 0)
+        Unpark();
+}
+
+void Threading::LightSemaphore::WaitWithoutYield()
+{
+    for (s32 i = 0; i < m_spin; ++i) {
+        if (TryWait()) {
+            m_spin = std::min(m_spin * 2, GetMaxSpin());
+            return;
+        }
+
+        SpinWait();
+    }
+
+    m_spin = std::max(m_spin / 2, std::min(LightSemaphoreMinSpin, GetMaxSpin()));
+
+    // Counted as a waiter from here on: a post that sees it unparks us, even before we park
+    if (m_count.fetch_sub(1, std::memory_order_acquire) > 0)
+        return;
+
+    Park();
+}
+
+int Threading::LightSemaphore::Count() const
+{
+    return std::max<s32>(m_count.load(std::memory_order_relaxed), 0);
+}
+
+#ifdef __linux__
+
+void Threading::LightSemaphore::Park()
+{
+    for (;;) {
+        s32 wakeups = m_wakeups.load(std::memory_order_acquire);
+
+        if (wakeups > 0) {
+            if (m_wakeups.compare_exchange_weak(wakeups, wakeups - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+            continue;
+        }
+
+        // Returns at once if an unpark came in since the load (EAGAIN); spurious wakeups
+        // and signals (EINTR) just loop.  A cancellation point, like sem_wait: the waiting
+        // threads are stopped with pxThread::Cancel.
+        int oldtype;
+        pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, &oldtype);
+        syscall(SYS_futex, &m_wakeups, FUTEX_WAIT_PRIVATE, 0, NULL, NULL, 0);
+        pthread_setcanceltype(oldtype, NULL);
+    }
+}
+
+void Threading::LightSemaphore::Unpark()
+{
+    m_wakeups.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, &m_wakeups, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+#else
+
+void Threading::LightSemaphore::Park()
+{
+    m_park.WaitWithoutYield();
+}
+
+void Threading::LightSemaphore::Unpark()
+{
+    m_park.Post();
+}
+
+#endif
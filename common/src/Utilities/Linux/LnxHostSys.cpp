@@ -22,6 +22,7 @@
 #include <sys/mman.h>
 #include <signal.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 // Apple uses the MAP_ANON define instead of MAP_ANONYMOUS, but they mean
@@ -222,6 +223,79 @@ void HostSys::Munmap(uptr base, size_t size)
     munmap((void *)base, size);
 }
 
+#ifdef MADV_HUGEPAGE
+// True unless transparent huge pages are turned off system-wide ("[never]"), in which case
+// madvise still succeeds but nothing changes.
+static bool TransparentHugePagesEnabled()
+{
+    static int enabled = -1;
+
+    if (enabled < 0) {
+        char mode[128] = {0};
+        if (FILE *fp = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r")) {
+            if (!fgets(mode, sizeof(mode), fp))
+                mode[0] = 0;
+            fclose(fp);
+        }
+        enabled = mode[0] && !strstr(mode, "[never]");
+    }
+
+    return enabled != 0;
+}
+#endif
+
+bool HostSys::MmapAdviseLargePages(void *base, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+    // Transparent huge pages: the range is filled with 2mb pages as it faults in, and
+    // khugepaged collapses what it can later on.  Unlike MAP_HUGETLB this needs no
+    // preallocated pool, and the range can still be protected and reset page by page
+    // (which splits the affected huge page back into small ones).
+    if (madvise(base, size, MADV_HUGEPAGE) != 0)
+        return false;
+
+    return TransparentHugePagesEnabled();
+#else
+    return false;
+#endif
+}
+
+bool HostSys::MmapFilePrivatePtr(void *base, size_t size, const wxString &filename)
+{
+    PageSizeAssertionTest(size);
+
+    const int fd = open(filename.ToUTF8(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    // MAP_FIXED replaces whatever was mapped there, so there's no window in which the range
+    // is unmapped.  The fd may be closed once mapped.
+    void *result = mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    close(fd);
+
+    return result == base;
+}
+
+s64 HostSys::GetResidentBytes(const void *base, size_t size)
+{
+    const uptr start = (uptr)base & ~(uptr)(__pagesize - 1);
+    const size_t pages = ((uptr)base + size - start + __pagesize - 1) / __pagesize;
+
+#ifdef __APPLE__
+    std::vector<char> resident(pages);
+#else
+    std::vector<unsigned char> resident(pages);
+#endif
+    if (mincore((void *)start, pages * __pagesize, &resident[0]) != 0)
+        return -1;
+
+    s64 count = 0;
+    for (const auto page : resident)
+        count += page & 1;
+
+    return count * __pagesize;
+}
+
 void HostSys::MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mode)
 {
     if (!_memprotect(baseaddr, size, mode)) {
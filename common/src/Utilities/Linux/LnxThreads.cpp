@@ -17,8 +17,13 @@
 #include "../PrecompiledHeader.h"
 #include "PersistentThread.h"
 #include <unistd.h>
+#include <time.h>
+#include <errno.h>
 #if defined(__linux__)
 #include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sched.h>
 #elif defined(__unix__)
 #include <pthread_np.h>
 #endif
@@ -42,6 +47,17 @@ __forceinline void Threading::Sleep(int ms)
     usleep(1000 * ms);
 }
 
+void Threading::SleepPrecise(u64 us)
+{
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+
+    // Interrupted by a signal: sleep the rest
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR) {
+    }
+}
+
 // For use in spin/wait loops,  Acts as a hint to Intel CPUs and should, in theory
 // improve performance and reduce cpu power consumption.
 __forceinline void Threading::SpinWait()
@@ -119,6 +135,11 @@ void Threading::pxThread::_platform_specific_OnCleanupInThread()
 }
 
 void Threading::pxThread::_DoSetThreadName(const char *name)
+{
+    SetCurrentThreadName(name);
+}
+
+void Threading::SetCurrentThreadName(const char *name)
 {
 #if defined(__linux__)
     // Extract of manpage: "The name can be up to 16 bytes long, and should be
@@ -129,4 +150,116 @@ void Threading::pxThread::_DoSetThreadName(const char *name)
 #endif
 }
 
+void Threading::SetCurrentThreadAffinity(u64 mask)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+        if (mask & (1ull << cpu))
+            CPU_SET(cpu, &set);
+    }
+
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+u64 Threading::GetCurrentThreadAffinity()
+{
+    u64 mask = 0;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set))
+                mask |= 1ull << cpu;
+        }
+    }
+#endif
+    return mask;
+}
+
+int Threading::GetCurrentCpu()
+{
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+bool Threading::SetCurrentThreadPriority(int priority)
+{
+#if defined(__linux__)
+    // The nice value is per thread on Linux
+    const int nice = priority > 0 ? -5 : priority < 0 ? 5 : 0;
+    return setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice) == 0;
+#else
+    return false;
+#endif
+}
+
+#if defined(__linux__)
+// sysfs cpu lists are comma separated ranges, such as "0-15,32-47"
+static u64 ReadCpuList(const char *path)
+{
+    u64 mask = 0;
+
+    if (FILE *fp = fopen(path, "r")) {
+        int first, last;
+        char sep;
+
+        while (fscanf(fp, "%d", &first) == 1) {
+            last = first;
+            if (fscanf(fp, "%c", &sep) == 1 && sep == '-') {
+                if (fscanf(fp, "%d", &last) != 1)
+                    break;
+                if (fscanf(fp, "%c", &sep) != 1)
+                    sep = 0;
+            }
+
+            for (int cpu = first; cpu <= last && cpu < 64; ++cpu)
+                mask |= 1ull << cpu;
+
+            if (sep != ',')
+                break;
+        }
+
+        fclose(fp);
+    }
+
+    return mask;
+}
+#endif
+
+u64 Threading::GetHostCoreCpus()
+{
+    u64 mask = 0;
+#if defined(__linux__)
+    for (int cpu = 0; cpu < 64; ++cpu) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+
+        const u64 siblings = ReadCpuList(path);
+        if (siblings & (1ull << cpu))
+            mask |= siblings & (~siblings + 1); // the lowest sibling stands for the core
+    }
+#endif
+    return mask;
+}
+
+u64 Threading::GetNumaNodeCpus(int node)
+{
+#if defined(__linux__)
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    return ReadCpuList(path);
+#else
+    return 0;
+#endif
+}
+
 #endif
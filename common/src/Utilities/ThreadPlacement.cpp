@@ -0,0 +1,177 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "ThreadPlacement.h"
+#include "StringHelpers.h"
+#include "Console.h"
+
+#include <mutex>
+
+using namespace Threading;
+
+struct NamedPlacement
+{
+    wxString name;
+    ThreadPlacement placement;
+};
+
+static std::mutex s_placement_lock;
+static std::vector<NamedPlacement> s_placements;
+
+static bool ParseCpuList(const wxString &list, u64 &mask)
+{
+    mask = 0;
+
+    wxArrayString ranges;
+    SplitString(ranges, list, L",");
+
+    for (const wxString &range : ranges) {
+        unsigned long first, last;
+
+        if (!range.BeforeFirst(L'-').ToULong(&first))
+            return false;
+        if (range.Find(L'-') == wxNOT_FOUND)
+            last = first;
+        else if (!range.AfterFirst(L'-').ToULong(&last))
+            return false;
+
+        if (first > last || last >= 64)
+            return false;
+
+        for (unsigned long cpu = first; cpu <= last; ++cpu)
+            mask |= 1ull << cpu;
+    }
+
+    return mask != 0;
+}
+
+static bool ParseCpus(const wxString &cpus, u64 &affinity, wxString &error)
+{
+    affinity = ~0ull;
+
+    wxArrayString terms;
+    SplitString(terms, cpus, L"+");
+
+    for (const wxString &term : terms) {
+        u64 mask;
+        unsigned long node;
+
+        if (term.CmpNoCase(L"nosmt") == 0) {
+            mask = GetHostCoreCpus();
+            if (!mask) {
+                error = L"the host cpu topology is unknown, 'nosmt' can't be used";
+                return false;
+            }
+        } else if (term.Lower().StartsWith(L"node") && term.Mid(4).ToULong(&node)) {
+            mask = GetNumaNodeCpus((int)node);
+            if (!mask) {
+                error = wxsFormat(L"there is no NUMA node %lu", node);
+                return false;
+            }
+        } else if (!ParseCpuList(term, mask)) {
+            error = wxsFormat(L"'%s' is neither a cpu list, a NUMA node nor 'nosmt'", WX_STR(term));
+            return false;
+        }
+
+        affinity &= mask;
+    }
+
+    if (!affinity) {
+        error = wxsFormat(L"'%s' leaves no cpu", WX_STR(cpus));
+        return false;
+    }
+
+    return true;
+}
+
+bool Threading::SetThreadPlacements(const wxString &spec, wxString &error)
+{
+    std::vector<NamedPlacement> placements;
+
+    wxArrayString entries;
+    SplitString(entries, spec, L";", wxTOKEN_STRTOK);
+
+    for (const wxString &entry : entries) {
+        NamedPlacement p;
+        p.name = entry.BeforeFirst(L'=').Trim(true).Trim(false);
+        p.placement.affinity = 0;
+        p.placement.priority = 0;
+
+        const wxString where = entry.AfterFirst(L'=').Trim(true).Trim(false);
+
+        if (p.name.IsEmpty() || where.IsEmpty()) {
+            error = wxsFormat(L"'%s' is not <thread>=<cpus>[@<priority>]", WX_STR(entry));
+            return false;
+        }
+
+        const wxString cpus = where.BeforeFirst(L'@');
+        const wxString priority = where.AfterFirst(L'@');
+
+        if (!cpus.IsEmpty() && !ParseCpus(cpus, p.placement.affinity, error))
+            return false;
+
+        if (priority.IsEmpty() || priority.CmpNoCase(L"normal") == 0)
+            p.placement.priority = 0;
+        else if (priority.CmpNoCase(L"high") == 0)
+            p.placement.priority = 1;
+        else if (priority.CmpNoCase(L"low") == 0)
+            p.placement.priority = -1;
+        else {
+            error = wxsFormat(L"unknown priority '%s' (low, normal or high)", WX_STR(priority));
+            return false;
+        }
+
+        placements.push_back(p);
+    }
+
+    std::lock_guard<std::mutex> l(s_placement_lock);
+    s_placements.swap(placements);
+    return true;
+}
+
+// "EE" names "EE Core", but "MTVU" doesn't name "MTVU0"
+static bool IsNamed(const wxString &name, const wxString &key)
+{
+    return name.Lower().StartsWith(key.Lower()) && (name.Length() == key.Length() || name[key.Length()] == L' ');
+}
+
+void Threading::ApplyThreadPlacement(const wxString &name)
+{
+    ThreadPlacement placement;
+    {
+        std::lock_guard<std::mutex> l(s_placement_lock);
+
+        auto it = std::find_if(s_placements.begin(), s_placements.end(),
+                               [&](const NamedPlacement &p) { return IsNamed(name, p.name); });
+        if (it == s_placements.end())
+            return;
+
+        placement = it->placement;
+    }
+
+    if (placement.affinity)
+        SetCurrentThreadAffinity(placement.affinity);
+
+    const bool priority_ok = SetCurrentThreadPriority(placement.priority);
+
+    // What the OS made of it: a mask it refused (or trimmed to the process' cpus) shows here
+    const u64 actual = GetCurrentThreadAffinity();
+    const wxChar *affinity = !placement.affinity ? L"not placed" : !actual ? L"unknown" : actual == placement.affinity ? L"as placed" : L"NOT as placed";
+    const wxChar *priority = placement.priority > 0 ? L"high" : placement.priority < 0 ? L"low" : L"normal";
+
+    Console.WriteLn(Color_Gray, L"(Threading) %s: cpus 0x%llx (%s), on cpu %d, %s priority%s", WX_STR(name),
+                    (unsigned long long)actual, affinity, GetCurrentCpu(), priority, priority_ok ? L"" : L" refused by the OS");
+}
@@ -0,0 +1,229 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "ThreadPool.h"
+
+using namespace Threading;
+
+// The pool and queue of the calling thread, if it is a worker.
+static thread_local const ThreadPool *tls_pool = NULL;
+static thread_local uint tls_queue = 0;
+
+// --------------------------------------------------------------------------------------
+//  ThreadPool
+// --------------------------------------------------------------------------------------
+ThreadPool::ThreadPool(uint threads, u64 affinity, const char *name)
+    : m_next_queue(0)
+    , m_queued(0)
+    , m_exit(false)
+{
+    threads = std::max(threads, 1u);
+
+    for (uint i = 0; i < threads; ++i)
+        m_queues.push_back(std::unique_ptr<Queue>(new Queue));
+
+    // All the queues exist before any worker looks for a task to steal
+    for (uint i = 0; i < threads; ++i)
+        m_threads.push_back(std::thread(&ThreadPool::WorkerThread, this, i, affinity, name));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> l(m_sleep_lock);
+        m_exit = true;
+    }
+
+    m_sleep_cond.notify_all();
+
+    for (std::thread &thr : m_threads)
+        thr.join();
+}
+
+bool ThreadPool::IsWorkerThread() const
+{
+    return tls_pool == this;
+}
+
+void ThreadPool::Submit(Task task, Priority priority)
+{
+    const uint n = (uint)m_queues.size();
+    const uint index = IsWorkerThread() ? tls_queue : m_next_queue++ % n;
+
+    {
+        std::lock_guard<std::mutex> l(m_queues[index]->lock);
+        m_queues[index]->tasks[priority].push_back(std::move(task));
+    }
+
+    // Counted under the sleep lock, so that a worker can't miss it on its way to sleep
+    {
+        std::lock_guard<std::mutex> l(m_sleep_lock);
+        ++m_queued;
+    }
+
+    m_sleep_cond.notify_one();
+}
+
+// Takes the next task for the worker self: its own newest one, else the oldest one of another
+// queue, at the highest priority any queue has.
+bool ThreadPool::Pop(uint self, Task &task)
+{
+    const uint n = (uint)m_queues.size();
+
+    for (int p = 0; p < Priority_Count; ++p) {
+        for (uint i = 0; i < n; ++i) {
+            Queue &q = *m_queues[(self + i) % n];
+            std::lock_guard<std::mutex> l(q.lock);
+
+            std::deque<Task> &tasks = q.tasks[p];
+            if (tasks.empty())
+                continue;
+
+            if (i == 0) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+            } else {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            --m_queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::WorkerThread(uint self, u64 affinity, const char *name)
+{
+    SetCurrentThreadName(name);
+    if (affinity)
+        SetCurrentThreadAffinity(affinity);
+
+    tls_pool = this;
+    tls_queue = self;
+
+    for (;;) {
+        Task task;
+
+        if (Pop(self, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> l(m_sleep_lock);
+
+        // Queued tasks are still run on exit
+        if (m_queued == 0 && m_exit)
+            break;
+
+        m_sleep_cond.wait(l, [this] { return m_queued > 0 || m_exit; });
+    }
+}
+
+void ThreadPool::ParallelFor(uint count, const std::function<void(uint)> &job, Priority priority)
+{
+    if (count <= 1) {
+        if (count)
+            job(0);
+        return;
+    }
+
+    // Shared with the helper tasks: those that only start after the last job was taken find
+    // nothing to do, and never touch job, which is gone by then.
+    struct State
+    {
+        std::atomic<uint> next;
+        std::atomic<uint> left;
+        uint count;
+        const std::function<void(uint)> *job;
+        std::mutex lock;
+        std::condition_variable done;
+    };
+
+    std::shared_ptr<State> state = std::make_shared<State>();
+    state->next = 0;
+    state->left = count;
+    state->count = count;
+    state->job = &job;
+
+    const auto run = [](State &s) {
+        for (uint i = s.next++; i < s.count; i = s.next++) {
+            (*s.job)(i);
+
+            if (--s.left == 0) {
+                std::lock_guard<std::mutex> l(s.lock);
+                s.done.notify_all();
+            }
+        }
+    };
+
+    const uint helpers = std::min(count - 1, GetThreadCount());
+    for (uint i = 0; i < helpers; ++i)
+        Submit([state, run] { run(*state); }, priority);
+
+    run(*state);
+
+    // Only the jobs already taken by the helpers are left
+    std::unique_lock<std::mutex> l(state->lock);
+    state->done.wait(l, [&state] { return state->left == 0; });
+}
+
+// --------------------------------------------------------------------------------------
+//  Shared pool
+// --------------------------------------------------------------------------------------
+static std::mutex s_shared_lock;
+static std::unique_ptr<ThreadPool> s_shared;
+static uint s_shared_threads = 0;
+static u64 s_shared_affinity = 0;
+
+ThreadPool &ThreadPool::GetShared()
+{
+    std::lock_guard<std::mutex> l(s_shared_lock);
+
+    if (!s_shared) {
+        uint threads = s_shared_threads;
+
+        if (threads == 0) {
+            uint cpus = std::thread::hardware_concurrency();
+
+            if (s_shared_affinity) {
+                cpus = 0;
+                for (u64 mask = s_shared_affinity; mask; mask &= mask - 1)
+                    ++cpus;
+            }
+
+            threads = std::max(cpus, 2u) - 1;
+        }
+
+        s_shared.reset(new ThreadPool(threads, s_shared_affinity, "SharedWorker"));
+    }
+
+    return *s_shared;
+}
+
+bool ThreadPool::ConfigureShared(uint threads, u64 affinity)
+{
+    std::lock_guard<std::mutex> l(s_shared_lock);
+
+    if (s_shared)
+        return false;
+
+    s_shared_threads = threads;
+    s_shared_affinity = affinity;
+    return true;
+}
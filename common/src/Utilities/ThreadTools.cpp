@@ -21,6 +21,7 @@
 #endif
 
 #include "PersistentThread.h"
+#include "ThreadPlacement.h"
 #include "wxBaseTools.h"
 #include "ThreadingInternal.h"
 #include "EventSource.inl"
@@ -645,6 +646,7 @@ void Threading::pxThread::_internal_execute()
         pthread_setspecific(curthread_key, this);
 
     OnStartInThread();
+    ApplyThreadPlacement(GetName());
     m_sem_startup.Post();
 
     _try_virtual_invoke(&pxThread::ExecuteTaskInThread);
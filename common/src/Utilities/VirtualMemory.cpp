@@ -80,6 +80,8 @@ VirtualMemoryReserve::VirtualMemoryReserve(const wxString &name, size_t size)
     m_baseptr = NULL;
     m_prot_mode = PageAccess_None();
     m_allow_writes = true;
+    m_large_pages = false;
+    m_large_pages_result = -1;
 }
 
 VirtualMemoryReserve &VirtualMemoryReserve::SetName(const wxString &newname)
@@ -103,6 +105,13 @@ VirtualMemoryReserve &VirtualMemoryReserve::SetPageAccessOnCommit(const PageProt
     return *this;
 }
 
+// Takes effect at the next Commit.
+VirtualMemoryReserve &VirtualMemoryReserve::SetLargePages(bool enabled)
+{
+    m_large_pages = enabled;
+    return *this;
+}
+
 // Notes:
 //  * This method should be called if the object is already in an released (unreserved) state.
 //    Subsequent calls will be ignored, and the existing reserve will be returned.
@@ -195,7 +204,18 @@ bool VirtualMemoryReserve::Commit()
         return true;
 
     m_pages_commited = m_pages_reserved;
-    return HostSys::MmapCommitPtr(m_baseptr, m_pages_reserved * __pagesize, m_prot_mode);
+    if (!HostSys::MmapCommitPtr(m_baseptr, m_pages_reserved * __pagesize, m_prot_mode))
+        return false;
+
+    if (m_large_pages) {
+        const int result = HostSys::MmapAdviseLargePages(m_baseptr, m_pages_reserved * __pagesize);
+        if (result != m_large_pages_result)
+            Console.WriteLn(Color_Gray, L"%-32s %s", WX_STR(m_name),
+                            result ? L"is backed by large pages." : L"could not get large pages; using normal pages.");
+        m_large_pages_result = result;
+    }
+
+    return true;
 }
 
 void VirtualMemoryReserve::AllowModification()
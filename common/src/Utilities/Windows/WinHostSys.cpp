@@ -131,6 +131,26 @@ void HostSys::Munmap(uptr base, size_t size)
     VirtualFree((void *)base, 0, MEM_RELEASE);
 }
 
+// Windows large pages (MEM_LARGE_PAGES) have to be reserved and committed in one go, need the
+// "Lock pages in memory" privilege, and can be neither decommitted nor protected in parts.
+// Our reserves rely on all of these, so they keep their normal pages.
+bool HostSys::MmapAdviseLargePages(void *base, size_t size)
+{
+    return false;
+}
+
+// A file view can't be mapped into part of an existing reservation (short of the placeholder
+// API of recent Windows 10 builds), so the caller reads the file instead.
+bool HostSys::MmapFilePrivatePtr(void *base, size_t size, const wxString &filename)
+{
+    return false;
+}
+
+s64 HostSys::GetResidentBytes(const void *base, size_t size)
+{
+    return -1;
+}
+
 void HostSys::MemProtect(void *baseaddr, size_t size, const PageProtectionMode &mode)
 {
     pxAssertDev(((size & (__pagesize - 1)) == 0), pxsFmt(
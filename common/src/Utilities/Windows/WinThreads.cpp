@@ -29,6 +29,31 @@ __fi void Threading::Sleep(int ms)
     ::Sleep(ms);
 }
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+void Threading::SleepPrecise(u64 us)
+{
+    // One timer per thread, it lives as long as the thread.  High resolution timers (Windows 10
+    // 1803 and later) don't depend on timeBeginPeriod; the plain ones are as good as Sleep().
+    static thread_local HANDLE timer = NULL;
+
+    if (!timer) {
+        timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!timer)
+            timer = CreateWaitableTimerW(NULL, TRUE, NULL);
+    }
+
+    LARGE_INTEGER due;
+    due.QuadPart = -(LONGLONG)(us * 10); // relative, in 100 ns
+
+    if (timer && SetWaitableTimer(timer, &due, 0, NULL, NULL, FALSE))
+        WaitForSingleObject(timer, INFINITE);
+    else
+        ::Sleep((DWORD)(us / 1000));
+}
+
 // For use in spin/wait loops,  Acts as a hint to Intel CPUs and should, in theory
 // improve performance and reduce cpu power consumption.
 __fi void Threading::SpinWait()
@@ -104,6 +129,70 @@ void Threading::pxThread::_platform_specific_OnCleanupInThread()
 }
 
 void Threading::pxThread::_DoSetThreadName(const char *name)
+{
+    SetCurrentThreadName(name);
+}
+
+void Threading::SetCurrentThreadAffinity(u64 mask)
+{
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask);
+}
+
+u64 Threading::GetCurrentThreadAffinity()
+{
+    // There is no getter, setting a mask returns the previous one
+    DWORD_PTR process, system;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system))
+        return 0;
+
+    const DWORD_PTR mask = SetThreadAffinityMask(GetCurrentThread(), process);
+    if (mask)
+        SetThreadAffinityMask(GetCurrentThread(), mask);
+
+    return (u64)mask;
+}
+
+int Threading::GetCurrentCpu()
+{
+    return (int)GetCurrentProcessorNumber();
+}
+
+bool Threading::SetCurrentThreadPriority(int priority)
+{
+    const int level = priority > 0 ? THREAD_PRIORITY_ABOVE_NORMAL : priority < 0 ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_NORMAL;
+    return SetThreadPriority(GetCurrentThread(), level) != 0;
+}
+
+u64 Threading::GetHostCoreCpus()
+{
+    DWORD size = 0;
+    GetLogicalProcessorInformation(NULL, &size);
+    if (size == 0)
+        return 0;
+
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!GetLogicalProcessorInformation(info.data(), &size))
+        return 0;
+
+    u64 mask = 0;
+    for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION &i : info) {
+        if (i.Relationship == RelationProcessorCore && i.ProcessorMask)
+            mask |= (u64)(i.ProcessorMask & (~i.ProcessorMask + 1)); // the lowest sibling stands for the core
+    }
+
+    return mask;
+}
+
+u64 Threading::GetNumaNodeCpus(int node)
+{
+    ULONGLONG mask = 0;
+    if (node < 0 || node > 255 || !GetNumaNodeProcessorMask((UCHAR)node, &mask))
+        return 0;
+
+    return (u64)mask;
+}
+
+void Threading::SetCurrentThreadName(const char *name)
 {
 // This feature needs Windows headers and MSVC's SEH support:
 
@@ -180,10 +180,45 @@ __fi void xCVTTSS2SI(const xRegister32or64 &to, const xIndirect32 &from) { OpWri
 
 
 // ------------------------------------------------------------------------
+// Three operand forms: a single VEX encoded instruction when AVX is available, which saves
+// the recs the copy they'd otherwise need to keep from1 intact (SSE ops are destructive).
+//
+template <typename T>
+static void xOpWriteVEXorSSE(u8 prefix, u16 opcode, const xRegisterSSE &to, const xRegisterSSE &from1, const T &from2, bool intOp)
+{
+    if (x86caps.hasAVX) {
+        const u8 map = opcode & 0xff;
+        if (map == 0x38 || map == 0x3a)
+            xOpWriteC4(prefix, map, opcode >> 8, to, from1, from2, 0);
+        else
+            xOpWriteC5(prefix, opcode, to, from1, from2);
+        return;
+    }
+
+    if (to != from1) {
+        if (intOp)
+            xMOVDQA(to, from1);
+        else
+            xMOVAPS(to, from1);
+    }
+    xOpWrite0F(prefix, opcode, to, from2);
+}
+
+static __fi void CheckThreeOperands(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2)
+{
+    pxAssertDev(to == from1 || to != from2, "SSE three operand form: destination overwrites the second source");
+}
 
 void xImplSimd_DestRegSSE::operator()(const xRegisterSSE &to, const xRegisterSSE &from) const { OpWriteSSE(Prefix, Opcode); }
 void xImplSimd_DestRegSSE::operator()(const xRegisterSSE &to, const xIndirectVoid &from) const { OpWriteSSE(Prefix, Opcode); }
 
+void xImplSimd_DestRegSSE::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2) const
+{
+    CheckThreeOperands(to, from1, from2);
+    xOpWriteVEXorSSE(Prefix, Opcode, to, from1, from2, false);
+}
+void xImplSimd_DestRegSSE::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2) const { xOpWriteVEXorSSE(Prefix, Opcode, to, from1, from2, false); }
+
 void xImplSimd_DestRegImmSSE::operator()(const xRegisterSSE &to, const xRegisterSSE &from, u8 imm) const { xOpWrite0F(Prefix, Opcode, to, from, imm); }
 void xImplSimd_DestRegImmSSE::operator()(const xRegisterSSE &to, const xIndirectVoid &from, u8 imm) const { xOpWrite0F(Prefix, Opcode, to, from, imm); }
 
@@ -191,6 +226,13 @@ void xImplSimd_DestRegImmSSE::operator()(const xRegisterSSE &to, const xIndirect
 void xImplSimd_DestRegEither::operator()(const xRegisterSSE &to, const xRegisterSSE &from) const { OpWriteSSE(Prefix, Opcode); }
 void xImplSimd_DestRegEither::operator()(const xRegisterSSE &to, const xIndirectVoid &from) const { OpWriteSSE(Prefix, Opcode); }
 
+void xImplSimd_DestRegEither::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xRegisterSSE &from2) const
+{
+    CheckThreeOperands(to, from1, from2);
+    xOpWriteVEXorSSE(Prefix, Opcode, to, from1, from2, true);
+}
+void xImplSimd_DestRegEither::operator()(const xRegisterSSE &to, const xRegisterSSE &from1, const xIndirectVoid &from2) const { xOpWriteVEXorSSE(Prefix, Opcode, to, from1, from2, true); }
+
 
 void xImplSimd_DestSSE_CmpImm::operator()(const xRegisterSSE &to, const xRegisterSSE &from, SSE2_ComparisonType imm) const { xOpWrite0F(Prefix, Opcode, to, from, imm); }
 void xImplSimd_DestSSE_CmpImm::operator()(const xRegisterSSE &to, const xIndirectVoid &from, SSE2_ComparisonType imm) const { xOpWrite0F(Prefix, Opcode, to, from, imm); }
@@ -73,26 +73,6 @@ template void xWrite<u32>(u32 val);
 template void xWrite<u64>(u64 val);
 template void xWrite<u128>(u128 val);
 
-__fi void xWrite8(u8 val)
-{
-    xWrite(val);
-}
-
-__fi void xWrite16(u16 val)
-{
-    xWrite(val);
-}
-
-__fi void xWrite32(u32 val)
-{
-    xWrite(val);
-}
-
-__fi void xWrite64(u64 val)
-{
-    xWrite(val);
-}
-
 // Empty initializers are due to frivolously pointless GCC errors (it demands the
 // objects be initialized even though they have no actual variable members).
 
@@ -250,16 +230,31 @@ static __fi void SibSB(u32 ss, u32 index, u32 base)
     xWrite8((ss << 6) | (index << 3) | base);
 }
 
-void EmitSibMagic(uint regfield, const void *address)
+// extraRIPOffset - number of bytes the instruction emits after the displacement (ie, the size
+//   of any trailing immediate).  On x86_64 a bare disp32 ModRm is relative to the *end* of the
+//   instruction, so the emitter needs to know how far away that end is.
+//
+void EmitSibMagic(uint regfield, const void *address, int extraRIPOffset)
 {
-    ModRM(0, regfield, ModRm_UseDisp32);
-
-    // SIB encoding only supports 32bit offsets, even on x86_64
-    // We must make sure that the displacement is within the 32bit range
-    // Else we will fail out in a spectacular fashion
     sptr displacement = (sptr)address;
+
 #ifdef __x86_64__
-    pxAssertDev(displacement >= -0x80000000LL && displacement < 0x80000000LL, "SIB target is too far away, needs an indirect register");
+    // Prefer the rip-relative form whenever the target is within +/-2GB of the code (this is
+    // the common case for recompiler state like cpuRegs, and it is a byte shorter than the SIB
+    // form).  Otherwise fall back to an absolute disp32, which requires a SIB with neither base
+    // nor index.  Both forms only support 32bit offsets, so anything else is a fatal error.
+    sptr ripRelative = displacement - ((sptr)x86Ptr + 1 + 4 + extraRIPOffset);
+
+    if (ripRelative == (s32)ripRelative) {
+        ModRM(0, regfield, ModRm_UseDisp32);
+        displacement = ripRelative;
+    } else {
+        pxAssertDev(displacement == (s32)displacement, "SIB target is too far away, needs an indirect register");
+        ModRM(0, regfield, ModRm_UseSib);
+        SibSB(0, ModRm_UseSib, ModRm_UseDisp32); // index=ESP means no index, base=EBP means disp32
+    }
+#else
+    ModRM(0, regfield, ModRm_UseDisp32);
 #endif
 
     xWrite<s32>((s32)displacement);
@@ -293,7 +288,7 @@ static __fi bool NeedsSibMagic(const xIndirectVoid &info)
 // regfield - register field to be written to the ModRm.  This is either a register specifier
 //   or an opcode extension.  In either case, the instruction determines the value for us.
 //
-void EmitSibMagic(uint regfield, const xIndirectVoid &info)
+void EmitSibMagic(uint regfield, const xIndirectVoid &info, int extraRIPOffset)
 {
     // 3 bits also on x86_64 (so max is 8)
     // We might need to mask it on x86_64
@@ -310,7 +305,7 @@ void EmitSibMagic(uint regfield, const xIndirectVoid &info)
         // encoded *with* a displacement of 0, if it would otherwise not have one).
 
         if (info.Index.IsEmpty()) {
-            EmitSibMagic(regfield, (void *)info.Displacement);
+            EmitSibMagic(regfield, (void *)info.Displacement, extraRIPOffset);
             return;
         } else {
             if (info.Index == ebp && displacement_size == 0)
@@ -347,41 +342,20 @@ void EmitSibMagic(uint regfield, const xIndirectVoid &info)
     }
 }
 
-// Writes a ModRM byte for "Direct" register access forms, which is used for all
-// instructions taking a form of [reg,reg].
-void EmitSibMagic(uint reg1, const xRegisterBase &reg2)
-{
-    xWrite8((Mod_Direct << 6) | (reg1 << 3) | reg2.Id);
-}
-
-void EmitSibMagic(const xRegisterBase &reg1, const xRegisterBase &reg2)
+void EmitSibMagic(const xRegisterBase &reg1, const void *src, int extraRIPOffset)
 {
-    xWrite8((Mod_Direct << 6) | (reg1.Id << 3) | reg2.Id);
+    EmitSibMagic(reg1.Id, src, extraRIPOffset);
 }
 
-void EmitSibMagic(const xRegisterBase &reg1, const void *src)
+void EmitSibMagic(const xRegisterBase &reg1, const xIndirectVoid &sib, int extraRIPOffset)
 {
-    EmitSibMagic(reg1.Id, src);
-}
-
-void EmitSibMagic(const xRegisterBase &reg1, const xIndirectVoid &sib)
-{
-    EmitSibMagic(reg1.Id, sib);
+    EmitSibMagic(reg1.Id, sib, extraRIPOffset);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
-__emitinline static void EmitRex(bool w, bool r, bool x, bool b)
-{
-#ifdef __x86_64__
-    u8 rex = 0x40 | (w << 3) | (r << 2) | (x << 1) | b;
-    if (rex != 0x40)
-        xWrite8(rex);
-#endif
-}
-
 void EmitRex(uint regfield, const void *address)
 {
-    pxAssert(0);
+    // Direct addresses never have a base or index register (rip-relative or disp32 forms).
     bool w = false;
     bool r = false;
     bool x = false;
@@ -398,31 +372,12 @@ void EmitRex(uint regfield, const xIndirectVoid &info)
     EmitRex(w, r, x, b);
 }
 
-void EmitRex(uint reg1, const xRegisterBase &reg2)
-{
-    bool w = reg2.IsWide();
-    bool r = false;
-    bool x = false;
-    bool b = reg2.IsExtended();
-    EmitRex(w, r, x, b);
-}
-
-void EmitRex(const xRegisterBase &reg1, const xRegisterBase &reg2)
-{
-    bool w = reg1.IsWide();
-    bool r = reg1.IsExtended();
-    bool x = false;
-    bool b = reg2.IsExtended();
-    EmitRex(w, r, x, b);
-}
-
 void EmitRex(const xRegisterBase &reg1, const void *src)
 {
-    pxAssert(0); //see fixme
     bool w = reg1.IsWide();
     bool r = reg1.IsExtended();
     bool x = false;
-    bool b = false; // FIXME src.IsExtended();
+    bool b = false;
     EmitRex(w, r, x, b);
 }
 
@@ -888,7 +843,7 @@ void xImpl_Test::operator()(const xRegisterInt &to, const xRegisterInt &from) co
 
 void xImpl_Test::operator()(const xIndirect64orLess &dest, int imm) const
 {
-    xOpWrite(dest.GetPrefix16(), dest.Is8BitOp() ? 0xf6 : 0xf7, 0, dest);
+    xOpWrite(dest.GetPrefix16(), dest.Is8BitOp() ? 0xf6 : 0xf7, 0, dest, dest.GetImmSize());
     dest.xWriteImm(imm);
 }
 
@@ -53,6 +53,14 @@ public:
 	virtual void SetBlockSize(uint bytes) {}
 	virtual void SetDataOffset(int bytes) {}
 
+	// Direct access to the data of the given sectors, for readers that have the whole image
+	// in memory (mapped). Returns NULL if unsupported or out of range.
+	virtual const u8* GetSectorPointer(uint sector, uint count) { return NULL; }
+
+	// The buffer all the following multi sector reads land in, for readers that can register
+	// it with the kernel once instead of mapping it again on every read.
+	virtual void SetReadBuffer(void* buffer, size_t size) {}
+
 	uint GetBlockSize() const { return m_blocksize; }
 
 	const wxString& GetFilename() const
@@ -76,6 +84,10 @@ class FlatFileReader : public AsyncFileReader
 #elif defined(__linux__)
 	int m_fd; // FIXME don't know if overlap as an equivalent on linux
 	io_context_t m_aio_context;
+
+	// io_uring backend, used instead of libaio when the kernel supports it
+	struct UringContext;
+	std::unique_ptr<UringContext> m_uring;
 #elif defined(__POSIX__)
 	int m_fd; // TODO OSX don't know if overlap as an equivalent on OSX
 	struct aiocb m_aiocb;
@@ -102,7 +114,60 @@ public:
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
 	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+
+#ifdef __linux__
+	virtual void SetReadBuffer(void* buffer, size_t size);
+#endif
+};
+
+#ifdef __linux__
+// --------------------------------------------------------------------------------------
+//  MappedFileReader
+// --------------------------------------------------------------------------------------
+// Reads an uncompressed image through a memory mapped window of the file, so sectors can be
+// copied straight out of the page cache without a syscall (see GetSectorPointer). Refuses
+// to open files on network filesystems, whose page faults would stall the EE thread.
+class MappedFileReader : public AsyncFileReader
+{
+	DeclareNoncopyableObject( MappedFileReader );
+
+	static const u64 ViewSize = _64mb;
+	static const u64 ReadAheadSize = _1mb * 4;
+
+	int m_fd;
+	u64 m_filesize;
+
+	u8* m_view;
+	u64 m_view_offset;
+	u64 m_view_size;
+	u64 m_advised; // end of the range we asked the kernel to read ahead
+
+	int m_bytesRead;
+
+	bool MapView(u64 offset, u64 size);
+
+public:
+	MappedFileReader();
+	virtual ~MappedFileReader(void);
+
+	virtual bool Open(const wxString& fileName);
+
+	virtual int ReadSync(void* pBuffer, uint sector, uint count);
+
+	virtual void BeginRead(void* pBuffer, uint sector, uint count);
+	virtual int FinishRead(void);
+	virtual void CancelRead(void);
+
+	virtual void Close(void);
+
+	virtual uint GetBlockCount(void) const;
+
+	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
+	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+
+	virtual const u8* GetSectorPointer(uint sector, uint count);
 };
+#endif
 
 class MultipartFileReader : public AsyncFileReader
 {
@@ -138,6 +203,7 @@ public:
 	virtual uint GetBlockCount(void) const;
 
 	virtual void SetBlockSize(uint bytes);
+	virtual void SetReadBuffer(void* buffer, size_t size);
 
 	static AsyncFileReader* DetectMultipart(AsyncFileReader* reader);
 };
@@ -0,0 +1,361 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Benchmark.h"
+#include "App.h"
+#include "Common.h"
+#include "Counters.h"
+#include "Elfheader.h"
+#include "IopBios.h"
+#include "IopMem.h"
+#include "Patch.h"
+#include "R5900.h"
+#include "ps2/BiosTools.h"
+#include "gui/CpuUsageProvider.h"
+#include "DebugTools/RecProfiler.h"
+#include "Utilities/AsciiFile.h"
+
+#ifndef DISABLE_RECORDING
+#	include "Recording/InputRecording.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Benchmark
+{
+
+enum State
+{
+	State_Idle = 0,
+	State_Armed,		// Start() was called; the baseline is taken at the next vsync
+	State_Running,
+	State_Done,			// report written, waiting for the app to exit
+};
+
+static const char* const RecNames[RecProfiler::Source_Count] = { "ee", "iop", "vu0", "vu1" };
+
+static std::atomic<int> s_state(State_Idle);
+
+// Set before Start(), read-only afterwards.
+static uint s_frames = 0;				// 0 until the replay ends
+static uint s_segmentFrames = 0;
+static wxString s_reportFile;
+
+// Core thread only.
+static AllPCSX2Threads s_begin;
+static RecProfiler::RecStats s_recBegin[RecProfiler::Source_Count];
+static std::vector<u64> s_frameTicks;
+static u64 s_lastTick = 0;
+static u32 s_firstFrame = 0;
+static u32 s_eventTestsBegin = 0;
+static u32 s_patchWritesBegin = 0;
+static u32 s_iopHleCallsBegin = 0;
+static std::vector<u32> s_hwReadsBegin;
+
+void Setup(uint frames, uint segmentFrames, const wxString& reportFile)
+{
+	s_frames = frames;
+	s_segmentFrames = std::max(segmentFrames, 1u);
+	s_reportFile = reportFile;
+
+	// Before anything is recompiled, so that direct register loads are counted too.
+	hwReadStatsEnabled = true;
+}
+
+void Start()
+{
+	s_state.store(State_Armed, std::memory_order_release);
+}
+
+bool IsActive()
+{
+	return s_state.load(std::memory_order_relaxed) != State_Idle;
+}
+
+static std::string JsonString(const wxString& str)
+{
+	std::string out("\"");
+
+	for (const char c : std::string(str.ToUTF8()))
+	{
+		if (c == '"' || c == '\\')
+			out += '\\';
+		if ((u8)c >= 0x20)
+			out += c;
+	}
+
+	return out + "\"";
+}
+
+static double TicksToMs(u64 ticks)
+{
+	return ticks * 1000.0 / GetTickFrequency();
+}
+
+static void WriteThread(AsciiFile& out, const char* name, u64 cpuTime, double seconds, bool last)
+{
+	const double cpuSec = (double)cpuTime / GetThreadTicksPerSecond();
+
+	out.Printf("\t\t\"%s\": { \"cpu_sec\": %.3f, \"busy_pct\": %.1f }%s\n",
+		name, cpuSec, cpuSec * 100.0 / seconds, last ? "" : ",");
+}
+
+// Resident memory of the PS2 memory regions, for host density planning.  Pages of the rom
+// regions mapped with ShareRomMemory are counted here but shared with other instances.
+static void WriteResident(AsciiFile& out)
+{
+	const struct { const char* name; const void* base; size_t size; } regions[] = {
+		{ "ee_main",	eeMem->Main,	Ps2MemSize::MainRam },
+		{ "rom",		eeMem->ROM,		Ps2MemSize::Rom },
+		{ "rom1",		eeMem->ROM1,	Ps2MemSize::Rom1 },
+		{ "rom2",		eeMem->ROM2,	Ps2MemSize::Rom2 },
+		{ "erom",		eeMem->EROM,	Ps2MemSize::ERom },
+		{ "iop_main",	iopMem->Main,	Ps2MemSize::IopRam },
+	};
+
+	out.Printf("\t\"resident_kb\": {");
+	for (uint i = 0; i < ArraySize(regions); ++i)
+	{
+		const s64 bytes = HostSys::GetResidentBytes(regions[i].base, regions[i].size);
+		if (bytes < 0)
+			out.Printf(" \"%s\": null", regions[i].name);
+		else
+			out.Printf(" \"%s\": %u", regions[i].name, (uint)(bytes / 1024));
+		out.Printf("%s", (i + 1 < ArraySize(regions)) ? "," : "");
+	}
+	out.Printf(" },\n");
+	out.Printf("\t\"rom_mapped_kb\": %u,\n", BiosRomBytesMapped / 1024);
+}
+
+// The most read hardware registers over the run.
+static void WriteHwReads(AsciiFile& out, uint frames)
+{
+	static const uint TopCount = 16;
+
+	std::vector< std::pair<u32, u32> > reads;
+	for (uint i = 0; i < HwReadStatCount; ++i)
+	{
+		const u32 count = hwReadStats[i] - s_hwReadsBegin[i];
+		if (count) reads.push_back(std::make_pair(count, 0x10000000 + i * 4));
+	}
+
+	const size_t top = std::min<size_t>(reads.size(), TopCount);
+	std::partial_sort(reads.begin(), reads.begin() + top, reads.end(), std::greater< std::pair<u32, u32> >());
+
+	out.Printf("\t\"hw_reads_per_frame\": {");
+	for (size_t i = 0; i < top; ++i)
+		out.Printf("%s \"%08x\": %.1f", i ? "," : "", reads[i].second, (double)reads[i].first / frames);
+	out.Printf(" },\n");
+}
+
+// Timings of consecutive runs of s_segmentFrames frames, to locate the slow parts of a replay.
+static void WriteSegments(AsciiFile& out)
+{
+	out.Printf("\t\"segment_frames\": %u,\n", s_segmentFrames);
+	out.Printf("\t\"segments\": [");
+
+	for (size_t first = 0; first < s_frameTicks.size(); first += s_segmentFrames)
+	{
+		const size_t last = std::min(first + s_segmentFrames, s_frameTicks.size());
+		u64 total = 0, longest = 0;
+		for (size_t i = first; i < last; ++i)
+		{
+			total += s_frameTicks[i];
+			longest = std::max(longest, s_frameTicks[i]);
+		}
+
+		out.Printf("%s\n\t\t{ \"first_frame\": %u, \"frames\": %u, \"elapsed_ms\": %.3f, \"max_ms\": %.3f }",
+			first ? "," : "", s_firstFrame + (uint)first, (uint)(last - first), TicksToMs(total), TicksToMs(longest));
+	}
+
+	out.Printf("\n\t],\n");
+}
+
+static u64 HashMemory(u64 hash, const void* data, size_t size)
+{
+	// FNV-1a over 64 bit words, fast enough for the 32 MB of EE memory.
+	const u64* src = (const u64*)data;
+	for (size_t i = 0; i < size / 8; ++i)
+	{
+		hash ^= src[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+// Hashes of the final machine state.  Two runs of the same replay with the same settings
+// must end with the same values; the GS state includes the local memory (VRAM).
+static void WriteStateHashes(AsciiFile& out)
+{
+	const u64 basis = 0xcbf29ce484222325ull;
+
+	out.Printf("\t\"state_hash\": { \"ee_ram\": \"%016llx\", \"iop_ram\": \"%016llx\"",
+		(unsigned long long)HashMemory(basis, eeMem->Main, Ps2MemSize::MainRam),
+		(unsigned long long)HashMemory(basis, iopMem->Main, Ps2MemSize::IopRam));
+
+	try
+	{
+		std::vector<u8> gs(GetCorePlugins().GetFreezeSize(PluginId_GS));
+		if (!gs.empty())
+		{
+			GetCorePlugins().FreezeOut(PluginId_GS, gs.data());
+			out.Printf(", \"gs\": \"%016llx\"", (unsigned long long)HashMemory(basis, gs.data(), gs.size()));
+		}
+		else
+			out.Printf(", \"gs\": null");
+	}
+	catch (BaseException& ex)
+	{
+		Console.Warning(L"(Benchmark) The GS state could not be hashed: %s", WX_STR(ex.FormatDiagnosticMessage()));
+		out.Printf(", \"gs\": null");
+	}
+
+	out.Printf(" },\n");
+}
+
+static void WriteReport(bool replayEnded)
+{
+	AllPCSX2Threads end;
+	end.LoadWithCurrentTimes();
+	const AllPCSX2Threads delta(end - s_begin);
+
+	std::vector<u64> sorted(s_frameTicks);
+	std::sort(sorted.begin(), sorted.end());
+
+	const size_t count = sorted.size();
+	u64 total = 0;
+	for (u64 ticks : sorted)
+		total += ticks;
+
+	// Nearest-rank percentile.
+	const u64 p99 = sorted[(count * 99 + 99) / 100 - 1];
+	const double seconds = std::max((double)total / GetTickFrequency(), 1e-9);
+
+	wxString filename(s_reportFile);
+	if (filename.IsEmpty())
+	{
+		g_Conf->Folders.Logs.Mkdir();
+		filename = Path::Combine(g_Conf->Folders.Logs, L"benchmark.json");
+	}
+
+	AsciiFile out(filename, L"w");
+	if (!out.IsOpened())
+	{
+		Console.Error(L"(Benchmark) Could not write the report to %s", WX_STR(filename));
+		return;
+	}
+
+	out.Printf("{\n");
+	out.Printf("\t\"serial\": %s,\n", JsonString(SysGetDiscID()).c_str());
+	out.Printf("\t\"crc\": \"%08x\",\n", ElfCRC);
+	out.Printf("\t\"first_frame\": %u,\n", s_firstFrame);
+	out.Printf("\t\"frames\": %u,\n", (uint)count);
+	out.Printf("\t\"frames_requested\": %u,\n", s_frames);
+	out.Printf("\t\"replay_ended\": %s,\n", replayEnded ? "true" : "false");
+	out.Printf("\t\"elapsed_sec\": %.3f,\n", seconds);
+	out.Printf("\t\"fps\": %.2f,\n", count / seconds);
+	out.Printf("\t\"ee_event_tests_per_frame\": %.1f,\n", (double)(g_eeEventTests - s_eventTestsBegin) / count);
+	out.Printf("\t\"patch_writes_per_frame\": %.1f,\n", (double)(g_patchWrites - s_patchWritesBegin) / count);
+	out.Printf("\t\"iop_hle_calls_per_frame\": %.1f,\n", (double)(g_iopHleCalls - s_iopHleCallsBegin) / count);
+	out.Printf("\t\"frame_ms\": { \"min\": %.3f, \"avg\": %.3f, \"p99\": %.3f, \"max\": %.3f },\n",
+		TicksToMs(sorted.front()), TicksToMs(total) / count, TicksToMs(p99), TicksToMs(sorted.back()));
+
+	WriteSegments(out);
+	WriteStateHashes(out);
+	WriteHwReads(out, count);
+	WriteResident(out);
+
+	out.Printf("\t\"mtvu\": %s,\n", THREAD_VU1 ? "true" : "false");
+	if (GetThreadTicksPerSecond() != 0)
+	{
+		out.Printf("\t\"threads\": {\n");
+		WriteThread(out, "ee", delta.ee, seconds, false);
+		WriteThread(out, "gs", delta.gs, seconds, false);
+		WriteThread(out, "vu", delta.vu, seconds, true);
+		out.Printf("\t},\n");
+	}
+	else
+		out.Printf("\t\"threads\": null,\n");
+
+	out.Printf("\t\"recompilers\": {\n");
+	for (int src = 0; src < RecProfiler::Source_Count; ++src)
+	{
+		const RecProfiler::RecStats stats = RecProfiler::GetStats((RecProfiler::Source)src);
+		out.Printf("\t\t\"%s\": { \"blocks\": %u, \"x86_bytes\": %u, \"resets\": %u }%s\n", RecNames[src],
+			stats.blocks - s_recBegin[src].blocks, stats.x86bytes - s_recBegin[src].x86bytes,
+			stats.resets - s_recBegin[src].resets, (src + 1 < RecProfiler::Source_Count) ? "," : "");
+	}
+	out.Printf("\t}\n");
+	out.Printf("}\n");
+
+	Console.WriteLn(Color_StrongBlue, "(Benchmark) %u frames in %.2f sec: %.2f fps (frame min %.2f ms, p99 %.2f ms)",
+		(uint)count, seconds, count / seconds, TicksToMs(sorted.front()), TicksToMs(p99));
+	Console.WriteLn(L"(Benchmark) Report written to %s", WX_STR(filename));
+}
+
+void Vsync()
+{
+	const int state = s_state.load(std::memory_order_acquire);
+	if (state != State_Armed && state != State_Running) return;
+
+	const u64 now = GetCPUTicks();
+
+	if (state == State_Armed)
+	{
+		s_begin.LoadWithCurrentTimes();
+		for (int src = 0; src < RecProfiler::Source_Count; ++src)
+			s_recBegin[src] = RecProfiler::GetStats((RecProfiler::Source)src);
+
+		s_eventTestsBegin = g_eeEventTests;
+		s_patchWritesBegin = g_patchWrites;
+		s_iopHleCallsBegin = g_iopHleCalls;
+		s_hwReadsBegin.assign(hwReadStats, hwReadStats + HwReadStatCount);
+
+		s_frameTicks.clear();
+		s_frameTicks.reserve(s_frames ? s_frames : 60 * 60 * 10);
+		s_lastTick = now;
+		s_firstFrame = g_FrameCount;
+		s_state = State_Running;
+
+		if (s_frames)
+			Console.WriteLn(Color_StrongBlue, "(Benchmark) Measuring %u frames, starting at frame %u.", s_frames, g_FrameCount);
+		else
+			Console.WriteLn(Color_StrongBlue, "(Benchmark) Measuring until the replay ends, starting at frame %u.", g_FrameCount);
+		return;
+	}
+
+	s_frameTicks.push_back(now - s_lastTick);
+	s_lastTick = now;
+
+	// The replay pauses the VM when it runs out, so stop with whatever was measured.
+	bool replayEnded = false;
+#ifndef DISABLE_RECORDING
+	if (g_Conf->EmuOptions.EnableRecordingTools && g_InputRecording.GetModeState() == INPUT_RECORDING_MODE_REPLAY)
+		replayEnded = (g_InputRecording.GetInputRecordingData().GetMaxFrame() <= g_FrameCount);
+#endif
+
+	if ((!s_frames || s_frameTicks.size() < s_frames) && !replayEnded) return;
+
+	s_state = State_Done;
+	WriteReport(replayEnded);
+	sApp.PostAppMethod(&Pcsx2App::PrepForExit);
+}
+
+}
@@ -0,0 +1,47 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Pcsx2Types.h"
+
+// --------------------------------------------------------------------------------------
+//  Benchmark
+// --------------------------------------------------------------------------------------
+// Command line benchmark mode (--benchmark).  Once started, the frame limiter is bypassed
+// and the next N frames (or all the frames of the replayed input recording) are timed on
+// the core thread.  At the end a JSON report (frame times, per segment timings, EE event
+// tests, patch writes, IOP HLE calls, most read hardware registers, resident memory of the
+// PS2 memory regions, EE/GS/VU thread cpu time, recompiler activity, and hashes of the final
+// EE/IOP memory and GS state for determinism checks) is written and the app is asked to exit.
+//
+// Setup() is called at startup; Start() is posted to the SysExecutor after the boot and
+// savestate load events, so that measuring begins at the first frame of actual play.
+//
+namespace Benchmark
+{
+	// Frame count (0 runs until the input recording ends), frames per timed segment, and
+	// report file; an empty report name writes benchmark.json to the logs folder.  Must be
+	// called before Start().
+	extern void Setup(uint frames, uint segmentFrames, const wxString& reportFile);
+
+	// Begins measuring at the next vsync.  May be called from any thread.
+	extern void Start();
+
+	// True from Start() until exit; the frame limiter is skipped meanwhile.
+	extern bool IsActive();
+
+	// Called once per vsync from the core thread.
+	extern void Vsync();
+}
@@ -0,0 +1,198 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "BootSnapshot.h"
+#include "SaveState.h"
+#include "CDVD/CDVD.h"
+#include "CDVD/CDVDaccess.h"
+#include "ps2/BiosTools.h"
+#include "AppConfig.h"
+
+#include <wx/ffile.h>
+
+namespace BootSnapshot
+{
+
+static const u32 SnapshotMagic = 0x746f6f42; // 'Boot'
+
+struct SnapshotHeader
+{
+	u32 magic;
+	u32 version;	// g_SaveVersion
+	u64 key;
+	u32 size;		// bytes of state following the header
+	u32 reserved;
+};
+
+static u64 HashBytes( u64 hash, const void* data, size_t size )
+{
+	const u8* p = (const u8*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= p[i];
+		hash *= 0x100000001b3ull; // FNV-1a
+	}
+	return hash;
+}
+
+// Everything the state at EELOAD depends on, besides the BIOS code itself.
+static u64 ComputeKey()
+{
+	const u32 settings[] =
+	{
+		g_SaveVersion, BiosChecksum, BiosVersion,
+		EmuConfig.Cpu.Recompiler.bitset, EmuConfig.Speedhacks.bitset,
+		(u32)EmuConfig.Speedhacks.EECycleRate, EmuConfig.Speedhacks.EECycleSkip,
+		EmuConfig.Gamefixes.bitset, EmuConfig.HostFs,
+		EmuConfig.MultitapPort0_Enabled, EmuConfig.MultitapPort1_Enabled,
+		(u32)DoCDVDdetectDiskType()
+	};
+
+	u64 hash = HashBytes( 0xcbf29ce484222325ull, settings, sizeof(settings) );
+
+	// Plugins freeze their own state, so a different plugin (or version) can't load it.
+	const PluginInfo* pi = tbl_PluginInfo; do
+	{
+		const wxCharBuffer name( (GetCorePlugins().GetName( pi->id ) + L" " + GetCorePlugins().GetVersion( pi->id )).utf8_str() );
+		hash = HashBytes( hash, name.data(), strlen(name.data()) );
+	} while( ++pi, pi->shortname != NULL );
+
+	return hash;
+}
+
+static wxString GetFilename( u64 key )
+{
+	return Path::Combine( PathDefs::GetCache(), wxsFormat( L"boot-%016llx.state", (unsigned long long)key ) );
+}
+
+static bool IsUsable()
+{
+	return EmuConfig.FastBootSnapshot && g_SkipBiosHack && CHECK_EEREC && g_Conf->CurrentIRX.IsEmpty();
+}
+
+// The boot in progress was loaded from a snapshot (no need to check for one at EELOAD).
+static bool s_booted = false;
+
+void Capture()
+{
+	if (s_booted || !IsUsable()) return;
+
+	const u64 key = ComputeKey();
+	const wxString file( GetFilename( key ) );
+	if (wxFileExists( file )) return;
+
+	try
+	{
+		VmStateBuffer state( L"BootSnapshot" );
+		memSavingState save( state );
+		save.FreezeAll();
+
+		SnapshotHeader header;
+		memzero( header );
+		header.magic	= SnapshotMagic;
+		header.version	= g_SaveVersion;
+		header.key		= key;
+		header.size		= save.GetCurrentPos();
+
+		// Written aside and renamed, so that another instance never loads half a snapshot.
+		PathDefs::GetCache().Mkdir();
+		const wxString temp( file + wxsFormat( L".%lu", wxGetProcessId() ) );
+		bool ok;
+		{
+			wxFFile fp( temp, L"wb" );
+			ok = fp.IsOpened();
+			ok = ok && fp.Write( &header, sizeof(header) ) == sizeof(header);
+			ok = ok && fp.Write( state.GetPtr(), header.size ) == header.size;
+		}
+
+		if (ok && wxRenameFile( temp, file, true ))
+			Console.WriteLn( Color_StrongGreen, L"Fast boot: BIOS snapshot saved to %s", WX_STR(file) );
+		else
+		{
+			wxRemoveFile( temp );
+			Console.Warning( L"Fast boot: could not write the BIOS snapshot to %s", WX_STR(file) );
+		}
+	}
+	catch (BaseException& ex)
+	{
+		Console.Warning( L"Fast boot: the BIOS snapshot was not saved: %s", WX_STR(ex.FormatDiagnosticMessage()) );
+	}
+}
+
+bool Boot()
+{
+	s_booted = false;
+	if (!IsUsable()) return false;
+
+	const u64 key = ComputeKey();
+	const wxString file( GetFilename( key ) );
+	if (!wxFileExists( file )) return false;
+
+	const u64 start = GetCPUTicks();
+
+	VmStateBuffer state( L"BootSnapshot" );
+	{
+		wxFFile fp( file, L"rb" );
+		SnapshotHeader header;
+
+		bool ok = fp.IsOpened() && fp.Read( &header, sizeof(header) ) == sizeof(header);
+		ok = ok && header.magic == SnapshotMagic && header.version == g_SaveVersion && header.key == key;
+		ok = ok && header.size > 0 && fp.Length() == (wxFileOffset)(sizeof(header) + header.size);
+
+		if (ok)
+		{
+			state.ExactAlloc( header.size );
+			ok = fp.Read( state.GetPtr(), header.size ) == header.size;
+		}
+
+		if (!ok)
+		{
+			Console.Warning( L"Fast boot: ignoring the invalid BIOS snapshot %s", WX_STR(file) );
+			fp.Close();
+			wxRemoveFile( file );
+			return false;
+		}
+	}
+
+	// The clock was just set from the host by the reset, the snapshot's one is from its capture.
+	const cdvdRTC rtc = cdvd.RTC;
+
+	try
+	{
+		memLoadingState( state ).FreezeAll();
+	}
+	catch (BaseException& ex)
+	{
+		Console.Warning( L"Fast boot: the BIOS snapshot could not be loaded: %s", WX_STR(ex.FormatDiagnosticMessage()) );
+		cpuReset();
+		return false;
+	}
+
+	cdvd.RTC = rtc;
+	cdvdNewDiskCB();
+
+	// The EELOAD _start block won't run again, main has to be known before it is recompiled.
+	eeloadFindMain();
+
+	s_booted = true;
+
+	Console.WriteLn( Color_StrongGreen, L"Fast boot: BIOS snapshot loaded in %.1f ms (%.2f s of BIOS skipped)",
+		(GetCPUTicks() - start) * 1000.0 / GetTickFrequency(), (double)cpuRegs.cycle / PS2CLK );
+	return true;
+}
+
+}
@@ -0,0 +1,41 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// --------------------------------------------------------------------------------------
+//  BootSnapshot
+// --------------------------------------------------------------------------------------
+// Fast boot from a pre-initialized BIOS.  Booting spends its first seconds in the kernel
+// and IOP module setup, which is the same for every boot with the same BIOS, settings and
+// plugins.  The first fast boot freezes the VM into the cache folder at the point where the
+// BIOS starts EELOAD (eeloadHook, before a game is chosen), and the following boots load
+// that state right after the reset instead of running the BIOS up to there.
+//
+// The snapshot is keyed on everything that can change how the BIOS initializes (BIOS,
+// emulation settings, plugins, disc type), and a mismatch simply writes a new one.  The
+// clock and the disc are refreshed after the load, as they are the only host inputs the
+// game may read differently.  Only used with the EE recompiler (the interpreter's EELOAD
+// detection steps past the restored pc), and never with an injected IRX.
+//
+namespace BootSnapshot
+{
+	// Called from eeloadHook on the first EELOAD call: writes the snapshot if none matches.
+	extern void Capture();
+
+	// Called from the core thread right after a VM reset; loads the matching snapshot.
+	// Returns false (and leaves the reset VM alone) if there is none.
+	extern bool Boot();
+}
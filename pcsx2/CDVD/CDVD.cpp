@@ -18,8 +18,10 @@
 #include "AppConfig.h"
 
 #include <memory>
+#include <unordered_map>
 #include <ctype.h>
 #include <wx/datetime.h>
+#include <wx/filename.h>
 
 #include "CdRom.h"
 #include "CDVD.h"
@@ -49,7 +51,8 @@ static __fi void SetResultSize(u8 size)
 	cdvd.sDataIn&=~0x40;
 }
 
-static void CDVDREAD_INT(u32 eCycle)
+// sectors: number of sectors read in eCycle each (see cdvdReadCachedSectors)
+static void CDVDREAD_INT(u32 eCycle, uint sectors = 1)
 {
 	// Give it an arbitary FAST value. Good for ~5000kb/s in ULE when copying a file from CDVD to HDD
 	// Keep long seeks out though, as games may try to push dmas while seeking. (Tales of the Abyss)
@@ -58,7 +61,7 @@ static void CDVDREAD_INT(u32 eCycle)
 			eCycle = 3000;
 	}
 	
-	PSX_INT(IopEvt_CdvdRead, eCycle);
+	PSX_INT(IopEvt_CdvdRead, eCycle * sectors);
 }
 
 static void CDVD_INT(int eCycle)
@@ -348,6 +351,101 @@ static __fi ElfObject* loadElf( const wxString filename )
 	return new ElfObject(fixedname, file);
 }
 
+// --------------------------------------------------------------------------------------
+//  Boot ELF info cache
+// --------------------------------------------------------------------------------------
+// The game CRC is computed over the whole boot ELF, which has to be read from the image at
+// every boot: several MBs of possibly compressed or networked data.  The results are kept
+// in the cache folder, keyed on the image file (path, size and modification time), its
+// primary volume descriptor and the ELF path.  Discs read through the plugin, and ELFs with
+// a symbol table (needed by the debugger), aren't cached.
+//
+// Accessed with Mutex_NewDiskCB held.
+
+struct ElfInfo
+{
+	u32 crc;
+	u32 entry;
+	std::pair<u32,u32> text;
+};
+
+static std::unordered_map<u64, ElfInfo> s_elfInfoCache;
+static bool s_elfInfoCacheLoaded = false;
+
+static wxString GetElfInfoCacheFile()
+{
+	return Path::Combine( PathDefs::GetCache(), L"elfinfo.txt" );
+}
+
+static u64 HashElfInfoBytes( u64 hash, const void* data, size_t size )
+{
+	const u8* p = (const u8*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= p[i];
+		hash *= 0x100000001b3ull; // FNV-1a
+	}
+	return hash;
+}
+
+// 0 if the source can't be identified.
+static u64 GetElfInfoKey( const wxString& elfpath )
+{
+	if (CDVDsys_GetSourceType() != CDVD_SourceType::Iso) return 0;
+
+	const wxFileName image( CDVDsys_GetFile( CDVD_SourceType::Iso ) );
+	if (!image.FileExists()) return 0;
+
+	u8 pvd[2048];
+	if (DoCDVDreadSector( pvd, 16, CDVD_MODE_2048 ) < 0) return 0;
+
+	const u64 stamp[] = { image.GetSize().GetValue(), (u64)image.GetModificationTime().GetTicks() };
+	const wxCharBuffer imagename( image.GetFullPath().utf8_str() );
+	const wxCharBuffer elfname( elfpath.utf8_str() );
+
+	u64 hash = HashElfInfoBytes( 0xcbf29ce484222325ull, imagename.data(), strlen(imagename.data()) );
+	hash = HashElfInfoBytes( hash, stamp, sizeof(stamp) );
+	hash = HashElfInfoBytes( hash, pvd, sizeof(pvd) );
+	hash = HashElfInfoBytes( hash, elfname.data(), strlen(elfname.data()) );
+	return hash ? hash : 1;
+}
+
+static bool FindElfInfo( u64 key, ElfInfo& info )
+{
+	if (!s_elfInfoCacheLoaded)
+	{
+		s_elfInfoCacheLoaded = true;
+
+		if (FILE* f = wxFopen( GetElfInfoCacheFile(), L"r" ))
+		{
+			unsigned long long k;
+			ElfInfo e;
+			while (fscanf( f, "%llx %x %x %x %x", &k, &e.crc, &e.entry, &e.text.first, &e.text.second ) == 5)
+				s_elfInfoCache[k] = e;
+			fclose( f );
+		}
+	}
+
+	auto it = s_elfInfoCache.find( key );
+	if (it == s_elfInfoCache.end()) return false;
+
+	info = it->second;
+	return true;
+}
+
+static void StoreElfInfo( u64 key, const ElfInfo& info )
+{
+	s_elfInfoCache[key] = info;
+
+	// One line per entry, appended, so that other instances don't lose theirs.
+	PathDefs::GetCache().Mkdir();
+	if (FILE* f = wxFopen( GetElfInfoCacheFile(), L"a" ))
+	{
+		fprintf( f, "%016llx %08x %08x %08x %08x\n", (unsigned long long)key, info.crc, info.entry, info.text.first, info.text.second );
+		fclose( f );
+	}
+}
+
 static __fi void _reloadElfInfo(wxString elfpath)
 {
 	// Now's a good time to reload the ELF info...
@@ -364,6 +462,18 @@ static __fi void _reloadElfInfo(wxString elfpath)
 	if (fname.Matches(L"????_???.??*"))
 		DiscSerial = fname(0,4) + L"-" + fname(5,3) + fname(9,2);
 
+	const u64 key = elfpath.StartsWith(L"host") ? 0 : GetElfInfoKey(elfpath);
+	ElfInfo info;
+
+	if (key && FindElfInfo(key, info))
+	{
+		ElfCRC = info.crc;
+		ElfEntry = info.entry;
+		ElfTextRange = info.text;
+		Console.WriteLn( Color_StrongBlue, L"ELF (%s) Game CRC = 0x%08X, EntryPoint = 0x%08X (cached)", WX_STR(elfpath), ElfCRC, ElfEntry);
+		return;
+	}
+
 	std::unique_ptr<ElfObject> elfptr(loadElf(elfpath));
 
 	elfptr->loadHeaders();
@@ -372,6 +482,15 @@ static __fi void _reloadElfInfo(wxString elfpath)
 	ElfTextRange = elfptr->getTextRange();
 	Console.WriteLn( Color_StrongBlue, L"ELF (%s) Game CRC = 0x%08X, EntryPoint = 0x%08X", WX_STR(elfpath), ElfCRC, ElfEntry);
 
+	// Its symbols feed the debugger and are only loaded when the ELF itself is read
+	if (key && !elfptr->hasSymbolTable())
+	{
+		info.crc = ElfCRC;
+		info.entry = ElfEntry;
+		info.text = ElfTextRange;
+		StoreElfInfo(key, info);
+	}
+
 	// Note: Do not load game database info here.  This code is generic and called from
 	// BIOS key encryption as well as eeloadReplaceOSDSYS.  The first is actually still executing
 	// BIOS code, and patches and cheats should not be applied yet.  (they are applied when
@@ -757,6 +876,42 @@ int cdvdReadSector() {
 	return 0;
 }
 
+// Delivers the sectors following the one just read that the reader has buffered already,
+// in one copy, instead of an interrupt and a read round trip per sector.  The last sector
+// of the command is always left to the regular path, which completes the command, and the
+// caller delays the next interrupt by the time the delivered sectors would have taken, so
+// the timing of the read doesn't change.  Returns the number of sectors delivered.
+static uint cdvdReadCachedSectors()
+{
+	// Raw DVD sectors get their header filled in by cdvdReadSector, one by one
+	if (cdvd.BlockSize != 2048 || cdvd.ReadMode != CDVD_MODE_2048 || cdvd.nSectors < 2)
+		return 0;
+
+	const u32 madr = HW_DMA3_MADR & 0x1fffff;
+	const s32 bcr = (HW_DMA3_BCR_H16 * HW_DMA3_BCR_L16) * 4;
+
+	uint count = std::min<uint>(cdvd.nSectors - 1, std::max(bcr, 0) / cdvd.BlockSize);
+	count = std::min<uint>(count, (0x200000 - madr) / cdvd.BlockSize);
+
+	if (!count || !(count = DoCDVDreadCachedSectors(iopPhysMem(madr), cdvd.Sector, count, cdvd.ReadMode)))
+		return 0;
+
+	const u32 size = count * cdvd.BlockSize;
+
+	if( cdvd.decSet ) mechaDecryptBytes( HW_DMA3_MADR, size );
+	psxCpu->Clear( HW_DMA3_MADR, size/4 );
+
+	HW_DMA3_BCR_H16 -= count * (cdvd.BlockSize / (HW_DMA3_BCR_L16*4));
+	HW_DMA3_MADR += size;
+
+	CDVD_LOG("SECTORS %d-%d from the read-ahead (BCR %x;%x)", cdvd.Sector, cdvd.Sector + count - 1, HW_DMA3_BCR_H16, HW_DMA3_BCR_L16);
+
+	cdvd.Sector += count;
+	cdvd.nSectors -= count;
+
+	return count;
+}
+
 // inlined due to being referenced in only one place.
 __fi void cdvdActionInterrupt()
 {
@@ -900,8 +1055,11 @@ __fi void cdvdReadInterrupt()
 
 	cdvd.RetryCntP = 0;
 	cdvd.Reading = 1;
+
+	const uint cached = cdvdReadCachedSectors();
+
 	cdvd.RErr = DoCDVDreadTrack(cdvd.Sector, cdvd.ReadMode);
-	CDVDREAD_INT(cdvd.ReadTime);
+	CDVDREAD_INT(cdvd.ReadTime, cached + 1);
 
 	return;
 }
@@ -36,6 +36,8 @@
 #include "DebugTools/SymbolMap.h"
 #include "AppConfig.h"
 
+#include "Utilities/Instrumentation.h"
+
 const wxChar* CDVD_SourceLabels[] =
 {
 	L"ISO",
@@ -434,6 +436,7 @@ void DoCDVDclose()
 
 s32 DoCDVDreadSector(u8* buffer, u32 lsn, int mode)
 {
+	Instrumentation::ScopedTimer readTimer(Instrumentation::Counter_CdvdRead);
 	CheckNullCDVD();
 	int ret = CDVD->readSector(buffer,lsn,mode);
 
@@ -456,6 +459,7 @@ s32 DoCDVDreadSector(u8* buffer, u32 lsn, int mode)
 
 s32 DoCDVDreadTrack(u32 lsn, int mode)
 {
+	Instrumentation::ScopedTimer readTimer(Instrumentation::Counter_CdvdRead);
 	CheckNullCDVD();
 
 	// TEMP: until all the plugins use the new CDVDgetBuffer style
@@ -482,6 +486,8 @@ s32 DoCDVDreadTrack(u32 lsn, int mode)
 
 s32 DoCDVDgetBuffer(u8* buffer)
 {
+	// Completes the read started by DoCDVDreadTrack, so it isn't counted as another one.
+	Instrumentation::ScopedTimer readTimer(Instrumentation::Counter_CdvdRead, 0);
 	CheckNullCDVD();
 	int ret = CDVD->getBuffer2(buffer);
 
@@ -502,6 +508,15 @@ s32 DoCDVDgetBuffer(u8* buffer)
 	return ret;
 }
 
+s32 DoCDVDreadCachedSectors(u8* buffer, u32 lsn, u32 count, int mode)
+{
+	// The block dumper has to see every sector go through DoCDVDgetBuffer
+	if (!CDVD || !CDVD->readCachedSectors || blockDumpFile.IsOpened())
+		return 0;
+
+	return CDVD->readCachedSectors(buffer, lsn, count, mode);
+}
+
 s32 DoCDVDdetectDiskType()
 {
 	CheckNullCDVD();
@@ -512,6 +527,7 @@ s32 DoCDVDdetectDiskType()
 void DoCDVDresetDiskTypeCache()
 {
 	diskTypeCached = -1;
+	IsoFSCDVD::ClearDirectoryCache();
 }
 
 ////////////////////////////////////////////////////////
@@ -614,4 +630,5 @@ CDVD_API CDVDapi_NoDisc =
 	NODISCreadSector,
 	NODISCgetBuffer2,
 	NODISCgetDualInfo,
+	NULL,	// readCachedSectors
 };
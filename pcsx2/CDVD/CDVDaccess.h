@@ -24,6 +24,10 @@ enum class CDVD_SourceType : uint8_t
 	NoDisc,		// use built in CDVDnull
 };
 
+// Copies the sectors from lsn on that are buffered already, up to count, without starting
+// or waiting for a read.  Returns the number of sectors copied (IsoReader only for now).
+typedef s32 (CALLBACK *_CDVDreadCachedSectors)(u8* buffer, u32 lsn, u32 count, int mode);
+
 struct CDVD_API
 {
 	void (CALLBACK *close)();
@@ -51,6 +55,7 @@ struct CDVD_API
 	_CDVDreadSector    readSector;
 	_CDVDgetBuffer2    getBuffer2;
 	_CDVDgetDualInfo   getDualInfo;
+	_CDVDreadCachedSectors readCachedSectors;
 };
 
 // ----------------------------------------------------------------------------
@@ -77,6 +82,7 @@ extern void DoCDVDclose();
 extern s32  DoCDVDreadSector(u8* buffer, u32 lsn, int mode);
 extern s32  DoCDVDreadTrack(u32 lsn, int mode);
 extern s32  DoCDVDgetBuffer(u8* buffer);
+extern s32  DoCDVDreadCachedSectors(u8* buffer, u32 lsn, u32 count, int mode);
 extern s32  DoCDVDdetectDiskType();
 extern void DoCDVDresetDiskTypeCache();
 
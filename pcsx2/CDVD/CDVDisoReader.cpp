@@ -376,6 +376,11 @@ s32 CALLBACK ISOgetBuffer2(u8* buffer)
 	return iso.FinishRead3(buffer, pmode);
 }
 
+s32 CALLBACK ISOreadCachedSectors(u8* buffer, u32 lsn, u32 count, int mode)
+{
+	return iso.ReadCached(buffer, lsn, count, mode);
+}
+
 //u8* CALLBACK ISOgetBuffer()
 //{
 //	iso.FinishRead();
@@ -426,4 +431,5 @@ CDVD_API CDVDapi_Iso =
 	ISOreadSector,
 	ISOgetBuffer2,
 	ISOgetDualInfo,
+	ISOreadCachedSectors,
 };
@@ -21,32 +21,158 @@ void ChunksCache::SetLimit(uint megabytes) {
 	MatchLimit();
 }
 
-void ChunksCache::MatchLimit(bool removeAll) {
-	std::list<CacheEntry*>::reverse_iterator rit;
-	while (!m_entries.empty() && (removeAll || m_size > m_limit)) {
-		rit = m_entries.rbegin();
-		m_size -= (*rit)->size;
-		delete(*rit);
-		m_entries.pop_back();
+int ChunksCache::BufferClass(int size) {
+	int c = MinBufferClass;
+	while (((size_t)1 << c) < (size_t)size)
+		c++;
+	return c;
+}
+
+size_t ChunksCache::BufferBytes(void* pBuffer) {
+	return (size_t)1 << ((BufferHeader*)pBuffer - 1)->sizeClass;
+}
+
+void* ChunksCache::Alloc(int size) {
+	int c = BufferClass(size);
+
+	if (!m_pool[c].empty()) {
+		void* p = m_pool[c].back();
+		m_pool[c].pop_back();
+		m_poolSize -= (PX_off_t)1 << c;
+		return p;
+	}
+
+	BufferHeader* h = (BufferHeader*)malloc(sizeof(BufferHeader) + ((size_t)1 << c));
+	if (!h)
+		return NULL;
+
+	h->sizeClass = c;
+	return h + 1;
+}
+
+void ChunksCache::Release(void* pBuffer) {
+	if (!pBuffer)
+		return;
+
+	// Keep a few MB around for the next chunks, they're usually the same size
+	BufferHeader* h = (BufferHeader*)pBuffer - 1;
+	PX_off_t bytes = (PX_off_t)1 << h->sizeClass;
+
+	if (m_poolSize + bytes <= std::max(m_limit / 16, (PX_off_t)4 * 1024 * 1024)) {
+		m_pool[h->sizeClass].push_back(pBuffer);
+		m_poolSize += bytes;
+	} else {
+		free(h);
+	}
+}
+
+void ChunksCache::ClearPool() {
+	for (auto& pool : m_pool) {
+		for (void* p : pool)
+			free((BufferHeader*)p - 1);
+		pool.clear();
+	}
+	m_poolSize = 0;
+}
+
+void ChunksCache::Unlink(CacheEntry* e) {
+	if (e->prev) e->prev->next = e->next;
+	else m_mru = e->next;
+
+	if (e->next) e->next->prev = e->prev;
+	else m_lru = e->prev;
+
+	e->prev = e->next = NULL;
+}
+
+void ChunksCache::PushFront(CacheEntry* e) {
+	e->lastUse = ++m_clock;
+	e->prev = NULL;
+	e->next = m_mru;
+
+	if (m_mru) m_mru->prev = e;
+	else m_lru = e;
+
+	m_mru = e;
+}
+
+void ChunksCache::Evict(CacheEntry* e) {
+	PX_off_t end = e->offset + std::max(e->coverage, 1);
+
+	for (PX_off_t g = e->offset / IndexGranule; g <= (end - 1) / IndexGranule; g++) {
+		auto range = m_index.equal_range(g);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second == e) {
+				m_index.erase(it);
+				break;
+			}
+		}
+	}
+
+	Unlink(e);
+
+	if (e->data) {
+		m_size -= BufferBytes(e->data);
+		Release(e->data);
 	}
+
+	delete e;
+}
+
+void ChunksCache::MatchLimit(bool removeAll) {
+	while (m_lru && (removeAll || m_size > m_limit))
+		Evict(m_lru);
 }
 
-void ChunksCache::Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage) {
-	m_entries.push_front(new CacheEntry(pMallocedSrc, offset, length, coverage));
-	m_size += length;
+void ChunksCache::Take(void* pSrc, PX_off_t offset, int length, int coverage) {
+	CacheEntry* e = new CacheEntry(pSrc, offset, length, coverage);
+
+	PX_off_t end = offset + std::max(coverage, 1);
+	for (PX_off_t g = offset / IndexGranule; g <= (end - 1) / IndexGranule; g++)
+		m_index.emplace(g, e);
+
+	PushFront(e);
+
+	if (pSrc)
+		m_size += BufferBytes(pSrc);
 	MatchLimit();
 }
 
+bool ChunksCache::Contains(PX_off_t offset, int length) const {
+	auto range = m_index.equal_range(offset / IndexGranule);
+	for (auto it = range.first; it != range.second; ++it) {
+		const CacheEntry* e = it->second;
+		if (offset >= e->offset && (offset + length) <= (e->offset + e->coverage))
+			return true;
+	}
+	return false;
+}
+
 // By design, succeed only if the entire request is in a single cached chunk
 int ChunksCache::Read(void* pDest, PX_off_t offset, int length) {
-	for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
-		CacheEntry* e = *it;
-		if (e && offset >= e->offset && (offset + length) <= (e->offset + e->coverage)) {
-			if (it != m_entries.begin())
-				m_entries.splice(m_entries.begin(), m_entries, it); // Move to top (MRU)
-			return CopyAvailable(e->data, e->offset, e->size, pDest, offset, length);
+	auto range = m_index.equal_range(offset / IndexGranule);
+
+	// Several entries can cover the same range, prefer the most recent one like the list walk did
+	CacheEntry* found = NULL;
+	for (auto it = range.first; it != range.second; ++it) {
+		CacheEntry* e = it->second;
+		if (offset >= e->offset && (offset + length) <= (e->offset + e->coverage)) {
+			if (!found || e->lastUse > found->lastUse)
+				found = e;
 		}
 	}
-	return -1;
-}
 
+	if (!found) {
+		m_misses++;
+		return -1;
+	}
+
+	m_hits++;
+
+	if (found != m_mru) { // Move to top (MRU)
+		Unlink(found);
+		PushFront(found);
+	}
+
+	return CopyAvailable(found->data, found->offset, found->size, pDest, offset, length);
+}
@@ -16,18 +16,32 @@
 #pragma once
 
 #include "zlib_indexed.h"
+#include <unordered_map>
+#include <vector>
 
 #define CLAMP(val, minval, maxval) (std::min(maxval, std::max(minval, val)))
 
+// Cache of extracted chunks, recently used first.
+// Entries are indexed by the IndexGranule sized blocks of the file they cover, so a lookup only
+// looks at the few entries overlapping the requested offset instead of walking the whole list.
+// Chunk buffers come from Alloc() and are recycled through a small pool when evicted.
 class ChunksCache {
 public:
-	ChunksCache(uint initialLimitMb) : m_entries(0), m_size(0), m_limit(initialLimitMb * 1024 * 1024) {};
-	~ChunksCache() { Clear(); };
+	ChunksCache(uint initialLimitMb) : m_mru(NULL), m_lru(NULL), m_size(0), m_limit((PX_off_t)initialLimitMb * 1024 * 1024), m_poolSize(0), m_clock(0), m_hits(0), m_misses(0) {};
+	~ChunksCache() { Clear(); ClearPool(); };
 	void SetLimit(uint megabytes);
-	void Clear() { MatchLimit(true); };
+	void Clear() { MatchLimit(true); m_hits = m_misses = 0; };
 
-	void Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage);
+	// Buffers passed to Take must come from Alloc. The cache owns them afterwards.
+	void* Alloc(int size);
+	void  Release(void* pBuffer);
+
+	void Take(void* pSrc, PX_off_t offset, int length, int coverage);
 	int  Read(void* pDest,        PX_off_t offset, int length);
+	bool Contains(PX_off_t offset, int length) const;
+
+	u64 GetHits() const { return m_hits; }
+	u64 GetMisses() const { return m_misses; }
 
 	static int CopyAvailable(void* pSrc, PX_off_t srcOffset, int srcSize,
 							 void* pDst, PX_off_t dstOffset, int maxCopySize) {
@@ -37,27 +51,61 @@ public:
 	};
 
 private:
+	static const PX_off_t IndexGranule = 64 * 1024;
+	static const int MinBufferClass = 12; // 4KB
+
 	class CacheEntry {
 	public:
-		CacheEntry(void* pMallocedSrc, PX_off_t offset, int length, int coverage) :
-			data(pMallocedSrc),
+		CacheEntry(void* pSrc, PX_off_t offset, int length, int coverage) :
+			data(pSrc),
 			offset(offset),
 			coverage(coverage),
-			size(length)
+			size(length),
+			lastUse(0),
+			prev(NULL),
+			next(NULL)
 		{};
 
-		~CacheEntry() { if (data) free(data); };
-
 		void* data;
 		PX_off_t offset;
 		int coverage;
 		int size;
+
+		// LRU links, prev is more recently used
+		u64 lastUse;
+		CacheEntry* prev;
+		CacheEntry* next;
+	};
+
+	// Pooled buffers are prefixed by their size class
+	struct BufferHeader {
+		int sizeClass;
+		int pad[3];
 	};
 
-	std::list<CacheEntry*> m_entries;
+	static int BufferClass(int size);
+	static size_t BufferBytes(void* pBuffer);
+
+	void Unlink(CacheEntry* e);
+	void PushFront(CacheEntry* e);
+	void Evict(CacheEntry* e);
 	void MatchLimit(bool removeAll = false);
-	PX_off_t m_size;
+	void ClearPool();
+
+	CacheEntry* m_mru;
+	CacheEntry* m_lru;
+	std::unordered_multimap<PX_off_t, CacheEntry*> m_index; // granule -> entries covering it
+
+	PX_off_t m_size;  // bytes held by cached buffers
 	PX_off_t m_limit;
+
+	std::vector<void*> m_pool[32]; // free buffers per size class
+	PX_off_t m_poolSize;
+
+	u64 m_clock;
+
+	u64 m_hits;
+	u64 m_misses;
 };
 
 #undef CLAMP
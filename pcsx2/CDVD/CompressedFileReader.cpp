@@ -18,6 +18,7 @@
 #include "CompressedFileReader.h"
 #include "CsoFileReader.h"
 #include "GzippedFileReader.h"
+#include "ZstdFileReader.h"
 
 // CompressedFileReader factory.
 AsyncFileReader* CompressedFileReader::GetNewReader(const wxString& fileName) {
@@ -27,6 +28,11 @@ AsyncFileReader* CompressedFileReader::GetNewReader(const wxString& fileName) {
 	if (CsoFileReader::CanHandle(fileName)) {
 		return new CsoFileReader();
 	}
+#ifdef PCSX2_ZSTD
+	if (ZstdFileReader::CanHandle(fileName)) {
+		return new ZstdFileReader();
+	}
+#endif
 	// This is the one which will fail on open.
 	return NULL;
 }
@@ -18,6 +18,7 @@
 #include "CompressedFileReaderUtils.h"
 #include "CsoFileReader.h"
 #include "Pcsx2Types.h"
+#include "Utilities/PersistentThread.h"
 #ifdef __POSIX__
 #include <zlib.h>
 #else
@@ -26,17 +27,83 @@
 
 // Implementation of CSO compressed ISO reading, based on:
 // https://github.com/unknownbrackets/maxcso/blob/master/README_CSO.md
-struct CsoHeader {
-	u8 magic[4];
-	u32 header_size;
-	u64 total_bytes;
-	u32 frame_size;
-	u8 ver;
-	u8 align;
-	u8 reserved[2];
-};
-
 static const u32 CSO_READ_BUFFER_SIZE = 256 * 1024;
+// Unit of work of the decoder threads (at least one frame)
+static const u8 CSO_DECODE_CHUNK_SHIFT = 16;
+
+// --------------------------------------------------------------------------------------
+//  CsoDecodeThread
+// --------------------------------------------------------------------------------------
+// Each decoder has its own file handle and zlib stream, so chunks decode fully in parallel.
+class CsoDecodeThread : public Threading::pxThread
+{
+	CsoFileReader& m_reader;
+	FILE* m_src;
+	z_stream m_z;
+	bool m_zInit;
+	u8* m_readBuffer;
+
+public:
+	CsoDecodeThread(CsoFileReader& reader, u32 readBufferSize)
+		: m_reader(reader), m_src(NULL), m_zInit(false)
+	{
+		m_name = L"CSO Decoder";
+		m_readBuffer = new u8[readBufferSize];
+		m_z.zalloc = Z_NULL;
+		m_z.zfree = Z_NULL;
+		m_z.opaque = Z_NULL;
+	}
+
+	virtual ~CsoDecodeThread()
+	{
+		try {
+			pxThread::Cancel();
+		}
+		DESTRUCTOR_CATCHALL
+
+		if (m_zInit)
+			inflateEnd(&m_z);
+		if (m_src)
+			fclose(m_src);
+		delete[] m_readBuffer;
+	}
+
+	bool Init()
+	{
+		m_src = PX_fopen_rb(m_reader.m_filename);
+		m_zInit = m_src && inflateInit2(&m_z, -15) == Z_OK;
+		return m_zInit;
+	}
+
+protected:
+	void ExecuteTaskInThread()
+	{
+		for (;;) {
+			m_reader.m_taskQueued.WaitNoCancel();
+			if (m_reader.m_decodersStopping)
+				return;
+
+			// Take the earliest queued chunk, that's the one the reader will want first
+			CsoFileReader::DecodeTask* task = NULL;
+			{
+				Threading::ScopedLock lock(m_reader.m_taskLock);
+				for (auto& t : m_reader.m_tasks) {
+					if (t.state == CsoFileReader::TaskQueued && (!task || t.chunk < task->chunk))
+						task = &t;
+				}
+				if (task)
+					task->state = CsoFileReader::TaskBusy;
+			}
+
+			if (!task)
+				continue;
+
+			bool success = m_reader.DecodeChunk(m_src, &m_z, m_readBuffer, task->buffer, task->chunk);
+			task->state = success ? CsoFileReader::TaskDone : CsoFileReader::TaskFailed;
+			m_reader.m_taskDone.Post();
+		}
+	}
+};
 
 bool CsoFileReader::CanHandle(const wxString& fileName) {
 	bool supported = false;
@@ -89,6 +156,8 @@ bool CsoFileReader::Open(const wxString& fileName) {
 		Close();
 		return false;
 	}
+
+	StartDecoders();
 	return true;
 }
 
@@ -155,10 +224,10 @@ bool CsoFileReader::InitializeBuffers() {
 }
 
 void CsoFileReader::Close() {
+	StopDecoders();
+
 	m_filename.Empty();
-#if CSO_USE_CHUNKSCACHE
 	m_cache.Clear();
-#endif
 
 	if (m_src) {
 		fclose(m_src);
@@ -200,6 +269,18 @@ int CsoFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
 	while (remaining > 0) {
 		int readBytes;
 
+		if (!m_decoders.empty()) {
+			readBytes = ReadFromDecoders(dest + bytes, pos + bytes, remaining);
+			if (readBytes == 0) {
+				// We hit EOF.
+				break;
+			}
+
+			bytes += readBytes;
+			remaining -= readBytes;
+			continue;
+		}
+
 #if CSO_USE_CHUNKSCACHE
 		// Try first to read from the cache.
 		readBytes = m_cache.Read(dest + bytes, pos + bytes, remaining);
@@ -215,7 +296,7 @@ int CsoFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
 
 #if CSO_USE_CHUNKSCACHE
 			// Add the bytes into the cache.  We need to allocate a buffer for it.
-			void *cached = malloc(readBytes);
+			void *cached = m_cache.Alloc(readBytes);
 			memcpy(cached, dest + bytes, readBytes);
 			m_cache.Take(cached, pos + bytes, readBytes, readBytes);
 #endif
@@ -297,6 +378,223 @@ bool CsoFileReader::DecompressFrame(u32 frame, u32 readBufferSize) {
 	return success;
 }
 
+void CsoFileReader::StartDecoders() {
+	int count = std::min(4, (int)x86caps.LogicalCores - 1);
+	if (count <= 0)
+		return;
+
+	m_chunkShift = std::max(m_frameShift, CSO_DECODE_CHUNK_SHIFT);
+	m_decodersStopping = false;
+
+	for (auto& task : m_tasks) {
+		task.state = TaskFree;
+		task.buffer = NULL;
+	}
+
+	// Same sizing as m_readBuffer
+	u32 readBufferSize = std::max(CSO_READ_BUFFER_SIZE, m_frameSize + (1 << m_indexShift));
+
+	for (int i = 0; i < count; i++) {
+		CsoDecodeThread* decoder = new CsoDecodeThread(*this, readBufferSize);
+		if (!decoder->Init()) {
+			delete decoder;
+			break;
+		}
+		decoder->Start();
+		m_decoders.push_back(decoder);
+	}
+
+	DevCon.WriteLn("CSO: decoding %uKB chunks with %d threads", 1 << (m_chunkShift - 10), (int)m_decoders.size());
+}
+
+void CsoFileReader::StopDecoders() {
+	if (m_decoders.empty())
+		return;
+
+	m_decodersStopping = true;
+	m_taskQueued.Post(m_decoders.size());
+
+	for (CsoDecodeThread* decoder : m_decoders) {
+		decoder->Block();
+		delete decoder;
+	}
+	m_decoders.clear();
+
+	for (auto& task : m_tasks) {
+		m_cache.Release(task.buffer);
+		task.buffer = NULL;
+		task.state = TaskFree;
+	}
+
+	m_taskQueued.Reset();
+	m_taskDone.Reset();
+}
+
+u64 CsoFileReader::GetChunkBytes(u32 chunk) const {
+	u64 chunkPos = (u64)chunk << m_chunkShift;
+	return std::min((u64)1 << m_chunkShift, m_totalSize - chunkPos);
+}
+
+CsoFileReader::DecodeTask* CsoFileReader::FindTask(u32 chunk) {
+	for (auto& task : m_tasks) {
+		if (task.state != TaskFree && task.chunk == chunk)
+			return &task;
+	}
+	return NULL;
+}
+
+// Moves a finished chunk into the cache and frees its task
+void CsoFileReader::HarvestTask(DecodeTask& task) {
+	if (task.state == TaskDone) {
+		int bytes = (int)GetChunkBytes(task.chunk);
+		m_cache.Take(task.buffer, (u64)task.chunk << m_chunkShift, bytes, bytes);
+	} else {
+		m_cache.Release(task.buffer);
+	}
+
+	task.buffer = NULL;
+	task.state = TaskFree;
+}
+
+// Returns NULL if the chunk is past the end, already cached, all the tasks are in use, or the
+// cache has no room for it
+CsoFileReader::DecodeTask* CsoFileReader::QueueChunk(u32 chunk) {
+	u64 chunkPos = (u64)chunk << m_chunkShift;
+	if (chunkPos >= m_totalSize)
+		return NULL;
+
+	if (DecodeTask* task = FindTask(chunk))
+		return task;
+
+	if (m_cache.Contains(chunkPos, (int)GetChunkBytes(chunk)))
+		return NULL;
+
+	for (auto& task : m_tasks) {
+		if (task.state != TaskFree)
+			continue;
+
+		u8* buffer = (u8*)m_cache.Alloc(1 << m_chunkShift);
+		if (!buffer)
+			return NULL;
+
+		{
+			Threading::ScopedLock lock(m_taskLock);
+			task.chunk = chunk;
+			task.buffer = buffer;
+			task.state = TaskQueued;
+		}
+		m_taskQueued.Post();
+
+		return &task;
+	}
+
+	return NULL;
+}
+
+int CsoFileReader::ReadFromDecoders(u8 *dest, u64 pos, int maxBytes) {
+	if (pos >= m_totalSize) {
+		// Can't read anything passed the end.
+		return 0;
+	}
+
+	const u32 chunk = (u32)(pos >> m_chunkShift);
+	const u64 chunkEnd = ((u64)chunk << m_chunkShift) + GetChunkBytes(chunk);
+	const int bytes = (int)std::min((u64)maxBytes, chunkEnd - pos);
+
+	for (auto& task : m_tasks) {
+		if (task.state == TaskDone || task.state == TaskFailed)
+			HarvestTask(task);
+	}
+
+	int res = m_cache.Read(dest, pos, bytes);
+
+	DecodeTask* task = NULL;
+	while (res < 0 && !(task = QueueChunk(chunk))) {
+		bool inFlight = false;
+		for (auto& t : m_tasks)
+			inFlight |= t.state != TaskFree;
+
+		// No task to wait for: the cache can't make room for the chunk, decode the frame here
+		if (!inFlight)
+			return ReadFromFrame(dest, pos, maxBytes);
+
+		// Every task is busy with other chunks, make room
+		m_taskDone.WaitWithoutYield();
+		for (auto& t : m_tasks) {
+			if (t.state == TaskDone || t.state == TaskFailed)
+				HarvestTask(t);
+		}
+		res = m_cache.Read(dest, pos, bytes);
+	}
+
+	// Keep the pipeline full for sequential reads
+	for (u32 i = 1; i <= DecodeAhead; i++)
+		QueueChunk(chunk + i);
+
+	if (res >= 0)
+		return res;
+
+	while (task->state == TaskQueued || task->state == TaskBusy)
+		m_taskDone.WaitWithoutYield();
+
+	if (task->state == TaskFailed) {
+		Console.Error("Unable to decompress CSO chunk using zlib.");
+		HarvestTask(*task);
+		return 0;
+	}
+
+	HarvestTask(*task);
+
+	res = m_cache.Read(dest, pos, bytes);
+	return res < 0 ? ReadFromFrame(dest, pos, maxBytes) : res;
+}
+
+// Runs on the decoder threads, only touches the (read only) index and the thread's own state
+bool CsoFileReader::DecodeChunk(FILE* src, z_stream* z, u8* readBuffer, u8* dest, u32 chunk) const {
+	const u64 chunkPos = (u64)chunk << m_chunkShift;
+	const u64 chunkBytes = GetChunkBytes(chunk);
+	const u32 firstFrame = (u32)(chunkPos >> m_frameShift);
+	const u32 frames = (u32)((chunkBytes + m_frameSize - 1) >> m_frameShift);
+
+	for (u32 i = 0; i < frames; i++) {
+		const u32 frame = firstFrame + i;
+		u8* out = dest + ((u64)i << m_frameShift);
+		const u32 bytes = (u32)std::min((u64)m_frameSize, chunkBytes - ((u64)i << m_frameShift));
+
+		const bool compressed = (m_index[frame + 0] & 0x80000000) == 0;
+		const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
+		const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
+
+		const u64 frameRawPos = (u64)index0 << m_indexShift;
+		const u64 frameRawSize = (u64)(index1 - index0) << m_indexShift;
+
+		if (PX_fseeko(src, m_dataoffset + frameRawPos, SEEK_SET) != 0)
+			return false;
+
+		if (!compressed) {
+			if (fread(out, 1, bytes, src) != bytes)
+				return false;
+			continue;
+		}
+
+		const u32 readRawBytes = fread(readBuffer, 1, frameRawSize, src);
+
+		z->next_in = readBuffer;
+		z->avail_in = readRawBytes;
+		z->next_out = out;
+		z->avail_out = m_frameSize;
+
+		int status = inflate(z, Z_FINISH);
+		bool success = status == Z_STREAM_END && z->total_out == m_frameSize;
+		inflateReset(z);
+
+		if (!success)
+			return false;
+	}
+
+	return true;
+}
+
 void CsoFileReader::BeginRead(void* pBuffer, uint sector, uint count) {
 	// TODO: No async support yet, implement as sync.
 	m_bytesRead = ReadSync(pBuffer, sector, count);
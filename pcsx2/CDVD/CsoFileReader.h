@@ -26,12 +26,26 @@
 
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "Utilities/Threading.h"
+#include <atomic>
+#include <vector>
+
+struct CsoHeader {
+	u8 magic[4];
+	u32 header_size;
+	u64 total_bytes;
+	u32 frame_size;
+	u8 ver;
+	u8 align;
+	u8 reserved[2];
+};
 
-struct CsoHeader;
 typedef struct z_stream_s z_stream;
 
 static const uint CSO_CHUNKCACHE_SIZE_MB = 200;
 
+class CsoDecodeThread;
+
 class CsoFileReader : public AsyncFileReader
 {
 	DeclareNoncopyableObject(CsoFileReader);
@@ -47,9 +61,9 @@ public:
 		m_totalSize(0),
 		m_src(0),
 		m_z_stream(0),
-#if CSO_USE_CHUNKSCACHE
 		m_cache(CSO_CHUNKCACHE_SIZE_MB),
-#endif
+		m_chunkShift(0),
+		m_decodersStopping(false),
 		m_bytesRead(0) {
 		m_blocksize = 2048;
 	};
@@ -81,6 +95,19 @@ private:
 	int ReadFromFrame(u8 *dest, u64 pos, int maxBytes);
 	bool DecompressFrame(u32 frame, u32 readBufferSize);
 
+	// Threaded decoding: whole chunks of frames are decoded by a pool of worker threads,
+	// the requested one plus a few after it, and land in m_cache.
+	struct DecodeTask;
+
+	void StartDecoders();
+	void StopDecoders();
+	int ReadFromDecoders(u8 *dest, u64 pos, int maxBytes);
+	DecodeTask* FindTask(u32 chunk);
+	DecodeTask* QueueChunk(u32 chunk);
+	void HarvestTask(DecodeTask& task);
+	bool DecodeChunk(FILE* src, z_stream* z, u8* readBuffer, u8* dest, u32 chunk) const;
+	u64 GetChunkBytes(u32 chunk) const;
+
 	u32 m_frameSize;
 	u8 m_frameShift;
 	u8 m_indexShift;
@@ -93,9 +120,29 @@ private:
 	FILE* m_src;
 	z_stream* m_z_stream;
 
-#if CSO_USE_CHUNKSCACHE
+	// Always used by the decoder threads, and by the synchronous path if CSO_USE_CHUNKSCACHE
 	ChunksCache m_cache;
-#endif
+
+	friend class CsoDecodeThread;
+
+	static const int MaxDecodeTasks = 8;
+	static const int DecodeAhead = 4; // chunks queued past the one being read
+
+	enum DecodeState { TaskFree, TaskQueued, TaskBusy, TaskDone, TaskFailed };
+
+	struct DecodeTask {
+		u32 chunk;
+		std::atomic<int> state;
+		u8* buffer;
+	};
+
+	std::vector<CsoDecodeThread*> m_decoders;
+	DecodeTask m_tasks[MaxDecodeTasks];
+	u8 m_chunkShift;
+	Threading::Mutex m_taskLock;
+	Threading::Semaphore m_taskQueued;
+	Threading::Semaphore m_taskDone;
+	std::atomic<bool> m_decodersStopping;
 
 	// The result of a read is stored here between BeginRead() and FinishRead().
 	int m_bytesRead;
@@ -15,11 +15,13 @@
 
 #include "PrecompiledHeader.h"
 #include <fstream>
+#include <vector>
 #include <wx/stdpaths.h>
 #include "AppConfig.h"
 #include "ChunksCache.h"
 #include "CompressedFileReaderUtils.h"
 #include "GzippedFileReader.h"
+#include "Utilities/PersistentThread.h"
 #include "zlib_indexed.h"
 
 #define CLAMP(val, minval, maxval) (std::min(maxval, std::max(minval, val)))
@@ -36,14 +38,48 @@ static s64 fsize(const wxString& filename) {
 	return size;
 }
 
-#define GZIP_ID "PCSX2.index.gzip.v1|"
+#define GZIP_ID_V1 "PCSX2.index.gzip.v1|"
+#define GZIP_ID "PCSX2.index.gzip.v2|"
 #define GZIP_ID_LEN (sizeof(GZIP_ID) - 1)	/* sizeof includes the \0 terminator */
 
+#define GZIP_KEY_HEADER_BYTES (64 * 1024)	/* how much of the compressed file is hashed into its key */
+
+static void GetIndexKey(const wxString& filename, FILE* src, GzIndexKey& key) {
+	memset(&key, 0, sizeof(key));
+	key.size = fsize(filename);
+	key.mtime = wxFileName(filename).GetModificationTime().GetTicks();
+
+	u32 hash = 2166136261u;
+	u8 buffer[4096];
+	PX_fseeko(src, 0, SEEK_SET);
+	for (int total = 0; total < GZIP_KEY_HEADER_BYTES; ) {
+		size_t len = fread(buffer, 1, sizeof(buffer), src);
+		for (size_t i = 0; i < len; i++)
+			hash = (hash ^ buffer[i]) * 16777619u;
+		if (len < sizeof(buffer))
+			break;
+		total += len;
+	}
+	key.hash = hash;
+}
+
+// Used for the $(h) template key
+static wxString IndexKeyHash(const GzIndexKey& key) {
+	u64 hash = 14695981039346656037ull;
+	const u8* data = (const u8*)&key;
+	for (size_t i = 0; i < sizeof(key); i++)
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	return wxString::Format(L"%016llx", (unsigned long long)hash);
+}
+
 // File format is:
 // - [GZIP_ID_LEN] GZIP_ID (no \0)
+// - [sizeof(GzIndexKey)] key of the compressed file the index was built from (not in v1 files)
 // - [sizeof(Access)] index (should be allocated, contains various sizes)
 // - [rest] the indexed data points (should be allocated, index->list should then point to it)
-static Access* ReadIndexFromFile(const wxString& filename) {
+// v1 files are still used, but can't be verified against the compressed file.
+static Access* ReadIndexFromFile(const wxString& filename, const GzIndexKey& key, bool& stale) {
+	stale = false;
 	s64 size = fsize(filename);
 	if (size <= 0) {
 		Console.Error(L"Error: Can't open index file: '%s'", WX_STR(filename));
@@ -53,7 +89,18 @@ static Access* ReadIndexFromFile(const wxString& filename) {
 
 	char fileId[GZIP_ID_LEN + 1] = { 0 };
 	infile.read(fileId, GZIP_ID_LEN);
-	if (wxString::From8BitData(GZIP_ID) != wxString::From8BitData(fileId)) {
+	s64 headersize = GZIP_ID_LEN + sizeof(Access);
+	if (wxString::From8BitData(GZIP_ID) == wxString::From8BitData(fileId)) {
+		GzIndexKey filekey;
+		infile.read((char*)&filekey, sizeof(filekey));
+		if (memcmp(&filekey, &key, sizeof(key))) {
+			Console.Warning(L"Warning: Gzip index was built for a different or modified file, ignoring it: '%s'", WX_STR(filename));
+			infile.close();
+			stale = true;
+			return 0;
+		}
+		headersize += sizeof(GzIndexKey);
+	} else if (wxString::From8BitData(GZIP_ID_V1) != wxString::From8BitData(fileId)) {
 		Console.Error(L"Error: Incompatible gzip index, please delete it manually: '%s'", WX_STR(filename));
 		infile.close();
 		return 0;
@@ -62,7 +109,7 @@ static Access* ReadIndexFromFile(const wxString& filename) {
 	Access* index = (Access*)malloc(sizeof(Access));
 	infile.read((char*)index, sizeof(Access));
 
-	s64 datasize = size - GZIP_ID_LEN - sizeof(Access);
+	s64 datasize = size - headersize;
 	if (datasize != (s64)index->have * sizeof(Point)) {
 		Console.Error(L"Error: unexpected size of gzip index, please delete it manually: '%s'.", WX_STR(filename));
 		infile.close();
@@ -77,14 +124,20 @@ static Access* ReadIndexFromFile(const wxString& filename) {
 	return index;
 }
 
-static void WriteIndexToFile(Access* index, const wxString filename) {
+static void WriteIndexToFile(Access* index, const wxString filename, const GzIndexKey& key) {
 	if (wxFileName::FileExists(filename)) {
 		Console.Warning(L"WARNING: Won't write index - file name exists (please delete it manually): '%s'", WX_STR(filename));
 		return;
 	}
 
-	std::ofstream outfile(PX_wfilename(filename), std::ofstream::binary);
+	// The index folder may be shared with other hosts. Write under a temporary
+	// name and move it in place at once, so nobody ever reads a partial index.
+	wxFileName(filename).Mkdir(0777, wxPATH_MKDIR_FULL);
+	wxString tmpname = filename + wxString::Format(L".%lu.tmp", wxGetProcessId());
+
+	std::ofstream outfile(PX_wfilename(tmpname), std::ofstream::binary);
 	outfile.write(GZIP_ID, GZIP_ID_LEN);
+	outfile.write((char*)&key, sizeof(key));
 
 	Point* tmp = index->list;
 	index->list = 0; // current pointer is useless on disk, normalize it as 0.
@@ -95,48 +148,60 @@ static void WriteIndexToFile(Access* index, const wxString filename) {
 	outfile.close();
 
 	// Verify
-	if (fsize(filename) != (s64)GZIP_ID_LEN + sizeof(Access) + sizeof(Point) * index->have) {
-		Console.Warning(L"Warning: Can't write index file to disk: '%s'", WX_STR(filename));
+	if (fsize(tmpname) != (s64)GZIP_ID_LEN + sizeof(GzIndexKey) + sizeof(Access) + sizeof(Point) * index->have
+	    || !wxRenameFile(tmpname, filename, false)) {
+		wxRemoveFile(tmpname);
+		if (wxFileName::FileExists(filename))
+			Console.WriteLn(Color_Green, L"OK: Gzip quick access index was saved meanwhile by someone else: '%s'", WX_STR(filename));
+		else
+			Console.Warning(L"Warning: Can't write index file to disk: '%s'", WX_STR(filename));
 	} else {
 		Console.WriteLn(Color_Green, L"OK: Gzip quick access index file saved to disk: '%s'", WX_STR(filename));
 	}
 }
 
 static wxString INDEX_TEMPLATE_KEY(L"$(f)");
+static wxString INDEX_TEMPLATE_HASH_KEY(L"$(h)");
 // template:
-// must contain one and only one instance of '$(f)' (without the quotes)
-// if if !canEndWithKey -> must not end with $(f)
+// must contain one and only one instance of '$(f)' or '$(h)' (without the quotes)
+// if if !canEndWithKey -> must not end with the key
 // if starts with $(f) then it expands to the full path + file name.
 // if doesn't start with $(f) then it's expanded to file name only (with extension)
+// $(h) expands to a hash of the file content key instead of its name, so one
+//   (shared) folder can serve the same image from any path or host.
 // if doesn't start with $(f) and ends up relative,
 //   then it's relative to base (not to cwd)
 // No checks are performed if the result file name can be created.
 // If this proves useful, we can move it into Path:: . Right now there's no need.
 static wxString ApplyTemplate(const wxString &name, const wxDirName &base,
                               const wxString &fileTemplate, const wxString &filename,
-                              bool canEndWithKey)
+                              const wxString &hash, bool canEndWithKey)
 {
 	wxString tem(fileTemplate);
-	wxString key = INDEX_TEMPLATE_KEY;
 	tem = tem.Trim(true).Trim(false); // both sides
 
+	bool useHash = tem.find(INDEX_TEMPLATE_KEY) == wxString::npos;
+	wxString key = useHash ? INDEX_TEMPLATE_HASH_KEY : INDEX_TEMPLATE_KEY;
+
 	size_t first = tem.find(key);
 	if (first == wxString::npos // not found
 	    || first != tem.rfind(key) // more than one instance
+	    || !useHash && tem.find(INDEX_TEMPLATE_HASH_KEY) != wxString::npos // both keys
 	    || !canEndWithKey && first == tem.length() - key.length())
 	{
 		Console.Error(L"Invalid %s template '%s'.\n"
-		              L"Template must contain exactly one '%s' and must not end with it. Abotring.",
-		              WX_STR(name), WX_STR(tem), WX_STR(key));
+		              L"Template must contain exactly one '%s' or '%s' and must not end with it. Abotring.",
+		              WX_STR(name), WX_STR(tem), WX_STR(INDEX_TEMPLATE_KEY), WX_STR(INDEX_TEMPLATE_HASH_KEY));
 		return L"";
 	}
 
-	wxString fname(filename);
-	if (first > 0)
+	bool relative = first > 0 || useHash;
+	wxString fname(useHash ? hash : filename);
+	if (relative && !useHash)
 		fname = Path::GetFilename(fname); // without path
 
 	tem.Replace(key, fname);
-	if (first > 0)
+	if (relative)
 		tem = Path::Combine(base, tem); // ignores appRoot if tem is absolute
 
 	return tem;
@@ -154,7 +219,10 @@ static void TestTemplate(const wxDirName &base, const wxString &fname, bool canE
 		"c:\\pcsx2-cache/$(f).pindex",        // absolute
 		"~/.cache/$(f).pindex",	              // TODO: check if this works on *nix. It should...
 		                                      //       (on windows ~ isn't recognized as special)
+		"cache/$(h).pindex",                  // relative to base, by content
+		"//server/share/pcsx2/$(h).pindex",   // shared between hosts
 		"cache/$(f)/$(f).index",              // invalid: appears twice
+		"cache/$(f)/$(h).index",              // invalid: both keys
 		"hello",                              // invalid: doesn't contain $(f)
 		"hello$(f)",                          // invalid, can't end with $(f)
 		NULL
@@ -164,24 +232,101 @@ static void TestTemplate(const wxDirName &base, const wxString &fname, bool canE
 		wxString tem(wxString::From8BitData(ins[i]));
 		Console.WriteLn(Color_Green, L"test: '%s' -> '%s'",
 		                WX_STR(tem),
-		                WX_STR(ApplyTemplate(L"test", base, tem, fname, canEndWithKey)));
+		                WX_STR(ApplyTemplate(L"test", base, tem, fname, L"0123456789abcdef", canEndWithKey)));
 	}
 }
 */
 
-static wxString iso2indexname(const wxString& isoname) {
+static wxString iso2indexname(const wxString& isoname, const wxString& hash) {
 	//testTemplate(isoname);
 	wxDirName appRoot = // TODO: have only one of this in PCSX2. Right now have few...
 	    (wxDirName)(wxFileName(wxStandardPaths::Get().GetExecutablePath()).GetPath());
 	//TestTemplate(appRoot, isoname, false);
-	return ApplyTemplate(L"gzip index", appRoot, g_Conf->GzipIsoIndexTemplate, isoname, false);
+	return ApplyTemplate(L"gzip index", appRoot, g_Conf->GzipIsoIndexTemplate, isoname, hash, false);
 }
 
+// --------------------------------------------------------------------------------------
+//  GzIndexBuilder
+// --------------------------------------------------------------------------------------
+// Scans the whole compressed file once to build the quick access index, while the
+// reader already extracts through the access points which were found so far.
+class GzIndexBuilder : public Threading::pxThread
+{
+	GzippedFileReader& m_reader;
+	FILE* m_src;
+	BuildHooks m_hooks;
+	bool m_started;
+	PX_off_t m_printed;
+
+public:
+	int m_result;
+
+	GzIndexBuilder(GzippedFileReader& reader)
+		: m_reader(reader), m_src(NULL), m_started(false), m_printed(0), m_result(Z_ERRNO)
+	{
+		m_name = L"Gzip Indexer";
+		m_hooks.lock = Lock;
+		m_hooks.unlock = Unlock;
+		m_hooks.progress = Progress;
+		m_hooks.published = &reader.m_pIndex;
+		m_hooks.opaque = this;
+	}
+
+	virtual ~GzIndexBuilder()
+	{
+		try {
+			pxThread::Cancel();
+		}
+		DESTRUCTOR_CATCHALL
+
+		if (m_src)
+			fclose(m_src);
+	}
+
+	bool Init()
+	{
+		m_src = PX_fopen_rb(m_reader.m_filename);
+		return m_src != NULL;
+	}
+
+protected:
+	static void Lock(void* opaque) { ((GzIndexBuilder*)opaque)->m_reader.m_indexLock.Acquire(); }
+	static void Unlock(void* opaque) { ((GzIndexBuilder*)opaque)->m_reader.m_indexLock.Release(); }
+
+	static int Progress(void* opaque, PX_off_t totin)
+	{
+		GzIndexBuilder* builder = (GzIndexBuilder*)opaque;
+		if (!builder->m_started && *builder->m_hooks.published) {
+			// The first access point is right after the gzip header, the reader can start now
+			builder->m_started = true;
+			builder->m_reader.m_indexStarted.Post();
+		}
+		if (totin / (512 * 1024 * 1024) != builder->m_printed / (512 * 1024 * 1024)) {
+			DevCon.WriteLn(Color_Gray, L"gzip index: %d MB scanned", (int)(totin / (1024 * 1024)));
+			builder->m_printed = totin;
+		}
+		return builder->m_reader.m_indexCancel;
+	}
+
+	void ExecuteTaskInThread()
+	{
+		Access* index = NULL;
+		m_result = build_index(m_src, GZFILE_SPAN_DEFAULT, &index, &m_hooks);
+		m_reader.m_indexBuilt = true;
+		if (!m_started)
+			m_reader.m_indexStarted.Post();
+	}
+};
+
 GzippedFileReader::GzippedFileReader(void) :
 	mBytesRead(0),
 	m_pIndex(0),
+	m_uncompressedSize(0),
 	m_zstates(0),
 	m_src(0),
+	m_builder(NULL),
+	m_indexBuilt(false),
+	m_indexCancel(false),
 	m_cache(GZFILE_CACHE_SIZE_MB) {
 	m_blocksize = 2048;
 	AsyncPrefetchReset();
@@ -196,7 +341,7 @@ void GzippedFileReader::InitZstates() {
 		return;
 
 	// having another extra element helps avoiding logic for last (so 2+ instead of 1+)
-	int size = 2 + m_pIndex->uncompressed_size / m_pIndex->span;
+	int size = 2 + m_uncompressedSize / m_pIndex->span;
 	m_zstates = new Czstate[size]();
 }
 
@@ -287,43 +432,141 @@ bool GzippedFileReader::OkIndex() {
 		return true;
 
 	// Try to read index from disk
-	wxString indexfile = iso2indexname(m_filename);
-	if (indexfile.length() == 0)
+	GetIndexKey(m_filename, m_src, m_key);
+	m_indexfile = iso2indexname(m_filename, IndexKeyHash(m_key));
+	if (m_indexfile.length() == 0)
 		return false; // iso2indexname(...) will print errors if it can't apply the template
 
-	if (wxFileName::FileExists(indexfile) && (m_pIndex = ReadIndexFromFile(indexfile))) {
-		Console.WriteLn(Color_Green, L"OK: Gzip quick access index read from disk: '%s'", WX_STR(indexfile));
+	bool stale = false;
+	if (wxFileName::FileExists(m_indexfile) && (m_pIndex = ReadIndexFromFile(m_indexfile, m_key, stale))) {
+		Console.WriteLn(Color_Green, L"OK: Gzip quick access index read from disk: '%s'", WX_STR(m_indexfile));
 		if (m_pIndex->span != GZFILE_SPAN_DEFAULT) {
 			Console.Warning(L"Note: This index has %1.1f MB intervals, while the current default for new indexes is %1.1f MB.",
 			                (float)m_pIndex->span / 1024 / 1024, (float)GZFILE_SPAN_DEFAULT / 1024 / 1024);
 			Console.Warning(L"It will work fine, but if you want to generate a new index with default intervals, delete this index file.");
 			Console.Warning(L"(smaller intervals mean bigger index file and quicker but more frequent decompressions)");
 		}
+		m_uncompressedSize = m_pIndex->uncompressed_size;
 		InitZstates();
 		return true;
 	}
 
+	// A stale index is replaced by the new one
+	if (stale)
+		wxRemoveFile(m_indexfile);
+
 	// No valid index file. Generate an index
-	Console.Warning(L"This may take a while (but only once). Scanning compressed file to generate a quick access index...");
+	return StartIndexBuild();
+}
 
-	Access *index;
-	FILE* infile = PX_fopen_rb(m_filename);
-	int len = build_index(infile, GZFILE_SPAN_DEFAULT, &index);
-	printf("\n"); // build_index prints progress without \n's
-	fclose(infile);
+// The index is built in the background, and the game may boot meanwhile. Reads are
+// served from the closest access point found so far, which is slower far into the
+// file until the scan gets there, but always correct.
+bool GzippedFileReader::StartIndexBuild() {
+	m_indexBuilt = false;
+	m_indexCancel = false;
+	m_indexStarted.Reset();
+
+	m_builder = new GzIndexBuilder(*this);
+	if (!m_builder->Init()) {
+		Console.Error(L"ERROR: index could not be generated for file '%s'", WX_STR(m_filename));
+		delete m_builder;
+		m_builder = NULL;
+		return false;
+	}
+	m_builder->Start();
+	m_indexStarted.WaitNoCancel();
 
-	if (len >= 0) {
-		m_pIndex = index;
-		WriteIndexToFile((Access*)m_pIndex, indexfile);
-	} else {
-		Console.Error(L"ERROR (%d): index could not be generated for file '%s'", len, WX_STR(m_filename));
-		free_index(index);
+	PX_off_t size;
+	if (!m_indexBuilt && EstimateUncompressedSize(size)) {
+		Console.WriteLn(Color_Green, L"Gzip quick access index is being generated in the background...");
+		m_uncompressedSize = size;
+		InitZstates();
+		return true;
+	}
+
+	// The size has to be known before the first read, wait for the complete index
+	if (!m_indexBuilt)
+		Console.Warning(L"This may take a while (but only once). Scanning compressed file to generate a quick access index...");
+	FinishIndexBuild();
+	return m_pIndex != NULL;
+}
+
+void GzippedFileReader::FinishIndexBuild() {
+	m_builder->Block();
+	int len = m_builder->m_result;
+	delete m_builder;
+	m_builder = NULL;
+
+	// On failure the partial index is left to us
+	if (len <= 0 || !m_pIndex) {
+		if (!m_indexCancel)
+			Console.Error(L"ERROR (%d): index could not be generated for file '%s'", len, WX_STR(m_filename));
+		free_index(m_pIndex);
+		m_pIndex = 0;
 		InitZstates();
+		return;
+	}
+
+	WriteIndexToFile(m_pIndex, m_indexfile, m_key);
+
+	if (m_zstates && m_uncompressedSize != m_pIndex->uncompressed_size)
+		Console.Warning(L"Warning: size of '%s' was estimated as %lld bytes, but it's %lld bytes.",
+		                WX_STR(m_filename), (long long)m_uncompressedSize, (long long)m_pIndex->uncompressed_size);
+
+	if (!m_zstates || m_uncompressedSize != m_pIndex->uncompressed_size) {
+		m_uncompressedSize = m_pIndex->uncompressed_size;
+		InitZstates();
+	}
+}
+
+// Drops an unfinished index, a finished one is still saved
+void GzippedFileReader::StopIndexBuild() {
+	if (!m_builder)
+		return;
+
+	m_indexCancel = true;
+	FinishIndexBuild();
+}
+
+// The exact size is only known once the whole file was scanned, but an iso has to
+// report its size when it's opened. The gzip trailer holds the size modulo 4GB, and
+// the primary volume descriptor the size of the (first layer of the) volume, which
+// together pin it down for PS2 images. Anything else waits for the complete index.
+bool GzippedFileReader::EstimateUncompressedSize(PX_off_t& size) {
+	u8 trailer[4];
+	if (m_key.size < 64 || PX_fseeko(m_src, m_key.size - 4, SEEK_SET) || fread(trailer, 1, 4, m_src) != 4)
 		return false;
+	u32 isize = trailer[0] | trailer[1] << 8 | trailer[2] << 16 | (u32)trailer[3] << 24;
+
+	// Sector 16, as 2048 bytes sectors, or 2352 bytes sectors in mode 2 or mode 1
+	static const int sectorSizes[] = { 2048, 2352, 2352 };
+	static const int pvdOffsets[] = { 0, 24, 16 };
+	std::vector<u8> head(17 * 2352);
+	Czstate cstate;
+	int res;
+	{
+		Threading::ScopedLock lock(m_indexLock);
+		res = extract(m_src, m_pIndex, 0, head.data(), head.size(), &cstate.state);
 	}
 
-	InitZstates();
-	return true;
+	PX_off_t volume = 0;
+	int sectorSize = 0;
+	for (int i = 0; i < 3 && !volume; i++) {
+		int pos = 16 * sectorSizes[i] + pvdOffsets[i];
+		const u8* pvd = &head[pos];
+		if (res >= pos + 84 && pvd[0] == 1 && !memcmp(pvd + 1, "CD001", 5)) {
+			volume = (PX_off_t)(pvd[80] | pvd[81] << 8 | pvd[82] << 16 | (u32)pvd[83] << 24) * sectorSizes[i];
+			sectorSize = sectorSizes[i];
+		}
+	}
+	if (!volume)
+		return false;
+
+	// Deflate never expands the data anywhere near that much
+	PX_off_t lowest = std::max(volume, (PX_off_t)(m_key.size - m_key.size / 512));
+	size = lowest + (u32)(isize - (u32)lowest);
+	return size % sectorSize == 0;
 }
 
 bool GzippedFileReader::Open(const wxString& fileName) {
@@ -379,9 +622,15 @@ PX_off_t GzippedFileReader::GetOptimalExtractionStart(PX_off_t offset) {
 }
 
 int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRead) {
+	if (m_builder && m_indexBuilt)
+		FinishIndexBuild();
 	if (!OkIndex())
 		return -1;
 
+	// Beyond the estimated size, the zstates don't cover it until the index is complete
+	if (m_builder && offset >= m_uncompressedSize)
+		return 0;
+
 	// Without all the caching, chunking and states, this would be enough:
 	// return extract(m_src, m_pIndex, offset, (unsigned char*)pBuffer, bytesToRead);
 
@@ -410,14 +659,17 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 	PTT s = NOW();
 	PX_off_t extractOffset = GetOptimalExtractionStart(offset); // guaranteed in GZFILE_READ_CHUNK_SIZE boundaries
 	int size = offset + maxInChunk - extractOffset;
-	unsigned char* extracted = (unsigned char*)malloc(size);
+	unsigned char* extracted = (unsigned char*)m_cache.Alloc(size);
 
 	int span = m_pIndex->span;
 	int spanix = extractOffset / span;
 	AsyncPrefetchCancel();
-	res = extract(m_src, m_pIndex, extractOffset, extracted, size, &(m_zstates[spanix].state));
+	{
+		Threading::ScopedLock lock(m_builder ? &m_indexLock : NULL);
+		res = extract(m_src, m_pIndex, extractOffset, extracted, size, &(m_zstates[spanix].state));
+	}
 	if (res < 0) {
-		free(extracted);
+		m_cache.Release(extracted);
 		return res;
 	}
 	AsyncPrefetchChunk(getInOffset(&(m_zstates[spanix].state)));
@@ -443,12 +695,12 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 	else { // split into cacheable chunks
 		for (int i = 0; i < size; i += GZFILE_READ_CHUNK_SIZE) {
 			int available = CLAMP(res - i, 0, GZFILE_READ_CHUNK_SIZE);
-			void* chunk = available ? malloc(available) : 0;
+			void* chunk = available ? m_cache.Alloc(available) : 0;
 			if (available)
 				memcpy(chunk, extracted + i, available);
 			m_cache.Take(chunk, extractOffset + i, available, std::min(size - i, GZFILE_READ_CHUNK_SIZE));
 		}
-		free(extracted);
+		m_cache.Release(extracted);
 	}
 
 	int duration = NOW() - s;
@@ -463,6 +715,8 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 }
 
 void GzippedFileReader::Close() {
+	StopIndexBuild();
+
 	m_filename.Empty();
 	if (m_pIndex) {
 		free_index((Access*)m_pIndex);
@@ -470,6 +724,9 @@ void GzippedFileReader::Close() {
 	}
 
 	InitZstates(); // results in delete because no index
+
+	if (m_cache.GetHits() + m_cache.GetMisses())
+		DevCon.WriteLn("gunzip: cache %llu hits, %llu misses", m_cache.GetHits(), m_cache.GetMisses());
 	m_cache.Clear();
 
 	if (m_src) {
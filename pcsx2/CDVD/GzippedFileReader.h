@@ -19,15 +19,30 @@ typedef struct zstate Zstate;
 
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "Utilities/Threading.h"
 #include "zlib_indexed.h"
+#include <atomic>
 
 #define GZFILE_SPAN_DEFAULT (1048576L * 4)   /* distance between direct access points when creating a new index */
 #define GZFILE_READ_CHUNK_SIZE (256 * 1024)  /* zlib extraction chunks size (at 0-based boundaries) */
 #define GZFILE_CACHE_SIZE_MB 200             /* cache size for extracted data. must be at least GZFILE_READ_CHUNK_SIZE (in MB)*/
 
+class GzIndexBuilder;
+
+// Identifies the compressed file an index was built from, so indexes can be
+// shared by content (see the $(h) template key) and stale ones are rejected.
+struct GzIndexKey
+{
+	s64 size;
+	s64 mtime;
+	u32 hash; // FNV-1a of the first bytes of the compressed file
+	u32 reserved;
+};
+
 class GzippedFileReader : public AsyncFileReader
 {
 	DeclareNoncopyableObject(GzippedFileReader);
+	friend class GzIndexBuilder;
 public:
 	GzippedFileReader(void);
 
@@ -47,7 +62,8 @@ public:
 	virtual uint GetBlockCount(void) const {
 		// type and formula copied from FlatFileReader
 		// FIXME? : Shouldn't it be uint and (size - m_dataoffset) / m_blocksize ?
-		return (int)((m_pIndex ? m_pIndex->uncompressed_size : 0) / m_blocksize);
+		// While the index is still being built this is an estimate, see EstimateUncompressedSize.
+		return (int)((m_pIndex ? m_uncompressedSize : 0) / m_blocksize);
 	};
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
@@ -66,15 +82,31 @@ private:
 	};
 
 	bool	OkIndex();  // Verifies that we have an index, or try to create one
+	bool	StartIndexBuild();
+	void	FinishIndexBuild();
+	void	StopIndexBuild();
+	bool	EstimateUncompressedSize(PX_off_t& size);
 	PX_off_t GetOptimalExtractionStart(PX_off_t offset);
 	int     _ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRead);
 	void	InitZstates();
 
 	int		mBytesRead; // Temp sync read result when simulating async read
-	Access* m_pIndex;   // Quick access index
+	Access* m_pIndex;   // Quick access index, partial while m_builder is running
+	PX_off_t m_uncompressedSize;
 	Czstate* m_zstates;
 	FILE*	m_src;
 
+	GzIndexKey m_key;
+	wxString m_indexfile;
+
+	// Background index build. The builder publishes new access points into
+	// m_pIndex under m_indexLock, reads extract under the same lock meanwhile.
+	GzIndexBuilder* m_builder;
+	Threading::Mutex m_indexLock;
+	Threading::Semaphore m_indexStarted;
+	std::atomic<bool> m_indexBuilt;
+	std::atomic<bool> m_indexCancel;
+
 	ChunksCache m_cache;
 
 #ifdef _WIN32
@@ -0,0 +1,544 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2016  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "AppConfig.h"
+#include "AsyncFileReader.h"
+#include "HttpFileReader.h"
+
+#ifdef PCSX2_CURL
+
+#include "Utilities/ThreadPool.h"
+
+#include <curl/curl.h>
+#include <wx/ffile.h>
+#include <algorithm>
+
+using Threading::ThreadPool;
+
+static const u32 IndexMagic = 0x49545448; // 'HTTI'
+static const u32 IndexVersion = 1;
+
+struct IndexHeader
+{
+	u32 magic;
+	u32 version;
+	u64 key;
+	u32 slots;
+	u32 chunkSize;
+};
+
+static u64 HashBytes(u64 hash, const void* data, size_t size)
+{
+	const u8* p = (const u8*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= p[i];
+		hash *= 0x100000001b3ull; // FNV-1a
+	}
+	return hash;
+}
+
+// --------------------------------------------------------------------------------------
+//  HttpFileReader::DiskCache
+// --------------------------------------------------------------------------------------
+
+bool HttpFileReader::DiskCache::Open(const wxString& filename, u64 key, u32 slots)
+{
+	Close();
+	m_filename = filename;
+	m_key = key;
+	m_slotChunk.assign(slots, NoChunk);
+	m_slotUse.assign(slots, 0);
+
+	const bool reused = wxFileExists(m_filename) && LoadIndex();
+	if (!reused)
+	{
+		m_slotChunk.assign(slots, NoChunk);
+		m_slotUse.assign(slots, 0);
+		m_chunkSlot.clear();
+		m_used = 0;
+		m_clock = 0;
+
+		if (!m_file.Create(m_filename, true))
+			return false;
+		m_file.Close();
+	}
+
+	// A crash would leave an index that doesn't match the slots written from now on
+	wxRemoveFile(m_filename + L".index");
+
+	return m_file.Open(m_filename, wxFile::read_write);
+}
+
+bool HttpFileReader::DiskCache::LoadIndex()
+{
+	wxFFile fp(m_filename + L".index", L"rb");
+	if (!fp.IsOpened())
+		return false;
+
+	const u32 slots = m_slotChunk.size();
+	IndexHeader header;
+
+	bool ok = fp.Read(&header, sizeof(header)) == sizeof(header);
+	ok = ok && header.magic == IndexMagic && header.version == IndexVersion && header.key == m_key;
+	ok = ok && header.slots == slots && header.chunkSize == ChunkSize;
+	ok = ok && fp.Read(&m_slotChunk[0], slots * sizeof(u32)) == slots * sizeof(u32);
+	ok = ok && fp.Read(&m_slotUse[0], slots * sizeof(u64)) == slots * sizeof(u64);
+	if (!ok)
+		return false;
+
+	for (u32 slot = 0; slot < slots; slot++)
+	{
+		if (m_slotChunk[slot] == NoChunk)
+			continue;
+
+		m_chunkSlot[m_slotChunk[slot]] = slot;
+		m_used = slot + 1;
+		m_clock = std::max(m_clock, m_slotUse[slot]);
+	}
+
+	return true;
+}
+
+void HttpFileReader::DiskCache::Close()
+{
+	if (!m_file.IsOpened())
+		return;
+
+	m_file.Close();
+
+	IndexHeader header;
+	memzero(header);
+	header.magic = IndexMagic;
+	header.version = IndexVersion;
+	header.key = m_key;
+	header.slots = m_slotChunk.size();
+	header.chunkSize = ChunkSize;
+
+	wxFFile fp(m_filename + L".index", L"wb");
+	bool ok = fp.IsOpened() && fp.Write(&header, sizeof(header)) == sizeof(header);
+	ok = ok && fp.Write(&m_slotChunk[0], header.slots * sizeof(u32)) == header.slots * sizeof(u32);
+	ok = ok && fp.Write(&m_slotUse[0], header.slots * sizeof(u64)) == header.slots * sizeof(u64);
+	fp.Close();
+
+	if (!ok)
+		wxRemoveFile(m_filename + L".index");
+
+	m_slotChunk.clear();
+	m_slotUse.clear();
+	m_chunkSlot.clear();
+	m_used = 0;
+	m_clock = 0;
+}
+
+bool HttpFileReader::DiskCache::Read(u32 chunk, u32 offset, void* dest, u32 size)
+{
+	auto it = m_chunkSlot.find(chunk);
+	if (it == m_chunkSlot.end())
+		return false;
+
+	const u32 slot = it->second;
+	m_slotUse[slot] = ++m_clock;
+
+	return m_file.Seek((wxFileOffset)slot * ChunkSize + offset) != wxInvalidOffset
+		&& m_file.Read(dest, size) == (ssize_t)size;
+}
+
+bool HttpFileReader::DiskCache::Write(u32 chunk, const void* src, u32 size)
+{
+	u32 slot;
+	auto it = m_chunkSlot.find(chunk);
+
+	if (it != m_chunkSlot.end())
+		slot = it->second;
+	else if (m_used < m_slotChunk.size())
+		slot = m_used++;
+	else
+	{
+		slot = std::min_element(m_slotUse.begin(), m_slotUse.end()) - m_slotUse.begin();
+		if (m_slotChunk[slot] != NoChunk)
+			m_chunkSlot.erase(m_slotChunk[slot]);
+	}
+
+	// Forgotten until written, a reader never sees half a chunk
+	m_slotChunk[slot] = NoChunk;
+	m_slotUse[slot] = 0;
+	m_chunkSlot.erase(chunk);
+
+	if (m_file.Seek((wxFileOffset)slot * ChunkSize) == wxInvalidOffset || m_file.Write(src, size) != size)
+		return false;
+
+	m_slotChunk[slot] = chunk;
+	m_slotUse[slot] = ++m_clock;
+	m_chunkSlot[chunk] = slot;
+	return true;
+}
+
+// --------------------------------------------------------------------------------------
+//  HttpFileReader
+// --------------------------------------------------------------------------------------
+
+struct FetchTarget
+{
+	u8* dest;
+	u32 size;
+	u32 pos;
+};
+
+static size_t WriteToTarget(char* ptr, size_t size, size_t nmemb, void* user)
+{
+	FetchTarget& target = *(FetchTarget*)user;
+	const size_t bytes = size * nmemb;
+
+	// More than the range asked for, the server ignored it: abort the transfer
+	if (bytes > target.size - target.pos)
+		return 0;
+
+	memcpy(target.dest + target.pos, ptr, bytes);
+	target.pos += bytes;
+	return bytes;
+}
+
+static void SetCommonOptions(CURL* curl, const std::string& url)
+{
+	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L); // used from the pool threads
+	curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+	curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+	curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 15L);
+}
+
+HttpFileReader::HttpFileReader(void) :
+	m_filesize(0),
+	m_chunks(0),
+	m_inflight(0),
+	m_connections(1),
+	m_closing(false),
+	m_buffer(NULL),
+	m_readOffset(0),
+	m_readLength(0),
+	m_lastChunk(DiskCache::NoChunk),
+	m_fetched(0),
+	m_hits(0),
+	m_misses(0)
+{
+	m_blocksize = 2048;
+}
+
+bool HttpFileReader::Open(const wxString& fileName)
+{
+	Close();
+	m_filename = fileName;
+	m_url = std::string(fileName.utf8_str());
+
+	static std::once_flag s_curlInit;
+	std::call_once(s_curlInit, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+	CURL* curl = curl_easy_init();
+	if (!curl)
+		return false;
+
+	// The size and the modification time, and whether the server is there at all
+	SetCommonOptions(curl, m_url);
+	curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+	curl_easy_setopt(curl, CURLOPT_FILETIME, 1L);
+
+	const CURLcode res = curl_easy_perform(curl);
+	long code = 0, filetime = -1;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+	curl_easy_getinfo(curl, CURLINFO_FILETIME, &filetime);
+#if LIBCURL_VERSION_NUM >= 0x073700
+	curl_off_t length = -1;
+	curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+#else
+	double length = -1;
+	curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length);
+#endif
+
+	if (res != CURLE_OK || code / 100 != 2 || length <= 0)
+	{
+		Console.Error("Remote image %s: %s (http %ld)", m_url.c_str(),
+			res != CURLE_OK ? curl_easy_strerror(res) : "no size", code);
+		curl_easy_cleanup(curl);
+		return false;
+	}
+
+	m_handles.push_back(curl);
+	m_filesize = (u64)length;
+	m_chunks = (m_filesize + ChunkSize - 1) / ChunkSize;
+	m_connections = std::min(std::max(EmuConfig.CdvdRemoteConnections, 1), 16);
+
+	const u64 limit = (u64)std::max(EmuConfig.CdvdRemoteCacheMB, 64) * _1mb / ChunkSize;
+	const u32 slots = (u32)std::min<u64>(limit, m_chunks);
+
+	u64 key = HashBytes(0xcbf29ce484222325ull, m_url.data(), m_url.size());
+	const u64 name = key;
+	key = HashBytes(key, &m_filesize, sizeof(m_filesize));
+	key = HashBytes(key, &filetime, sizeof(filetime));
+
+	PathDefs::GetCache().Mkdir();
+	const wxString cacheFile(Path::Combine(PathDefs::GetCache(), wxsFormat(L"http-%016llx.chunks", (unsigned long long)name)));
+
+	if (!m_cache.Open(cacheFile, key, slots))
+	{
+		Console.Error(L"Remote image: could not create the cache file %s", WX_STR(cacheFile));
+		Close();
+		return false;
+	}
+
+	Console.WriteLn(Color_StrongBlue, "Remote image: %llu MB, %u MB cached locally, %u connections",
+		(unsigned long long)(m_filesize / _1mb), (uint)((u64)slots * ChunkSize / _1mb), m_connections);
+	return true;
+}
+
+u32 HttpFileReader::ChunkBytes(u32 chunk) const
+{
+	return (u32)std::min<u64>(ChunkSize, m_filesize - (u64)chunk * ChunkSize);
+}
+
+// m_lock held
+void HttpFileReader::Want(u32 chunk, bool demand)
+{
+	if (m_cache.Contains(chunk) || m_wanted.count(chunk))
+		return;
+
+	if (demand)
+		m_failed.erase(chunk);
+	else if (m_failed.count(chunk))
+		return;
+
+	m_wanted.insert(chunk);
+	(demand ? m_demand : m_prefetch).push_back(chunk);
+}
+
+// Starts fetches until all the connections are busy, keeping one for the demand reads.
+// m_lock held
+void HttpFileReader::Pump()
+{
+	while (!m_closing && m_inflight < m_connections)
+	{
+		const bool demand = !m_demand.empty();
+		if (!demand && (m_prefetch.empty() || (m_connections > 1 && m_inflight + 1 >= m_connections)))
+			break;
+
+		std::deque<u32>& queue = demand ? m_demand : m_prefetch;
+		const u32 chunk = queue.front();
+		queue.pop_front();
+
+		m_inflight++;
+		ThreadPool::GetShared().Submit([this, chunk] { FetchTask(chunk); },
+			demand ? ThreadPool::Priority_High : ThreadPool::Priority_Normal);
+	}
+}
+
+bool HttpFileReader::Fetch(void* handle, u64 offset, u8* dest, u32 size)
+{
+	CURL* curl = (CURL*)handle;
+	FetchTarget target = { dest, size, 0 };
+
+	char range[64];
+	snprintf(range, sizeof(range), "%llu-%llu", (unsigned long long)offset, (unsigned long long)(offset + size - 1));
+
+	SetCommonOptions(curl, m_url);
+	curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+	curl_easy_setopt(curl, CURLOPT_RANGE, range);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteToTarget);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &target);
+
+	const CURLcode res = curl_easy_perform(curl);
+	long code = 0;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+
+	// A 200 is the whole image, only right if that's what was asked for
+	if (res == CURLE_OK && target.pos == size && (code == 206 || (code == 200 && size == m_filesize)))
+		return true;
+
+	Console.Warning("Remote image: reading %u bytes at %llu failed: %s (http %ld)",
+		size, (unsigned long long)offset, curl_easy_strerror(res), code);
+	return false;
+}
+
+// Runs on the shared pool
+void HttpFileReader::FetchTask(u32 chunk)
+{
+	void* curl = NULL;
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		if (!m_handles.empty())
+		{
+			curl = m_handles.back();
+			m_handles.pop_back();
+		}
+	}
+	if (!curl)
+		curl = curl_easy_init();
+
+	const u32 size = ChunkBytes(chunk);
+	std::unique_ptr<u8[]> data(new u8[size]);
+
+	bool ok = false;
+	for (uint attempt = 0; curl && !ok && !m_closing && attempt < MaxRetries; attempt++)
+		ok = Fetch(curl, (u64)chunk * ChunkSize, data.get(), size);
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	ok = ok && m_cache.Write(chunk, data.get(), size);
+	if (ok)
+		m_fetched += size;
+	else
+		m_failed.insert(chunk);
+
+	m_wanted.erase(chunk);
+	if (curl)
+		m_handles.push_back(curl);
+
+	m_inflight--;
+	Pump();
+	m_cond.notify_all();
+}
+
+int HttpFileReader::ReadSync(void* pBuffer, uint sector, uint count)
+{
+	BeginRead(pBuffer, sector, count);
+	return FinishRead();
+}
+
+void HttpFileReader::BeginRead(void* pBuffer, uint sector, uint count)
+{
+	m_buffer = (u8*)pBuffer;
+	m_readOffset = sector * (u64)m_blocksize + m_dataoffset;
+
+	const u64 end = std::min(m_readOffset + count * (u64)m_blocksize, m_filesize);
+	m_readLength = end > m_readOffset ? (u32)(end - m_readOffset) : 0;
+	if (!m_readLength)
+		return;
+
+	const u32 first = m_readOffset / ChunkSize;
+	const u32 last = (end - 1) / ChunkSize;
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	// Prefetches for an older position would only delay the chunks wanted now
+	for (u32 chunk : m_prefetch)
+		m_wanted.erase(chunk);
+	m_prefetch.clear();
+
+	for (u32 chunk = first; chunk <= last; chunk++)
+	{
+		if (m_cache.Contains(chunk))
+			m_hits++;
+		else
+			m_misses++;
+
+		Want(chunk, true);
+	}
+
+	// Sequential reads (including the chunk just read again) fetch ahead of the drive
+	if (first == m_lastChunk || first == m_lastChunk + 1)
+	{
+		for (u32 chunk = last + 1; chunk < m_chunks && chunk <= last + ReadAheadChunks; chunk++)
+			Want(chunk, false);
+	}
+	m_lastChunk = last;
+
+	Pump();
+}
+
+int HttpFileReader::FinishRead(void)
+{
+	if (!m_readLength)
+		return -1;
+
+	const u64 end = m_readOffset + m_readLength;
+	const u32 first = m_readOffset / ChunkSize;
+	const u32 last = (end - 1) / ChunkSize;
+	m_readLength = 0;
+
+	std::unique_lock<std::mutex> lock(m_lock);
+
+	for (u32 chunk = first; chunk <= last; chunk++)
+	{
+		while (!m_cache.Contains(chunk))
+		{
+			if (m_failed.count(chunk))
+			{
+				m_failed.erase(chunk);
+				return -1;
+			}
+
+			// Evicted by the other fetches before we got to it
+			if (!m_wanted.count(chunk))
+			{
+				Want(chunk, true);
+				Pump();
+			}
+
+			m_cond.wait(lock);
+		}
+
+		const u64 chunkStart = (u64)chunk * ChunkSize;
+		const u64 from = std::max(m_readOffset, chunkStart);
+		const u64 to = std::min(end, chunkStart + ChunkBytes(chunk));
+
+		if (!m_cache.Read(chunk, from - chunkStart, m_buffer + (from - m_readOffset), to - from))
+			return -1;
+	}
+
+	return 1;
+}
+
+void HttpFileReader::CancelRead(void)
+{
+	// The fetches still land in the cache, they're likely to be read again
+	m_readLength = 0;
+}
+
+void HttpFileReader::Close(void)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_closing = true;
+		m_demand.clear();
+		m_prefetch.clear();
+
+		while (m_inflight)
+			m_cond.wait(lock);
+
+		m_wanted.clear();
+		m_failed.clear();
+	}
+
+	for (void* curl : m_handles)
+		curl_easy_cleanup((CURL*)curl);
+	m_handles.clear();
+
+	if (m_hits || m_misses)
+		DevCon.WriteLn("Remote image: %llu MB downloaded, %.1f%% of the reads from the local cache",
+			(unsigned long long)(m_fetched / _1mb), 100.0 * m_hits / (m_hits + m_misses));
+
+	m_cache.Close();
+
+	m_closing = false;
+	m_filesize = 0;
+	m_chunks = 0;
+	m_readLength = 0;
+	m_lastChunk = DiskCache::NoChunk;
+	m_fetched = m_hits = m_misses = 0;
+}
+
+#endif
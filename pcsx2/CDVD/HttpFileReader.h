@@ -0,0 +1,136 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2016  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Reader for plain images on a web server or an object store (http:// and https:// urls),
+// so that a game boots without copying the whole image first.  The image is fetched by
+// ChunkSize sized HTTP range requests, several at once (CdvdRemoteConnections) from the
+// shared thread pool, and kept in a bounded cache file of the cache folder, evicted least
+// recently used first like ChunksCache (CdvdRemoteCacheMB).  Reads that continue the last
+// one prefetch the following chunks, on top of InputIsoFile's own read-ahead.
+//
+// The cache index is only written on a clean close, and is keyed on the url, the size and
+// the modification time the server reports, so a changed image starts a new cache.
+// Only built when libcurl is available (PCSX2_CURL), see InputIsoFile::Open.
+
+#include "AsyncFileReader.h"
+#include <wx/file.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class HttpFileReader : public AsyncFileReader
+{
+	DeclareNoncopyableObject(HttpFileReader);
+
+	static const u32 ChunkSize = _1mb;
+	static const uint ReadAheadChunks = 8;
+	static const uint MaxRetries = 3;
+
+	// Chunks of the image stored in fixed slots of a local file
+	class DiskCache
+	{
+		wxFile m_file;
+		wxString m_filename;
+		u64 m_key;
+
+		std::vector<u32> m_slotChunk;	// chunk held by each slot, NoChunk if free
+		std::vector<u64> m_slotUse;		// last use of each slot
+		std::unordered_map<u32, u32> m_chunkSlot;
+		u32 m_used;
+		u64 m_clock;
+
+		bool LoadIndex();
+
+	public:
+		static const u32 NoChunk = 0xffffffff;
+
+		DiskCache() : m_key(0), m_used(0), m_clock(0) {}
+		~DiskCache() { Close(); }
+
+		bool Open(const wxString& filename, u64 key, u32 slots);
+		void Close();
+
+		bool Contains(u32 chunk) const { return m_chunkSlot.count(chunk) != 0; }
+		bool Read(u32 chunk, u32 offset, void* dest, u32 size);
+		bool Write(u32 chunk, const void* src, u32 size);
+	};
+
+	std::string m_url; // utf8, for curl
+	u64 m_filesize;
+	u32 m_chunks;
+
+	std::mutex m_lock;
+	std::condition_variable m_cond;	// a fetch ended
+	DiskCache m_cache;
+
+	// Chunks to fetch, the ones a read waits for first
+	std::deque<u32> m_demand;
+	std::deque<u32> m_prefetch;
+	std::unordered_set<u32> m_wanted;	// queued or being fetched
+	std::unordered_set<u32> m_failed;
+	uint m_inflight;
+	uint m_connections;
+	std::atomic<bool> m_closing;
+
+	std::vector<void*> m_handles;	// idle curl handles, reused for keep-alive
+
+	// The read between BeginRead() and FinishRead()
+	u8* m_buffer;
+	u64 m_readOffset;
+	u32 m_readLength;
+	u32 m_lastChunk;
+
+	u64 m_fetched;
+	u64 m_hits;
+	u64 m_misses;
+
+	u32 ChunkBytes(u32 chunk) const;
+	void Want(u32 chunk, bool demand);
+	void Pump();
+	void FetchTask(u32 chunk);
+	bool Fetch(void* handle, u64 offset, u8* dest, u32 size);
+
+public:
+	HttpFileReader(void);
+	virtual ~HttpFileReader(void) { Close(); };
+
+	static bool CanHandle(const wxString& fileName) {
+		const wxString name(fileName.Lower());
+		return name.StartsWith(L"http://") || name.StartsWith(L"https://");
+	}
+
+	virtual bool Open(const wxString& fileName);
+
+	virtual int ReadSync(void* pBuffer, uint sector, uint count);
+
+	virtual void BeginRead(void* pBuffer, uint sector, uint count);
+	virtual int FinishRead(void);
+	virtual void CancelRead(void);
+
+	virtual void Close(void);
+
+	virtual uint GetBlockCount(void) const {
+		return (m_filesize - m_dataoffset) / m_blocksize;
+	};
+
+	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
+	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+};
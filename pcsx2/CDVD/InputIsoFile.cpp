@@ -17,6 +17,7 @@
 #include "PrecompiledHeader.h"
 #include "IopCommon.h"
 #include "IsoFileFormats.h"
+#include "HttpFileReader.h"
 
 #include <errno.h>
 
@@ -45,9 +46,127 @@ int InputIsoFile::ReadSync(u8* dst, uint lsn)
 		return -1;
 	}
 
+	// The reader only handles one request at a time
+	FlushReadAhead();
+
 	return m_reader->ReadSync(dst+m_blockofs, lsn, 1);
 }
 
+int InputIsoFile::FindSlot(uint lsn) const
+{
+	for (uint i = 0; i < ReadAheadSlots; i++)
+	{
+		const ReadSlot& slot = m_slots[i];
+
+		if (slot.count && lsn >= slot.lsn && lsn < slot.lsn + slot.count)
+			return i;
+	}
+
+	return -1;
+}
+
+// Picks the slot to reuse: an empty one, or else the one farthest from the current lsn.
+// For a sequential stream that's the oldest data behind us.
+int InputIsoFile::FindVictim() const
+{
+	int victim = -1;
+	uint victim_dist = 0;
+
+	for (uint i = 0; i < ReadAheadSlots; i++)
+	{
+		if ((int)i == m_current_slot)
+			continue;
+
+		const ReadSlot& slot = m_slots[i];
+
+		if (!slot.count)
+			return i;
+
+		uint dist = std::abs((s64)slot.lsn - (s64)m_current_lsn);
+
+		if (victim < 0 || dist > victim_dist)
+		{
+			victim = i;
+			victim_dist = dist;
+		}
+	}
+
+	return victim;
+}
+
+// Completes the read in flight if it targets the given slot.
+int InputIsoFile::WaitSlot(int slot)
+{
+	if (slot < 0 || slot != m_pending_slot)
+		return 0;
+
+	int ret = m_reader->FinishRead();
+
+	m_slots[slot].pending = false;
+	m_pending_slot = -1;
+
+	if (ret < 0)
+		m_slots[slot].count = 0;
+
+	return ret;
+}
+
+void InputIsoFile::FlushReadAhead()
+{
+	if (m_pending_slot >= 0)
+		WaitSlot(m_pending_slot);
+}
+
+void InputIsoFile::ReadSlotAsync(int slot, uint lsn, uint count)
+{
+	FlushReadAhead();
+
+	ReadSlot& s = m_slots[slot];
+
+	s.lsn = lsn;
+	s.count = count;
+	s.pending = true;
+
+	m_pending_slot = slot;
+	m_reader->BeginRead(s.data, lsn, count);
+}
+
+// Queues the unit after the buffered run once the drive reads sequentially. A single
+// prefetch is in flight at a time, and we never run further ahead than the ring holds.
+void InputIsoFile::Prefetch()
+{
+	if (ReadUnit <= 1 || m_seq_run < ReadAheadTrigger || m_pending_slot >= 0)
+		return;
+
+	uint next = m_current_lsn;
+	int slot;
+
+	while ((slot = FindSlot(next)) >= 0)
+		next = m_slots[slot].lsn + m_slots[slot].count;
+
+	if (next >= m_blocks || next - m_current_lsn >= (ReadAheadSlots - 1) * ReadUnit)
+		return;
+
+	uint count = std::min(ReadUnit, m_blocks - next);
+
+	ReadSlotAsync(FindVictim(), next, count);
+	m_readahead_prefetched += count;
+}
+
+uint InputIsoFile::GetReadAheadWindow() const
+{
+	if (m_current_lsn < 0)
+		return 0;
+
+	uint next = m_current_lsn;
+	int slot;
+
+	while ((slot = FindSlot(next)) >= 0)
+		next = m_slots[slot].lsn + m_slots[slot].count;
+
+	return next - m_current_lsn;
+}
+
 void InputIsoFile::BeginRead2(uint lsn)
 {
 	if (lsn > m_blocks)
@@ -65,47 +184,135 @@ void InputIsoFile::BeginRead2(uint lsn)
 		m_current_lsn = -1;
 		return;
 	}
-	
+
+	m_seq_run = (m_current_lsn >= 0 && lsn == (uint)m_current_lsn + 1) ? m_seq_run + 1 : 0;
 	m_current_lsn = lsn;
 
-	if(lsn >= m_read_lsn && lsn < (m_read_lsn+m_read_count))
+	if(m_mapped)
 	{
-		// Already buffered
+		// The reader hands out pointers, FinishRead3 copies from it directly
 		return;
 	}
 
-	m_read_lsn = lsn;
-	m_read_count = 1;
+	int slot = FindSlot(lsn);
 
-	if(ReadUnit > 1)
+	if(slot >= 0)
 	{
-		//m_read_lsn   = lsn - (lsn % ReadUnit);
+		// Already buffered (or being prefetched)
+		m_current_slot = slot;
+		m_readahead_hits++;
+		return;
+	}
 
-		m_read_count = std::min(ReadUnit, m_blocks - m_read_lsn);
+	m_readahead_misses++;
+
+	uint count = 1;
+
+	if(ReadUnit > 1)
+	{
+		count = std::min(ReadUnit, m_blocks - lsn);
 	}
 
-	m_reader->BeginRead(m_readbuffer, m_read_lsn, m_read_count);
-	m_read_inprogress = true;
+	slot = FindVictim();
+	ReadSlotAsync(slot, lsn, count);
+	m_current_slot = slot;
 }
 
 int InputIsoFile::FinishRead3(u8* dst, uint mode)
 {
-	int _offset = 0;
-	int length = 0;
 	int ret = 0;
 
 	if(m_current_lsn < 0)
 		return -1;
 
-	if(m_read_inprogress)
+	const u8* src;
+
+	if(m_mapped)
 	{
-		ret = m_reader->FinishRead();
-		m_read_inprogress = false;
+		// Straight from the mapped file, no intermediate buffer
+		src = m_reader->GetSectorPointer(m_current_lsn, 1);
+
+		if(!src)
+			return -1;
+	}
+	else
+	{
+		ret = WaitSlot(m_current_slot);
 
 		if(ret < 0)
 			return ret;
+
+		const ReadSlot& slot = m_slots[m_current_slot];
+		src = slot.data + (m_current_lsn - slot.lsn) * m_blocksize;
 	}
-		
+
+	CopySector(dst, src, m_current_lsn, mode);
+
+	if(!m_mapped)
+		Prefetch();
+
+	return 0;
+}
+
+uint InputIsoFile::ReadCached(u8* dst, uint lsn, uint count, uint mode)
+{
+	if(lsn >= m_blocks || !m_reader)
+		return 0;
+
+	const uint length = (mode == CDVD_MODE_2352) ? 2352 : (mode == CDVD_MODE_2340) ? 2340 : (mode == CDVD_MODE_2328) ? 2328 : 2048;
+
+	count = std::min(count, m_blocks - lsn);
+
+	uint done = 0;
+
+	for(; done < count; done++)
+	{
+		const uint cur = lsn + done;
+		const u8* src;
+
+		if(m_mapped)
+		{
+			src = m_reader->GetSectorPointer(cur, 1);
+
+			if(!src)
+				break;
+		}
+		else
+		{
+			const int slot = FindSlot(cur);
+
+			// A read in flight may well be done, but the reader can't tell without waiting
+			if(slot < 0 || m_slots[slot].pending)
+				break;
+
+			src = m_slots[slot].data + (cur - m_slots[slot].lsn) * m_blocksize;
+			m_current_slot = slot;
+		}
+
+		CopySector(dst + done * length, src, cur, mode);
+	}
+
+	if(done)
+	{
+		// As if they had been read one by one, the read-ahead keeps streaming
+		m_seq_run += done;
+		m_current_lsn = lsn + done - 1;
+
+		if(!m_mapped)
+		{
+			m_readahead_hits += done;
+			Prefetch();
+		}
+	}
+
+	return done;
+}
+
+void InputIsoFile::CopySector(u8* dst, const u8* src, uint lsn, uint mode)
+{
+	int _offset = 0;
+	int length = 0;
+
 	switch (mode)
 	{
 	case CDVD_MODE_2352:
@@ -145,20 +352,25 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 
 	length = end - _offset;
 
-	uint read_offset = (m_current_lsn - m_read_lsn) * m_blocksize;
-	memcpy(dst + diff, m_readbuffer + ndiff + read_offset, length);
+	memcpy(dst + diff, src + ndiff, length);
 	
 	if (m_type == ISOTYPE_CD && diff >= 12)
 	{
-		lsn_to_msf(dst + diff - 12, m_current_lsn);
+		lsn_to_msf(dst + diff - 12, lsn);
 		dst[diff - 9] = 2;
 	}
-
-	return 0;
 }
 
 InputIsoFile::InputIsoFile()
 {
+	// Keep every slot page aligned, it's friendlier to O_DIRECT style readers
+	static const uint SlotSize = (MaxReadUnit * CD_FRAMESIZE_RAW + 4095) & ~4095;
+
+	m_readbuffer.Alloc(ReadAheadSlots * SlotSize);
+
+	for (uint i = 0; i < ReadAheadSlots; i++)
+		m_slots[i].data = m_readbuffer.GetPtr() + i * SlotSize;
+
 	_init();
 }
 
@@ -177,11 +389,24 @@ void InputIsoFile::_init()
 	m_blocksize		= 0;
 	m_blocks		= 0;
 	
-	m_read_inprogress = false;
-	m_read_count = 0;
+	for (uint i = 0; i < ReadAheadSlots; i++)
+	{
+		m_slots[i].lsn = 0;
+		m_slots[i].count = 0;
+		m_slots[i].pending = false;
+	}
+
+	m_current_slot = -1;
+	m_pending_slot = -1;
+	m_seq_run = 0;
+	m_mapped = false;
+
+	m_readahead_hits = 0;
+	m_readahead_misses = 0;
+	m_readahead_prefetched = 0;
+
 	ReadUnit = 0;
 	m_current_lsn = -1;
-	m_read_lsn = -1;
 	m_reader = NULL;
 }
 
@@ -208,21 +433,55 @@ bool InputIsoFile::Open( const wxString& srcfile, bool testOnly )
 
 	bool isBlockdump = false;
 	bool isCompressed = false;
+	bool isRemote = false;
 
 	// First try using a compressed reader.  If it works, go with it.
 	m_reader = CompressedFileReader::GetNewReader(m_filename);
 	isCompressed = m_reader != NULL;
 
 	// If it wasn't compressed, let's open it has a FlatFileReader. 
+	bool isOpened = false;
+
 	if (!isCompressed)
 	{
-		// Allow write sharing of the iso based on the ini settings.
-		// Mostly useful for romhacking, where the disc is frequently
-		// changed and the emulator would block modifications
-		m_reader = new FlatFileReader(EmuConfig.CdvdShareWrite);
+#ifdef PCSX2_CURL
+		if (HttpFileReader::CanHandle(m_filename))
+		{
+			m_reader = new HttpFileReader();
+			isRemote = true;
+		}
+#endif
+#ifdef __linux__
+		// Local plain images are read through a mapping. Not when write sharing, a file
+		// that shrinks under a mapping faults.
+		if (!m_reader && EmuConfig.CdvdMappedReads && !EmuConfig.CdvdShareWrite)
+		{
+			m_reader = new MappedFileReader();
+			isOpened = m_reader->Open(m_filename);
+
+			if (!isOpened)
+			{
+				delete m_reader;
+				m_reader = NULL;
+			}
+		}
+
+#endif
+		if (!m_reader)
+		{
+			// Allow write sharing of the iso based on the ini settings.
+			// Mostly useful for romhacking, where the disc is frequently
+			// changed and the emulator would block modifications
+			m_reader = new FlatFileReader(EmuConfig.CdvdShareWrite);
+		}
 	}
 
-	m_reader->Open(m_filename);
+	if (!isOpened)
+		isOpened = m_reader->Open(m_filename);
+
+	if (isRemote && !isOpened)
+		throw Exception::FileNotFound(m_filename)
+			.SetDiagMsg(L"ISO mounting failed: the remote image could not be opened.");
 
 	// It might actually be a blockdump file.
 	// Check that before continuing with the FlatFileReader.
@@ -260,13 +519,19 @@ bool InputIsoFile::Open( const wxString& srcfile, bool testOnly )
 		m_reader->SetBlockSize(m_blocksize);
 
 		// Returns the original reader if single-part or a Multipart reader otherwise
-		AsyncFileReader* m_reader_old = m_reader;
-		m_reader =	MultipartFileReader::DetectMultipart(m_reader);
-		if (m_reader != m_reader_old) // Not the same object the old one need to be deleted
-			delete m_reader_old;
+		if (!isRemote)
+		{
+			AsyncFileReader* m_reader_old = m_reader;
+			m_reader =	MultipartFileReader::DetectMultipart(m_reader);
+			if (m_reader != m_reader_old) // Not the same object the old one need to be deleted
+				delete m_reader_old;
+		}
+
+		m_reader->SetReadBuffer(m_readbuffer.GetPtr(), m_readbuffer.GetSize());
 	}
 
 	m_blocks = m_reader->GetBlockCount();
+	m_mapped = m_reader->GetSectorPointer(0, 1) != NULL;
 
 	Console.WriteLn(Color_StrongBlue, L"isoFile open ok: %s", WX_STR(m_filename));
 
@@ -278,12 +543,24 @@ bool InputIsoFile::Open( const wxString& srcfile, bool testOnly )
 	DevCon.WriteLn ("offset      = %d", m_offset);
 	DevCon.WriteLn ("blocksize   = %u", m_blocksize);
 	DevCon.WriteLn ("blockoffset = %d", m_blockofs);
+	if (m_mapped)
+		DevCon.WriteLn("reads       = memory mapped");
 
 	return true;
 }
 
 void InputIsoFile::Close()
 {
+	if (m_reader)
+	{
+		FlushReadAhead();
+
+		u64 total = m_readahead_hits + m_readahead_misses;
+		if (total)
+			DevCon.WriteLn("isoFile read-ahead: %.1f%% hits (%llu reads), %llu sectors prefetched",
+				100.0 * m_readahead_hits / total, total, m_readahead_prefetched);
+	}
+
 	delete m_reader;
 	m_reader = NULL;
 	
@@ -0,0 +1,315 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "IsoCompressor.h"
+#include "IsoFileFormats.h"
+#include "Utilities/PersistentThread.h"
+
+#include <atomic>
+#include <vector>
+
+// Uncompressed bytes per unit of work. Whole frames of either format.
+static const uint CompressUnitSize = 1024 * 1024;
+
+class IsoCompressorThread;
+
+// --------------------------------------------------------------------------------------
+//  IsoCompressor
+// --------------------------------------------------------------------------------------
+// The calling thread reads the source and writes the image, in order. Units in between
+// are compressed by the workers. There are only so many units in flight, which bounds
+// the memory use and keeps the writes sequential.
+class IsoCompressor
+{
+	DeclareNoncopyableObject(IsoCompressor);
+	friend class IsoCompressorThread;
+
+	enum UnitState { UnitFree, UnitQueued, UnitBusy, UnitDone, UnitFailed };
+
+	struct Frame
+	{
+		u32 offset;	// in out, or in in when stored as is
+		u32 size;
+		u32 bytes;
+		bool compressed;
+	};
+
+	struct Unit
+	{
+		u64 index;
+		std::atomic<int> state;
+		std::vector<u8> in;
+		std::vector<u8> out;
+		std::vector<Frame> frames;
+	};
+
+	int m_version;
+	uint m_frameSize;
+
+	std::vector<Unit> m_units;
+	std::vector<IsoCompressorThread*> m_workers;
+	Threading::Mutex m_unitLock;
+	Threading::Semaphore m_unitQueued;
+	Threading::Semaphore m_unitDone;
+	std::atomic<bool> m_stopping;
+
+public:
+	IsoCompressor(int version);
+	virtual ~IsoCompressor();
+
+	void Run(InputIsoFile& src, OutputIsoFile& dest);
+
+protected:
+	void StartWorkers();
+	void StopWorkers();
+	void CompressUnit(IsoFrameCompressor& compressor, Unit& unit);
+};
+
+// --------------------------------------------------------------------------------------
+//  IsoCompressorThread
+// --------------------------------------------------------------------------------------
+class IsoCompressorThread : public Threading::pxThread
+{
+	IsoCompressor& m_owner;
+	IsoFrameCompressor m_compressor;
+
+public:
+	IsoCompressorThread(IsoCompressor& owner)
+		: m_owner(owner)
+	{
+		m_name = L"ISO Compressor";
+		m_compressor.Init(owner.m_version);
+	}
+
+	virtual ~IsoCompressorThread()
+	{
+		try {
+			pxThread::Cancel();
+		}
+		DESTRUCTOR_CATCHALL
+	}
+
+protected:
+	void ExecuteTaskInThread()
+	{
+		for (;;) {
+			m_owner.m_unitQueued.WaitNoCancel();
+			if (m_owner.m_stopping)
+				return;
+
+			// The writer waits for the earliest unit, so that one goes first
+			IsoCompressor::Unit* unit = NULL;
+			{
+				Threading::ScopedLock lock(m_owner.m_unitLock);
+				for (auto& u : m_owner.m_units) {
+					if (u.state == IsoCompressor::UnitQueued && (!unit || u.index < unit->index))
+						unit = &u;
+				}
+				if (unit)
+					unit->state = IsoCompressor::UnitBusy;
+			}
+
+			if (!unit)
+				continue;
+
+			try {
+				m_owner.CompressUnit(m_compressor, *unit);
+				unit->state = IsoCompressor::UnitDone;
+			} catch (BaseException& ex) {
+				Console.Error(ex.FormatDiagnosticMessage());
+				unit->state = IsoCompressor::UnitFailed;
+			}
+			m_owner.m_unitDone.Post();
+		}
+	}
+};
+
+IsoCompressor::IsoCompressor(int version)
+	: m_version(version)
+	, m_frameSize(IsoFrameCompressor::GetFrameSize(version))
+	, m_stopping(false)
+{
+}
+
+IsoCompressor::~IsoCompressor()
+{
+	StopWorkers();
+}
+
+void IsoCompressor::StartWorkers()
+{
+	// One core is left for reading and writing
+	int count = std::max(1, (int)x86caps.LogicalCores - 1);
+
+	// Enough units to keep everybody busy while the writer waits for the oldest one
+	m_units = std::vector<Unit>(count * 2 + 2);
+	for (auto& unit : m_units)
+		unit.state = UnitFree;
+
+	m_stopping = false;
+	for (int i = 0; i < count; i++) {
+		IsoCompressorThread* worker = new IsoCompressorThread(*this);
+		worker->Start();
+		m_workers.push_back(worker);
+	}
+
+	Console.WriteLn("isoFile compressing with %d threads", count);
+}
+
+void IsoCompressor::StopWorkers()
+{
+	if (m_workers.empty())
+		return;
+
+	m_stopping = true;
+	m_unitQueued.Post(m_workers.size());
+
+	for (IsoCompressorThread* worker : m_workers) {
+		worker->Block();
+		delete worker;
+	}
+	m_workers.clear();
+}
+
+void IsoCompressor::CompressUnit(IsoFrameCompressor& compressor, Unit& unit)
+{
+	std::vector<u8> compressed;
+	unit.out.clear();
+	unit.frames.clear();
+
+	for (size_t pos = 0; pos < unit.in.size(); pos += m_frameSize) {
+		Frame frame;
+		frame.bytes = (u32)std::min<size_t>(m_frameSize, unit.in.size() - pos);
+		frame.compressed = compressor.Compress(unit.in.data() + pos, frame.bytes, compressed);
+
+		if (frame.compressed) {
+			frame.offset = (u32)unit.out.size();
+			frame.size = (u32)compressed.size();
+			unit.out.insert(unit.out.end(), compressed.begin(), compressed.end());
+		} else {
+			frame.offset = (u32)pos;
+			frame.size = frame.bytes;
+		}
+		unit.frames.push_back(frame);
+	}
+}
+
+void IsoCompressor::Run(InputIsoFile& src, OutputIsoFile& dest)
+{
+	const uint blocksize = src.GetBlockSize();
+	const uint blocks = src.GetBlockCount();
+	const uint mode = blocksize == 2048 ? CDVD_MODE_2048 : CDVD_MODE_2352;
+	const u64 total = (u64)blocks * blocksize;
+	const u64 unitCount = (total + CompressUnitSize - 1) / CompressUnitSize;
+
+	dest.WriteHeader(src.GetBlockOffset(), blocksize, blocks);
+
+	StartWorkers();
+
+	std::vector<u8> sector(CD_FRAMESIZE_RAW);
+	std::vector<u8> pending;	// sectors read but not handed out yet
+	uint lsn = 0;
+	u64 nextRead = 0, nextWrite = 0;
+	int lastPercent = -1;
+	u64 start = GetCPUTicks();
+
+	while (nextWrite < unitCount) {
+		// Keep the workers fed
+		while (nextRead < unitCount && nextRead - nextWrite < m_units.size()) {
+			Unit& unit = m_units[nextRead % m_units.size()];
+			const size_t unitBytes = (size_t)std::min<u64>(CompressUnitSize, total - nextRead * CompressUnitSize);
+
+			while (pending.size() < unitBytes) {
+				src.BeginRead2(lsn);
+				if (src.FinishRead3(sector.data(), mode) < 0)
+					throw Exception::BadStream(src.GetFilename()).SetDiagMsg(pxsFmt(L"Can't read sector %u", lsn));
+				pending.insert(pending.end(), sector.begin(), sector.begin() + blocksize);
+				lsn++;
+			}
+
+			unit.in.assign(pending.begin(), pending.begin() + unitBytes);
+			pending.erase(pending.begin(), pending.begin() + unitBytes);
+			unit.index = nextRead++;
+
+			unit.state = UnitQueued;
+			m_unitQueued.Post();
+		}
+
+		Unit& unit = m_units[nextWrite % m_units.size()];
+		while (unit.state != UnitDone && unit.state != UnitFailed)
+			m_unitDone.WaitNoCancel();
+
+		if (unit.state == UnitFailed)
+			throw Exception::BadStream(dest.GetFilename()).SetDiagMsg(L"Compression failed");
+
+		for (const Frame& frame : unit.frames) {
+			const u8* data = frame.compressed ? unit.out.data() : unit.in.data();
+			dest.WriteFrame(data + frame.offset, frame.size, frame.bytes, frame.compressed);
+		}
+		unit.state = UnitFree;
+		nextWrite++;
+
+		const int percent = (int)(nextWrite * 100 / unitCount);
+		if (percent / 5 != lastPercent / 5) {
+			Console.WriteLn(Color_Gray, "isoFile compressing: %d%%", percent);
+			lastPercent = percent;
+		}
+	}
+
+	StopWorkers();
+
+	const double seconds = (double)(GetCPUTicks() - start) / GetTickFrequency();
+	Console.WriteLn("isoFile compressed %llu MB in %.1f s (%.1f MB/s)", total >> 20, seconds,
+	                seconds > 0 ? total / seconds / (1024 * 1024) : 0.0);
+}
+
+bool CompressIsoFile(const wxString& srcfile, const wxString& destfile)
+{
+	const wxString ext = destfile.Lower().AfterLast(L'.');
+	int version;
+	if (ext == L"cso")
+		version = 4;
+	else if (ext == L"zst")
+		version = 3;
+	else {
+		Console.Error(L"isoFile: can't compress to '%s', use a .cso or .zst file name", WX_STR(destfile));
+		return false;
+	}
+
+	InputIsoFile src;
+	OutputIsoFile dest;
+
+	try {
+		if (!src.Open(srcfile))
+			return false;
+
+		dest.Create(destfile, version);
+
+		IsoCompressor compressor(version);
+		compressor.Run(src, dest);
+		dest.Close();
+	} catch (BaseException& ex) {
+		Console.Error(ex.FormatDiagnosticMessage());
+		if (dest.IsOpened()) {
+			dest.Discard();
+			wxRemoveFile(destfile);
+		}
+		return false;
+	}
+
+	Console.WriteLn(Color_Green, L"isoFile: '%s' compressed to '%s'", WX_STR(srcfile), WX_STR(destfile));
+	return true;
+}
@@ -15,17 +15,71 @@
 
 #pragma once
 
+#include "Utilities/Threading.h"
+#include <wx/hashmap.h>
+#include <memory>
+#include <unordered_map>
+
 enum IsoFS_Type
 {
 	FStype_ISO9660	= 1,
 	FStype_Joliet	= 2,
 };
 
+// --------------------------------------------------------------------------------------
+//  IsoDirectoryListing
+// --------------------------------------------------------------------------------------
+// Parsed contents of a single directory extent, with a hashed name index.  Listings are
+// immutable once parsed, so they can be shared by any number of IsoDirectory objects.
+//
+struct IsoDirectoryListing
+{
+	std::vector<IsoFileDescriptor>	files;
+	std::unordered_map<wxString, int, wxStringHash, wxStringEqual> index;
+
+	void Parse(SectorSource& reader, const IsoFileDescriptor& directoryEntry);
+};
+
+typedef std::shared_ptr<const IsoDirectoryListing> IsoDirectoryListingPtr;
+
+// --------------------------------------------------------------------------------------
+//  IsoDirectoryCache
+// --------------------------------------------------------------------------------------
+// Remembers the root descriptor and every directory parsed so far for one disc, keyed by
+// the directory's starting lba.  Repeated path lookups (SYSTEM.CNF, the boot ELF, IRX
+// modules, ...) then never need to touch the media again.  The cache must be cleared
+// whenever the underlying disc changes.
+//
+class IsoDirectoryCache
+{
+protected:
+	Threading::Mutex	m_lock;
+	u32					m_generation;
+	bool				m_hasRoot;
+	IsoFileDescriptor	m_rootEntry;
+	IsoFS_Type			m_rootType;
+
+	std::unordered_map<u32, IsoDirectoryListingPtr> m_dirs;
+
+public:
+	IsoDirectoryCache();
+	virtual ~IsoDirectoryCache() = default;
+
+	u32 GetGeneration();
+	bool GetRoot(IsoFileDescriptor& entry, IsoFS_Type& type);
+	void SetRoot(const IsoFileDescriptor& entry, IsoFS_Type type, u32 generation);
+
+	IsoDirectoryListingPtr Find(u32 lba);
+	void Add(u32 lba, const IsoDirectoryListingPtr& listing, u32 generation);
+
+	void Clear();
+};
+
 class IsoDirectory
 {
 public:
 	SectorSource&					internalReader;
-	std::vector<IsoFileDescriptor>	files;
+	IsoDirectoryListingPtr			m_listing;
 	IsoFS_Type						m_fstype;
 
 public:
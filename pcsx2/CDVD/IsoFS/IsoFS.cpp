@@ -39,6 +39,113 @@ wxString IsoDirectory::FStype_ToString() const
 	return wxsFormat( L"Unrecognized Code (0x%x)", m_fstype );
 }
 
+//////////////////////////////////////////////////////////////////////////
+// IsoDirectoryCache
+//////////////////////////////////////////////////////////////////////////
+
+IsoDirectoryCache::IsoDirectoryCache()
+{
+	m_generation	= 0;
+	m_hasRoot		= false;
+	m_rootType		= FStype_ISO9660;
+}
+
+u32 IsoDirectoryCache::GetGeneration()
+{
+	Threading::ScopedLock lock( m_lock );
+	return m_generation;
+}
+
+bool IsoDirectoryCache::GetRoot(IsoFileDescriptor& entry, IsoFS_Type& type)
+{
+	Threading::ScopedLock lock( m_lock );
+	if( !m_hasRoot ) return false;
+
+	entry	= m_rootEntry;
+	type	= m_rootType;
+	return true;
+}
+
+// The generation parameter guards against a disc swap that happens while the caller was
+// still reading the old disc: anything parsed before the swap is silently discarded.
+void IsoDirectoryCache::SetRoot(const IsoFileDescriptor& entry, IsoFS_Type type, u32 generation)
+{
+	Threading::ScopedLock lock( m_lock );
+	if( generation != m_generation ) return;
+
+	m_rootEntry	= entry;
+	m_rootType	= type;
+	m_hasRoot	= true;
+}
+
+IsoDirectoryListingPtr IsoDirectoryCache::Find(u32 lba)
+{
+	Threading::ScopedLock lock( m_lock );
+	auto it = m_dirs.find( lba );
+	return (it == m_dirs.end()) ? IsoDirectoryListingPtr() : it->second;
+}
+
+void IsoDirectoryCache::Add(u32 lba, const IsoDirectoryListingPtr& listing, u32 generation)
+{
+	Threading::ScopedLock lock( m_lock );
+	if( generation != m_generation ) return;
+
+	m_dirs[lba] = listing;
+}
+
+void IsoDirectoryCache::Clear()
+{
+	Threading::ScopedLock lock( m_lock );
+
+	++m_generation;
+	m_hasRoot = false;
+	m_dirs.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IsoDirectoryListing
+//////////////////////////////////////////////////////////////////////////
+
+void IsoDirectoryListing::Parse(SectorSource& reader, const IsoFileDescriptor& directoryEntry)
+{
+	// parse directory sector
+	IsoFile dataStream (reader, directoryEntry);
+
+	files.clear();
+	index.clear();
+
+	uint remainingSize = directoryEntry.size;
+
+	u8 b[257];
+
+	while(remainingSize>=4) // hm hack :P
+	{
+		b[0] = dataStream.read<u8>();
+
+		if(b[0]==0)
+		{
+			break; // or continue?
+		}
+
+		remainingSize -= b[0];
+
+		dataStream.read(b+1, b[0]-1);
+
+		files.push_back(IsoFileDescriptor(b, b[0]));
+	}
+
+	b[0] = 0;
+
+	// emplace keeps the first occurrence of a name, same as the old linear search did.
+	index.reserve( files.size() );
+	for(unsigned int i=0;i<files.size();i++)
+		index.emplace( files[i].name, i );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// IsoDirectory
+//////////////////////////////////////////////////////////////////////////
+
 // Used to load the Root directory from an image
 IsoDirectory::IsoDirectory(SectorSource& r)
 	: internalReader(r)
@@ -50,6 +157,15 @@ IsoDirectory::IsoDirectory(SectorSource& r)
 
 	m_fstype = FStype_ISO9660;
 
+	IsoDirectoryCache* cache = internalReader.getDirectoryCache();
+	const u32 generation = cache ? cache->GetGeneration() : 0;
+
+	if( cache && cache->GetRoot( rootDirEntry, m_fstype ) )
+	{
+		Init( rootDirEntry );
+		return;
+	}
+
 	while( !done )
 	{
 		u8 sector[2048];
@@ -99,6 +215,7 @@ IsoDirectory::IsoDirectory(SectorSource& r)
 			.SetDiagMsg(L"IsoFS could not find the root directory on the ISO image.");
 
 	DevCon.WriteLn( L"(IsoFS) Filesystem is " + FStype_ToString() );
+	if( cache ) cache->SetRoot( rootDirEntry, m_fstype, generation );
 	Init( rootDirEntry );
 }
 
@@ -112,45 +229,27 @@ IsoDirectory::IsoDirectory(SectorSource& r, IsoFileDescriptor directoryEntry)
 
 void IsoDirectory::Init(const IsoFileDescriptor& directoryEntry)
 {
-	// parse directory sector
-	IsoFile dataStream (internalReader, directoryEntry);
+	IsoDirectoryCache* cache = internalReader.getDirectoryCache();
+	const u32 generation = cache ? cache->GetGeneration() : 0;
 
-	files.clear();
+	if( cache && (m_listing = cache->Find( directoryEntry.lba )) ) return;
 
-	uint remainingSize = directoryEntry.size;
-
-	u8 b[257];
-
-	while(remainingSize>=4) // hm hack :P
-	{
-		b[0] = dataStream.read<u8>();
-
-		if(b[0]==0)
-		{
-			break; // or continue?
-		}
+	std::shared_ptr<IsoDirectoryListing> listing( new IsoDirectoryListing );
+	listing->Parse( internalReader, directoryEntry );
+	m_listing = listing;
 
-		remainingSize -= b[0];
-
-		dataStream.read(b+1, b[0]-1);
-
-		files.push_back(IsoFileDescriptor(b, b[0]));
-	}
-
-	b[0] = 0;
+	if( cache ) cache->Add( directoryEntry.lba, m_listing, generation );
 }
 
 const IsoFileDescriptor& IsoDirectory::GetEntry(int index) const
 {
-	return files[index];
+	return m_listing->files[index];
 }
 
 int IsoDirectory::GetIndexOf(const wxString& fileName) const
 {
-	for(unsigned int i=0;i<files.size();i++)
-	{
-		if(files[i].name == fileName) return i;
-	}
+	auto it = m_listing->index.find( fileName );
+	if( it != m_listing->index.end() ) return it->second;
 
 	throw Exception::FileNotFound(fileName);
 }
@@ -16,9 +16,14 @@
 
 #include "PrecompiledHeader.h"
 
+#include "IsoFS.h"
 #include "IsoFSCDVD.h"
 #include "../CDVDaccess.h"
 
+// Directory information is shared by every IsoFSCDVD instance, since they all read from
+// the same (currently inserted) disc.
+static IsoDirectoryCache s_cdvdDirectoryCache;
+
 IsoFSCDVD::IsoFSCDVD()
 {
 }
@@ -35,3 +40,13 @@ int IsoFSCDVD::getNumSectors()
 
 	return td.lsn;
 }
+
+IsoDirectoryCache* IsoFSCDVD::getDirectoryCache()
+{
+	return &s_cdvdDirectoryCache;
+}
+
+void IsoFSCDVD::ClearDirectoryCache()
+{
+	s_cdvdDirectoryCache.Clear();
+}
@@ -28,4 +28,9 @@ public:
 	virtual bool readSector(unsigned char* buffer, int lba);
 
 	virtual int  getNumSectors();
+
+	virtual IsoDirectoryCache* getDirectoryCache();
+
+	// Drops all cached directory information; must be called when the disc is changed.
+	static void ClearDirectoryCache();
 };
@@ -15,10 +15,16 @@
 
 #pragma once
 
+class IsoDirectoryCache;
+
 class SectorSource
 {
 public:
 	virtual int  getNumSectors()=0;
 	virtual bool readSector(unsigned char* buffer, int lba)=0;
+
+	// Sources that outlive a single lookup can return a directory cache here, which
+	// IsoDirectory will use to avoid re-reading directory sectors.  NULL disables caching.
+	virtual IsoDirectoryCache* getDirectoryCache() { return NULL; }
 	virtual ~SectorSource() = default;
 };
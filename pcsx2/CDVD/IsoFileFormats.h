@@ -19,7 +19,11 @@
 #include "wx/wfstream.h"
 #include "AsyncFileReader.h"
 #include "CompressedFileReader.h"
+#include "Utilities/ScopedAlloc.h"
 #include <memory>
+#include <vector>
+
+typedef struct z_stream_s z_stream;
 
 enum isoType
 {
@@ -41,6 +45,20 @@ class InputIsoFile
 	
 	 static const uint MaxReadUnit = 128;
 
+	// Read-ahead ring. Each slot holds up to ReadUnit sectors. Once the drive reads
+	// sequentially the next unit is fetched asynchronously while the current one is
+	// being consumed. The reader only supports a single request in flight.
+	static const uint ReadAheadSlots = 4;
+	static const uint ReadAheadTrigger = 2;	// sequential sectors before we start prefetching
+
+	struct ReadSlot
+	{
+		uint lsn;
+		uint count;	// 0 if empty
+		bool pending;
+		u8* data;
+	};
+
 protected:
 	 uint ReadUnit;
 
@@ -60,10 +78,18 @@ protected:
 	// total number of blocks in the ISO image (including all parts)
 	u32			m_blocks;
 		
-	bool		m_read_inprogress;
-	uint		m_read_lsn;
-	uint		m_read_count;
-	u8			m_readbuffer[MaxReadUnit * CD_FRAMESIZE_RAW];
+	ReadSlot	m_slots[ReadAheadSlots];
+	int			m_current_slot;
+	int			m_pending_slot;	// slot of the read in flight, or -1
+	uint		m_seq_run;
+	bool		m_mapped;	// m_reader gives direct sector pointers, the ring is unused
+
+	// read-ahead stats (in sectors)
+	u64			m_readahead_hits;
+	u64			m_readahead_misses;
+	u64			m_readahead_prefetched;
+
+	ScopedAlignedAlloc<u8, 4096> m_readbuffer;
 	
 public:	
 	InputIsoFile();
@@ -74,6 +100,7 @@ public:
 	isoType GetType() const		{ return m_type; }
 	uint GetBlockCount() const	{ return m_blocks; }	
 	int GetBlockOffset() const	{ return m_blockofs; }
+	uint GetBlockSize() const	{ return m_blocksize; }
 	
 	const wxString& GetFilename() const
 	{
@@ -89,14 +116,59 @@ public:
 
 	void BeginRead2(uint lsn);
 	int FinishRead3(u8* dest, uint mode);
-	
+
+	// Copies the sectors from lsn on that are mapped or in a completed read-ahead slot,
+	// up to count, the way FinishRead3 does.  Never starts nor waits for a read, stops at
+	// the first sector that isn't buffered and returns the number of sectors copied.
+	uint ReadCached(u8* dest, uint lsn, uint count, uint mode);
+
+	u64 GetReadAheadHits() const		{ return m_readahead_hits; }
+	u64 GetReadAheadMisses() const		{ return m_readahead_misses; }
+	uint GetReadAheadWindow() const;
+
 protected:
 	void _init();
 
+	int FindSlot(uint lsn) const;
+	int FindVictim() const;
+	int WaitSlot(int slot);
+	void ReadSlotAsync(int slot, uint lsn, uint count);
+	void Prefetch();
+	void FlushReadAhead();
+	void CopySector(u8* dst, const u8* src, uint lsn, uint mode);
+
 	bool tryIsoType(u32 _size, s32 _offset, s32 _blockofs);
 	void FindParts();
 };
 
+// --------------------------------------------------------------------------------------
+//  IsoFrameCompressor
+// --------------------------------------------------------------------------------------
+// Compresses the frames of a compressed OutputIsoFile (version 3 or 4). It keeps its
+// zlib/zstd context between frames, so use one per thread.
+class IsoFrameCompressor
+{
+	DeclareNoncopyableObject( IsoFrameCompressor );
+
+protected:
+	int			m_version;
+	z_stream*	m_zstream;
+	void*		m_zstdContext;
+
+public:
+	IsoFrameCompressor();
+	virtual ~IsoFrameCompressor();
+
+	void Init(int version);
+	void Close();
+
+	static uint GetFrameSize(int version);
+
+	// Returns false if the frame doesn't shrink and should be stored as is (CSO only),
+	// dest is left undefined then.
+	bool Compress(const u8* src, size_t size, std::vector<u8>& dest);
+};
+
 class OutputIsoFile
 {
 	DeclareNoncopyableObject( OutputIsoFile );
@@ -116,6 +188,17 @@ protected:
 	// dtable is used when reading blockdumps
 	std::vector<u32> m_dtable;
 
+	// version 3 writes a seekable zstd image (see ZstdFileReader), version 4 a CSO v1
+	// image. Both are compressed frame by frame, and have to be written in order.
+	IsoFrameCompressor	m_compressor;
+	std::vector<u8>		m_frame;		// sectors of the frame being filled
+	std::vector<u8>		m_compressed;
+	uint				m_nextLsn;
+	u64					m_frameBytes;	// decompressed bytes of the frames written
+	std::vector<u32>	m_zstdTable;	// compressed and decompressed size of each frame
+	std::vector<u32>	m_csoIndex;		// offset of each frame, shifted by m_csoAlign
+	u8					m_csoAlign;
+
 	std::unique_ptr<wxFileOutputStream>	m_outstream;
 		
 public:	
@@ -132,16 +215,25 @@ public:
 
 	void Create(const wxString& filename, int mode);
 	void Close();
+	void Discard();
 
 	void WriteHeader(int blockofs, uint blocksize, uint blocks);
 
 	void WriteSector(const u8* src, uint lsn);
+
+	// Appends a frame which was already compressed (IsoFrameCompressor of the same
+	// version), for compressing on several threads. bytes is the decompressed size.
+	void WriteFrame(const void* src, size_t size, uint bytes, bool compressed);
 	
 protected:
 	void _init();
 
 	void WriteBuffer( const void* src, size_t size );
 
+	bool IsCompressed() const { return m_version == 3 || m_version == 4; }
+	void FlushFrames();
+	void FinishFrames();
+
 	template< typename T >
 	void WriteValue( const T& data )
 	{
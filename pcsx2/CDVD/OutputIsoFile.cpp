@@ -17,9 +17,145 @@
 #include "PrecompiledHeader.h"
 #include "IopCommon.h"
 #include "IsoFileFormats.h"
+#include "CsoFileReader.h"
+#include "ZstdFileReader.h"
 
 #include <errno.h>
 
+#ifdef __POSIX__
+#include <zlib.h>
+#else
+#include <zlib/zlib.h>
+#endif
+
+#ifdef PCSX2_ZSTD
+#include <zstd.h>
+
+// Decompressed size of each frame of a zstd image, the unit of random access when reading
+static const uint ZstdFrameSize = 256 * 1024;
+// Images are written once and read often, favour ratio
+static const int ZstdLevel = 12;
+#endif
+
+// CSO frames are a single sector, like most other tools write them
+static const uint CsoFrameSize = 2048;
+
+// --------------------------------------------------------------------------------------
+//  IsoFrameCompressor
+// --------------------------------------------------------------------------------------
+IsoFrameCompressor::IsoFrameCompressor()
+{
+	m_version		= 0;
+	m_zstream		= NULL;
+	m_zstdContext	= NULL;
+}
+
+IsoFrameCompressor::~IsoFrameCompressor()
+{
+	Close();
+}
+
+void IsoFrameCompressor::Init(int version)
+{
+	Close();
+	m_version = version;
+
+	if (m_version == 4)
+	{
+		m_zstream = new z_stream;
+		m_zstream->zalloc = Z_NULL;
+		m_zstream->zfree = Z_NULL;
+		m_zstream->opaque = Z_NULL;
+
+		// Raw deflate, which is what CsoFileReader inflates
+		if (deflateInit2(m_zstream, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			delete m_zstream;
+			m_zstream = NULL;
+			throw Exception::OutOfMemory(L"CSO deflate stream");
+		}
+	}
+#ifdef PCSX2_ZSTD
+	else if (m_version == 3)
+	{
+		m_zstdContext = ZSTD_createCCtx();
+		if (!m_zstdContext)
+			throw Exception::OutOfMemory(L"zstd compression context");
+	}
+#endif
+}
+
+void IsoFrameCompressor::Close()
+{
+	if (m_zstream)
+	{
+		deflateEnd(m_zstream);
+		delete m_zstream;
+		m_zstream = NULL;
+	}
+
+#ifdef PCSX2_ZSTD
+	if (m_zstdContext)
+	{
+		ZSTD_freeCCtx((ZSTD_CCtx*)m_zstdContext);
+		m_zstdContext = NULL;
+	}
+#endif
+
+	m_version = 0;
+}
+
+uint IsoFrameCompressor::GetFrameSize(int version)
+{
+#ifdef PCSX2_ZSTD
+	if (version == 3)
+		return ZstdFrameSize;
+#endif
+	return CsoFrameSize;
+}
+
+bool IsoFrameCompressor::Compress(const u8* src, size_t size, std::vector<u8>& dest)
+{
+	if (m_zstream)
+	{
+		dest.resize(deflateBound(m_zstream, size));
+
+		deflateReset(m_zstream);
+		m_zstream->next_in = (Bytef*)src;
+		m_zstream->avail_in = size;
+		m_zstream->next_out = dest.data();
+		m_zstream->avail_out = dest.size();
+
+		if (deflate(m_zstream, Z_FINISH) != Z_STREAM_END)
+			throw Exception::BadStream().SetDiagMsg(L"CSO deflate failed");
+
+		dest.resize(m_zstream->total_out);
+		return dest.size() < size;
+	}
+
+#ifdef PCSX2_ZSTD
+	if (m_zstdContext)
+	{
+		dest.resize(ZSTD_compressBound(size));
+		size_t csize = ZSTD_compressCCtx((ZSTD_CCtx*)m_zstdContext, dest.data(), dest.size(), src, size, ZstdLevel);
+
+		if (ZSTD_isError(csize))
+			throw Exception::BadStream().SetDiagMsg(pxsFmt(L"zstd compression failed: %s", ZSTD_getErrorName(csize)));
+
+		// Every part of a seekable image has to be a zstd frame
+		dest.resize(csize);
+		return true;
+	}
+#endif
+
+	pxFailDev("IsoFrameCompressor used without Init");
+	return false;
+}
+
+// --------------------------------------------------------------------------------------
+//  OutputIsoFile
+// --------------------------------------------------------------------------------------
+
 void pxStream_OpenCheck( const wxStreamBase& stream, const wxString& fname, const wxString& mode )
 {
 	if (stream.IsOk()) return;
@@ -47,6 +183,13 @@ void OutputIsoFile::_init()
 	m_blockofs		= 0;
 	m_blocksize		= 0;
 	m_blocks		= 0;
+
+	m_frame.clear();
+	m_nextLsn		= 0;
+	m_frameBytes	= 0;
+	m_zstdTable.clear();
+	m_csoIndex.clear();
+	m_csoAlign		= 0;
 }
 
 void OutputIsoFile::Create(const wxString& filename, int version)
@@ -59,6 +202,14 @@ void OutputIsoFile::Create(const wxString& filename, int version)
 	m_blockofs	= 24;
 	m_blocksize	= 2048;
 
+#ifndef PCSX2_ZSTD
+	if (m_version == 3)
+		throw Exception::BadStream(m_filename).SetDiagMsg(L"This build has no zstd support");
+#endif
+
+	if (IsCompressed())
+		m_compressor.Init(m_version);
+
 	m_outstream = std::make_unique<wxFileOutputStream>(m_filename);
 	pxStream_OpenCheck( *m_outstream, m_filename, L"writing" );
 
@@ -83,6 +234,31 @@ void OutputIsoFile::WriteHeader(int _blockofs, uint _blocksize, uint _blocks)
 		WriteValue(m_blocks);
 		WriteValue(m_blockofs);
 	}
+	else if (m_version == 4)
+	{
+		const u64 total = (u64)m_blocks * m_blocksize;
+		const u32 frames = (u32)((total + CsoFrameSize - 1) / CsoFrameSize);
+
+		// Index entries have 31 bits, pick the smallest alignment which can address
+		// the worst case: every frame stored uncompressed, plus padding.
+		const u64 headerSize = sizeof(CsoHeader) + (u64)(frames + 1) * sizeof(u32);
+		while ((headerSize + total + ((u64)frames << m_csoAlign)) >> m_csoAlign >= 0x80000000)
+			m_csoAlign++;
+
+		CsoHeader hdr = {};
+		memcpy(hdr.magic, "CISO", 4);
+		hdr.header_size	= sizeof(CsoHeader);
+		hdr.total_bytes	= total;
+		hdr.frame_size	= CsoFrameSize;
+		hdr.ver			= 1;
+		hdr.align		= m_csoAlign;
+		WriteValue(hdr);
+
+		// The index is filled in at Close, once all offsets are known
+		std::vector<u32> index(frames + 1, 0);
+		WriteBuffer(index.data(), index.size() * sizeof(u32));
+		m_csoIndex.reserve(frames + 1);
+	}
 }
 
 void OutputIsoFile::WriteSector(const u8* src, uint lsn)
@@ -97,6 +273,24 @@ void OutputIsoFile::WriteSector(const u8* src, uint lsn)
 
 		WriteValue<u32>( lsn );
 	}
+	else if (IsCompressed())
+	{
+		// The image is compressed as it goes, so it has to be written in order. Sectors
+		// we've already passed are dropped and holes are zero filled.
+		if (lsn < m_nextLsn)
+			return;
+
+		for (; m_nextLsn < lsn; m_nextLsn++)
+		{
+			m_frame.insert(m_frame.end(), m_blocksize, 0);
+			FlushFrames();
+		}
+
+		m_frame.insert(m_frame.end(), src + m_blockofs, src + m_blockofs + m_blocksize);
+		m_nextLsn++;
+		FlushFrames();
+		return;
+	}
 	else
 	{
 		wxFileOffset ofs = (wxFileOffset)lsn * m_blocksize + m_offset;
@@ -109,6 +303,23 @@ void OutputIsoFile::WriteSector(const u8* src, uint lsn)
 
 void OutputIsoFile::Close()
 {
+	if (IsCompressed() && IsOpened())
+	{
+		FinishFrames();
+		m_outstream = nullptr;
+	}
+
+	m_compressor.Close();
+	m_dtable.clear();
+
+	_init();
+}
+
+// Closes without finishing a compressed image, after a failure
+void OutputIsoFile::Discard()
+{
+	m_outstream = nullptr;
+	m_compressor.Close();
 	m_dtable.clear();
 
 	_init();
@@ -129,6 +340,116 @@ void OutputIsoFile::WriteBuffer( const void* src, size_t size )
 	}
 }
 
+// Appends a compressed frame and records it in the seek table or the index
+void OutputIsoFile::WriteFrame(const void* src, size_t size, uint bytes, bool compressed)
+{
+	m_frameBytes += bytes;
+
+	if (m_version == 3)
+	{
+		WriteBuffer(src, size);
+		m_zstdTable.push_back((u32)size);
+		m_zstdTable.push_back(bytes);
+	}
+	else if (m_version == 4)
+	{
+		// Frames start at multiples of the index alignment
+		wxFileOffset pos = m_outstream->TellO();
+		const wxFileOffset alignMask = ((wxFileOffset)1 << m_csoAlign) - 1;
+		if (pos & alignMask)
+		{
+			static const u8 padding[256] = {};
+			WriteBuffer(padding, (size_t)(alignMask + 1 - (pos & alignMask)));
+			pos = (pos + alignMask) & ~alignMask;
+		}
+
+		m_csoIndex.push_back((u32)(pos >> m_csoAlign) | (compressed ? 0 : 0x80000000));
+		WriteBuffer(src, size);
+	}
+}
+
+// Compresses the pending sectors into as many whole frames as they fill
+void OutputIsoFile::FlushFrames()
+{
+	const uint frameSize = IsoFrameCompressor::GetFrameSize(m_version);
+	size_t done = 0;
+
+	for (; m_frame.size() - done >= frameSize; done += frameSize)
+	{
+		const u8* frame = m_frame.data() + done;
+
+		if (m_compressor.Compress(frame, frameSize, m_compressed))
+			WriteFrame(m_compressed.data(), m_compressed.size(), frameSize, true);
+		else
+			WriteFrame(frame, frameSize, frameSize, false);
+	}
+
+	m_frame.erase(m_frame.begin(), m_frame.begin() + done);
+}
+
+// Writes the last (partial) frame and the seek table or index
+void OutputIsoFile::FinishFrames()
+{
+	// Zero fill up to the size given to WriteHeader, the index covers all of it
+	const uint frameSize = IsoFrameCompressor::GetFrameSize(m_version);
+	const u64 total = (u64)m_blocks * m_blocksize;
+
+	while (m_frameBytes + m_frame.size() < total)
+	{
+		m_frame.resize(m_frame.size() + (size_t)std::min<u64>(frameSize, total - m_frameBytes - m_frame.size()), 0);
+		FlushFrames();
+	}
+
+	FlushFrames();
+
+	if (!m_frame.empty())
+	{
+		if (m_compressor.Compress(m_frame.data(), m_frame.size(), m_compressed))
+			WriteFrame(m_compressed.data(), m_compressed.size(), m_frame.size(), true);
+		else
+			WriteFrame(m_frame.data(), m_frame.size(), m_frame.size(), false);
+		m_frame.clear();
+	}
+
+	if (m_version == 3)
+	{
+#ifdef PCSX2_ZSTD
+		const u32 frames = m_zstdTable.size() / 2;
+
+		WriteValue<u32>(ZSTD_SEEKABLE_SKIPPABLE_MAGIC);
+		WriteValue<u32>(frames * 8 + ZSTD_SEEKABLE_FOOTER_SIZE);
+		WriteBuffer(m_zstdTable.data(), m_zstdTable.size() * sizeof(u32));
+
+		WriteValue<u32>(frames);
+		WriteValue<u8>(0); // no checksums
+		WriteValue<u32>(ZSTD_SEEKABLE_MAGIC);
+
+		Console.WriteLn("isoFile zstd image done: %u frames", frames);
+#endif
+	}
+	else if (m_version == 4)
+	{
+		// The last entry marks the end of the last frame
+		const u32 frames = m_csoIndex.size();
+		m_csoIndex.push_back((u32)(m_outstream->TellO() >> m_csoAlign));
+
+		// Round the file up so the end offset is exact
+		const wxFileOffset alignMask = ((wxFileOffset)1 << m_csoAlign) - 1;
+		const wxFileOffset tail = m_outstream->TellO() & alignMask;
+		if (tail)
+		{
+			static const u8 padding[256] = {};
+			WriteBuffer(padding, (size_t)(alignMask + 1 - tail));
+			m_csoIndex.back()++;
+		}
+
+		m_outstream->SeekO(sizeof(CsoHeader));
+		WriteBuffer(m_csoIndex.data(), m_csoIndex.size() * sizeof(u32));
+
+		Console.WriteLn("isoFile cso image done: %u frames", frames);
+	}
+}
+
 bool OutputIsoFile::IsOpened() const
 {
 	return m_outstream && m_outstream->IsOk();
@@ -0,0 +1,230 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "AsyncFileReader.h"
+#include "CompressedFileReaderUtils.h"
+#include "ZstdFileReader.h"
+
+#ifdef PCSX2_ZSTD
+
+#include <zstd.h>
+#include <algorithm>
+
+static bool ReadFooter(FILE* fp, u32& frames, u32& entrySize, PX_off_t& tableStart) {
+	u8 footer[ZSTD_SEEKABLE_FOOTER_SIZE];
+
+	if (PX_fseeko(fp, -(PX_off_t)ZSTD_SEEKABLE_FOOTER_SIZE, SEEK_END) != 0)
+		return false;
+	PX_off_t footerStart = PX_ftello(fp);
+	if (fread(footer, 1, sizeof(footer), fp) != sizeof(footer))
+		return false;
+
+	if (*(u32*)(footer + 5) != ZSTD_SEEKABLE_MAGIC)
+		return false;
+
+	// Bit 7 is the checksum flag, bits 2-6 are reserved and must be zero
+	const u8 descriptor = footer[4];
+	if (descriptor & 0x7C)
+		return false;
+
+	frames = *(u32*)footer;
+	entrySize = (descriptor & 0x80) ? 12 : 8;
+	tableStart = footerStart - (PX_off_t)frames * entrySize;
+
+	// The table lives in a skippable frame, its header is right before the entries.
+	if (tableStart < 8 || PX_fseeko(fp, tableStart - 8, SEEK_SET) != 0)
+		return false;
+
+	u32 header[2];
+	if (fread(header, 1, sizeof(header), fp) != sizeof(header))
+		return false;
+
+	return header[0] == ZSTD_SEEKABLE_SKIPPABLE_MAGIC && header[1] == frames * entrySize + ZSTD_SEEKABLE_FOOTER_SIZE;
+}
+
+bool ZstdFileReader::CanHandle(const wxString& fileName) {
+	bool supported = false;
+	if (wxFileName::FileExists(fileName) && fileName.Lower().EndsWith(L".zst")) {
+		FILE* fp = PX_fopen_rb(fileName);
+		if (fp) {
+			u32 frames, entrySize;
+			PX_off_t tableStart;
+			supported = ReadFooter(fp, frames, entrySize, tableStart);
+			if (!supported)
+				Console.Error(L"Only seekable zstd images are supported (see zstd's seekable_format).");
+			fclose(fp);
+		}
+	}
+	return supported;
+}
+
+bool ZstdFileReader::Open(const wxString& fileName) {
+	Close();
+	m_filename = fileName;
+	m_src = PX_fopen_rb(m_filename);
+
+	bool success = false;
+	if (m_src && ReadSeekTable()) {
+		m_dctx = ZSTD_createDCtx();
+		success = m_dctx != NULL;
+	}
+
+	if (!success) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool ZstdFileReader::ReadSeekTable() {
+	u32 frames, entrySize;
+	PX_off_t tableStart;
+
+	if (!ReadFooter(m_src, frames, entrySize, tableStart)) {
+		Console.Error(L"Zstd image has an invalid seek table.");
+		return false;
+	}
+
+	std::vector<u8> table((size_t)frames * entrySize);
+	if (PX_fseeko(m_src, tableStart, SEEK_SET) != 0 || fread(table.data(), 1, table.size(), m_src) != table.size()) {
+		Console.Error(L"Unable to read the zstd seek table.");
+		return false;
+	}
+
+	m_compressedOffsets.resize(frames + 1);
+	m_offsets.resize(frames + 1);
+	m_compressedOffsets[0] = 0;
+	m_offsets[0] = 0;
+
+	u32 maxCompressed = 0;
+	for (u32 i = 0; i < frames; i++) {
+		const u32 compressed = *(u32*)&table[i * entrySize + 0];
+		const u32 decompressed = *(u32*)&table[i * entrySize + 4];
+
+		m_compressedOffsets[i + 1] = m_compressedOffsets[i] + compressed;
+		m_offsets[i + 1] = m_offsets[i] + decompressed;
+		maxCompressed = std::max(maxCompressed, compressed);
+	}
+
+	// The frames can't overlap the seek table
+	if (m_compressedOffsets[frames] > (u64)tableStart - 8) {
+		Console.Error(L"Zstd seek table doesn't match the file size.");
+		return false;
+	}
+
+	m_totalSize = m_offsets[frames];
+	m_readBuffer.resize(maxCompressed);
+
+	return true;
+}
+
+void ZstdFileReader::Close() {
+	m_filename.Empty();
+
+	m_cache.Clear();
+
+	if (m_src) {
+		fclose(m_src);
+		m_src = NULL;
+	}
+	if (m_dctx) {
+		ZSTD_freeDCtx(m_dctx);
+		m_dctx = NULL;
+	}
+
+	m_compressedOffsets.clear();
+	m_offsets.clear();
+	m_readBuffer.clear();
+	m_totalSize = 0;
+}
+
+int ZstdFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
+	if (!m_src) {
+		return 0;
+	}
+
+	u8* dest = (u8*)pBuffer;
+	// We do it this way in case m_blocksize is not well aligned to our frame size.
+	u64 pos = (u64)sector * (u64)m_blocksize;
+	int remaining = count * m_blocksize;
+	int bytes = 0;
+
+	while (remaining > 0) {
+		int readBytes = ReadFromFrame(dest + bytes, pos + bytes, remaining);
+		if (readBytes == 0) {
+			// We hit EOF.
+			break;
+		}
+
+		bytes += readBytes;
+		remaining -= readBytes;
+	}
+
+	return bytes;
+}
+
+// Reads up to the end of the frame holding pos. Frames are decompressed whole into the cache.
+int ZstdFileReader::ReadFromFrame(u8 *dest, u64 pos, int maxBytes) {
+	if (pos >= m_totalSize) {
+		// Can't read anything passed the end.
+		return 0;
+	}
+
+	const u32 frame = (u32)(std::upper_bound(m_offsets.begin(), m_offsets.end(), pos) - m_offsets.begin() - 1);
+	const u64 frameStart = m_offsets[frame];
+	const u32 frameSize = (u32)(m_offsets[frame + 1] - frameStart);
+	const u32 rawSize = (u32)(m_compressedOffsets[frame + 1] - m_compressedOffsets[frame]);
+
+	const int bytes = (int)std::min((u64)maxBytes, frameStart + frameSize - pos);
+	int cached = m_cache.Read(dest, pos, bytes);
+	if (cached >= 0)
+		return cached;
+
+	if (PX_fseeko(m_src, m_compressedOffsets[frame], SEEK_SET) != 0 || fread(m_readBuffer.data(), 1, rawSize, m_src) != rawSize) {
+		Console.Error("Unable to read zstd frame.");
+		return 0;
+	}
+
+	void* decompressed = m_cache.Alloc(frameSize);
+	size_t res = ZSTD_decompressDCtx(m_dctx, decompressed, frameSize, m_readBuffer.data(), rawSize);
+	if (ZSTD_isError(res) || res != frameSize) {
+		Console.Error("Unable to decompress zstd frame: %s", ZSTD_isError(res) ? ZSTD_getErrorName(res) : "size mismatch");
+		m_cache.Release(decompressed);
+		return 0;
+	}
+
+	int copied = ChunksCache::CopyAvailable(decompressed, frameStart, frameSize, dest, pos, bytes);
+	m_cache.Take(decompressed, frameStart, frameSize, frameSize);
+
+	return copied;
+}
+
+void ZstdFileReader::BeginRead(void* pBuffer, uint sector, uint count) {
+	// TODO: No async support yet, implement as sync.
+	m_bytesRead = ReadSync(pBuffer, sector, count);
+}
+
+int ZstdFileReader::FinishRead() {
+	int res = m_bytesRead;
+	m_bytesRead = -1;
+	return res;
+}
+
+void ZstdFileReader::CancelRead() {
+	// TODO: No async read support yet.
+}
+
+#endif
@@ -0,0 +1,86 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Reader for zstd compressed images in the zstd "seekable" format: a sequence of
+// independent zstd frames followed by a skippable frame holding the seek table.
+// See contrib/seekable_format/zstd_seekable_compression_format.md in the zstd sources.
+// Only built when libzstd is available (PCSX2_ZSTD), see CompressedFileReader.
+
+#include "AsyncFileReader.h"
+#include "ChunksCache.h"
+#include <vector>
+
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+static const uint ZSTD_CHUNKCACHE_SIZE_MB = 200;
+
+// Seek table constants, shared with the writer in OutputIsoFile
+static const u32 ZSTD_SEEKABLE_SKIPPABLE_MAGIC = 0x184D2A5E;
+static const u32 ZSTD_SEEKABLE_MAGIC = 0x8F92EAB1;
+static const u32 ZSTD_SEEKABLE_FOOTER_SIZE = 9;
+
+class ZstdFileReader : public AsyncFileReader
+{
+	DeclareNoncopyableObject(ZstdFileReader);
+public:
+	ZstdFileReader(void) :
+		m_totalSize(0),
+		m_src(0),
+		m_dctx(0),
+		m_cache(ZSTD_CHUNKCACHE_SIZE_MB),
+		m_bytesRead(0) {
+		m_blocksize = 2048;
+	};
+
+	virtual ~ZstdFileReader(void) { Close(); };
+
+	static  bool CanHandle(const wxString& fileName);
+	virtual bool Open(const wxString& fileName);
+
+	virtual int ReadSync(void* pBuffer, uint sector, uint count);
+
+	virtual void BeginRead(void* pBuffer, uint sector, uint count);
+	virtual int FinishRead(void);
+	virtual void CancelRead(void);
+
+	virtual void Close(void);
+
+	virtual uint GetBlockCount(void) const {
+		return (m_totalSize - m_dataoffset) / m_blocksize;
+	};
+
+	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
+	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+
+private:
+	bool ReadSeekTable();
+	int ReadFromFrame(u8 *dest, u64 pos, int maxBytes);
+
+	// Per frame start offsets, with one extra entry for the end of the data
+	std::vector<u64> m_compressedOffsets;
+	std::vector<u64> m_offsets;
+
+	u64 m_totalSize;
+	FILE* m_src;
+	ZSTD_DCtx* m_dctx;
+	std::vector<u8> m_readBuffer;
+
+	ChunksCache m_cache;
+
+	// The result of a read is stored here between BeginRead() and FinishRead().
+	int m_bytesRead;
+};
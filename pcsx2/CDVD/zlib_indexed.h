@@ -208,6 +208,29 @@ local struct access *addpoint(struct access *index, int bits,
     return index;
 }
 
+/* Optional hooks for building an index while another thread reads through it.
+   Every change to the access point list is made between lock() and unlock(),
+   and the current (partial) index is stored in *published each time, so
+   extract() can be used on it for any offset - just from a possibly distant
+   access point.  progress() is called after each input chunk; a non-zero
+   return value aborts the build with Z_ERRNO.  On failure the partial index
+   stays published and is left for the caller to free. */
+struct build_hooks {
+    void (*lock)(void *opaque);
+    void (*unlock)(void *opaque);
+    int (*progress)(void *opaque, PX_off_t totin);
+    struct access **published;
+    void *opaque;
+};
+
+typedef struct build_hooks BuildHooks;
+
+local void publish_index(struct build_hooks *hooks, struct access *index)
+{
+    if (hooks != NULL)
+        *hooks->published = index;
+}
+
 /* Make one entire pass through the compressed stream and build an index, with
    access points about every span bytes of uncompressed output -- span is
    chosen to balance the speed of random access against the memory requirements
@@ -216,7 +239,8 @@ local struct access *addpoint(struct access *index, int bits,
    returns the number of access points on success (>= 1), Z_MEM_ERROR for out
    of memory, Z_DATA_ERROR for an error in the input file, or Z_ERRNO for a
    file read error.  On success, *built points to the resulting index. */
-local int build_index(FILE *in, PX_off_t span, struct access **built)
+local int build_index(FILE *in, PX_off_t span, struct access **built,
+                      struct build_hooks *hooks = NULL)
 {
     int ret;
     PX_off_t totin, totout, totPrinted;     /* our own total counters to avoid 4GB limit */
@@ -288,8 +312,18 @@ local int build_index(FILE *in, PX_off_t span, struct access **built)
              */
             if ((strm.data_type & 128) && !(strm.data_type & 64) &&
                 (totout == 0 || totout - last > span)) {
+                if (hooks != NULL)
+                    hooks->lock(hooks->opaque);
+                int first = index == NULL;
                 index = addpoint(index, strm.data_type & 7, totin,
                                  totout, strm.avail_out, window);
+                if (index != NULL && first) {
+                    index->span = span;
+                    index->uncompressed_size = 0;
+                }
+                publish_index(hooks, index);
+                if (hooks != NULL)
+                    hooks->unlock(hooks->opaque);
                 if (index == NULL) {
                     ret = Z_MEM_ERROR;
                     goto build_index_error;
@@ -297,7 +331,12 @@ local int build_index(FILE *in, PX_off_t span, struct access **built)
                 last = totout;
             }
         } while (strm.avail_in != 0);
-        if (totin / (50 * 1024 * 1024) != totPrinted / (50 * 1024 * 1024)) {
+        if (hooks != NULL && hooks->progress != NULL) {
+            if (hooks->progress(hooks->opaque, totin)) {
+                ret = Z_ERRNO;
+                goto build_index_error;
+            }
+        } else if (totin / (50 * 1024 * 1024) != totPrinted / (50 * 1024 * 1024)) {
             printf("%dMB ", (int)(totin / (1024 * 1024)));
             totPrinted = totin;
         }
@@ -310,17 +349,22 @@ local int build_index(FILE *in, PX_off_t span, struct access **built)
 
     /* clean up and return index (release unused entries in list) */
     (void)inflateEnd(&strm);
+    if (hooks != NULL)
+        hooks->lock(hooks->opaque);
     index->list = (Point*)realloc(index->list, sizeof(struct point) * index->have);
     index->size = index->have;
     index->span = span;
     index->uncompressed_size = totout;
+    publish_index(hooks, index);
+    if (hooks != NULL)
+        hooks->unlock(hooks->opaque);
     *built = index;
     return index->have;
 
     /* return error */
   build_index_error:
     (void)inflateEnd(&strm);
-    if (index != NULL)
+    if (index != NULL && hooks == NULL)
         free_index(index);
     return ret;
 }
@@ -13,7 +13,6 @@
  *  If not, see <http://www.gnu.org/licenses/>.
  */
 
-
 #include "PrecompiledHeader.h"
 #include "Common.h"
 #include "Cache.h"
@@ -28,16 +27,28 @@ _cacheS pCache[64];
 using namespace R5900;
 using namespace vtlb_private;
 
+vtlbHandler cachedRamHandler = 0;
 
-
-int getFreeCache(u32 mem, int mode, int * way ) {
-	int number;
-	int i = (mem >> 6) & 0x3F;
+// Host address of an EE virtual address.  Pages under cache emulation are mapped to the
+// cachedRamHandler (see memSetPageAddr), so their host address has to be taken from the
+// physical address instead of the vmap.
+static __fi s32 getCachePPF(u32 mem)
+{
 	u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
 	s32 ppf=mem+vmv;
 
-	u32 hand=(u8)vmv;
-	u32 paddr=ppf-hand+0x80000000;
+	if (ppf < 0)
+		ppf = (s32)(uptr)PSM(ppf - (u8)vmv + 0x80000000);
+
+	return ppf;
+}
+
+// ppf - host address of the access.  Tags hold the host address of the line | 0x80000000.
+static int getFreeCache(s32 ppf, int * way ) {
+	int number;
+	int i = (ppf >> 6) & 0x3F;
+
+	u32 paddr=ppf+0x80000000;
 
 	if((cpuRegs.CP0.n.Config & 0x10000)  == 0) CACHE_LOG("Cache off!");
 	
@@ -62,7 +73,7 @@ int getFreeCache(u32 mem, int mode, int * way ) {
 	ppf = (ppf & ~0x3F) ; 
 	if((pCache[i].tag[number] & (DIRTY_FLAG|VALID_FLAG)) == (DIRTY_FLAG|VALID_FLAG))	// Dirty Write
 	{		
-		s32 oldppf = (pCache[i].tag[number] & ~0x80000fff) + (mem & 0xFC0);
+		s32 oldppf = (pCache[i].tag[number] & ~0x80000fff) + (ppf & 0xFC0);
 		
 		CACHE_LOG("Dirty cache fill! PPF %x", oldppf);
 		*reinterpret_cast<mem64_t*>(oldppf) = pCache[i].data[number][0].b8._u64[0];
@@ -100,154 +111,108 @@ int getFreeCache(u32 mem, int mode, int * way ) {
 	
 }
 
-void writeCache8(u32 mem, u8 value) {
-	int i, number;
-	//u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-	//s32 ppf=(mem+vmv) & ~0x3f;
-	i = getFreeCache(mem,1,&number);
+// --------------------------------------------------------------------------------------
+//  Cached accesses by host address
+// --------------------------------------------------------------------------------------
+// Shared by the interpreter (which checks CheckCache() itself) and by the cachedRamHandler
+// the recompilers reach through the vtlb indirect path.
 
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		*reinterpret_cast<mem8_t*>(ppf) = value;
-		return;
-	}
-	CACHE_LOG("writeCache8 %8.8x adding to %d, way %d, value %x", mem, i,number,value);
-	pCache[i].tag[number] |= DIRTY_FLAG;	// Set Dirty Bit if mode == write
-	pCache[i].data[number][(mem>>4) & 0x3].b8._u8[(mem&0xf)] = value;
-}
+template< typename T >
+static void writeCacheHost(s32 ppf, T value)
+{
+	int number;
+	int i = getFreeCache(ppf, &number);
 
-void writeCache16(u32 mem, u16 value) {
-	int i, number;
-	//u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-	//s32 ppf=(mem+vmv) & ~0x3f;
-	i = getFreeCache(mem,1,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		*reinterpret_cast<mem16_t*>(ppf) = value;
-		return;
-	}
-	CACHE_LOG("writeCache16 %8.8x adding to %d, way %d, value %x", mem, i,number,value);
+	CACHE_LOG("writeCache%d %8.8x adding to %d, way %d, value %x", (int)sizeof(T) * 8, ppf, i, number, (u32)value);
 	pCache[i].tag[number] |= DIRTY_FLAG;	// Set Dirty Bit if mode == write
-	pCache[i].data[number][(mem>>4) & 0x3].b8._u16[(mem&0xf)>>1] = value;
+	*reinterpret_cast<T*>(&pCache[i].data[number][(ppf>>4) & 0x3].b8._u8[ppf & (0x10 - sizeof(T))]) = value;
 }
 
-void writeCache32(u32 mem, u32 value) {
-	int i, number;
-	//u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-	//s32 ppf=(mem+vmv) & ~0x3f;
-	i = getFreeCache(mem,1,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		*reinterpret_cast<mem32_t*>(ppf) = value;
-		return;
-	}
-	CACHE_LOG("writeCache32 %8.8x adding to %d, way %d, value %x", mem, i,number,value);
+static void writeCache128Host(s32 ppf, const mem128_t* value)
+{
+	int number;
+	int i = getFreeCache(ppf, &number);
+
+	CACHE_LOG("writeCache128 %8.8x adding to %d way %x tag %x vallo = %x_%x valhi = %x_%x", ppf, i, number, pCache[i].tag[number], value->lo, value->hi);
 	pCache[i].tag[number] |= DIRTY_FLAG;	// Set Dirty Bit if mode == write
-	pCache[i].data[number][(mem>>4) & 0x3].b8._u32[(mem&0xf)>>2] = value;
+	pCache[i].data[number][(ppf>>4) & 0x3].b8._u64[0] = value->lo;
+	pCache[i].data[number][(ppf>>4) & 0x3].b8._u64[1] = value->hi;
 }
 
-void writeCache64(u32 mem, const u64 value) {
-	int i, number;
-	//u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-	//s32 ppf=(mem+vmv) & ~0x3f;
-	i = getFreeCache(mem,1,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		*reinterpret_cast<mem64_t*>(ppf) = value;
-		return;
-	}
-	CACHE_LOG("writeCache64 %8.8x adding to %d, way %d, value %x", mem, i,number,value);
-	pCache[i].tag[number] |= DIRTY_FLAG;	// Set Dirty Bit if mode == write
-	pCache[i].data[number][(mem>>4) & 0x3].b8._u64[(mem&0xf)>>3] = value;
+template< typename T >
+static T readCacheHost(s32 ppf)
+{
+	int number;
+	int i = getFreeCache(ppf, &number);
+
+	T value = *reinterpret_cast<T*>(&pCache[i].data[number][(ppf>>4) & 0x3].b8._u8[ppf & (0x10 - sizeof(T))]);
+	CACHE_LOG("readCache%d %8.8x from %d, way %d QW %x Really Reading %x", (int)sizeof(T) * 8, ppf, i, number, (ppf >> 4) & 0x3, (u32)value);
+	return value;
 }
 
-void writeCache128(u32 mem, const mem128_t* value){
-	int i, number;
-	//u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-	//s32 ppf=(mem+vmv) & ~0x3f;
-	i = getFreeCache(mem,1,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		*reinterpret_cast<mem64_t*>(ppf) = value->lo;
-		*reinterpret_cast<mem64_t*>(ppf+8) = value->hi;
-		return;
-	}
-	CACHE_LOG("writeCache128 %8.8x adding to %d way %x tag %x vallo = %x_%x valhi = %x_%x", mem, i, number, pCache[i].tag[number], value->lo, value->hi);
-	pCache[i].tag[number] |= DIRTY_FLAG;	// Set Dirty Bit if mode == write
-	pCache[i].data[number][(mem>>4) & 0x3].b8._u64[0] = value->lo;
-	pCache[i].data[number][(mem>>4) & 0x3].b8._u64[1] = value->hi;
+void writeCache8(u32 mem, u8 value)					{ writeCacheHost<u8>(getCachePPF(mem), value); }
+void writeCache16(u32 mem, u16 value)				{ writeCacheHost<u16>(getCachePPF(mem), value); }
+void writeCache32(u32 mem, u32 value)				{ writeCacheHost<u32>(getCachePPF(mem), value); }
+void writeCache64(u32 mem, const u64 value)			{ writeCacheHost<u64>(getCachePPF(mem), value); }
+void writeCache128(u32 mem, const mem128_t* value)	{ writeCache128Host(getCachePPF(mem), value); }
+
+u8 readCache8(u32 mem)		{ return readCacheHost<u8>(getCachePPF(mem)); }
+u16 readCache16(u32 mem)	{ return readCacheHost<u16>(getCachePPF(mem)); }
+u32 readCache32(u32 mem)	{ return readCacheHost<u32>(getCachePPF(mem)); }
+u64 readCache64(u32 mem)	{ return readCacheHost<u64>(getCachePPF(mem)); }
+
+// --------------------------------------------------------------------------------------
+//  cachedRamHandler
+// --------------------------------------------------------------------------------------
+// vtlb handler for main RAM pages that are mapped cached (EntryLo C=3) while cache
+// emulation is enabled.  Mapping them to a handler makes the recompilers' existing
+// sign check on the vmap entry double as the "is this access cached" check: uncached
+// accesses keep their direct inline path, and cached ones take the indirect dispatch to
+// these functions (paddr is the physical address).
+
+static __fi s32 cachedRamPPF(u32 paddr)
+{
+	return (s32)(uptr)PSM(paddr);
 }
 
-u8 readCache8(u32 mem) {
-	int number;
-	
-	int i = getFreeCache(mem,0,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		return *(u8*)ppf;
-	}
+static mem8_t __fastcall cachedRamRead8(u32 paddr)		{ return readCacheHost<u8>(cachedRamPPF(paddr)); }
+static mem16_t __fastcall cachedRamRead16(u32 paddr)	{ return readCacheHost<u16>(cachedRamPPF(paddr)); }
+static mem32_t __fastcall cachedRamRead32(u32 paddr)	{ return readCacheHost<u32>(cachedRamPPF(paddr)); }
 
-	CACHE_LOG("readCache %8.8x from %d, way %d QW %x u8 part %x Really Reading %x", mem, i, number, (mem >> 4) & 0x3, (mem & 0xf) >> 2, (u32)pCache[i].data[number][(mem >> 4) & 0x3].b8._u8[(mem & 0xf)]);
-	return pCache[i].data[number][(mem >> 4) & 0x3].b8._u8[(mem&0xf)];
+static void __fastcall cachedRamRead64(u32 paddr, mem64_t* data)
+{
+	*data = readCacheHost<u64>(cachedRamPPF(paddr));
 }
 
-u16 readCache16(u32 mem) {
-	int number;
-	
-	int i = getFreeCache(mem,0,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		return *(u16*)ppf;
-	}
-
-	CACHE_LOG("readCache %8.8x from %d, way %d QW %x u16 part %x Really Reading %x", mem, i, number, (mem >> 4) & 0x3, (mem & 0xf) >> 2, (u32)pCache[i].data[number][(mem >> 4) & 0x3].b8._u16[(mem & 0xf) >> 1]);
-	return pCache[i].data[number][(mem >> 4) & 0x3].b8._u16[(mem&0xf)>>1];
+static void __fastcall cachedRamRead128(u32 paddr, mem128_t* data)
+{
+	data->lo = readCacheHost<u64>(cachedRamPPF(paddr));
+	data->hi = readCacheHost<u64>(cachedRamPPF(paddr + 8));
 }
 
-u32 readCache32(u32 mem) {
-	int number;
-	
-	int i = getFreeCache(mem,0,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		return *(u32*)ppf;
-	}
+static void __fastcall cachedRamWrite8(u32 paddr, mem8_t data)		{ writeCacheHost<u8>(cachedRamPPF(paddr), data); }
+static void __fastcall cachedRamWrite16(u32 paddr, mem16_t data)	{ writeCacheHost<u16>(cachedRamPPF(paddr), data); }
+static void __fastcall cachedRamWrite32(u32 paddr, mem32_t data)	{ writeCacheHost<u32>(cachedRamPPF(paddr), data); }
 
-	CACHE_LOG("readCache %8.8x from %d, way %d QW %x u32 part %x Really Reading %x", mem, i, number, (mem >> 4) & 0x3, (mem & 0xf) >> 2, (u32)pCache[i].data[number][(mem >> 4) & 0x3].b8._u32[(mem & 0xf) >> 2]);
-	return pCache[i].data[number][(mem >> 4) & 0x3].b8._u32[(mem&0xf)>>2];
+static void __fastcall cachedRamWrite64(u32 paddr, const mem64_t* data)
+{
+	writeCacheHost<u64>(cachedRamPPF(paddr), *data);
 }
 
-u64 readCache64(u32 mem) {
-	int number;
-	
-	int i = getFreeCache(mem,0,&number);
-	if(i == -1)
-	{
-		u32 vmv=vtlbdata.vmap[mem>>VTLB_PAGE_BITS];
-		s32 ppf=mem+vmv;
-		return *(u64*)ppf;
-	}
+static void __fastcall cachedRamWrite128(u32 paddr, const mem128_t* data)
+{
+	writeCache128Host(cachedRamPPF(paddr), data);
+}
 
-	CACHE_LOG("readCache %8.8x from %d, way %d QW %x u64 part %x Really Reading %x_%x", mem, i, number, (mem >> 4) & 0x3, (mem & 0xf) >> 2, pCache[i].data[number][(mem >> 4) & 0x3].b8._u64[(mem & 0xf) >> 3]);
-	return pCache[i].data[number][(mem >> 4) & 0x3].b8._u64[(mem&0xf)>>3];
+void cacheRegisterHandler()
+{
+	cachedRamHandler = vtlb_RegisterHandler(
+		cachedRamRead8, cachedRamRead16, cachedRamRead32, cachedRamRead64, cachedRamRead128,
+		cachedRamWrite8, cachedRamWrite16, cachedRamWrite32, cachedRamWrite64, cachedRamWrite128
+	);
 }
 
+
 namespace R5900 {
 namespace Interpreter
 {
@@ -266,11 +231,8 @@ void CACHE() {
 		{
 			int index = (addr >> 6) & 0x3F;
 			int way = 0;
-			u32 pfnaddr = addr;
-			u32 vmv=vtlbdata.vmap[pfnaddr>>VTLB_PAGE_BITS];
-			s32 ppf=pfnaddr+vmv;
-			u32 hand=(u8)vmv;
-			u32 paddr=ppf-hand+0x80000000;
+			s32 ppf=getCachePPF(addr);
+			u32 paddr=ppf+0x80000000;
 
 			if((paddr & ~0xFFF) == (pCache[index].tag[0] & ~0xfff) && (pCache[index].tag[0] & VALID_FLAG))
 			{
@@ -304,11 +266,8 @@ void CACHE() {
 		{
 			int index = (addr >> 6) & 0x3F;
 			int way = 0;
-			u32 pfnaddr = addr;
-			u32 vmv=vtlbdata.vmap[pfnaddr>>VTLB_PAGE_BITS];
-			s32 ppf=(pfnaddr+vmv) & ~0x3F;
-			u32 hand=(u8)vmv;
-			u32 paddr=ppf-hand+0x80000000;
+			s32 ppf=getCachePPF(addr) & ~0x3F;
+			u32 paddr=ppf+0x80000000;
 
 			if ((pCache[index].tag[0] & ~0xFFF) == (paddr & ~0xFFF) && (pCache[index].tag[0] & VALID_FLAG))
 			{
@@ -39,6 +39,10 @@ struct _cacheS {
 
 extern _cacheS pCache[64];
 
+// vtlb handler for cached RAM pages, see memSetPageAddr.
+extern vtlbHandler cachedRamHandler;
+extern void cacheRegisterHandler();
+
 void writeCache8(u32 mem, u8 value);
 void writeCache16(u32 mem, u16 value);
 void writeCache32(u32 mem, u32 value);
@@ -155,19 +155,24 @@ struct TraceLogFilters
 	// so I prefer this to help keep them usable.
 	bool	Enabled;
 
+	// Binary - records the logs to emuLog.trace without formatting them (see BinaryTrace.h),
+	// for tracing at close to full speed.  Decode with tools/tracedump.
+	bool	Binary;
+
 	TraceFiltersEE	EE;
 	TraceFiltersIOP	IOP;
 
 	TraceLogFilters()
 	{
 		Enabled	= false;
+		Binary	= false;
 	}
 
 	void LoadSave( IniInterface& ini );
 
 	bool operator ==( const TraceLogFilters& right ) const
 	{
-		return OpEqu( Enabled ) && OpEqu( EE ) && OpEqu( IOP );
+		return OpEqu( Enabled ) && OpEqu( Binary ) && OpEqu( EE ) && OpEqu( IOP );
 	}
 
 	bool operator !=( const TraceLogFilters& right ) const
@@ -196,10 +201,10 @@ struct Pcsx2Config
 		BITFIELD32()
 			bool
 				Enabled:1,			// universal toggle for the profiler.
-				RecBlocks_EE:1,		// Enables per-block profiling for the EE recompiler [unimplemented]
-				RecBlocks_IOP:1,	// Enables per-block profiling for the IOP recompiler [unimplemented]
-				RecBlocks_VU0:1,	// Enables per-block profiling for the VU0 recompiler [unimplemented]
-				RecBlocks_VU1:1;	// Enables per-block profiling for the VU1 recompiler [unimplemented]
+				RecBlocks_EE:1,		// Enables per-block profiling for the EE recompiler
+				RecBlocks_IOP:1,	// Enables per-block profiling for the IOP recompiler
+				RecBlocks_VU0:1,	// Enables per-block profiling for the VU0 recompiler
+				RecBlocks_VU1:1;	// Enables per-block profiling for the VU1 recompiler (not sampled with MTVU)
 		BITFIELD_END
 
 		// Default is Disabled, with all recs enabled underneath.
@@ -248,6 +253,10 @@ struct Pcsx2Config
 				PreBlockCheckIOP:1;
 			bool
 				EnableEECache   :1;
+			bool
+				EnableMicroVUCache :1;	// Persist recompiled microPrograms to disk across sessions
+			bool
+				EnableEETiering :1;		// Recompile hot split EE blocks as larger superblocks
 		BITFIELD_END
 
 		RecompilerOptions();
@@ -298,6 +307,8 @@ struct Pcsx2Config
 		bool	SynchronousMTGS;
 
 		int		VsyncQueueSize;
+		bool	VsyncQueueAdaptive;	// retune the queue size from the MTGS frame times (VsyncQueueSize is the start)
+		int		RingSizeFactor;	// MTGS ringbuffer size, as a power of 2 of simd128s
 
 		bool		FrameLimitEnable;
 		bool		FrameSkipEnable;
@@ -305,6 +316,8 @@ struct Pcsx2Config
 
 		int		FramesToDraw;	// number of consecutive frames (fields) to render
 		int		FramesToSkip;	// number of consecutive frames (fields) to skip
+		int		FastForwardInterval;	// fast-forward renders one frame out of this many
+		int		FrameLimitSpinUs;	// last microseconds of a frame limiter wait spent spinning instead of sleeping
 
 		Fixed100	LimitScalar;
 		Fixed100	FramerateNTSC;
@@ -320,6 +333,8 @@ struct Pcsx2Config
 			return
 				OpEqu( SynchronousMTGS )		&&
 				OpEqu( VsyncQueueSize )			&&
+				OpEqu( VsyncQueueAdaptive )		&&
+				OpEqu( RingSizeFactor )			&&
 				
 				OpEqu( FrameSkipEnable )		&&
 				OpEqu( FrameLimitEnable )		&&
@@ -330,7 +345,9 @@ struct Pcsx2Config
 				OpEqu( FrameratePAL )			&&
 
 				OpEqu( FramesToDraw )			&&
-				OpEqu( FramesToSkip );
+				OpEqu( FramesToSkip )			&&
+				OpEqu( FastForwardInterval )	&&
+				OpEqu( FrameLimitSpinUs );
 		}
 
 		bool operator !=( const GSOptions& right ) const
@@ -397,7 +414,9 @@ struct Pcsx2Config
 				IntcStat		:1,		// tells Pcsx2 to fast-forward through intc_stat waits.
 				WaitLoop		:1,		// enables constant loop detection and fast-forwarding
 				vuFlagHack		:1,		// microVU specific flag hack
-				vuThread        :1;		// Enable Threaded VU1
+				vuThread        :1,		// Enable Threaded VU1
+				vu0Thread       :1,		// Enable Threaded VU0 (micro-mode programs only)
+				IopHle			:1;		// runs the IOP sysclib memory/string functions natively
 		BITFIELD_END
 
 		s8	EECycleRate;		// EE cycle rate selector (1.0, 1.5, 2.0)
@@ -453,6 +472,7 @@ struct Pcsx2Config
 			CdvdVerboseReads	:1,		// enables cdvd read activity verbosely dumped to the console
 			CdvdDumpBlocks		:1,		// enables cdvd block dumping
 			CdvdShareWrite		:1,		// allows the iso to be modified while it's loaded
+			CdvdMappedReads		:1,		// reads local uncompressed isos through a memory mapping (linux)
 			EnablePatches		:1,		// enables patch detection and application
 			EnableCheats		:1,		// enables cheat detection and application
 			EnableWideScreenPatches		:1,
@@ -461,7 +481,13 @@ struct Pcsx2Config
 #endif
 		// when enabled uses BOOT2 injection, skipping sony bios splashes
 			UseBOOT2Injection	:1,
+		// fast boot resumes from a cached state of the BIOS at EELOAD (see BootSnapshot.h)
+			FastBootSnapshot	:1,
 			BackupSavestate		:1,
+		// savestates let emulation resume before EE/IOP memory is copied (see mmap_BeginSnapshot)
+			CopyOnWriteSaves	:1,
+		// savestates store only the memory pages that differ from a per-game base state
+			DiffSavestates		:1,
 		// enables simulated ejection of memory cards when loading savestates
 			McdEnableEjection	:1,
 			McdFolderAutoManage	:1,
@@ -470,9 +496,27 @@ struct Pcsx2Config
 			MultitapPort1_Enabled:1,
 
 			ConsoleToStdio		:1,
-			HostFs				:1;
+			HostFs				:1,
+		// backs EE/IOP/VU memory and the recompiler caches with large pages, where the host allows it
+			HostLargePages		:1,
+		// maps the bios rom files copy-on-write rather than reading them, so that instances share them
+			ShareRomMemory		:1;
 	BITFIELD_END
 
+	// Number of reads the linux iso reader keeps in flight (io_uring only, 0 forces libaio)
+	int					CdvdReadQueueDepth;
+
+	// Local disk cache kept per remote (http) image, and the parallel connections used to fill it
+	int					CdvdRemoteCacheMB;
+	int					CdvdRemoteConnections;
+
+	// Frames between rewind snapshots (0 disables rewind), and memory kept for them
+	int					RewindInterval;
+	int					RewindBudgetMB;
+
+	// Frames emulated ahead of the one shown, to hide the game's input lag (0 disables it)
+	int					RunAheadFrames;
+
 	CpuOptions			Cpu;
 	GSOptions			GS;
 	SpeedhackOptions	Speedhacks;
@@ -498,6 +542,12 @@ struct Pcsx2Config
 	{
 		return
 			OpEqu( bitset )		&&
+			OpEqu( CdvdReadQueueDepth ) &&
+			OpEqu( CdvdRemoteCacheMB ) &&
+			OpEqu( CdvdRemoteConnections ) &&
+			OpEqu( RewindInterval ) &&
+			OpEqu( RewindBudgetMB ) &&
+			OpEqu( RunAheadFrames ) &&
 			OpEqu( Cpu )		&&
 			OpEqu( GS )			&&
 			OpEqu( Speedhacks )	&&
@@ -528,6 +578,7 @@ TraceLogFilters&				SetTraceConfig();
 // ------------ CPU / Recompiler Options ---------------
 
 #define THREAD_VU1					(EmuConfig.Cpu.Recompiler.UseMicroVU1 && EmuConfig.Speedhacks.vuThread)
+#define THREAD_VU0					(EmuConfig.Cpu.Recompiler.UseMicroVU0 && EmuConfig.Speedhacks.vu0Thread)
 #define CHECK_MICROVU0				(EmuConfig.Cpu.Recompiler.UseMicroVU0)
 #define CHECK_MICROVU1				(EmuConfig.Cpu.Recompiler.UseMicroVU1)
 #define CHECK_EEREC					(EmuConfig.Cpu.Recompiler.EnableEE && GetCpuProviders().IsRecAvailable_EE())
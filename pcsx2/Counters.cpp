@@ -27,10 +27,15 @@
 
 #include "GS.h"
 #include "VUmicro.h"
+#include "MTVU.h"
 
 #include "ps2/HwInternal.h"
 
 #include "Sio.h"
+#include "Benchmark.h"
+#include "gui/GSFrame.h"
+#include "RunAhead.h"
+#include "Utilities/Instrumentation.h"
 
 #ifndef DISABLE_RECORDING
 #	include "Recording/RecordingControls.h"
@@ -255,6 +260,84 @@ static void vSyncInfoCalc(vSyncTimingInfo* info, Fixed100 framesPerSecond, u32 s
 	// is thus not worth the effort at this time.
 }
 
+// --------------------------------------------------------------------------------------
+//  Input latency probes
+// --------------------------------------------------------------------------------------
+// Each vsync leaves its time (and that of the input change it ends, if any) in a tag slot;
+// its serial travels with the vsync through the MTGS ring, so a ring reset can't mismatch them.
+struct InputLatencyTag
+{
+	std::atomic<u64> vsync;
+	std::atomic<u64> input;
+};
+
+static const uint InputLatencyTagCount = 64;		// well over what the MTGS may queue
+static InputLatencyTag s_latencyTags[InputLatencyTagCount];
+static u64 s_inputChangeTicks = 0;
+static u32 s_vsyncSerial = 0;
+
+void inputLatencyChanged()
+{
+	if (!s_inputChangeTicks && Instrumentation::IsEnabled())
+		s_inputChangeTicks = Instrumentation::GetTicks();
+}
+
+u32 inputLatencyVsync()
+{
+	const u32 serial = s_vsyncSerial++;
+	const u64 now = Instrumentation::IsEnabled() ? Instrumentation::GetTicks() : 0;
+
+	if (s_inputChangeTicks && now)
+		Instrumentation::Add(Instrumentation::Counter_InputToVsync, now - s_inputChangeTicks);
+
+	// Published to the MTGS by the ring write of the vsync packet.
+	InputLatencyTag& tag = s_latencyTags[serial % InputLatencyTagCount];
+	tag.input.store(now ? s_inputChangeTicks : 0, std::memory_order_relaxed);
+	tag.vsync.store(now, std::memory_order_relaxed);
+
+	s_inputChangeTicks = 0;
+	return serial;
+}
+
+void inputLatencyPresent(u32 serial)
+{
+	InputLatencyTag& tag = s_latencyTags[serial % InputLatencyTagCount];
+	const u64 vsync = tag.vsync.exchange(0, std::memory_order_relaxed);
+	const u64 input = tag.input.exchange(0, std::memory_order_relaxed);
+	if (!vsync || !Instrumentation::IsEnabled()) return;
+
+	const u64 now = Instrumentation::GetTicks();
+	Instrumentation::Add(Instrumentation::Counter_VsyncToPresent, now - vsync);
+	if (input)
+		Instrumentation::Add(Instrumentation::Counter_InputToPresent, now - input);
+}
+
+// Cpu time of the emulator threads over the frame that just ended (GSdx graphs them).
+static u64 s_threadCpuTimes[3];
+
+static void instrumentThreadTimes()
+{
+	if (!Instrumentation::IsEnabled() || !GetThreadTicksPerSecond()) return;
+
+	static const Instrumentation::Counter counters[3] =
+	{
+		Instrumentation::Counter_EEThreadTime,
+		Instrumentation::Counter_MTGSThreadTime,
+		Instrumentation::Counter_MTVUThreadTime,
+	};
+
+	const u64 now[3] = { GetCoreThread().GetCpuTime(), GetMTGS().GetCpuTime(), THREAD_VU1 ? vu1Thread.GetCpuTime() : 0 };
+
+	for (int i = 0; i < 3; i++)
+	{
+		// 0 when the thread isn't running, and the first frame has nothing to diff against
+		if (now[i] && s_threadCpuTimes[i] && now[i] > s_threadCpuTimes[i])
+			Instrumentation::Add(counters[i], (now[i] - s_threadCpuTimes[i]) * Instrumentation::GetFrequency() / GetThreadTicksPerSecond());
+
+		s_threadCpuTimes[i] = now[i];
+	}
+}
+
 const char* ReportVideoMode()
 {
 	switch (gsVideoMode)
@@ -382,14 +465,45 @@ u32 UpdateVSyncRate()
 			Console.WriteLn( Color_Green, "(UpdateVSyncRate) FPS Limit Changed : %.02f fps", fpslimit.ToFloat()*2 );
 	}
 
-	m_iStart = GetCPUTicks();
+	// A run-ahead rollback keeps the limiter's schedule, it happens every frame
+	if( !RunAhead::IsCapturing() )
+		m_iStart = GetCPUTicks();
 
 	return (u32)m_iTicks;
 }
 
+static u64 s_paceLast = 0;		// when the frame limiter last let a frame through, 0 to skip the next one
+
 void frameLimitReset()
 {
 	m_iStart = GetCPUTicks();
+	s_paceLast = 0;
+}
+
+static u64 frameLimitToInstrTicks(u64 ticks)
+{
+	return ticks * Instrumentation::GetFrequency() / GetTickFrequency();
+}
+
+// Files the length of the frame that ends now in the frame pacing histogram.
+static void frameLimitPace(u64 now)
+{
+	if( s_paceLast && Instrumentation::IsEnabled() )
+	{
+		const s64 length = now - s_paceLast;
+		const u64 deviation = (u64)std::abs(length - m_iTicks);
+		const u64 us = deviation * 1000000 / GetTickFrequency();
+
+		Instrumentation::Counter bucket =
+			us < 100 ? Instrumentation::Counter_FramePace100us :
+			us < 500 ? Instrumentation::Counter_FramePace500us :
+			us < 1000 ? Instrumentation::Counter_FramePace1ms :
+			us < 2000 ? Instrumentation::Counter_FramePace2ms : Instrumentation::Counter_FramePaceOver;
+
+		Instrumentation::Add(bucket, frameLimitToInstrTicks(deviation));
+	}
+
+	s_paceLast = now;
 }
 
 // Framelimiter - Measures the delta time between calls and stalls until a
@@ -397,8 +511,22 @@ void frameLimitReset()
 // See the GS FrameSkip function for details on why this is here and not in the GS.
 static __fi void frameLimit()
 {
+	const bool fastForward = (g_LimiterMode == Limit_FastForward);
+
+	// The SPU2 keeps mixing (games depend on its timing), but has no business playing any
+	// of it back at a few hundred percent speed.  Cheap enough to just tell it every frame.
+	if( SPU2setFastForward != NULL ) SPU2setFastForward( fastForward );
+
+	// Frames run ahead are emulated as fast as possible, only the kept ones are paced.
+	if( RunAhead::IsSpeculating() ) return;
+
 	// 999 means the user would rather just have framelimiting turned off...
-	if( !EmuConfig.GS.FrameLimitEnable ) return;
+	// Benchmarks measure raw throughput, and fast-forward is just as unthrottled.
+	if( !EmuConfig.GS.FrameLimitEnable || Benchmark::IsActive() || fastForward )
+	{
+		s_paceLast = 0;
+		return;
+	}
 
 	u64 uExpectedEnd	= m_iStart + m_iTicks;
 	u64 iEnd			= GetCPUTicks();
@@ -411,6 +539,7 @@ static __fi void frameLimit()
 	if( sDeltaTime > m_iTicks*8 )
 	{
 		m_iStart = iEnd - m_iTicks;
+		s_paceLast = 0;
 		return;
 	}
 
@@ -423,21 +552,42 @@ static __fi void frameLimit()
 
 	// Shortcut for cases where no waiting is needed (they're running slow already,
 	// so don't bog 'em down with extra math...)
-	if( sDeltaTime >= 0 ) return;
+	if( sDeltaTime >= 0 )
+	{
+		frameLimitPace( iEnd );
+		return;
+	}
 
-	// If we're way ahead then we can afford to sleep the thread a bit.
-	// (note, on Windows sleep(1) thru sleep(2) tend to be the least accurate sleeps,
-	// and longer sleeps tend to be pretty reliable, so that's why the convoluted if/
-	// else below.  The same generally isn't true for Linux, but no harm either way
-	// really.)
+	// Sleep with the finest timer the OS has until the spin margin, then spin the rest
+	// out: even high resolution sleeps wake up some tens or hundreds of microseconds late,
+	// which is what used to leave the frame pacing a millisecond or two off.  A margin of
+	// 0 sleeps all the way (cheaper on battery, less even).
 
-	s32 msec = (int)((sDeltaTime*-1000) / (s64)GetTickFrequency());
-	if( msec > 4 ) Threading::Sleep( msec );
-	else if( msec > 2 ) Threading::Sleep( 1 );
+	const s64 freq = GetTickFrequency();
+	const s64 margin = (s64)std::max( EmuConfig.GS.FrameLimitSpinUs, 0 ) * freq / 1000000;
+	const s64 remaining = -sDeltaTime;
 
-	// Sleep is not picture-perfect accurate, but it's actually not necessary to
-	// maintain a "perfect" lock to uExpectedEnd anyway.  if we're a little ahead
-	// starting this frame, it'll just sleep longer the next to make up for it. :)
+	if( remaining > margin )
+		Threading::SleepPrecise( (u64)(remaining - margin) * 1000000 / freq );
+
+	u64 now = GetCPUTicks();
+
+	if( now > uExpectedEnd )
+	{
+		Instrumentation::Add( Instrumentation::Counter_FrameLimitLate, frameLimitToInstrTicks( now - uExpectedEnd ) );
+	}
+	else
+	{
+		const u64 spinStart = now;
+
+		while( (now = GetCPUTicks()) < uExpectedEnd )
+			Threading::SpinWait();
+
+		Instrumentation::Add( Instrumentation::Counter_FrameLimitSpin, frameLimitToInstrTicks( now - spinStart ) );
+	}
+
+	// An overslept frame is made up for by the next one, which starts from uExpectedEnd.
+	frameLimitPace( now );
 }
 
 static __fi void VSyncStart(u32 sCycle)
@@ -465,9 +615,13 @@ static __fi void VSyncStart(u32 sCycle)
 
 	hwIntcIrq(INTC_VBLANK_S);
 	psxVBlankStart();
+	instrumentThreadTimes();
 	gsPostVsyncStart();
 	if (gates) rcntStartGate(true, sCycle); // Counters Start Gate code
 
+	// The last frame run ahead is on its way to the GS: leave the recompilers to roll back
+	if (RunAhead::PostVsync()) Cpu->CheckExecutionState();
+
 	// INTC - VB Blank Start Hack --
 	// Hack fix!  This corrects a freezeup in Granda 2 where it decides to spin
 	// on the INTC_STAT register after the exception handler has already cleared
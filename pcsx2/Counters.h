@@ -143,3 +143,9 @@ template< uint page > extern u16 rcntRead32( u32 mem );		// returns u16 by desig
 extern u32 UpdateVSyncRate();
 extern void frameLimitReset();
 
+// Input latency probes, published as instrumentation counters.  The first change of a pad's
+// reply since the last vsync is timed to that vsync, and to the GS finishing it.
+extern void inputLatencyChanged();			// EE thread: the pad's reply to a poll changed
+extern u32 inputLatencyVsync();				// EE thread: vsync; returns the serial to pass along
+extern void inputLatencyPresent(u32 serial);	// MTGS thread: GSvsync returned for that vsync
+
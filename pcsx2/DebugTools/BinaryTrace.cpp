@@ -0,0 +1,454 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "BinaryTrace.h"
+#include "Debug.h"
+#include "R5900.h"
+#include "R3000A.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <wx/filename.h>
+
+namespace BinaryTrace
+{
+
+typedef std::pair<const SysTraceLog*, const char*> EventKey;
+
+struct EventKeyHash
+{
+	size_t operator()(const EventKey& key) const
+	{
+		return std::hash<const void*>()(key.first) ^ (std::hash<const void*>()(key.second) * 31);
+	}
+};
+
+struct Event
+{
+	u32 id;
+	u8 cpu;
+	bool text;				// formatted at the call
+	u8 argCount;
+	u8 args[MaxArgs];
+	std::string format;		// as passed by the caller, to catch reused buffers
+	std::string define;		// the Record_Define
+};
+
+// Single producer (the owning thread), single consumer (the writer).
+struct Ring
+{
+	static const u32 Size = 1 << 22;
+
+	u8 data[Size];
+	std::atomic<u32> head;
+	std::atomic<u32> tail;
+	std::atomic<bool> owned;
+	u32 dropped;			// owner only
+
+	Ring() : head(0), tail(0), owned(true), dropped(0) {}
+};
+
+// Interning stops here; anything new is recorded as text.
+static const uint MaxEvents = 4096;
+
+enum WriterState
+{
+	Writer_Idle = 0,		// opened by the first trace
+	Writer_Running,
+	Writer_Closed,			// closed, or could not be opened; traces are discarded
+};
+
+// The writer drains the rings at this interval, or sooner when one is half full.
+static const std::chrono::milliseconds WriterInterval(10);
+
+static std::mutex s_lock;
+static std::condition_variable s_wake;
+static std::unordered_map<EventKey, Event*, EventKeyHash> s_eventMap;
+static std::vector<Event*> s_events;
+static std::vector<Ring*> s_rings;
+static std::thread s_writer;
+static std::atomic<int> s_state(Writer_Idle);
+static bool s_stop = false;
+
+// Writer thread (or with the writer stopped).
+static FILE* s_file = NULL;
+static size_t s_defined = 0;	// events already defined in s_file
+
+struct ThreadState
+{
+	Ring* ring;
+	std::unordered_map<EventKey, const Event*, EventKeyHash> events;
+
+	ThreadState() : ring(NULL) {}
+
+	// The ring is reused by the next thread that traces, once drained.
+	~ThreadState()
+	{
+		if (ring) ring->owned.store(false, std::memory_order_release);
+	}
+};
+
+static thread_local ThreadState t_state;
+
+static void Put(std::string& dest, const void* src, size_t size)
+{
+	dest.append((const char*)src, size);
+}
+
+static Event* NewEvent(const SysTraceLog& log, const char* fmt)
+{
+	Event* event = new Event;
+	event->id = s_events.size();
+	event->cpu = log.GetCpu();
+	event->text = (fmt == NULL);
+	event->argCount = 0;
+
+	std::string format(log.GetMessagePrefix());
+
+	if (fmt)
+	{
+		event->format = fmt;
+		format += fmt;
+
+		for (const char* pos = fmt; *pos && !event->text; ++pos)
+		{
+			if (*pos != '%') continue;
+			if (pos[1] == '%') { ++pos; continue; }
+
+			Conversion conv;
+			if (!ParseConversion(pos + 1, conv) || event->argCount + conv.stars + 1 > MaxArgs)
+			{
+				event->text = true;
+				break;
+			}
+
+			for (uint i = 0; i < conv.stars; ++i)
+				event->args[event->argCount++] = Arg_Int32;
+			event->args[event->argCount++] = conv.type;
+			pos = conv.end - 1;
+		}
+	}
+
+	if (event->text)
+	{
+		event->argCount = 1;
+		event->args[0] = Arg_Text;
+		format = log.GetMessagePrefix();
+		format += "%s";
+	}
+
+	const std::string prefix(std::string(log.GetPrefix()).substr(0, 255));
+	format.resize(std::min<size_t>(format.size(), MaxRecord - DefineRecordSize - MaxArgs - 255));
+
+	const RecordHeader header = { (u16)(DefineRecordSize + event->argCount + prefix.size() + format.size()), Record_Define, event->cpu };
+	const u8 counts[2] = { event->argCount, (u8)prefix.size() };
+	const u16 formatSize = format.size();
+
+	Put(event->define, &header, sizeof(header));
+	Put(event->define, &event->id, 4);
+	Put(event->define, counts, 2);
+	Put(event->define, &formatSize, 2);
+	Put(event->define, event->args, event->argCount);
+	event->define += prefix;
+	event->define += format;
+
+	return event;
+}
+
+static const Event* Intern(const SysTraceLog& log, const char* fmt)
+{
+	std::lock_guard<std::mutex> guard(s_lock);
+
+	// Past the limit, new formats share the text event of their log.
+	if (fmt && s_events.size() >= MaxEvents && !s_eventMap.count(EventKey(&log, fmt)))
+		fmt = NULL;
+
+	Event*& event = s_eventMap[EventKey(&log, fmt)];
+	if (!event)
+	{
+		event = NewEvent(log, fmt);
+		s_events.push_back(event);
+	}
+	return event;
+}
+
+// --------------------------------------------------------------------------------------
+//  Writer
+// --------------------------------------------------------------------------------------
+static void Drain()
+{
+	std::vector< std::pair<Ring*, u32> > pending;
+
+	{
+		std::lock_guard<std::mutex> guard(s_lock);
+
+		// Heads first: any event they use was interned before they were published.
+		for (Ring* ring : s_rings)
+			pending.push_back(std::make_pair(ring, ring->head.load(std::memory_order_acquire)));
+
+		for (; s_defined < s_events.size(); ++s_defined)
+			fwrite(s_events[s_defined]->define.data(), 1, s_events[s_defined]->define.size(), s_file);
+	}
+
+	for (const auto& entry : pending)
+	{
+		Ring& ring = *entry.first;
+		const u32 tail = ring.tail.load(std::memory_order_relaxed);
+		const u32 size = entry.second - tail;
+		if (!size) continue;
+
+		const u32 ofs = tail & (Ring::Size - 1);
+		const u32 first = std::min(size, Ring::Size - ofs);
+		fwrite(ring.data + ofs, 1, first, s_file);
+		fwrite(ring.data, 1, size - first, s_file);
+
+		ring.tail.store(entry.second, std::memory_order_release);
+	}
+
+	fflush(s_file);
+}
+
+static void WriterThread()
+{
+	std::unique_lock<std::mutex> lock(s_lock);
+	while (!s_stop)
+	{
+		s_wake.wait_for(lock, WriterInterval);
+
+		lock.unlock();
+		Drain();
+		lock.lock();
+	}
+}
+
+static void Open()
+{
+	std::lock_guard<std::mutex> guard(s_lock);
+	if (s_state.load(std::memory_order_relaxed) != Writer_Idle) return;
+
+	wxFileName filename(emuLogName.IsEmpty() ? wxString(L"emuLog.txt") : emuLogName);
+	filename.SetExt(L"trace");
+
+	s_file = wxFopen(filename.GetFullPath(), L"wb");
+	if (!s_file)
+	{
+		Console.Error(L"(BinaryTrace) Could not open %s", WX_STR(filename.GetFullPath()));
+		s_state.store(Writer_Closed, std::memory_order_release);
+		return;
+	}
+
+	const FileHeader header = { FileMagic, FileVersion };
+	fwrite(&header, sizeof(header), 1, s_file);
+	s_defined = 0;
+
+	s_stop = false;
+	s_writer = std::thread(WriterThread);
+	s_state.store(Writer_Running, std::memory_order_release);
+
+	Console.WriteLn(L"(BinaryTrace) Writing trace records to %s", WX_STR(filename.GetFullPath()));
+}
+
+void Close()
+{
+	if (s_state.exchange(Writer_Closed, std::memory_order_acq_rel) != Writer_Running) return;
+
+	{
+		std::lock_guard<std::mutex> guard(s_lock);
+		s_stop = true;
+	}
+	s_wake.notify_one();
+	s_writer.join();
+
+	Drain();
+	fclose(s_file);
+	s_file = NULL;
+}
+
+static Ring* AcquireRing()
+{
+	std::lock_guard<std::mutex> guard(s_lock);
+
+	for (Ring* ring : s_rings)
+	{
+		bool owned = false;
+		if (ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire) &&
+			ring->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+		{
+			ring->dropped = 0;
+			return ring;
+		}
+	}
+
+	s_rings.push_back(new Ring);
+	return s_rings.back();
+}
+
+static bool Push(Ring& ring, const u8* data, u32 size)
+{
+	const u32 head = ring.head.load(std::memory_order_relaxed);
+	const u32 used = head - ring.tail.load(std::memory_order_acquire);
+	if (Ring::Size - used < size) return false;
+
+	const u32 ofs = head & (Ring::Size - 1);
+	const u32 first = std::min(size, Ring::Size - ofs);
+	memcpy(ring.data + ofs, data, first);
+	memcpy(ring.data, data + first, size - first);
+
+	ring.head.store(head + size, std::memory_order_release);
+
+	if (used + size >= Ring::Size / 2)
+		s_wake.notify_one();
+	return true;
+}
+
+static u8* PutString(u8* dest, const char* str, uint maxSize)
+{
+	if (!str) str = "(null)";
+	const u16 size = std::min<size_t>(strlen(str), maxSize);
+	memcpy(dest, &size, 2);
+	memcpy(dest + 2, str, size);
+	return dest + 2 + size;
+}
+
+// --------------------------------------------------------------------------------------
+//  Write
+// --------------------------------------------------------------------------------------
+void Write(const SysTraceLog& log, const char* fmt, va_list list)
+{
+	if (s_state.load(std::memory_order_acquire) != Writer_Running)
+	{
+		if (s_state.load(std::memory_order_relaxed) == Writer_Closed) return;
+		Open();
+		if (s_state.load(std::memory_order_acquire) != Writer_Running) return;
+	}
+
+	ThreadState& state = t_state;
+	if (!state.ring) state.ring = AcquireRing();
+
+	const Event*& cached = state.events[EventKey(&log, fmt)];
+	if (!cached) cached = Intern(log, fmt);
+
+	// A format that lives in a reused (or temporary) buffer doesn't match what it was
+	// interned with, and is recorded as text.
+	const Event* event = cached;
+	if (event->format != fmt)
+	{
+		const Event*& text = state.events[EventKey(&log, NULL)];
+		if (!text) text = Intern(log, NULL);
+		event = text;
+	}
+
+	u8 record[MaxRecord];
+	u8* out = record + EventRecordSize;
+
+	if (event->text)
+	{
+		FastFormatAscii ascii;
+		ascii.WriteV(fmt, list);
+		out = PutString(out, ascii.c_str(), MaxText);
+	}
+	else
+	{
+		for (uint i = 0; i < event->argCount; ++i)
+		{
+			switch (event->args[i])
+			{
+				case Arg_Int32:
+				{
+					const u32 value = va_arg(list, u32);
+					memcpy(out, &value, 4);
+					out += 4;
+				}
+				break;
+
+				case Arg_Int64:
+				{
+					const u64 value = va_arg(list, u64);
+					memcpy(out, &value, 8);
+					out += 8;
+				}
+				break;
+
+				case Arg_Double:
+				{
+					const double value = va_arg(list, double);
+					memcpy(out, &value, 8);
+					out += 8;
+				}
+				break;
+
+				case Arg_Pointer:
+				{
+					const u64 value = (uptr)va_arg(list, const void*);
+					memcpy(out, &value, 8);
+					out += 8;
+				}
+				break;
+
+				case Arg_String:
+					out = PutString(out, va_arg(list, const char*), MaxString);
+				break;
+			}
+		}
+	}
+
+	u32 pc = 0, cycle = 0;
+	if (event->cpu == Cpu_EE)
+	{
+		pc = cpuRegs.pc;
+		cycle = cpuRegs.cycle;
+	}
+	else if (event->cpu == Cpu_IOP)
+	{
+		pc = psxRegs.pc;
+		cycle = psxRegs.cycle;
+	}
+
+	const RecordHeader header = { (u16)(out - record), Record_Event, event->cpu };
+	memcpy(record, &header, sizeof(header));
+	memcpy(record + 4, &event->id, 4);
+	memcpy(record + 8, &pc, 4);
+	memcpy(record + 12, &cycle, 4);
+
+	Ring& ring = *state.ring;
+	if (ring.dropped)
+	{
+		u8 dropped[DroppedRecordSize];
+		const RecordHeader droppedHeader = { DroppedRecordSize, Record_Dropped, Cpu_None };
+		memcpy(dropped, &droppedHeader, sizeof(droppedHeader));
+		memcpy(dropped + 4, &ring.dropped, 4);
+
+		if (!Push(ring, dropped, sizeof(dropped)))
+		{
+			++ring.dropped;
+			return;
+		}
+		ring.dropped = 0;
+	}
+
+	if (!Push(ring, record, header.size))
+		++ring.dropped;
+}
+
+}
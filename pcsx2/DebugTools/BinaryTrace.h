@@ -0,0 +1,191 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Pcsx2Types.h"
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstring>
+
+class SysTraceLog;
+
+// --------------------------------------------------------------------------------------
+//  BinaryTrace
+// --------------------------------------------------------------------------------------
+// Binary mode of the SysTrace logs (TraceLog.Binary in the ini).  Instead of formatting
+// each message, the log writes a compact record -- event id, pc, cycle and the raw printf
+// arguments -- into a ring buffer of the calling thread.  A background thread drains the
+// rings to emuLog.trace, next to emuLog.txt.  tools/tracedump formats the file back into
+// the same lines the text log would have written.
+//
+// Events are interned per (log, format string) the first time they are written, and their
+// Record_Define is written to the file ahead of any record that uses them.  Formats that
+// are not string literals (or use conversions that can't be replayed) are formatted at the
+// call and recorded as text.  A full ring drops records; the count is written as a
+// Record_Dropped once there is room again.  Records of different threads are interleaved
+// in chunks of up to a few milliseconds, and are only ordered within a thread.
+//
+// This header is shared with the decoder, so the file layout below must not depend on
+// anything else in the emulator.  All fields are little endian and unaligned.
+//
+namespace BinaryTrace
+{
+	static const u32 FileMagic = 0x43525450;	// 'PTRC'
+	static const u32 FileVersion = 1;
+
+	static const uint MaxArgs = 16;
+	static const uint MaxString = 255;			// longer %s arguments are truncated
+	static const uint MaxText = 2048;			// text records are truncated
+	static const uint MaxRecord = 8192;
+
+	enum RecordType
+	{
+		Record_Event = 0,
+		Record_Define,
+		Record_Dropped,
+	};
+
+	// Register context of an event; also selects the text log's "prefix(pc cycle): ".
+	enum Cpu
+	{
+		Cpu_None = 0,
+		Cpu_EE,
+		Cpu_IOP,
+	};
+
+	enum ArgType
+	{
+		Arg_Int32 = 0,
+		Arg_Int64,
+		Arg_Double,
+		Arg_Pointer,		// stored as 64 bits
+		Arg_String,			// u16 length, then the characters
+		Arg_Text,			// the whole message, formatted at the call (same layout as Arg_String)
+	};
+
+	struct FileHeader
+	{
+		u32 magic;
+		u32 version;
+	};
+
+	// Starts every record.  Size includes the header.
+	struct RecordHeader
+	{
+		u16 size;
+		u8 type;
+		u8 cpu;				// Record_Event and Record_Define
+	};
+
+	// Record_Event: header, then u32 event, u32 pc, u32 cycle, then the arguments.
+	static const uint EventRecordSize = sizeof(RecordHeader) + 12;
+
+	// Record_Define: header, u32 event, u8 argument count, u8 prefix length, u16 format
+	// length, the argument types (one byte each), the prefix, then the format.
+	static const uint DefineRecordSize = sizeof(RecordHeader) + 8;
+
+	// Record_Dropped: header, u32 number of records lost.
+	static const uint DroppedRecordSize = sizeof(RecordHeader) + 4;
+
+	// A printf conversion, as parsed by ParseConversion.
+	struct Conversion
+	{
+		const char* modifiers;	// first length modifier; flags, width and precision come before
+		const char* end;		// past the conversion character
+		char conversion;
+		ArgType type;
+		uint stars;				// '*' widths and precisions, each taking an int first
+	};
+
+	// Parses the conversion that starts just past a '%' (other than "%%").  Returns false for
+	// conversions that can't be recorded: wide characters and strings, long doubles and %n.
+	// Argument sizes are those of the calling compiler.
+	static inline bool ParseConversion(const char* fmt, Conversion& conv)
+	{
+		conv.stars = 0;
+
+		while (*fmt && strchr("-+ #0", *fmt)) ++fmt;
+		if (*fmt == '*') { ++conv.stars; ++fmt; }
+		else while (*fmt >= '0' && *fmt <= '9') ++fmt;
+
+		if (*fmt == '.')
+		{
+			++fmt;
+			if (*fmt == '*') { ++conv.stars; ++fmt; }
+			else while (*fmt >= '0' && *fmt <= '9') ++fmt;
+		}
+
+		conv.modifiers = fmt;
+
+		uint size = sizeof(int);
+		bool wide = false;
+		switch (*fmt)
+		{
+			case 'h': ++fmt; if (*fmt == 'h') ++fmt; break;
+			case 'l':
+				++fmt;
+				if (*fmt == 'l') { ++fmt; size = 8; }
+				else { size = sizeof(long); wide = true; }
+			break;
+			case 'q': case 'j': ++fmt; size = 8; break;
+			case 'z': ++fmt; size = sizeof(size_t); break;
+			case 't': ++fmt; size = sizeof(ptrdiff_t); break;
+			case 'I':
+				++fmt;
+				if (fmt[0] == '6' && fmt[1] == '4') { fmt += 2; size = 8; }
+				else if (fmt[0] == '3' && fmt[1] == '2') fmt += 2;
+				else size = sizeof(size_t);
+			break;
+			case 'L': return false;
+		}
+
+		conv.conversion = *fmt;
+		switch (*fmt)
+		{
+			case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+				conv.type = (size == 8) ? Arg_Int64 : Arg_Int32;
+			break;
+
+			case 'c':
+				if (wide) return false;
+				conv.type = Arg_Int32;
+			break;
+
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				conv.type = Arg_Double;
+			break;
+
+			case 'p': conv.type = Arg_Pointer; break;
+
+			case 's':
+				if (wide) return false;
+				conv.type = Arg_String;
+			break;
+
+			default: return false;
+		}
+
+		conv.end = fmt + 1;
+		return true;
+	}
+
+	// Records a message of the given log.  Called by SysTraceLog::Write in binary mode.
+	extern void Write(const SysTraceLog& log, const char* fmt, va_list list);
+
+	// Stops the writer and flushes what's left in the rings.  No log may be written
+	// concurrently.
+	extern void Close();
+}
@@ -20,6 +20,7 @@
 #include <cstdio>
 #include "../R5900.h"
 #include "../System.h"
+#include "../vtlb.h"
 
 std::vector<BreakPoint> CBreakPoints::breakPoints_;
 u32 CBreakPoints::breakSkipFirstAt_ = 0;
@@ -27,6 +28,27 @@ u64 CBreakPoints::breakSkipFirstTicks_ = 0;
 std::vector<MemCheck> CBreakPoints::memChecks_;
 std::vector<MemCheck *> CBreakPoints::cleanupMemChecks_;
 bool CBreakPoints::breakpointTriggered_ = false;
+bool CBreakPoints::memcheckPages_ = false;
+bool CBreakPoints::memcheckBreakPending_ = false;
+
+static void __fastcall memcheckWatchNotify(u32 vaddr, u32 size, bool write);
+
+// The EE reads the memchecks while it runs (see ExecMemCheck), so they are only changed
+// while it's paused.  Returns true if the caller has to resume it.
+static bool pauseForUpdate()
+{
+	if (r5900Debug.isCpuPaused())
+		return false;
+
+	r5900Debug.pauseCpu();
+	return true;
+}
+
+static void resumeAfterUpdate(bool resume)
+{
+	if (resume)
+		r5900Debug.resumeCpu();
+}
 
 // called from the dynarec
 u32 __fastcall standardizeBreakpointAddress(u32 addr)
@@ -59,6 +81,8 @@ MemCheck::MemCheck() :
 
 void MemCheck::Log(u32 addr, bool write, int size, u32 pc)
 {
+	if (result & MEMCHECK_LOG)
+		DevCon.WriteLn("Hit %s breakpoint @0x%x (%d bytes, block @0x%x)", write ? "store" : "load", addr, size, pc);
 }
 
 void MemCheck::Action(u32 addr, bool write, int size, u32 pc)
@@ -252,7 +276,7 @@ void CBreakPoints::ChangeBreakPointAddCond(u32 addr, const BreakPointCond &cond)
 	{
 		breakPoints_[bp].hasCond = true;
 		breakPoints_[bp].cond = cond;
-		Update();
+		Update(addr);
 	}
 }
 
@@ -262,7 +286,7 @@ void CBreakPoints::ChangeBreakPointRemoveCond(u32 addr)
 	if (bp != INVALID_BREAKPOINT)
 	{
 		breakPoints_[bp].hasCond = false;
-		Update();
+		Update(addr);
 	}
 }
 
@@ -281,6 +305,8 @@ BreakPointCond *CBreakPoints::GetBreakPointCondition(u32 addr)
 
 void CBreakPoints::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCheckResult result)
 {
+	const bool resume = pauseForUpdate();
+
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
@@ -302,10 +328,14 @@ void CBreakPoints::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCh
 		memChecks_[mc].result = (MemCheckResult)(memChecks_[mc].result | result);
 		Update();
 	}
+
+	resumeAfterUpdate(resume);
 }
 
 void CBreakPoints::RemoveMemCheck(u32 start, u32 end)
 {
+	const bool resume = pauseForUpdate();
+
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
@@ -315,10 +345,14 @@ void CBreakPoints::RemoveMemCheck(u32 start, u32 end)
 		memChecks_.erase(memChecks_.begin() + mc);
 		Update();
 	}
+
+	resumeAfterUpdate(resume);
 }
 
 void CBreakPoints::ChangeMemCheck(u32 start, u32 end, MemCheckCondition cond, MemCheckResult result)
 {
+	const bool resume = pauseForUpdate();
+
 	size_t mc = FindMemCheck(start, end);
 	if (mc != INVALID_MEMCHECK)
 	{
@@ -326,10 +360,14 @@ void CBreakPoints::ChangeMemCheck(u32 start, u32 end, MemCheckCondition cond, Me
 		memChecks_[mc].result = result;
 		Update();
 	}
+
+	resumeAfterUpdate(resume);
 }
 
 void CBreakPoints::ClearAllMemChecks()
 {
+	const bool resume = pauseForUpdate();
+
 	// This will ruin any pending memchecks.
 	cleanupMemChecks_.clear();
 
@@ -338,6 +376,83 @@ void CBreakPoints::ClearAllMemChecks()
 		memChecks_.clear();
 		Update();
 	}
+
+	resumeAfterUpdate(resume);
+}
+
+// Length of a memcheck, which covers at least one byte.
+static u32 memcheckSize(const MemCheck& check)
+{
+	return std::max<u32>(check.end - check.start, 1);
+}
+
+void CBreakPoints::ExecMemCheck(u32 addr, bool write, int size, u32 pc)
+{
+	const u32 start = standardizeBreakpointAddress(addr);
+	const u32 end = start + size;
+	const int mask = write ? MEMCHECK_WRITE : MEMCHECK_READ;
+
+	for (size_t i = 0; i < memChecks_.size(); i++)
+	{
+		MemCheck& check = memChecks_[i];
+		if (check.result == MEMCHECK_IGNORE)
+			continue;
+
+		const u32 checkStart = standardizeBreakpointAddress(check.start);
+		if (start >= checkStart + memcheckSize(check) || checkStart >= end)
+			continue;
+
+		check.Action(start, write, size, pc);
+		if ((check.cond & mask) && (check.result & MEMCHECK_BREAK))
+		{
+			memcheckBreakPending_ = true;
+			cpuSetNextEventDelta(0);
+		}
+	}
+}
+
+// Watches the mirrors of a page (given as a standardized address) that the EE can reach
+// without the TLB: kseg0, kseg1 and the uncached user segments.
+static bool watchMemcheckPage(u32 page)
+{
+	static const u32 segments[] = { 0x00000000, 0x20000000, 0x30000000, 0x80000000, 0xA0000000 };
+
+	for (size_t i = 0; i < ArraySize(segments); i++)
+	{
+		const u32 vaddr = page | segments[i];
+		if (standardizeBreakpointAddress(vaddr) == page && !vtlb_WatchPage(vaddr, memcheckWatchNotify))
+			return false;
+	}
+	return true;
+}
+
+void CBreakPoints::UpdateMemcheckPages()
+{
+	vtlb_UnwatchAll();
+	memcheckPages_ = !memChecks_.empty();
+
+	for (size_t i = 0; i < memChecks_.size() && memcheckPages_; i++)
+	{
+		const MemCheck& check = memChecks_[i];
+		if (check.result == MEMCHECK_IGNORE)
+			continue;
+
+		const u32 start = standardizeBreakpointAddress(check.start);
+		const u32 last = (start + memcheckSize(check) - 1) & ~0xfff;
+
+		for (u32 page = start & ~0xfff; memcheckPages_; page += 0x1000)
+		{
+			memcheckPages_ = watchMemcheckPage(page);
+			if (page == last)
+				break;
+		}
+	}
+
+	if (!memcheckPages_ && !memChecks_.empty())
+	{
+		vtlb_UnwatchAll();
+		Console.Warning("(Debugger) The memchecks cover too many pages to watch; checking every load and store instead.");
+	}
 }
 
 void CBreakPoints::SetSkipFirst(u32 pc)
@@ -394,10 +509,16 @@ void CBreakPoints::Update(u32 addr)
 		resume = true;
 	}
 
-//	if (addr != 0)
-//		Cpu->Clear(addr-4,8);
-//	else
+	// A breakpoint only needs the block that contains it recompiled (which is also the one
+	// holding the branch, when it's in a delay slot).  Memcheck pages are baked into the
+	// constant address loads and stores, so those need everything recompiled.
+	if (addr != 0)
+		Cpu->Clear(addr, 1);
+	else
+	{
+		UpdateMemcheckPages();
 		SysClearExecutionCache();
+	}
 
 	if (resume)
 		r5900Debug.resumeCpu();
@@ -405,3 +526,13 @@ void CBreakPoints::Update(u32 addr)
 	if (disassembly_window) // make sure that valid pointer is recieved to prevent potential NULL dereference.
 		disassembly_window->update();
 }
+
+// Accesses to the watched pages.  Only the EE's own loads and stores count: the debugger
+// reads memory from the GUI thread, and the interpreter fetches code through the vtlb.
+static void __fastcall memcheckWatchNotify(u32 vaddr, u32 size, bool write)
+{
+	if (Cpu == &intCpu || !GetCoreThread().IsSelf())
+		return;
+
+	CBreakPoints::ExecMemCheck(vaddr, write, size, cpuRegs.pc);
+}
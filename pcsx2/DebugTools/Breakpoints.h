@@ -108,6 +108,11 @@ struct MemCheck
 // BreakPoints cannot overlap, only one is allowed per address.
 // MemChecks can overlap, as long as their ends are different.
 // WARNING: MemChecks are not used in the interpreter or HLE currently.
+//
+// With the recompiler, the pages under memchecks are watched in the vtlb (see
+// vtlb_WatchPage), so that only accesses to those pages are checked.  Such a memcheck
+// breaks at the end of the block that hit it.  When there are too many pages to watch,
+// every load and store is checked instead, and breaks before the access.
 class CBreakPoints
 {
 public:
@@ -143,6 +148,25 @@ public:
 	static const std::vector<BreakPoint> GetBreakpoints();
 	static size_t GetNumMemchecks() { return memChecks_.size(); }
 
+	// True when the memchecks are handled by watched pages rather than by checking every
+	// load and store.
+	static bool HasMemcheckPages() { return memcheckPages_; }
+
+	// Checks an access made by the EE against the memchecks.
+	static void ExecMemCheck(u32 addr, bool write, int size, u32 pc);
+
+	// Returns (and clears) a break requested by ExecMemCheck.  Checked by the EE at its
+	// next event test.
+	static bool CheckMemcheckBreak()
+	{
+		if (!memcheckBreakPending_)
+			return false;
+		memcheckBreakPending_ = false;
+		return true;
+	}
+
+	// addr - the breakpoint that changed; only the blocks around it are recompiled.
+	//   0 recompiles everything (and is required for memcheck changes).
 	static void Update(u32 addr = 0);
 
 	static void SetBreakpointTriggered(bool b) { breakpointTriggered_ = b; };
@@ -160,6 +184,10 @@ private:
 
 	static std::vector<MemCheck> memChecks_;
 	static std::vector<MemCheck *> cleanupMemChecks_;
+
+	static void UpdateMemcheckPages();
+	static bool memcheckPages_;
+	static bool memcheckBreakPending_;
 };
 
 
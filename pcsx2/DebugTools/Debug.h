@@ -17,6 +17,7 @@
 
 #include "Utilities/TraceLog.h"
 #include "../Memory.h"
+#include "BinaryTrace.h"
 
 extern FILE *emuLog;
 extern wxString emuLogName;
@@ -61,7 +62,8 @@ struct SysTraceLogDescriptor
 // Default trace log for high volume VM/System logging.
 // This log dumps to emuLog.txt directly and has no ability to pipe output
 // to the console (due to the console's inability to handle extremely high
-// logging volume).
+// logging volume).  In binary mode (EmuConfig.Trace.Binary) messages are not
+// formatted, but recorded to emuLog.trace; see BinaryTrace.h.
 class SysTraceLog : public TextFileTraceLog
 {
 public:
@@ -71,11 +73,21 @@ public:
 	SysTraceLog( const SysTraceLogDescriptor* desc )
 		: TextFileTraceLog( &desc->base ) {}
 
+	// Hides TextFileTraceLog::Write, so that binary mode skips the formatting.
+	bool Write( const char* fmt, ... ) const;
+
 	void DoWrite( const char *fmt ) const override;
 	bool IsActive() const override
 	{
 		return EmuConfig.Trace.Enabled && Enabled;
 	}
+
+	const char* GetPrefix() const { return ((SysTraceLogDescriptor*)m_Descriptor)->Prefix; }
+
+	// What ApplyPrefix writes, for binary traces: the registers it shows, and any text
+	// ahead of the message.
+	virtual BinaryTrace::Cpu GetCpu() const { return BinaryTrace::Cpu_None; }
+	virtual const char* GetMessagePrefix() const { return ""; }
 };
 
 class SysTraceLog_EE : public SysTraceLog
@@ -86,6 +98,7 @@ public:
 	SysTraceLog_EE( const SysTraceLogDescriptor* desc ) : _parent( desc ) {}
 
 	void ApplyPrefix( FastFormatAscii& ascii ) const override;
+	BinaryTrace::Cpu GetCpu() const override { return BinaryTrace::Cpu_EE; }
 	bool IsActive() const override
 	{
 		return SysTraceLog::IsActive() && EmuConfig.Trace.EE.m_EnableAll;
@@ -102,6 +115,7 @@ public:
 	SysTraceLog_VIFcode( const SysTraceLogDescriptor* desc ) : _parent( desc ) {}
 
 	void ApplyPrefix( FastFormatAscii& ascii ) const override;
+	const char* GetMessagePrefix() const override { return "vifCode_"; }
 };
 
 class SysTraceLog_EE_Disasm : public SysTraceLog_EE
@@ -158,6 +172,7 @@ public:
 	SysTraceLog_IOP( const SysTraceLogDescriptor* desc ) : _parent( desc ) {}
 
 	void ApplyPrefix( FastFormatAscii& ascii ) const override;
+	BinaryTrace::Cpu GetCpu() const override { return BinaryTrace::Cpu_IOP; }
 	bool IsActive() const override
 	{
 		return SysTraceLog::IsActive() && EmuConfig.Trace.IOP.m_EnableAll;
@@ -342,7 +357,9 @@ extern void __Log( const char* fmt, ... );
 // against Trace.Enabled, to avoid extra overhead in Debug builds when logging is disabled.
 // (specifically this allows debug builds to skip havingto resolve all the parameters being
 //  passed into the function)
-#ifdef PCSX2_DEVBUILD
+// Release builds compile the trace logs out, unless PCSX2_TRACE is defined (the ENABLE_TRACE
+// build option), for binary traces in the field.
+#if defined(PCSX2_DEVBUILD) || defined(PCSX2_TRACE)
 #	define SysTraceActive(trace)	SysTrace.trace.IsActive()
 #else
 #	define SysTraceActive(trace)	(false)
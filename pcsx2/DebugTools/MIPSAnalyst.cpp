@@ -22,7 +22,8 @@
 #include "../R5900.h"
 #include "../R5900OpcodeTables.h"
 
-static std::vector<MIPSAnalyst::AnalyzedFunction> functions;
+#include <atomic>
+#include <thread>
 
 #define MIPS_MAKE_J(addr)   (0x08000000 | ((addr)>>2))
 #define MIPS_MAKE_JAL(addr) (0x0C000000 | ((addr)>>2))
@@ -196,7 +197,54 @@ namespace MIPSAnalyst
 		return furthestJumpbackAddr;
 	}
 
-	void ScanForFunctions(u32 startAddr, u32 endAddr, bool insertSymbols) {
+	// Scans are split into pages, hashed so that a rescan of the same range (a reboot of the
+	// same game) only reanalyzes the functions of the pages that changed.
+	static const u32 SCAN_PAGE_SIZE = 0x1000;
+
+	struct ScanCache {
+		u32 start;
+		u32 end;
+		std::vector<u64> pageHashes;
+		std::vector<AnalyzedFunction> functions;
+	};
+
+	static ScanCache scanCache;
+
+	static std::thread scanThread;
+	static std::atomic<bool> scanCancel(false);
+	static std::atomic<int> scanProgress(-1);
+	static u32 scanProgressStart, scanProgressSize;
+	static ScanNotifyFP* scanNotify;
+
+	static u64 HashScanPage(u32 page) {
+		// FNV-1a over the words of the page.
+		u64 hash = 0xcbf29ce484222325ULL;
+		for (u32 addr = page; addr < page + SCAN_PAGE_SIZE; addr += 4) {
+			hash ^= r5900Debug.read32(addr);
+			hash *= 0x100000001b3ULL;
+		}
+		return hash;
+	}
+
+	// Called at each page of the scan; false if it was cancelled.
+	static bool ScanCheckpoint(u32 addr) {
+		if (scanCancel.load(std::memory_order_relaxed))
+			return false;
+
+		if (scanNotify == NULL || scanProgressSize == 0)
+			return true;
+
+		int percent = (int)((u64)(addr - scanProgressStart) * 100 / scanProgressSize);
+		percent = std::min(std::max(percent, 0), 99);
+		if (percent / 10 != scanProgress.load(std::memory_order_relaxed) / 10) {
+			scanProgress.store(percent, std::memory_order_relaxed);
+			scanNotify(false);
+		}
+		return true;
+	}
+
+	// Appends the functions found in [startAddr, endAddr]; false if cancelled.
+	static bool ScanRange(u32 startAddr, u32 endAddr, std::vector<AnalyzedFunction>& functions) {
 		AnalyzedFunction currentFunction = {startAddr};
 
 		u32 furthestBranch = 0;
@@ -204,10 +252,11 @@ namespace MIPSAnalyst
 		bool end = false;
 		bool isStraightLeaf = true;
 
-		functions.clear();
-
 		u32 addr;
 		for (addr = startAddr; addr <= endAddr; addr += 4) {
+			if ((addr % SCAN_PAGE_SIZE) == 0 && !ScanCheckpoint(addr))
+				return false;
+
 			// Use pre-existing symbol map info if available. May be more reliable.
 			SymbolInfo syminfo;
 			if (symbolMap.GetSymbolInfo(&syminfo, addr, ST_FUNCTION)) {
@@ -312,6 +361,87 @@ namespace MIPSAnalyst
 
 		currentFunction.end = addr + 4;
 		functions.push_back(currentFunction);
+		return true;
+	}
+
+	// A cached function can be kept if none of its pages changed, and it still agrees with
+	// any function the symbol map already has there.
+	static bool CanKeepFunction(const AnalyzedFunction& func, u32 startAddr, const std::vector<bool>& dirty) {
+		u32 first = (func.start - startAddr) / SCAN_PAGE_SIZE;
+		u32 last = (func.end - startAddr) / SCAN_PAGE_SIZE;
+		if (func.end < func.start || last >= dirty.size())
+			return false;
+		for (u32 page = first; page <= last; page++) {
+			if (dirty[page])
+				return false;
+		}
+
+		SymbolInfo syminfo;
+		if (symbolMap.GetSymbolInfo(&syminfo, func.start, ST_FUNCTION))
+			return syminfo.address == func.start && syminfo.size == func.end - func.start + 4;
+		return true;
+	}
+
+	// Rescans the gap [startAddr, endAddr] between kept functions.  The scan doesn't stop at
+	// the end of the gap, so whatever it finds is clipped to it.
+	static bool ScanGap(u32 startAddr, u32 endAddr, std::vector<AnalyzedFunction>& functions) {
+		std::vector<AnalyzedFunction> found;
+		if (!ScanRange(startAddr, endAddr, found))
+			return false;
+
+		for (auto iter = found.begin(); iter != found.end(); iter++) {
+			if (iter->start > endAddr)
+				break;
+			if (iter->end > endAddr)
+				iter->end = endAddr;
+			functions.push_back(*iter);
+		}
+		return true;
+	}
+
+	static bool ScanWithCache(u32 startAddr, u32 endAddr, std::vector<AnalyzedFunction>& functions) {
+		u32 pageCount = (endAddr - startAddr) / SCAN_PAGE_SIZE + 1;
+		std::vector<u64> hashes(pageCount);
+		for (u32 page = 0; page < pageCount; page++)
+			hashes[page] = HashScanPage(startAddr + page * SCAN_PAGE_SIZE);
+
+		if (scanCache.start != startAddr || scanCache.end != endAddr || scanCache.pageHashes.size() != pageCount) {
+			if (!ScanRange(startAddr, endAddr, functions))
+				return false;
+		} else {
+			std::vector<bool> dirty(pageCount);
+			for (u32 page = 0; page < pageCount; page++)
+				dirty[page] = hashes[page] != scanCache.pageHashes[page];
+
+			u32 gapStart = startAddr;
+			for (auto iter = scanCache.functions.begin(); iter != scanCache.functions.end(); iter++) {
+				if (iter->start < gapStart || !CanKeepFunction(*iter, startAddr, dirty))
+					continue;
+
+				if (iter->start > gapStart && !ScanGap(gapStart, iter->start - 4, functions))
+					return false;
+				if (!ScanCheckpoint(iter->start))
+					return false;
+
+				functions.push_back(*iter);
+				gapStart = iter->end + 4;
+			}
+
+			if (gapStart <= endAddr && !ScanRange(gapStart, endAddr, functions))
+				return false;
+		}
+
+		scanCache.start = startAddr;
+		scanCache.end = endAddr;
+		scanCache.pageHashes.swap(hashes);
+		scanCache.functions = functions;
+		return true;
+	}
+
+	static bool ScanFunctionsInternal(u32 startAddr, u32 endAddr, bool insertSymbols) {
+		std::vector<AnalyzedFunction> functions;
+		if (endAddr < startAddr || !ScanWithCache(startAddr, endAddr, functions))
+			return false;
 
 		for (auto iter = functions.begin(); iter != functions.end(); iter++) {
 			iter->size = iter->end - iter->start + 4;
@@ -320,6 +450,49 @@ namespace MIPSAnalyst
 				symbolMap.AddFunction(DefaultFunctionName(temp, iter->start), iter->start, iter->end - iter->start + 4);
 			}
 		}
+		return true;
+	}
+
+	void ScanForFunctions(u32 startAddr, u32 endAddr, bool insertSymbols) {
+		CancelScan();
+		scanNotify = NULL;
+		ScanFunctionsInternal(startAddr, endAddr, insertSymbols);
+	}
+
+	void ScanForFunctionsInBackground(u32 startAddr, u32 endAddr, ScanNotifyFP* notify) {
+		CancelScan();
+
+		scanProgressStart = startAddr;
+		scanProgressSize = endAddr - startAddr;
+		scanNotify = notify;
+		scanProgress.store(0, std::memory_order_relaxed);
+
+		scanThread = std::thread([startAddr, endAddr]() {
+			u64 start = GetCPUTicks();
+			bool done = ScanFunctionsInternal(startAddr, endAddr, true);
+			if (done)
+				symbolMap.UpdateActiveSymbols();
+
+			scanProgress.store(-1, std::memory_order_relaxed);
+			if (done) {
+				DevCon.WriteLn("(MIPSAnalyst) Function scan took %u ms.", (u32)((GetCPUTicks() - start) * 1000 / GetTickFrequency()));
+				if (scanNotify)
+					scanNotify(true);
+			}
+		});
+	}
+
+	void CancelScan() {
+		if (!scanThread.joinable())
+			return;
+
+		scanCancel.store(true, std::memory_order_relaxed);
+		scanThread.join();
+		scanCancel.store(false, std::memory_order_relaxed);
+	}
+
+	int GetScanProgress() {
+		return scanProgress.load(std::memory_order_relaxed);
 	}
 
 	MipsOpcodeInfo GetOpcodeInfo(DebugInterface* cpu, u32 address) {
@@ -501,4 +674,72 @@ namespace MIPSAnalyst
 
 		return info;
 	}
+
+	bool IsIdleLoop(u32 start, u32 end, u32 (*fetch)(u32 addr))
+	{
+		// loads: registers whose value in this iteration only depends on loads or other
+		// such registers.  reads: registers whose value from the previous iteration is
+		// used.  A register in both sets carries state from one iteration to the next.
+		u32 reads = 0, loads = 1;
+
+		for (u32 pc = start; pc < end; pc += 4)
+		{
+			// the branch itself; only reads registers
+			if (pc == end - 8)
+				continue;
+
+			const u32 op = fetch(pc);
+			const u32 opcode = MIPS_GET_OP(op);
+			const u32 funct = MIPS_GET_FUNC(op);
+			const u32 rs = MIPS_GET_RS(op);
+			const u32 rt = MIPS_GET_RT(op);
+			u32 src, dst;
+
+			// nop
+			if (op == 0)
+				continue;
+			// cache, sync
+			else if (opcode == 057 || (opcode == 0 && funct == 017))
+				continue;
+			// imm arithmetic, loads
+			else if ((opcode & 070) == 010 || (opcode & 076) == 030
+				|| (opcode & 070) == 040 || (opcode & 076) == 032 || opcode == 067)
+			{
+				src = 1 << rs;
+				dst = 1 << rt;
+			}
+			// common register arithmetic instructions
+			else if (opcode == 0 && (funct & 060) == 040 && (funct & 076) != 050)
+			{
+				src = 1 << rs | 1 << rt;
+				dst = 1 << MIPS_GET_RD(op);
+			}
+			// shifts by immediate
+			else if (opcode == 0 && (funct == 000 || funct == 002 || funct == 003))
+			{
+				src = 1 << rt;
+				dst = 1 << MIPS_GET_RD(op);
+			}
+			// mfc*, cfc*
+			else if ((opcode & 074) == 020 && rs < 4)
+			{
+				loads |= 1 << rt;
+				continue;
+			}
+			else
+				return false;
+
+			if ((loads & src) == src)
+			{
+				loads |= dst;
+				continue;
+			}
+
+			reads |= src;
+			if (reads & dst)
+				return false;
+		}
+
+		return true;
+	}
 }
@@ -41,6 +41,21 @@ namespace MIPSAnalyst
 
 	void ScanForFunctions(u32 startAddr, u32 endAddr, bool insertSymbols);
 
+	// Called from the scan thread: with done = false each time the progress moves by 10%,
+	// and with done = true once the functions are in the symbol map.
+	typedef void ScanNotifyFP(bool done);
+
+	// Scans for functions in another thread, inserting them into the symbol map.  A scan
+	// (of either kind) cancels any background scan still running.
+	void ScanForFunctionsInBackground(u32 startAddr, u32 endAddr, ScanNotifyFP* notify);
+
+	// Stops the background scan, if any, and waits for it.  Must be called before the
+	// symbol map is cleared or guest memory goes away.
+	void CancelScan();
+
+	// Percentage done of the background scan, or -1 if none is running.
+	int GetScanProgress();
+
 	enum LoadStoreLRType { LOADSTORE_NORMAL, LOADSTORE_LEFT, LOADSTORE_RIGHT };
 
 	typedef struct {
@@ -72,4 +87,12 @@ namespace MIPSAnalyst
 	} MipsOpcodeInfo;
 	
 	MipsOpcodeInfo GetOpcodeInfo(DebugInterface* cpu, u32 address);
+
+	// Checks whether the loop [start, end), whose backwards branch and delay slot are the
+	// last two instructions, only polls: it writes no memory, and every register it
+	// modifies is recomputed from loads (or constants) each iteration, so that running
+	// it again can't change anything until some other part of the system does.  Such
+	// loops can skip straight to the next scheduled event.  Used by both the EE and IOP
+	// recompilers; fetch reads an opcode from guest memory.
+	bool IsIdleLoop(u32 start, u32 end, u32 (*fetch)(u32 addr));
 };
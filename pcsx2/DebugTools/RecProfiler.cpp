@@ -0,0 +1,402 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "RecProfiler.h"
+#include "SymbolMap.h"
+#include "R5900.h"
+#include "AppConfig.h"
+#include "Utilities/AsciiFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+
+namespace RecProfiler
+{
+
+static const char* const SourceNames[Source_Count] = { "EE", "IOP", "VU0", "VU1" };
+
+// Sampling rate, in nanoseconds of core thread cpu time.
+static const long SampleInterval = 1000 * 1000;
+
+// Ring buffer filled by the signal handler and drained once per vsync.  Must be a power
+// of two; 16k samples is about 16 seconds worth of headroom.
+static const u32 SampleBufferSize = 0x4000;
+
+struct BlockInfo
+{
+	u32 x86size;
+	u32 pc;
+};
+
+struct Sample
+{
+	uptr ip;
+	u32 eepc;
+};
+
+static Sample s_samples[SampleBufferSize];
+static std::atomic<u32> s_sampleWrite(0);
+static std::atomic<u32> s_sampleRead(0);
+static std::atomic<u32> s_samplesDropped(0);
+
+// Everything below is protected by s_lock (the signal handler only touches the ring).
+static std::mutex s_lock;
+static std::map<uptr, BlockInfo> s_blocks[Source_Count];
+static std::unordered_map<u32, u64> s_blockHits[Source_Count];
+static std::unordered_map<u32, u64> s_nativeHits;		// samples outside of rec code, by EE pc
+static u64 s_totalSamples = 0;
+
+// Written by whichever thread runs the recompiler (MTVU for VU1), read by anyone.
+static std::atomic<u32> s_statBlocks[Source_Count];
+static std::atomic<u32> s_statBytes[Source_Count];
+static std::atomic<u32> s_statResets[Source_Count];
+
+bool IsEnabled(Source src)
+{
+	const Pcsx2Config::ProfilerOptions& opts = EmuConfig.Profiler;
+
+	if (!opts.Enabled) return false;
+
+	switch (src)
+	{
+		case Source_EE:		return opts.RecBlocks_EE;
+		case Source_IOP:	return opts.RecBlocks_IOP;
+		case Source_VU0:	return opts.RecBlocks_VU0;
+		case Source_VU1:	return opts.RecBlocks_VU1;
+
+		jNO_DEFAULT
+	}
+
+	return false;
+}
+
+static void Attribute(const Sample& sample)
+{
+	++s_totalSamples;
+
+	for (int src = 0; src < Source_Count; ++src)
+	{
+		const std::map<uptr, BlockInfo>& blocks = s_blocks[src];
+		std::map<uptr, BlockInfo>::const_iterator it = blocks.upper_bound(sample.ip);
+		if (it == blocks.begin()) continue;
+
+		--it;
+		if (sample.ip - it->first < it->second.x86size)
+		{
+			++s_blockHits[src][it->second.pc];
+			return;
+		}
+	}
+
+	++s_nativeHits[sample.eepc];
+}
+
+// Caller must hold s_lock.
+static void Drain()
+{
+	u32 read = s_sampleRead.load(std::memory_order_relaxed);
+	const u32 write = s_sampleWrite.load(std::memory_order_acquire);
+
+	for (; read != write; ++read)
+		Attribute(s_samples[read & (SampleBufferSize - 1)]);
+
+	s_sampleRead.store(read, std::memory_order_release);
+}
+
+void MapBlock(Source src, uptr x86, u32 x86size, u32 pc)
+{
+	s_statBlocks[src].fetch_add(1, std::memory_order_relaxed);
+	s_statBytes[src].fetch_add(x86size, std::memory_order_relaxed);
+
+	if (!IsEnabled(src) || x86size == 0) return;
+
+	std::lock_guard<std::mutex> guard(s_lock);
+	BlockInfo& info = s_blocks[src][x86];
+	info.x86size = x86size;
+	info.pc = pc;
+}
+
+void ResetBlocks(Source src)
+{
+	s_statResets[src].fetch_add(1, std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> guard(s_lock);
+
+	// Attribute what we have while the old block layout is still known.
+	Drain();
+	s_blocks[src].clear();
+}
+
+void UnmapRange(Source src, uptr begin, uptr end)
+{
+	std::lock_guard<std::mutex> guard(s_lock);
+
+	Drain();
+	s_blocks[src].erase(s_blocks[src].lower_bound(begin), s_blocks[src].lower_bound(end));
+}
+
+void Update()
+{
+	if (!EmuConfig.Profiler.Enabled) return;
+
+	std::lock_guard<std::mutex> guard(s_lock);
+	Drain();
+}
+
+void Clear()
+{
+	std::lock_guard<std::mutex> guard(s_lock);
+
+	s_sampleRead.store(s_sampleWrite.load(std::memory_order_acquire), std::memory_order_release);
+	s_samplesDropped = 0;
+
+	for (int src = 0; src < Source_Count; ++src)
+		s_blockHits[src].clear();
+	s_nativeHits.clear();
+	s_totalSamples = 0;
+}
+
+RecStats GetStats(Source src)
+{
+	RecStats stats;
+	stats.blocks = s_statBlocks[src].load(std::memory_order_relaxed);
+	stats.x86bytes = s_statBytes[src].load(std::memory_order_relaxed);
+	stats.resets = s_statResets[src].load(std::memory_order_relaxed);
+	return stats;
+}
+
+// --------------------------------------------------------------------------------------
+//  Sampling
+// --------------------------------------------------------------------------------------
+#ifdef __linux__
+
+static timer_t s_timer;
+static bool s_timerActive = false;
+
+static void SampleHandler(int signal, siginfo_t* info, void* context)
+{
+	const u32 write = s_sampleWrite.load(std::memory_order_relaxed);
+
+	if (write - s_sampleRead.load(std::memory_order_acquire) >= SampleBufferSize)
+	{
+		s_samplesDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	const ucontext_t* uc = (const ucontext_t*)context;
+	Sample& sample = s_samples[write & (SampleBufferSize - 1)];
+#ifdef __x86_64__
+	sample.ip = (uptr)uc->uc_mcontext.gregs[REG_RIP];
+#else
+	sample.ip = (uptr)uc->uc_mcontext.gregs[REG_EIP];
+#endif
+	sample.eepc = cpuRegs.pc;
+
+	s_sampleWrite.store(write + 1, std::memory_order_release);
+}
+
+void Start()
+{
+	if (!EmuConfig.Profiler.Enabled)
+	{
+		Stop();
+		return;
+	}
+
+	if (s_timerActive) return;
+
+	// The handler is left installed after Stop(), since a SIGPROF can still be in flight
+	// when the timer is deleted (and the default action would kill the process).
+	struct sigaction sa;
+	memzero(sa);
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sa.sa_sigaction = SampleHandler;
+	sigaction(SIGPROF, &sa, NULL);
+
+	// Profile cpu time of this thread only, so that an idle or throttled core thread
+	// doesn't skew the results towards whatever happens to be running when it wakes up.
+	clockid_t clock;
+	if (pthread_getcpuclockid(pthread_self(), &clock) != 0)
+	{
+		Console.Error("(RecProfiler) Could not get the core thread cpu clock; profiling disabled.");
+		return;
+	}
+
+	struct sigevent sev;
+	memzero(sev);
+	sev.sigev_notify = SIGEV_THREAD_ID;
+	sev.sigev_signo = SIGPROF;
+	sev.sigev_notify_thread_id = syscall(SYS_gettid);
+
+	if (timer_create(clock, &sev, &s_timer) != 0)
+	{
+		Console.Error("(RecProfiler) timer_create failed (errno=%d); profiling disabled.", errno);
+		return;
+	}
+
+	struct itimerspec its;
+	its.it_interval.tv_sec = 0;
+	its.it_interval.tv_nsec = SampleInterval;
+	its.it_value = its.it_interval;
+	timer_settime(s_timer, 0, &its, NULL);
+
+	s_timerActive = true;
+	DevCon.WriteLn("(RecProfiler) Sampling started.");
+}
+
+void Stop()
+{
+	if (!s_timerActive) return;
+
+	timer_delete(s_timer);
+	s_timerActive = false;
+	DevCon.WriteLn("(RecProfiler) Sampling stopped.");
+}
+
+#else
+
+void Start()
+{
+	if (EmuConfig.Profiler.Enabled)
+		Console.Warning("(RecProfiler) Sampling is not supported on this platform.");
+}
+
+void Stop()
+{
+}
+
+#endif
+
+// --------------------------------------------------------------------------------------
+//  Reports
+// --------------------------------------------------------------------------------------
+
+// Folded stacks use ';' as the frame separator and ' ' before the count.
+static std::string SanitizeFrame(std::string name)
+{
+	std::replace(name.begin(), name.end(), ';', '_');
+	std::replace(name.begin(), name.end(), ' ', '_');
+	return name;
+}
+
+static std::string GetFunctionName(u32 pc)
+{
+	char buf[32];
+
+	const u32 start = symbolMap.GetFunctionStart(pc);
+	if (start == SymbolMap::INVALID_ADDRESS)
+		return "[unknown]";
+
+	std::string label = symbolMap.GetLabelString(start);
+	if (!label.empty())
+		return SanitizeFrame(label);
+
+	snprintf(buf, sizeof(buf), "sub_%08x", start);
+	return buf;
+}
+
+struct ReportEntry
+{
+	int src;
+	u32 pc;
+	u64 hits;
+
+	bool operator<(const ReportEntry& right) const { return hits > right.hits; }
+};
+
+void WriteReport()
+{
+	std::lock_guard<std::mutex> guard(s_lock);
+
+	Drain();
+	if (s_totalSamples == 0) return;
+
+	std::vector<ReportEntry> entries;
+	std::map<std::string, u64> stacks;
+	u64 nativeTotal = 0;
+	char buf[32];
+
+	for (int src = 0; src < Source_Count; ++src)
+	{
+		for (auto& hit : s_blockHits[src])
+		{
+			ReportEntry entry = { src, hit.first, hit.second };
+			entries.push_back(entry);
+
+			snprintf(buf, sizeof(buf), "0x%08x", hit.first);
+			std::string stack(SourceNames[src]);
+			if (src == Source_EE)
+				stack += ";" + GetFunctionName(hit.first);
+			stacks[stack + ";" + buf] += hit.second;
+		}
+	}
+
+	for (auto& hit : s_nativeHits)
+	{
+		stacks["EE;" + GetFunctionName(hit.first) + ";[native]"] += hit.second;
+		nativeTotal += hit.second;
+	}
+
+	std::sort(entries.begin(), entries.end());
+
+	g_Conf->Folders.Logs.Mkdir();
+
+	AsciiFile folded(Path::Combine(g_Conf->Folders.Logs, L"recprofile.folded"), L"w");
+	for (auto& stack : stacks)
+		folded.Printf("%s %llu\n", stack.first.c_str(), (unsigned long long)stack.second);
+
+	AsciiFile table(Path::Combine(g_Conf->Folders.Logs, L"recprofile.txt"), L"w");
+	table.Printf("%llu samples (%u dropped), %.1f%% outside of recompiled code\n\n",
+		(unsigned long long)s_totalSamples, s_samplesDropped.load(), nativeTotal * 100.0 / s_totalSamples);
+	table.Printf("   # Source  Block PC      Samples       %%  Function\n");
+
+	Console.WriteLn(Color_StrongBlue, "(RecProfiler) %llu samples, hottest blocks:", (unsigned long long)s_totalSamples);
+
+	const size_t count = std::min<size_t>(entries.size(), 100);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const ReportEntry& entry = entries[i];
+		const double percent = entry.hits * 100.0 / s_totalSamples;
+		const std::string func = (entry.src == Source_EE) ? GetFunctionName(entry.pc) : "";
+
+		table.Printf("%4u %-6s  0x%08x %9llu  %5.2f%%  %s\n", (uint)i + 1, SourceNames[entry.src],
+			entry.pc, (unsigned long long)entry.hits, percent, func.c_str());
+
+		if (i < 10)
+			Console.Indent().WriteLn("%-4s 0x%08x %5.2f%% %s", SourceNames[entry.src], entry.pc, percent, func.c_str());
+	}
+
+	Console.WriteLn(L"(RecProfiler) Profile written to %s", WX_STR(Path::Combine(g_Conf->Folders.Logs, L"recprofile.txt")));
+}
+
+}
@@ -0,0 +1,79 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Pcsx2Types.h"
+
+// --------------------------------------------------------------------------------------
+//  RecProfiler
+// --------------------------------------------------------------------------------------
+// Sampling profiler for recompiled code.  The core thread is interrupted at a fixed rate
+// (of its own cpu time) and the interrupted host address is attributed to the guest block
+// that was compiled there.  Blocks are registered by the recompilers as they are emitted.
+//
+// Results are accumulated until the next Clear(), and written to the logs folder as
+// folded stacks (recprofile.folded, usable with flamegraph.pl) and as a top-N block table
+// (recprofile.txt).  EE blocks are grouped by the function they belong to in symbolMap.
+//
+// Controlled by the [Profiler] section of the emulator settings.  Sampling is currently
+// only implemented on Linux; on other platforms blocks are tracked but no samples are taken.
+//
+// Block and reset counts (GetStats) are kept at all times, profiler enabled or not.
+//
+namespace RecProfiler
+{
+	enum Source
+	{
+		Source_EE = 0,
+		Source_IOP,
+		Source_VU0,
+		Source_VU1,
+		Source_Count
+	};
+
+	// Running totals since startup.  The counters wrap, so users should only look at the
+	// difference between two readings.
+	struct RecStats
+	{
+		u32 blocks;			// blocks compiled
+		u32 x86bytes;		// host code emitted for them
+		u32 resets;			// code cache resets
+	};
+
+	// True when the profiler is enabled for the given recompiler.
+	extern bool IsEnabled(Source src);
+
+	// Registers a freshly compiled block.  Safe to call from any thread.
+	extern void MapBlock(Source src, uptr x86, u32 x86size, u32 pc);
+
+	// Must be called before a recompiler discards its code cache.
+	extern void ResetBlocks(Source src);
+
+	// Same as above, for a recompiler that reuses part of its cache in [begin, end).
+	extern void UnmapRange(Source src, uptr begin, uptr end);
+
+	// Begins/ends sampling of the calling thread (the core thread).
+	extern void Start();
+	extern void Stop();
+
+	// Attributes pending samples; called once per vsync from the core thread.
+	extern void Update();
+
+	extern void WriteReport();
+	extern void Clear();
+
+	// Safe to call from any thread.
+	extern RecStats GetStats(Source src);
+}
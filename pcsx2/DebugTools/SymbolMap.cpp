@@ -104,9 +104,9 @@ bool SymbolMap::LoadNocashSym(const char *filename) {
 
 SymbolType SymbolMap::GetSymbolType(u32 address) const {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
-	if (activeFunctions.find(address) != activeFunctions.end())
+	if (activeFunctions.find(address) != NULL)
 		return ST_FUNCTION;
-	if (activeData.find(address) != activeData.end())
+	if (activeData.find(address) != NULL)
 		return ST_DATA;
 	return ST_NONE;
 }
@@ -157,14 +157,14 @@ bool SymbolMap::GetSymbolInfo(SymbolInfo *info, u32 address, SymbolType symmask)
 
 u32 SymbolMap::GetNextSymbolAddress(u32 address, SymbolType symmask) {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
-	const auto functionEntry = symmask & ST_FUNCTION ? activeFunctions.upper_bound(address) : activeFunctions.end();
-	const auto dataEntry = symmask & ST_DATA ? activeData.upper_bound(address) : activeData.end();
+	const auto functionEntry = symmask & ST_FUNCTION ? activeFunctions.next(address) : NULL;
+	const auto dataEntry = symmask & ST_DATA ? activeData.next(address) : NULL;
 
-	if (functionEntry == activeFunctions.end() && dataEntry == activeData.end())
+	if (functionEntry == NULL && dataEntry == NULL)
 		return INVALID_ADDRESS;
 
-	u32 funcAddress = (functionEntry != activeFunctions.end()) ? functionEntry->first : 0xFFFFFFFF;
-	u32 dataAddress = (dataEntry != activeData.end()) ? dataEntry->first : 0xFFFFFFFF;
+	u32 funcAddress = (functionEntry != NULL) ? functionEntry->first : 0xFFFFFFFF;
+	u32 dataAddress = (dataEntry != NULL) ? dataEntry->first : 0xFFFFFFFF;
 
 	if (funcAddress <= dataAddress)
 		return funcAddress;
@@ -347,10 +347,8 @@ void SymbolMap::AddFunction(const char* name, u32 address, u32 size, int moduleI
 
 		// Refresh the active item if it exists.
 		auto active = activeFunctions.find(address);
-		if (active != activeFunctions.end() && active->second.module == moduleIndex) {
-			activeFunctions.erase(active);
-			activeFunctions.insert(std::make_pair(address, existing->second));
-		}
+		if (active != NULL && active->module == moduleIndex)
+			activeFunctions.replace(address, existing->second);
 	} else {
 		FunctionEntry func;
 		func.start = relAddress;
@@ -360,7 +358,7 @@ void SymbolMap::AddFunction(const char* name, u32 address, u32 size, int moduleI
 		functions[symbolKey] = func;
 
 		if (IsModuleActive(moduleIndex)) {
-			activeFunctions.insert(std::make_pair(address, func));
+			activeFunctions.insert(address, func);
 		}
 	}
 
@@ -369,38 +367,25 @@ void SymbolMap::AddFunction(const char* name, u32 address, u32 size, int moduleI
 
 u32 SymbolMap::GetFunctionStart(u32 address) const {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
-	auto it = activeFunctions.upper_bound(address);
-	if (it == activeFunctions.end()) {
-		// check last element
-		auto rit = activeFunctions.rbegin();
-		if (rit != activeFunctions.rend()) {
-			u32 start = rit->first;
-			u32 size = rit->second.size;
-			if (start <= address && start+size > address)
-				return start;
-		}
-		// otherwise there's no function that contains this address
-		return INVALID_ADDRESS;
-	}
-
-	if (it != activeFunctions.begin()) {
-		it--;
+	auto it = activeFunctions.floor(address);
+	if (it != NULL) {
 		u32 start = it->first;
 		u32 size = it->second.size;
-		if (start <= address && start+size > address)
+		if (start+size > address)
 			return start;
 	}
 
+	// otherwise there's no function that contains this address
 	return INVALID_ADDRESS;
 }
 
 u32 SymbolMap::GetFunctionSize(u32 startAddress) const {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 	auto it = activeFunctions.find(startAddress);
-	if (it == activeFunctions.end())
+	if (it == NULL)
 		return INVALID_ADDRESS;
 
-	return it->second.size;
+	return it->size;
 }
 
 int SymbolMap::GetFunctionNum(u32 address) const {
@@ -410,10 +395,10 @@ int SymbolMap::GetFunctionNum(u32 address) const {
 		return INVALID_ADDRESS;
 
 	auto it = activeFunctions.find(start);
-	if (it == activeFunctions.end())
+	if (it == NULL)
 		return INVALID_ADDRESS;
 
-	return it->second.index;
+	return it->index;
 }
 
 void SymbolMap::AssignFunctionIndices() {
@@ -444,27 +429,27 @@ void SymbolMap::UpdateActiveSymbols() {
 	for (auto it = functions.begin(), end = functions.end(); it != end; ++it) {
 		const auto mod = activeModuleIndexes.find(it->second.module);
 		if (it->second.module <= 0) {
-			activeFunctions.insert(std::make_pair(it->second.start, it->second));
+			activeFunctions.insert(it->second.start, it->second);
 		} else if (mod != activeModuleIndexes.end()) {
-			activeFunctions.insert(std::make_pair(mod->second + it->second.start, it->second));
+			activeFunctions.insert(mod->second + it->second.start, it->second);
 		}
 	}
 
 	for (auto it = labels.begin(), end = labels.end(); it != end; ++it) {
 		const auto mod = activeModuleIndexes.find(it->second.module);
 		if (it->second.module <= 0) {
-			activeLabels.insert(std::make_pair(it->second.addr, it->second));
+			activeLabels.insert(it->second.addr, it->second);
 		} else if (mod != activeModuleIndexes.end()) {
-			activeLabels.insert(std::make_pair(mod->second + it->second.addr, it->second));
+			activeLabels.insert(mod->second + it->second.addr, it->second);
 		}
 	}
 
 	for (auto it = data.begin(), end = data.end(); it != end; ++it) {
 		const auto mod = activeModuleIndexes.find(it->second.module);
 		if (it->second.module <= 0) {
-			activeData.insert(std::make_pair(it->second.start, it->second));
+			activeData.insert(it->second.start, it->second);
 		} else if (mod != activeModuleIndexes.end()) {
-			activeData.insert(std::make_pair(mod->second + it->second.start, it->second));
+			activeData.insert(mod->second + it->second.start, it->second);
 		}
 	}
 
@@ -475,8 +460,8 @@ bool SymbolMap::SetFunctionSize(u32 startAddress, u32 newSize) {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 
 	auto funcInfo = activeFunctions.find(startAddress);
-	if (funcInfo != activeFunctions.end()) {
-		auto symbolKey = std::make_pair(funcInfo->second.module, funcInfo->second.start);
+	if (funcInfo != NULL) {
+		auto symbolKey = std::make_pair(funcInfo->module, funcInfo->start);
 		auto func = functions.find(symbolKey);
 		if (func != functions.end()) {
 			func->second.size = newSize;
@@ -492,25 +477,25 @@ bool SymbolMap::RemoveFunction(u32 startAddress, bool removeName) {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 
 	auto it = activeFunctions.find(startAddress);
-	if (it == activeFunctions.end())
+	if (it == NULL)
 		return false;
 
-	auto symbolKey = std::make_pair(it->second.module, it->second.start);
+	auto symbolKey = std::make_pair(it->module, it->start);
 	auto it2 = functions.find(symbolKey);
 	if (it2 != functions.end()) {
 		functions.erase(it2);
 	}
-	activeFunctions.erase(it);
+	activeFunctions.erase(startAddress);
 
 	if (removeName) {
 		auto labelIt = activeLabels.find(startAddress);
-		if (labelIt != activeLabels.end()) {
-			symbolKey = std::make_pair(labelIt->second.module, labelIt->second.addr);
+		if (labelIt != NULL) {
+			symbolKey = std::make_pair(labelIt->module, labelIt->addr);
 			auto labelIt2 = labels.find(symbolKey);
 			if (labelIt2 != labels.end()) {
 				labels.erase(labelIt2);
 			}
-			activeLabels.erase(labelIt);
+			activeLabels.erase(startAddress);
 		}
 	}
 
@@ -542,10 +527,8 @@ void SymbolMap::AddLabel(const char* name, u32 address, int moduleIndex) {
 
 			// Refresh the active item if it exists.
 			auto active = activeLabels.find(address);
-			if (active != activeLabels.end() && active->second.module == moduleIndex) {
-				activeLabels.erase(active);
-				activeLabels.insert(std::make_pair(address, existing->second));
-			}
+			if (active != NULL && active->module == moduleIndex)
+				activeLabels.replace(address, existing->second);
 		}
 	} else {
 		LabelEntry label;
@@ -556,7 +539,7 @@ void SymbolMap::AddLabel(const char* name, u32 address, int moduleIndex) {
 
 		labels[symbolKey] = label;
 		if (IsModuleActive(moduleIndex)) {
-			activeLabels.insert(std::make_pair(address, label));
+			activeLabels.insert(address, label);
 		}
 	}
 }
@@ -564,10 +547,10 @@ void SymbolMap::AddLabel(const char* name, u32 address, int moduleIndex) {
 void SymbolMap::SetLabelName(const char* name, u32 address, bool updateImmediately) {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 	auto labelInfo = activeLabels.find(address);
-	if (labelInfo == activeLabels.end()) {
+	if (labelInfo == NULL) {
 		AddLabel(name, address);
 	} else {
-		auto symbolKey = std::make_pair(labelInfo->second.module, labelInfo->second.addr);
+		auto symbolKey = std::make_pair(labelInfo->module, labelInfo->addr);
 		auto label = labels.find(symbolKey);
 		if (label != labels.end()) {
 			strncpy(label->second.name, name, ARRAY_SIZE(label->second.name));
@@ -585,10 +568,10 @@ void SymbolMap::SetLabelName(const char* name, u32 address, bool updateImmediate
 const char *SymbolMap::GetLabelName(u32 address) const {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 	auto it = activeLabels.find(address);
-	if (it == activeLabels.end())
+	if (it == NULL)
 		return NULL;
 
-	return it->second.name;
+	return it->name;
 }
 
 const char *SymbolMap::GetLabelNameRel(u32 relAddress, int moduleIndex) const {
@@ -646,10 +629,8 @@ void SymbolMap::AddData(u32 address, u32 size, DataType type, int moduleIndex) {
 
 		// Refresh the active item if it exists.
 		auto active = activeData.find(address);
-		if (active != activeData.end() && active->second.module == moduleIndex) {
-			activeData.erase(active);
-			activeData.insert(std::make_pair(address, existing->second));
-		}
+		if (active != NULL && active->module == moduleIndex)
+			activeData.replace(address, existing->second);
 	} else {
 		DataEntry entry;
 		entry.start = relAddress;
@@ -659,53 +640,37 @@ void SymbolMap::AddData(u32 address, u32 size, DataType type, int moduleIndex) {
 
 		data[symbolKey] = entry;
 		if (IsModuleActive(moduleIndex)) {
-			activeData.insert(std::make_pair(address, entry));
+			activeData.insert(address, entry);
 		}
 	}
 }
 
 u32 SymbolMap::GetDataStart(u32 address) const {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
-	auto it = activeData.upper_bound(address);
-	if (it == activeData.end())
-	{
-		// check last element
-		auto rit = activeData.rbegin();
-
-		if (rit != activeData.rend())
-		{
-			u32 start = rit->first;
-			u32 size = rit->second.size;
-			if (start <= address && start+size > address)
-				return start;
-		}
-		// otherwise there's no data that contains this address
-		return INVALID_ADDRESS;
-	}
-
-	if (it != activeData.begin()) {
-		it--;
+	auto it = activeData.floor(address);
+	if (it != NULL) {
 		u32 start = it->first;
 		u32 size = it->second.size;
-		if (start <= address && start+size > address)
+		if (start+size > address)
 			return start;
 	}
 
+	// otherwise there's no data that contains this address
 	return INVALID_ADDRESS;
 }
 
 u32 SymbolMap::GetDataSize(u32 startAddress) const {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 	auto it = activeData.find(startAddress);
-	if (it == activeData.end())
+	if (it == NULL)
 		return INVALID_ADDRESS;
-	return it->second.size;
+	return it->size;
 }
 
 DataType SymbolMap::GetDataType(u32 startAddress) const {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 	auto it = activeData.find(startAddress);
-	if (it == activeData.end())
+	if (it == NULL)
 		return DATATYPE_NONE;
-	return it->second.type;
+	return it->type;
 }
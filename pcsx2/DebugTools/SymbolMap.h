@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include <mutex>
+#include <algorithm>
 
 #include "Pcsx2Types.h"
 
@@ -129,10 +130,94 @@ private:
 		char name[128];
 	};
 
+	// A flattened list of symbols, sorted by address.  Additions are appended and only
+	// sorted by the next lookup, so that bulk loads (a function scan, a module reload)
+	// sort once instead of paying for a tree insert each.  As with std::map::insert, the
+	// first symbol added at an address wins.  Callers hold m_lock.
+	template <typename T>
+	class ActiveList {
+	public:
+		typedef std::pair<u32, T> Entry;
+		typedef typename std::vector<Entry>::const_iterator const_iterator;
+
+		ActiveList() : sorted(true) {}
+
+		void clear() { items.clear(); sorted = true; }
+		bool empty() const { return items.empty(); }
+
+		void insert(u32 address, const T &value) {
+			if (!items.empty() && items.back().first >= address)
+				sorted = false;
+			items.push_back(Entry(address, value));
+		}
+
+		// Replaces the symbol at address, if there is one.
+		void replace(u32 address, const T &value) {
+			auto it = lowerBound(address);
+			if (it != items.end() && it->first == address)
+				it->second = value;
+		}
+
+		bool erase(u32 address) {
+			auto it = lowerBound(address);
+			if (it == items.end() || it->first != address)
+				return false;
+			items.erase(it);
+			return true;
+		}
+
+		const T *find(u32 address) const {
+			auto it = lowerBound(address);
+			return it != items.end() && it->first == address ? &it->second : NULL;
+		}
+
+		// The last symbol at or below address, or NULL.
+		const Entry *floor(u32 address) const {
+			sort();
+			auto it = std::upper_bound(items.begin(), items.end(), address, CompareAddress());
+			return it == items.begin() ? NULL : &*(it - 1);
+		}
+
+		// The first symbol above address, or NULL.
+		const Entry *next(u32 address) const {
+			sort();
+			auto it = std::upper_bound(items.begin(), items.end(), address, CompareAddress());
+			return it == items.end() ? NULL : &*it;
+		}
+
+		const_iterator begin() const { sort(); return items.begin(); }
+		const_iterator end() const { return items.end(); }
+
+	private:
+		struct CompareAddress {
+			bool operator()(const Entry &a, const Entry &b) const { return a.first < b.first; }
+			bool operator()(const Entry &a, u32 b) const { return a.first < b; }
+			bool operator()(u32 a, const Entry &b) const { return a < b.first; }
+		};
+
+		static bool SameAddress(const Entry &a, const Entry &b) { return a.first == b.first; }
+
+		typename std::vector<Entry>::iterator lowerBound(u32 address) const {
+			sort();
+			return std::lower_bound(items.begin(), items.end(), address, CompareAddress());
+		}
+
+		void sort() const {
+			if (sorted)
+				return;
+			std::stable_sort(items.begin(), items.end(), CompareAddress());
+			items.erase(std::unique(items.begin(), items.end(), SameAddress), items.end());
+			sorted = true;
+		}
+
+		mutable std::vector<Entry> items;
+		mutable bool sorted;
+	};
+
 	// These are flattened, read-only copies of the actual data in active modules only.
-	std::map<u32, const FunctionEntry> activeFunctions;
-	std::map<u32, const LabelEntry> activeLabels;
-	std::map<u32, const DataEntry> activeData;
+	ActiveList<FunctionEntry> activeFunctions;
+	ActiveList<LabelEntry> activeLabels;
+	ActiveList<DataEntry> activeData;
 
 	// This is indexed by the end address of the module.
 	std::map<u32, const ModuleEntry> activeModuleEnds;
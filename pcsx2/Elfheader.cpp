@@ -124,6 +124,16 @@ bool ElfObject::hasProgramHeaders() { return (proghead != NULL); }
 bool ElfObject::hasSectionHeaders() { return (secthead != NULL); }
 bool ElfObject::hasHeaders() { return (hasProgramHeaders() && hasSectionHeaders()); }
 
+bool ElfObject::hasSymbolTable()
+{
+	if (secthead == NULL || header.e_shoff > (u32)data.GetLength()) return false;
+
+	for (int i = 0; i < header.e_shnum; i++)
+		if (secthead[i].sh_type == 0x02) return true;
+
+	return false;
+}
+
 std::pair<u32,u32> ElfObject::getTextRange()
 {
 	for (int i = 0; i < header.e_phnum; i++)
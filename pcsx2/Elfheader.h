@@ -154,6 +154,7 @@ class ElfObject
 		bool hasProgramHeaders();
 		bool hasSectionHeaders();
 		bool hasHeaders();
+		bool hasSymbolTable();
 
 		std::pair<u32,u32> getTextRange();
 		u32 getCRC();
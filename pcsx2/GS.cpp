@@ -67,6 +67,7 @@ void gsUpdateFrequency(Pcsx2Config& config)
 		config.GS.LimitScalar = g_Conf->Framerate.SlomoScalar;
 		break;
 	case LimiterModeType::Limit_Turbo:
+	case LimiterModeType::Limit_FastForward:	// bypasses the limiter, the scalar is unused
 		config.GS.LimitScalar = g_Conf->Framerate.TurboScalar;
 		break;
 	default:
@@ -346,6 +347,10 @@ void gsIrq() {
 //
 // So instead we use a simple "always skipping" or "never skipping" logic.
 //
+// Fast-forward is the exception: it renders two consecutive fields (one full frame, which
+// covers the double buffered case above) out of every FastForwardInterval frames, and
+// skips everything else regardless of the frameskip settings.
+//
 // EE vs MTGS:
 //   This function does not regulate frame limiting, meaning it does no stalling. Stalling
 //   functions are performed by the EE, which itself uses thread sleep logic to avoid spin
@@ -356,6 +361,17 @@ __fi void gsFrameSkip()
 	static int consec_skipped = 0;
 	static int consec_drawn = 0;
 	static bool isSkipping = false;
+	static int ff_field = 0;
+
+	if( g_LimiterMode == Limit_FastForward )
+	{
+		const int fields = std::max( EmuConfig.GS.FastForwardInterval, 1 ) * 2;
+
+		ff_field = (ff_field + 1) % fields;
+		isSkipping = ff_field < fields - 2;
+		GSsetFrameSkip( isSkipping );
+		return;
+	}
 
 	if( !EmuConfig.GS.FrameSkipEnable )
 	{
@@ -314,15 +314,26 @@ class SysMtgsThread : public SysThreadBase
 public:
 	// note: when m_ReadPos == m_WritePos, the fifo is empty
 	// Threading info: m_ReadPos is updated by the MTGS thread. m_WritePos is updated by the EE thread
-	std::atomic<unsigned int> m_ReadPos;  // cur pos gs is reading from
-	std::atomic<unsigned int> m_WritePos; // cur pos ee thread is writing to
+	// Note: keep both positions on separate cache lines to avoid CPU conflict
+	__aligned(64) std::atomic<unsigned int> m_ReadPos;  // cur pos gs is reading from
+	__aligned(64) std::atomic<unsigned int> m_WritePos; // cur pos ee thread is writing to
 
-	std::atomic<bool>	m_RingBufferIsBusy;
+	__aligned(64) std::atomic<bool>	m_RingBufferIsBusy;
 	std::atomic<bool>	m_SignalRingEnable;
 	std::atomic<int>	m_SignalRingPosition;
 
 	std::atomic<int>	m_QueuedFrameCount;
 	std::atomic<bool>	m_VsyncSignalListener;
+	std::atomic<int>	m_VsyncQueueLimit;	// frames the EE may queue ahead, see UpdateVsyncQueue
+
+	// GS.VsyncQueueAdaptive bookkeeping (MTGS thread only), in GetCPUTicks units.
+	struct VsyncQueueState
+	{
+		u64		frame_start;	// end of the previous vsync, 0 to skip the next frame
+		u64		idle;			// time slept on an empty ring since then
+		u64		average;		// running average of the busy time of a frame
+		uint	calm;			// consecutive frames without a spike
+	} m_vsyncQueue;
 
 	Mutex			m_mtx_RingBufferBusy;  // Is obtained while processing ring-buffer data
 	Mutex			m_mtx_RingBufferBusy2; // This one gets released on semaXGkick waiting...
@@ -338,6 +349,38 @@ public:
 	// has more than one command in it when the thread is kicked.
 	int				m_CopyDataTally;
 
+	// Ring synchronization counters, dumped when the plugin is closed. Only the slow paths
+	// are counted: they are meant to tune RingBufferSizeFactor and the kick threshold.
+	struct RingStats
+	{
+		std::atomic<u32> ee_spins;		// EE waited for free room with a spin loop
+		std::atomic<u32> ee_sleeps;		// EE had to sleep on m_sem_OnRingReset
+		std::atomic<u32> gs_spins;		// MTGS found new data while spinning on an empty ring
+		std::atomic<u32> gs_sleeps;		// MTGS went to sleep on m_sem_event
+		std::atomic<u32> kicks;			// m_sem_event posts issued by the EE
+		std::atomic<u32> gs_packets;	// GIF path packets handed to SendSimpleGSPacket
+		std::atomic<u32> gs_commands;	// GS_RINGTYPE_GSPACKET commands they were merged into
+		std::atomic<u32> vsync_stalls;	// EE waited for the MTGS to catch up on the queued frames
+		std::atomic<u32> queue_raises;	// adaptive vsync queue limit raised after a spiky frame
+		std::atomic<u32> queue_drops;	// ... lowered after a calm stretch
+	} m_stats;
+
+	// Last GIF path packet, held back so that the next one can be merged into the same
+	// ring command when it continues the same path buffer (EE thread only).
+	struct PendingGSPacket
+	{
+		u32			offset;		// ~0u for blank (skipped) buffer space
+		u32			size;
+		GIF_PATH	path;
+		bool		valid;
+	} m_pendingGSPacket;
+
+	// Backing memory of RingBuffer.m_Ring. The maximum ring size is reserved once, and
+	// pages are committed as the ring grows.
+	VirtualMemoryReserve	m_RingReserve;
+	uint			m_RingCommitted;	// committed part of the reserve, in simd128's
+	uint			m_RingHighWater;	// max ring usage seen by the EE, in simd128's (EE thread only)
+
 	Semaphore			m_sem_OpenDone;
 	std::atomic<bool>	m_PluginOpened;
 
@@ -356,6 +399,8 @@ public:
 	SysMtgsThread();
 	virtual ~SysMtgsThread();
 
+	void ReserveRing();
+
 	// Waits for the GS to empty out the entire ring buffer contents.
 	void WaitGS(bool syncRegs=true, bool weakWait=false, bool isMTVU=false);
 	void ResetGS();
@@ -389,10 +434,17 @@ protected:
 	void OnResumeInThread( bool IsSuspended );
 	void OnCleanupInThread();
 
+	void ResizeRing( uint factor );
 	void GenericStall( uint size );
+	uint GetFreeRoom( uint writepos ) const;
+	void WaitForData();
+	void UpdateVsyncQueue();
+	void ResetStats();
+	void DumpStats();
 
 	// Used internally by SendSimplePacket type functions
 	void _FinishSimplePacket();
+	void FlushGSPacket();
 	void ExecuteTaskInThread();
 };
 
@@ -457,24 +509,45 @@ extern int g_nLeftGSFrames;
 #endif
 
 // Size of the ringbuffer as a power of 2 -- size is a multiple of simd128s.
-// (actual size is 1<<m_RingBufferSizeFactor simd vectors [128-bit values])
+// (actual size is 1<<EmuConfig.GS.RingBufferSizeFactor simd vectors [128-bit values])
 // A value of 19 is a 8meg ring buffer.  18 would be 4 megs, and 20 would be 16 megs.
 // Default was 2mb, but some games with lots of MTGS activity want 8mb to run fast (rama)
+// The maximum size is reserved at startup, only the configured size is committed.
 static const uint RingBufferSizeFactor = 19;
+static const uint RingBufferSizeFactorMin = 16;
+static const uint RingBufferSizeFactorMax = 22;
+
+static const uint RingBufferMaxSize = 1<<RingBufferSizeFactorMax;
 
 // size of the ringbuffer in simd128's.
-static const uint RingBufferSize = 1<<RingBufferSizeFactor;
+// Only changed by the MTGS thread while the ring is empty and the EE is waiting on it.
+extern uint RingBufferSize;
+
+// Amount of queued data (in simd128's) after which the EE kicks the MTGS thread. Packets
+// below that are coalesced and only woken up by the next kick or the vsync.
+static const uint RingBufferKickThreshold = 0x2000;
+
+// Number of SpinWait iterations done by either side of the ring before falling back to
+// a semaphore. A short spin is cheaper than the sleep/wake cycle when the other thread is
+// about to catch up.
+static const uint RingBufferSpinCount = 256;
+
+// Bounds of the adaptive vsync queue limit (GS.VsyncQueueAdaptive).  It grows by one frame
+// on every spiky MTGS frame, and shrinks by one after VsyncQueueCalmFrames calm ones.
+static const int VsyncQueueAdaptiveMin = 1;
+static const int VsyncQueueAdaptiveMax = 4;
+static const uint VsyncQueueCalmFrames = 300;
 
 // Mask to apply to ring buffer indices to wrap the pointer from end to
 // start (the wrapping is what makes it a ringbuffer, yo!)
-static const uint RingBufferMask = RingBufferSize - 1;
+extern uint RingBufferMask;
 
 struct MTGS_BufferedData
 {
-	u128		m_Ring[RingBufferSize];
+	u128*		m_Ring;		// RingBufferSize entries, mapped by SysMtgsThread::ReserveRing()
 	u8			Regs[Ps2MemSize::GSregs];
 
-	MTGS_BufferedData() {}
+	MTGS_BufferedData() : m_Ring(NULL) {}
 
 	u128& operator[]( uint idx )
 	{
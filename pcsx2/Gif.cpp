@@ -21,6 +21,7 @@
 #include "Vif_Dma.h"
 
 #include "iR5900.h"
+#include "Utilities/Instrumentation.h"
 
 // A three-way toggle used to determine if the GIF is stalling (transferring) or done (finished).
 // Should be a gifstate_t rather then int, but I don't feel like possibly interfering with savestates right now.
@@ -559,7 +560,7 @@ static __fi bool mfifoGIFchain()
 			SPR_LOG("GIF FIFO EMPTY before transfer");
 			gif.gifstate = GIF_STATE_EMPTY;
 			gif.mfifocycles += 4;
-			if (CHECK_GIFFIFOHACK)
+			if (CHECK_GIFFIFOHACK && gifRegs.stat.FQC > 0)
 				GifDMAInt(128);
 			return true;
 		}
@@ -590,6 +591,27 @@ static u32 qwctag(u32 mask) {
 	return (dmacRegs.rbor.ADDR + (mask & dmacRegs.rbsr.RMSK));
 }
 
+// Cycle at which the GIF started waiting on an empty MFIFO, for the instrumentation.
+// Not saved, a wait that spans a state load just isn't counted.
+static u32 s_mfifoWaitStart = 0;
+static bool s_mfifoWaiting = false;
+
+// The MFIFO is empty: hwMFIFOResume wakes the channel up when SPR0 adds data to the ring,
+// there's no need to come back before that.  With the FIFO hack the interrupt also drains
+// the GIF FIFO, so it still has to run as long as the FIFO has data.
+static __fi void gifMFIFOWait()
+{
+	if (CHECK_GIFFIFOHACK && gifRegs.stat.FQC > 0) {
+		GifDMAInt(128);
+		return;
+	}
+
+	if (!s_mfifoWaiting) {
+		s_mfifoWaiting = true;
+		s_mfifoWaitStart = cpuRegs.cycle;
+	}
+}
+
 void mfifoGifMaskMem(int id)
 {
 	switch (id) {
@@ -635,7 +657,7 @@ void mfifoGIFtransfer()
 			SPR_LOG("GIF FIFO EMPTY before tag read");
 			gif.gifstate = GIF_STATE_EMPTY;
 			GifDMAInt(4);
-			if (CHECK_GIFFIFOHACK)
+			if (CHECK_GIFFIFOHACK && gifRegs.stat.FQC > 0)
 				GifDMAInt(128);
 			return;
 		}
@@ -681,6 +703,12 @@ void gifMFIFOInterrupt()
     GIF_LOG("gifMFIFOInterrupt");
 	gif.mfifocycles = 0;
 
+	if (s_mfifoWaiting && !(gif.gifstate & GIF_STATE_EMPTY)) {
+		// Woken up by SPR0, the FIFO hack used to test every 128 cycles meanwhile
+		s_mfifoWaiting = false;
+		Instrumentation::Add(Instrumentation::Counter_MFIFOWait, (cpuRegs.cycle - s_mfifoWaitStart) / 128);
+	}
+
 	if (dmacRegs.ctrl.MFD != MFD_GIF) { // GIF not in MFIFO anymore, come out.
 		DevCon.WriteLn("GIF Leaving MFIFO - Report if any errors");
 		gifInterrupt();
@@ -762,8 +790,7 @@ void gifMFIFOInterrupt()
 
 	if ((gif.gifstate & GIF_STATE_EMPTY)) {
 		FireMFIFOEmpty();
-		if (CHECK_GIFFIFOHACK)
-			GifDMAInt(128);
+		gifMFIFOWait();
 		return;
 	}
 
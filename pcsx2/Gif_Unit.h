@@ -158,8 +158,9 @@ struct Gif_Path_MTVU {
 	GS_Packet fakePacket;
 	// Set a size based on MTGS but keep a factor 2 to avoid too waste to much
 	// memory overhead. Note the struct is instantied 3 times (for each gif
-	// path)
-	ringbuffer_base<GS_Packet, RingBufferSize / 2> gsPackQueue;
+	// path). The default MTGS size is used: a bigger ring only makes the push wait
+	// on the MTGS thread.
+	ringbuffer_base<GS_Packet, (1 << RingBufferSizeFactor) / 2> gsPackQueue;
 	Gif_Path_MTVU() { Reset(); }
 	void Reset()    { fakePackets = 0;
 		gsPackQueue.reset();
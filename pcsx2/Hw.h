@@ -383,5 +383,21 @@ union tGS_SMODE2
 extern void hwReset();
 extern void hwShutdown();
 
+// True for the registers whose 32 bit reads are a plain load of psHu32(mem) under the current
+// settings (no side effects, no gamefix involved), so the recompiler may load them directly.
+extern bool hwIsPlainRead32(u32 mem);
+
+// Counts of EE hardware register reads, per word of 0x10000000-0x1000ffff.  Only kept while
+// hwReadStatsEnabled is set (benchmark mode); costs a flag test per read otherwise.
+static const uint HwReadStatCount = 0x10000 / 4;
+extern bool hwReadStatsEnabled;
+extern u32 hwReadStats[HwReadStatCount];
+
+static __fi void hwCountRead(u32 mem)
+{
+	if (hwReadStatsEnabled)
+		++hwReadStats[(mem & 0xffff) >> 2];
+}
+
 extern const int rdram_devices;
 extern int rdram_sdevid;
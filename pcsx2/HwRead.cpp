@@ -33,6 +33,34 @@ static __fi void IntCHackCheck()
 	if( diff > 0 ) cpuRegs.cycle = g_nextEventCycle;
 }
 
+bool hwReadStatsEnabled = false;
+u32 hwReadStats[HwReadStatCount];
+
+// Registers polled in tight loops by many games.  Their reads go through the switches below
+// only to end up at psHu32(mem), unless a gamefix or speedhack changes that.
+bool hwIsPlainRead32(u32 mem)
+{
+	switch (mem)
+	{
+		case INTC_STAT:
+			return !EmuConfig.Speedhacks.IntcStat;
+
+		case GIF_STAT:
+			return !CHECK_OPHFLAGHACK;
+
+		case INTC_MASK:
+		case VIF0_STAT:
+		case VIF1_STAT:
+		case DMAC_CTRL:
+		case DMAC_STAT:
+		case DMAC_PCR:
+		case D0_CHCR: case D1_CHCR: case D2_CHCR: case D3_CHCR: case D4_CHCR:
+		case D5_CHCR: case D6_CHCR: case D7_CHCR: case D8_CHCR: case D9_CHCR:
+			return true;
+	}
+	return false;
+}
+
 template< uint page > void __fastcall _hwRead128(u32 mem, mem128_t* result );
 
 template< uint page, bool intcstathack >
@@ -209,6 +237,7 @@ mem32_t __fastcall _hwRead32(u32 mem)
 template< uint page >
 mem32_t __fastcall hwRead32(u32 mem)
 {
+	hwCountRead(mem);
 	mem32_t retval = _hwRead32<page,false>(mem);
 	eeHwTraceLog( mem, retval, true );
 	return retval;
@@ -216,6 +245,7 @@ mem32_t __fastcall hwRead32(u32 mem)
 
 mem32_t __fastcall hwRead32_page_0F_INTC_HACK(u32 mem)
 {
+	hwCountRead(mem);
 	mem32_t retval = _hwRead32<0x0f,true>(mem);
 	eeHwTraceLog( mem, retval, true );
 	return retval;
@@ -235,6 +265,7 @@ mem8_t __fastcall _hwRead8(u32 mem)
 template< uint page >
 mem8_t __fastcall hwRead8(u32 mem)
 {
+	hwCountRead(mem);
 	mem8_t ret8 = _hwRead8<0x0f>(mem);
 	eeHwTraceLog( mem, ret8, true );
 	return ret8;
@@ -252,6 +283,7 @@ mem16_t __fastcall _hwRead16(u32 mem)
 template< uint page >
 mem16_t __fastcall hwRead16(u32 mem)
 {
+	hwCountRead(mem);
 	u16 ret16 = _hwRead16<page>(mem);
 	eeHwTraceLog( mem, ret16, true );
 	return ret16;
@@ -260,6 +292,7 @@ mem16_t __fastcall hwRead16(u32 mem)
 mem16_t __fastcall hwRead16_page_0F_INTC_HACK(u32 mem)
 {
 	pxAssume( (mem & 0x01) == 0 );
+	hwCountRead(mem);
 
 	u32 ret32 = _hwRead32<0x0f, true>(mem & ~0x03);
 	u16 ret16 = ((u16*)&ret32)[(mem>>1) & 0x01];
@@ -322,6 +355,7 @@ static void _hwRead64(u32 mem, mem64_t* result )
 template< uint page >
 void __fastcall hwRead64(u32 mem, mem64_t* result )
 {
+	hwCountRead(mem);
 	_hwRead64<page>( mem, result );
 	eeHwTraceLog( mem, *result, true );
 }
@@ -393,6 +427,7 @@ void __fastcall _hwRead128(u32 mem, mem128_t* result )
 template< uint page >
 void __fastcall hwRead128(u32 mem, mem128_t* result )
 {
+	hwCountRead(mem);
 	_hwRead128<page>( mem, result );
 	eeHwTraceLog( mem, *result, true );
 }
@@ -644,52 +644,73 @@ static void ipuSETTH(u32 val)
 // --------------------------------------------------------------------------------------
 //  CORE Functions (referenced from MPEG library)
 // --------------------------------------------------------------------------------------
+// Applies the SETTH thresholds (and the sign conversion) to a converted macroblock.
+// Pixels whose r, g and b are all below threshold 0 become transparent black; otherwise
+// if they are all below threshold 1 their alpha is set to 0x40 (half transparent).
+static __fi void ipu_csc_adjust(macroblock_rgb32& rgb32, int sgn)
+{
+	const __m128i th0 = _mm_set1_epi32(s_thresh[0]);
+	const __m128i th1 = _mm_set1_epi32(s_thresh[1]);
+	const __m128i byte_mask = _mm_set1_epi32(0xff);
+	const __m128i alpha_mask = _mm_set1_epi32(0xff000000);
+	const __m128i alpha_40 = _mm_set1_epi32(0x40000000);
+	const __m128i sign = _mm_set1_epi32(sgn ? 0x808080 : 0);
+	__m128i* p = (__m128i*)&rgb32;
+
+	for (int i = 0; i < (int)(sizeof(rgb32) / 16); i++)
+	{
+		__m128i x = _mm_load_si128(p + i);
+
+		// max(r, g, b) in the low byte of each pixel
+		__m128i m = _mm_max_epu8(x, _mm_srli_epi32(x, 8));
+		m = _mm_and_si128(_mm_max_epu8(m, _mm_srli_epi32(x, 16)), byte_mask);
+
+		const __m128i below0 = _mm_cmplt_epi32(m, th0);
+		const __m128i below1 = _mm_andnot_si128(below0, _mm_cmplt_epi32(m, th1));
+
+		x = _mm_or_si128(_mm_andnot_si128(_mm_and_si128(below1, alpha_mask), x), _mm_and_si128(below1, alpha_40));
+		x = _mm_andnot_si128(below0, x);
+
+		_mm_store_si128(p + i, _mm_xor_si128(x, sign));
+	}
+}
+
 __fi void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn)
 {
-	int i;
-	u8* p = (u8*)&rgb32;
-
 	yuv2rgb();
 
-	if (s_thresh[0] > 0)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < s_thresh[0]) && (p[1] < s_thresh[0]) && (p[2] < s_thresh[0]))
-				*(u32*)p = 0;
-			else if ((p[0] < s_thresh[1]) && (p[1] < s_thresh[1]) && (p[2] < s_thresh[1]))
-				p[3] = 0x40;
-		}
-	}
-	else if (s_thresh[1] > 0)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < s_thresh[1]) && (p[1] < s_thresh[1]) && (p[2] < s_thresh[1]))
-				p[3] = 0x40;
-		}
-	}
-	if (sgn)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			*(u32*)p ^= 0x808080;
-		}
-	}
+	if (s_thresh[0] > 0 || s_thresh[1] > 0 || sgn)
+		ipu_csc_adjust(rgb32, sgn);
 }
 
 __fi void ipu_dither(const macroblock_rgb32& rgb32, macroblock_rgb16& rgb16, int dte)
 {
-	int i, j;
-	for (i = 0; i < 16; ++i)
+	const __m128i r_mask = _mm_set1_epi32(0x001f);
+	const __m128i g_mask = _mm_set1_epi32(0x03e0);
+	const __m128i b_mask = _mm_set1_epi32(0x7c00);
+	const __m128i a_mask = _mm_set1_epi32(0xff000000);
+	const __m128i a_40 = _mm_set1_epi32(0x40000000);
+	const __m128i a_bit = _mm_set1_epi32(0x8000);
+	const __m128i* src = (const __m128i*)&rgb32;
+	__m128i* dst = (__m128i*)&rgb16;
+
+	for (int i = 0; i < (int)(sizeof(rgb16) / 16); i++)
 	{
-		for (j = 0; j < 16; ++j)
+		__m128i c[2];
+
+		for (int j = 0; j < 2; j++)
 		{
-			rgb16.c[i][j].r = rgb32.c[i][j].r >> 3;
-			rgb16.c[i][j].g = rgb32.c[i][j].g >> 3;
-			rgb16.c[i][j].b = rgb32.c[i][j].b >> 3;
-			rgb16.c[i][j].a = rgb32.c[i][j].a == 0x40;
+			const __m128i x = _mm_load_si128(src + i * 2 + j);
+			__m128i v = _mm_and_si128(_mm_srli_epi32(x, 3), r_mask);
+			v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 6), g_mask));
+			v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 9), b_mask));
+			v = _mm_or_si128(v, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(x, a_mask), a_40), a_bit));
+
+			// sign extend, so that the signed saturating pack keeps all 16 bits
+			c[j] = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
 		}
+
+		_mm_store_si128(dst + i, _mm_packs_epi32(c[0], c[1]));
 	}
 }
 
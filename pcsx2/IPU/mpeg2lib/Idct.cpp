@@ -22,10 +22,6 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-// [TODO] : There are modern SSE versions of idct (idct_mmx.c) in the mpeg2 libs that we
-// should probably upgrade to.  They use their own raw-style intrinsics and not the intel
-// compiler-integrated ones.
-
 #include "PrecompiledHeader.h"
 
 #include "Common.h"
@@ -45,10 +41,6 @@
  * to +-3826 - this is the worst case for a column IDCT where the
  * column inputs are 16-bit values.
  */
-static __aligned16 u8 clip_lut[1024];
-
-#define CLIP(i) ((clip_lut+384)[(i)])
-
 static __fi void BUTTERFLY(int& t0, int& t1, int w0, int w1, int d0, int d1)
 {
 #if 0
@@ -61,6 +53,7 @@ static __fi void BUTTERFLY(int& t0, int& t1, int w0, int w1, int d0, int d1)
 #endif
 }
 
+// Reference implementation, kept for documentation; see idct_sse2 below.
 static __fi void idct_row (s16 * const block)
 {
     int d0, d1, d2, d3;
@@ -155,31 +148,184 @@ static __fi void idct_col (s16 * const block)
     block[8*7] = (a0 - b0) >> 17;
 }
 
+// ------------------------------------------------------------------------
+// SSE2 implementation.  Computes exactly the same as the reference idct_row/idct_col
+// above: products are done with pmaddwd on 16 bit pairs, and all other arithmetic in 32
+// bits, truncating back to 16 bits between the passes.  Each pass transforms all eight
+// rows (or columns) at once; the row pass runs on a transposed block.
+//
+static __fi void idct_transpose(__m128i* r)
+{
+	__m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+	__m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+	__m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+	__m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+	__m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+	__m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+	__m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+	__m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	__m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	__m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	__m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	__m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	__m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	__m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	__m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	__m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	r[0] = _mm_unpacklo_epi64(b0, b4);
+	r[1] = _mm_unpackhi_epi64(b0, b4);
+	r[2] = _mm_unpacklo_epi64(b1, b5);
+	r[3] = _mm_unpackhi_epi64(b1, b5);
+	r[4] = _mm_unpacklo_epi64(b2, b6);
+	r[5] = _mm_unpackhi_epi64(b2, b6);
+	r[6] = _mm_unpacklo_epi64(b3, b7);
+	r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+static __fi __m128i idct_pair(s16 w0, s16 w1)
+{
+	return _mm_set_epi16(w1, w0, w1, w0, w1, w0, w1, w0);
+}
+
+static __fi __m128i idct_mul181(__m128i x)
+{
+	// 181 = 128 + 32 + 16 + 4 + 1 (SSE2 has no 32 bit multiply)
+	__m128i r = _mm_add_epi32(_mm_slli_epi32(x, 7), _mm_slli_epi32(x, 5));
+	r = _mm_add_epi32(r, _mm_slli_epi32(x, 4));
+	r = _mm_add_epi32(r, _mm_slli_epi32(x, 2));
+	return _mm_add_epi32(r, x);
+}
+
+// Truncates two vectors of 32 bit results to a single vector of 16 bit ones.
+static __fi __m128i idct_pack(__m128i lo, __m128i hi)
+{
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+// One half (four lanes) of a pass.  p02, p31, p74 and p56 hold the inputs d0/d2, d3/d1,
+// d7/d4 and d5/d6 interleaved as 16 bit pairs.  When sparse is set, d4 to d7 are known
+// to be zero.
+template< bool row >
+static __fi void idct_half(__m128i p02, __m128i p31, __m128i p74, __m128i p56, bool sparse, __m128i* out)
+{
+	const __m128i bias = _mm_set1_epi32(row ? 128 : 65536);
+
+	__m128i t0 = _mm_add_epi32(_mm_madd_epi16(p02, idct_pair(2048, 2048)), bias);
+	__m128i t1 = _mm_add_epi32(_mm_madd_epi16(p02, idct_pair(2048, -2048)), bias);
+	__m128i t2 = _mm_madd_epi16(p31, idct_pair(W6, W2));
+	__m128i t3 = _mm_madd_epi16(p31, idct_pair(-W2, W6));
+
+	__m128i a0 = _mm_add_epi32(t0, t2);
+	__m128i a1 = _mm_add_epi32(t1, t3);
+	__m128i a2 = _mm_sub_epi32(t1, t3);
+	__m128i a3 = _mm_sub_epi32(t0, t2);
+
+	const int shift = row ? 8 : 17;
+
+	if (sparse)
+	{
+		out[0] = out[7] = _mm_srai_epi32(a0, shift);
+		out[1] = out[6] = _mm_srai_epi32(a1, shift);
+		out[2] = out[5] = _mm_srai_epi32(a2, shift);
+		out[3] = out[4] = _mm_srai_epi32(a3, shift);
+		return;
+	}
+
+	t0 = _mm_madd_epi16(p74, idct_pair(W7, W1));
+	t1 = _mm_madd_epi16(p74, idct_pair(-W1, W7));
+	t2 = _mm_madd_epi16(p56, idct_pair(W3, W5));
+	t3 = _mm_madd_epi16(p56, idct_pair(-W5, W3));
+
+	__m128i b0 = _mm_add_epi32(t0, t2);
+	__m128i b3 = _mm_add_epi32(t1, t3);
+	t0 = _mm_sub_epi32(t0, t2);
+	t1 = _mm_sub_epi32(t1, t3);
+
+	__m128i b1, b2;
+	if (row)
+	{
+		b1 = _mm_srai_epi32(idct_mul181(_mm_add_epi32(t0, t1)), 8);
+		b2 = _mm_srai_epi32(idct_mul181(_mm_sub_epi32(t0, t1)), 8);
+	}
+	else
+	{
+		t0 = _mm_srai_epi32(t0, 8);
+		t1 = _mm_srai_epi32(t1, 8);
+		b1 = idct_mul181(_mm_add_epi32(t0, t1));
+		b2 = idct_mul181(_mm_sub_epi32(t0, t1));
+	}
+
+	out[0] = _mm_srai_epi32(_mm_add_epi32(a0, b0), shift);
+	out[1] = _mm_srai_epi32(_mm_add_epi32(a1, b1), shift);
+	out[2] = _mm_srai_epi32(_mm_add_epi32(a2, b2), shift);
+	out[3] = _mm_srai_epi32(_mm_add_epi32(a3, b3), shift);
+	out[4] = _mm_srai_epi32(_mm_sub_epi32(a3, b3), shift);
+	out[5] = _mm_srai_epi32(_mm_sub_epi32(a2, b2), shift);
+	out[6] = _mm_srai_epi32(_mm_sub_epi32(a1, b1), shift);
+	out[7] = _mm_srai_epi32(_mm_sub_epi32(a0, b0), shift);
+}
+
+// x[k] holds input k of each of the eight lanes; replaced with output k.  When sparse is
+// set, the upper four inputs (row pass: the upper four lanes) are known to be zero.
+template< bool row >
+static __fi void idct_pass(__m128i* x, bool sparse)
+{
+	__m128i lo[8], hi[8];
+
+	idct_half<row>(_mm_unpacklo_epi16(x[0], x[2]), _mm_unpacklo_epi16(x[3], x[1]),
+		_mm_unpacklo_epi16(x[7], x[4]), _mm_unpacklo_epi16(x[5], x[6]), sparse && !row, lo);
+
+	if (sparse && row)
+	{
+		// Zero rows transform to zero.
+		const __m128i zero = _mm_setzero_si128();
+		for (int i = 0; i < 8; i++)
+			x[i] = idct_pack(lo[i], zero);
+		return;
+	}
+
+	idct_half<row>(_mm_unpackhi_epi16(x[0], x[2]), _mm_unpackhi_epi16(x[3], x[1]),
+		_mm_unpackhi_epi16(x[7], x[4]), _mm_unpackhi_epi16(x[5], x[6]), sparse && !row, hi);
+
+	for (int i = 0; i < 8; i++)
+		x[i] = idct_pack(lo[i], hi[i]);
+}
+
+// Transforms block (eight rows of eight coefficients) into r, and clears block.
+static __fi void idct_sse2(s16* block, __m128i* r)
+{
+	__m128i* src = (__m128i*)block;
+	const __m128i zero = _mm_setzero_si128();
+
+	for (int i = 0; i < 8; i++)
+	{
+		r[i] = _mm_load_si128(src + i);
+		_mm_store_si128(src + i, zero);
+	}
+
+	// Most blocks only have low frequency coefficients.  If the lower half of the block is
+	// empty, it stays empty after the row pass, and the odd half of the column pass drops out.
+	const __m128i upper = _mm_or_si128(_mm_or_si128(r[4], r[5]), _mm_or_si128(r[6], r[7]));
+	const bool sparse = _mm_movemask_epi8(_mm_cmpeq_epi8(upper, zero)) == 0xffff;
+
+	idct_transpose(r);
+	idct_pass<true>(r, sparse);
+	idct_transpose(r);
+	idct_pass<false>(r, sparse);
+}
+
 __ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
 {
-    int i;
-
-    for (i = 0; i < 8; i++)
-		idct_row (block + 8 * i);
-    for (i = 0; i < 8; i++)
-		idct_col (block + i);
-
-	__m128 zero = _mm_setzero_ps();
-    do {
-		dest[0] = CLIP (block[0]);
-		dest[1] = CLIP (block[1]);
-		dest[2] = CLIP (block[2]);
-		dest[3] = CLIP (block[3]);
-		dest[4] = CLIP (block[4]);
-		dest[5] = CLIP (block[5]);
-		dest[6] = CLIP (block[6]);
-		dest[7] = CLIP (block[7]);
-
-		_mm_store_ps((float*)block, zero);
-
-		dest += stride;
-		block += 8;
-    } while (--i);
+	__m128i r[8];
+	idct_sse2(block, r);
+
+	// Saturating the results to 0..255 is the same as clipping them.
+	for (int i = 0; i < 8; i++, dest += stride)
+		_mm_storel_epi64((__m128i*)dest, _mm_packus_epi16(r[i], r[i]));
 }
 
 
@@ -190,21 +336,11 @@ __ri void mpeg2_idct_add (const int last, s16 * block, s16 * dest, const int str
 
     if (last != 129 || (block[0] & 7) == 4)
     {
-		int i;
-		for (i = 0; i < 8; i++)
-			idct_row (block + 8 * i);
-		for (i = 0; i < 8; i++)
-			idct_col (block + i);
-
-		__m128 zero = _mm_setzero_ps();
-		do {
-			_mm_store_ps((float*)dest, _mm_load_ps((float*)block));
-			_mm_store_ps((float*)block, zero);
-
-			dest += stride;
-			block += 8;
-		} while (--i);
+		__m128i r[8];
+		idct_sse2(block, r);
 
+		for (int i = 0; i < 8; i++, dest += stride)
+			_mm_store_si128((__m128i*)dest, r[i]);
     }
     else
     {
@@ -237,9 +373,6 @@ mpeg2_scan_pack::mpeg2_scan_pack()
 		53, 61, 22, 30,  7, 15, 23, 31, 38, 46, 54, 62, 39, 47, 55, 63
 	};
 
-	for (int i = -384; i < 640; i++)
-		clip_lut[i+384] = (i < 0) ? 0 : ((i > 255) ? 255 : i);
-
 	for (int i = 0; i < 64; i++) {
 		int j = mpeg2_scan_norm[i];
 		norm[i] = ((j & 0x36) >> 1) | ((j & 0x09) << 2);
@@ -52,6 +52,28 @@ const int non_linear_quantizer_scale [] =
 const DCTtab * tab;
 int mbaCount = 0;
 
+// DCT.tab2 to DCT.tab6 (codes 0000 0001 xxxx xxxx down to 0000 0000 0001 xxxx) unrolled
+// into a single table indexed by the 16 bit code, so that the long codes are found with
+// one lookup instead of a chain of comparisons.  Shared by the intra and non-intra tables.
+struct DCTtabLongSet
+{
+	DCTtab tab[512];
+
+	DCTtabLongSet()
+	{
+		for (int code = 16; code < 512; code++)
+		{
+			if (code >= 256)		tab[code] = DCT.tab2[(code >> 4) - 16];
+			else if (code >= 128)	tab[code] = DCT.tab3[(code >> 3) - 16];
+			else if (code >= 64)	tab[code] = DCT.tab4[(code >> 2) - 16];
+			else if (code >= 32)	tab[code] = DCT.tab5[(code >> 1) - 16];
+			else					tab[code] = DCT.tab6[code - 16];
+		}
+	}
+};
+
+static const __aligned16 DCTtabLongSet DCTlong;
+
 int bitstream_init ()
 {
 	return g_BP.FillBuffer(32);
@@ -390,30 +412,9 @@ static bool get_intra_block()
 			}
 		}
 
-		// [TODO] Optimization: Following codes can all be done by a single "expedited" lookup
-		// that should use a single unrolled DCT table instead of five separate tables used
-		// here.  Multiple conditional statements are very slow, while modern CPU data caches
-		// have lots of room to spare.
-
-		else if (code >= 256)
-		{
-			tab = &DCT.tab2[(code >> 4) - 16];
-		}
-		else if (code >= 128)
-		{    
-			tab = &DCT.tab3[(code >> 3) - 16];
-		}
-		else if (code >= 64)
-		{    
-			tab = &DCT.tab4[(code >> 2) - 16];
-		}
-		else if (code >= 32)
-		{    
-			tab = &DCT.tab5[(code >> 1) - 16];
-		}
 		else if (code >= 16)
-		{    
-			tab = &DCT.tab6[code - 16];
+		{
+			tab = &DCTlong.tab[code];
 		}
 		else
 		{
@@ -541,30 +542,9 @@ static bool get_non_intra_block(int * last)
 				tab = &DCT.tab1[(code >> 6) - 8];
 			}
 
-			// [TODO] Optimization: Following codes can all be done by a single "expedited" lookup
-			// that should use a single unrolled DCT table instead of five separate tables used
-			// here.  Multiple conditional statements are very slow, while modern CPU data caches
-			// have lots of room to spare.
-
-			else if (code >= 256)
-			{		
-				tab = &DCT.tab2[(code >> 4) - 16];
-			}
-			else if (code >= 128)
-			{		
-				tab = &DCT.tab3[(code >> 3) - 16];
-			}
-			else if (code >= 64)
-			{		
-				tab = &DCT.tab4[(code >> 2) - 16];
-			}
-			else if (code >= 32)
-			{		
-				tab = &DCT.tab5[(code >> 1) - 16];
-			}
 			else if (code >= 16)
-			{		
-				tab = &DCT.tab6[code - 16];
+			{
+				tab = &DCTlong.tab[code];
 			}
 			else
 			{
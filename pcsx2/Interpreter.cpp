@@ -524,12 +524,7 @@ static void intExecute()
 						execI();
 					while (cpuRegs.pc != (g_eeloadMain ? g_eeloadMain : EELOAD_START));
 					if (cpuRegs.pc == EELOAD_START)
-					{
-						// The EELOAD _start function is the same across all BIOS versions afaik
-						u32 mainjump = memRead32(EELOAD_START + 0x9c);
-						if (mainjump >> 26 == 3) // JAL
-							g_eeloadMain = ((EELOAD_START + 0xa0) & 0xf0000000U) | (mainjump << 2 & 0x0fffffffU);
-					}
+						eeloadFindMain();
 					else if (cpuRegs.pc == g_eeloadMain)
 					{
 						eeloadHook();
@@ -593,6 +588,10 @@ static void intClear(u32 Addr, u32 Size)
 {
 }
 
+static void intSuspendPage(u32 Addr)
+{
+}
+
 static void intShutdown() {
 }
 
@@ -630,6 +629,7 @@ R5900cpu intCpu =
 	intThrowException,
 	intThrowException,
 	intClear,
+	intSuspendPage,
 
 	intGetCacheReserve,
 	intSetCacheReserve,
@@ -17,6 +17,7 @@
 #include "PrecompiledHeader.h"
 #include "IopCommon.h"
 #include "R5900.h" // for g_GameStarted
+#include "Utilities/Instrumentation.h"
 
 #include <ctype.h>
 #include <string.h>
@@ -84,6 +85,8 @@ void Hle_SetElfPath(const char* elfFileName)
 #endif
 }
 
+u32 g_iopHleCalls = 0;
+
 namespace R3000A {
 
 #define v0 (psxRegs.GPR.n.v0)
@@ -578,6 +581,136 @@ _start:
 	}
 }
 
+// Native versions of the sysclib memory and string functions (Speedhacks.IopHle).  Only
+// buffers lying entirely in IOP ram are handled; anything else, including overlapping
+// copies whose result depends on the copy order, runs the module code instead.
+namespace sysclib {
+	// Host pointer to [addr, addr+size) of IOP ram, or NULL.
+	static u8* ramRange(u32 addr, u32 size)
+	{
+		if (psxRegs.CP0.n.Status & 0x10000) return NULL;	// cache isolated
+
+		addr &= 0x1fffffff;
+		if (addr >= Ps2MemSize::IopRam || size > Ps2MemSize::IopRam - addr) return NULL;
+
+		return iopPhysMem(addr);
+	}
+
+	static bool overlaps(u32 a, u32 b, u32 size)
+	{
+		a &= 0x1fffffff;
+		b &= 0x1fffffff;
+		return (a < b) ? (b - a < size) : (a - b < size);
+	}
+
+	// Length of the string at addr, or -1 if it isn't terminated inside IOP ram.
+	static s32 length(u32 addr)
+	{
+		const u8* str = ramRange(addr, 1);
+		if (!str) return -1;
+
+		const u32 avail = Ps2MemSize::IopRam - (addr & 0x1fffffff);
+		const u8* end = (const u8*)memchr(str, 0, avail);
+		return end ? (s32)(end - str) : -1;
+	}
+
+	// Bookkeeping shared by the handlers: recompiled code over the written range is dropped,
+	// and the call is charged roughly what the module's word loops would have cost.
+	static int done(u32 written, u32 size)
+	{
+		if (size)
+		{
+			if (written != (u32)-1)
+			{
+				written &= 0x1fffffff;
+				psxCpu->Clear(written & ~3, ((written & 3) + size + 3) / 4);
+			}
+			psxRegs.cycle += size / 4;
+		}
+
+		++g_iopHleCalls;
+		Instrumentation::Add(Instrumentation::Counter_IopHleCall, size);
+
+		pc = ra;
+		return 1;
+	}
+
+	static int copy(u32 dst, u32 src, u32 size, bool overlapOk)
+	{
+		u8* to = ramRange(dst, size);
+		const u8* from = ramRange(src, size);
+		if (!to || !from || (!overlapOk && overlaps(dst, src, size)))
+			return 0;
+
+		memmove(to, from, size);
+		return done(dst, size);
+	}
+
+	int memcpy_HLE()
+	{
+		const u32 dst = a0;
+		if (!copy(dst, a1, a2, false)) return 0;
+
+		v0 = dst;
+		return 1;
+	}
+
+	int memmove_HLE()
+	{
+		const u32 dst = a0;
+		if (!copy(dst, a1, a2, true)) return 0;
+
+		v0 = dst;
+		return 1;
+	}
+
+	int bcopy_HLE()
+	{
+		return copy(a1, a0, a2, false);
+	}
+
+	int memset_HLE()
+	{
+		const u32 dst = a0;
+		u8* to = ramRange(dst, a2);
+		if (!to) return 0;
+
+		memset(to, (u8)a1, a2);
+		done(dst, a2);
+		v0 = dst;
+		return 1;
+	}
+
+	int bzero_HLE()
+	{
+		u8* to = ramRange(a0, a1);
+		if (!to) return 0;
+
+		memset(to, 0, a1);
+		return done(a0, a1);
+	}
+
+	int strlen_HLE()
+	{
+		const s32 len = length(a0);
+		if (len < 0) return 0;
+
+		done((u32)-1, len);
+		v0 = len;
+		return 1;
+	}
+
+	int strcpy_HLE()
+	{
+		const u32 dst = a0;
+		const s32 len = length(a1);
+		if (len < 0 || !copy(dst, a1, len + 1, false)) return 0;
+
+		v0 = dst;
+		return 1;
+	}
+}
+
 namespace loadcore {
 	void RegisterLibraryEntries_DEBUG()
 	{
@@ -653,13 +786,27 @@ const char* irxImportFuncname(const std::string &libname, u16 index)
 #define EXPORT_D(i, n) case (i): return n ## _DEBUG;
 #define EXPORT_H(i, n) case (i): return n ## _HLE;
 
-irxHLE irxImportHLE(const std::string &libname, u16 index)
+irxHLE irxImportHLE(const std::string &libname, u16 version, u16 index)
 {
 	// debugging output
 	MODULE(sysmem)
 		EXPORT_H( 14, Kprintf)
 	END_MODULE
 
+	// The export numbering is only known for the 1.x libraries.
+	if (EmuConfig.Speedhacks.IopHle && (version >> 8) == 1)
+	{
+		MODULE(sysclib)
+			EXPORT_H( 12, memcpy)
+			EXPORT_H( 13, memmove)
+			EXPORT_H( 14, memset)
+			EXPORT_H( 16, bcopy)
+			EXPORT_H( 17, bzero)
+			EXPORT_H( 23, strcpy)
+			EXPORT_H( 27, strlen)
+		END_MODULE
+	}
+
 	MODULE(ioman)
 		EXPORT_H(  4, open)
 		EXPORT_H(  5, close)
@@ -710,7 +857,7 @@ int irxImportExec(u32 import_table, u16 index)
 
 	std::string libname = iopMemReadString(import_table + 12, 8);
 	const char *funcname = irxImportFuncname(libname, index);
-	irxHLE hle = irxImportHLE(libname, index);
+	irxHLE hle = irxImportHLE(libname, iopMemRead16(import_table + 8), index);
 	irxDEBUG debug = irxImportDebug(libname, index);
 
 	irxImportLog(libname, index, funcname);
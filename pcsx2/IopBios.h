@@ -65,7 +65,7 @@ namespace R3000A
 {
 	u32 irxImportTableAddr(u32 entrypc);
 	const char* irxImportFuncname(const std::string &libname, u16 index);
-	irxHLE irxImportHLE(const std::string &libnam, u16 index);
+	irxHLE irxImportHLE(const std::string &libnam, u16 version, u16 index);
 	irxDEBUG irxImportDebug(const std::string & libname, u16 index);
 	void irxImportLog(const std::string &libnameptr, u16 index, const char *funcname);
 	void __fastcall irxImportLog_rec(u32 import_table, u16 index, const char *funcname);
@@ -77,6 +77,9 @@ namespace R3000A
 	}
 }
 
+// Calls handled by the native sysclib functions (Speedhacks.IopHle).
+extern u32 g_iopHleCalls;
+
 extern void Hle_SetElfPath(const char* elfFileName);
 
 #endif /* __PSXBIOS_H__ */
@@ -948,7 +948,9 @@ void gteRTPT() {
 	SSZ = (_v0) * mx##31 + (_v1) * mx##32 + (_v2) * mx##33; \
 }
 
-void gteMVMVA() {
+// mxv (matrix and vector) and cv (translation) are the opcode fields, constants when
+// called from the gteMVMVA_op variants.
+static __fi void MVMVA(u32 mxv, u32 cv) {
 	//	double SSX, SSY, SSZ;
 	s64 SSX, SSY, SSZ;
 
@@ -956,7 +958,7 @@ void gteMVMVA() {
 	GTE_LOG("GTE_MVMVA %lx\n", psxRegs.code & 0x1ffffff);
 #endif
 
-	switch (psxRegs.code & 0x78000) {
+	switch (mxv) {
 	case 0x00000: // V0 * R
 		_MVMVA_FUNC(gteVX0, gteVY0, gteVZ0, gteR); break;
 	case 0x08000: // V1 * R
@@ -991,7 +993,7 @@ void gteMVMVA() {
 		SSX >>= 12; SSY >>= 12; SSZ >>= 12;
 	}
 
-	switch (psxRegs.code & 0x6000) {
+	switch (cv) {
 	case 0x0000: // Add TR
 		SSX += gteTRX;
 		SSY += gteTRY;
@@ -1026,6 +1028,32 @@ void gteMVMVA() {
 		SUM_FLAG;
 }
 
+void gteMVMVA() {
+	MVMVA(psxRegs.code & 0x78000, psxRegs.code & 0x6000);
+}
+
+template< u32 mxv, u32 cv >
+static void gteMVMVA_op() {
+	MVMVA(mxv, cv);
+}
+
+#define MVMVA_OPS(mx) { \
+	gteMVMVA_op<(mx) << 15, 0x0000>, gteMVMVA_op<(mx) << 15, 0x2000>, \
+	gteMVMVA_op<(mx) << 15, 0x4000>, gteMVMVA_op<(mx) << 15, 0x6000> }
+
+static void (* const gteMVMVA_ops[16][4])() = {
+	MVMVA_OPS(0), MVMVA_OPS(1), MVMVA_OPS(2), MVMVA_OPS(3),
+	MVMVA_OPS(4), MVMVA_OPS(5), MVMVA_OPS(6), MVMVA_OPS(7),
+	MVMVA_OPS(8), MVMVA_OPS(9), MVMVA_OPS(10), MVMVA_OPS(11),
+	MVMVA_OPS(12), MVMVA_OPS(13), MVMVA_OPS(14), MVMVA_OPS(15),
+};
+
+#undef MVMVA_OPS
+
+void (*gteMVMVA_Get(u32 code))() {
+	return gteMVMVA_ops[(code >> 15) & 15][(code >> 13) & 3];
+}
+
 void gteNCLIP() {
 #ifdef GTE_DUMP
 	static int sample = 0; sample++;
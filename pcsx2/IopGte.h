@@ -47,4 +47,8 @@ void gteGPF();
 void gteGPL();
 void gteNCCT();
 
+// MVMVA with the matrix, vector and translation of the opcode decoded ahead, for the
+// recompiler (sf and lm are still read from psxRegs.code)
+void (*gteMVMVA_Get(u32 code))();
+
 #endif /* __GTE_H__ */
\ No newline at end of file
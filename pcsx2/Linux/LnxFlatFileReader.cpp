@@ -16,6 +16,210 @@
 #include "PrecompiledHeader.h"
 #include "AsyncFileReader.h"
 
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#if defined(__has_include)
+#	if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#		include <linux/io_uring.h>
+#		define PCSX2_IO_URING
+#	endif
+#endif
+
+// --------------------------------------------------------------------------------------
+//  FlatFileReader::UringContext
+// --------------------------------------------------------------------------------------
+// Minimal io_uring wrapper (raw syscalls, so no liburing dependency). A read is split
+// into up to 'depth' requests that are all in flight at once, which hides most of the
+// per request latency of network mounted isos. The read buffer given to SetReadBuffer
+// (InputIsoFile's whole read ahead arena) is registered with the kernel once and read with
+// READ_FIXED, anything outside of it uses plain READV.
+struct FlatFileReader::UringContext
+{
+#ifdef PCSX2_IO_URING
+	int ring_fd;
+	uint depth;
+
+	void* sq_ptr;
+	size_t sq_size;
+	void* cq_ptr;
+	size_t cq_size;
+	io_uring_sqe* sqes;
+	size_t sqes_size;
+
+	u32* sq_head;
+	u32* sq_tail;
+	u32* sq_mask;
+	u32* sq_array;
+	u32* cq_head;
+	u32* cq_tail;
+	u32* cq_mask;
+	io_uring_cqe* cqes;
+
+	std::unique_ptr<iovec[]> iovecs;
+	iovec fixed;
+	bool fixed_registered;
+
+	uint inflight;
+	int result;
+
+	UringContext()
+		: ring_fd(-1), depth(0)
+		, sq_ptr(MAP_FAILED), sq_size(0), cq_ptr(MAP_FAILED), cq_size(0)
+		, sqes((io_uring_sqe*)MAP_FAILED), sqes_size(0)
+		, fixed_registered(false), inflight(0), result(1)
+	{
+		fixed.iov_base = nullptr;
+		fixed.iov_len = 0;
+	}
+
+	~UringContext()
+	{
+		Wait();
+		Unregister();
+
+		if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+		if (cq_ptr != MAP_FAILED) munmap(cq_ptr, cq_size);
+		if (sq_ptr != MAP_FAILED) munmap(sq_ptr, sq_size);
+		if (ring_fd != -1) close(ring_fd);
+	}
+
+	bool Init(uint entries)
+	{
+		io_uring_params p;
+		memzero(p);
+
+		ring_fd = syscall(__NR_io_uring_setup, entries, &p);
+		if (ring_fd < 0) {
+			ring_fd = -1;
+			return false;
+		}
+
+		depth = std::min(entries, p.sq_entries);
+
+		sq_size = p.sq_off.array + p.sq_entries * sizeof(u32);
+		cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+		sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+
+		sq_ptr = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+		cq_ptr = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+		sqes = (io_uring_sqe*)mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+
+		if (sq_ptr == MAP_FAILED || cq_ptr == MAP_FAILED || sqes == MAP_FAILED)
+			return false;
+
+		u8* sq = (u8*)sq_ptr;
+		sq_head  = (u32*)(sq + p.sq_off.head);
+		sq_tail  = (u32*)(sq + p.sq_off.tail);
+		sq_mask  = (u32*)(sq + p.sq_off.ring_mask);
+		sq_array = (u32*)(sq + p.sq_off.array);
+
+		u8* cq = (u8*)cq_ptr;
+		cq_head = (u32*)(cq + p.cq_off.head);
+		cq_tail = (u32*)(cq + p.cq_off.tail);
+		cq_mask = (u32*)(cq + p.cq_off.ring_mask);
+		cqes    = (io_uring_cqe*)(cq + p.cq_off.cqes);
+
+		iovecs = std::unique_ptr<iovec[]>(new iovec[depth]);
+
+		return true;
+	}
+
+	// Nothing may be in flight (see Wait)
+	void Register(void* buffer, size_t size)
+	{
+		// Failure (typically RLIMIT_MEMLOCK) is fine, we just keep using plain reads
+		Unregister();
+
+		fixed.iov_base = buffer;
+		fixed.iov_len = size;
+		fixed_registered = syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, &fixed, 1) == 0;
+	}
+
+	void Unregister()
+	{
+		if (fixed_registered)
+			syscall(__NR_io_uring_register, ring_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+
+		fixed_registered = false;
+		fixed.iov_base = nullptr;
+		fixed.iov_len = 0;
+	}
+
+	void Queue(int fd, void* buffer, u32 size, u64 offset)
+	{
+		u32 tail = *sq_tail;
+		u32 index = tail & *sq_mask;
+
+		io_uring_sqe* sqe = &sqes[index];
+		memzero(*sqe);
+
+		sqe->fd = fd;
+		sqe->off = offset;
+		sqe->user_data = inflight;
+
+		if (fixed_registered && buffer >= fixed.iov_base && (u8*)buffer + size <= (u8*)fixed.iov_base + fixed.iov_len) {
+			sqe->opcode = IORING_OP_READ_FIXED;
+			sqe->addr = (uptr)buffer;
+			sqe->len = size;
+			sqe->buf_index = 0;
+		} else {
+			iovecs[inflight].iov_base = buffer;
+			iovecs[inflight].iov_len = size;
+
+			sqe->opcode = IORING_OP_READV;
+			sqe->addr = (uptr)&iovecs[inflight];
+			sqe->len = 1;
+		}
+
+		sq_array[index] = index;
+		__atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+		inflight++;
+	}
+
+	void Submit(uint count)
+	{
+		result = 1;
+
+		if (syscall(__NR_io_uring_enter, ring_fd, count, 0, 0, nullptr, 0) < 0) {
+			// Nothing got queued, pretend the requests completed with an error
+			*sq_tail = *sq_head;
+			inflight = 0;
+			result = -1;
+		}
+	}
+
+	int Wait()
+	{
+		while (inflight > 0)
+		{
+			u32 head = *cq_head;
+
+			if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+				// Also pushes anything a short submit left behind
+				u32 pending = *sq_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+
+				if (syscall(__NR_io_uring_enter, ring_fd, pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+					inflight = 0;
+					result = -1;
+				}
+				continue;
+			}
+
+			if (cqes[head & *cq_mask].res < 0)
+				result = -1;
+
+			__atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+			inflight--;
+		}
+
+		return result;
+	}
+#endif
+};
+
 FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite)
 {
 	m_blocksize = 2048;
@@ -32,8 +236,23 @@ bool FlatFileReader::Open(const wxString& fileName)
 {
 	m_filename = fileName;
 
-	int err = io_setup(64, &m_aio_context);
-	if (err) return false;
+#ifdef PCSX2_IO_URING
+	uint depth = std::min(std::max(EmuConfig.CdvdReadQueueDepth, 0), 64);
+
+	if (depth > 0) {
+		m_uring = std::unique_ptr<UringContext>(new UringContext());
+
+		if (!m_uring->Init(depth)) {
+			m_uring = nullptr;
+			Console.WriteLn("io_uring is not available, using libaio for %s", WX_STR(fileName));
+		}
+	}
+#endif
+
+	if (!m_uring) {
+		int err = io_setup(64, &m_aio_context);
+		if (err) return false;
+	}
 
     m_fd = wxOpen(fileName, O_RDONLY, 0);
 
@@ -53,6 +272,25 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 	u32 bytesToRead = count * m_blocksize;
 
+#ifdef PCSX2_IO_URING
+	if (m_uring) {
+		// A previous read was cancelled, let it land before reusing the buffers
+		m_uring->Wait();
+
+		uint chunk = std::max((count + m_uring->depth - 1) / m_uring->depth, 16u);
+		uint queued = 0;
+
+		for (uint i = 0; i < count; i += chunk) {
+			uint n = std::min(chunk, count - i);
+			m_uring->Queue(m_fd, (u8*)pBuffer + i * m_blocksize, n * m_blocksize, offset + i * (u64)m_blocksize);
+			queued++;
+		}
+
+		m_uring->Submit(queued);
+		return;
+	}
+#endif
+
 	struct iocb iocb;
 	struct iocb* iocbs = &iocb;
 
@@ -62,6 +300,11 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 int FlatFileReader::FinishRead(void)
 {
+#ifdef PCSX2_IO_URING
+	if (m_uring)
+		return m_uring->Wait();
+#endif
+
 	int min_nr = 1;
 	int max_nr = 1;
 	struct io_event events[max_nr];
@@ -82,12 +325,25 @@ void FlatFileReader::CancelRead(void)
 	//                struct io_event *result);
 }
 
+void FlatFileReader::SetReadBuffer(void* buffer, size_t size)
+{
+#ifdef PCSX2_IO_URING
+	if (m_uring) {
+		m_uring->Wait();
+		m_uring->Register(buffer, size);
+	}
+#endif
+}
+
 void FlatFileReader::Close(void)
 {
 
+	// Drains anything still in flight and unregisters the read buffer before the file goes away
+	m_uring = nullptr;
+
 	if (m_fd != -1) close(m_fd);
 
-	io_destroy(m_aio_context);
+	if (m_aio_context) io_destroy(m_aio_context);
 
 	m_fd = -1;
 	m_aio_context = 0;
@@ -0,0 +1,199 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2014  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "AsyncFileReader.h"
+
+#include <sys/mman.h>
+#include <sys/vfs.h>
+
+// f_type of the filesystems we don't want to map (see statfs(2))
+static bool IsNetworkFilesystem(int fd)
+{
+	struct statfs fs;
+	if (fstatfs(fd, &fs) != 0)
+		return true;
+
+	switch ((u32)fs.f_type)
+	{
+		case 0x6969:		// NFS
+		case 0x517B:		// SMB
+		case 0xFF534D42:	// CIFS
+		case 0xFE534D42:	// SMB2
+		case 0x65735546:	// FUSE (sshfs & co)
+			return true;
+	}
+
+	return false;
+}
+
+MappedFileReader::MappedFileReader()
+{
+	m_blocksize = 2048;
+	m_fd = -1;
+	m_filesize = 0;
+	m_view = NULL;
+	m_view_offset = 0;
+	m_view_size = 0;
+	m_advised = 0;
+	m_bytesRead = 0;
+}
+
+MappedFileReader::~MappedFileReader(void)
+{
+	Close();
+}
+
+bool MappedFileReader::Open(const wxString& fileName)
+{
+	Close();
+	m_filename = fileName;
+
+	m_fd = wxOpen(fileName, O_RDONLY, 0);
+	if (m_fd == -1)
+		return false;
+
+	struct stat st;
+	if (fstat(m_fd, &st) != 0 || st.st_size == 0 || IsNetworkFilesystem(m_fd)) {
+		Close();
+		return false;
+	}
+
+	m_filesize = st.st_size;
+
+	if (!MapView(0, std::min(m_filesize, (u64)ViewSize))) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+// Maps the view holding [offset, offset + size). Views start on 2mb boundaries so the
+// common small reads all land in the same one.
+bool MappedFileReader::MapView(u64 offset, u64 size)
+{
+	u64 start = offset & ~(u64)(_1mb * 2 - 1);
+	u64 length = std::min(std::max((u64)ViewSize, offset + size - start), m_filesize - start);
+
+	if (m_view)
+		munmap(m_view, m_view_size);
+
+	m_view = (u8*)mmap(NULL, length, PROT_READ, MAP_SHARED, m_fd, start);
+
+	if (m_view == MAP_FAILED) {
+		m_view = NULL;
+		m_view_size = 0;
+		return false;
+	}
+
+	m_view_offset = start;
+	m_view_size = length;
+	m_advised = start;
+
+	madvise(m_view, m_view_size, MADV_SEQUENTIAL);
+
+	return true;
+}
+
+const u8* MappedFileReader::GetSectorPointer(uint sector, uint count)
+{
+	u64 offset = sector * (u64)m_blocksize + m_dataoffset;
+	u64 size = count * (u64)m_blocksize;
+
+	if (offset + size > m_filesize)
+		return NULL;
+
+	if (offset < m_view_offset || offset + size > m_view_offset + m_view_size) {
+		if (!MapView(offset, size))
+			return NULL;
+	}
+
+	// Ask for the next few mb before the drive gets there, so streaming doesn't page fault
+	u64 end = offset + size;
+	if (end + ReadAheadSize / 2 > m_advised && m_advised < m_view_offset + m_view_size) {
+		// madvise wants a page aligned start, the view starts on a page boundary
+		u64 from = std::max(m_advised, end) & ~(u64)4095;
+		u64 to = std::min(end + ReadAheadSize, m_view_offset + m_view_size);
+
+		if (to > from) {
+			int ret = madvise(m_view + (from - m_view_offset), to - from, MADV_WILLNEED);
+			pxAssertMsg(ret == 0, L"MappedFileReader: madvise(MADV_WILLNEED) failed");
+		}
+
+		m_advised = to;
+	}
+
+	return m_view + (offset - m_view_offset);
+}
+
+int MappedFileReader::ReadSync(void* pBuffer, uint sector, uint count)
+{
+	const u8* src = GetSectorPointer(sector, count);
+
+	if (!src) {
+		// A partial read at the end of the file
+		u64 offset = sector * (u64)m_blocksize + m_dataoffset;
+		if (offset >= m_filesize)
+			return -1;
+
+		uint available = (m_filesize - offset) / m_blocksize;
+		if (!available || !(src = GetSectorPointer(sector, available)))
+			return -1;
+
+		count = available;
+	}
+
+	memcpy(pBuffer, src, count * m_blocksize);
+	return 1;
+}
+
+void MappedFileReader::BeginRead(void* pBuffer, uint sector, uint count)
+{
+	// Nothing to wait for, the data is either in the page cache or faulted in right here
+	m_bytesRead = ReadSync(pBuffer, sector, count);
+}
+
+int MappedFileReader::FinishRead(void)
+{
+	int res = m_bytesRead;
+	m_bytesRead = -1;
+	return res;
+}
+
+void MappedFileReader::CancelRead(void)
+{
+}
+
+void MappedFileReader::Close(void)
+{
+	if (m_view)
+		munmap(m_view, m_view_size);
+
+	if (m_fd != -1)
+		close(m_fd);
+
+	m_fd = -1;
+	m_filesize = 0;
+	m_view = NULL;
+	m_view_offset = 0;
+	m_view_size = 0;
+	m_advised = 0;
+}
+
+uint MappedFileReader::GetBlockCount(void) const
+{
+	return (int)(m_filesize / m_blocksize);
+}
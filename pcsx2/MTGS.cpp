@@ -20,9 +20,13 @@
 #include <wx/datetime.h>
 
 #include "GS.h"
+#include "Counters.h"
 #include "Gif_Unit.h"
 #include "MTVU.h"
 #include "Elfheader.h"
+#include "RunAhead.h"
+
+#include "Utilities/Instrumentation.h"
 
 
 // Uncomment this to enable profiling of the GS RingBufferCopy function.
@@ -41,6 +45,8 @@ using namespace Threading;
 // =====================================================================================================
 
 __aligned(32) MTGS_BufferedData RingBuffer;
+uint RingBufferSize = 1 << RingBufferSizeFactor;
+uint RingBufferMask = RingBufferSize - 1;
 extern bool renderswitch;
 
 
@@ -51,11 +57,16 @@ std::list<uint> ringposStack;
 
 SysMtgsThread::SysMtgsThread() :
 	SysThreadBase()
+,	m_RingReserve( L"MTGS Ringbuffer", RingBufferMaxSize * sizeof(u128) )
 #ifdef RINGBUF_DEBUG_STACK
 ,	m_lock_Stack()
 #endif
 {
 	m_name = L"MTGS";
+	m_ReadPos = 0;
+	m_WritePos = 0;
+	m_RingCommitted = 0;
+	m_RingHighWater = 0;
 
 	// All other state vars are initialized by OnStart().
 }
@@ -72,14 +83,100 @@ void SysMtgsThread::OnStart()
 
 	m_QueuedFrameCount    = 0;
 	m_VsyncSignalListener = false;
+	m_VsyncQueueLimit     = std::min(std::max(EmuConfig.GS.VsyncQueueSize, VsyncQueueAdaptiveMin), VsyncQueueAdaptiveMax);
+	memzero(m_vsyncQueue);
 	m_SignalRingEnable    = false;
 	m_SignalRingPosition  = 0;
 
 	m_CopyDataTally		= 0;
+	m_pendingGSPacket.valid = false;
+
+	ResetStats();
+	ReserveRing();
+	ResizeRing( EmuConfig.GS.RingSizeFactor );
 
 	_parent::OnStart();
 }
 
+// Reserves the virtual memory of the ringbuffer; OnStart commits the configured size.
+void SysMtgsThread::ReserveRing()
+{
+	if (m_RingReserve.IsOk()) return;
+
+	if (!m_RingReserve.ReserveAt( HostMemoryMap::MTGSring ))
+	{
+		throw Exception::OutOfMemory( m_RingReserve.GetName() )
+			.SetDiagMsg(L"MTGS ringbuffer could not be reserved.");
+	}
+
+	RingBuffer.m_Ring = (u128*)m_RingReserve.GetPtr();
+}
+
+// Sets the size of the ringbuffer, committing more of the reserve when it grows.
+// The ring must be empty: both positions are moved back to the start of the buffer.
+void SysMtgsThread::ResizeRing( uint factor )
+{
+	pxAssert( m_ReadPos.load() == m_WritePos.load() );
+
+	factor = std::min(std::max(factor, RingBufferSizeFactorMin), RingBufferSizeFactorMax);
+	const uint size = 1 << factor;
+
+	if (size > m_RingCommitted)
+	{
+		u8* start = m_RingReserve.GetPtr() + m_RingCommitted * sizeof(u128);
+		if (!HostSys::MmapCommitPtr( start, (size - m_RingCommitted) * sizeof(u128), PageAccess_ReadWrite() ))
+		{
+			if (!m_RingCommitted)
+				throw Exception::OutOfMemory( m_RingReserve.GetName() )
+					.SetDiagMsg(L"MTGS ringbuffer could not be committed.");
+
+			Console.Warning( "MTGS: could not commit a %ukb ringbuffer, keeping %ukb", size / 64, RingBufferSize / 64 );
+			return;
+		}
+		m_RingCommitted = size;
+	}
+
+	if (size != RingBufferSize)
+		DevCon.WriteLn( "MTGS: ringbuffer resized to %ukb", size / 64 );
+
+	m_ReadPos  = 0;
+	m_WritePos = 0;
+	RingBufferSize = size;
+	RingBufferMask = size - 1;
+	m_RingHighWater = 0;
+}
+
+void SysMtgsThread::ResetStats()
+{
+	m_stats.ee_spins  = 0;
+	m_stats.ee_sleeps = 0;
+	m_stats.gs_spins  = 0;
+	m_stats.gs_sleeps = 0;
+	m_stats.kicks     = 0;
+	m_stats.gs_packets  = 0;
+	m_stats.gs_commands = 0;
+	m_stats.vsync_stalls = 0;
+	m_stats.queue_raises = 0;
+	m_stats.queue_drops  = 0;
+}
+
+void SysMtgsThread::DumpStats()
+{
+	DevCon.WriteLn( "MTGS: ring stats: EE stalls %u spin / %u sleep, GS waits %u spin / %u sleep, %u kicks",
+		m_stats.ee_spins.load(), m_stats.ee_sleeps.load(),
+		m_stats.gs_spins.load(), m_stats.gs_sleeps.load(), m_stats.kicks.load() );
+	DevCon.WriteLn( "MTGS: %u GIF packets sent as %u ring commands",
+		m_stats.gs_packets.load(), m_stats.gs_commands.load() );
+	DevCon.WriteLn( "MTGS: ring high-water mark %ukb of %ukb", m_RingHighWater / 64, RingBufferSize / 64 );
+	if (EmuConfig.GS.VsyncQueueAdaptive)
+		DevCon.WriteLn( "MTGS: %u vsync stalls, adaptive queue at %d frames (%u raises, %u drops)",
+			m_stats.vsync_stalls.load(), m_VsyncQueueLimit.load(), m_stats.queue_raises.load(), m_stats.queue_drops.load() );
+	else
+		DevCon.WriteLn( "MTGS: %u vsync stalls", m_stats.vsync_stalls.load() );
+
+	ResetStats();
+}
+
 SysMtgsThread::~SysMtgsThread()
 {
 	try {
@@ -127,8 +224,16 @@ void SysMtgsThread::PostVsyncStart()
 	// 256-byte copy is only a few dozen cycles -- executed 60 times a second -- so probably
 	// not worth the effort or overhead of trying to selectively avoid it.
 
+	if (Instrumentation::IsEnabled())
+	{
+		const uint queued = (m_WritePos.load(std::memory_order_relaxed) - m_ReadPos.load(std::memory_order_relaxed)) & RingBufferMask;
+		Instrumentation::Add(Instrumentation::Counter_MTGSQueueBytes, queued * 16);
+	}
+
 	uint packsize = sizeof(RingCmdPacket_Vsync) / 16;
 	PrepDataPacket(GS_RINGTYPE_VSYNC, packsize);
+	((PacketTagType&)RingBuffer[m_packet_startpos]).data[1] = inputLatencyVsync();
+	((PacketTagType&)RingBuffer[m_packet_startpos]).data[2] = RunAhead::IsFrameShown();
 	MemCopy_WrappedDest( (u128*)PS2MEM_GS, RingBuffer.m_Ring, m_packet_writepos, RingBufferSize, 0xf );
 
 	u32* remainder = (u32*)GetDataPacketPtr();
@@ -153,8 +258,10 @@ void SysMtgsThread::PostVsyncStart()
 	// If those are needed back, it's better to increase the VsyncQueueSize via PCSX_vm.ini.
 	// (The Xenosaga engine is known to run into this, due to it throwing bulks of data in one frame followed by 2 empty frames.)
 
-	if ((m_QueuedFrameCount.fetch_add(1) < EmuConfig.GS.VsyncQueueSize) /*|| (!EmuConfig.GS.VsyncEnable && !EmuConfig.GS.FrameLimitEnable)*/) return;
+	const int limit = EmuConfig.GS.VsyncQueueAdaptive ? m_VsyncQueueLimit.load(std::memory_order_relaxed) : EmuConfig.GS.VsyncQueueSize;
+	if ((m_QueuedFrameCount.fetch_add(1) < limit) /*|| (!EmuConfig.GS.VsyncEnable && !EmuConfig.GS.FrameLimitEnable)*/) return;
 
+	m_stats.vsync_stalls.fetch_add(1, std::memory_order_relaxed);
 	m_VsyncSignalListener.store(true, std::memory_order_release);
 	//Console.WriteLn( Color_Blue, "(EEcore Sleep) Vsync\t\tringpos=0x%06x, writepos=0x%06x", m_ReadPos.load(), m_WritePos.load() );
 
@@ -197,8 +304,9 @@ void SysMtgsThread::OpenPlugin()
 
 	int result;
 
+	// No GS window was opened for the plugin when running headless
 	if( GSopen2 != NULL )
-		result = GSopen2( (void*)pDsp, 1 | (renderswitch ? 4 : 0) );
+		result = GSopen2( (void*)pDsp, 1 | (renderswitch ? 4 : 0) | (pDsp[0] ? 0 : 8) );
 	else
 		result = GSopen( (void*)pDsp, "PCSX2", renderswitch ? 2 : 1 );
 
@@ -271,6 +379,71 @@ class RingBufferLock {
 	}
 };
 
+// Spin a little on an empty ring before going to sleep: the EE often queues the next packet
+// right after the previous one, and waking up from the semaphore costs far more.
+void SysMtgsThread::WaitForData()
+{
+	for (uint i = 0; i < RingBufferSpinCount; i++) {
+		if (m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_acquire)) {
+			m_stats.gs_spins.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		SpinWait();
+	}
+
+	m_stats.gs_sleeps.fetch_add(1, std::memory_order_relaxed);
+
+	const u64 start = GetCPUTicks();
+	m_sem_event.WaitWithoutYield();
+	m_vsyncQueue.idle += GetCPUTicks() - start;
+}
+
+// Retunes the vsync queue limit once the GS is done with a frame.  A frame that keeps the
+// MTGS busy for much longer than usual (shader compilation, texture uploads, a slow present)
+// is what stalls the EE with a short queue, so the queue grows to absorb the next one; once
+// the frame times settle again, it shrinks back to keep the input latency down.
+void SysMtgsThread::UpdateVsyncQueue()
+{
+	if (!EmuConfig.GS.VsyncQueueAdaptive) return;
+
+	VsyncQueueState& q = m_vsyncQueue;
+	const u64 now = GetCPUTicks();
+	const u64 elapsed = now - q.frame_start;
+	const bool valid = q.frame_start && elapsed >= q.idle;
+	const u64 busy = valid ? elapsed - q.idle : 0;
+
+	q.frame_start = now;
+	q.idle = 0;
+
+	if (!valid) return;
+
+	if (!q.average) q.average = busy;
+
+	// Spikes: half again the usual time, and at least a millisecond more
+	const bool spike = busy > q.average + q.average / 2 && busy - q.average > GetTickFrequency() / 1000;
+	int limit = m_VsyncQueueLimit.load(std::memory_order_relaxed);
+
+	if (spike) {
+		q.calm = 0;
+		if (limit < VsyncQueueAdaptiveMax) {
+			m_VsyncQueueLimit.store(++limit, std::memory_order_relaxed);
+			m_stats.queue_raises.fetch_add(1, std::memory_order_relaxed);
+			DevCon.WriteLn( "MTGS: spiky frame (%.1f ms, usually %.1f ms), vsync queue raised to %d",
+				busy * 1000.0 / GetTickFrequency(), q.average * 1000.0 / GetTickFrequency(), limit );
+		}
+	} else if (++q.calm >= VsyncQueueCalmFrames) {
+		q.calm = 0;
+		if (limit > VsyncQueueAdaptiveMin) {
+			m_VsyncQueueLimit.store(--limit, std::memory_order_relaxed);
+			m_stats.queue_drops.fetch_add(1, std::memory_order_relaxed);
+			DevCon.WriteLn( "MTGS: calm frames, vsync queue lowered to %d", limit );
+		}
+	}
+
+	// Spikes move the average slowly, so that a stretch of them keeps counting as spikes
+	q.average = (q.average * 15 + busy) / 16;
+}
+
 void SysMtgsThread::ExecuteTaskInThread()
 {
 	// Threading info: run in MTGS thread
@@ -289,7 +462,7 @@ void SysMtgsThread::ExecuteTaskInThread()
 		// is very optimized (only 1 instruction test in most cases), so no point in trying
 		// to avoid it.
 
-		m_sem_event.WaitWithoutYield();
+		WaitForData();
 		StateCheckInThread();
 		busy.Acquire();
 
@@ -430,7 +603,7 @@ void SysMtgsThread::ExecuteTaskInThread()
 							const int qsize = tag.data[0];
 							ringposinc += qsize;
 
-							MTGS_LOG( "(MTGS Packet Read) ringtype=Vsync, field=%u, skip=%s", !!(((u32&)RingBuffer.Regs[0x1000]) & 0x2000) ? 0 : 1, tag.data[1] ? "true" : "false" );
+							MTGS_LOG( "(MTGS Packet Read) ringtype=Vsync, field=%u, serial=%u", !!(((u32&)RingBuffer.Regs[0x1000]) & 0x2000) ? 0 : 1, tag.data[1] );
 
 							// Mail in the important GS registers.
 							// This seemingly obtuse system is needed in order to handle cases where the vsync data wraps
@@ -444,8 +617,12 @@ void SysMtgsThread::ExecuteTaskInThread()
 							((u32&)RingBuffer.Regs[0x1010])				= remainder[1];
 							((GSRegSIGBLID&)RingBuffer.Regs[0x1080])	= (GSRegSIGBLID&)remainder[2];
 
-							// CSR & 0x2000; is the pageflip id.
-							GSvsync(((u32&)RingBuffer.Regs[0x1000]) & 0x2000);
+							// CSR & 0x2000; is the pageflip id.  Frames hidden by the run-ahead are
+							// still drawn, just not presented.
+							if (tag.data[2])
+								GSvsync(((u32&)RingBuffer.Regs[0x1000]) & 0x2000);
+							inputLatencyPresent(tag.data[1]);
+							UpdateVsyncQueue();
 							gsFrameSkip();
 
 							// if we're not using GSOpen2, then the GS window is on this thread (MTGS thread),
@@ -472,7 +649,7 @@ void SysMtgsThread::ExecuteTaskInThread()
 						{
 							MTGS_FreezeData* data = (MTGS_FreezeData*)tag.pointer;
 							int mode = tag.data[0];
-							data->retval = GetCorePlugins().DoFreeze( PluginId_GS, mode, data->fdata );
+							GetCorePlugins().DoFreeze( PluginId_GS, mode, data->fdata, &data->retval );
 						}
 						break;
 
@@ -569,6 +746,7 @@ void SysMtgsThread::ClosePlugin()
 {
 	if( !m_PluginOpened ) return;
 	m_PluginOpened = false;
+	DumpStats();
 	GetCorePlugins().Close( PluginId_GS );
 }
 
@@ -580,9 +758,17 @@ void SysMtgsThread::OnSuspendInThread()
 
 void SysMtgsThread::OnResumeInThread( bool isSuspended )
 {
+	// The size setting can be changed on the fly (GameDB, ini). The EE is blocked in
+	// WaitForOpen, so the ring can safely be resized if it was left empty.
+	if( isSuspended && m_ReadPos.load(std::memory_order_relaxed) == m_WritePos.load(std::memory_order_acquire) )
+		ResizeRing( EmuConfig.GS.RingSizeFactor );
+
 	if( isSuspended )
 		OpenPlugin();
 
+	// The time spent suspended isn't a GS frame
+	m_vsyncQueue.frame_start = 0;
+
 	_parent::OnResumeInThread( isSuspended );
 }
 
@@ -603,6 +789,9 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 	if( m_ExecMode == ExecMode_NoThreadYet || !IsRunning() ) return;
 	if( !pxAssertDev( IsOpen(), "MTGS Warning!  WaitGS issued on a closed thread." ) ) return;
 
+	// The MTVU thread never touches the ring; a pending packet belongs to the EE thread.
+	if (!isMTVU) FlushGSPacket();
+
 	Gif_Path&   path = gifUnit.gifPath[GIF_PATH_1];
 	u32 startP1Packs = weakWait ? path.GetPendingGSPackets() : 0;
 
@@ -610,6 +799,7 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 	// we don't want to access the content of the queue
 
 	if (isMTVU || m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_relaxed)) {
+		Instrumentation::ScopedTimer stallTimer(Instrumentation::Counter_MTGSStall);
 		SetEvent();
 		RethrowException();
 		for(;;) {
@@ -639,8 +829,10 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 // For use in loops that wait on the GS thread to do certain things.
 void SysMtgsThread::SetEvent()
 {
-	if(!m_RingBufferIsBusy.load(std::memory_order_relaxed))
+	if(!m_RingBufferIsBusy.load(std::memory_order_relaxed)) {
+		m_stats.kicks.fetch_add(1, std::memory_order_relaxed);
 		m_sem_event.Post();
+	}
 
 	m_CopyDataTally = 0;
 }
@@ -672,7 +864,7 @@ void SysMtgsThread::SendDataPacket()
 	else if(!m_RingBufferIsBusy.load(std::memory_order_relaxed))
 	{
 		m_CopyDataTally += m_packet_size;
-		if( m_CopyDataTally > 0x2000 ) SetEvent();
+		if( m_CopyDataTally > (int)RingBufferKickThreshold ) SetEvent();
 	}
 
 	m_packet_size = 0;
@@ -680,6 +872,17 @@ void SysMtgsThread::SendDataPacket()
 	//m_PacketLocker.Release();
 }
 
+// Returns the amount of room left between the given write position and the MTGS read position.
+__fi uint SysMtgsThread::GetFreeRoom( uint writepos ) const
+{
+	uint readpos = m_ReadPos.load(std::memory_order_acquire);
+
+	if (writepos < readpos)
+		return readpos - writepos;
+	else
+		return RingBufferSize - (writepos - readpos);
+}
+
 void SysMtgsThread::GenericStall( uint size )
 {
 	// Note on volatiles: m_WritePos is not modified by the GS thread, so there's no need
@@ -696,16 +899,15 @@ void SysMtgsThread::GenericStall( uint size )
 	// But if not then we need to make sure the readpos is outside the scope of
 	// the block about to be written (writepos + size)
 
-	uint readpos = m_ReadPos.load(std::memory_order_acquire);
-	uint freeroom;
+	uint freeroom = GetFreeRoom(writepos);
 
-	if (writepos < readpos)
-		freeroom = readpos - writepos;
-	else
-		freeroom = RingBufferSize - (writepos - readpos);
+	if (RingBufferSize - freeroom > m_RingHighWater)
+		m_RingHighWater = RingBufferSize - freeroom;
 
 	if (freeroom <= size)
 	{
+		Instrumentation::ScopedTimer stallTimer(Instrumentation::Counter_MTGSStall);
+
 		// writepos will overlap readpos if we commit the data, so we need to wait until
 		// readpos is out past the end of the future write pos, or until it wraps around
 		// (in which case writepos will be >= readpos).
@@ -723,8 +925,24 @@ void SysMtgsThread::GenericStall( uint size )
 
 		if( somedone > 0x80 )
 		{
+			// Adaptive wait: the MTGS may already be close to the target, so spin a bit
+			// before paying for the semaphore round trip.
+			const uint target = std::min(freeroom + somedone, RingBufferSize);
+
+			SetEvent();
+			for (uint i = 0; i < RingBufferSpinCount; i++) {
+				SpinWait();
+				freeroom = GetFreeRoom(writepos);
+				if (freeroom >= target) {
+					m_stats.ee_spins.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			}
+
+			m_stats.ee_sleeps.fetch_add(1, std::memory_order_relaxed);
+
 			pxAssertDev( m_SignalRingEnable == 0, "MTGS Thread Synchronization Error" );
-			m_SignalRingPosition.store(somedone, std::memory_order_release);
+			m_SignalRingPosition.store(target - freeroom, std::memory_order_release);
 
 			//Console.WriteLn( Color_Blue, "(EEcore Sleep) PrepDataPacker \tringpos=0x%06x, writepos=0x%06x, signalpos=0x%06x", readpos, writepos, m_SignalRingPosition );
 
@@ -732,13 +950,8 @@ void SysMtgsThread::GenericStall( uint size )
 				m_SignalRingEnable.store(true, std::memory_order_release);
 				SetEvent();
 				m_sem_OnRingReset.WaitWithoutYield();
-				readpos = m_ReadPos.load(std::memory_order_acquire);
-				//Console.WriteLn( Color_Blue, "(EEcore Awake) Report!\tringpos=0x%06x", readpos );
-
-				if (writepos < readpos)
-					freeroom = readpos - writepos;
-				else
-					freeroom = RingBufferSize - (writepos - readpos);
+				freeroom = GetFreeRoom(writepos);
+				//Console.WriteLn( Color_Blue, "(EEcore Awake) Report!\tringpos=0x%06x", m_ReadPos.load() );
 
 				if (freeroom > size) break;
 			}
@@ -748,17 +961,11 @@ void SysMtgsThread::GenericStall( uint size )
 		else
 		{
 			//Console.WriteLn( Color_StrongGray, "(EEcore Spin) PrepDataPacket!" );
+			m_stats.ee_spins.fetch_add(1, std::memory_order_relaxed);
 			SetEvent();
 			while(true) {
 				SpinWait();
-				readpos = m_ReadPos.load(std::memory_order_acquire);
-
-				if (writepos < readpos)
-					freeroom = readpos - writepos;
-				else
-					freeroom = RingBufferSize - (writepos - readpos);
-
-				if (freeroom > size) break;
+				if (GetFreeRoom(writepos) > size) break;
 			}
 		}
 	}
@@ -766,6 +973,8 @@ void SysMtgsThread::GenericStall( uint size )
 
 void SysMtgsThread::PrepDataPacket( MTGS_RingCommand cmd, u32 size )
 {
+	FlushGSPacket();
+
 	m_packet_size = size;
 	++size;			// takes into account our RingCommand QWC.
 	GenericStall(size);
@@ -809,6 +1018,8 @@ void SysMtgsThread::SendSimplePacket( MTGS_RingCommand type, int data0, int data
 {
 	//ScopedLock locker( m_PacketLocker );
 
+	FlushGSPacket();
+
 	GenericStall(1);
 	PacketTagType& tag = (PacketTagType&)RingBuffer[m_WritePos.load(std::memory_order_relaxed)];
 
@@ -820,22 +1031,68 @@ void SysMtgsThread::SendSimplePacket( MTGS_RingCommand type, int data0, int data
 	_FinishSimplePacket();
 }
 
-void SysMtgsThread::SendSimpleGSPacket(MTGS_RingCommand type, u32 offset, u32 size, GIF_PATH path)
+// Sends the packet held back by SendSimpleGSPacket, if any.  Every other ring write goes
+// through here first, so that commands keep their order.
+void SysMtgsThread::FlushGSPacket()
 {
-	SendSimplePacket(type, (int)offset, (int)size, (int)path);
+	PendingGSPacket& pend = m_pendingGSPacket;
+	if (!pend.valid) return;
+
+	pend.valid = false;
+	m_stats.gs_commands.fetch_add(1, std::memory_order_relaxed);
+	SendSimplePacket(GS_RINGTYPE_GSPACKET, (int)pend.offset, (int)pend.size, (int)pend.path);
 
 	if(!EmuConfig.GS.SynchronousMTGS) {
 		if(!m_RingBufferIsBusy.load(std::memory_order_relaxed)) {
-			m_CopyDataTally += size / 16;
-			if (m_CopyDataTally > 0x2000) SetEvent();
+			m_CopyDataTally += pend.size / 16;
+			if (m_CopyDataTally > (int)RingBufferKickThreshold) SetEvent();
 		}
 	}
 }
 
+// Consecutive packets of a path are usually contiguous in its buffer (DMA chains and
+// XGKICK loops), and are merged into a single GSgifTransfer call.  Blank packets only
+// release buffer space and are merged with each other.
+void SysMtgsThread::SendSimpleGSPacket(MTGS_RingCommand type, u32 offset, u32 size, GIF_PATH path)
+{
+	if (type != GS_RINGTYPE_GSPACKET || EmuConfig.GS.SynchronousMTGS) {
+		if (type == GS_RINGTYPE_GSPACKET) {
+			m_stats.gs_packets.fetch_add(1, std::memory_order_relaxed);
+			m_stats.gs_commands.fetch_add(1, std::memory_order_relaxed);
+		}
+		SendSimplePacket(type, (int)offset, (int)size, (int)path);
+		return;
+	}
+
+	m_stats.gs_packets.fetch_add(1, std::memory_order_relaxed);
+
+	PendingGSPacket& pend = m_pendingGSPacket;
+	const bool blank = offset == ~0u;
+
+	if (pend.valid && pend.path == path && (blank ? pend.offset == ~0u
+		: pend.offset != ~0u && pend.offset + pend.size == offset)) {
+		pend.size += size;
+	}
+	else {
+		FlushGSPacket();
+		pend.offset = offset;
+		pend.size   = size;
+		pend.path   = path;
+		pend.valid  = true;
+	}
+
+	// Only hold the packet back while the GS thread has other work to chew on; an idle
+	// GS thread gets it right away.
+	if (m_ReadPos.load(std::memory_order_relaxed) == m_WritePos.load(std::memory_order_relaxed))
+		FlushGSPacket();
+}
+
 void SysMtgsThread::SendPointerPacket( MTGS_RingCommand type, u32 data0, void* data1 )
 {
 	//ScopedLock locker( m_PacketLocker );
 
+	FlushGSPacket();
+
 	GenericStall(1);
 	PacketTagType& tag = (PacketTagType&)RingBuffer[m_WritePos.load(std::memory_order_relaxed)];
 
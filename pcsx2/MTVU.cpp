@@ -18,8 +18,12 @@
 #include "MTVU.h"
 #include "newVif.h"
 #include "Gif_Unit.h"
+#include "Counters.h"
+
+#include "Utilities/Instrumentation.h"
 
 __aligned16 VU_Thread vu1Thread(CpuVU1, VU1);
+__aligned16 VU0_Thread vu0Thread;
 
 #define MTVU_ALWAYS_KICK 0
 #define MTVU_SYNC_MODE   0
@@ -53,11 +57,6 @@ void SaveStateBase::mtvuFreeze()
 	FreezeTag("MTVU");
 	pxAssert(vu1Thread.IsDone());
 	if (!IsSaving()) vu1Thread.Reset();
-	for (size_t i = 0; i < 4; ++i) {
-		unsigned int v = vu1Thread.vuCycles[i].load();
-		Freeze(v);
-	}
-	Freeze(vu1Thread.vuCycleIdx);
 }
 
 VU_Thread::VU_Thread(BaseVUmicroCPU*& _vuCPU, VURegs& _vuRegs) :
@@ -79,16 +78,28 @@ void VU_Thread::Reset()
 {
 	ScopedLock lock(mtxBusy);
 
-	vuCycleIdx   = 0;
 	isBusy       = false;
 	m_ato_write_pos = 0;
 	m_write_pos     = 0;
 	m_ato_read_pos  = 0;
 	m_read_pos      = 0;
+	m_ato_micro_done = 0;
+	m_micro_queued   = 0;
+	m_ato_vu_progress = 0;
+	m_vu_progress     = 0;
 	memzero(vif);
 	memzero(vifRegs);
-	for (size_t i = 0; i < 4; ++i)
-		vu1Thread.vuCycles[i] = 0;
+
+	m_unpackCopied     = 0;
+	m_unpackDirect     = 0;
+	m_unpackStatsFrame = 0;
+	m_waitCount        = 0;
+	m_waitTicks        = 0;
+	m_waitPCs.clear();
+	m_microShadowValid = false;
+	m_microSkipped     = 0;
+	m_programCount     = 0;
+	m_programCycles    = 0;
 }
 
 void VU_Thread::ExecuteTaskInThread()
@@ -116,8 +127,12 @@ void VU_Thread::ExecuteRingBuffer()
 					vuCPU->Execute(vu1RunCycles);
 					gifUnit.gifPath[GIF_PATH_1].FinishGSPacketMTVU();
 					semaXGkick.Post(); // Tell MTGS a path1 packet is complete
-					vuCycles[vuCycleIdx].store(vuRegs.cycle, std::memory_order_release);
-					vuCycleIdx  = (vuCycleIdx + 1) & 3;
+
+					// microVU counts the cycles of every block it runs into vuRegs.cycle
+					const u64 progress = m_ato_vu_progress.load(std::memory_order_relaxed);
+					const u32 programs = (u32)(progress >> 32) + 1;
+					const u32 cycles   = (u32)progress + std::min(vuRegs.cycle, 3000u);
+					m_ato_vu_progress.store(((u64)programs << 32) | cycles, std::memory_order_release);
 					break;
 				}
 				case MTVU_VU_WRITE_MICRO: {
@@ -125,6 +140,7 @@ void VU_Thread::ExecuteRingBuffer()
 					u32 size = Read();
 					vuCPU->Clear(vu_micro_addr, size);
 					Read(&vuRegs.Micro[vu_micro_addr], size);
+					m_ato_micro_done.fetch_add(1, std::memory_order_release);
 					break;
 				}
 				case MTVU_VU_WRITE_DATA: {
@@ -283,14 +299,22 @@ __fi void VU_Thread::WriteRegs(VIFregisters* src)
 	m_write_pos += size_u32(sizeof(VIFregistersMTVU));
 }
 
-// Returns Average number of vu Cycles from last 4 runs
-// Used for vu cycle stealing hack
-u32 VU_Thread::Get_vuCycles()
+// Charges the EE with the cycles of the VU1 programs finished since the last call, the way
+// the non-threaded VU1 does at the end of every program (EE cycle skip hack).  Programs still
+// in the ring are charged by a later call once the VU thread has measured them, so the EE
+// gets the same cycles as without MTVU, just a little later, and never has to wait for them.
+void VU_Thread::ChargeVUCycles()
 {
-	return (vuCycles[0].load(std::memory_order_acquire) +
-			vuCycles[1].load(std::memory_order_acquire) +
-			vuCycles[2].load(std::memory_order_acquire) +
-			vuCycles[3].load(std::memory_order_acquire)) >> 2;
+	const u64 progress = m_ato_vu_progress.load(std::memory_order_acquire);
+	if (progress == m_vu_progress) return;
+
+	const u32 programs = (u32)(progress >> 32) - (u32)(m_vu_progress >> 32);
+	const u32 cycles   = (u32)progress - (u32)m_vu_progress;
+	m_vu_progress = progress;
+
+	cpuRegs.cycle   += cycles * EmuConfig.Speedhacks.EECycleSkip;
+	m_programCount  += programs;
+	m_programCycles += cycles;
 }
 
 void VU_Thread::KickStart(bool forceKick)
@@ -304,9 +328,18 @@ bool VU_Thread::IsDone()
 	return GetReadPos() == GetWritePos();
 }
 
+bool VU_Thread::IsMicroMemSynced()
+{
+	return m_ato_micro_done.load(std::memory_order_acquire) == m_micro_queued;
+}
+
 void VU_Thread::WaitVU()
 {
 	MTVU_LOG("MTVU - WaitVU!");
+	if (IsDone()) return;
+
+	Instrumentation::ScopedTimer waitTimer(Instrumentation::Counter_MTVUWait);
+	const u64 start = GetCPUTicks();
 	for(;;) {
 		if (IsDone()) break;
 		//DevCon.WriteLn("WaitVU()");
@@ -315,6 +348,51 @@ void VU_Thread::WaitVU()
 		std::this_thread::yield(); // Give a chance to the MTVU thread to actually start
 		ScopedLock lock(mtxBusy);
 	}
+
+	m_waitCount++;
+	m_waitTicks += GetCPUTicks() - start;
+	m_waitPCs[cpuRegs.pc]++;
+}
+
+// Reports the unpack and wait statistics about once a second (60 frames).
+void VU_Thread::ReportStats()
+{
+	const uint frames = g_FrameCount - m_unpackStatsFrame;
+	if (frames < 60) return;
+
+	if (m_unpackCopied || m_unpackDirect)
+		DevCon.WriteLn("MTVU: %u KB/frame of unpack data copied to the ring, %u KB/frame unpacked in place",
+			m_unpackCopied / 1024 / frames, m_unpackDirect / 1024 / frames);
+
+	if (m_waitCount) {
+		u32 topPC = 0, topCount = 0;
+		for (auto& site : m_waitPCs) {
+			if (site.second > topCount) {
+				topPC    = site.first;
+				topCount = site.second;
+			}
+		}
+		DevCon.WriteLn("MTVU: EE waited on VU1 %u times/frame (%.2f ms/frame), %u%% of the waits at pc %08x",
+			m_waitCount / frames, (double)m_waitTicks * 1000 / GetTickFrequency() / frames,
+			topCount * 100 / m_waitCount, topPC);
+	}
+
+	if (m_microSkipped)
+		DevCon.WriteLn("MTVU: %u bytes/frame of unchanged micro memory uploads skipped", m_microSkipped / frames);
+
+	if (m_programCount)
+		DevCon.WriteLn("MTVU: %u VU1 programs/frame of %u cycles on average",
+			m_programCount / frames, m_programCycles / m_programCount);
+
+	m_unpackCopied     = 0;
+	m_unpackDirect     = 0;
+	m_waitCount        = 0;
+	m_waitTicks        = 0;
+	m_waitPCs.clear();
+	m_microSkipped     = 0;
+	m_programCount     = 0;
+	m_programCycles    = 0;
+	m_unpackStatsFrame = g_FrameCount;
 }
 
 void VU_Thread::ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop)
@@ -326,16 +404,36 @@ void VU_Thread::ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop)
 	Write(vif_top);
 	Write(vif_itop);
 	CommitWritePos();
+	ReportStats();
 	gifUnit.TransferGSPacketData(GIF_TRANS_MTVU, NULL, 0);
 	KickStart();
-	u32 cycles = std::min(Get_vuCycles(), 3000u);
-	cpuRegs.cycle += cycles * EmuConfig.Speedhacks.EECycleSkip;
+	ChargeVUCycles();
 }
 
 void VU_Thread::VifUnpack(vifStruct& _vif, VIFregisters& _vifRegs, u8* data, u32 size)
 {
 	MTVU_LOG("MTVU - VifUnpack!");
 	u32 vif_copy_size = (uptr)&_vif.StructEnd - (uptr)&_vif.tag;
+
+	ReportStats();
+
+	// With nothing queued the VU thread is idle, and stays idle until we queue something,
+	// so the unpack can be done right here, straight from the DMA source, instead of
+	// copying the whole packet into the ring for the VU thread to unpack later.
+	if (IsDone()) {
+		memcpy(&vif.tag, &_vif.tag, vif_copy_size);
+		vifRegs.cycle = _vifRegs.cycle;
+		vifRegs.mode  = _vifRegs.mode;
+		vifRegs.num   = _vifRegs.num;
+		vifRegs.mask  = _vifRegs.mask;
+		vifRegs.itop  = _vifRegs.itop;
+		vifRegs.top   = _vifRegs.top;
+		MTVU_Unpack(data, vifRegs);
+		m_unpackDirect += size;
+		return;
+	}
+
+	m_unpackCopied += size;
 	ReserveSpace(1 + size_u32(vif_copy_size) + size_u32(sizeof(VIFregistersMTVU)) + 1 + size_u32(size));
 	Write(MTVU_VIF_UNPACK);
 	Write(&_vif.tag, vif_copy_size);
@@ -346,17 +444,61 @@ void VU_Thread::VifUnpack(vifStruct& _vif, VIFregisters& _vifRegs, u8* data, u32
 	KickStart();
 }
 
-void VU_Thread::WriteMicroMem(u32 vu_micro_addr, void* data, u32 size)
+void VU_Thread::QueueMicroMem(u32 vu_micro_addr, const void* data, u32 size)
 {
-	MTVU_LOG("MTVU - WriteMicroMem!");
 	ReserveSpace(3 + size_u32(size));
 	Write(MTVU_VU_WRITE_MICRO);
 	Write(vu_micro_addr);
 	Write(size);
-	Write(data, size);
+	Write((void*)data, size);
+	m_micro_queued++;
 	CommitWritePos();
 }
 
+// Only the 64 byte lines that actually change are queued, so that games re-uploading the
+// same microprogram every frame neither fill the ring nor invalidate the recompiled code.
+void VU_Thread::WriteMicroMem(u32 vu_micro_addr, void* data, u32 size)
+{
+	MTVU_LOG("MTVU - WriteMicroMem!");
+	if (vu_micro_addr + size > sizeof(m_microShadow)) {
+		m_microShadowValid = false;
+		QueueMicroMem(vu_micro_addr, data, size);
+		return;
+	}
+
+	if (!m_microShadowValid) {
+		if (!IsDone()) {
+			QueueMicroMem(vu_micro_addr, data, size);
+			return;
+		}
+		memcpy(m_microShadow, vuRegs.Micro, sizeof(m_microShadow));
+		m_microShadowValid = true;
+	}
+
+	const u8* src   = (const u8*)data;
+	u32       start = 0;
+	bool      dirty = false;
+
+	for (u32 pos = 0; pos < size;) {
+		const u32 addr = vu_micro_addr + pos;
+		const u32 len  = std::min(size - pos, 64 - (addr & 63));
+
+		if (memcmp(&m_microShadow[addr], src + pos, len)) {
+			if (!dirty) start = pos;
+			dirty = true;
+		}
+		else {
+			if (dirty) QueueMicroMem(vu_micro_addr + start, src + start, pos - start);
+			dirty = false;
+			m_microSkipped += len;
+		}
+		pos += len;
+	}
+	if (dirty) QueueMicroMem(vu_micro_addr + start, src + start, size - start);
+
+	memcpy(&m_microShadow[vu_micro_addr], src, size);
+}
+
 void VU_Thread::WriteDataMem(u32 vu_data_addr, void* data, u32 size)
 {
 	MTVU_LOG("MTVU - WriteDataMem!");
@@ -385,3 +527,85 @@ void VU_Thread::WriteRow(vifStruct& _vif)
 	Write(&_vif.MaskRow, sizeof(_vif.MaskRow));
 	CommitWritePos();
 }
+
+//------------------------------------------------------------------
+// VU0_Thread
+//------------------------------------------------------------------
+
+void __fastcall vu0ThreadWaitJIT()
+{
+	vu0Thread.WaitVU();
+}
+
+VU0_Thread::VU0_Thread()
+{
+	m_name = L"MTVU0";
+	Reset();
+}
+
+VU0_Thread::~VU0_Thread()
+{
+	try {
+		pxThread::Cancel();
+	}
+	DESTRUCTOR_CATCHALL
+}
+
+void VU0_Thread::Reset()
+{
+	isBusy    = false;
+	m_pending = false;
+	stat      = 0;
+}
+
+void VU0_Thread::ExecuteTaskInThread()
+{
+	PCSX2_PAGEFAULT_PROTECT {
+		for(;;) {
+			semaEvent.WaitWithoutYield();
+			VU0.flags &= ~VUFLAG_MFLAGSET;
+			do { // Run VU until it finishes (M-bit breaks aren't needed, the EE is waiting anyway)
+				CpuVU0->Execute(vu0RunCycles);
+			} while (stat & 1);
+			isBusy.store(false, std::memory_order_release);
+		}
+	} PCSX2_PAGEFAULT_EXCEPT;
+}
+
+void VU0_Thread::ExecuteVU()
+{
+	MTVU_LOG("MTVU0 - ExecuteVU!");
+	WaitVU();
+	stat      = VU0.VI[REG_VPU_STAT].UL & 0xff;
+	m_pending = true;
+	isBusy.store(true, std::memory_order_release);
+	semaEvent.Post();
+}
+
+// Copies the end-of-program state the recompiler would have written
+// straight into the EE's registers if VU0 ran on the EE thread
+void VU0_Thread::Sync()
+{
+	m_pending = false;
+	VU0.VI[REG_VPU_STAT].UL = (VU0.VI[REG_VPU_STAT].UL & ~0xff) | (stat & 0xff);
+	vif0Regs.stat.VEW = false;
+
+	if (VU0.flags & VUFLAG_INTCINTERRUPT) {
+		VU0.flags &= ~VUFLAG_INTCINTERRUPT;
+		hwIntcIrq(6);
+	}
+}
+
+void VU0_Thread::Poll()
+{
+	if (m_pending && !isBusy.load(std::memory_order_acquire)) Sync();
+}
+
+void VU0_Thread::WaitVU()
+{
+	if (!m_pending) return;
+	MTVU_LOG("MTVU0 - WaitVU!");
+	while (isBusy.load(std::memory_order_acquire))
+		std::this_thread::yield();
+	Sync();
+}
@@ -18,6 +18,7 @@
 #include "Vif.h"
 #include "Vif_Dma.h"
 #include "VUmicro.h"
+#include <unordered_map>
 
 #define MTVU_LOG(...) do{} while(0)
 //#define MTVU_LOG DevCon.WriteLn
@@ -34,19 +35,43 @@ class VU_Thread : public pxThread {
 	__aligned(64) std::atomic<bool> isBusy;   // Is thread processing data?
 	__aligned(64) std::atomic<int> m_ato_read_pos; // Only modified by VU thread
 	__aligned(64) std::atomic<int> m_ato_write_pos;    // Only modified by EE thread
+	__aligned(64) std::atomic<u32> m_ato_micro_done;   // MTVU_VU_WRITE_MICRO packets processed (VU thread)
+	u32  m_micro_queued; // MTVU_VU_WRITE_MICRO packets queued (EE thread)
+	// Finished VU1 programs (upper 32 bits) and the sum of their cycles, each capped like
+	// the non-threaded VU1 charges them to the EE (lower 32 bits).  Both wrap (VU thread)
+	__aligned(64) std::atomic<u64> m_ato_vu_progress;
+	u64  m_vu_progress; // m_ato_vu_progress already charged to the EE (EE thread)
 	__aligned(64) int  m_read_pos; // temporary read pos (local to the VU thread)
 	int  m_write_pos; // temporary write pos (local to the EE thread)
 	Mutex     mtxBusy;
-	Semaphore semaEvent;
+	LightSemaphore semaEvent;
 	BaseVUmicroCPU*& vuCPU;
 	VURegs&          vuRegs;
 
+	// Unpack statistics (EE thread only)
+	u32  m_unpackCopied;      // bytes of unpack data copied into the ring
+	u32  m_unpackDirect;      // bytes unpacked directly by the EE thread
+	uint m_unpackStatsFrame;  // g_FrameCount at the start of the current period
+
+	// WaitVU statistics (EE thread only), only counting waits that actually stalled
+	u32  m_waitCount;
+	u64  m_waitTicks;
+	std::unordered_map<u32, u32> m_waitPCs; // stalls by EE pc
+
+	// EE-side copy of VU1 micro memory, queued writes included, used to drop uploads
+	// that wouldn't change anything (EE thread only)
+	__aligned16 u8 m_microShadow[0x4000];
+	bool m_microShadowValid; // false until re-synced from VU1.Micro with the ring empty
+	u32  m_microSkipped;     // bytes of micro memory uploads dropped as unchanged
+
+	// VU1 program statistics (EE thread only)
+	u32  m_programCount;
+	u32  m_programCycles;
+
 public:
 	__aligned16  vifStruct        vif;
 	__aligned16  VIFregisters     vifRegs;
-	__aligned(4) Semaphore semaXGkick;
-	__aligned(4) std::atomic<unsigned int> vuCycles[4]; // Used for VU cycle stealing hack
-	__aligned(4) u32 vuCycleIdx;  // Used for VU cycle stealing hack
+	__aligned(4) LightSemaphore semaXGkick;
 
 	VU_Thread(BaseVUmicroCPU*& _vuCPU, VURegs& _vuRegs);
 	virtual ~VU_Thread();
@@ -62,6 +87,13 @@ public:
 	// Waits till MTVU is done processing
 	void WaitVU();
 
+	// True when no micro memory write is left in the ring. VU1 programs never write to
+	// micro memory, so the EE can then read it without waiting for the VU thread.
+	bool IsMicroMemSynced();
+
+	// Must be called when VU1 micro memory is modified behind the ring's back
+	void DiscardMicroShadow() { m_microShadowValid = false; }
+
 	void ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop);
 
 	void VifUnpack(vifStruct& _vif, VIFregisters& _vifRegs, u8* data, u32 size);
@@ -101,7 +133,53 @@ private:
 	void Write(void* src, u32 size);
 	void WriteRegs(VIFregisters* src);
 
-	u32 Get_vuCycles();
+	void QueueMicroMem(u32 vu_micro_addr, const void* data, u32 size);
+
+	void ChargeVUCycles();
+
+	void ReportStats();
 };
 
 extern __aligned16 VU_Thread vu1Thread;
+
+// Runs VU0 micro-mode programs (VCALLMS/VCALLMSR and VIF0 MSCAL) on their own thread.
+// Only one VU0 program can be in flight, so instead of a ring buffer the EE just hands
+// over the start state, and waits for the program to end at every interlock point:
+// any COP2 op, LQC2/SQC2, VU0 memory accesses, VIF0 transfers and savestates.
+// Notes:
+// - This class should only be accessed from the EE thread...
+// - VPU_STAT/VEW and the VU0 interrupt are synced back to the EE once the program ends
+class VU0_Thread : public pxThread {
+	// Note: keep atomic on separate cache line to avoid CPU conflict
+	__aligned(64) std::atomic<bool> isBusy; // Is thread running a program?
+	__aligned(64) bool m_pending; // Has the EE yet to sync with the last program? (EE thread only)
+	LightSemaphore semaEvent;
+
+public:
+	__aligned(4) u32 stat; // VU0's copy of VPU_STAT while it runs on this thread
+
+	VU0_Thread();
+	virtual ~VU0_Thread();
+
+	void Reset();
+
+	// Starts VU0 at the current TPC
+	void ExecuteVU();
+
+	// Syncs with the last program if it has already ended, without stalling
+	void Poll();
+
+	// Waits till VU0 is done with its program and syncs its state with the EE
+	void WaitVU();
+
+protected:
+	void ExecuteTaskInThread();
+
+private:
+	void Sync();
+};
+
+extern __aligned16 VU0_Thread vu0Thread;
+
+// Called from recompiled EE code before it touches VU0 state
+extern void __fastcall vu0ThreadWaitJIT();
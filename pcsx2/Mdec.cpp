@@ -26,6 +26,8 @@
 #include "IopCommon.h"
 #include "Mdec.h"
 
+#include <emmintrin.h>
+
 struct {
 	u32 command;
 	u32 status;
@@ -47,125 +49,103 @@ u32 mdecMem[0x100000]; //watherver large size. //Memory only used to get DMA dat
 
 int iq_y[DCTSIZE2],iq_uv[DCTSIZE2];
 
-static void idct1(int *block)
+// The IDCT and the colour conversion work on 4 ints per SSE2 register, with the integer math
+// of the original code bit for bit.  The scalar IDCT skipped the columns and rows without AC
+// coefficients, the full butterfly gives the same result for them.
+
+static __fi __m128i mul32(__m128i a, int c)
 {
-	int i, val;
+	// No 32 bit mullo in SSE2, but the low half of the unsigned 64 bit product is the same
+	const __m128i k = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(a, k);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), k);
+
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+}
 
-	val = RANGE(DESCALE(block[0], PASS1_BITS+3));
+#define MULTIPLY4(var,const) _mm_srai_epi32(mul32(var, const), CONST_BITS)
 
-	for(i=0;i<DCTSIZE2;i++)
-		block[i]=val;
+// One pass of the butterfly on 4 columns, p[n] is the row n
+static __fi void idct_pass(__m128i* p)
+{
+	__m128i z5, z10, z11, z12, z13;
+
+	z10 = _mm_add_epi32(p[0], p[4]);
+	z11 = _mm_sub_epi32(p[0], p[4]);
+	z13 = _mm_add_epi32(p[2], p[6]);
+	z12 = _mm_sub_epi32(MULTIPLY4(_mm_sub_epi32(p[2], p[6]), FIX_1_414213562), z13);
+
+	const __m128i tmp0 = _mm_add_epi32(z10, z13);
+	const __m128i tmp3 = _mm_sub_epi32(z10, z13);
+	const __m128i tmp1 = _mm_add_epi32(z11, z12);
+	const __m128i tmp2 = _mm_sub_epi32(z11, z12);
+
+	z13 = _mm_add_epi32(p[3], p[5]);
+	z10 = _mm_sub_epi32(p[3], p[5]);
+	z11 = _mm_add_epi32(p[1], p[7]);
+	z12 = _mm_sub_epi32(p[1], p[7]);
+
+	z5 = MULTIPLY4(_mm_sub_epi32(z12, z10), FIX_1_847759065);
+	const __m128i tmp7 = _mm_add_epi32(z11, z13);
+	const __m128i tmp6 = _mm_sub_epi32(_mm_add_epi32(MULTIPLY4(z10, FIX_2_613125930), z5), tmp7);
+	const __m128i tmp5 = _mm_sub_epi32(MULTIPLY4(_mm_sub_epi32(z11, z13), FIX_1_414213562), tmp6);
+	const __m128i tmp4 = _mm_add_epi32(_mm_sub_epi32(MULTIPLY4(z12, FIX_1_082392200), z5), tmp5);
+
+	p[0] = _mm_add_epi32(tmp0, tmp7);
+	p[7] = _mm_sub_epi32(tmp0, tmp7);
+	p[1] = _mm_add_epi32(tmp1, tmp6);
+	p[6] = _mm_sub_epi32(tmp1, tmp6);
+	p[2] = _mm_add_epi32(tmp2, tmp5);
+	p[5] = _mm_sub_epi32(tmp2, tmp5);
+	p[4] = _mm_add_epi32(tmp3, tmp4);
+	p[3] = _mm_sub_epi32(tmp3, tmp4);
 }
 
-void idct(int *block,int k)
+static __fi void transpose4(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
 {
-  int tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
-  int z5, z10, z11, z12, z13;
-  int *ptr;
-  int i;
-
-  if (!k) { idct1(block); return; }
-
-  ptr = block;
-  for (i = 0; i< DCTSIZE; i++,ptr++) {
-
-    if ((ptr[DCTSIZE*1] | ptr[DCTSIZE*2] | ptr[DCTSIZE*3] |
-	 ptr[DCTSIZE*4] | ptr[DCTSIZE*5] | ptr[DCTSIZE*6] |
-	 ptr[DCTSIZE*7]) == 0) {
-      ptr[DCTSIZE*0] =
-      ptr[DCTSIZE*1] =
-      ptr[DCTSIZE*2] =
-      ptr[DCTSIZE*3] =
-      ptr[DCTSIZE*4] =
-      ptr[DCTSIZE*5] =
-      ptr[DCTSIZE*6] =
-      ptr[DCTSIZE*7] =
-      	ptr[DCTSIZE*0];
-
-      continue;
-    }
-
-    z10 = ptr[DCTSIZE*0] + ptr[DCTSIZE*4];
-    z11 = ptr[DCTSIZE*0] - ptr[DCTSIZE*4];
-    z13 = ptr[DCTSIZE*2] + ptr[DCTSIZE*6];
-    z12 = MULTIPLY(ptr[DCTSIZE*2] - ptr[DCTSIZE*6], FIX_1_414213562) - z13;
-
-    tmp0 = z10 + z13;
-    tmp3 = z10 - z13;
-    tmp1 = z11 + z12;
-    tmp2 = z11 - z12;
-
-    z13 = ptr[DCTSIZE*3] + ptr[DCTSIZE*5];
-    z10 = ptr[DCTSIZE*3] - ptr[DCTSIZE*5];
-    z11 = ptr[DCTSIZE*1] + ptr[DCTSIZE*7];
-    z12 = ptr[DCTSIZE*1] - ptr[DCTSIZE*7];
-
-    z5 = MULTIPLY(z12 - z10, FIX_1_847759065);
-    tmp7 = z11 + z13;
-    tmp6 = MULTIPLY(z10, FIX_2_613125930) + z5 - tmp7;
-    tmp5 = MULTIPLY(z11 - z13, FIX_1_414213562) - tmp6;
-    tmp4 = MULTIPLY(z12, FIX_1_082392200) - z5 + tmp5;
-
-    ptr[DCTSIZE*0] = (tmp0 + tmp7);
-    ptr[DCTSIZE*7] = (tmp0 - tmp7);
-    ptr[DCTSIZE*1] = (tmp1 + tmp6);
-    ptr[DCTSIZE*6] = (tmp1 - tmp6);
-    ptr[DCTSIZE*2] = (tmp2 + tmp5);
-    ptr[DCTSIZE*5] = (tmp2 - tmp5);
-    ptr[DCTSIZE*4] = (tmp3 + tmp4);
-    ptr[DCTSIZE*3] = (tmp3 - tmp4);
-
-  }
-
-  ptr = block;
-  for (i = 0; i < DCTSIZE; i++ ,ptr+=DCTSIZE) {
-
-    if ((ptr[1] | ptr[2] | ptr[3] | ptr[4] | ptr[5] | ptr[6] |
-	 ptr[7]) == 0) {
-      ptr[0] =
-      ptr[1] =
-      ptr[2] =
-      ptr[3] =
-      ptr[4] =
-      ptr[5] =
-      ptr[6] =
-      ptr[7] =
-      	RANGE(DESCALE(ptr[0], PASS1_BITS+3));;
-
-      continue;
-    }
-
-    z10 = ptr[0] + ptr[4];
-    z11 = ptr[0] - ptr[4];
-    z13 = ptr[2] + ptr[6];
-    z12 = MULTIPLY(ptr[2] - ptr[6], FIX_1_414213562) - z13;
-
-    tmp0 = z10 + z13;
-    tmp3 = z10 - z13;
-    tmp1 = z11 + z12;
-    tmp2 = z11 - z12;
-
-    z13 = ptr[3] + ptr[5];
-    z10 = ptr[3] - ptr[5];
-    z11 = ptr[1] + ptr[7];
-    z12 = ptr[1] - ptr[7];
-
-    z5 = MULTIPLY(z12 - z10, FIX_1_847759065);
-    tmp7 = z11 + z13;
-    tmp6 = MULTIPLY(z10, FIX_2_613125930) + z5 - tmp7;
-    tmp5 = MULTIPLY(z11 - z13, FIX_1_414213562) - tmp6;
-    tmp4 = MULTIPLY(z12, FIX_1_082392200) - z5 + tmp5;
-
-    ptr[0] = RANGE(DESCALE(tmp0 + tmp7, PASS1_BITS+3));;
-    ptr[7] = RANGE(DESCALE(tmp0 - tmp7, PASS1_BITS+3));;
-    ptr[1] = RANGE(DESCALE(tmp1 + tmp6, PASS1_BITS+3));;
-    ptr[6] = RANGE(DESCALE(tmp1 - tmp6, PASS1_BITS+3));;
-    ptr[2] = RANGE(DESCALE(tmp2 + tmp5, PASS1_BITS+3));;
-    ptr[5] = RANGE(DESCALE(tmp2 - tmp5, PASS1_BITS+3));;
-    ptr[4] = RANGE(DESCALE(tmp3 + tmp4, PASS1_BITS+3));;
-    ptr[3] = RANGE(DESCALE(tmp3 - tmp4, PASS1_BITS+3));;
-
-  }
+	const __m128i t0 = _mm_unpacklo_epi32(a, b);
+	const __m128i t1 = _mm_unpacklo_epi32(c, d);
+	const __m128i t2 = _mm_unpackhi_epi32(a, b);
+	const __m128i t3 = _mm_unpackhi_epi32(c, d);
+
+	a = _mm_unpacklo_epi64(t0, t1);
+	b = _mm_unpackhi_epi64(t0, t1);
+	c = _mm_unpacklo_epi64(t2, t3);
+	d = _mm_unpackhi_epi64(t2, t3);
+}
+
+// l[n] and r[n] are the left and right halves of the row n
+static __fi void transpose8(__m128i* l, __m128i* r)
+{
+	transpose4(l[0], l[1], l[2], l[3]);
+	transpose4(l[4], l[5], l[6], l[7]);
+	transpose4(r[0], r[1], r[2], r[3]);
+	transpose4(r[4], r[5], r[6], r[7]);
+
+	for (int i = 0; i < 4; i++) std::swap(l[4 + i], r[i]);
+}
+
+static void idct(int *block)
+{
+	__m128i l[DCTSIZE], r[DCTSIZE];
+
+	for (int i = 0; i < DCTSIZE; i++) {
+		l[i] = _mm_loadu_si128((__m128i*)&block[i*DCTSIZE + 0]);
+		r[i] = _mm_loadu_si128((__m128i*)&block[i*DCTSIZE + 4]);
+	}
+
+	// columns, then the rows as the columns of the transposed block
+	idct_pass(l);
+	idct_pass(r);
+	transpose8(l, r);
+	idct_pass(l);
+	idct_pass(r);
+	transpose8(l, r);
+
+	for (int i = 0; i < DCTSIZE; i++) {
+		_mm_storeu_si128((__m128i*)&block[i*DCTSIZE + 0], _mm_srai_epi32(l[i], PASS1_BITS+3));
+		_mm_storeu_si128((__m128i*)&block[i*DCTSIZE + 4], _mm_srai_epi32(r[i], PASS1_BITS+3));
+	}
 }
 
 void mdecInit(void) {
@@ -176,7 +156,6 @@ void mdecInit(void) {
 	//mdec.rl = (u16*)&psxM[0x100000];
 	mdec.command = 0;
 	mdec.status = 0;
-	round_init();
 }
 
 
@@ -193,7 +172,6 @@ void mdecWrite1(u32 data) {
 	MDEC_LOG("mdec1 write %lx", data);
 
 	if (data&0x80000000) { // mdec reset
-		round_init();
 //		mdecInit();
 	}
 }
@@ -339,119 +317,81 @@ unsigned short* rl2blk(int *blk,unsigned short *mdec_rl) {
 			blk[zscan[k]] = (VALOF(rl) * iqtab[k] * q_scale) / 8; // / 16;
 		}
 
-		idct(blk,k+1);
+		idct(blk);
 		blk+=DCTSIZE2;
 	}
 	return mdec_rl;
 }
 
-unsigned char roundtbl[256*3];
-
-void round_init(void) {
-	int i;
-	for(i=0;i<256;i++) {
-		roundtbl[i]=0;
-		roundtbl[i+256]=i;
-		roundtbl[i+512]=255;
+// Clamped R, G and B (0..255, in 16 bits) of the 8 pixels (x0..x0+7, y) of the macroblock.
+// Each chroma sample covers 2x2 pixels, the 4 luma blocks are Y1 Y2 over Y3 Y4.
+static __fi void yuv2rgb8(const int *blk, int x0, int y, __m128i& r, __m128i& g, __m128i& b)
+{
+	const int *Yblk = blk + DCTSIZE2*(2 + (x0 >> 3) + (y >> 3)*2) + (y & 7)*DCTSIZE;
+	const __m128i Y0 = _mm_loadu_si128((__m128i*)&Yblk[0]);
+	const __m128i Y1 = _mm_loadu_si128((__m128i*)&Yblk[4]);
+	__m128i r0 = Y0, r1 = Y1, g0 = Y0, g1 = Y1, b0 = Y0, b1 = Y1;
+
+	if (!(Config.Mdec&0x1)) {
+		const int c = (y >> 1)*DCTSIZE + (x0 >> 1);
+		const __m128i Cb = _mm_loadu_si128((__m128i*)&blk[c]);
+		const __m128i Cr = _mm_loadu_si128((__m128i*)&blk[DCTSIZE2 + c]);
+
+		const __m128i R = _mm_srai_epi32(mul32(Cr, MDEC_CR_R), 10);
+		const __m128i G = _mm_add_epi32(_mm_srai_epi32(mul32(Cb, MDEC_CB_G), 10), _mm_srai_epi32(mul32(Cr, MDEC_CR_G), 10));
+		const __m128i B = _mm_srai_epi32(mul32(Cb, MDEC_CB_B), 10);
+
+		r0 = _mm_add_epi32(r0, _mm_unpacklo_epi32(R, R));
+		r1 = _mm_add_epi32(r1, _mm_unpackhi_epi32(R, R));
+		g0 = _mm_add_epi32(g0, _mm_unpacklo_epi32(G, G));
+		g1 = _mm_add_epi32(g1, _mm_unpackhi_epi32(G, G));
+		b0 = _mm_add_epi32(b0, _mm_unpacklo_epi32(B, B));
+		b1 = _mm_add_epi32(b1, _mm_unpackhi_epi32(B, B));
 	}
+
+	// c + 128 clamped to 0..255, the saturations of the packing don't change that
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i max = _mm_set1_epi16(255);
+
+	r = _mm_min_epi16(_mm_max_epi16(_mm_adds_epi16(_mm_packs_epi32(r0, r1), bias), zero), max);
+	g = _mm_min_epi16(_mm_max_epi16(_mm_adds_epi16(_mm_packs_epi32(g0, g1), bias), zero), max);
+	b = _mm_min_epi16(_mm_max_epi16(_mm_adds_epi16(_mm_packs_epi32(b0, b1), bias), zero), max);
 }
 
 void yuv2rgb15(int *blk,unsigned short *image) {
-	int x,y;
-	int *Yblk = blk+DCTSIZE2*2;
-	int Cb,Cr,R,G,B;
-	int *Cbblk = blk;
-	int *Crblk = blk+DCTSIZE2;
-
-	if (!(Config.Mdec&0x1))
-	for (y=0;y<16;y+=2,Crblk+=4,Cbblk+=4,Yblk+=8,image+=24) {
-		if (y==8) Yblk+=DCTSIZE2;
-		for (x=0;x<4;x++,image+=2,Crblk++,Cbblk++,Yblk+=2) {
-			Cr = *Crblk;
-			Cb = *Cbblk;
-			R = MULR(Cr);
-			G = MULG(Cb) + MULG2(Cr);
-			B = MULB(Cb);
-
-			RGB15(0, Yblk[0]);
-			RGB15(1, Yblk[1]);
-			RGB15(16, Yblk[8]);
-			RGB15(17, Yblk[9]);
-
-			Cr = *(Crblk+4);
-			Cb = *(Cbblk+4);
-			R = MULR(Cr);
-			G = MULG(Cb) + MULG2(Cr);
-			B = MULB(Cb);
-
-			RGB15(8, Yblk[DCTSIZE2+0]);
-			RGB15(9, Yblk[DCTSIZE2+1]);
-			RGB15(24, Yblk[DCTSIZE2+8]);
-			RGB15(25, Yblk[DCTSIZE2+9]);
-		}
-	} else
-	for (y=0;y<16;y+=2,Yblk+=8,image+=24) {
-		if (y==8) Yblk+=DCTSIZE2;
-		for (x=0;x<4;x++,image+=2,Yblk+=2) {
-			RGB15BW(0, Yblk[0]);
-			RGB15BW(1, Yblk[1]);
-			RGB15BW(16, Yblk[8]);
-			RGB15BW(17, Yblk[9]);
-
-			RGB15BW(8, Yblk[DCTSIZE2+0]);
-			RGB15BW(9, Yblk[DCTSIZE2+1]);
-			RGB15BW(24, Yblk[DCTSIZE2+8]);
-			RGB15BW(25, Yblk[DCTSIZE2+9]);
+	__m128i r, g, b;
+
+	for (int y = 0; y < 16; y++, image += 16) {
+		for (int x = 0; x < 16; x += 8) {
+			yuv2rgb8(blk, x, y, r, g, b);
+
+			const __m128i c = _mm_or_si128(_mm_or_si128(
+				_mm_slli_epi16(_mm_srli_epi16(r, 3), 10),
+				_mm_slli_epi16(_mm_srli_epi16(g, 3), 5)),
+				_mm_srli_epi16(b, 3));
+
+			_mm_storeu_si128((__m128i*)&image[x], c);
 		}
 	}
 }
 
 void yuv2rgb24(int *blk,unsigned char *image) {
-	int x,y;
-	int *Yblk = blk+DCTSIZE2*2;
-	int Cb,Cr,R,G,B;
-	int *Cbblk = blk;
-	int *Crblk = blk+DCTSIZE2;
-
-	if (!(Config.Mdec&0x1))
-	for (y=0;y<16;y+=2,Crblk+=4,Cbblk+=4,Yblk+=8,image+=24*3) {
-		if (y==8) Yblk+=DCTSIZE2;
-		for (x=0;x<4;x++,image+=6,Crblk++,Cbblk++,Yblk+=2) {
-			Cr = *Crblk;
-			Cb = *Cbblk;
-			R = MULR(Cr);
-			G = MULG(Cb) + MULG2(Cr);
-			B = MULB(Cb);
-
-			RGB24(0, Yblk[0]);
-			RGB24(1*3, Yblk[1]);
-			RGB24(16*3, Yblk[8]);
-			RGB24(17*3, Yblk[9]);
-
-			Cr = *(Crblk+4);
-			Cb = *(Cbblk+4);
-			R = MULR(Cr);
-			G = MULG(Cb) + MULG2(Cr);
-			B = MULB(Cb);
-
-			RGB24(8*3, Yblk[DCTSIZE2+0]);
-			RGB24(9*3, Yblk[DCTSIZE2+1]);
-			RGB24(24*3, Yblk[DCTSIZE2+8]);
-			RGB24(25*3, Yblk[DCTSIZE2+9]);
-		}
-	} else
-	for (y=0;y<16;y+=2,Yblk+=8,image+=24*3) {
-		if (y==8) Yblk+=DCTSIZE2;
-		for (x=0;x<4;x++,image+=6,Yblk+=2) {
-			RGB24BW(0, Yblk[0]);
-			RGB24BW(1*3, Yblk[1]);
-			RGB24BW(16*3, Yblk[8]);
-			RGB24BW(17*3, Yblk[9]);
-
-			RGB24BW(8*3, Yblk[DCTSIZE2+0]);
-			RGB24BW(9*3, Yblk[DCTSIZE2+1]);
-			RGB24BW(24*3, Yblk[DCTSIZE2+8]);
-			RGB24BW(25*3, Yblk[DCTSIZE2+9]);
+	__m128i rl, gl, bl, rh, gh, bh;
+	__aligned16 u8 r[16], g[16], b[16];
+
+	for (int y = 0; y < 16; y++, image += 16*3) {
+		yuv2rgb8(blk, 0, y, rl, gl, bl);
+		yuv2rgb8(blk, 8, y, rh, gh, bh);
+
+		_mm_store_si128((__m128i*)r, _mm_packus_epi16(rl, rh));
+		_mm_store_si128((__m128i*)g, _mm_packus_epi16(gl, gh));
+		_mm_store_si128((__m128i*)b, _mm_packus_epi16(bl, bh));
+
+		for (int x = 0; x < 16; x++) {
+			image[x*3 + 0] = b[x];
+			image[x*3 + 1] = g[x];
+			image[x*3 + 2] = r[x];
 		}
 	}
 }
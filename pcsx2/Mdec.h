@@ -52,38 +52,11 @@
 #define VALOF(a) (((int)(a)<<(32-10))>>(32-10))
 #define NOP	0xfe00
 
-#define FIXED
-
-#ifdef FIXED
-#define	MULR(a)		((((int)0x0000059B) * (a)) >> 10)
-#define	MULG(a)		((((int)0xFFFFFEA1) * (a)) >> 10)
-#define	MULG2(a)	((((int)0xFFFFFD25) * (a)) >> 10)
-#define	MULB(a)		((((int)0x00000716) * (a)) >> 10)
-#else
-#define	MULR(a)		((int)((float)1.40200 * (a)))
-#define	MULG(a)		((int)((float)-0.3437 * (a)))
-#define	MULG2(a)	((int)((float)-0.7143 * (a)))
-#define	MULB(a)		((int)((float)1.77200 * (a)))
-#endif
-
-#define	MAKERGB15(r,g,b)	( (((r)>>3)<<10)|(((g)>>3)<<5)|((b)>>3) )
-#define	ROUND(c)	roundtbl[((c)+128+256)]//&0x3ff]
-
-#define RGB15(n, Y) \
-	image[n] = MAKERGB15(ROUND(Y + R),ROUND(Y + G),ROUND(Y + B));
-
-#define RGB15BW(n, Y) \
-	image[n] = MAKERGB15(ROUND(Y),ROUND(Y),ROUND(Y));
-
-#define RGB24(n, Y) \
-	image[n+2] = ROUND(Y + R); \
-	image[n+1] = ROUND(Y + G); \
-	image[n+0] = ROUND(Y + B);
-
-#define RGB24BW(n, Y) \
-	image[n+2] = ROUND(Y); \
-	image[n+1] = ROUND(Y); \
-	image[n+0] = ROUND(Y);
+// YCbCr to RGB, multiplied and then >> 10
+#define MDEC_CR_R	0x0000059B	//  1.402
+#define MDEC_CB_G	0xFFFFFEA1	// -0.3437
+#define MDEC_CR_G	0xFFFFFD25	// -0.7143
+#define MDEC_CB_B	0x00000716	//  1.772
 
 extern void mdecInit();
 extern void mdecWrite0(u32 data);
@@ -97,7 +70,6 @@ extern void psxDma1(u32 madr, u32 bcr, u32 chcr);
 
 u16* rl2blk(int *blk,u16 *mdec_rl);
 void iqtab_init(int *iqtab,unsigned char *iq_y);
-void round_init(void);
 void yuv2rgb24(int *blk,unsigned char *image);
 void yuv2rgb15(int *blk,u16 *image);
 
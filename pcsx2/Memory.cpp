@@ -36,6 +36,8 @@ BIOS
 
 #include "PrecompiledHeader.h"
 #include <wx/file.h>
+#include <atomic>
+#include <thread>
 
 #include "IopCommon.h"
 #include "GS.h"
@@ -102,6 +104,7 @@ static vtlbHandler
 	tlb_fallback_8,
 
 	vu0_micro_mem,
+	vu0_data_mem,
 	vu1_micro_mem,
 	vu1_data_mem,
 
@@ -132,7 +135,10 @@ void memMapVUmicro()
 
 	// VU0/VU1 memory (data)
 	// VU0 is 4k, mirrored 4 times across a 16k area.
-	vtlb_MapBlock(VU0.Mem,0x11004000,0x00004000,0x1000);
+	// MTVU0 needs the handlers so the EE waits for the VU0 thread (they wrap the address too).
+	// Note: Unlike VU1 below this follows the setting, so toggling MTVU0 needs a reset.
+	if (THREAD_VU0) vtlb_MapHandler(vu0_data_mem,0x11004000,0x00004000);
+	else            vtlb_MapBlock  (VU0.Mem,     0x11004000,0x00004000,0x1000);
 	// Note: In order for the below conditional to work correctly
 	// support needs to be coded to reset the memMappings when MTVU is
 	// turned off/on. For now we just always use the vu data handlers...
@@ -452,38 +458,44 @@ template<int vunum> static __fi void ClearVuFunc(u32 addr, u32 size) {
 }
 
 // VU Micro Memory Reads...
+// MTVU only has to be waited on while a micro memory write is still queued.
 template<int vunum> static mem8_t __fc vuMicroRead8(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
-	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (vunum && THREAD_VU1 && !vu1Thread.IsMicroMemSynced()) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return vu->Micro[addr];
 }
 template<int vunum> static mem16_t __fc vuMicroRead16(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
-	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (vunum && THREAD_VU1 && !vu1Thread.IsMicroMemSynced()) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u16*)&vu->Micro[addr];
 }
 template<int vunum> static mem32_t __fc vuMicroRead32(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
-	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (vunum && THREAD_VU1 && !vu1Thread.IsMicroMemSynced()) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u32*)&vu->Micro[addr];
 }
 template<int vunum> static void __fc vuMicroRead64(u32 addr,mem64_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	
-	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (vunum && THREAD_VU1 && !vu1Thread.IsMicroMemSynced()) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	*data=*(u64*)&vu->Micro[addr];
 }
 template<int vunum> static void __fc vuMicroRead128(u32 addr,mem128_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
-	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (vunum && THREAD_VU1 && !vu1Thread.IsMicroMemSynced()) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	
 	CopyQWC(data,&vu->Micro[addr]);
 }
@@ -498,6 +510,7 @@ template<int vunum> static void __fc vuMicroWrite8(u32 addr,mem8_t data) {
 		vu1Thread.WriteMicroMem(addr, &data, sizeof(u8));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (vu->Micro[addr]!=data) {     // Clear before writing new data
 		ClearVuFunc<vunum>(addr, 8); //(clearing 8 bytes because an instruction is 8 bytes) (cottonvibes)
 		vu->Micro[addr] =data;
@@ -511,6 +524,7 @@ template<int vunum> static void __fc vuMicroWrite16(u32 addr, mem16_t data) {
 		vu1Thread.WriteMicroMem(addr, &data, sizeof(u16));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (*(u16*)&vu->Micro[addr]!=data) {
 		ClearVuFunc<vunum>(addr, 8);
 		*(u16*)&vu->Micro[addr] =data;
@@ -524,6 +538,7 @@ template<int vunum> static void __fc vuMicroWrite32(u32 addr, mem32_t data) {
 		vu1Thread.WriteMicroMem(addr, &data, sizeof(u32));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if (*(u32*)&vu->Micro[addr]!=data) {
 		ClearVuFunc<vunum>(addr, 8);
 		*(u32*)&vu->Micro[addr] =data;
@@ -537,6 +552,7 @@ template<int vunum> static void __fc vuMicroWrite64(u32 addr, const mem64_t* dat
 		vu1Thread.WriteMicroMem(addr, (void*)data, sizeof(u64));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	
 	if (*(u64*)&vu->Micro[addr]!=data[0]) {
 		ClearVuFunc<vunum>(addr, 8);
@@ -551,6 +567,7 @@ template<int vunum> static void __fc vuMicroWrite128(u32 addr, const mem128_t* d
 		vu1Thread.WriteMicroMem(addr, (void*)data, sizeof(u128));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	if ((u128&)vu->Micro[addr]!=*data) {
 		ClearVuFunc<vunum>(addr, 16);
 		CopyQWC(&vu->Micro[addr],data);
@@ -562,30 +579,35 @@ template<int vunum> static mem8_t __fc vuDataRead8(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return vu->Mem[addr];
 }
 template<int vunum> static mem16_t __fc vuDataRead16(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u16*)&vu->Mem[addr];
 }
 template<int vunum> static mem32_t __fc vuDataRead32(u32 addr) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	return *(u32*)&vu->Mem[addr];
 }
 template<int vunum> static void __fc vuDataRead64(u32 addr, mem64_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	*data=*(u64*)&vu->Mem[addr];
 }
 template<int vunum> static void __fc vuDataRead128(u32 addr, mem128_t* data) {
 	VURegs* vu = vunum ?  &VU1 :  &VU0;
 	addr      &= vunum ? 0x3fff: 0xfff;
 	if (vunum && THREAD_VU1) vu1Thread.WaitVU();
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	CopyQWC(data,&vu->Mem[addr]);
 }
 
@@ -597,6 +619,7 @@ template<int vunum> static void __fc vuDataWrite8(u32 addr, mem8_t data) {
 		vu1Thread.WriteDataMem(addr, &data, sizeof(u8));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	vu->Mem[addr] = data;
 }
 template<int vunum> static void __fc vuDataWrite16(u32 addr, mem16_t data) {
@@ -606,6 +629,7 @@ template<int vunum> static void __fc vuDataWrite16(u32 addr, mem16_t data) {
 		vu1Thread.WriteDataMem(addr, &data, sizeof(u16));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	*(u16*)&vu->Mem[addr] = data;
 }
 template<int vunum> static void __fc vuDataWrite32(u32 addr, mem32_t data) {
@@ -615,6 +639,7 @@ template<int vunum> static void __fc vuDataWrite32(u32 addr, mem32_t data) {
 		vu1Thread.WriteDataMem(addr, &data, sizeof(u32));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	*(u32*)&vu->Mem[addr] = data;
 }
 template<int vunum> static void __fc vuDataWrite64(u32 addr, const mem64_t* data) {
@@ -624,6 +649,7 @@ template<int vunum> static void __fc vuDataWrite64(u32 addr, const mem64_t* data
 		vu1Thread.WriteDataMem(addr, (void*)data, sizeof(u64));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	*(u64*)&vu->Mem[addr] = data[0];
 }
 template<int vunum> static void __fc vuDataWrite128(u32 addr, const mem128_t* data) {
@@ -633,15 +659,21 @@ template<int vunum> static void __fc vuDataWrite128(u32 addr, const mem128_t* da
 		vu1Thread.WriteDataMem(addr, (void*)data, sizeof(u128));
 		return;
 	}
+	if (!vunum && THREAD_VU0) vu0Thread.WaitVU();
 	CopyQWC(&vu->Mem[addr], data);
 }
 
 
-void memSetPageAddr(u32 vaddr, u32 paddr)
+// cached - the TLB entry maps the page with cache mode 3 (cached).  When the data cache is
+// emulated, such RAM pages go through the cache handler instead of being mapped directly.
+void memSetPageAddr(u32 vaddr, u32 paddr, bool cached)
 {
 	//Console.WriteLn("memSetPageAddr: %8.8x -> %8.8x", vaddr, paddr);
 
-	vtlb_VMap(vaddr,paddr,0x1000);
+	if (cached && CHECK_CACHE && paddr < Ps2MemSize::MainRam)
+		vtlb_VMapHandler(cachedRamHandler,vaddr,paddr,0x1000);
+	else
+		vtlb_VMap(vaddr,paddr,0x1000);
 
 }
 
@@ -747,6 +779,8 @@ void eeMemoryReserve::Reset()
 	null_handler = vtlb_RegisterHandler(nullRead8, nullRead16, nullRead32, nullRead64, nullRead128,
 		nullWrite8, nullWrite16, nullWrite32, nullWrite64, nullWrite128);
 
+	cacheRegisterHandler();
+
 	tlb_fallback_0 = vtlb_RegisterHandlerTempl1(_ext_mem,0);
 	tlb_fallback_3 = vtlb_RegisterHandlerTempl1(_ext_mem,3);
 	tlb_fallback_4 = vtlb_RegisterHandlerTempl1(_ext_mem,4);
@@ -757,6 +791,7 @@ void eeMemoryReserve::Reset()
 	// Dynarec versions of VUs
 	vu0_micro_mem = vtlb_RegisterHandlerTempl1(vuMicro,0);
 	vu1_micro_mem = vtlb_RegisterHandlerTempl1(vuMicro,1);
+	vu0_data_mem  = vtlb_RegisterHandlerTempl1(vuData,0);
 	vu1_data_mem  = (1||THREAD_VU1) ? vtlb_RegisterHandlerTempl1(vuData,1) : 0;
 	
 	//////////////////////////////////////////////////////////////////////////////////////////
@@ -890,6 +925,15 @@ void eeMemoryReserve::Release()
 // is 4096 (4k), which is why you'll see a lot of 0xfff's, >><< 12's, and 0x1000's in the
 // code below.
 //
+// Sub-page Tracking:
+// Each protected page also remembers which of its 256 byte sub-pages hold recompiled code.
+// A write fault into a sub-page with no code is a data write that merely shares the page
+// with code; the page is unprotected as usual, but instead of being cleared its blocks are
+// suspended (see R5900cpu::SuspendPage) and re-validated against their original code the
+// next time one of them runs, which re-protects the page.  Pages that keep doing this are
+// eventually treated like any other fault, so that a busy data page doesn't turn into a
+// fault storm.
+//
 
 struct vtlb_PageProtectionInfo
 {
@@ -901,8 +945,17 @@ struct vtlb_PageProtectionInfo
 	u32 ReverseRamMap;
 
 	vtlb_ProtectionMode Mode;
+
+	// One bit per sub-page that holds recompiled code (since the page was last cleared).
+	u16 CodeMask;
+
+	// Number of write faults into this page that didn't hit any code.
+	u8 DataFaults;
 };
 
+static const uint RamSubpageShift = 8;
+static const uint MaxDataFaults = 32;
+
 static __aligned16 vtlb_PageProtectionInfo m_PageProtectInfo[Ps2MemSize::MainRam >> 12];
 
 
@@ -954,6 +1007,24 @@ void mmap_MarkCountedRamPage( u32 paddr )
 	HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadOnly() );
 }
 
+// paddr - physically mapped PS2 address of recompiled code, size in bytes.
+// The range must reside within a single page.
+void mmap_MarkCodeRange( u32 paddr, u32 size )
+{
+	pxAssert( eeMem && size );
+
+	uptr ptr = (uptr)PSM( paddr );
+	uptr offset = ptr - (uptr)eeMem->Main;
+
+	if (offset >= Ps2MemSize::MainRam)
+		return;
+
+	const uint first = (offset & 0xfff) >> RamSubpageShift;
+	const uint last = ((offset & 0xfff) + size - 1) >> RamSubpageShift;
+
+	m_PageProtectInfo[offset >> 12].CodeMask |= (u16)(((2 << last) - 1) & ~((1 << first) - 1));
+}
+
 // offset - offset of address relative to psM.
 // All recompiled blocks belonging to the page are cleared, and any new blocks recompiled
 // from code residing in this page will use manual protection.
@@ -968,9 +1039,169 @@ static __fi void mmap_ClearCpuBlock( uint offset )
 	pxAssertMsg( m_PageProtectInfo[rampage].Mode != ProtMode_Manual,
 		"Attempted to clear a block that is already under manual protection." );
 
+	vtlb_PageProtectionInfo& info = m_PageProtectInfo[rampage];
+
 	HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadWrite() );
-	m_PageProtectInfo[rampage].Mode = ProtMode_Manual;
-	Cpu->Clear( m_PageProtectInfo[rampage].ReverseRamMap, 0x400 );
+	info.Mode = ProtMode_Manual;
+
+	const uint subpage = (offset & 0xfff) >> RamSubpageShift;
+
+	if (!(info.CodeMask & (1 << subpage)) && info.DataFaults < MaxDataFaults)
+	{
+		info.DataFaults++;
+		Cpu->SuspendPage( info.ReverseRamMap );
+		return;
+	}
+
+	info.CodeMask = 0;
+	Cpu->Clear( info.ReverseRamMap, 0x400 );
+}
+
+// ===========================================================================================
+//  Copy-on-write memory snapshots
+// ===========================================================================================
+// Savestates can capture EE and IOP main memory without keeping the core paused for the
+// copy: both are write-protected while paused, and emulation resumes immediately.  A
+// background thread then copies every page into the destination buffer, and any page the
+// emulator writes to before then is copied by the page fault handler first.
+//
+// Pages stay protected until their first write (even once the background copy is done),
+// because unprotecting them from another thread would race with the code protection above.
+// EE pages that also hold counted code are handed on to the regular fault handling, which
+// unprotects them after clearing their blocks.
+//
+enum SnapshotPageState
+{
+	SnapPage_Free = 0,		// not part of a snapshot (or already written to since)
+	SnapPage_Pending,		// protected, not copied yet
+	SnapPage_Copying,		// being copied by another thread
+	SnapPage_Copied,		// copied, still protected
+};
+
+struct SnapshotRegion
+{
+	u8* src;
+	u8* dest;
+	uint pages;
+	std::atomic<u8>* state;
+};
+
+static std::atomic<u8> m_SnapshotEE[Ps2MemSize::MainRam >> 12];
+static std::atomic<u8> m_SnapshotIOP[Ps2MemSize::IopRam >> 12];
+static SnapshotRegion m_SnapshotRegions[2];
+static std::thread m_SnapshotThread;
+
+static void mmap_CopySnapshotPage( SnapshotRegion& region, uint page )
+{
+	u8 expected = SnapPage_Pending;
+	if( region.state[page].compare_exchange_strong( expected, SnapPage_Copying, std::memory_order_acquire ) )
+	{
+		memcpy( region.dest + (page << 12), region.src + (page << 12), __pagesize );
+		region.state[page].store( SnapPage_Copied, std::memory_order_release );
+		return;
+	}
+
+	while( region.state[page].load( std::memory_order_acquire ) == SnapPage_Copying )
+		_mm_pause();
+}
+
+static void mmap_SnapshotThread()
+{
+	for( SnapshotRegion& region : m_SnapshotRegions )
+	{
+		if( !region.dest ) continue;
+
+		for( uint page = 0; page < region.pages; ++page )
+			mmap_CopySnapshotPage( region, page );
+	}
+}
+
+// Returns true if the fault hit a page protected by the snapshot.  The page has then been
+// copied, and only needs to be unprotected.
+static bool mmap_SnapshotFault( uptr addr )
+{
+	for( SnapshotRegion& region : m_SnapshotRegions )
+	{
+		const uptr offset = addr - (uptr)region.src;
+		if( !region.dest || offset >= (region.pages << 12) ) continue;
+
+		const uint page = offset >> 12;
+		if( region.state[page].load( std::memory_order_acquire ) == SnapPage_Free ) return false;
+
+		mmap_CopySnapshotPage( region, page );
+		region.state[page].store( SnapPage_Free, std::memory_order_release );
+		return true;
+	}
+
+	return false;
+}
+
+void mmap_BeginSnapshot( u8* eeDest, u8* iopDest )
+{
+	mmap_EndSnapshot();
+
+	const SnapshotRegion regions[2] =
+	{
+		{ eeMem->Main, eeDest, Ps2MemSize::MainRam >> 12, m_SnapshotEE },
+		{ iopMem->Main, iopDest, Ps2MemSize::IopRam >> 12, m_SnapshotIOP },
+	};
+
+	for( uint i = 0; i < ArraySize(regions); ++i )
+	{
+		m_SnapshotRegions[i] = regions[i];
+		if( !regions[i].dest ) continue;
+
+		for( uint page = 0; page < regions[i].pages; ++page )
+			regions[i].state[page].store( SnapPage_Pending, std::memory_order_relaxed );
+
+		HostSys::MemProtect( regions[i].src, regions[i].pages << 12, PageAccess_ReadOnly() );
+	}
+
+	m_SnapshotThread = std::thread( mmap_SnapshotThread );
+}
+
+// Blocks until the snapshot is complete in its destination buffers.
+void mmap_WaitSnapshot()
+{
+	if( m_SnapshotThread.joinable() )
+		m_SnapshotThread.join();
+}
+
+// Completes the snapshot and lifts whatever protection it still holds.
+void mmap_EndSnapshot()
+{
+	mmap_WaitSnapshot();
+
+	for( SnapshotRegion& region : m_SnapshotRegions )
+	{
+		if( !region.dest ) continue;
+
+		const bool isEE = (region.state == m_SnapshotEE);
+
+		for( uint page = 0; page < region.pages; )
+		{
+			uint end = page;
+			while( end < region.pages && region.state[end].load( std::memory_order_relaxed ) != SnapPage_Free
+				&& !(isEE && m_PageProtectInfo[end].Mode == ProtMode_Write) )
+			{
+				region.state[end].store( SnapPage_Free, std::memory_order_relaxed );
+				++end;
+			}
+
+			if( end != page )
+				HostSys::MemProtect( region.src + (page << 12), (end - page) << 12, PageAccess_ReadWrite() );
+			else
+			{
+				// Free already, or holds counted code (which must stay protected).
+				region.state[page].store( SnapPage_Free, std::memory_order_relaxed );
+				++end;
+			}
+
+			page = end;
+		}
+
+		region.dest = NULL;
+	}
 }
 
 void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& handled )
@@ -979,6 +1210,18 @@ void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& h
 
 	// get bad virtual address
 	uptr offset = info.addr - (uptr)eeMem->Main;
+
+	if( mmap_SnapshotFault( info.addr ) )
+	{
+		// Pages that also hold counted code still need their blocks cleared below.
+		if( offset >= Ps2MemSize::MainRam || m_PageProtectInfo[offset >> 12].Mode != ProtMode_Write )
+		{
+			HostSys::MemProtect( (void*)(info.addr & ~(uptr)0xfff), __pagesize, PageAccess_ReadWrite() );
+			handled = true;
+			return;
+		}
+	}
+
 	if( offset >= Ps2MemSize::MainRam ) return;
 
 	mmap_ClearCpuBlock( offset );
@@ -992,6 +1235,7 @@ void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& h
 void mmap_ResetBlockTracking()
 {
 	//DbgCon.WriteLn( "vtlb/mmap: Block Tracking reset..." );
+	mmap_EndSnapshot();
 	memzero( m_PageProtectInfo );
 	if (eeMem) HostSys::MemProtect( eeMem->Main, Ps2MemSize::MainRam, PageAccess_ReadWrite() );
 }
@@ -110,7 +110,7 @@ static __fi void ZeroQWC( u128& dest )
 extern void memSetKernelMode();
 //extern void memSetSupervisorMode();
 extern void memSetUserMode();
-extern void memSetPageAddr(u32 vaddr, u32 paddr);
+extern void memSetPageAddr(u32 vaddr, u32 paddr, bool cached = false);
 extern void memClearPageAddr(u32 vaddr);
 extern void memBindConditionalHandlers();
 
@@ -126,8 +126,15 @@ enum vtlb_ProtectionMode
 
 extern vtlb_ProtectionMode mmap_GetRamPageInfo( u32 paddr );
 extern void mmap_MarkCountedRamPage( u32 paddr );
+extern void mmap_MarkCodeRange( u32 paddr, u32 size );
 extern void mmap_ResetBlockTracking();
 
+// Copy-on-write snapshot of EE and IOP main memory (either destination may be NULL).
+// Begin and End must be called with the core thread paused.
+extern void mmap_BeginSnapshot( u8* eeDest, u8* iopDest );
+extern void mmap_WaitSnapshot();
+extern void mmap_EndSnapshot();
+
 #define memRead8 vtlb_memRead<mem8_t>
 #define memRead16 vtlb_memRead<mem16_t>
 #define memRead32 vtlb_memRead<mem32_t>
@@ -241,3 +241,9 @@ void MultipartFileReader::SetBlockSize(uint bytes)
 	}
 }
 
+void MultipartFileReader::SetReadBuffer(void* buffer, size_t size)
+{
+	for(uint i=0;i<m_numparts;i++)
+		m_parts[i].reader->SetReadBuffer(buffer, size);
+}
+
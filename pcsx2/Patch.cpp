@@ -20,6 +20,7 @@
 #include "IopCommon.h"
 #include "Patch.h"
 #include "GameDatabase.h"
+#include "Utilities/Instrumentation.h"
 
 #include <memory>
 #include <vector>
@@ -36,6 +37,8 @@ extern void _ApplyPatch(IniPatch *p);
 
 std::vector<IniPatch> Patch;
 
+u32 g_patchWrites = 0;
+
 wxString strgametitle;
 
 struct PatchTextTable
@@ -172,9 +175,12 @@ void inifile_process(wxTextFile &f1 )
 	}
 }
 
+static void InvalidateCompiledPatches();
+
 void ForgetLoadedPatches()
 {
 	Patch.clear();
+	InvalidateCompiledPatches();
 }
 
 static int _LoadPatchFiles(const wxDirName& folderName, wxString& fileSpec, const wxString& friendlyName, int& numberFoundPatchFiles)
@@ -340,6 +346,7 @@ namespace PatchFunc
 
 			iPatch.enabled = 1; // omg success!!
 			Patch.push_back(iPatch);
+			InvalidateCompiledPatches();
 
 		}
 		catch( wxString& exmsg )
@@ -351,12 +358,207 @@ namespace PatchFunc
 	void patch(const wxString& cmd, const wxString& param) { patchHelper(cmd, param); }
 }
 
+// --------------------------------------------------------------------------------------
+//  Compiled patches
+// --------------------------------------------------------------------------------------
+// The continuous patches are applied on every vsync, so on first use after a change the
+// loaded patches are compiled into one list per place.  A run of consecutive plain writes
+// with the same cpu and width becomes a group applied by a loop specialized for that width.
+// Extended (cheat code) lines go to groups of their own, since each line carries state over
+// to the next one.  Groups keep the order of the pnach lines, so overlapping patches still
+// resolve the same way.
+
+struct PatchWrite
+{
+	u32 addr;
+	u64 data;
+};
+
+struct PatchGroup
+{
+	patch_cpu_type cpu;
+	patch_data_type type;
+	u32 first;		// index into writes, or into extended for EXTENDED_T
+	u32 count;
+};
+
+struct CompiledPatches
+{
+	std::vector<PatchGroup> groups;
+	std::vector<PatchWrite> writes;
+	std::vector<IniPatch> extended;
+
+	void clear()
+	{
+		groups.clear();
+		writes.clear();
+		extended.clear();
+	}
+};
+
+static CompiledPatches s_compiled[_PPT_END_MARKER];
+static bool s_compiledValid = false;
+
+static void InvalidateCompiledPatches()
+{
+	s_compiledValid = false;
+}
+
+// Mirrors the cases handled by _ApplyPatch; anything else is never applied.
+static bool IsApplicablePatch(const IniPatch& p)
+{
+	if (!p.enabled || p.placetopatch < 0 || p.placetopatch >= _PPT_END_MARKER)
+		return false;
+
+	switch (p.cpu)
+	{
+	case CPU_EE:	return p.type >= BYTE_T && p.type <= EXTENDED_T;
+	case CPU_IOP:	return p.type >= BYTE_T && p.type <= WORD_T;
+	default:		return false;
+	}
+}
+
+static void CompilePatches()
+{
+	for (auto& list : s_compiled)
+		list.clear();
+
+	for (const auto& p : Patch)
+	{
+		if (!IsApplicablePatch(p)) continue;
+
+		CompiledPatches& list = s_compiled[p.placetopatch];
+		const bool extended = (p.type == EXTENDED_T);
+		const u32 index = extended ? list.extended.size() : list.writes.size();
+
+		if (list.groups.empty() || list.groups.back().cpu != p.cpu || list.groups.back().type != p.type)
+		{
+			PatchGroup group = { p.cpu, p.type, index, 0 };
+			list.groups.push_back(group);
+		}
+		++list.groups.back().count;
+
+		if (extended)
+			list.extended.push_back(p);
+		else
+		{
+			PatchWrite write = { p.addr, p.data };
+			list.writes.push_back(write);
+		}
+	}
+
+	s_compiledValid = true;
+}
+
+template< typename T >
+static u32 ApplyWritesEE(const PatchWrite* w, u32 count)
+{
+	u32 written = 0;
+	for (const PatchWrite* end = w + count; w != end; ++w)
+	{
+		if (vtlb_memRead<T>(w->addr) == (T)w->data) continue;
+		vtlb_memWrite<T>(w->addr, (T)w->data);
+		++written;
+	}
+	return written;
+}
+
+static u32 ApplyWritesEE64(const PatchWrite* w, u32 count)
+{
+	u32 written = 0;
+	for (const PatchWrite* end = w + count; w != end; ++w)
+	{
+		u64 mem;
+		memRead64(w->addr, &mem);
+		if (mem == w->data) continue;
+		memWrite64(w->addr, &w->data);
+		++written;
+	}
+	return written;
+}
+
+static u32 ApplyWritesIOP8(const PatchWrite* w, u32 count)
+{
+	u32 written = 0;
+	for (const PatchWrite* end = w + count; w != end; ++w)
+	{
+		if (iopMemRead8(w->addr) == (u8)w->data) continue;
+		iopMemWrite8(w->addr, (u8)w->data);
+		++written;
+	}
+	return written;
+}
+
+static u32 ApplyWritesIOP16(const PatchWrite* w, u32 count)
+{
+	u32 written = 0;
+	for (const PatchWrite* end = w + count; w != end; ++w)
+	{
+		if (iopMemRead16(w->addr) == (u16)w->data) continue;
+		iopMemWrite16(w->addr, (u16)w->data);
+		++written;
+	}
+	return written;
+}
+
+static u32 ApplyWritesIOP32(const PatchWrite* w, u32 count)
+{
+	u32 written = 0;
+	for (const PatchWrite* end = w + count; w != end; ++w)
+	{
+		if (iopMemRead32(w->addr) == (u32)w->data) continue;
+		iopMemWrite32(w->addr, (u32)w->data);
+		++written;
+	}
+	return written;
+}
+
 // This is for applying patches directly to memory
 void ApplyLoadedPatches(patch_place_type place)
 {
-	for (auto& i : Patch)
+	if (!s_compiledValid)
+		CompilePatches();
+
+	CompiledPatches& list = s_compiled[place];
+	if (list.groups.empty()) return;
+
+	u32 applied = 0, written = 0;
+
+	for (const auto& group : list.groups)
 	{
-		if (i.placetopatch == place)
-			_ApplyPatch(&i);
+		const PatchWrite* w = (group.type != EXTENDED_T) ? &list.writes[group.first] : NULL;
+		applied += group.count;
+
+		if (group.cpu == CPU_EE)
+		{
+			switch (group.type)
+			{
+			case BYTE_T:	written += ApplyWritesEE<mem8_t>(w, group.count); break;
+			case SHORT_T:	written += ApplyWritesEE<mem16_t>(w, group.count); break;
+			case WORD_T:	written += ApplyWritesEE<mem32_t>(w, group.count); break;
+			case DOUBLE_T:	written += ApplyWritesEE64(w, group.count); break;
+
+			case EXTENDED_T:
+				// Cheat codes may write any number of times (or not at all); not counted.
+				for (u32 i = 0; i < group.count; ++i)
+					_ApplyPatch(&list.extended[group.first + i]);
+				break;
+
+			default: break;
+			}
+		}
+		else
+		{
+			switch (group.type)
+			{
+			case BYTE_T:	written += ApplyWritesIOP8(w, group.count); break;
+			case SHORT_T:	written += ApplyWritesIOP16(w, group.count); break;
+			case WORD_T:	written += ApplyWritesIOP32(w, group.count); break;
+			default: break;
+			}
+		}
 	}
+
+	g_patchWrites += written;
+	Instrumentation::Add(Instrumentation::Counter_PatchWrite, written, applied);
 }
@@ -119,6 +119,10 @@ extern void ForgetLoadedPatches();
 
 extern const IConsoleWriter *PatchesCon;
 
+// Memory writes made by ApplyLoadedPatches so far; patches whose value is already in
+// memory don't write (or count).
+extern u32 g_patchWrites;
+
 // Patch loading is verbose only once after the crc changes, this makes it think that the crc changed.
 extern void PatchesVerboseReset();
 
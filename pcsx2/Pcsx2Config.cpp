@@ -27,6 +27,7 @@ void TraceLogFilters::LoadSave( IniInterface& ini )
 	ScopedIniGroup path( ini, L"TraceLog" );
 
 	IniEntry( Enabled );
+	IniEntry( Binary );
 	
 	// Retaining backwards compat of the trace log enablers isn't really important, and
 	// doing each one by hand would be murder.  So let's cheat and just save it as an int:
@@ -65,6 +66,8 @@ void Pcsx2Config::SpeedhackOptions::LoadSave( IniInterface& ini )
 	IniBitBool( WaitLoop );
 	IniBitBool( vuFlagHack );
 	IniBitBool( vuThread );
+	IniBitBool( vu0Thread );
+	IniBitBool( IopHle );
 }
 
 void Pcsx2Config::ProfilerOptions::LoadSave( IniInterface& ini )
@@ -89,6 +92,8 @@ Pcsx2Config::RecompilerOptions::RecompilerOptions()
 
 	EnableEE	= true;
 	EnableEECache = false;
+	EnableMicroVUCache = false;
+	EnableEETiering = false;
 	EnableIOP	= true;
 	EnableVU0	= true;
 	EnableVU1	= true;
@@ -147,11 +152,13 @@ void Pcsx2Config::RecompilerOptions::LoadSave( IniInterface& ini )
 	IniBitBool( EnableEE );
 	IniBitBool( EnableIOP );
 	IniBitBool( EnableEECache );
+	IniBitBool( EnableEETiering );
 	IniBitBool( EnableVU0 );
 	IniBitBool( EnableVU1 );
 
 	IniBitBool( UseMicroVU0 );
 	IniBitBool( UseMicroVU1 );
+	IniBitBool( EnableMicroVUCache );
 
 	IniBitBool( vuOverflow );
 	IniBitBool( vuExtraOverflow );
@@ -205,9 +212,13 @@ Pcsx2Config::GSOptions::GSOptions()
 
 	SynchronousMTGS			= false;
 	VsyncQueueSize			= 2;
+	VsyncQueueAdaptive		= false;
+	RingSizeFactor			= 19;	// 8mb, see RingBufferSizeFactor
 
 	FramesToDraw			= 2;
 	FramesToSkip			= 2;
+	FastForwardInterval		= 8;
+	FrameLimitSpinUs		= 1000;
 
 	LimitScalar				= 1.0;
 	FramerateNTSC			= 59.94;
@@ -220,6 +231,8 @@ void Pcsx2Config::GSOptions::LoadSave( IniInterface& ini )
 
 	IniEntry( SynchronousMTGS );
 	IniEntry( VsyncQueueSize );
+	IniEntry( VsyncQueueAdaptive );
+	IniEntry( RingSizeFactor );
 
 	IniEntry( FrameLimitEnable );
 	IniEntry( FrameSkipEnable );
@@ -231,11 +244,13 @@ void Pcsx2Config::GSOptions::LoadSave( IniInterface& ini )
 
 	IniEntry( FramesToDraw );
 	IniEntry( FramesToSkip );
+	IniEntry( FastForwardInterval );
+	IniEntry( FrameLimitSpinUs );
 }
 
 int Pcsx2Config::GSOptions::GetVsync() const
 {
-	if (g_LimiterMode == Limit_Turbo || !FrameLimitEnable)
+	if (g_LimiterMode == Limit_Turbo || g_LimiterMode == Limit_FastForward || !FrameLimitEnable)
 		return 0;
 
 	// D3D only support a boolean state. OpenGL waits a number of vsync
@@ -425,6 +440,13 @@ Pcsx2Config::Pcsx2Config()
 	McdFolderAutoManage = true;
 	EnablePatches = true;
 	BackupSavestate = true;
+	CdvdMappedReads = true;
+	CdvdReadQueueDepth = 8;
+	CdvdRemoteCacheMB = 8192;
+	CdvdRemoteConnections = 4;
+	RewindInterval = 0;
+	RewindBudgetMB = 64;
+	RunAheadFrames = 0;
 }
 
 void Pcsx2Config::LoadSave( IniInterface& ini )
@@ -434,6 +456,13 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 	IniBitBool( CdvdVerboseReads );
 	IniBitBool( CdvdDumpBlocks );
 	IniBitBool( CdvdShareWrite );
+	IniBitBool( CdvdMappedReads );
+	IniEntry( CdvdReadQueueDepth );
+	IniEntry( CdvdRemoteCacheMB );
+	IniEntry( CdvdRemoteConnections );
+	IniEntry( RewindInterval );
+	IniEntry( RewindBudgetMB );
+	IniEntry( RunAheadFrames );
 	IniBitBool( EnablePatches );
 	IniBitBool( EnableCheats );
 	IniBitBool( EnableWideScreenPatches );
@@ -442,8 +471,13 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 #endif
 	IniBitBool( ConsoleToStdio );
 	IniBitBool( HostFs );
+	IniBitBool( HostLargePages );
+	IniBitBool( ShareRomMemory );
+	IniBitBool( FastBootSnapshot );
 
 	IniBitBool( BackupSavestate );
+	IniBitBool( CopyOnWriteSaves );
+	IniBitBool( DiffSavestates );
 	IniBitBool( McdEnableEjection );
 	IniBitBool( McdFolderAutoManage );
 	IniBitBool( MultitapPort0_Enabled );
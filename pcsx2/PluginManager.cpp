@@ -19,10 +19,13 @@
 #include <wx/dir.h>
 #include <wx/file.h>
 #include <memory>
+#include <future>
 
 #include "GS.h"
 #include "Gif.h"
 #include "CDVD/CDVDisoReader.h"
+#include "Rewind.h"
+#include "RunAhead.h"
 
 #include "Utilities/pxStreams.h"
 
@@ -295,6 +298,8 @@ _SPU2interruptDMA7 SPU2interruptDMA7;
 _SPU2ReadMemAddr   SPU2ReadMemAddr;
 _SPU2WriteMemAddr   SPU2WriteMemAddr;
 _SPU2setupRecording SPU2setupRecording;
+_SPU2setFastForward SPU2setFastForward;
+_SPU2setMute SPU2setMute;
 _SPU2irqCallback   SPU2irqCallback;
 
 _SPU2setClockPtr   SPU2setClockPtr;
@@ -594,6 +599,8 @@ static const LegacyApi_OptMethod s_MethMessOpt_SPU2[] =
 	{	"SPU2WriteMemAddr",		(vMeth**)&SPU2WriteMemAddr	},
 	{	"SPU2setDMABaseAddr",	(vMeth**)&SPU2setDMABaseAddr},
 	{	"SPU2setupRecording",	(vMeth**)&SPU2setupRecording},
+	{	"SPU2setFastForward",	(vMeth**)&SPU2setFastForward},
+	{	"SPU2setMute",			(vMeth**)&SPU2setMute},
 
 	{ NULL }
 };
@@ -894,6 +901,57 @@ bool DynamicLibrary::HasSymbol(const wxString &name)
 	return Lib.HasSymbol(name);
 }
 
+// GSdx is built once per instruction set (GSdx32-SSE2/-SSE4/-AVX2[-dbg] on Windows, libGSdx,
+// libGSdx-SSE4 and libGSdx-AVX2 elsewhere) since its vector code is selected at compile time,
+// and a wrong pick either fails its cpu check or silently runs the slower code.  Whichever of
+// them is configured, bind the best build of the same folder the host supports.
+static wxString GetBestGSdxBuild( const wxString& srcfile )
+{
+	wxFileName fn( srcfile );
+	wxString name( fn.GetName() );
+	wxString dbg, base;
+
+	if( name.EndsWith( L"-dbg", &base ) )
+	{
+		dbg = L"-dbg";
+		name = base;
+	}
+
+	// The SSE2 build has no suffix outside of Windows
+	wxString sse2( L"-SSE2" );
+
+	if( !name.EndsWith( L"-AVX2", &base ) && !name.EndsWith( L"-SSE4", &base ) && !name.EndsWith( L"-SSE2", &base ) )
+	{
+		base = name;
+		sse2.clear();
+	}
+
+	if( !base.Lower().Contains( L"gsdx" ) ) return srcfile;
+
+	std::vector<wxString> builds;
+
+	if( x86caps.hasAVX2 && x86caps.hasBMI1 && x86caps.hasBMI2 )
+		builds.push_back( L"-AVX2" );
+	if( x86caps.hasSupplementalStreamingSIMD3Extensions && x86caps.hasStreamingSIMD4Extensions )
+		builds.push_back( L"-SSE4" );
+	builds.push_back( sse2 );
+
+	for( const wxString& isa : builds )
+	{
+		fn.SetName( base + isa + dbg );
+
+		if( fn.FileExists() )
+		{
+			if( fn.GetFullPath() != srcfile )
+				Console.WriteLn( L"(GSdx) %s is the best build for this cpu, bound instead of %s", WX_STR(fn.GetFullName()), WX_STR(wxFileName(srcfile).GetFullName()) );
+
+			return fn.GetFullPath();
+		}
+	}
+
+	return srcfile;
+}
+
 // ---------------------------------------------------------------------------------
 //  PluginStatus_t Implementations
 // ---------------------------------------------------------------------------------
@@ -903,7 +961,7 @@ SysCorePlugins::SysCorePlugins() :
 }
 
 SysCorePlugins::PluginStatus_t::PluginStatus_t( PluginsEnum_t _pid, const wxString& srcfile )
-	: Filename( srcfile )
+	: Filename( _pid == PluginId_GS ? GetBestGSdxBuild( srcfile ) : srcfile )
 {
 	pid = _pid;
 
@@ -1095,7 +1153,7 @@ void SysCorePlugins::Load( PluginsEnum_t pid, const wxString& srcfile )
 	m_info[pid] = std::make_unique<PluginStatus_t>(pid, srcfile);
 
 	Console.Indent().WriteLn(L"Bound %4s: %s [%s %s]", WX_STR(tbl_PluginInfo[pid].GetShortname()), 
-		WX_STR(wxFileName(srcfile).GetFullName()), WX_STR(m_info[pid]->Name), WX_STR(m_info[pid]->Version));
+		WX_STR(wxFileName(m_info[pid]->Filename).GetFullName()), WX_STR(m_info[pid]->Name), WX_STR(m_info[pid]->Version));
 }
 
 void SysCorePlugins::Load( const wxString (&folders)[PluginId_Count] )
@@ -1122,6 +1180,7 @@ void SysCorePlugins::Load( const wxString (&folders)[PluginId_Count] )
 	m_info[PluginId_PAD]->CommonBindings.Init = _hack_PADinit;
 
 	Console.WriteLn( Color_StrongBlue, "Plugins loaded successfully.\n" );
+	SysStartupMark( SysStartup_PluginsLoaded );
 
 	// HACK!  Manually bind the Internal MemoryCard plugin for now, until
 	// we get things more completed in the new plugin api.
@@ -1475,9 +1534,39 @@ bool SysCorePlugins::Init()
 	if( !NeedsInit() ) return false;
 
 	Console.WriteLn( Color_StrongBlue, "Initializing plugins..." );
-	const PluginInfo* pi = tbl_PluginInfo; do {
-		Init( pi->id );
-	} while( ++pi, pi->shortname != NULL );
+
+	// The plugins don't depend on each other to init, so they are initialized in parallel.
+	// GS and PAD still init on this thread (deferred, run by get() below): GSdx sets up COM
+	// for the thread it is initialized from, and pad plugins can hook the calling thread.
+	{
+		ScopedLock lock( m_mtx_PluginStatus );
+
+		std::future<s32> results[PluginId_Count];
+
+		const PluginInfo* pi = tbl_PluginInfo; do {
+			PluginStatus_t* info = m_info[pi->id].get();
+			if( !info || info->IsInitialized ) continue;
+
+			Console.Indent().WriteLn( "Init %s", pi->shortname );
+			const bool here = (pi->id == PluginId_GS) || (pi->id == PluginId_PAD);
+			results[pi->id] = std::async( here ? std::launch::deferred : std::launch::async, info->CommonBindings.Init );
+		} while( ++pi, pi->shortname != NULL );
+
+		// All of them are waited for, the first failure (in init order) is thrown afterwards
+		PluginsEnum_t failed = PluginId_Count;
+
+		pi = tbl_PluginInfo; do {
+			if( !results[pi->id].valid() ) continue;
+
+			if( 0 == results[pi->id].get() )
+				m_info[pi->id]->IsInitialized = true;
+			else if( failed == PluginId_Count )
+				failed = pi->id;
+		} while( ++pi, pi->shortname != NULL );
+
+		if( failed != PluginId_Count )
+			throw Exception::PluginInitError( failed );
+	}
 
 	if( SysPlugins.Mcd == NULL )
 	{
@@ -1491,6 +1580,7 @@ bool SysCorePlugins::Init()
 	}
 
 	Console.WriteLn( Color_StrongBlue, "Plugins initialized successfully.\n" );
+	SysStartupMark( SysStartup_PluginsInit );
 
 	return true;
 }
@@ -1537,21 +1627,27 @@ bool SysCorePlugins::Shutdown()
 
 // For internal use only, unless you're the MTGS.  Then it's for you too!
 // Returns false if the plugin returned an error.
-bool SysCorePlugins::DoFreeze( PluginsEnum_t pid, int mode, freezeData* data )
+// result (optional) receives the value returned by the plugin (0 if it isn't loaded).
+bool SysCorePlugins::DoFreeze( PluginsEnum_t pid, int mode, freezeData* data, s32* result )
 {
+	s32 retval = 0;
+
 	if( (pid == PluginId_GS) && !GetMTGS().IsSelf() )
 	{
 		// GS needs some thread safety love...
 
 		MTGS_FreezeData woot = { data, 0 };
 		GetMTGS().Freeze( mode, woot );
-		return woot.retval != -1;
+		retval = woot.retval;
 	}
 	else
 	{
 		ScopedLock lock( m_mtx_PluginStatus );
-		return !m_info[pid] || m_info[pid]->CommonBindings.Freeze( mode, data ) != -1;
+		if( m_info[pid] ) retval = m_info[pid]->CommonBindings.Freeze( mode, data );
 	}
+
+	if( result ) *result = retval;
+	return retval != -1;
 }
 
 // Thread Safety:
@@ -1571,8 +1667,9 @@ void SysCorePlugins::Freeze( PluginsEnum_t pid, SaveStateBase& state )
 	int fsize = fP.size;
 	state.Freeze( fsize );
 
-	Console.Indent().WriteLn( "%s %s", state.IsSaving() ? "Saving" : "Loading",
-		tbl_PluginInfo[pid].shortname );
+	if( !Rewind::IsCapturing() && !RunAhead::IsCapturing() && !state.IsSizing() )
+		Console.Indent().WriteLn( "%s %s", state.IsSaving() ? "Saving" : "Loading",
+			tbl_PluginInfo[pid].shortname );
 
 	if( state.IsLoading() && (fsize == 0) )
 	{
@@ -1591,17 +1688,32 @@ void SysCorePlugins::Freeze( PluginsEnum_t pid, SaveStateBase& state )
 	fP.size = fsize;
 	if( fP.size == 0 ) return;
 
+	if( state.IsSizing() )
+	{
+		state.CommitBlock( fP.size );
+		return;
+	}
+
 	state.PrepBlock( fP.size );
 	fP.data = (s8*)state.GetBlockPtr();
 
+	// The incremental modes return 0 from the plugins that don't know them
+	s32 handled = 0;
+
 	if( state.IsSaving() )
 	{
-		if( !DoFreeze(pid, FREEZE_SAVE, &fP) )
+		if( pid == PluginId_GS && state.IsIncremental() )
+			DoFreeze(pid, FREEZE_SAVE_INCREMENTAL, &fP, &handled);
+
+		if( handled != 1 && !DoFreeze(pid, FREEZE_SAVE, &fP) )
 			throw Exception::FreezePluginFailure( pid );
 	}
 	else
 	{
-		if( !DoFreeze(pid, FREEZE_LOAD, &fP) )
+		if( pid == PluginId_GS && state.IsRollback() )
+			DoFreeze(pid, FREEZE_LOAD_INCREMENTAL, &fP, &handled);
+
+		if( handled != 1 && !DoFreeze(pid, FREEZE_LOAD, &fP) )
 			throw Exception::ThawPluginFailure( pid );
 	}
 
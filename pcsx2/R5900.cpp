@@ -34,9 +34,11 @@
 #include "CDVD/CDVD.h"
 #include "Patch.h"
 #include "GameDatabase.h"
+#include "BootSnapshot.h"
 
 #include "../DebugTools/Breakpoints.h"
 #include "R5900OpcodeTables.h"
+#include "Utilities/Instrumentation.h"
 
 using namespace R5900;	// for R5900 disasm tools
 
@@ -72,10 +74,12 @@ extern SysMainMemory& GetVmMemory();
 void cpuReset()
 {
 	vu1Thread.WaitVU();
+	vu0Thread.WaitVU();
 	if (GetMTGS().IsOpen())
 		GetMTGS().WaitGS();		// GS better be done processing before we reset the EE, just in case.
 
 	GetVmMemory().ResetAll();
+	vu1Thread.DiscardMicroShadow();
 
 	memzero(cpuRegs);
 	memzero(fpuRegs);
@@ -88,6 +92,8 @@ void cpuReset()
 	fpuRegs.fprc[0]			= 0x00002e30; // fpu Revision..
 	fpuRegs.fprc[31]		= 0x01000001; // fpu Status/Control
 
+	cpuRebuildEventQueue();
+
 	g_nextEventCycle = cpuRegs.cycle + 4;
 	EEsCycle = 0;
 	EEoCycle = cpuRegs.cycle;
@@ -259,64 +265,248 @@ __fi void cpuSetEvent()
 	g_nextEventCycle = cpuRegs.cycle;
 }
 
-__fi void cpuClearInt( uint i )
+// --------------------------------------------------------------------------------------
+//  EE event queue
+// --------------------------------------------------------------------------------------
+// Pending CPU_INT events, kept in a binary min-heap on their due cycle so that an event test
+// only has to look at the events that are actually due, and the next one is simply the top.
+//
+// cpuRegs.interrupt/sCycle/eCycle remain the authoritative (savestated) state.  Some of the
+// DMA code clears interrupt bits or rewrites eCycle directly, so entries are re-validated
+// against them whenever they come due or reach the top, rather than trusted blindly.
+
+struct EventHandler
 {
-	pxAssume( i < 32 );
-	cpuRegs.interrupt &= ~(1 << i);
+	EE_EventType	event;
+	void			(*callback)();
+};
+
+// Events are dispatched in this order when several are due in the same event test.
+static const EventHandler s_eventHandlers[] =
+{
+	{ DMAC_VIF1,		vif1Interrupt },
+	{ DMAC_GIF,			gifInterrupt },
+	{ DMAC_SIF0,		EEsif0Interrupt },
+	{ DMAC_SIF1,		EEsif1Interrupt },
+
+	{ DMAC_VIF0,		vif0Interrupt },
+
+	{ DMAC_FROM_IPU,	ipu0Interrupt },
+	{ DMAC_TO_IPU,		ipu1Interrupt },
+
+	{ DMAC_FROM_SPR,	SPRFROMinterrupt },
+	{ DMAC_TO_SPR,		SPRTOinterrupt },
+
+	{ DMAC_MFIFO_VIF,	vifMFIFOInterrupt },
+	{ DMAC_MFIFO_GIF,	gifMFIFOInterrupt },
+
+	{ VIF_VU0_FINISH,	vif0VUFinish },
+	{ VIF_VU1_FINISH,	vif1VUFinish },
+};
+
+// Events without a handler above (SIF2) never fire, so they're never queued either.
+static const u32 s_eventHandledMask =
+	(1 << DMAC_VIF1) | (1 << DMAC_GIF) | (1 << DMAC_SIF0) | (1 << DMAC_SIF1) | (1 << DMAC_VIF0) |
+	(1 << DMAC_FROM_IPU) | (1 << DMAC_TO_IPU) | (1 << DMAC_FROM_SPR) | (1 << DMAC_TO_SPR) |
+	(1 << DMAC_MFIFO_VIF) | (1 << DMAC_MFIFO_GIF) | (1 << VIF_VU0_FINISH) | (1 << VIF_VU1_FINISH);
+
+static u8	s_eventHeap[32];		// event ids, in heap order
+static u8	s_eventHeapPos[32];		// 1 + position of each event in s_eventHeap, 0 when not queued
+static u32	s_eventDue[32];			// cycle each queued event is due at
+static uint	s_eventHeapSize = 0;
+
+u32 g_eeEventTests = 0;
+
+static __fi bool eventHeapLess( uint a, uint b )
+{
+	return (s32)(s_eventDue[s_eventHeap[a]] - s_eventDue[s_eventHeap[b]]) < 0;
 }
 
-static __fi void TESTINT( u8 n, void (*callback)() )
+static __fi void eventHeapSwap( uint a, uint b )
 {
-	if( !(cpuRegs.interrupt & (1 << n)) ) return;
+	std::swap( s_eventHeap[a], s_eventHeap[b] );
+	s_eventHeapPos[s_eventHeap[a]] = a + 1;
+	s_eventHeapPos[s_eventHeap[b]] = b + 1;
+}
 
-	if( cpuTestCycle( cpuRegs.sCycle[n], cpuRegs.eCycle[n] ) )
+static uint eventHeapSiftUp( uint pos )
+{
+	while (pos > 0)
 	{
-		cpuClearInt( n );
-		callback();
+		const uint parent = (pos - 1) / 2;
+		if (!eventHeapLess( pos, parent )) break;
+		eventHeapSwap( pos, parent );
+		pos = parent;
+	}
+	return pos;
+}
+
+static void eventHeapSiftDown( uint pos )
+{
+	while (true)
+	{
+		const uint left = pos * 2 + 1;
+		if (left >= s_eventHeapSize) break;
+
+		uint child = left;
+		if (left + 1 < s_eventHeapSize && eventHeapLess( left + 1, left )) child = left + 1;
+		if (!eventHeapLess( child, pos )) break;
+
+		eventHeapSwap( pos, child );
+		pos = child;
+	}
+}
+
+// Queues an event, or moves it if it's already queued.
+static void eventQueueSet( uint n, u32 due )
+{
+	s_eventDue[n] = due;
+
+	if (!s_eventHeapPos[n])
+	{
+		const uint pos = s_eventHeapSize++;
+		s_eventHeap[pos] = n;
+		s_eventHeapPos[n] = pos + 1;
+		eventHeapSiftUp( pos );
 	}
 	else
-		cpuSetNextEvent( cpuRegs.sCycle[n], cpuRegs.eCycle[n] );
+		eventHeapSiftDown( eventHeapSiftUp( s_eventHeapPos[n] - 1 ) );
+}
+
+static void eventQueueRemove( uint n )
+{
+	if (!s_eventHeapPos[n]) return;
+
+	const uint pos = s_eventHeapPos[n] - 1;
+	const uint last = --s_eventHeapSize;
+	s_eventHeapPos[n] = 0;
+
+	if (pos == last) return;
+
+	s_eventHeap[pos] = s_eventHeap[last];
+	s_eventHeapPos[s_eventHeap[pos]] = pos + 1;
+	eventHeapSiftDown( eventHeapSiftUp( pos ) );
+}
+
+// Returns the mask of queued events whose due cycle has passed.  The subtrees of events that
+// aren't due yet can be skipped entirely, so this is a single compare when nothing is due.
+static u32 eventQueueDueMask()
+{
+	u32 mask = 0;
+	u8 stack[32];
+	uint sp = 0;
+
+	if (s_eventHeapSize) stack[sp++] = 0;
+
+	while (sp)
+	{
+		const uint pos = stack[--sp];
+		const uint n = s_eventHeap[pos];
+
+		if ((s32)(cpuRegs.cycle - s_eventDue[n]) < 0) continue;
+
+		mask |= 1 << n;
+
+		const uint left = pos * 2 + 1;
+		if (left < s_eventHeapSize) stack[sp++] = left;
+		if (left + 1 < s_eventHeapSize) stack[sp++] = left + 1;
+	}
+
+	return mask;
+}
+
+// Drops or re-sorts stale entries at the top of the heap, so that the top is the next event
+// that will really fire.
+static void eventQueueValidateTop()
+{
+	while (s_eventHeapSize)
+	{
+		const uint n = s_eventHeap[0];
+
+		if (!(cpuRegs.interrupt & (1 << n)))
+			eventQueueRemove( n );
+		else if (s_eventDue[n] != cpuRegs.sCycle[n] + cpuRegs.eCycle[n])
+			eventQueueSet( n, cpuRegs.sCycle[n] + cpuRegs.eCycle[n] );
+		else
+			break;
+	}
+}
+
+// Rebuilds the queue from cpuRegs, after a reset or a savestate load.
+void cpuRebuildEventQueue()
+{
+	s_eventHeapSize = 0;
+	memzero( s_eventHeapPos );
+
+	const u32 pending = cpuRegs.interrupt & s_eventHandledMask;
+	for (uint n = 0; n < 32; ++n)
+	{
+		if (pending & (1 << n))
+			eventQueueSet( n, cpuRegs.sCycle[n] + cpuRegs.eCycle[n] );
+	}
+}
+
+__fi void cpuClearInt( uint i )
+{
+	pxAssume( i < 32 );
+	cpuRegs.interrupt &= ~(1 << i);
+	eventQueueRemove( i );
 }
 
+// Dispatches the due events, in s_eventHandlers order.  Handlers can raise or clear other
+// events, which may make some of them due within this same pass.  Returns the number of
+// events dispatched.
+//
 // [TODO] move this function to LegacyDmac.cpp, and remove most of the DMAC-related headers from
 // being included into R5900.cpp.
-static __fi void _cpuTestInterrupts()
+static __fi uint _cpuTestInterrupts()
 {
 	if (!dmacRegs.ctrl.DMAE || (psHu8(DMAC_ENABLER+2) & 1))
 	{
 		//Console.Write("DMAC Disabled or suspended");
-		return;
+		return 0;
 	}
 	/* These are 'pcsx2 interrupts', they handle asynchronous stuff
 	   that depends on the cycle timings */
 
-	TESTINT(DMAC_VIF1,		vif1Interrupt);	
-	TESTINT(DMAC_GIF,		gifInterrupt);
-	TESTINT(DMAC_SIF0,		EEsif0Interrupt);
-	TESTINT(DMAC_SIF1,		EEsif1Interrupt);
-	
-	// Profile-guided Optimization (sorta)
-	// The following ints are rarely called.  Encasing them in a conditional
-	// as follows helps speed up most games.
+	uint dispatched = 0;
+	u32 due = eventQueueDueMask();
 
-	if (cpuRegs.interrupt & ((1 << DMAC_VIF0) | (1 << DMAC_FROM_IPU) | (1 << DMAC_TO_IPU)
-		| (1 << DMAC_FROM_SPR) | (1 << DMAC_TO_SPR) | (1 << DMAC_MFIFO_VIF) | (1 << DMAC_MFIFO_GIF)
-		| (1 << VIF_VU0_FINISH) | (1 << VIF_VU1_FINISH)))
+	for (uint i = 0; due && i < ArraySize(s_eventHandlers); ++i)
 	{
-		TESTINT(DMAC_VIF0,		vif0Interrupt);
+		const uint n = s_eventHandlers[i].event;
+		if (!(due & (1 << n))) continue;
 
-		TESTINT(DMAC_FROM_IPU,	ipu0Interrupt);
-		TESTINT(DMAC_TO_IPU,	ipu1Interrupt);
+		due &= ~(1 << n);
+
+		if (!(cpuRegs.interrupt & (1 << n)))
+		{
+			eventQueueRemove( n );
+			continue;
+		}
+
+		if (!cpuTestCycle( cpuRegs.sCycle[n], cpuRegs.eCycle[n] ))
+		{
+			// eCycle was pushed back behind our back.
+			eventQueueSet( n, cpuRegs.sCycle[n] + cpuRegs.eCycle[n] );
+			continue;
+		}
 
-		TESTINT(DMAC_FROM_SPR,	SPRFROMinterrupt);
-		TESTINT(DMAC_TO_SPR,	SPRTOinterrupt);
+		cpuClearInt( n );
+		s_eventHandlers[i].callback();
+		++dispatched;
 
-		TESTINT(DMAC_MFIFO_VIF, vifMFIFOInterrupt);
-		TESTINT(DMAC_MFIFO_GIF, gifMFIFOInterrupt);
+		due = eventQueueDueMask();
+	}
 
-		TESTINT(VIF_VU0_FINISH, vif0VUFinish);
-		TESTINT(VIF_VU1_FINISH, vif1VUFinish);
+	eventQueueValidateTop();
+	if (s_eventHeapSize)
+	{
+		const uint n = s_eventHeap[0];
+		cpuSetNextEvent( cpuRegs.sCycle[n], cpuRegs.eCycle[n] );
 	}
+
+	return dispatched;
 }
 
 static __fi void _cpuTestTIMR()
@@ -369,6 +559,7 @@ __fi void _cpuEventTest_Shared()
 {
 	ScopedBool etest(eeEventTestIsActive);
 	g_nextEventCycle = cpuRegs.cycle + eeWaitCycles;
+	++g_eeEventTests;
 
 	// ---- INTC / DMAC (CPU-level Exceptions) -----------------
 	// Done first because exceptions raised during event tests need to be postponed a few
@@ -398,7 +589,7 @@ __fi void _cpuEventTest_Shared()
 	// These are basically just DMAC-related events, which also piggy-back the same bits as
 	// the PS2's own DMA channel IRQs and IRQ Masks.
 
-	_cpuTestInterrupts();
+	Instrumentation::Add( Instrumentation::Counter_EEEventTest, _cpuTestInterrupts() );
 
 	// ---- IOP -------------
 	// * It's important to run a iopEventTest before calling ExecuteBlock. This
@@ -515,6 +706,9 @@ __fi void CPU_INT( EE_EventType n, s32 ecycle)
 	cpuRegs.sCycle[n] = cpuRegs.cycle;
 	cpuRegs.eCycle[n] = ecycle;
 
+	if (s_eventHandledMask & (1 << n))
+		eventQueueSet( n, cpuRegs.cycle + ecycle );
+
 	// Interrupt is happening soon: make sure both EE and IOP are aware.
 
 	if( ecycle <= 28 && iopCycleEE > 0 )
@@ -592,9 +786,22 @@ int ParseArgumentString(u32 arg_block)
 	return argc;
 }
 
+// Finds EELOAD's main function from the 'jal' of its _start, once EELOAD is in memory.
+void eeloadFindMain()
+{
+	// The EELOAD _start function is the same across all BIOS versions
+	u32 mainjump = memRead32(EELOAD_START + 0x9c);
+	if (mainjump >> 26 == 3) // JAL
+		g_eeloadMain = ((EELOAD_START + 0xa0) & 0xf0000000U) | (mainjump << 2 & 0x0fffffffU);
+}
+
 // Called from recompilers; __fastcall define is mandatory.
 void __fastcall eeloadHook()
 {
+	// The BIOS is done initializing and nothing has been chosen yet, the state is the same for every boot
+	if (cpuRegs.GPR.n.a0.SD[0] == 0)
+		BootSnapshot::Capture();
+
 	const wxString &elf_override = GetCoreThread().GetElfOverride();
 
 	if (!elf_override.IsEmpty())
@@ -778,7 +985,8 @@ int isBreakpointNeeded(u32 addr)
 
 int isMemcheckNeeded(u32 pc)
 {
-	if (CBreakPoints::GetNumMemchecks() == 0)
+	// Watched pages check their own accesses.
+	if (CBreakPoints::GetNumMemchecks() == 0 || CBreakPoints::HasMemcheckPages())
 		return 0;
 	
 	u32 addr = pc;
@@ -275,6 +275,7 @@ const u32 EELOAD_START		= 0x82000;
 const u32 EELOAD_SIZE		= 0x20000; // overestimate for searching
 extern u32 g_eeloadMain, g_eeloadExec;
 
+extern void eeloadFindMain();
 extern void __fastcall eeGameStarting();
 extern void __fastcall eeloadHook();
 extern void __fastcall eeloadHook2();
@@ -391,6 +392,16 @@ struct R5900cpu
 	//   doesn't matter if we're stripping it out soon. ;)
 	//
 	void (*Clear)(u32 Addr, u32 Size);
+
+	// Called by the VTLB block protection when a write-protected page takes a write that
+	// doesn't touch any of the page's recompiled code.  The page is no longer protected, so
+	// its blocks must be re-validated before they are executed again (but needn't be
+	// thrown away).  Addr is the physical address of the page.
+	//
+	// Thread Affinity Rule:
+	//   Called from the page fault handler of the thread that did the write.
+	//
+	void (*SuspendPage)(u32 Addr);
 	
 	uint (*GetCacheReserve)();
 	void (*SetCacheReserve)( uint reserveInMegs );
@@ -438,6 +449,7 @@ extern void cpuTlbMissR(u32 addr, u32 bd);
 extern void cpuTlbMissW(u32 addr, u32 bd);
 extern void cpuTestHwInts();
 extern void cpuClearInt(uint n);
+extern void cpuRebuildEventQueue();
 extern void __fastcall GoemonPreloadTlb();
 extern void __fastcall GoemonUnloadTlb(u32 key);
 
@@ -446,6 +458,9 @@ extern void cpuSetNextEventDelta( s32 delta );
 extern int  cpuTestCycle( u32 startCycle, s32 delta );
 extern void cpuSetEvent();
 
+// Number of EE event tests run so far (wraps).
+extern u32 g_eeEventTests;
+
 extern void _cpuEventTest_Shared();		// for internal use by the Dynarecs and Ints inside R5900:
 
 extern void cpuTestINTCInts();
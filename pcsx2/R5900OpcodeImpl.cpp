@@ -23,6 +23,7 @@
 #include "R5900OpcodeTables.h"
 #include "R5900Exceptions.h"
 #include "GS.h"
+#include "MTVU.h"
 
 GS_VideoMode gsVideoMode = GS_VideoMode::Uninitialized;
 bool gsIsInterlaced = false;
@@ -260,6 +261,7 @@ void COP2()
 	//disR5900Fasm(disOut, cpuRegs.code, cpuRegs.pc);
 
 	//VU0_LOG("%s", disOut.c_str());
+	if (THREAD_VU0) vu0Thread.WaitVU(); // COP2 ops all touch VU0 state
 	Int_COP2PrintTable[_Rs_]();
 }
 
@@ -23,6 +23,8 @@
 
 #include "InputRecordingFile.h"
 
+#include <zlib.h>
+
 long InputRecordingFile::GetBlockSeekPoint(const long & frame)
 {
 	if (savestate.fromSavestate)
@@ -59,6 +61,19 @@ bool InputRecordingFile::Open(const wxString path, bool fNewOpen, bool fromSaveS
 
 	if (fNewOpen)
 	{
+		// The chunks are appended, everything before them must be there first
+		header.version = 2;
+		savestate.fromSavestate = fromSaveState;
+		chunked = true;
+		chunkOffsets.clear();
+		WriteHeader();
+		WriteMaxFrame();
+		fseek(recordingFile, RecordingSeekpointUndoCount, SEEK_SET);
+		fwrite(&UndoCount, 4, 1, recordingFile);
+		WriteSaveState();
+		WriteChunkIndex();
+		StartChunkWriter();
+
 		if (fromSaveState)
 		{
 			savestate.fromSavestate = true;
@@ -85,6 +100,16 @@ bool InputRecordingFile::Close()
 	{
 		return false;
 	}
+	if (chunked)
+	{
+		SubmitChunk();
+		StopChunkWriter();
+		if (indexStale)
+			WriteChunkIndex();
+		chunked = false;
+		WriteMaxFrame();
+		currentChunk = ~0u;
+	}
 	WriteHeader();
 	WriteSaveState();
 	fclose(recordingFile);
@@ -93,6 +118,275 @@ bool InputRecordingFile::Close()
 	return true;
 }
 
+// The pad data of a frame, in the chunk that is loaded for it (version 2)
+u8* InputRecordingFile::AccessChunk(unsigned long frame)
+{
+	const u32 chunk = frame / RecordingChunkFrames;
+
+	if (chunk != currentChunk)
+	{
+		SubmitChunk();
+
+		currentChunk = chunk;
+		currentData.assign(RecordingChunkSize, 0);
+
+		std::lock_guard<std::mutex> lock(chunkLock);
+
+		auto pending = pendingChunks.find(chunk);
+		if (pending != pendingChunks.end())
+		{
+			currentData = pending->second.second;
+		}
+		else if (chunk < chunkOffsets.size() && chunkOffsets[chunk])
+		{
+			u32 record[3];
+			std::vector<u8> packed;
+			uLongf size = RecordingChunkSize;
+
+			bool ok = fseek(recordingFile, chunkOffsets[chunk], SEEK_SET) == 0
+				&& fread(record, sizeof(record), 1, recordingFile) == 1
+				&& record[0] == RecordingChunkMagic && record[1] == chunk;
+			if (ok)
+			{
+				packed.resize(record[2]);
+				ok = fread(packed.data(), 1, packed.size(), recordingFile) == packed.size()
+					&& uncompress(currentData.data(), &size, packed.data(), packed.size()) == Z_OK;
+			}
+			if (!ok)
+			{
+				recordingConLog(wxString::Format("[REC]: Could not read the pad data of frames %u to %u.\n",
+					chunk * RecordingChunkFrames, (chunk + 1) * RecordingChunkFrames - 1));
+				currentData.assign(RecordingChunkSize, 0);
+			}
+		}
+	}
+
+	return &currentData[(frame % RecordingChunkFrames) * RecordingBlockDataSize];
+}
+
+// Hands the loaded chunk to the writer thread if it was modified
+void InputRecordingFile::SubmitChunk()
+{
+	if (!currentDirty)
+	{
+		return;
+	}
+	currentDirty = false;
+
+	{
+		std::lock_guard<std::mutex> lock(chunkLock);
+
+		std::pair<u32, std::vector<u8>>& pending = pendingChunks[currentChunk];
+		pending.first = ++chunkSequence;
+		pending.second = currentData;
+		chunkQueue.push_back(std::make_pair(currentChunk, chunkSequence));
+		chunkMaxFrame = MaxFrame;
+	}
+	chunkCv.notify_one();
+}
+
+void InputRecordingFile::ChunkWriterProc()
+{
+	std::vector<u8> data;
+	std::vector<u8> packed(compressBound(RecordingChunkSize));
+
+	std::unique_lock<std::mutex> lock(chunkLock);
+
+	while (true)
+	{
+		chunkCv.wait(lock, [this] { return !chunkQueue.empty() || chunkWriterExit; });
+		if (chunkQueue.empty())
+		{
+			break;
+		}
+
+		const std::pair<u32, u32> job = chunkQueue.front();
+		chunkQueue.pop_front();
+
+		// Superseded by a newer copy further in the queue
+		auto pending = pendingChunks.find(job.first);
+		if (pending == pendingChunks.end() || pending->second.first != job.second)
+		{
+			continue;
+		}
+		data = pending->second.second;
+
+		lock.unlock();
+		uLongf size = packed.size();
+		const bool packedOk = compress2(packed.data(), &size, data.data(), data.size(), Z_BEST_SPEED) == Z_OK;
+		lock.lock();
+
+		if (!packedOk)
+		{
+			continue; // stays pending, hence readable, until the recording is closed
+		}
+
+		if (!indexStale)
+		{
+			// Scanned on the next load if this one is never closed
+			const u64 none = 0;
+			fseek(recordingFile, RecordingSeekpointIndex, SEEK_SET);
+			fwrite(&none, sizeof(none), 1, recordingFile);
+			indexStale = true;
+		}
+
+		const u32 record[3] = { RecordingChunkMagic, job.first, (u32)size };
+		fseek(recordingFile, 0, SEEK_END);
+		const u64 offset = ftell(recordingFile);
+		if (fwrite(record, sizeof(record), 1, recordingFile) != 1
+			|| fwrite(packed.data(), 1, size, recordingFile) != size)
+		{
+			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: %s\n", strerror(errno)));
+			continue;
+		}
+		fseek(recordingFile, RecordingSeekpointFrameMax, SEEK_SET);
+		fwrite(&chunkMaxFrame, 4, 1, recordingFile);
+		fflush(recordingFile);
+
+		if (chunkOffsets.size() <= job.first)
+		{
+			chunkOffsets.resize(job.first + 1, 0);
+		}
+		chunkOffsets[job.first] = offset;
+
+		// No newer copy was submitted meanwhile
+		pending = pendingChunks.find(job.first);
+		if (pending != pendingChunks.end() && pending->second.first == job.second)
+		{
+			pendingChunks.erase(pending);
+		}
+	}
+}
+
+void InputRecordingFile::StartChunkWriter()
+{
+	chunkWriterExit = false;
+	chunkWriter = std::thread(&InputRecordingFile::ChunkWriterProc, this);
+}
+
+// Writes everything that was submitted and stops the writer
+void InputRecordingFile::StopChunkWriter()
+{
+	if (!chunkWriter.joinable())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(chunkLock);
+		chunkWriterExit = true;
+	}
+	chunkCv.notify_one();
+	chunkWriter.join();
+
+	pendingChunks.clear();
+	chunkQueue.clear();
+}
+
+// Appends the chunk index and points the header to it
+void InputRecordingFile::WriteChunkIndex()
+{
+	std::lock_guard<std::mutex> lock(chunkLock);
+
+	const u32 count = chunkOffsets.size();
+	u64 offset = 0;
+
+	if (count)
+	{
+		const u32 record[3] = { RecordingIndexMagic, count, count * (u32)sizeof(u64) };
+		fseek(recordingFile, 0, SEEK_END);
+		offset = ftell(recordingFile);
+		if (fwrite(record, sizeof(record), 1, recordingFile) != 1
+			|| fwrite(chunkOffsets.data(), sizeof(u64), count, recordingFile) != count)
+		{
+			return; // the index stays zeroed, the file will be scanned
+		}
+	}
+
+	fseek(recordingFile, RecordingSeekpointIndex, SEEK_SET);
+	fwrite(&offset, sizeof(offset), 1, recordingFile);
+	fwrite(&count, sizeof(count), 1, recordingFile);
+	fflush(recordingFile);
+	indexStale = false;
+}
+
+// Loads the chunk index, or rebuilds it from the records if the file wasn't closed
+bool InputRecordingFile::ReadChunkIndex()
+{
+	u64 offset = 0;
+	u32 count = 0;
+	u32 record[3];
+
+	chunkOffsets.clear();
+
+	fseek(recordingFile, RecordingSeekpointIndex, SEEK_SET);
+	if (fread(&offset, sizeof(offset), 1, recordingFile) != 1
+		|| fread(&count, sizeof(count), 1, recordingFile) != 1)
+	{
+		return false;
+	}
+
+	if (offset)
+	{
+		chunkOffsets.resize(count);
+		return fseek(recordingFile, offset, SEEK_SET) == 0
+			&& fread(record, sizeof(record), 1, recordingFile) == 1
+			&& record[0] == RecordingIndexMagic && record[1] == count
+			&& fread(chunkOffsets.data(), sizeof(u64), count, recordingFile) == count;
+	}
+
+	if (count)
+	{
+		recordingConLog(L"[REC]: The recording was not closed properly, rebuilding its index.\n");
+	}
+
+	u64 pos = RecordingChunksStart;
+	while (fseek(recordingFile, pos, SEEK_SET) == 0 && fread(record, sizeof(record), 1, recordingFile) == 1)
+	{
+		if (record[0] == RecordingChunkMagic)
+		{
+			if (chunkOffsets.size() <= record[1])
+			{
+				chunkOffsets.resize(record[1] + 1, 0);
+			}
+			chunkOffsets[record[1]] = pos;
+		}
+		else if (record[0] != RecordingIndexMagic)
+		{
+			break; // torn record at the end
+		}
+		pos += sizeof(record) + record[2];
+	}
+	indexStale = true;
+	return true;
+}
+
+bool InputRecordingFile::ReadFrame(unsigned long frame, u8* buf)
+{
+	if (chunked)
+	{
+		memcpy(buf, AccessChunk(frame), RecordingBlockDataSize);
+		return true;
+	}
+
+	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
+	return fseek(recordingFile, seek, SEEK_SET) == 0
+		&& fread(buf, 1, RecordingBlockDataSize, recordingFile) == RecordingBlockDataSize;
+}
+
+bool InputRecordingFile::WriteFrame(unsigned long frame, const u8* buf)
+{
+	if (chunked)
+	{
+		memcpy(AccessChunk(frame), buf, RecordingBlockDataSize);
+		currentDirty = true;
+		return true;
+	}
+
+	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
+	return fseek(recordingFile, seek, SEEK_SET) == 0
+		&& fwrite(buf, 1, RecordingBlockDataSize, recordingFile) == RecordingBlockDataSize;
+}
+
 // Write savestate flag to file
 bool InputRecordingFile::WriteSaveState() {
 	if (recordingFile == NULL)
@@ -100,6 +394,7 @@ bool InputRecordingFile::WriteSaveState() {
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(chunkLock);
 	fseek(recordingFile, RecordingSeekpointSaveState, SEEK_SET);
 	if (fwrite(&savestate.fromSavestate, sizeof(bool), 1, recordingFile) != 1)
 	{
@@ -117,6 +412,13 @@ bool InputRecordingFile::WriteKeyBuf(const uint & frame, const uint port, const
 		return false;
 	}
 
+	if (chunked)
+	{
+		AccessChunk(frame)[18 * port + bufIndex] = buf;
+		currentDirty = true;
+		return true;
+	}
+
 	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize + 18 * port + bufIndex;
 
 	if (fseek(recordingFile, seek, SEEK_SET) != 0
@@ -137,6 +439,12 @@ bool InputRecordingFile::ReadKeyBuf(u8 & result,const uint & frame, const uint p
 		return false;
 	}
 
+	if (chunked)
+	{
+		result = AccessChunk(frame)[18 * port + bufIndex];
+		return true;
+	}
+
 	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize + 18 * port + bufIndex;
 	if (fseek(recordingFile, seek, SEEK_SET) != 0)
 	{
@@ -159,9 +467,7 @@ void InputRecordingFile::GetPadData(PadData & result, unsigned long frame)
 		return;
 	}
 
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	if (fseek(recordingFile, seek, SEEK_SET) != 0
-		|| fread(result.buf, 1, RecordingBlockDataSize, recordingFile) == 0)
+	if (!ReadFrame(frame, (u8*)result.buf))
 	{
 		return;
 	}
@@ -178,22 +484,15 @@ bool InputRecordingFile::DeletePadData(unsigned long frame)
 
 	for (unsigned long i = frame; i < MaxFrame - 1; i++)
 	{
-		long seek1 = GetBlockSeekPoint(i+1) + RecordingBlockHeaderSize;
-		long seek2 = GetBlockSeekPoint(i) + RecordingBlockHeaderSize;
-
 		u8 buf[2][18];
-		fseek(recordingFile, seek1, SEEK_SET);
-		int rSize = fread(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
+		if (!ReadFrame(i + 1, &buf[0][0]))
 		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when reading from file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
+			recordingConLog(wxString::Format("[REC]: Error encountered when reading frame %lu from file.\n", i + 1));
 			return false;
 		}
-		fseek(recordingFile, seek2, SEEK_SET);
-		rSize = fwrite(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
+		if (!WriteFrame(i, &buf[0][0]))
 		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
+			recordingConLog(wxString::Format("[REC]: Error encountered when writing frame %lu to file.\n", i));
 			return false;
 		}
 	}
@@ -213,31 +512,21 @@ bool InputRecordingFile::InsertPadData(unsigned long frame, const PadData& key)
 
 	for (unsigned long i = MaxFrame - 1; i >= frame; i--)
 	{
-		long seek1 = GetBlockSeekPoint(i) + RecordingBlockHeaderSize;
-		long seek2 = GetBlockSeekPoint(i+1) + RecordingBlockHeaderSize;
-
 		u8 buf[2][18];
-		fseek(recordingFile, seek1, SEEK_SET);
-		int rSize = fread(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
+		if (!ReadFrame(i, &buf[0][0]))
 		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when reading from file: Expected %d bytes, read %d instead.\n", RecordingBlockDataSize, rSize));
+			recordingConLog(wxString::Format("[REC]: Error encountered when reading frame %lu from file.\n", i));
 			return false;
 		}
-		fseek(recordingFile, seek2, SEEK_SET);
-		rSize = fwrite(buf, 1, RecordingBlockDataSize, recordingFile);
-		if (rSize != RecordingBlockDataSize)
+		if (!WriteFrame(i + 1, &buf[0][0]))
 		{
-			recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, wrote %d instead.\n", RecordingBlockDataSize, rSize));
+			recordingConLog(wxString::Format("[REC]: Error encountered when writing frame %lu to file.\n", i + 1));
 			return false;
 		}
 	}
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	fseek(recordingFile, seek, SEEK_SET);
-	int rSize = fwrite(key.buf, 1, RecordingBlockDataSize, recordingFile);
-	if (rSize != RecordingBlockDataSize)
+	if (!WriteFrame(frame, (const u8*)key.buf))
 	{
-		recordingConLog(wxString::Format("[REC]: Error encountered when writing to file: Expected %d bytes, wrote %d instead.\n", RecordingBlockDataSize, rSize));
+		recordingConLog(wxString::Format("[REC]: Error encountered when writing frame %lu to file.\n", frame));
 		return false;
 	}
 	MaxFrame++;
@@ -258,14 +547,15 @@ bool InputRecordingFile::UpdatePadData(unsigned long frame, const PadData& key)
 		return false;
 	}
 
-	long seek = GetBlockSeekPoint(frame) + RecordingBlockHeaderSize;
-	fseek(recordingFile, seek, SEEK_SET);
-	if (fwrite(key.buf, 1, RecordingBlockDataSize, recordingFile) == 0)
+	if (!WriteFrame(frame, (const u8*)key.buf))
 	{
 		return false;
 	}
 
-	fflush(recordingFile);
+	if (!chunked)
+	{
+		fflush(recordingFile);
+	}
 	return true;
 }
 
@@ -301,11 +591,21 @@ bool InputRecordingFile::ReadHeaderAndCheck()
 	}
 
 	// Check for current verison
-	if (header.version != 1)
+	if (header.version != 1 && header.version != 2)
 	{
 		recordingConLog(wxString::Format("[REC]: Input recording file is not a supported version - %d\n", header.version));
 		return false;
 	}
+	if (header.version == 2)
+	{
+		if (!ReadChunkIndex())
+		{
+			recordingConLog(L"[REC]: Could not read the chunk index of the recording.\n");
+			return false;
+		}
+		chunked = true;
+		StartChunkWriter();
+	}
 	return true;
 }
 bool InputRecordingFile::WriteHeader()
@@ -314,6 +614,7 @@ bool InputRecordingFile::WriteHeader()
 	{
 		return false;
 	}
+	std::lock_guard<std::mutex> lock(chunkLock);
 	rewind(recordingFile);
 	if (fwrite(&header, sizeof(InputRecordingHeader), 1, recordingFile) != 1)
 	{
@@ -328,6 +629,7 @@ bool InputRecordingFile::WriteMaxFrame()
 	{
 		return false;
 	}
+	std::lock_guard<std::mutex> lock(chunkLock);
 	fseek(recordingFile, RecordingSeekpointFrameMax, SEEK_SET);
 	if (fwrite(&MaxFrame, 4, 1, recordingFile) != 1)
 	{
@@ -343,6 +645,10 @@ void InputRecordingFile::UpdateFrameMax(unsigned long frame)
 		return;
 	}
 	MaxFrame = frame;
+	if (chunked)
+	{
+		return; // written along with the chunks, see SubmitChunk
+	}
 	fseek(recordingFile, RecordingSeekpointFrameMax, SEEK_SET);
 	fwrite(&MaxFrame, 4, 1, recordingFile);
 }
@@ -354,6 +660,7 @@ void InputRecordingFile::AddUndoCount()
 	{
 		return;
 	}
+	std::lock_guard<std::mutex> lock(chunkLock);
 	fseek(recordingFile, RecordingSeekpointUndoCount, SEEK_SET);
 	fwrite(&UndoCount, 4, 1, recordingFile);
 }
@@ -18,10 +18,26 @@
 #include "PadData.h"
 #include "System.h"
 
-
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Version 1 stores the pad data of every frame uncompressed, at a fixed offset.  Version 2
+// (written for new recordings) stores it in zlib compressed chunks of ChunkFrames frames,
+// appended to the file as they are completed, and an index of the chunks at the end:
+//
+//   header, MaxFrame, UndoCount, fromSavestate, index offset (u64), chunk count (u32),
+//   records of { magic, chunk number or chunk count, size, data }...
+//
+// Seeking to a frame reads a single chunk.  A rewritten chunk is simply appended again,
+// the index points to the newest copy.  The index offset is zeroed while the file is being
+// written, in which case the records are scanned instead (the file wasn't closed).
 struct InputRecordingHeader
 {
-	u8 version = 1;
+	u8 version = 2;
 	char emu[50] = "PCSX2-1.5.X";
 	char author[255] = "";
 	char gameName[255] = "";
@@ -82,11 +98,47 @@ private:
 	static const int RecordingSeekpointUndoCount = sizeof(InputRecordingHeader) + 4;
 	static const int RecordingSeekpointSaveState = RecordingSeekpointUndoCount + 4;
 
+	// Version 2 records
+	static const u32 RecordingChunkMagic = 0x43324d50; // 'PM2C'
+	static const u32 RecordingIndexMagic = 0x49324d50; // 'PM2I'
+	static const int RecordingChunkFrames = 256;
+	static const int RecordingChunkSize = RecordingChunkFrames * RecordingBlockDataSize;
+	static const int RecordingSeekpointIndex = RecordingSeekpointSaveState + sizeof(bool);
+	static const int RecordingChunksStart = RecordingSeekpointIndex + 8 + 4;
+
 	// Movie File
 	FILE * recordingFile = NULL;
 	wxString filename = "";
 	long GetBlockSeekPoint(const long & frame);
 
+	bool ReadFrame(unsigned long frame, u8* buf);
+	bool WriteFrame(unsigned long frame, const u8* buf);
+
+	// Version 2: the chunk being accessed, and the background writer of the completed ones
+	bool chunked = false;
+	u32 currentChunk = ~0u;
+	std::vector<u8> currentData;
+	bool currentDirty = false;
+
+	std::mutex chunkLock;					// recordingFile and everything below
+	std::condition_variable chunkCv;
+	std::thread chunkWriter;
+	std::vector<u64> chunkOffsets;			// 0 if never written
+	std::unordered_map<u32, std::pair<u32, std::vector<u8>>> pendingChunks; // chunk -> latest (sequence, data)
+	std::deque<std::pair<u32, u32>> chunkQueue; // (chunk, sequence)
+	u32 chunkSequence = 0;
+	u32 chunkMaxFrame = 0;					// MaxFrame as of the last submitted chunk
+	bool chunkWriterExit = false;
+	bool indexStale = false;				// chunks were appended since the index was written
+
+	u8* AccessChunk(unsigned long frame);
+	void SubmitChunk();
+	void ChunkWriterProc();
+	bool ReadChunkIndex();
+	void WriteChunkIndex();
+	void StartChunkWriter();
+	void StopChunkWriter();
+
 	// Header
 	InputRecordingHeader header;
 	InputRecordingSavestate savestate;
@@ -113,5 +113,5 @@ void RecordingControls::Unpause()
 {
 	fStop = false;
 	fStart = true;
-	fFrameAdvance = true;
+	fFrameAdvance = false;
 }
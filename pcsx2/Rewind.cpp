@@ -0,0 +1,392 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Rewind.h"
+#include "SaveState.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <emmintrin.h>
+
+#ifdef PCSX2_ZSTD
+#include <zstd.h>
+#else
+#include <zlib.h>
+#endif
+
+namespace Rewind
+{
+
+// A snapshot of state N is stored as the words that changed between state N and N+1,
+// encoded as runs of [unchanged count][changed count][changed words ^ previous].  Applying
+// it to the newer state (which is always available uncompressed) yields the older one.
+//
+// When the serialized size changes (a plugin resized its freeze block, for instance)
+// the words cannot be lined up, and the whole older state is stored instead, encoded the
+// same way against an all-zero buffer.
+struct Snapshot
+{
+	u32 stateSize;			// size in bytes of the state this entry rebuilds
+	u32 deltaWords;			// length of the decompressed run stream
+	bool full;
+	std::vector<u8> data;
+};
+
+// Newest snapshot (uncompressed), and the buffer the next one is frozen into.  The two are
+// swapped after each capture.  Both are owned by the worker while s_pending is set.
+static std::unique_ptr<VmStateBuffer> s_current;
+static std::unique_ptr<VmStateBuffer> s_capture;
+static uint s_currentSize = 0;
+static uint s_captureSize = 0;
+
+// Protected by s_lock.
+static std::mutex s_lock;
+static std::condition_variable s_cond;
+static std::deque<Snapshot> s_history;
+static size_t s_historyBytes = 0;
+static bool s_pending = false;
+static bool s_quit = false;
+
+static std::thread s_worker;
+static std::vector<u32> s_delta;		// worker (or paused core) scratch
+
+// Core thread only.
+static int s_framesSinceCapture = 0;
+static std::atomic<bool> s_capturing(false);
+
+static uint WordCount(uint bytes)
+{
+	return (bytes + 3) / 4;
+}
+
+// Zeroes the padding up to the next word boundary, so that it never shows up in a delta.
+static void PadToWords(VmStateBuffer& buffer, uint size)
+{
+	const uint padded = WordCount(size) * 4;
+	buffer.MakeRoomFor(padded);
+	for (uint i = size; i < padded; ++i)
+		buffer[i] = 0;
+}
+
+// Encodes (cur ^ prev) as a run stream; prev may be NULL to encode cur as is.
+static void EncodeDelta(std::vector<u32>& out, const u32* cur, const u32* prev, uint words)
+{
+	out.clear();
+
+	uint i = 0;
+	while (i < words)
+	{
+		const uint same = i;
+
+		if (prev)
+		{
+			for (; i + 4 <= words; i += 4)
+			{
+				const __m128i a = _mm_loadu_si128((const __m128i*)&cur[i]);
+				const __m128i b = _mm_loadu_si128((const __m128i*)&prev[i]);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)) != 0xffff) break;
+			}
+			while (i < words && cur[i] == prev[i]) ++i;
+		}
+		else
+		{
+			for (; i + 4 <= words; i += 4)
+			{
+				const __m128i a = _mm_loadu_si128((const __m128i*)&cur[i]);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, _mm_setzero_si128())) != 0xffff) break;
+			}
+			while (i < words && cur[i] == 0) ++i;
+		}
+
+		if (i == words && i != same)
+			break;		// trailing unchanged run needs no entry
+
+		const size_t header = out.size();
+		out.push_back(i - same);
+		out.push_back(0);
+
+		const uint changed = i;
+		while (i < words && cur[i] != (prev ? prev[i] : 0))
+		{
+			out.push_back(cur[i] ^ (prev ? prev[i] : 0));
+			++i;
+		}
+		out[header + 1] = i - changed;
+	}
+}
+
+static bool ApplyDelta(u32* state, uint words, const u32* delta, uint deltaWords)
+{
+	uint pos = 0;
+	uint d = 0;
+
+	while (d + 2 <= deltaWords)
+	{
+		pos += delta[d];
+		const uint changed = delta[d + 1];
+		d += 2;
+
+		if (pos + changed > words || d + changed > deltaWords) return false;
+
+		for (uint i = 0; i < changed; ++i)
+			state[pos++] ^= delta[d++];
+	}
+
+	return d == deltaWords;
+}
+
+static bool Compress(Snapshot& snap, const std::vector<u32>& delta)
+{
+	const size_t srcSize = delta.size() * sizeof(u32);
+	snap.deltaWords = (u32)delta.size();
+
+#ifdef PCSX2_ZSTD
+	snap.data.resize(ZSTD_compressBound(srcSize));
+	const size_t size = ZSTD_compress(snap.data.data(), snap.data.size(), delta.data(), srcSize, 1);
+	if (ZSTD_isError(size)) return false;
+#else
+	uLongf size = compressBound((uLong)srcSize);
+	snap.data.resize(size);
+	if (compress2(snap.data.data(), &size, (const Bytef*)delta.data(), (uLong)srcSize, Z_BEST_SPEED) != Z_OK)
+		return false;
+#endif
+
+	snap.data.resize(size);
+	snap.data.shrink_to_fit();
+	return true;
+}
+
+static bool Decompress(std::vector<u32>& delta, const Snapshot& snap)
+{
+	const size_t dstSize = snap.deltaWords * sizeof(u32);
+	delta.resize(snap.deltaWords);
+
+#ifdef PCSX2_ZSTD
+	return ZSTD_decompress(delta.data(), dstSize, snap.data.data(), snap.data.size()) == dstSize;
+#else
+	uLongf size = (uLongf)dstSize;
+	return uncompress((Bytef*)delta.data(), &size, snap.data.data(), (uLong)snap.data.size()) == Z_OK
+		&& size == dstSize;
+#endif
+}
+
+// Turns the captured state into the new head of the history.  Returns false when there is
+// no history entry to add (first capture, or the entry could not be compressed).
+static bool Encode(Snapshot& snap)
+{
+	if (s_currentSize != 0)
+	{
+		snap.stateSize = s_currentSize;
+		snap.full = (s_captureSize != s_currentSize);
+
+		if (snap.full)
+			EncodeDelta(s_delta, (const u32*)s_current->GetPtr(), NULL, WordCount(s_currentSize));
+		else
+			EncodeDelta(s_delta, (const u32*)s_capture->GetPtr(), (const u32*)s_current->GetPtr(), WordCount(s_currentSize));
+	}
+
+	const bool stored = (s_currentSize != 0) && Compress(snap, s_delta);
+
+	std::swap(s_current, s_capture);
+	s_currentSize = s_captureSize;
+	return stored;
+}
+
+static void WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(s_lock);
+
+	while (true)
+	{
+		s_cond.wait(lock, [] { return s_pending || s_quit; });
+		if (s_quit) break;
+
+		const bool hadHistory = (s_currentSize != 0);
+		lock.unlock();
+
+		Snapshot snap;
+		const bool stored = Encode(snap);
+
+		lock.lock();
+
+		if (stored)
+		{
+			s_historyBytes += snap.data.size();
+			s_history.push_back(std::move(snap));
+
+			const size_t budget = (size_t)std::max(EmuConfig.RewindBudgetMB, 1) * _1mb;
+			while (s_historyBytes > budget && !s_history.empty())
+			{
+				s_historyBytes -= s_history.front().data.size();
+				s_history.pop_front();
+			}
+		}
+		else if (hadHistory)
+		{
+			// The chain is broken; older entries can no longer be reached.
+			Console.Warning("(Rewind) Could not compress snapshot; history discarded.");
+			s_history.clear();
+			s_historyBytes = 0;
+		}
+
+		s_pending = false;
+		s_cond.notify_all();
+	}
+}
+
+// Caller must hold s_lock.
+static void WaitForWorker(std::unique_lock<std::mutex>& lock)
+{
+	s_cond.wait(lock, [] { return !s_pending; });
+}
+
+void Vsync()
+{
+	const int interval = EmuConfig.RewindInterval;
+
+	if (interval <= 0)
+	{
+		if (s_current) Shutdown();
+		return;
+	}
+
+	if (++s_framesSinceCapture < interval) return;
+
+	{
+		std::lock_guard<std::mutex> guard(s_lock);
+		if (s_pending) return;		// the worker is still busy; try again next vsync
+	}
+
+	if (!s_current)
+	{
+		s_current = std::unique_ptr<VmStateBuffer>(new VmStateBuffer(L"RewindState"));
+		s_capture = std::unique_ptr<VmStateBuffer>(new VmStateBuffer(L"RewindCapture"));
+		s_worker = std::thread(WorkerThread);
+	}
+
+	s_framesSinceCapture = 0;
+
+	try
+	{
+		s_capturing = true;
+		memSavingState save(*s_capture);
+		save.FreezeAll();
+		s_capturing = false;
+
+		s_captureSize = save.GetCurrentPos();
+		PadToWords(*s_capture, s_captureSize);
+	}
+	catch (BaseException& ex)
+	{
+		s_capturing = false;
+		Console.Error(L"(Rewind) Snapshot failed: %s", WX_STR(ex.FormatDiagnosticMessage()));
+		Clear();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(s_lock);
+		s_pending = true;
+	}
+	s_cond.notify_one();
+}
+
+bool LoadPrevious()
+{
+	std::unique_lock<std::mutex> lock(s_lock);
+	WaitForWorker(lock);
+
+	if (s_currentSize == 0) return false;
+
+	// Rewinding right after a snapshot was taken would barely move; step past it instead.
+	// Repeated presses land here too, since loading resets the frame count.
+	if (s_framesSinceCapture * 2 < EmuConfig.RewindInterval && !s_history.empty())
+	{
+		const Snapshot& snap = s_history.back();
+		const uint words = WordCount(snap.stateSize);
+
+		if (snap.full)
+		{
+			s_current->MakeRoomFor(words * 4);
+			memset(s_current->GetPtr(), 0, words * 4);
+		}
+
+		if (!Decompress(s_delta, snap) || !ApplyDelta((u32*)s_current->GetPtr(), words, s_delta.data(), snap.deltaWords))
+		{
+			Console.Error("(Rewind) History is corrupt; discarded.");
+			s_history.clear();
+			s_historyBytes = 0;
+			s_currentSize = 0;
+			return false;
+		}
+
+		s_currentSize = snap.stateSize;
+		s_historyBytes -= snap.data.size();
+		s_history.pop_back();
+	}
+
+	memLoadingState(*s_current).FreezeAll();
+	s_framesSinceCapture = 0;
+
+	DevCon.WriteLn("(Rewind) %u snapshots left (%u KB).", (uint)s_history.size(), (uint)(s_historyBytes / 1024));
+	return true;
+}
+
+void Clear()
+{
+	std::unique_lock<std::mutex> lock(s_lock);
+	WaitForWorker(lock);
+
+	s_history.clear();
+	s_historyBytes = 0;
+	s_currentSize = 0;
+	s_framesSinceCapture = 0;
+}
+
+void Shutdown()
+{
+	if (s_worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> guard(s_lock);
+			s_quit = true;
+		}
+		s_cond.notify_all();
+		s_worker.join();
+		s_quit = false;
+	}
+
+	// The worker may have quit with a capture still pending.
+	s_pending = false;
+
+	Clear();
+	s_current.reset();
+	s_capture.reset();
+	s_delta = std::vector<u32>();
+}
+
+bool IsCapturing()
+{
+	return s_capturing.load(std::memory_order_relaxed);
+}
+
+}
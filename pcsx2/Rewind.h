@@ -0,0 +1,49 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Pcsx2Types.h"
+
+// --------------------------------------------------------------------------------------
+//  Rewind
+// --------------------------------------------------------------------------------------
+// In-memory rewind history.  Every RewindInterval frames the whole VM is frozen into a
+// memSavingState, and the difference to the previous snapshot is stored (compressed) in a
+// ring bounded by RewindBudgetMB.  Only the newest snapshot is kept uncompressed; older
+// ones are rebuilt by walking the deltas backwards, so the oldest entries can be dropped
+// whenever the budget is exceeded.
+//
+// Snapshots are taken from the core thread at vsync (the same point a pause is serviced),
+// and the delta/compression work is done on a worker thread.  If the worker is still busy
+// when the next snapshot is due, the capture is deferred to the following vsync.
+//
+namespace Rewind
+{
+	// Called once per vsync from the core thread.
+	extern void Vsync();
+
+	// Loads the previous snapshot into the VM.  The core thread must be paused.
+	// Returns false if there is nothing to rewind to.
+	extern bool LoadPrevious();
+
+	// Drops the whole history; must be called when the VM is reset or a state is loaded.
+	extern void Clear();
+
+	// Stops the worker thread and releases all buffers.
+	extern void Shutdown();
+
+	// True while the core thread is freezing a snapshot (used to keep the log quiet).
+	extern bool IsCapturing();
+}
@@ -0,0 +1,222 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "IopCommon.h"
+#include "RunAhead.h"
+#include "SaveState.h"
+
+#include "Utilities/Instrumentation.h"
+
+#include <memory>
+
+namespace RunAhead
+{
+
+// Loads a state of the same session.  EE and IOP main memory are compared page by page, and
+// only the pages that differ are written back: write protected EE pages clear their blocks on
+// the way (like DMA writes do), the IOP recompiler is told about its pages.
+class RollbackLoadingState : public memLoadingState
+{
+	typedef memLoadingState _parent;
+
+	static const int PageSize = 0x1000;
+
+public:
+	RollbackLoadingState( const VmStateBuffer& load_from )
+		: _parent( load_from )
+	{
+	}
+
+	bool IsRollback() const { return true; }
+
+	void FreezeMem( void* data, int size )
+	{
+		const bool iop = (data == iopMem->Main);
+
+		if (!iop && data != eeMem->Main)
+		{
+			_parent::FreezeMem( data, size );
+			return;
+		}
+
+		const u8* src = m_memory->GetPtr(m_idx);
+		u8* dst = (u8*)data;
+
+		for (int offset = 0; offset < size; offset += PageSize)
+		{
+			const int len = std::min(PageSize, size - offset);
+			if (memcmp(dst + offset, src + offset, len) == 0) continue;
+
+			memcpy(dst + offset, src + offset, len);
+			if (iop) psxCpu->Clear(offset, len / 4);
+		}
+
+		m_idx += size;
+	}
+};
+
+// Saves over the previous kept state: the GS only writes the pages of its memory that
+// changed since (the buffer holds the last saved or rolled back state).
+class IncrementalSavingState : public memSavingState
+{
+	typedef memSavingState _parent;
+
+public:
+	IncrementalSavingState( VmStateBuffer& save_to )
+		: _parent( save_to )
+	{
+	}
+
+	bool IsIncremental() const { return true; }
+};
+
+static std::unique_ptr<VmStateBuffer> s_state;
+static bool s_state_valid = false;	// s_state holds a complete state (not just allocated, or a failed save)
+
+// Core thread only.
+static int s_ahead = -1;			// frames emulated past the kept state, -1 if not speculating
+static bool s_replay = false;		// the next vsync is the one the kept state was saved at
+static bool s_rollback = false;
+static bool s_rollback_due = false;	// set by Vsync, s_rollback is raised by PostVsync once the frame went to the GS
+static bool s_shown = true;
+static bool s_capturing = false;
+
+static void SetMute( bool mute )
+{
+	if (SPU2setMute) SPU2setMute( mute );
+}
+
+bool Vsync()
+{
+	const int frames = std::min(std::max(EmuConfig.RunAheadFrames, 0), MaxFrames);
+
+	s_shown = true;
+
+	if (frames == 0)
+	{
+		if (s_state) Shutdown();
+		return true;
+	}
+
+	// Same point as the kept state: the frame was already shown ahead
+	if (s_replay)
+	{
+		s_replay = false;
+		s_shown = false;
+		return false;
+	}
+
+	if (s_ahead >= 0)
+	{
+		s_rollback_due = (++s_ahead >= frames);
+		s_shown = s_rollback_due;
+		return false;
+	}
+
+	// The frame that ends here is kept: save it, and run ahead of it
+	if (!s_state)
+		s_state = std::unique_ptr<VmStateBuffer>(new VmStateBuffer(L"RunAheadState"));
+
+	try
+	{
+		Instrumentation::ScopedTimer timer( Instrumentation::Counter_RunAheadSave );
+
+		s_capturing = true;
+		if (s_state_valid)
+			IncrementalSavingState( *s_state ).FreezeAll();
+		else
+			memSavingState( *s_state ).FreezeAll();
+		s_capturing = false;
+		s_state_valid = true;
+	}
+	catch (BaseException& ex)
+	{
+		s_capturing = false;
+		s_state_valid = false;
+		Console.Error(L"(RunAhead) Snapshot failed: %s", WX_STR(ex.FormatDiagnosticMessage()));
+		return true;
+	}
+
+	s_ahead = 0;
+	s_shown = false;
+	SetMute( true );
+	return true;
+}
+
+bool PostVsync()
+{
+	s_rollback = s_rollback_due;
+	s_rollback_due = false;
+	return s_rollback;
+}
+
+bool IsFrameShown()
+{
+	return s_shown;
+}
+
+bool IsSpeculating()
+{
+	return s_ahead >= 0;
+}
+
+bool IsRollbackPending()
+{
+	return s_rollback;
+}
+
+void Rollback()
+{
+	s_rollback = false;
+
+	{
+		Instrumentation::ScopedTimer timer( Instrumentation::Counter_RunAheadLoad );
+
+		// Still muted: the audio of the kept frames carries on
+		s_capturing = true;
+		RollbackLoadingState( *s_state ).FreezeAll();
+		s_capturing = false;
+	}
+
+	s_ahead = -1;
+	s_replay = true;
+	SetMute( false );
+}
+
+void Clear()
+{
+	if (s_ahead >= 0) SetMute( false );
+
+	s_ahead = -1;
+	s_replay = false;
+	s_rollback = false;
+	s_rollback_due = false;
+	s_shown = true;
+}
+
+void Shutdown()
+{
+	Clear();
+	s_state.reset();
+	s_state_valid = false;
+}
+
+bool IsCapturing()
+{
+	return s_capturing;
+}
+
+}
@@ -0,0 +1,69 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "Pcsx2Types.h"
+
+// --------------------------------------------------------------------------------------
+//  RunAhead
+// --------------------------------------------------------------------------------------
+// Input latency reduction.  At the vsync that ends a frame, the whole VM is frozen into an
+// in-memory state, and RunAheadFrames more frames are emulated with the same input, as
+// fast as possible: only the last one is presented, none of them is heard.  The VM is then
+// rolled back to the state, and the next frame is emulated for real (not presented either).
+// The screen thus shows the game RunAheadFrames frames ahead of its actual timeline, which
+// hides as many frames of the game's own input lag.  Each frame costs RunAheadFrames + 1
+// frames of emulation, plus a state save and load.
+//
+// The state buffer is reused, so neither save nor load allocate once warmed up, and a
+// rollback keeps the recompiled code: only the memory pages that differ are written back
+// (and their blocks cleared).  The GS saves and loads only the pages of its memory that were
+// written since the previous save or rollback (FREEZE_SAVE_INCREMENTAL).
+//
+namespace RunAhead
+{
+	static const int MaxFrames = 4;
+
+	// Called once per vsync from the core thread, before the vsync is sent to the GS.
+	// Returns false for the vsyncs that don't advance the kept timeline: those of the frames
+	// run ahead, and the vsync replayed after a rollback.
+	extern bool Vsync();
+
+	// Called at the end of the vsync, once it was sent to the GS.  Returns true when the
+	// frames run ahead are done: the last one is then presented, and the rollback raised.
+	extern bool PostVsync();
+
+	// True if the GS should present the frame ended by the current vsync.
+	extern bool IsFrameShown();
+
+	// True while emulating frames that will be rolled back.
+	extern bool IsSpeculating();
+
+	// True when the frames run ahead are done; the core thread must then leave the
+	// recompilers and call Rollback().
+	extern bool IsRollbackPending();
+
+	// Reloads the state of the last kept frame.  Core thread, outside of the recompilers.
+	extern void Rollback();
+
+	// Keeps the current state as the timeline (loaded states, resets, rewinds).
+	extern void Clear();
+
+	// Releases the state buffer.
+	extern void Shutdown();
+
+	// True while the core thread is saving or loading the state (used to keep the log quiet).
+	extern bool IsCapturing();
+}
@@ -390,6 +390,50 @@ __fi void SPR1chain()
 	}
 }
 
+// Upper bounds of the source chain tags run by a single toSPR event: a full scratchpad worth
+// of data, and enough tags that chains of small packets still go in a handful of events.
+static const int SPR1BulkQWC = _16kb / 16;
+static const uint SPR1BulkTags = 64;
+
+// Reads the tag at TADR and transfers its data; sets done at the end of the chain or when the
+// tag interrupts.  Returns the QWC transferred (-1 if the data isn't in memory), without
+// scheduling the event.
+static int _SPR1chainTag(bool& done)
+{
+	tDMA_TAG *ptag = SPRdmaGetAddr(spr1ch.tadr, false);		//Set memory pointer to TADR
+
+	if (!spr1ch.transfer("SPR1 Tag", ptag))
+	{
+		done = true;
+		return 0;
+	}
+
+	spr1ch.madr = ptag[1]._u32;						//MADR = ADDR field + SPR
+
+	// Transfer dma tag if tte is set
+	if (spr1ch.chcr.TTE)
+	{
+		SPR_LOG("SPR TTE: %x_%x\n", ptag[3]._u32, ptag[2]._u32);
+		SPR1transfer(ptag, 1);				//Transfer Tag
+	}
+
+	SPR_LOG("spr1 dmaChain %8.8x_%8.8x size=%d, id=%d, addr=%lx taddr=%lx saddr=%lx",
+		ptag[1]._u32, ptag[0]._u32, spr1ch.qwc, ptag->ID, spr1ch.madr, spr1ch.tadr, spr1ch.sadr);
+
+	done = hwDmacSrcChain(spr1ch, ptag->ID);
+	const int qwc = _SPR1chain();						//Transfers the data set by the switch
+
+	if (spr1ch.chcr.TIE && ptag->IRQ)  			//Check TIE bit of CHCR and IRQ bit of tag
+	{
+		SPR_LOG("dmaIrq Set");
+
+		//Console.WriteLn("SPR1 TIE");
+		done = true;
+	}
+
+	return qwc;
+}
+
 void _SPR1interleave()
 {
 	int qwc = spr1ch.qwc;
@@ -429,9 +473,6 @@ void _dmaSPR1()   // toSPR work function
 		}
 		case CHAIN_MODE:
 		{
-			tDMA_TAG *ptag;
-			bool done = false;
-
 			if (spr1ch.qwc > 0)
 			{
 				SPR_LOG("spr1 Normal or in Progress size=%d, addr=%lx taddr=%lx saddr=%lx", spr1ch.qwc, spr1ch.madr, spr1ch.tadr, spr1ch.sadr);
@@ -439,39 +480,34 @@ void _dmaSPR1()   // toSPR work function
 				SPR1chain();
 				return;
 			}
-			// Chain Mode
-
-			ptag = SPRdmaGetAddr(spr1ch.tadr, false);		//Set memory pointer to TADR
 
-			if (!spr1ch.transfer("SPR1 Tag", ptag))
+			// Chain Mode.  Tags are run back to back in a single event until the chain ends or
+			// raises its interrupt, and the event then takes the cycles of all of them.  The
+			// registers already jump ahead by a whole tag per event; now they jump by several.
+			// The caps keep long chains visibly progressing (and zero sized loops finite).
+			if (CHECK_IPUWAITHACK)
 			{
-				done = true;
+				bool done = false;
+				_SPR1chainTag(done);
+				CPU_INT(DMAC_TO_SPR, 8);
 				spr1finished = done;
+				break;
 			}
 
-			spr1ch.madr = ptag[1]._u32;						//MADR = ADDR field + SPR
-
-			// Transfer dma tag if tte is set
-			if (spr1ch.chcr.TTE)
-			{
-				SPR_LOG("SPR TTE: %x_%x\n", ptag[3]._u32, ptag[2]._u32);
-				SPR1transfer(ptag, 1);				//Transfer Tag
-			}
-
-			SPR_LOG("spr1 dmaChain %8.8x_%8.8x size=%d, id=%d, addr=%lx taddr=%lx saddr=%lx",
-				ptag[1]._u32, ptag[0]._u32, spr1ch.qwc, ptag->ID, spr1ch.madr, spr1ch.tadr, spr1ch.sadr);
-
-			done = hwDmacSrcChain(spr1ch, ptag->ID);
-			SPR1chain();										//Transfers the data set by the switch
-
-			if (spr1ch.chcr.TIE && ptag->IRQ)  			//Check TIE bit of CHCR and IRQ bit of tag
+			bool done = false;
+			int qwc = 0;
+			for (uint tags = 0; !done && tags < SPR1BulkTags && qwc < SPR1BulkQWC; ++tags)
 			{
-				SPR_LOG("dmaIrq Set");
-
-				//Console.WriteLn("SPR1 TIE");
-				done = true;
+				const int partialqwc = _SPR1chainTag(done);
+				if (partialqwc < 0)
+				{
+					qwc = partialqwc;
+					break;
+				}
+				qwc += partialqwc;
 			}
 
+			CPU_INT(DMAC_TO_SPR, qwc * BIAS);
 			spr1finished = done;
 			break;
 		}
@@ -27,15 +27,18 @@
 
 #include "Elfheader.h"
 #include "Counters.h"
+#include "RunAhead.h"
 
 #include "Utilities/SafeArray.inl"
 
 using namespace R5900;
 
 
-static void PreLoadPrep()
+static void PreLoadPrep( bool rollback )
 {
-	SysClearExecutionCache();
+	// Loading writes memory from outside of the core thread; lift any snapshot protection first.
+	mmap_EndSnapshot();
+	if (!rollback) SysClearExecutionCache();
 }
 
 static void PostLoadPrep()
@@ -45,6 +48,8 @@ static void PostLoadPrep()
 	for(int i=0; i<48; i++) MapTLB(i);
 	if (EmuConfig.Gamefixes.GoemonTlbHack) GoemonPreloadTlb();
 
+	cpuRebuildEventQueue();
+
 	UpdateVSyncRate();
 }
 
@@ -63,6 +68,16 @@ wxString SaveStateBase::GetFilename( int slot )
 	//	pxsFmt( L"%08X.%03d", ElfCRC, slot )).GetFullPath();
 }
 
+// Base state that differential savestates of the running game are stored against.
+wxString SaveStateBase::GetBaseFilename()
+{
+	wxString serialName( DiscSerial );
+	if (serialName.IsEmpty()) serialName = L"BIOS";
+
+	return (g_Conf->Folders.Savestates +
+		pxsFmt( L"%s (%08X).base.p2s", WX_STR(serialName), ElfCRC )).GetFullPath();
+}
+
 SaveStateBase::SaveStateBase( SafeArray<u8>& memblock )
 {
 	Init( &memblock );
@@ -83,6 +98,8 @@ void SaveStateBase::Init( SafeArray<u8>* memblock )
 
 void SaveStateBase::PrepBlock( int size )
 {
+	if( IsSizing() ) return;
+
 	pxAssertDev( m_memory, "Savestate memory/buffer pointer is null!" );
 
 	const int end = m_idx+size;
@@ -153,8 +170,9 @@ static const uint MainMemorySizeInBytes =
 SaveStateBase& SaveStateBase::FreezeMainMemory()
 {
 	vu1Thread.WaitVU(); // Finish VU1 just in-case...
-	if (IsLoading()) PreLoadPrep();
-	else m_memory->MakeRoomFor( m_idx + MainMemorySizeInBytes );
+	vu0Thread.WaitVU();
+	if (IsLoading()) PreLoadPrep( IsRollback() );
+	else if (!IsSizing()) m_memory->MakeRoomFor( m_idx + MainMemorySizeInBytes );
 
 	// First Block - Memory Dumps
 	// ---------------------------
@@ -177,10 +195,11 @@ SaveStateBase& SaveStateBase::FreezeMainMemory()
 SaveStateBase& SaveStateBase::FreezeInternals()
 {
 	vu1Thread.WaitVU(); // Finish VU1 just in-case...
+	vu0Thread.WaitVU();
 	// Print this until the MTVU problem in gifPathFreeze is taken care of (rama)
-	if (THREAD_VU1) Console.Warning("MTVU speedhack is enabled, saved states may not be stable");
+	if (THREAD_VU1 && !IsSizing() && !RunAhead::IsCapturing()) Console.Warning("MTVU speedhack is enabled, saved states may not be stable");
 	
-	if (IsLoading()) PreLoadPrep();
+	if (IsLoading()) PreLoadPrep( IsRollback() );
 
 	// Second Block - Various CPU Registers and States
 	// -----------------------------------------------
@@ -285,12 +304,18 @@ void memSavingState::FreezeMem( void* data, int size )
 	m_idx += size;
 }
 
+// Grows the buffer to fit a FreezeAll from the current position, in a single allocation.
 void memSavingState::MakeRoomForData()
 {
 	pxAssertDev( m_memory, "Savestate memory/buffer pointer is null!" );
 
-	m_memory->ChunkSize = ReallocThreshold;
-	m_memory->MakeRoomFor( m_idx + MemoryBaseAllocSize );
+	// A buffer reused from an earlier save (rewind, for instance) is already about the right
+	// size, and not worth a sizing pass; FreezeMem still grows it if something got bigger.
+	if( m_memory->GetSizeInBytes() - m_idx >= (int)MainMemorySizeInBytes ) return;
+
+	memSizingState sizer;
+	sizer.FreezeAll();
+	m_memory->MakeRoomFor( m_idx + sizer.GetCurrentPos() );
 }
 
 // Saving of state data to a memory buffer
@@ -301,6 +326,19 @@ memSavingState& memSavingState::FreezeAll()
 	return *this;
 }
 
+// --------------------------------------------------------------------------------------
+//  memSizingState  (implementations)
+// --------------------------------------------------------------------------------------
+memSizingState::memSizingState()
+	: SaveStateBase( (VmStateBuffer*)NULL )
+{
+}
+
+void memSizingState::FreezeMem( void* data, int size )
+{
+	m_idx += size;
+}
+
 // --------------------------------------------------------------------------------------
 //  memLoadingState  (implementations)
 // --------------------------------------------------------------------------------------
@@ -24,7 +24,7 @@
 //  the lower 16 bit value.  IF the change is breaking of all compatibility with old
 //  states, increment the upper 16 bit value, and clear the lower 16 bits to 0.
 
-static const u32 g_SaveVersion = (0x9A0E << 16) | 0x0000;
+static const u32 g_SaveVersion = (0x9A0F << 16) | 0x0000;
 
 // this function is meant to be used in the place of GSfreeze, and provides a safe layer
 // between the GS saving function and the MTGS's needs. :)
@@ -113,6 +113,7 @@ public:
 	virtual ~SaveStateBase() { }
 
 	static wxString GetFilename( int slot );
+	static wxString GetBaseFilename();
 
 	// Gets the version of savestate that this object is acting on.
 	// The version refers to the low 16 bits only (high 16 bits classifies Pcsx2 build types)
@@ -184,6 +185,19 @@ public:
 	// Returns true if this object is a StateSaving type object.
 	virtual bool IsSaving() const=0;
 
+	// Returns true if this object only measures the size of a saved state (see memSizingState).
+	// Such objects are also saving objects, but have no memory and store no data.
+	virtual bool IsSizing() const { return false; }
+
+	// Returns true if this object rolls the VM back to a state of the same session, a few
+	// frames old (see RunAhead).  The recompiled code is then kept: the loader is expected
+	// to clear the blocks of the memory it changes.
+	virtual bool IsRollback() const { return false; }
+
+	// Returns true if this object saves into the buffer it saved the previous state into,
+	// untouched since (see RunAhead), so that the GS may only write back what changed.
+	virtual bool IsIncremental() const { return false; }
+
 public:
 	// note: gsFreeze() needs to be public because of the GSState recorder.
 	void gsFreeze();
@@ -226,10 +240,6 @@ class memSavingState : public SaveStateBase
 {
 	typedef SaveStateBase _parent;
 
-protected:
-	static const int ReallocThreshold		= _1mb / 4;		// 256k reallocation block size.
-	static const int MemoryBaseAllocSize	= _8mb;			// 8 meg base alloc when PS2 main memory is excluded
-
 public:
 	virtual ~memSavingState() = default;
 	memSavingState( VmStateBuffer& save_to );
@@ -243,6 +253,20 @@ public:
 	bool IsSaving() const { return true; }
 };
 
+// Runs through a save without storing anything, so that the buffer of the real save can be
+// allocated once at its exact size.  Plugins are only asked for their freeze size.
+class memSizingState : public SaveStateBase
+{
+public:
+	virtual ~memSizingState() = default;
+	memSizingState();
+
+	void FreezeMem( void* data, int size );
+
+	bool IsSaving() const { return true; }
+	bool IsSizing() const { return true; }
+};
+
 class memLoadingState : public SaveStateBase
 {
 public:
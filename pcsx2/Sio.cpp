@@ -18,6 +18,7 @@
 
 #include "Common.h"
 #include "ConsoleLogger.h"
+#include "Counters.h"
 #include "Sio.h"
 #include "sio_internal.h"
 
@@ -200,6 +201,10 @@ int byteCnt = 0;
 //On the real PS1, asserting /ACK after the last byte would cause the transfer to fail.
 #define IS_LAST_BYTE_IN_PACKET ((sio.bufCount >= 3) ? 1 : 0)
 
+static const uint PadInputBytes = 6;
+static u8 padCommand[2];
+static u8 padInput[2][PadInputBytes];
+
 SIO_WRITE sioWriteController(u8 data)
 {
 	//if (data == 0x01) byteCnt = 0;
@@ -215,6 +220,19 @@ SIO_WRITE sioWriteController(u8 data)
 	default:
 		sio.buf[sio.bufCount] = PADpoll(data);
 
+		// Buttons and sticks in the reply to a read (0x42); a change starts a latency probe.
+		if (sio.bufCount == 1)
+			padCommand[sio.port & 1] = data;
+		else if (sio.bufCount >= 3 && sio.bufCount < 3 + PadInputBytes && padCommand[sio.port & 1] == 0x42)
+		{
+			u8& last = padInput[sio.port & 1][sio.bufCount - 3];
+			if (last != sio.buf[sio.bufCount])
+			{
+				last = sio.buf[sio.bufCount];
+				inputLatencyChanged();
+			}
+		}
+
 #ifndef DISABLE_RECORDING
 		if (g_Conf->EmuOptions.EnableRecordingTools)
 		{
@@ -1039,7 +1057,8 @@ void SaveStateBase::sioFreeze()
 	// but that requires adding memorycard plugin to the savestate, and I'm not in
 	// the mood to do that (let's plan it for 0.9.8) --air
 
-	if( IsSaving() )
+	// (the checksums can take a while, and don't change the size of anything)
+	if( IsSaving() && !IsSizing() )
 	{
 		for( uint port=0; port<2; ++port )
 			for( uint slot=0; slot<4; ++slot )
@@ -61,6 +61,20 @@ void __Log( const char* fmt, ... )
 	va_end( list );
 }
 
+bool SysTraceLog::Write( const char* fmt, ... ) const
+{
+	va_list list;
+	va_start(list, fmt);
+
+	if( EmuConfig.Trace.Binary )
+		BinaryTrace::Write( *this, fmt, list );
+	else
+		WriteV( fmt, list );
+
+	va_end(list);
+	return false;
+}
+
 void SysTraceLog::DoWrite( const char *msg ) const
 {
 	if( emuLog == NULL ) return;
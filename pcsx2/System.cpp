@@ -26,6 +26,7 @@
 
 #include "Utilities/MemsetFast.inl"
 #include "Utilities/Perf.h"
+#include "Utilities/Instrumentation.h"
 
 
 // --------------------------------------------------------------------------------------
@@ -77,6 +78,7 @@ void RecompiledCodeReserve::Reset()
 
 bool RecompiledCodeReserve::Commit()
 {
+	SetLargePages( EmuConfig.HostLargePages );
 	bool status = _parent::Commit();
 
 	if (IsDevBuild && m_baseptr)
@@ -187,6 +189,44 @@ TraceLogFilters& SetTraceConfig()
 }
 
 
+static std::atomic<u64> s_startupTicks[SysStartup_Count];
+
+static const char* const s_startupNames[SysStartup_Count] =
+{
+	"begin",
+	"cpu providers",
+	"plugins loaded",
+	"plugins init",
+	"plugins opened",
+	"rec reset",
+	"first frame",
+};
+
+void SysStartupMark( SysStartupStage stage )
+{
+	// The first vsync stamps it on every frame, keep that cheap
+	if( s_startupTicks[stage].load( std::memory_order_relaxed ) ) return;
+
+	const u64 begin = s_startupTicks[SysStartup_Begin].load( std::memory_order_relaxed );
+	if( stage != SysStartup_Begin && !begin ) return;
+
+	const u64 now = Instrumentation::GetTicks();
+	u64 expected = 0;
+	if( !s_startupTicks[stage].compare_exchange_strong( expected, now ) || stage != SysStartup_FirstFrame ) return;
+
+	// Some stages run in parallel, so they aren't necessarily in order
+	const double msec = 1000.0 / Instrumentation::GetFrequency();
+
+	Console.WriteLn( Color_StrongBlue, "Startup timing (ms since init):" );
+	for( int i = SysStartup_Begin + 1; i < SysStartup_Count; ++i )
+	{
+		if( const u64 ticks = s_startupTicks[i].load( std::memory_order_relaxed ) )
+			Console.Indent().WriteLn( "%-16s %8.1f", s_startupNames[i], (ticks - begin) * msec );
+	}
+
+	Instrumentation::Add( Instrumentation::Counter_StartupToFrame, now - begin );
+}
+
 // This function should be called once during program execution.
 void SysLogMachineCaps()
 {
@@ -380,6 +420,8 @@ void SysMainMemory::ReserveAll()
 	m_ee.Reserve();
 	m_iop.Reserve();
 	m_vu.Reserve();
+
+	GetMTGS().ReserveRing();
 }
 
 void SysMainMemory::CommitAll()
@@ -403,6 +445,8 @@ void SysMainMemory::ResetAll()
 	DevCon.WriteLn( Color_StrongBlue, "Resetting host memory for virtual systems..." );
 	ConsoleIndentScope indent(1);
 
+	mmap_EndSnapshot();
+
 	m_ee.Reset();
 	m_iop.Reset();
 	m_vu.Reset();
@@ -417,11 +461,16 @@ void SysMainMemory::DecommitAll()
 	Console.WriteLn( Color_Blue, "Decommitting host memory for virtual systems..." );
 	ConsoleIndentScope indent(1);
 
+	if (m_ee.IsCommitted() && m_iop.IsCommitted())
+		mmap_EndSnapshot();
+
 	// On linux, the MTVU isn't empty and the thread still uses the m_ee/m_vu memory
 	vu1Thread.WaitVU();
 	// The EE thread must be stopped here command mustn't be send
 	// to the ring. Let's call it an extra safety valve :)
 	vu1Thread.Reset();
+	vu0Thread.WaitVU();
+	vu0Thread.Reset();
 
 	m_ee.Decommit();
 	m_iop.Decommit();
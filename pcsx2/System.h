@@ -59,6 +59,7 @@ namespace HostMemoryMap
 	static const uptr VIF1rec	= 0x58000000;
 	static const uptr mVU0rec	= 0x5C000000;
 	static const uptr mVU1rec	= 0x60000000;
+	static const uptr MTGSring	= 0x64000000;
 #else
 	// PS2 main memory, SPR, and ROMs
 	static const uptr EEmem		= 0x20000000;
@@ -86,6 +87,9 @@ namespace HostMemoryMap
 
 	// microVU0 recompiler code cache area (64mb)
 	static const uptr mVU1rec	= 0x40000000;
+
+	// MTGS ringbuffer (up to 64mb, see RingBufferSizeFactorMax)
+	static const uptr MTGSring	= 0x44000000;
 #endif
 
 }
@@ -171,6 +175,22 @@ protected:
 // implemented by the provisioning interface.
 extern SysCpuProviderPack& GetCpuProviders();
 
+// Startup timing: each stage is stamped the first time it is reached, and the times since
+// SysStartup_Begin are logged (and published as Counter_StartupToFrame) at the first vsync.
+enum SysStartupStage
+{
+	SysStartup_Begin = 0,		// app init
+	SysStartup_CpuProviders,	// recompiler caches reserved
+	SysStartup_PluginsLoaded,
+	SysStartup_PluginsInit,
+	SysStartup_PluginsOpened,
+	SysStartup_RecReset,		// execution caches and dispatchers ready
+	SysStartup_FirstFrame,
+	SysStartup_Count
+};
+
+extern void SysStartupMark( SysStartupStage stage );
+
 extern void SysLogMachineCaps();		// Detects cpu type and fills cpuInfo structs.
 extern void SysClearExecutionCache();	// clears recompiled execution caches!
 extern void SysOutOfMemory_EmergencyResponse(uptr blocksize);
@@ -27,9 +27,15 @@
 
 #include "../DebugTools/MIPSAnalyst.h"
 #include "../DebugTools/SymbolMap.h"
+#include "../DebugTools/RecProfiler.h"
+#include "../Rewind.h"
+#include "../RunAhead.h"
+#include "../BootSnapshot.h"
+#include "../Benchmark.h"
 
 #include "Utilities/PageFaultSource.h"
 #include "Utilities/Threading.h"
+#include "Utilities/Instrumentation.h"
 
 #ifdef __WXMSW__
 #	include <wx/msw/wrapwin.h>
@@ -37,6 +43,8 @@
 
 #include "x86emitter/x86_intrin.h"
 
+#include <future>
+
 // --------------------------------------------------------------------------------------
 //  SysCoreThread *External Thread* Implementations
 //    (Called from outside the context of this thread)
@@ -49,6 +57,7 @@ SysCoreThread::SysCoreThread()
 	m_resetProfilers		= true;
 	m_resetVsyncTimers		= true;
 	m_resetVirtualMachine	= true;
+	m_execCacheReady		= false;
 
 	m_hasActiveMachine		= false;
 }
@@ -159,6 +168,8 @@ void SysCoreThread::UploadStateCopy( const VmStateBuffer& copy )
 	memLoadingState loadme( copy );
 	loadme.FreezeAll();
 	m_resetVirtualMachine = false;
+	Rewind::Clear();
+	RunAhead::Clear();
 }
 
 // --------------------------------------------------------------------------------------
@@ -167,7 +178,7 @@ void SysCoreThread::UploadStateCopy( const VmStateBuffer& copy )
 // --------------------------------------------------------------------------------------
 bool SysCoreThread::HasPendingStateChangeRequest() const
 {
-	return !m_hasActiveMachine || GetMTGS().HasPendingException() || _parent::HasPendingStateChangeRequest();
+	return !m_hasActiveMachine || GetMTGS().HasPendingException() || RunAhead::IsRollbackPending() || _parent::HasPendingStateChangeRequest();
 }
 
 void SysCoreThread::_reset_stuff_as_needed()
@@ -180,7 +191,8 @@ void SysCoreThread::_reset_stuff_as_needed()
 
 	if( m_resetVirtualMachine || m_resetRecompilers || m_resetProfilers )
 	{
-		SysClearExecutionCache();
+		if( !m_execCacheReady ) SysClearExecutionCache();
+		SysStartupMark( SysStartup_RecReset );
 		memBindConditionalHandlers();
 		SetCPUState( EmuConfig.Cpu.sseMXCSR, EmuConfig.Cpu.sseVUMXCSR );
 
@@ -188,6 +200,8 @@ void SysCoreThread::_reset_stuff_as_needed()
 		m_resetProfilers		= false;
 	}
 
+	m_execCacheReady = false;
+
 	if( m_resetVirtualMachine )
 	{
 		DoCpuReset();
@@ -211,6 +225,10 @@ void SysCoreThread::DoCpuReset()
 {
 	AffinityAssert_AllowFromSelf( pxDiagSpot );
 	cpuReset();
+	BootSnapshot::Boot();
+	RecProfiler::Clear();
+	Rewind::Clear();
+	RunAhead::Clear();
 }
 
 // This is called from the PS2 VM at the start of every vsync (either 59.94 or 50 hz by PS2
@@ -219,20 +237,33 @@ void SysCoreThread::DoCpuReset()
 // Default tasks: Updates PADs and applies vsync patches.  Derived classes can override this
 // to change either PAD and/or Patching behaviors.
 //
-// [TODO]: Should probably also handle profiling and debugging updates, once those are
-// re-implemented.
+// [TODO]: Should probably also handle debugging updates, once those are re-implemented.
 //
 void SysCoreThread::VsyncInThread()
 {
+	SysStartupMark( SysStartup_FirstFrame );
 	ApplyLoadedPatches(PPT_CONTINUOUSLY);
+	RecProfiler::Update();
+
+	// Frames run ahead (and replayed) are not part of the timeline
+	if (!RunAhead::Vsync()) return;
+
+	Rewind::Vsync();
+	Benchmark::Vsync();
+	Instrumentation::Publish(g_FrameCount);
+}
+
+static void OnFunctionScan(bool done)
+{
+	sApp.PostAppMethod(done ? &Pcsx2App::resetDebugger : &Pcsx2App::updateDebuggerAnalysis);
 }
 
 void SysCoreThread::GameStartingInThread()
 {
 	GetMTGS().SendGameCRC(ElfCRC);
 
-	MIPSAnalyst::ScanForFunctions(ElfTextRange.first,ElfTextRange.first+ElfTextRange.second,true);
-	symbolMap.UpdateActiveSymbols();
+	// Large ELFs take a while to analyze; the debugger is reset again once it's done.
+	MIPSAnalyst::ScanForFunctionsInBackground(ElfTextRange.first,ElfTextRange.first+ElfTextRange.second,OnFunctionScan);
 	sApp.PostAppMethod(&Pcsx2App::resetDebugger);
 
 	ApplyLoadedPatches(PPT_ONCE_ON_LOAD);
@@ -267,6 +298,7 @@ void SysCoreThread::ExecuteTaskInThread()
 	PCSX2_PAGEFAULT_PROTECT {
 		while(true) {
 			StateCheckInThread();
+			if (RunAhead::IsRollbackPending()) RunAhead::Rollback();
 			DoCpuExecute();
 		}
 	} PCSX2_PAGEFAULT_EXCEPT;
@@ -274,12 +306,33 @@ void SysCoreThread::ExecuteTaskInThread()
 
 void SysCoreThread::OnSuspendInThread()
 {
+	RecProfiler::Stop();
+	RecProfiler::WriteReport();
 	GetCorePlugins().Close();
 }
 
 void SysCoreThread::OnResumeInThread( bool isSuspended )
 {
+	// Resetting the recompilers (code caches, dispatchers) doesn't involve the plugins, so it
+	// runs alongside their opening -- mostly the GS device creation -- instead of after it.
+	// The emitter state is per thread.  _reset_stuff_as_needed does the rest of the reset.
+	std::future<void> recReset;
+	if( m_resetVirtualMachine || m_resetRecompilers || m_resetProfilers )
+	{
+		GetVmMemory().CommitAll();
+		recReset = std::async( std::launch::async, SysClearExecutionCache );
+	}
+
 	GetCorePlugins().Open();
+	SysStartupMark( SysStartup_PluginsOpened );
+
+	if( recReset.valid() )
+	{
+		recReset.get();
+		m_execCacheReady = true;
+	}
+
+	RecProfiler::Start();
 }
 
 
@@ -288,11 +341,17 @@ void SysCoreThread::OnCleanupInThread()
 {
 	m_ExecMode				= ExecMode_Closing;
 
+	RecProfiler::Stop();
+	Rewind::Shutdown();
+	RunAhead::Shutdown();
+	MIPSAnalyst::CancelScan();
+
 	m_hasActiveMachine		= false;
 	m_resetVirtualMachine	= true;
 
 	// FIXME: temporary workaround for deadlock on exit, which actually should be a crash
 	vu1Thread.WaitVU();
+	vu0Thread.WaitVU();
 	GetCorePlugins().Close();
 	GetCorePlugins().Shutdown();
 
@@ -37,6 +37,7 @@ enum VURegFlags
 //interpreter hacks, WIP
 //#define INT_VUSTALLHACK //some games work without those, big speedup
 //#define INT_VUDOUBLEHACK
+//#define INT_VUSCALARFMAC //per-field FMAC ops instead of the SSE ones (reference for checking them)
 
 enum VUStatus {
 	VU_Ready = 0,
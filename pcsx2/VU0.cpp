@@ -24,6 +24,7 @@
 
 #include "PrecompiledHeader.h"
 #include "Common.h"
+#include "MTVU.h"
 
 #include <cmath>
 
@@ -56,6 +57,7 @@ void COP2_Unknown()
 
 __fi void _vu0run(bool breakOnMbit, bool addCycles) {
 
+	if (THREAD_VU0) vu0Thread.WaitVU(); // Leaves nothing for the loop below to run
 	if (!(VU0.VI[REG_VPU_STAT].UL & 1)) return;
 
 	int startcycle = VU0.cycle;
@@ -80,6 +82,7 @@ namespace Interpreter{
 namespace OpcodeImpl
 {
 	void LQC2() {
+		if (THREAD_VU0) vu0Thread.WaitVU();
 		u32 addr = cpuRegs.GPR.r[_Rs_].UL[0] + (s16)cpuRegs.code;
 		if (_Ft_) {
 			memRead128(addr, VU0.VF[_Ft_].UQ);
@@ -93,6 +96,7 @@ namespace OpcodeImpl
 	//TODO: check this
 	// HUH why ? doesn't make any sense ...
 	void SQC2() {
+		if (THREAD_VU0) vu0Thread.WaitVU();
 		u32 addr = _Imm_ + cpuRegs.GPR.r[_Rs_].UL[0];
 		memWrite128(addr, VU0.VF[_Ft_].UQ);
 	}
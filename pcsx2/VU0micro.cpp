@@ -21,6 +21,7 @@
 #include "PrecompiledHeader.h"
 #include "Common.h"
 #include "VUmicro.h"
+#include "MTVU.h"
 
 #include <cmath>
 
@@ -47,5 +48,6 @@ void __fastcall vu0ExecMicro(u32 addr) {
 
 	if ((s32)addr != -1) VU0.VI[REG_TPC].UL = addr;
 	_vuExecMicroDebug(VU0);
-	CpuVU0->ExecuteBlock(1);
+	if (THREAD_VU0) vu0Thread.ExecuteVU();
+	else            CpuVU0->ExecuteBlock(1);
 }
@@ -16,6 +16,7 @@
 #include "PrecompiledHeader.h"
 #include "Common.h"
 #include "VUmicro.h"
+#include "MTVU.h"
 
 #define useDeltaTime 1
 
@@ -28,6 +29,10 @@ void BaseVUmicroCPU::ExecuteBlock(bool startUp) {
 	const int  s = 1024*8; // Kick Start Cycles (Silver Surfer needs this amount)
 	const int  c = 1024*1; // Continue Cycles
 	if (!(stat & test)) return;
+	if (!m_Idx && THREAD_VU0) { // VU0 runs on its own thread, just pick up its result
+		vu0Thread.Poll();
+		return;
+	}
 	if (startUp) {  // Start Executing a microprogram
 		Execute(s); // Kick start VU
 
@@ -59,6 +64,10 @@ void __fastcall BaseVUmicroCPU::ExecuteBlockJIT(BaseVUmicroCPU* cpu) {
 	const u32& stat	= VU0.VI[REG_VPU_STAT].UL;
 	const int  test = cpu->m_Idx ? 0x100 : 1;
 	const int  c	= 128;	// VU Execution Cycles
+	if (!cpu->m_Idx && THREAD_VU0) {
+		vu0Thread.WaitVU();
+		return;
+	}
 	if (stat & test) {		// VU is running
 		#ifdef PCSX2_DEVBUILD
 		static int warn = 5;
@@ -81,6 +90,10 @@ void __fastcall BaseVUmicroCPU::ExecuteBlockJIT(BaseVUmicroCPU* cpu) {
 void BaseVUmicroCPU::ExecuteBlock(bool startUp) {
 	const int vuRunning = m_Idx ? 0x100 : 1;
 	if (!(VU0.VI[REG_VPU_STAT].UL & vuRunning)) return;
+	if (!m_Idx && THREAD_VU0) { // VU0 runs on its own thread, just pick up its result
+		vu0Thread.Poll();
+		return;
+	}
 	if (startUp) { // Start Executing a microprogram
 		Execute(vu0RunCycles); // Kick start VU
 
@@ -103,6 +116,10 @@ void BaseVUmicroCPU::ExecuteBlock(bool startUp) {
 // This function is called by VU0 Macro (COP2) after transferring
 // EE data to a VU0 register...
 void __fastcall BaseVUmicroCPU::ExecuteBlockJIT(BaseVUmicroCPU* cpu) {
+	if (!cpu->m_Idx && THREAD_VU0) {
+		vu0Thread.WaitVU();
+		return;
+	}
 	cpu->Execute(128);
 }
 
@@ -21,6 +21,7 @@
 #include "MTVU.h"
 
 #include <cmath>
+#include <emmintrin.h>
 
 //Lower/Upper instructions can use that..
 #define _Ft_ ((VU->code >> 16) & 0x1F)  // The rt part of the instruction register
@@ -375,6 +376,8 @@ void _vuABS(VURegs * VU) {
 }/*Reworked from define to function. asadr*/
 
 
+#ifdef INT_VUSCALARFMAC
+
 static __fi void _vuADD(VURegs * VU) {
 	VECTOR * dst;
 	if (_Fd_ == 0) dst = &RDzero;
@@ -1174,6 +1177,125 @@ static __fi void _vuMSUBAw(VURegs * VU) {
     if (_W) VU->ACC.i.w = VU_MACw_UPDATE(VU, vuDouble(VU->ACC.i.w) - ( vuDouble(VU->VF[_Fs_].i.w) * tw)); else VU_MACw_CLEAR(VU);
     VU_STAT_UPDATE(VU);
 }
+#else
+
+// SSE versions of the FMAC ops above: all four fields are computed at once, and the results and
+// MAC flags are the same as the per-field code gives (the build does all float math in SSE too).
+// Unwritten fields keep their value and get their MAC flags cleared.
+
+enum vuFMACop {
+	vuFMAC_ADD,
+	vuFMAC_SUB,
+	vuFMAC_MUL,
+	vuFMAC_MADD,
+	vuFMAC_MSUB,
+};
+
+// Field masks for _XYZW (bit 3 = x)
+static __aligned16 const u32 vuFieldMask[16][4] = {
+	{0,0,0,0}, {0,0,0,~0u}, {0,0,~0u,0}, {0,0,~0u,~0u},
+	{0,~0u,0,0}, {0,~0u,0,~0u}, {0,~0u,~0u,0}, {0,~0u,~0u,~0u},
+	{~0u,0,0,0}, {~0u,0,0,~0u}, {~0u,0,~0u,0}, {~0u,0,~0u,~0u},
+	{~0u,~0u,0,0}, {~0u,~0u,0,~0u}, {~0u,~0u,~0u,0}, {~0u,~0u,~0u,~0u},
+};
+
+// Turns a movemask (bit 0 = x) into MAC flag order (bit 3 = x)
+static const u8 vuFlipMask[16] = {0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15};
+
+static __fi __m128i vuDoubleV(__m128i v)
+{
+#ifndef INT_VUDOUBLEHACK
+	const __m128i exp  = _mm_and_si128(v, _mm_set1_epi32(0x7f800000));
+	const __m128i sign = _mm_and_si128(v, _mm_set1_epi32(0x80000000));
+	const __m128i zero = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+	const __m128i max  = _mm_cmpeq_epi32(exp, _mm_set1_epi32(0x7f800000));
+	v = _mm_or_si128(_mm_andnot_si128(zero, v), _mm_and_si128(zero, sign));
+	v = _mm_or_si128(_mm_andnot_si128(max,  v), _mm_and_si128(max,  _mm_or_si128(sign, _mm_set1_epi32(0x7f7fffff))));
+#endif
+	return v;
+}
+
+static __fi __m128i vuLoadVF(const VECTOR& vf) { return _mm_loadu_si128((const __m128i*)&vf); }
+static __fi __m128i vuBroadcast(u32 f)		   { return _mm_set1_epi32(f); }
+
+// Clamps the fields written by the op the same way VU_MACx_UPDATE() does, and sets their MAC flags
+static __fi void vuFMACstore(VURegs* VU, VECTOR* dst, __m128 result)
+{
+	const u32     xyzw = _XYZW;
+	const __m128i mask = _mm_load_si128((const __m128i*)vuFieldMask[xyzw]);
+	const __m128i v    = _mm_castps_si128(result);
+	const __m128i sign = _mm_and_si128(v, _mm_set1_epi32(0x80000000));
+	const __m128i exp  = _mm_and_si128(v, _mm_set1_epi32(0x7f800000));
+	const __m128i zero = _mm_castps_si128(_mm_cmpeq_ps(result, _mm_setzero_ps()));
+	const __m128i exp0 = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+	const __m128i over = _mm_cmpeq_epi32(exp, _mm_set1_epi32(0x7f800000));
+	const __m128i unf  = _mm_andnot_si128(zero, exp0);
+
+	__m128i r = _mm_or_si128(_mm_andnot_si128(unf,  v), _mm_and_si128(unf, sign));
+	r = _mm_or_si128(_mm_andnot_si128(over, r), _mm_and_si128(over, _mm_or_si128(sign, _mm_set1_epi32(0x7f7fffff))));
+	r = _mm_or_si128(_mm_andnot_si128(mask, vuLoadVF(*dst)), _mm_and_si128(mask, r));
+	_mm_storeu_si128((__m128i*)dst, r);
+
+	// Zero and denormal results set Z, overflows keep the previous Z
+	const u32 s = vuFlipMask[_mm_movemask_ps(result)];
+	const u32 e = vuFlipMask[_mm_movemask_ps(_mm_castsi128_ps(exp0))];
+	const u32 u = vuFlipMask[_mm_movemask_ps(_mm_castsi128_ps(unf))];
+	const u32 o = vuFlipMask[_mm_movemask_ps(_mm_castsi128_ps(over))];
+	const u32 z = e | (o & VU->macflag);
+	VU->macflag = (VU->macflag & ~0xffff) | ((z | (s << 4) | (u << 8) | (o << 12)) & (xyzw * 0x1111));
+}
+
+template<vuFMACop op>
+static __fi void vuFMAC(VURegs* VU, VECTOR* dst, __m128i ft, bool addHack = false)
+{
+	const __m128i fsRaw = vuLoadVF(VU->VF[_Fs_]);
+	const __m128  fs    = _mm_castsi128_ps(vuDoubleV(fsRaw));
+	const __m128  t     = _mm_castsi128_ps(vuDoubleV(ft));
+	__m128 result = _mm_setzero_ps();
+
+	switch (op) {
+		case vuFMAC_ADD:  result = _mm_add_ps(fs, t); break;
+		case vuFMAC_SUB:  result = _mm_sub_ps(fs, t); break;
+		case vuFMAC_MUL:  result = _mm_mul_ps(fs, t); break;
+		case vuFMAC_MADD: result = _mm_add_ps(_mm_castsi128_ps(vuDoubleV(vuLoadVF(VU->ACC))), _mm_mul_ps(fs, t)); break;
+		case vuFMAC_MSUB: result = _mm_sub_ps(_mm_castsi128_ps(vuDoubleV(vuLoadVF(VU->ACC))), _mm_mul_ps(fs, t)); break;
+	}
+
+	if (addHack && (VU->VI[REG_I].UL == 0x43a02666)) { // See vuADD_TriAceHack()
+		const __m128 hit = _mm_castsi128_ps(_mm_cmpeq_epi32(fsRaw, _mm_set1_epi32(0x4b1ed4a8)));
+		result = _mm_or_ps(_mm_andnot_ps(hit, result), _mm_and_ps(hit, _mm_castsi128_ps(_mm_set1_epi32(0x4b1ed5e7))));
+	}
+
+	vuFMACstore(VU, dst, result);
+	VU_STAT_UPDATE(VU);
+}
+
+#define _vuFd (_Fd_ ? &VU->VF[_Fd_] : &RDzero)
+
+#define _vuFMACops(name, op, dst, addHack) \
+	static __fi void _vu##name   (VURegs * VU) { vuFMAC<op>(VU, dst, vuLoadVF(VU->VF[_Ft_])); } \
+	static __fi void _vu##name##i(VURegs * VU) { vuFMAC<op>(VU, dst, vuBroadcast(VU->VI[REG_I].UL), addHack && CHECK_VUADDSUBHACK); } \
+	static __fi void _vu##name##q(VURegs * VU) { vuFMAC<op>(VU, dst, vuBroadcast(VU->VI[REG_Q].UL)); } \
+	static __fi void _vu##name##x(VURegs * VU) { vuFMAC<op>(VU, dst, vuBroadcast(VU->VF[_Ft_].i.x)); } \
+	static __fi void _vu##name##y(VURegs * VU) { vuFMAC<op>(VU, dst, vuBroadcast(VU->VF[_Ft_].i.y)); } \
+	static __fi void _vu##name##z(VURegs * VU) { vuFMAC<op>(VU, dst, vuBroadcast(VU->VF[_Ft_].i.z)); } \
+	static __fi void _vu##name##w(VURegs * VU) { vuFMAC<op>(VU, dst, vuBroadcast(VU->VF[_Ft_].i.w)); }
+
+_vuFMACops(ADD,   vuFMAC_ADD,  _vuFd,     true)
+_vuFMACops(ADDA,  vuFMAC_ADD,  &VU->ACC,  false)
+_vuFMACops(SUB,   vuFMAC_SUB,  _vuFd,     false)
+_vuFMACops(SUBA,  vuFMAC_SUB,  &VU->ACC,  false)
+_vuFMACops(MUL,   vuFMAC_MUL,  _vuFd,     false)
+_vuFMACops(MULA,  vuFMAC_MUL,  &VU->ACC,  false)
+_vuFMACops(MADD,  vuFMAC_MADD, _vuFd,     false)
+_vuFMACops(MADDA, vuFMAC_MADD, &VU->ACC,  false)
+_vuFMACops(MSUB,  vuFMAC_MSUB, _vuFd,     false)
+_vuFMACops(MSUBA, vuFMAC_MSUB, &VU->ACC,  false)
+
+#undef _vuFMACops
+#undef _vuFd
+
+#endif
 
 // The functions below are floating point semantics min/max on integer representations to get
 // the effect of a floating point min/max without issues with denormal and special numbers.
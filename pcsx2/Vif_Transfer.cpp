@@ -17,6 +17,7 @@
 #include "Common.h"
 #include "Vif_Dma.h"
 #include "newVif.h"
+#include "MTVU.h"
 
 //------------------------------------------------------------------
 // VifCode Transfer Interpreter (Vif0/Vif1)
@@ -65,6 +66,9 @@ _vifT void vifTransferLoop(u32* &data) {
 _vifT static __fi bool vifTransfer(u32 *data, int size, bool TTE) {
 	vifStruct& vifX = GetVifX;
 
+	// VIF0 writes VU0 memory and can start new programs
+	if (!idx && THREAD_VU0) vu0Thread.WaitVU();
+
 	// irqoffset necessary to add up the right qws, or else will spin (spiderman)
 	int transferred = vifX.irqoffset.enabled ? vifX.irqoffset.value : 0;
 	
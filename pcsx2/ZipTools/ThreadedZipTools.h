@@ -139,6 +139,83 @@ public:
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  Chunked entries
+// --------------------------------------------------------------------------------------
+// Entries are split into fixed size chunks that are compressed independently, so that both
+// saving and loading can be spread over all cores.  A chunked entry is stored in the zip
+// without further compression, under its regular name plus ChunkedEntrySuffix.  Payload
+// layout:
+//
+//   ChunkedEntryHeader, u32 compressed size of each chunk, chunk data...
+//
+// Archives written before chunking (plain deflated entries) are still readable.
+//
+static const wxChar* const ChunkedEntrySuffix = L".zc";
+
+static const u32 ChunkedEntryMagic		= 0x435A5350;	// 'PSZC'
+static const u16 ChunkedEntryVersion	= 1;
+
+enum ChunkedEntryCodec
+{
+	ChunkedCodec_Deflate = 0,
+	ChunkedCodec_Zstd,
+};
+
+struct ChunkedEntryHeader
+{
+	u32 magic;
+	u16 version;
+	u16 codec;
+	u32 rawSize;
+	u32 chunkSize;
+	u32 chunkCount;
+};
+
+// Compresses all entries of the list; dest[i] receives the chunked payload of entry i.
+extern void CompressChunkedEntries( const ArchiveEntryList& list, std::vector< std::vector<u8> >& dest );
+
+// Unpacks a chunked payload into dest (resized to fit).  Throws BadStream on corrupt data.
+extern void DecompressChunkedEntry( const wxString& streamName, const u8* src, size_t srcSize, ArchiveDataBuffer& dest );
+
+// --------------------------------------------------------------------------------------
+//  Differential entries
+// --------------------------------------------------------------------------------------
+// An entry can be stored as the pages that differ from the same entry of a base savestate,
+// under its regular name plus DiffEntrySuffix (which is then chunked like any other entry).
+// The base is identified by the crc32 of its entry data, so that a base that is replaced
+// or modified is detected instead of silently producing a corrupt state.  Payload layout:
+//
+//   DiffEntryHeader, u8 bitmap of changed pages (bit n = page n), changed pages...
+//
+// The last page may be partial.  Both entries must be the same size; entries that changed
+// size are simply stored whole.
+//
+static const wxChar* const DiffEntrySuffix = L".diff";
+
+static const u32 DiffEntryMagic		= 0x46445350;	// 'PSDF'
+static const u16 DiffEntryVersion	= 1;
+static const u16 DiffEntryPageShift	= 12;
+
+struct DiffEntryHeader
+{
+	u32 magic;
+	u16 version;
+	u16 pageShift;
+	u32 baseCrc;
+	u32 rawSize;
+	u32 changedPages;
+};
+
+// Encodes src against base (both size bytes).  Returns false, leaving dest empty, when the
+// differential payload would not be any smaller than src itself.
+extern bool EncodeDiffEntry( const u8* src, const u8* base, u32 size, u32 baseCrc, std::vector<u8>& dest );
+
+// Rebuilds an entry from its differential payload and base entry into dest (resized to
+// fit).  Throws SaveStateLoadError on corrupt data or a mismatched base.
+extern void ApplyDiffEntry( const wxString& streamName, const u8* src, size_t srcSize,
+	const u8* base, u32 baseSize, u32 baseCrc, ArchiveDataBuffer& dest );
+
 // --------------------------------------------------------------------------------------
 //  BaseCompressThread
 // --------------------------------------------------------------------------------------
@@ -0,0 +1,215 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "SaveState.h"
+#include "ThreadedZipTools.h"
+#include "Utilities/SafeArray.inl"
+#include "Utilities/ThreadPool.h"
+
+#include <atomic>
+#include <functional>
+
+#ifdef PCSX2_ZSTD
+#include <zstd.h>
+#endif
+#include <zlib.h>
+
+// 1MB chunks keep eeMemory (the bulk of a state) spread over 32 jobs, while staying large
+// enough that the per-chunk restart costs almost nothing in ratio.
+static const u32 ChunkSize = _1mb;
+
+#ifdef PCSX2_ZSTD
+static const u16 DefaultCodec = ChunkedCodec_Zstd;
+#else
+static const u16 DefaultCodec = ChunkedCodec_Deflate;
+#endif
+
+// Runs job(0..count-1) on the shared pool.  The calling thread takes part as well.
+static void ParallelFor( uint count, const std::function<void(uint)>& job )
+{
+	Threading::ThreadPool::GetShared().ParallelFor( count, job );
+}
+
+static size_t CompressBound( u16 codec, size_t size )
+{
+#ifdef PCSX2_ZSTD
+	if (codec == ChunkedCodec_Zstd)
+		return ZSTD_compressBound( size );
+#endif
+	return compressBound( (uLong)size );
+}
+
+// Returns the compressed size, or 0 on failure.
+static size_t CompressChunk( u16 codec, u8* dest, size_t destSize, const u8* src, size_t srcSize )
+{
+#ifdef PCSX2_ZSTD
+	if (codec == ChunkedCodec_Zstd)
+	{
+		const size_t size = ZSTD_compress( dest, destSize, src, srcSize, ZSTD_CLEVEL_DEFAULT );
+		return ZSTD_isError( size ) ? 0 : size;
+	}
+#endif
+
+	uLongf size = (uLongf)destSize;
+	if (compress2( dest, &size, src, (uLong)srcSize, Z_DEFAULT_COMPRESSION ) != Z_OK)
+		return 0;
+	return size;
+}
+
+static bool DecompressChunk( u16 codec, u8* dest, size_t destSize, const u8* src, size_t srcSize )
+{
+#ifdef PCSX2_ZSTD
+	if (codec == ChunkedCodec_Zstd)
+		return ZSTD_decompress( dest, destSize, src, srcSize ) == destSize;
+#endif
+
+	uLongf size = (uLongf)destSize;
+	return (uncompress( dest, &size, src, (uLong)srcSize ) == Z_OK) && (size == destSize);
+}
+
+void CompressChunkedEntries( const ArchiveEntryList& list, std::vector< std::vector<u8> >& dest )
+{
+	struct ChunkJob
+	{
+		uint entry;
+		u32 offset;			// within the entry
+		u32 size;
+		std::vector<u8> data;
+	};
+
+	std::vector<ChunkJob> jobs;
+	dest.clear();
+	dest.resize( list.GetLength() );
+
+	for (uint i = 0; i < list.GetLength(); ++i)
+	{
+		for (u32 ofs = 0; ofs < list[i].GetDataSize(); ofs += ChunkSize)
+		{
+			ChunkJob job = { i, ofs, std::min<u32>( ChunkSize, list[i].GetDataSize() - ofs ) };
+			jobs.push_back( job );
+		}
+	}
+
+	std::atomic<bool> failed( false );
+
+	ParallelFor( jobs.size(), [&]( uint idx )
+	{
+		ChunkJob& job = jobs[idx];
+		const u8* src = list.GetPtr( list[job.entry].GetDataIndex() + job.offset );
+
+		job.data.resize( CompressBound( DefaultCodec, job.size ) );
+		const size_t size = CompressChunk( DefaultCodec, job.data.data(), job.data.size(), src, job.size );
+		if (!size) failed = true;
+		job.data.resize( size );
+	});
+
+	if (failed)
+		throw Exception::RuntimeError().SetDiagMsg( L"Savestate chunk compression failed." );
+
+	// Assemble the payloads: header, chunk size table, then the chunks themselves.
+	uint jobidx = 0;
+	for (uint i = 0; i < list.GetLength(); ++i)
+	{
+		ChunkedEntryHeader header;
+		header.magic		= ChunkedEntryMagic;
+		header.version		= ChunkedEntryVersion;
+		header.codec		= DefaultCodec;
+		header.rawSize		= list[i].GetDataSize();
+		header.chunkSize	= ChunkSize;
+		header.chunkCount	= (header.rawSize + ChunkSize - 1) / ChunkSize;
+
+		size_t total = sizeof(header) + header.chunkCount * sizeof(u32);
+		for (uint c = 0; c < header.chunkCount; ++c)
+			total += jobs[jobidx + c].data.size();
+
+		std::vector<u8>& payload = dest[i];
+		payload.resize( total );
+
+		u8* out = payload.data();
+		memcpy( out, &header, sizeof(header) );
+		out += sizeof(header);
+
+		for (uint c = 0; c < header.chunkCount; ++c)
+		{
+			const u32 size = jobs[jobidx + c].data.size();
+			memcpy( out, &size, sizeof(size) );
+			out += sizeof(size);
+		}
+
+		for (uint c = 0; c < header.chunkCount; ++c, ++jobidx)
+		{
+			memcpy( out, jobs[jobidx].data.data(), jobs[jobidx].data.size() );
+			out += jobs[jobidx].data.size();
+		}
+	}
+}
+
+void DecompressChunkedEntry( const wxString& streamName, const u8* src, size_t srcSize, ArchiveDataBuffer& dest )
+{
+	ChunkedEntryHeader header;
+
+	if (srcSize < sizeof(header))
+		throw Exception::SaveStateLoadError( streamName ).SetDiagMsg( L"Chunked savestate entry is truncated." );
+
+	memcpy( &header, src, sizeof(header) );
+
+	if (header.magic != ChunkedEntryMagic || header.version > ChunkedEntryVersion || header.codec > ChunkedCodec_Zstd)
+		throw Exception::SaveStateLoadError( streamName )
+			.SetDiagMsg( pxsFmt( L"Unknown chunked savestate entry (magic=%08x, version=%u, codec=%u).", header.magic, header.version, header.codec ) );
+
+#ifndef PCSX2_ZSTD
+	if (header.codec == ChunkedCodec_Zstd)
+		throw Exception::SaveStateLoadError( streamName )
+			.SetDiagMsg( L"Savestate was compressed with zstd, which this build does not support." )
+			.SetUserMsg( _("This savestate cannot be loaded because it uses a compression format that this build of PCSX2 does not support.") );
+#endif
+
+	// Locate each chunk up front, so that they can be unpacked in any order.
+	const size_t tableEnd = sizeof(header) + (size_t)header.chunkCount * sizeof(u32);
+	if (header.chunkSize == 0 || tableEnd > srcSize
+		|| (u64)header.chunkCount * header.chunkSize < header.rawSize
+		|| (header.chunkCount && (u64)(header.chunkCount - 1) * header.chunkSize >= header.rawSize))
+		throw Exception::SaveStateLoadError( streamName ).SetDiagMsg( L"Chunked savestate entry has a bad header." );
+
+	std::vector<size_t> offsets( header.chunkCount + 1 );
+	offsets[0] = tableEnd;
+	for (uint c = 0; c < header.chunkCount; ++c)
+	{
+		u32 size;
+		memcpy( &size, src + sizeof(header) + c * sizeof(u32), sizeof(size) );
+		offsets[c + 1] = offsets[c] + size;
+	}
+
+	if (offsets[header.chunkCount] > srcSize)
+		throw Exception::SaveStateLoadError( streamName ).SetDiagMsg( L"Chunked savestate entry is truncated." );
+
+	if (header.rawSize) dest.ExactAlloc( header.rawSize );
+
+	std::atomic<bool> failed( false );
+
+	ParallelFor( header.chunkCount, [&]( uint c )
+	{
+		const u32 ofs = c * header.chunkSize;
+		const u32 size = std::min( header.chunkSize, header.rawSize - ofs );
+
+		if (!DecompressChunk( header.codec, dest.GetPtr( ofs ), size, src + offsets[c], offsets[c + 1] - offsets[c] ))
+			failed = true;
+	});
+
+	if (failed)
+		throw Exception::SaveStateLoadError( streamName ).SetDiagMsg( L"Chunked savestate entry is corrupt." );
+}
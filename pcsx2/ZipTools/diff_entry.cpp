@@ -0,0 +1,112 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "SaveState.h"
+#include "ThreadedZipTools.h"
+#include "Utilities/SafeArray.inl"
+
+static const u32 PageSize = 1u << DiffEntryPageShift;
+
+static u32 PageCount( u32 size )
+{
+	return (size + PageSize - 1) >> DiffEntryPageShift;
+}
+
+bool EncodeDiffEntry( const u8* src, const u8* base, u32 size, u32 baseCrc, std::vector<u8>& dest )
+{
+	const u32 pages = PageCount( size );
+	const size_t bitmapSize = (pages + 7) / 8;
+
+	DiffEntryHeader header;
+	header.magic		= DiffEntryMagic;
+	header.version		= DiffEntryVersion;
+	header.pageShift	= DiffEntryPageShift;
+	header.baseCrc		= baseCrc;
+	header.rawSize		= size;
+	header.changedPages	= 0;
+
+	// Pages are appended as they are found, so the bitmap and header are filled in last.
+	dest.assign( sizeof(header) + bitmapSize, 0 );
+
+	for (u32 page = 0; page < pages; ++page)
+	{
+		const u32 ofs = page << DiffEntryPageShift;
+		const u32 len = std::min( PageSize, size - ofs );
+
+		if (memcmp( src + ofs, base + ofs, len ) == 0) continue;
+
+		if (dest.size() + len >= size)
+		{
+			dest.clear();
+			return false;
+		}
+
+		dest[sizeof(header) + page / 8] |= 1 << (page & 7);
+		dest.insert( dest.end(), src + ofs, src + ofs + len );
+		++header.changedPages;
+	}
+
+	memcpy( dest.data(), &header, sizeof(header) );
+	return true;
+}
+
+void ApplyDiffEntry( const wxString& streamName, const u8* src, size_t srcSize,
+	const u8* base, u32 baseSize, u32 baseCrc, ArchiveDataBuffer& dest )
+{
+	DiffEntryHeader header;
+
+	if (srcSize < sizeof(header))
+		throw Exception::SaveStateLoadError( streamName ).SetDiagMsg( L"Differential savestate entry is truncated." );
+
+	memcpy( &header, src, sizeof(header) );
+
+	if (header.magic != DiffEntryMagic || header.version > DiffEntryVersion || header.pageShift != DiffEntryPageShift)
+		throw Exception::SaveStateLoadError( streamName )
+			.SetDiagMsg( pxsFmt( L"Unknown differential savestate entry (magic=%08x, version=%u).", header.magic, header.version ) );
+
+	if (header.baseCrc != baseCrc || header.rawSize != baseSize)
+		throw Exception::SaveStateLoadError( streamName )
+			.SetDiagMsg( pxsFmt( L"Base savestate does not match (crc=%08x, expected %08x).", baseCrc, header.baseCrc ) )
+			.SetUserMsg( _("This savestate cannot be loaded because the base savestate it was saved against has been changed or replaced.") );
+
+	const u32 pages = PageCount( header.rawSize );
+	const u8* bitmap = src + sizeof(header);
+	const u8* data = bitmap + (pages + 7) / 8;
+	const u8* end = src + srcSize;
+
+	if (data > end)
+		throw Exception::SaveStateLoadError( streamName ).SetDiagMsg( L"Differential savestate entry is truncated." );
+
+	if (!header.rawSize) return;
+
+	dest.ExactAlloc( header.rawSize );
+	memcpy( dest.GetPtr(), base, header.rawSize );
+
+	for (u32 page = 0; page < pages; ++page)
+	{
+		if (!(bitmap[page / 8] & (1 << (page & 7)))) continue;
+
+		const u32 ofs = page << DiffEntryPageShift;
+		const u32 len = std::min( PageSize, header.rawSize - ofs );
+
+		if ((size_t)(end - data) < len)
+			throw Exception::SaveStateLoadError( streamName ).SetDiagMsg( L"Differential savestate entry is truncated." );
+
+		memcpy( dest.GetPtr( ofs ), data, len );
+		data += len;
+	}
+}
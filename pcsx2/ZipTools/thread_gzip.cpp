@@ -55,24 +55,31 @@ void BaseCompressThread::ExecuteTaskInThread()
 	
 	Yield( 3 );
 
+	// Compression is done up front over all cores; the zip itself only stores the result.
+	std::vector< std::vector<u8> > payloads;
+	CompressChunkedEntries( *m_src_list, payloads );
+
 	uint listlen = m_src_list->GetLength();
 	for( uint i=0; i<listlen; ++i )
 	{
 		const ArchiveEntry& entry = (*m_src_list)[i];
 		if (!entry.GetDataSize()) continue;
 
-		wxArchiveOutputStream& woot = *(wxArchiveOutputStream*)m_gzfp->GetWxStreamBase();
-		woot.PutNextEntry( entry.GetFilename() );
+		wxZipOutputStream& woot = *(wxZipOutputStream*)m_gzfp->GetWxStreamBase();
+		wxZipEntry* zent = new wxZipEntry( entry.GetFilename() + ChunkedEntrySuffix );
+		zent->SetMethod( wxZIP_METHOD_STORE );
+		woot.PutNextEntry( zent );
 
 		static const uint BlockSize = 0x64000;
+		const std::vector<u8>& payload = payloads[i];
 		uint curidx = 0;
 
 		do {
-			uint thisBlockSize = std::min( BlockSize, entry.GetDataSize() - curidx );
-			m_gzfp->Write(m_src_list->GetPtr( entry.GetDataIndex() + curidx ), thisBlockSize);
+			uint thisBlockSize = std::min<uint>( BlockSize, payload.size() - curidx );
+			m_gzfp->Write(&payload[curidx], thisBlockSize);
 			curidx += thisBlockSize;
 			Yield( 2 );
-		} while( curidx < entry.GetDataSize() );
+		} while( curidx < payload.size() );
 		
 		woot.CloseEntry();
 	}
@@ -316,6 +316,13 @@ public:
 	bool			ForceConsole;
 	bool			PortableMode;
 
+	// Publishes the Instrumentation counters for external tools.
+	bool			Instrument;
+
+	// No main frame, GS window or log window, and no GUI work per vsync.  The log goes to
+	// stdout and the counters are published (implies Instrument).
+	bool			Headless;
+
 	// Disables the fast boot option when auto-running games.  This option only applies
 	// if SysAutoRun is also true.
 	bool			NoFastBoot;
@@ -328,6 +335,18 @@ public:
 
 	wxString		GameLaunchArgs;
 
+	// Compresses IsoFile to this file and exits, instead of running it.
+	wxString		CompressIsoFile;
+
+	// Runs this many frames unthrottled once booted (0 = until the input recording ends),
+	// writes a report and exits.  The savestate and input recording are optional.
+	bool			Benchmark;
+	uint			BenchmarkFrames;
+	uint			BenchmarkSegment;	// frames per timed segment of the report
+	wxString		BenchmarkState;
+	wxString		BenchmarkReplay;
+	wxString		BenchmarkReport;
+
 	// Specifies the CDVD source type to use when AutoRunning
 	CDVD_SourceType CdvdSource;
 
@@ -341,10 +360,15 @@ public:
 		ForceWizard				= false;
 		ForceConsole			= false;
 		PortableMode			= false;
+		Instrument				= false;
+		Headless				= false;
 		NoFastBoot				= false;
 		SysAutoRun				= false;
 		SysAutoRunElf			= false;
 		SysAutoRunIrx			= false;
+		Benchmark				= false;
+		BenchmarkFrames			= 0;
+		BenchmarkSegment		= 600;
 		CdvdSource				= CDVD_SourceType::NoDisc;
 	}
 };
@@ -573,6 +597,7 @@ public:
 	void enterDebugMode();
 	void leaveDebugMode();
 	void resetDebugger();
+	void updateDebuggerAnalysis();
 
 	bool HasMainFrame() const	{ return GetMainFramePtr() != NULL; }
 
@@ -620,6 +645,8 @@ public:
 	wxImageList&		GetImgList_Toolbars();
 
 	const AppImageIds& GetImgId() const;
+
+	// Loaded by a worker thread started at init; blocks until that load is complete.
 	AppGameDatabase* GetGameDatabase();
 
 	// --------------------------------------------------------------------------
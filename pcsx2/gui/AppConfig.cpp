@@ -108,6 +108,12 @@ namespace PathDefs
 			static const wxDirName retval( L"docs" );
 			return retval;
 		}
+
+		const wxDirName& Cache()
+		{
+			static const wxDirName retval( L"cache" );
+			return retval;
+		}
 	};
 
 	// Specifies the root folder for the application install.
@@ -247,6 +253,12 @@ namespace PathDefs
 		return AppRoot() + Base::Langs();
 	}
 
+	// Holds regenerable data (recompiler and lookup caches); safe to delete at any time.
+	wxDirName GetCache()
+	{
+		return GetDocuments() + Base::Cache();
+	}
+
 	wxDirName Get( FoldersEnum_t folderidx )
 	{
 		switch( folderidx )
@@ -932,6 +944,7 @@ AppConfig::UiTemplateOptions::UiTemplateOptions()
 	LimiterUnlimited	= L"Max";
 	LimiterTurbo		= L"Turbo";
 	LimiterSlowmo		= L"Slowmo";
+	LimiterFastForward	= L"FastForward";
 	LimiterNormal		= L"Normal";
 	OutputFrame			= L"Frame";
 	OutputField			= L"Field";
@@ -951,6 +964,7 @@ void AppConfig::UiTemplateOptions::LoadSave(IniInterface& ini)
 	IniEntry(LimiterUnlimited);
 	IniEntry(LimiterTurbo);
 	IniEntry(LimiterSlowmo);
+	IniEntry(LimiterFastForward);
 	IniEntry(LimiterNormal);
 	IniEntry(OutputFrame);
 	IniEntry(OutputField);
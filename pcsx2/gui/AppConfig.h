@@ -256,6 +256,7 @@ public:
 		wxString LimiterUnlimited;
 		wxString LimiterTurbo;
 		wxString LimiterSlowmo;
+		wxString LimiterFastForward;
 		wxString LimiterNormal;
 		wxString OutputFrame;
 		wxString OutputField;
@@ -354,7 +354,7 @@ void AppCorePlugins::Open()
 // Yay, this plugin is guaranteed to always be opened first and closed last.
 bool AppCorePlugins::OpenPlugin_GS()
 {
-	if( GSopen2 && !s_DisableGsWindow )
+	if( GSopen2 && !s_DisableGsWindow && !wxGetApp().Startup.Headless )
 	{
 		sApp.OpenGsPanel();
 	}
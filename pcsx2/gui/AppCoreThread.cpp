@@ -263,6 +263,20 @@ static int loadGameSettings(Pcsx2Config& dest, const Game_Data& game) {
 	}
 
 
+	if (game.keyExists("eeCacheEmulation")) {
+		bool eeCache = game.getInt("eeCacheEmulation") ? 1 : 0;
+		PatchesCon->WriteLn("(GameDB) Changing EE data cache emulation [mode=%d]", eeCache);
+		dest.Cpu.Recompiler.EnableEECache = eeCache;
+		gf++;
+	}
+
+	if (game.keyExists("mtgsRingSizeFactor")) {
+		int ringFactor = game.getInt("mtgsRingSizeFactor");
+		PatchesCon->WriteLn("(GameDB) Changing MTGS ringbuffer size [factor=%d]", ringFactor);
+		dest.GS.RingSizeFactor = ringFactor;
+		gf++;
+	}
+
 	if (game.keyExists("mvuFlagSpeedHack")) {
 		bool vuFlagHack = game.getInt("mvuFlagSpeedHack") ? 1 : 0;
 		PatchesCon->WriteLn("(GameDB) Changing mVU flag speed hack [mode=%d]", vuFlagHack);
@@ -270,6 +284,13 @@ static int loadGameSettings(Pcsx2Config& dest, const Game_Data& game) {
 		gf++;
 	}
 
+	if (game.keyExists("mtvu0SpeedHack")) {
+		bool vu0Thread = game.getInt("mtvu0SpeedHack") ? 1 : 0;
+		PatchesCon->WriteLn("(GameDB) Changing MTVU0 speed hack [mode=%d]", vu0Thread);
+		dest.Speedhacks.vu0Thread = vu0Thread;
+		gf++;
+	}
+
 	for( GamefixId id=GamefixId_FIRST; id<pxEnumEnd; ++id )
 	{
 		wxString key( EnumToString(id) );
@@ -568,7 +589,10 @@ void AppCoreThread::OnCleanupInThread()
 
 void AppCoreThread::VsyncInThread()
 {
-	wxGetApp().LogicalVsync();
+	// Nothing to update or read input from without a GUI, and it saves a round trip
+	// through the App's event queue every frame.
+	if( !wxGetApp().Startup.Headless )
+		wxGetApp().LogicalVsync();
 	_parent::VsyncInThread();
 }
 
@@ -17,6 +17,10 @@
 #include "App.h"
 #include "AppGameDatabase.h"
 #include <wx/stdpaths.h>
+#include <wx/ffile.h>
+
+#include <algorithm>
+#include <unordered_map>
 
 class DBLoaderHelper
 {
@@ -128,10 +132,199 @@ void DBLoaderHelper::ReadGames()
 	}
 }
 
+// --------------------------------------------------------------------------------------
+//  Compiled database cache
+// --------------------------------------------------------------------------------------
+// The cache is a single blob, read in one go and searched in place; only the game being
+// looked up is ever converted back into a Game_Data.  It is tied to the text database by the
+// latter's size and modification time, and rebuilt from it whenever either changes.
+//
+// Layout:  header | entries[gameCount] (sorted by serial) | pairs[pairCount] | string pool
+// Strings are UTF-8, null terminated, and referenced by their offset in the pool.
+
+static const u32 GameCacheMagic		= 0x31424447;	// 'GDB1'
+static const u32 GameCacheVersion	= 1;
+
+struct GameCacheHeader
+{
+	u32	magic;
+	u32	version;
+	u64	sourceSize;
+	u64	sourceTime;
+	u32	gameCount;
+	u32	pairCount;
+	u32	poolSize;
+	u32	reserved;
+};
+
+struct GameCacheEntry
+{
+	u32	id;
+	u32	firstPair;
+	u32	pairCount;
+};
+
+struct GameCachePair
+{
+	u32	key;
+	u32	value;
+};
+
+bool AppGameDatabase::LoadCache(const wxString& cacheFile, u64 sourceSize, u64 sourceTime)
+{
+	if (!wxFileExists(cacheFile)) return false;
+
+	wxFFile file(cacheFile, L"rb");
+	if (!file.IsOpened()) return false;
+
+	const wxFileOffset length = file.Length();
+	if (length < (wxFileOffset)sizeof(GameCacheHeader)) return false;
+
+	std::vector<u8> cache(length);
+	if (file.Read(cache.data(), length) != (size_t)length) return false;
+
+	const GameCacheHeader& header = (GameCacheHeader&)cache[0];
+	if (header.magic != GameCacheMagic || header.version != GameCacheVersion) return false;
+	if (header.sourceSize != sourceSize || header.sourceTime != sourceTime) return false;
+
+	const u64 expected = sizeof(GameCacheHeader) + (u64)header.gameCount * sizeof(GameCacheEntry) +
+		(u64)header.pairCount * sizeof(GameCachePair) + header.poolSize;
+	if (expected != (u64)length || !header.poolSize) return false;
+
+	// Checked once here, so that lookups can trust the offsets.
+	const GameCacheEntry* entries = (GameCacheEntry*)&cache[sizeof(GameCacheHeader)];
+	const GameCachePair* pairs = (GameCachePair*)(entries + header.gameCount);
+	const char* pool = (char*)(pairs + header.pairCount);
+
+	if (pool[header.poolSize - 1] != 0) return false;
+
+	for (u32 i = 0; i < header.gameCount; ++i)
+	{
+		if (entries[i].id >= header.poolSize || entries[i].firstPair > header.pairCount ||
+			entries[i].pairCount > header.pairCount - entries[i].firstPair)
+			return false;
+	}
+
+	for (u32 i = 0; i < header.pairCount; ++i)
+	{
+		if (pairs[i].key >= header.poolSize || pairs[i].value >= header.poolSize)
+			return false;
+	}
+
+	m_cache.swap(cache);
+	return true;
+}
+
+void AppGameDatabase::SaveCache(const wxString& cacheFile, u64 sourceSize, u64 sourceTime) const
+{
+	std::vector<GameCacheEntry> entries;
+	std::vector<GameCachePair> pairs;
+	std::string pool;
+	std::unordered_map<std::string, u32> pooled;	// keys (and many values) repeat a lot
+
+	auto addString = [&](const wxString& str) -> u32
+	{
+		const std::string utf8(str.utf8_str());
+		auto it = pooled.find(utf8);
+		if (it != pooled.end()) return it->second;
+
+		const u32 offset = pool.size();
+		pool.append(utf8.c_str(), utf8.size() + 1);
+		pooled.emplace(utf8, offset);
+		return offset;
+	};
+
+	entries.reserve(gHash.size());
+	for (const auto& game : gHash)
+	{
+		GameCacheEntry entry;
+		entry.id = addString(game.second.id);
+		entry.firstPair = pairs.size();
+		entry.pairCount = game.second.kList.size();
+		entries.push_back(entry);
+
+		for (const key_pair& pair : game.second.kList)
+		{
+			GameCachePair cached;
+			cached.key = addString(pair.key);
+			cached.value = addString(pair.value);
+			pairs.push_back(cached);
+		}
+	}
+
+	std::sort(entries.begin(), entries.end(), [&](const GameCacheEntry& a, const GameCacheEntry& b) {
+		return strcmp(&pool[a.id], &pool[b.id]) < 0;
+	});
+
+	GameCacheHeader header = {};
+	header.magic = GameCacheMagic;
+	header.version = GameCacheVersion;
+	header.sourceSize = sourceSize;
+	header.sourceTime = sourceTime;
+	header.gameCount = entries.size();
+	header.pairCount = pairs.size();
+	header.poolSize = pool.size();
+
+	// Written under a temporary name first, so that another instance never sees half a cache.
+	const wxString tempFile(cacheFile + L".tmp");
+	{
+		wxFFile file(tempFile, L"wb");
+		if (!file.IsOpened()) return;
+
+		bool ok = file.Write(&header, sizeof(header)) == sizeof(header);
+		ok = ok && file.Write(entries.data(), entries.size() * sizeof(GameCacheEntry)) == entries.size() * sizeof(GameCacheEntry);
+		ok = ok && file.Write(pairs.data(), pairs.size() * sizeof(GameCachePair)) == pairs.size() * sizeof(GameCachePair);
+		ok = ok && file.Write(pool.data(), pool.size()) == pool.size();
+
+		if (!file.Close() || !ok)
+		{
+			wxRemoveFile(tempFile);
+			Console.Warning(L"(GameDB) Could not write the database cache [%s]", WX_STR(cacheFile));
+			return;
+		}
+	}
+
+	if (!wxRenameFile(tempFile, cacheFile, true))
+		wxRemoveFile(tempFile);
+}
+
 // --------------------------------------------------------------------------------------
 //  AppGameDatabase  (implementations)
 // --------------------------------------------------------------------------------------
 
+bool AppGameDatabase::findGame(Game_Data& dest, const wxString& id)
+{
+	if (m_cache.empty())
+		return BaseGameDatabaseImpl::findGame(dest, id);
+
+	const GameCacheHeader& header = (GameCacheHeader&)m_cache[0];
+	const GameCacheEntry* entries = (GameCacheEntry*)&m_cache[sizeof(GameCacheHeader)];
+	const GameCachePair* pairs = (GameCachePair*)(entries + header.gameCount);
+	const char* pool = (char*)(pairs + header.pairCount);
+
+	dest.clear();
+
+	const std::string utf8(id.utf8_str());
+	const GameCacheEntry* end = entries + header.gameCount;
+	const GameCacheEntry* entry = std::lower_bound(entries, end, utf8, [&](const GameCacheEntry& e, const std::string& key) {
+		return strcmp(&pool[e.id], key.c_str()) < 0;
+	});
+
+	if (entry == end || utf8 != &pool[entry->id])
+		return false;
+
+	dest.id = wxString::FromUTF8(&pool[entry->id]);
+	dest.kList.reserve(entry->pairCount);
+
+	for (u32 i = 0; i < entry->pairCount; ++i)
+	{
+		const GameCachePair& pair = pairs[entry->firstPair + i];
+		dest.kList.push_back(key_pair(wxString::FromUTF8(&pool[pair.key]), wxString::FromUTF8(&pool[pair.value])));
+	}
+
+	return true;
+}
+
 AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxString& key )
 {
 	wxString file(_file);
@@ -158,9 +351,25 @@ AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxSt
 		return *this;
 	}
 
+	const u64 sourceSize = wxFileName::GetSize( file ).GetValue();
+	const u64 sourceTime = wxFileModificationTime( file );
+	const wxString cacheFile( Path::Combine( GetSettingsFolder(), wxFileName(L"GameIndex.cache") ) );
+
+	u64 qpc_Start = GetCPUTicks();
+
+	if (LoadCache( cacheFile, sourceSize, sourceTime ))
+	{
+		u64 qpc_end = GetCPUTicks();
+
+		Console.WriteLn( "(GameDB) %d games on record (loaded from cache in %ums)",
+			((GameCacheHeader&)m_cache[0]).gameCount, (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
+		return *this;
+	}
+
 	wxFFileInputStream reader( file );
+	const bool readable = reader.IsOk();
 
-	if (!reader.IsOk())
+	if (!readable)
 	{
 		//throw Exception::FileNotFound( file );
 		Console.Error(L"(GameDB) Could not access file (permission denied?) [%s]", WX_STR(file));
@@ -168,13 +377,15 @@ AppGameDatabase& AppGameDatabase::LoadFromFile(const wxString& _file, const wxSt
 
 	DBLoaderHelper loader( reader, *this );
 
-	u64 qpc_Start = GetCPUTicks();
 	loader.ReadGames();
 	u64 qpc_end = GetCPUTicks();
 
 	Console.WriteLn( "(GameDB) %d games on record (loaded in %ums)",
 		gHash.size(), (u32)(((qpc_end-qpc_Start)*1000) / GetTickFrequency()) );
 
+	if (readable)
+		SaveCache( cacheFile, sourceSize, sourceTime );
+
 	return *this;
 }
 
@@ -38,9 +38,16 @@
 // After the constructor loads the game data, you can use the
 // GameDatabase class's methods to get the other key's values.
 // Such as dbLoader.getString("Region") returns "NTSC-U"
+//
+// The parsed database is also saved in a compiled form (GameIndex.cache, in the settings
+// folder), which is used in place of the text file for as long as the latter is unchanged.
+// Games are then looked up directly in the cache.
 
 class AppGameDatabase : public BaseGameDatabaseImpl
 {
+protected:
+	std::vector<u8>	m_cache;		// compiled database, when loaded from the cache
+
 public:
 	AppGameDatabase() {}
 	virtual ~AppGameDatabase() {
@@ -51,6 +58,12 @@ public:
 	}
 
 	AppGameDatabase& LoadFromFile(const wxString& file = Path::Combine( PathDefs::GetProgramDataDir(), wxFileName(L"GameIndex.dbf") ), const wxString& key = L"Serial" );
+
+	bool findGame(Game_Data& dest, const wxString& id);
+
+protected:
+	bool LoadCache(const wxString& cacheFile, u64 sourceSize, u64 sourceTime);
+	void SaveCache(const wxString& cacheFile, u64 sourceSize, u64 sourceTime) const;
 };
 
 static wxString compatToStringWX(int compat) {
@@ -19,14 +19,22 @@
 #include "ConsoleLogger.h"
 #include "MSWstuff.h"
 #include "MTVU.h" // for thread cancellation on shutdown
+#include "CDVD/IsoCompressor.h"
 
 #include "Utilities/IniInterface.h"
+#include "Utilities/Instrumentation.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/ThreadPlacement.h"
 #include "DebugTools/Debug.h"
 #include "Dialogs/ModalPopups.h"
 
 #include "Debugger/DisassemblyDialog.h"
 
+#include "Benchmark.h"
+
 #ifndef DISABLE_RECORDING
+#	include "Recording/InputRecording.h"
+#	include "Recording/RecordingControls.h"
 #	include "Recording/VirtualPad.h"
 #endif
 
@@ -139,12 +147,16 @@ void Pcsx2App::AllocateCoreStuffs()
 
 	GetVmReserve().ReserveAll();
 
+	// Loaded by the SysExecutor, meanwhile the recompilers reserve their caches here
+	LoadPluginsPassive();
+
 	if( !m_CpuProviders )
 	{
 		// FIXME : Some or all of SysCpuProviderPack should be run from the SysExecutor thread,
 		// so that the thread is safely blocked from being able to start emulation.
 
 		m_CpuProviders = std::make_unique<SysCpuProviderPack>();
+		SysStartupMark( SysStartup_CpuProviders );
 
 		if( m_CpuProviders->HadSomeFailures( g_Conf->EmuOptions.Cpu.Recompiler ) )
 		{
@@ -223,8 +235,6 @@ void Pcsx2App::AllocateCoreStuffs()
 			pxIssueConfirmation( exconf, MsgButtons().OK() );
 		}
 	}
-
-	LoadPluginsPassive();
 }
 
 
@@ -249,11 +259,19 @@ void Pcsx2App::OnInitCmdLine( wxCmdLineParser& parser )
 
 	parser.AddSwitch( wxEmptyString,L"nogui",		_("disables display of the gui while running games") );
 	parser.AddSwitch( wxEmptyString,L"noguiprompt",	_("when nogui - prompt before exiting on suspend") );
+	parser.AddSwitch( wxEmptyString,L"headless",	_("runs without any window (implies --nogui and --instrument); needs windowless GS/PAD plugins such as GSnull, or GSdx which then uses its null renderer") );
 
 	parser.AddOption( wxEmptyString,L"elf",			_("executes an ELF image"), wxCMD_LINE_VAL_STRING );
 	parser.AddOption( wxEmptyString,L"irx",			_("executes an IRX image"), wxCMD_LINE_VAL_STRING );
 	parser.AddSwitch( wxEmptyString,L"nodisc",		_("boots an empty DVD tray; use to enter the PS2 system menu") );
 	parser.AddSwitch( wxEmptyString,L"usecd",		_("boots from the CDVD plugin (overrides IsoFile parameter)") );
+	parser.AddOption( wxEmptyString,L"compress",	_("compresses the IsoFile to the given .cso or .zst file and exits"), wxCMD_LINE_VAL_STRING );
+
+	parser.AddOption( wxEmptyString,L"benchmark",	_("runs the given number of frames unthrottled (0: until the replay ends), writes a JSON report and exits"), wxCMD_LINE_VAL_NUMBER );
+	parser.AddOption( wxEmptyString,L"benchstate",	_("when benchmarking - loads the specified savestate before measuring"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"benchreplay",	_("when benchmarking - replays the specified input recording"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"benchsegment",	_("when benchmarking - frames per timed segment of the report (default: 600)"), wxCMD_LINE_VAL_NUMBER );
+	parser.AddOption( wxEmptyString,L"benchreport",	_("when benchmarking - writes the report to the specified file (default: logs/benchmark.json)"), wxCMD_LINE_VAL_STRING );
 
 	parser.AddSwitch( wxEmptyString,L"nohacks",		_("disables all speedhacks") );
 	parser.AddOption( wxEmptyString,L"gamefixes",	_("use the specified comma or pipe-delimited list of gamefixes.") + fixlist, wxCMD_LINE_VAL_STRING );
@@ -266,6 +284,10 @@ void Pcsx2App::OnInitCmdLine( wxCmdLineParser& parser )
 	parser.AddSwitch( wxEmptyString,L"portable",	_("enables portable mode operation (requires admin/root access)") );
 
 	parser.AddSwitch( wxEmptyString,L"profiling",	_("update options to ease profiling (debug)") );
+	parser.AddSwitch( wxEmptyString,L"instrument",	_("publishes performance counters in shared memory, for external monitoring tools") );
+	parser.AddOption( wxEmptyString,L"workers",		_("number of background worker threads (default: one per host cpu, minus one)"), wxCMD_LINE_VAL_NUMBER );
+	parser.AddOption( wxEmptyString,L"workercpus",	_("hexadecimal mask of the host cpus the background workers may run on"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"placement",	_("host cpus and priority of the emulator threads, e.g. \"EE=2@high;MTVU=4;MTGS=node0+nosmt\""), wxCMD_LINE_VAL_STRING );
 
 	const PluginInfo* pi = tbl_PluginInfo; do {
 		parser.AddOption( wxEmptyString, pi->GetShortname().Lower(),
@@ -352,7 +374,8 @@ bool Pcsx2App::OnCmdLineParsed( wxCmdLineParser& parser )
 	// Suppress wxWidgets automatic options parsing since none of them pertain to PCSX2 needs.
 	//wxApp::OnCmdLineParsed( parser );
 
-	m_UseGUI	= !parser.Found(L"nogui");
+	Startup.Headless	= parser.Found(L"headless");
+	m_UseGUI	= !parser.Found(L"nogui") && !Startup.Headless;
 	m_NoGuiExitPrompt = parser.Found(L"noguiprompt"); // by default no prompt for exit with nogui.
 
 	if( !ParseOverrides(parser) ) return false;
@@ -362,6 +385,40 @@ bool Pcsx2App::OnCmdLineParsed( wxCmdLineParser& parser )
 	Startup.NoFastBoot		= parser.Found(L"fullboot");
 	Startup.ForceWizard		= parser.Found(L"forcewiz");
 	Startup.PortableMode	= parser.Found(L"portable");
+	Startup.Instrument		= parser.Found(L"instrument") || Startup.Headless;
+
+	long workers = 0;
+	wxString workercpus;
+	const bool has_workers = parser.Found( L"workers", &workers );
+	const bool has_workercpus = parser.Found( L"workercpus", &workercpus );
+	if( has_workers || has_workercpus )
+	{
+		wxULongLong_t mask = 0;
+		if( workers < 0 || (!workercpus.IsEmpty() && (!workercpus.ToULongLong( &mask, 16 ) || mask == 0)) )
+		{
+			Console.Error( L"--workers needs a positive count, --workercpus a non-zero hexadecimal cpu mask" );
+			return false;
+		}
+		Threading::ThreadPool::ConfigureShared( workers, mask );
+	}
+
+	wxString placement, placement_error;
+	if( parser.Found( L"placement", &placement ) && !Threading::SetThreadPlacements( placement, placement_error ) )
+	{
+		Console.Error( L"--placement: %s", WX_STR(placement_error) );
+		return false;
+	}
+
+	if( parser.Found(L"compress", &Startup.CompressIsoFile) )
+	{
+		if( parser.GetParamCount() < 1 )
+		{
+			Console.Error( L"--compress needs the IsoFile to compress" );
+			return false;
+		}
+		Startup.IsoFile = parser.GetParam( 0 );
+		return true;
+	}
 
 	if( parser.GetParamCount() >= 1 )
 	{
@@ -397,6 +454,33 @@ bool Pcsx2App::OnCmdLineParsed( wxCmdLineParser& parser )
 		Startup.SysAutoRun = true;
 	}
 
+	long frames;
+	if( parser.Found(L"benchmark", &frames) )
+	{
+		parser.Found( L"benchstate", &Startup.BenchmarkState );
+		parser.Found( L"benchreplay", &Startup.BenchmarkReplay );
+		parser.Found( L"benchreport", &Startup.BenchmarkReport );
+
+		if( frames < 0 || (frames == 0 && Startup.BenchmarkReplay.IsEmpty()) || !(Startup.SysAutoRun || Startup.SysAutoRunElf || Startup.SysAutoRunIrx) )
+		{
+			Console.Error( L"--benchmark needs a frame count (0 only with --benchreplay) and something to boot" );
+			return false;
+		}
+		Startup.Benchmark = true;
+		Startup.BenchmarkFrames = frames;
+
+		long segment;
+		if( parser.Found( L"benchsegment", &segment ) )
+		{
+			if( segment <= 0 )
+			{
+				Console.Error( L"--benchsegment needs a positive frame count" );
+				return false;
+			}
+			Startup.BenchmarkSegment = segment;
+		}
+	}
+
 	return true;
 }
 
@@ -428,7 +512,6 @@ public:
 protected:
 	void ExecuteTaskInThread()
 	{
-		Sleep(2);
 		wxGetApp().GetGameDatabase();
 	}
 
@@ -449,7 +532,12 @@ bool Pcsx2App::OnInit()
 	EnableAllLogging();
 	Console.WriteLn("Interface is initializing.  Entering Pcsx2App::OnInit!");
 
+	// Keep a log storm on the EE/IOP threads from stalling them on the log window.
+	Console_SetAsync( true );
+	Console_SetRateLimit( 50 );
+
 	InitCPUTicks();
+	SysStartupMark( SysStartup_Begin );
 
 	pxDoAssert		= AppDoAssert;
 	pxDoOutOfMemory	= SysOutOfMemory_EmergencyResponse;
@@ -509,14 +597,36 @@ bool Pcsx2App::OnInit()
 		//   Start GUI and/or Direct Emulation
 		// -------------------------------------
 		pxSizerFlags::SetBestPadding();
-		if( Startup.ForceConsole ) g_Conf->ProgLogBox.Visible = true;
-		OpenProgramLog();
-		AllocateCoreStuffs();
-		if( m_UseGUI ) OpenMainFrame();
+		if( Startup.Headless )
+			Console_SetActiveHandler( ConsoleWriter_Stdout );
+		else
+		{
+			if( Startup.ForceConsole ) g_Conf->ProgLogBox.Visible = true;
+			OpenProgramLog();
+		}
 
+		if( !Startup.CompressIsoFile.IsEmpty() )
+		{
+			// Nothing is run afterwards, exit once the image is written
+			if( !CompressIsoFile( Startup.IsoFile, Startup.CompressIsoFile ) )
+			{
+				CleanupOnExit();
+				return false;
+			}
+			PrepForExit();
+			return true;
+		}
 
+		// The database is only needed once a game is running (GetGameDatabase waits for it
+		// then), so let it load alongside the VM allocation and main frame setup.
 		(new GameDatabaseLoaderThread())->Start();
 
+		// Before any plugin is opened, so that they find the segment to attach to.
+		if( Startup.Instrument ) Instrumentation::Create();
+
+		AllocateCoreStuffs();
+		if( m_UseGUI ) OpenMainFrame();
+
 		// By default no IRX injection
 		g_Conf->CurrentIRX = "";
 
@@ -544,6 +654,35 @@ bool Pcsx2App::OnInit()
 			// FIXME: ElfFile is an irx it will crash
 			sApp.SysExecute( Startup.CdvdSource, Startup.ElfFile );
 		}
+
+		if( Startup.Benchmark )
+		{
+			// Everything here is queued behind the boot, so measuring starts only once the
+			// VM is running what the benchmark is about.  A recording brings its own starting
+			// point (it either reboots or loads the savestate it was recorded from).
+#ifndef DISABLE_RECORDING
+			if( !Startup.BenchmarkReplay.IsEmpty() )
+			{
+				if( !Startup.BenchmarkState.IsEmpty() )
+					Console.Warning( L"--benchstate is ignored when replaying an input recording." );
+
+				g_Conf->EmuOptions.EnableRecordingTools = true;
+				g_InputRecording.Play( Startup.BenchmarkReplay, true );
+				if( g_InputRecording.GetModeState() != INPUT_RECORDING_MODE_REPLAY )
+					throw Exception::StartupAborted( L"Benchmark input recording could not be played." );
+				g_RecordingControls.Unpause();
+			}
+			else
+#else
+			if( !Startup.BenchmarkReplay.IsEmpty() )
+				Console.Warning( L"Input recording is not supported by this build; --benchreplay ignored." );
+#endif
+			if( !Startup.BenchmarkState.IsEmpty() )
+				StateCopy_LoadFromFile( Startup.BenchmarkState );
+
+			Benchmark::Setup( Startup.BenchmarkFrames, Startup.BenchmarkSegment, Startup.BenchmarkReport );
+			SysExecutorThread.PostEvent( new SysExecEvent_MethodVoid( Benchmark::Start, L"BenchmarkStart" ) );
+		}
 	}
 	// ----------------------------------------------------------------------------
 	catch( Exception::StartupAborted& ex )		// user-aborted, no popups needed.
@@ -644,6 +783,7 @@ void Pcsx2App::CleanupOnExit()
 	{
 		CleanupRestartable();
 		CleanupResources();
+		Instrumentation::Close();
 	}
 	catch( Exception::CancelEvent& )		{ throw; }
 	catch( Exception::RuntimeError& ex )
@@ -669,6 +809,7 @@ void Pcsx2App::CleanupOnExit()
 	// FIXME: performing a wxYield() here may fix that problem. -- air
 
 	pxDoAssert = pxAssertImpl_LogIt;
+	Console_SetAsync( false );
 	Console_SetActiveHandler( ConsoleWriter_Stdout );
 }
 
@@ -778,6 +919,7 @@ Pcsx2App::~Pcsx2App()
 	pxDoAssert = pxAssertImpl_LogIt;	
 	try {
 		vu1Thread.Cancel();
+		vu0Thread.Cancel();
 	}
 	DESTRUCTOR_CATCHALL
 }
@@ -789,6 +931,7 @@ void Pcsx2App::CleanUp()
 	m_RecentIsoList	= NULL;
 
 	DisableDiskLogging();
+	BinaryTrace::Close();
 
 	if( emuLog != NULL )
 	{
@@ -30,6 +30,7 @@
 #include "Dialogs/LogOptionsDialog.h"
 
 #include "Debugger/DisassemblyDialog.h"
+#include "DebugTools/MIPSAnalyst.h"
 
 #ifndef DISABLE_RECORDING
 #	include "Recording/RecordingControls.h"
@@ -647,8 +648,8 @@ void Pcsx2App::HandleEvent(wxEvtHandler* handler, wxEventFunction func, wxEvent&
 	{
 		// Commandline 'nogui' users will not receive an error message, but at least PCSX2 will
 		// terminate properly.
-		GSFrame* gsframe = wxGetApp().GetGsFramePtr();
-		gsframe->Close();
+		if (GSFrame* gsframe = wxGetApp().GetGsFramePtr())
+			gsframe->Close();
 
 		Console.Error(ex.FormatDiagnosticMessage());
 
@@ -831,6 +832,13 @@ void Pcsx2App::resetDebugger()
 		dlg->reset();
 }
 
+void Pcsx2App::updateDebuggerAnalysis()
+{
+	DisassemblyDialog* dlg = GetDisassemblyPtr();
+	if (dlg)
+		dlg->updateAnalysis();
+}
+
 // NOTE: Plugins are *not* applied by this function.  Changes to plugins need to handled
 // manually.  The PluginSelectorPanel does this, for example.
 void AppApplySettings( const AppConfig* oldconf )
@@ -1121,6 +1129,7 @@ protected:
 		DbgCon.WriteLn( Color_Gray, "(SysExecute) received." );
 
 		CoreThread.ResetQuick();
+		MIPSAnalyst::CancelScan();
 		symbolMap.Clear();
 		CBreakPoints::SetSkipFirst(0);
 
@@ -59,5 +59,6 @@ protected:
 
 extern void StateCopy_SaveToFile( const wxString& file );
 extern void StateCopy_LoadFromFile( const wxString& file );
+extern void StateCopy_Rewind();
 extern void StateCopy_SaveToSlot( uint num );
 extern void StateCopy_LoadFromSlot( uint slot, bool isFromBackup = false );
@@ -297,6 +297,9 @@ void Pcsx2App::EstablishAppUserMode()
 		return;
 	}
 
+	if( Startup.Headless )
+		throw Exception::StartupAborted( L"The first-time wizard can't run headless; run PCSX2 once with its GUI, or use --portable/--cfgpath." );
+
 	DoFirstTimeWizard();
 
 	// Save user's new settings
@@ -20,6 +20,7 @@
 #include "DebugTools/DisassemblyManager.h"
 #include "DebugTools/Breakpoints.h"
 #include "DebugTools/MipsStackWalk.h"
+#include "DebugTools/MIPSAnalyst.h"
 #include "BreakpointWindow.h"
 #include "PathDefs.h"
 
@@ -133,14 +134,39 @@ CpuTabPage::CpuTabPage(wxWindow* parent, DebugInterface* _cpu)
 
 void CpuTabPage::reloadSymbolMap()
 {
-	functionList->Clear();
-
 	auto funcs = symbolMap.GetAllSymbols(ST_FUNCTION);
+
+	// Appending in one go keeps big ELFs from redrawing the list for each function.
+	wxArrayString names;
+	std::vector<void*> addresses;
+	names.Alloc(funcs.size());
+	addresses.reserve(funcs.size());
 	for (size_t i = 0; i < funcs.size(); i++)
 	{
-		wxString name = wxString(funcs[i].name.c_str(),wxConvUTF8);
-		functionList->Append(name,(void*)funcs[i].address);
+		names.Add(wxString(funcs[i].name.c_str(),wxConvUTF8));
+		addresses.push_back((void*)funcs[i].address);
 	}
+
+	functionList->Freeze();
+	functionList->Clear();
+	if (!names.IsEmpty())
+		functionList->Append(names,addresses.data());
+	functionList->Thaw();
+
+	updateAnalysis();
+}
+
+void CpuTabPage::updateAnalysis()
+{
+	int page = leftTabs->FindPage(functionList);
+	if (page == wxNOT_FOUND)
+		return;
+
+	int progress = MIPSAnalyst::GetScanProgress();
+	if (progress < 0)
+		leftTabs->SetPageText(page,L"Functions");
+	else
+		leftTabs->SetPageText(page,wxsFormat(L"Functions (%d%%)",progress));
 }
 
 void CpuTabPage::listBoxHandler(wxCommandEvent& event)
@@ -580,6 +606,12 @@ void DisassemblyDialog::reset()
 	iopTab->reloadSymbolMap();
 }
 
+void DisassemblyDialog::updateAnalysis()
+{
+	eeTab->updateAnalysis();
+	iopTab->updateAnalysis();
+}
+
 void DisassemblyDialog::gotoPc()
 {
 	eeTab->getDisassembly()->gotoPc();
@@ -54,6 +54,7 @@ public:
 	void showMemoryView() { setBottomTabPage(memory); };
 	void loadCycles();
 	void reloadSymbolMap();
+	void updateAnalysis();
 	u32 getStepOutAddress();
 
 	void listBoxHandler(wxCommandEvent& event);
@@ -87,6 +88,7 @@ public:
 	
 	void update();
 	void reset();
+	void updateAnalysis();
 	void setDebugMode(bool debugMode, bool switchPC);
 	
 #ifdef _WIN32
@@ -54,11 +54,13 @@ void GSPanel::InitDefaultAccelerators()
 	m_Accels->Map( AAC( WXK_F3 ).Shift(),		"States_DefrostCurrentSlotBackup");
 	m_Accels->Map( AAC( WXK_F2 ),				"States_CycleSlotForward" );
 	m_Accels->Map( AAC( WXK_F2 ).Shift(),		"States_CycleSlotBackward" );
+	m_Accels->Map( AAC( WXK_BACK ),				"States_Rewind" );
 
 	m_Accels->Map( AAC( WXK_F4 ),				"Framelimiter_MasterToggle");
 	m_Accels->Map( AAC( WXK_F4 ).Shift(),		"Frameskip_Toggle");
 	m_Accels->Map( AAC( WXK_TAB ),				"Framelimiter_TurboToggle" );
 	m_Accels->Map( AAC( WXK_TAB ).Shift(),		"Framelimiter_SlomoToggle" );
+	m_Accels->Map( AAC( WXK_TAB ).Cmd(),		"Framelimiter_FastForwardToggle" );
 
 	m_Accels->Map( AAC( WXK_F6 ),				"GSwindow_CycleAspectRatio" );
 
@@ -692,6 +694,16 @@ void GSFrame::OnUpdateTitle( wxTimerEvent& evt )
 	out << std::fixed << std::setprecision(2) << fps;
 	OSDmonitor(Color_StrongGreen, "FPS:", out.str());
 
+	if (g_Conf->EmuOptions.GS.VsyncQueueAdaptive) {
+		// Stalls since the previous update (the counters restart when the GS is reopened)
+		static u32 lastStalls = 0;
+		const u32 stalls = GetMTGS().m_stats.vsync_stalls.load(std::memory_order_relaxed);
+		const u32 recent = stalls >= lastStalls ? stalls - lastStalls : stalls;
+		lastStalls = stalls;
+
+		OSDmonitor(Color_StrongGreen, "Queue:", std::to_string(GetMTGS().m_VsyncQueueLimit.load()) + " (" + std::to_string(recent) + " stalls)");
+	}
+
 #ifdef __linux__
 	// Important Linux note: When the title is set in fullscreen the window is redrawn. Unfortunately
 	// an intermediate white screen appears too which leads to a very annoying flickering.
@@ -715,6 +727,7 @@ void GSFrame::OnUpdateTitle( wxTimerEvent& evt )
 			case Limit_Nominal:	limiterStr = templates.LimiterNormal; break;
 			case Limit_Turbo:	limiterStr = templates.LimiterTurbo; break;
 			case Limit_Slomo:	limiterStr = templates.LimiterSlowmo; break;
+			case Limit_FastForward:	limiterStr = templates.LimiterFastForward; break;
 		}
 	}
 
@@ -26,6 +26,7 @@ enum LimiterModeType
 	Limit_Nominal,
 	Limit_Turbo,
 	Limit_Slomo,
+	Limit_FastForward,	// unthrottled, with only one frame in GSOptions::FastForwardInterval rendered
 };
 
 extern LimiterModeType g_LimiterMode;
@@ -154,6 +154,28 @@ namespace Implementations
 		pauser.AllowResume();
 	}
 
+	// Runs unthrottled, with the GS only drawing one frame in FastForwardInterval and the
+	// SPU2 muted.  Meant for getting through long stretches of a game quickly.
+	void Framelimiter_FastForwardToggle()
+	{
+		ScopedCoreThreadPause pauser;
+
+		if( g_LimiterMode == Limit_FastForward )
+		{
+			g_LimiterMode = Limit_Nominal;
+			OSDlog( Color_StrongRed, true, "(FrameLimiter) FastForward DISABLED." );
+		}
+		else
+		{
+			g_LimiterMode = Limit_FastForward;
+			OSDlog( Color_StrongRed, true, "(FrameLimiter) FastForward ENABLED, drawing 1 frame in %d.", g_Conf->EmuOptions.GS.FastForwardInterval );
+		}
+
+		gsUpdateFrequency(g_Conf->EmuOptions);
+
+		pauser.AllowResume();
+	}
+
 	void Framelimiter_MasterToggle()
 	{
 		ScopedCoreThreadPause pauser;
@@ -633,6 +655,13 @@ static const GlobalCommandDescriptor CommandDeclarations[] =
 		false,
 	},
 
+	{	"States_Rewind",
+		States_Rewind,
+		pxL( "Rewind" ),
+		pxL( "Steps the virtual machine back to the previous in-memory snapshot." ),
+		false,
+	},
+
 	{	"States_CycleSlotForward",
 		States_CycleSlotForward,
 		pxL( "Cycle to next slot" ),
@@ -668,6 +697,13 @@ static const GlobalCommandDescriptor CommandDeclarations[] =
 		false,
 	},
 
+	{	"Framelimiter_FastForwardToggle",
+		Implementations::Framelimiter_FastForwardToggle,
+		NULL,
+		NULL,
+		false,
+	},
+
 	{	"Framelimiter_MasterToggle",
 		Implementations::Framelimiter_MasterToggle,
 		NULL,
@@ -17,6 +17,7 @@
 
 #include "App.h"
 #include "CDVD/CDVD.h"
+#include "CDVD/HttpFileReader.h"
 #include "GS.h"
 #include "GSFrame.h"
 
@@ -262,10 +263,18 @@ bool MainEmuFrame::_DoSelectIsoBrowser( wxString& result )
 	const wxString isoSupportedLabel( JoinString(isoSupportedTypes, L" ") );
 	const wxString isoSupportedList( JoinFiletypes(isoSupportedTypes) );
 	
+#ifdef PCSX2_ZSTD
+	const wxString compressedLabel(L".gz .cso .zst");
+	const wxString compressedList(L"*.gz;*.cso;*.zst");
+#else
+	const wxString compressedLabel(L".gz .cso");
+	const wxString compressedList(L"*.gz;*.cso");
+#endif
+
 	wxArrayString isoFilterTypes;
 
-	isoFilterTypes.Add(pxsFmt(_("All Supported (%s)"), WX_STR((isoSupportedLabel + L" .dump" + L" .gz" + L" .cso"))));
-	isoFilterTypes.Add(isoSupportedList + L";*.dump" + L";*.gz" + L";*.cso");
+	isoFilterTypes.Add(pxsFmt(_("All Supported (%s)"), WX_STR((isoSupportedLabel + L" .dump " + compressedLabel))));
+	isoFilterTypes.Add(isoSupportedList + L";*.dump;" + compressedList);
 
 	isoFilterTypes.Add(pxsFmt(_("Disc Images (%s)"), WX_STR(isoSupportedLabel) ));
 	isoFilterTypes.Add(isoSupportedList);
@@ -273,8 +282,8 @@ bool MainEmuFrame::_DoSelectIsoBrowser( wxString& result )
 	isoFilterTypes.Add(pxsFmt(_("Blockdumps (%s)"), L".dump" ));
 	isoFilterTypes.Add(L"*.dump");
 
-	isoFilterTypes.Add(pxsFmt(_("Compressed (%s)"), L".gz .cso"));
-	isoFilterTypes.Add(L"*.gz;*.cso");
+	isoFilterTypes.Add(pxsFmt(_("Compressed (%s)"), WX_STR(compressedLabel)));
+	isoFilterTypes.Add(compressedList);
 
 	isoFilterTypes.Add(_("All Files (*.*)"));
 	isoFilterTypes.Add(L"*.*");
@@ -317,7 +326,7 @@ void MainEmuFrame::_DoBootCdvd()
 	{
 		bool selector = g_Conf->CurrentIso.IsEmpty();
 
-		if( !selector && !wxFileExists(g_Conf->CurrentIso) )
+		if( !selector && !wxFileExists(g_Conf->CurrentIso) && !HttpFileReader::CanHandle(g_Conf->CurrentIso) )
 		{
 			// User has an iso selected from a previous run, but it doesn't exist anymore.
 			// Issue a courtesy popup and then an Iso Selector to choose a new one.
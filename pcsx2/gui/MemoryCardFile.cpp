@@ -40,29 +40,61 @@ struct Component_FileMcd;
 
 #include <wx/ffile.h>
 #include <map>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __WXMSW__
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 static const int MCD_SIZE	= 1024 *  8  * 16;		// Legacy PSX card default size
 
 static const int MC2_MBSIZE	= 1024 * 528 * 2;		// Size of a single megabyte of card data
 
+// Erase block size (16 sectors of 512 bytes + 16 bytes ECC), also the unit of write-back.
+static const u32 MC2_BLOCKSIZE	= 528 * 16;
+
+// Writes are collected for this long before being written back, since games save in lots
+// of small page writes.
+static const std::chrono::milliseconds FlushDelay( 500 );
+
 // --------------------------------------------------------------------------------------
 //  FileMemoryCard
 // --------------------------------------------------------------------------------------
-// Provides thread-safe direct file IO mapping.
+// Each card is read into memory when opened, and all reads and writes go to that image.
+// Blocks that were written are marked dirty and written back to the file by a flush thread,
+// once the game has stopped writing for a moment (and synced to disk when idle, or when
+// the card is closed).  This keeps file IO, which can be slow (network home directories),
+// off the emulation thread entirely.
 //
 class FileMemoryCard
 {
 protected:
 	wxFFile			m_file[8];
 	u8				m_effeffs[528*16];
-	SafeArray<u8>	m_currentdata;
 	u64				m_chksum[8];
 	bool			m_ispsx[8];
 	u32				m_chkaddr;
 
+	std::vector<u8>		m_image[8];
+	u32					m_offset[8];		// of the card data within the file (see GetDataOffset)
+	std::vector<bool>	m_dirty[8];			// one per MC2_BLOCKSIZE of file
+
+	// Protects m_image writes and m_dirty.  The emulation thread is the only writer of the
+	// images, so its reads go without.
+	std::mutex				m_lock;
+	std::condition_variable	m_cond;
+	std::thread				m_flushThread;
+	bool					m_pending;		// something is dirty
+	bool					m_quit;
+
 public:
 	FileMemoryCard();
-	virtual ~FileMemoryCard() = default;
+	virtual ~FileMemoryCard();
 
 	void Lock();
 	void Unlock();
@@ -79,9 +111,16 @@ public:
 	u64  GetCRC		( uint slot );
 
 protected:
-	bool Seek( wxFFile& f, u32 adr );
+	static u32 GetDataOffset( u32 size );
 	bool Create( const wxString& mcdFile, uint sizeInMB );
 
+	bool InRange( uint slot, u32 adr, int size ) const;
+	void MarkDirty( uint slot, u32 adr, int size );
+	void XorPsxChecksum( uint slot, u32 adr, int size );
+
+	void FlushThread();
+	bool FlushDirty();
+
 	wxString GetDisabledMessage( uint slot ) const
 	{
 		return wxsFormat( pxE( L"The PS2-slot %d has been automatically disabled.  You can correct the problem\nand re-enable it at any time using Config:Memory cards from the main menu."
@@ -143,10 +182,30 @@ wxString FileMcd_GetDefaultName(uint slot)
 		return wxsFormat( L"Mcd%03u.ps2", slot+1 );
 }
 
+static void SyncFile( wxFFile& f )
+{
+	f.Flush();
+#ifdef __WXMSW__
+	_commit( _fileno( f.fp() ) );
+#else
+	fsync( fileno( f.fp() ) );
+#endif
+}
+
 FileMemoryCard::FileMemoryCard()
 {
 	memset8<0xff>( m_effeffs );
 	m_chkaddr = 0;
+	m_pending = false;
+	m_quit = false;
+}
+
+FileMemoryCard::~FileMemoryCard()
+{
+	try {
+		Close();
+	}
+	DESTRUCTOR_CATCHALL
 }
 
 void FileMemoryCard::Open()
@@ -206,8 +265,21 @@ void FileMemoryCard::Open()
 		NTFS_CompressFile( str, g_Conf->McdCompressNTFS );
 #endif
 
-		if( !m_file[slot].Open( str.c_str(), L"r+b" ) )
+		bool opened = m_file[slot].Open( str.c_str(), L"r+b" );
+
+		if( opened )
+		{
+			const u32 length = m_file[slot].Length();
+			m_image[slot].resize( length );
+
+			opened = m_file[slot].Seek( 0 ) && (m_file[slot].Read( m_image[slot].data(), length ) == length);
+			if( !opened ) m_file[slot].Close();
+		}
+
+		if( !opened )
 		{
+			m_image[slot].clear();
+
 			// Translation note: detailed description should mention that the memory card will be disabled
 			// for the duration of this session.
 			Msgbox::Alert(
@@ -217,17 +289,42 @@ void FileMemoryCard::Open()
 		}
 		else // Load checksum
 		{
-			m_ispsx[slot] = m_file[slot].Length() == 0x20000;
-			m_chkaddr = 0x210;
+			const u32 length = m_image[slot].size();
 
-			if(!m_ispsx[slot] && !!m_file[slot].Seek( m_chkaddr ))
-				m_file[slot].Read( &m_chksum[slot], 8 );
+			m_ispsx[slot] = length == 0x20000;
+			m_chkaddr = 0x210;
+			m_offset[slot] = GetDataOffset( length );
+			m_dirty[slot].assign( (length + MC2_BLOCKSIZE - 1) / MC2_BLOCKSIZE, false );
+			m_chksum[slot] = 0;
+
+			if( m_ispsx[slot] )
+				XorPsxChecksum( slot, 0, length );
+			else if( m_chkaddr + 8 <= length )
+				memcpy( &m_chksum[slot], &m_image[slot][m_chkaddr], 8 );
 		}
 	}
+
+	if( !m_flushThread.joinable() )
+	{
+		m_quit = false;
+		m_pending = false;
+		m_flushThread = std::thread( &FileMemoryCard::FlushThread, this );
+	}
 }
 
 void FileMemoryCard::Close()
 {
+	if( m_flushThread.joinable() )
+	{
+		{
+			std::lock_guard<std::mutex> guard( m_lock );
+			m_quit = true;
+		}
+		m_cond.notify_all();
+		m_flushThread.join();
+	}
+
+	// The flush thread writes everything back before quitting.
 	for( int slot=0; slot<8; ++slot )
 	{
 		if (m_file[slot].IsOpened()) {
@@ -235,16 +332,18 @@ void FileMemoryCard::Close()
 			if(!m_ispsx[slot] && !!m_file[slot].Seek(  m_chkaddr ))
 				m_file[slot].Write( &m_chksum[slot], 8 );
 
+			SyncFile( m_file[slot] );
 			m_file[slot].Close();
 		}
+
+		m_image[slot] = std::vector<u8>();
+		m_dirty[slot].clear();
 	}
 }
 
-// Returns FALSE if the seek failed (is outside the bounds of the file).
-bool FileMemoryCard::Seek( wxFFile& f, u32 adr )
+// Returns the offset of the card data within a file of the given size.
+u32 FileMemoryCard::GetDataOffset( u32 size )
 {
-	const u32 size = f.Length();
-
 	// If anyone knows why this filesize logic is here (it appears to be related to legacy PSX
 	// cards, perhaps hacked support for some special emulator-specific memcard formats that
 	// had header info?), then please replace this comment with something useful.  Thanks!  -- air
@@ -260,7 +359,7 @@ bool FileMemoryCard::Seek( wxFFile& f, u32 adr )
 		// perform sanity checks here?
 	}
 
-	return f.Seek( adr + offset );
+	return offset;
 }
 
 // returns FALSE if an error occurred (either permission denied or disk full)
@@ -281,6 +380,121 @@ bool FileMemoryCard::Create( const wxString& mcdFile, uint sizeInMB )
 	return true;
 }
 
+// Returns FALSE if the access is outside the bounds of the card.
+bool FileMemoryCard::InRange( uint slot, u32 adr, int size ) const
+{
+	return (u64)m_offset[slot] + adr + size <= m_image[slot].size();
+}
+
+// Caller must hold m_lock.
+void FileMemoryCard::MarkDirty( uint slot, u32 adr, int size )
+{
+	if( size <= 0 ) return;
+
+	const u32 begin = m_offset[slot] + adr;
+	const u32 last = begin + size - 1;
+
+	for( u32 block = begin / MC2_BLOCKSIZE; block <= last / MC2_BLOCKSIZE; ++block )
+		m_dirty[slot][block] = true;
+
+	m_pending = true;
+}
+
+// PSX cards have no stored checksum; their CRC is the xor of all u64 words of the card
+// (up to the last whole 528*64 bytes, as it has always been computed).  Xoring a range
+// out before it's written and back in afterwards keeps it current.
+void FileMemoryCard::XorPsxChecksum( uint slot, u32 adr, int size )
+{
+	const u32 limit = (m_image[slot].size() - m_offset[slot]) / (528*64) * (528*64);
+	const u32 end = std::min<u32>( (adr + size + 7) & ~7, limit );
+	const u8* data = &m_image[slot][m_offset[slot]];
+
+	for( u32 i = adr & ~7; i < end; i += 8 )
+	{
+		u64 word;
+		memcpy( &word, data + i, 8 );
+		m_chksum[slot] ^= word;
+	}
+}
+
+// Writes all dirty blocks back to the files.  Only the flush thread touches the files while
+// it is running.  Returns false if a write failed.
+bool FileMemoryCard::FlushDirty()
+{
+	bool ok = true;
+
+	for( uint slot=0; slot<8; ++slot )
+	{
+		if( !m_file[slot].IsOpened() ) continue;
+
+		const u32 blocks = m_dirty[slot].size();
+		const u32 length = m_image[slot].size();
+
+		// Copy out one run of consecutive dirty blocks at a time, so that the lock is only
+		// held for a memcpy and the emulation thread can keep writing while the file IO runs.
+		for( u32 block = 0; block < blocks; )
+		{
+			std::vector<u8> run;
+			u32 start = 0;
+
+			{
+				std::lock_guard<std::mutex> guard( m_lock );
+
+				while( block < blocks && !m_dirty[slot][block] ) ++block;
+				if( block == blocks ) break;
+
+				start = block * MC2_BLOCKSIZE;
+				for( ; block < blocks && m_dirty[slot][block]; ++block )
+					m_dirty[slot][block] = false;
+
+				const u32 end = std::min( block * MC2_BLOCKSIZE, length );
+				run.assign( m_image[slot].begin() + start, m_image[slot].begin() + end );
+			}
+
+			if( !m_file[slot].Seek( start ) || m_file[slot].Write( run.data(), run.size() ) != run.size() )
+			{
+				Console.Error( L"(FileMcd) Error writing to memory card %s.", WX_STR(m_file[slot].GetName()) );
+				ok = false;
+			}
+		}
+	}
+
+	return ok;
+}
+
+void FileMemoryCard::FlushThread()
+{
+	std::unique_lock<std::mutex> lock( m_lock );
+
+	while( true )
+	{
+		m_cond.wait( lock, [this] { return m_pending || m_quit; } );
+
+		// Let the game finish its save; the emulation thread keeps writing into the images
+		// (and marking blocks dirty) in the meantime.
+		if( !m_quit )
+			m_cond.wait_for( lock, FlushDelay, [this] { return m_quit; } );
+
+		m_pending = false;
+		lock.unlock();
+
+		const bool ok = FlushDirty();
+
+		lock.lock();
+
+		// Nothing new was written during the flush: the card is idle, make sure it is on disk.
+		if( ok && !m_pending && !m_quit )
+		{
+			lock.unlock();
+			for( uint slot=0; slot<8; ++slot )
+				if( m_file[slot].IsOpened() ) SyncFile( m_file[slot] );
+			lock.lock();
+		}
+
+		if( m_quit && !m_pending ) break;
+	}
+}
+
 s32 FileMemoryCard::IsPresent( uint slot )
 {
 	return m_file[slot].IsOpened();
@@ -293,7 +507,7 @@ void FileMemoryCard::GetSizeInfo( uint slot, PS2E_McdSizeInfo& outways )
 	outways.Xor						= 18;  // 0x12, XOR 02 00 00 10
 
 	if( pxAssert( m_file[slot].IsOpened() ) )
-		outways.McdSizeInSectors	= m_file[slot].Length() / (outways.SectorSize + outways.EraseBlockSizeInSectors);
+		outways.McdSizeInSectors	= m_image[slot].size() / (outways.SectorSize + outways.EraseBlockSizeInSectors);
 	else
 		outways.McdSizeInSectors	= 0x4000;
 
@@ -308,122 +522,109 @@ bool FileMemoryCard::IsPSX( uint slot )
 
 s32 FileMemoryCard::Read( uint slot, u8 *dest, u32 adr, int size )
 {
-	wxFFile& mcfp( m_file[slot] );
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "(FileMcd) Ignoring attempted read from disabled slot." );
 		memset(dest, 0, size);
 		return 1;
 	}
-	if( !Seek(mcfp, adr) ) return 0;
-	return mcfp.Read( dest, size ) != 0;
+	if( !InRange(slot, adr, size) ) return 0;
+
+	memcpy( dest, &m_image[slot][m_offset[slot] + adr], size );
+	return 1;
 }
 
 s32 FileMemoryCard::Save( uint slot, const u8 *src, u32 adr, int size )
 {
-	wxFFile& mcfp( m_file[slot] );
-
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "(FileMcd) Ignoring attempted save/write to disabled slot." );
 		return 1;
 	}
 
-	if(m_ispsx[slot])
-	{
-		m_currentdata.MakeRoomFor( size );
-		for (int i=0; i<size; i++) m_currentdata[i] = src[i];
-	}
-	else
+	if( !InRange(slot, adr, size) ) return 0;
+
 	{
-		if( !Seek(mcfp, adr) ) return 0;
-		m_currentdata.MakeRoomFor( size );
-		mcfp.Read( m_currentdata.GetPtr(), size);
-		
+		std::lock_guard<std::mutex> guard( m_lock );
+		u8* data = &m_image[slot][m_offset[slot] + adr];
 
-		for (int i=0; i<size; i++)
+		if(m_ispsx[slot])
 		{
-			if ((m_currentdata[i] & src[i]) != src[i])
-				Console.Warning("(FileMcd) Warning: writing to uncleared data. (%d) [%08X]", slot, adr);
-			m_currentdata[i] &= src[i];
+			XorPsxChecksum( slot, adr, size );
+			memcpy( data, src, size );
+			XorPsxChecksum( slot, adr, size );
 		}
-
-		// Checksumness
+		else
 		{
-			if(adr == m_chkaddr) 
-				Console.Warning("(FileMcd) Warning: checksum sector overwritten. (%d)", slot);
+			for (int i=0; i<size; i++)
+			{
+				if ((data[i] & src[i]) != src[i])
+					Console.Warning("(FileMcd) Warning: writing to uncleared data. (%d) [%08X]", slot, adr);
+				data[i] &= src[i];
+			}
+
+			// Checksumness
+			{
+				if(adr == m_chkaddr) 
+					Console.Warning("(FileMcd) Warning: checksum sector overwritten. (%d)", slot);
 
-			u64 *pdata = (u64*)&m_currentdata[0];
-			u32 loops = size / 8;
+				u32 loops = size / 8;
 
-			for(u32 i = 0; i < loops; i++)
-				m_chksum[slot] ^= pdata[i];
+				for(u32 i = 0; i < loops; i++)
+				{
+					u64 word;
+					memcpy( &word, data + i * 8, 8 );
+					m_chksum[slot] ^= word;
+				}
+			}
 		}
-	}
-
-	if( !Seek(mcfp, adr) ) return 0;
 
-	int status = mcfp.Write( m_currentdata.GetPtr(), size );
+		MarkDirty( slot, adr, size );
+	}
+	m_cond.notify_one();
 
-	if( status ) {
-		static auto last = std::chrono::time_point<std::chrono::system_clock>();
+	static auto last = std::chrono::time_point<std::chrono::system_clock>();
 
-		std::chrono::duration<float> elapsed = std::chrono::system_clock::now() - last;
-		if(elapsed > std::chrono::seconds(5)) {
-			wxString name, ext;
-			wxFileName::SplitPath(m_file[slot].GetName(), NULL, NULL, &name, &ext);
-			OSDlog( Color_StrongYellow, false, "Memory Card %s written.", (const char *)(name + "." + ext).c_str() );
-			last = std::chrono::system_clock::now();
-		}
-		return 1;
+	std::chrono::duration<float> elapsed = std::chrono::system_clock::now() - last;
+	if(elapsed > std::chrono::seconds(5)) {
+		wxString name, ext;
+		wxFileName::SplitPath(m_file[slot].GetName(), NULL, NULL, &name, &ext);
+		OSDlog( Color_StrongYellow, false, "Memory Card %s written.", (const char *)(name + "." + ext).c_str() );
+		last = std::chrono::system_clock::now();
 	}
-
-	return 0;
+	return 1;
 }
 
 s32 FileMemoryCard::EraseBlock( uint slot, u32 adr )
 {
-	wxFFile& mcfp( m_file[slot] );
-
-	if( !mcfp.IsOpened() )
+	if( !m_file[slot].IsOpened() )
 	{
 		DevCon.Error( "MemoryCard: Ignoring erase for disabled slot." );
 		return 1;
 	}
 
-	if( !Seek(mcfp, adr) ) return 0;
-	return mcfp.Write( m_effeffs, sizeof(m_effeffs) ) != 0;
-}
+	if( !InRange(slot, adr, sizeof(m_effeffs)) ) return 0;
 
-u64 FileMemoryCard::GetCRC( uint slot )
-{
-	wxFFile& mcfp( m_file[slot] );
-	if( !mcfp.IsOpened() ) return 0;
+	{
+		std::lock_guard<std::mutex> guard( m_lock );
 
-	u64 retval = 0;
+		if( m_ispsx[slot] ) XorPsxChecksum( slot, adr, sizeof(m_effeffs) );
+		memcpy( &m_image[slot][m_offset[slot] + adr], m_effeffs, sizeof(m_effeffs) );
+		if( m_ispsx[slot] ) XorPsxChecksum( slot, adr, sizeof(m_effeffs) );
 
-	if(m_ispsx[slot])
-	{
-		if( !Seek( mcfp, 0 ) ) return 0;
-
-		// Process the file in 4k chunks.  Speeds things up significantly.
-	
-		u64 buffer[528*8];		// use 528 (sector size), ensures even divisibility
-	
-		const uint filesize = mcfp.Length() / sizeof(buffer);
-		for( uint i=filesize; i; --i )
-		{
-			mcfp.Read( &buffer, sizeof(buffer) );
-			for( uint t=0; t<ArraySize(buffer); ++t )
-				retval ^= buffer[t];
-		}
-	}
-	else
-	{
-		retval = m_chksum[slot];
+		MarkDirty( slot, adr, sizeof(m_effeffs) );
 	}
+	m_cond.notify_one();
+
+	return 1;
+}
+
+u64 FileMemoryCard::GetCRC( uint slot )
+{
+	if( !m_file[slot].IsOpened() ) return 0;
 
-	return retval;
+	// PSX checksums are kept up to date by Save and EraseBlock, instead of rescanning the card.
+	return m_chksum[slot];
 }
 
 // --------------------------------------------------------------------------------------
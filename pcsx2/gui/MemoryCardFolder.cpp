@@ -34,6 +34,11 @@ FolderMemoryCard::FolderMemoryCard() {
 	m_timeLastWritten = 0;
 	m_filteringEnabled = false;
 	m_filteringString = L"";
+	m_flushDone = false;
+}
+
+FolderMemoryCard::~FolderMemoryCard() {
+	FinishFlush();
 }
 
 void FolderMemoryCard::InitializeInternalData() {
@@ -64,6 +69,7 @@ void FolderMemoryCard::Open( const bool enableFiltering, const wxString& filter
 }
 
 void FolderMemoryCard::Open( const wxString& fullPath, const AppConfig::McdOptions& mcdOptions, const u32 sizeInClusters, const bool enableFiltering, const wxString& filter, bool simulateFileWrites ) {
+	FinishFlush();
 	InitializeInternalData();
 	m_performFileWrites = !simulateFileWrites;
 
@@ -107,10 +113,12 @@ void FolderMemoryCard::Open( const wxString& fullPath, const AppConfig::McdOptio
 }
 
 void FolderMemoryCard::Close( bool flush ) {
+	FinishFlush();
 	if ( !m_isEnabled ) { return; }
 
 	if ( flush ) {
-		Flush();
+		BeginFlush();
+		FinishFlush();
 	}
 
 	m_cache.clear();
@@ -572,7 +580,10 @@ s32 FolderMemoryCard::IsPresent() const {
 void FolderMemoryCard::GetSizeInfo( PS2E_McdSizeInfo& outways ) const {
 	outways.SectorSize = PageSize;
 	outways.EraseBlockSizeInSectors = BlockSize / PageSize;
-	outways.McdSizeInSectors = GetSizeInClusters() * 2;
+	{
+		std::lock_guard<std::mutex> guard( m_flushLock );
+		outways.McdSizeInSectors = GetSizeInClusters() * 2;
+	}
 
 	u8 *pdata = (u8*)&outways.McdSizeInSectors;
 	outways.Xor = 18;
@@ -802,6 +813,17 @@ s32 FolderMemoryCard::Read( u8 *dest, u32 adr, int size ) {
 }
 
 void FolderMemoryCard::ReadDataWithoutCache( u8* const dest, const u32 adr, const u32 dataLength ) {
+	// pages that are being flushed right now may not have made it to the underlying data yet
+	if ( !m_flushingPages.empty() ) {
+		auto it = m_flushingPages.find( adr / PageSizeRaw );
+		if ( it != m_flushingPages.end() ) {
+			memcpy( dest, &it->second.raw[adr % PageSizeRaw], dataLength );
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> guard( m_flushLock );
+
 	u8* src = GetSystemBlockPointer( adr );
 	if ( src != nullptr ) {
 		memcpy( dest, src, dataLength );
@@ -853,13 +875,67 @@ s32 FolderMemoryCard::Save( const u8 *src, u32 adr, int size ) {
 }
 
 void FolderMemoryCard::NextFrame() {
+	if ( m_flushThread.joinable() && m_flushDone ) {
+		FinishFlush();
+	}
+
 	if ( m_framesUntilFlush > 0 && --m_framesUntilFlush == 0 ) {
+		if ( m_flushThread.joinable() ) {
+			// the previous flush is still busy, try again next frame
+			m_framesUntilFlush = 1;
+		} else {
+			BeginFlush();
+		}
+	}
+}
+
+void FolderMemoryCard::BeginFlush() {
+	if ( m_cache.empty() ) { return; }
+
+	m_flushingPages = m_cache;
+	m_flushCache.swap( m_cache );
+	m_flushOldData.swap( m_oldDataCache );
+	m_cache.clear();
+	m_oldDataCache.clear();
+
+	m_flushDone = false;
+	m_flushThread = std::thread( &FolderMemoryCard::FlushThread, this );
+}
+
+void FolderMemoryCard::FinishFlush() {
+	if ( !m_flushThread.joinable() ) { return; }
+	m_flushThread.join();
+
+	// an aborted flush leaves its pages behind, keep them around for the next one
+	// (anything the emulation wrote since is newer, but the old data still predates both)
+	for ( auto& page : m_flushCache ) {
+		if ( m_cache.find( page.first ) == m_cache.end() ) {
+			m_cache.emplace( page.first, page.second );
+		}
+		auto old = m_flushOldData.find( page.first );
+		if ( old != m_flushOldData.end() ) {
+			m_oldDataCache[page.first] = old->second;
+		}
+	}
+
+	m_flushCache.clear();
+	m_flushOldData.clear();
+	m_flushingPages.clear();
+}
+
+void FolderMemoryCard::FlushThread() {
+	try {
+		std::lock_guard<std::mutex> guard( m_flushLock );
 		Flush();
+	} catch ( BaseException& ex ) {
+		Console.Error( L"(FolderMcd) Flush of slot %u failed: %s", m_slot, WX_STR( ex.FormatDiagnosticMessage() ) );
 	}
+
+	m_flushDone = true;
 }
 
 void FolderMemoryCard::Flush() {
-	if ( m_cache.empty() ) { return; }
+	if ( m_flushCache.empty() ) { return; }
 
 	#ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
 	WriteToFile( m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format( L"%Y-%m-%d-%H-%M-%S" ) + L"_pre-flush.ps2" );
@@ -920,7 +996,7 @@ void FolderMemoryCard::Flush() {
 
 	m_lastAccessedFile.FlushAll();
 	m_lastAccessedFile.ClearMetadataWriteState();
-	m_oldDataCache.clear();
+	m_flushOldData.clear();
 
 	const u64 timeFlushEnd = wxGetLocalTimeMillis().GetValue();
 	Console.WriteLn( L"(FolderMcd) Done! Took %u ms.", timeFlushEnd - timeFlushStart );
@@ -931,10 +1007,10 @@ void FolderMemoryCard::Flush() {
 }
 
 bool FolderMemoryCard::FlushPage( const u32 page ) {
-	auto it = m_cache.find( page );
-	if ( it != m_cache.end() ) {
+	auto it = m_flushCache.find( page );
+	if ( it != m_flushCache.end() ) {
 		WriteWithoutCache( &it->second.raw[0], page * PageSizeRaw, PageSize );
-		m_cache.erase( it );
+		m_flushCache.erase( it );
 		return true;
 	}
 	return false;
@@ -1085,7 +1161,7 @@ void FolderMemoryCard::FlushDeletedFilesAndRemoveUnchangedDataFromCache( const s
 				const wxString subDirPath = dirPath + L"/" + subDirName;
 				FlushDeletedFilesAndRemoveUnchangedDataFromCache( it->subdir, newEntry->entry.data.cluster, newEntry->entry.data.length, subDirPath );
 			} else if ( entry->IsFile() ) {
-				// still exists and is a file, see if we can remove unchanged data from m_cache
+				// still exists and is a file, see if we can remove unchanged data from m_flushCache
 				RemoveUnchangedDataFromCache( entry, newEntry );
 			}
 		}
@@ -1108,13 +1184,13 @@ void FolderMemoryCard::RemoveUnchangedDataFromCache( const MemoryCardFileEntry*
 	while ( cluster != LastDataCluster ) {
 		for ( int i = 0; i < 2; ++i ) {
 			const u32 page = ( cluster + alloc_offset ) * 2 + i;
-			auto newIt = m_cache.find( page );
-			if ( newIt == m_cache.end() ) { continue; }
-			auto oldIt = m_oldDataCache.find( page );
-			if ( oldIt == m_oldDataCache.end() ) { continue; }
+			auto newIt = m_flushCache.find( page );
+			if ( newIt == m_flushCache.end() ) { continue; }
+			auto oldIt = m_flushOldData.find( page );
+			if ( oldIt == m_flushOldData.end() ) { continue; }
 
 			if ( memcmp( &oldIt->second.raw[0], &newIt->second.raw[0], PageSize ) == 0 ) {
-				m_cache.erase( newIt );
+				m_flushCache.erase( newIt );
 			}
 		}
 
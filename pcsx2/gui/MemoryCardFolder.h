@@ -18,7 +18,11 @@
 #include <wx/file.h>
 #include <wx/dir.h>
 #include <wx/ffile.h>
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "PluginCallbacks.h"
@@ -297,16 +301,29 @@ protected:
 	} m_backupBlock2;
 
 	// stores directory and file metadata
-	std::map<u32, MemoryCardFileEntryCluster> m_fileEntryDict;
+	// (node based, MemoryCardFileMetadataReference points into both of these)
+	std::unordered_map<u32, MemoryCardFileEntryCluster> m_fileEntryDict;
 	// quick-access map of related file entry metadata for each memory card FAT cluster that contains file data
-	std::map<u32, MemoryCardFileMetadataReference> m_fileMetadataQuickAccess;
+	std::unordered_map<u32, MemoryCardFileMetadataReference> m_fileMetadataQuickAccess;
 
 	// holds a copy of modified pages of the memory card before they're flushed to the file system
-	std::map<u32, MemoryCardPage> m_cache;
+	std::unordered_map<u32, MemoryCardPage> m_cache;
 	// contains the state of how the data looked before the first write to it
 	// used to reduce the amount of disk I/O by not re-writing unchanged data that just happened to be
 	// touched in memory due to how actual physical memory cards have to erase and rewrite in blocks
-	std::map<u32, MemoryCardPage> m_oldDataCache;
+	std::unordered_map<u32, MemoryCardPage> m_oldDataCache;
+
+	// Flushes run on m_flushThread, on the pages m_cache and m_oldDataCache held when the flush
+	// started; emulation keeps going with empty caches meanwhile.  The flush thread owns
+	// m_flushCache and m_flushOldData, and holds m_flushLock while it modifies everything
+	// else (metadata, system blocks, host files), so reads of the card's underlying data take
+	// it too.  m_flushingPages is the emulation thread's copy of the pages being flushed.
+	std::unordered_map<u32, MemoryCardPage> m_flushCache;
+	std::unordered_map<u32, MemoryCardPage> m_flushOldData;
+	std::unordered_map<u32, MemoryCardPage> m_flushingPages;
+	std::thread m_flushThread;
+	std::atomic<bool> m_flushDone;
+	mutable std::mutex m_flushLock;
 	// if > 0, the amount of frames until data is flushed to the file system
 	// reset to FramesAfterWriteUntilFlush on each write
 	int m_framesUntilFlush;
@@ -333,7 +350,7 @@ protected:
 
 public:
 	FolderMemoryCard();
-	virtual ~FolderMemoryCard() = default;
+	virtual ~FolderMemoryCard();
 
 	void Lock();
 	void Unlock();
@@ -485,6 +502,12 @@ protected:
 	// flush the whole cache to the internal data and/or host file system
 	void Flush();
 
+	// starts a Flush() of the current caches on m_flushThread
+	void BeginFlush();
+	// waits for a running flush, and puts back into the caches whatever it could not write
+	void FinishFlush();
+	void FlushThread();
+
 	// flush a single page of the cache to the internal data and/or host file system
 	bool FlushPage( const u32 page );
 
@@ -190,7 +190,6 @@ namespace Panels
 
 	protected:
 		void OnRestoreDefaults( wxCommandEvent& evt );
-		void EECache_Event( wxCommandEvent& evt );
 	};
 
 	class CpuPanelVU : public BaseApplicableConfigPanel_SpecificConfig
@@ -342,6 +341,7 @@ namespace Panels
 		pxCheckBox*		m_check_fastCDVD;
 		pxCheckBox*		m_check_vuFlagHack;
 		pxCheckBox*		m_check_vuThread;
+		pxCheckBox*		m_check_vu0Thread;
 
 	public:
 		virtual ~SpeedHacksPanel() = default;
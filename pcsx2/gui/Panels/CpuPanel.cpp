@@ -151,7 +151,7 @@ Panels::CpuPanelEE::CpuPanelEE( wxWindow* parent )
 	wxStaticBoxSizer& s_iop	( *new wxStaticBoxSizer( wxVERTICAL, this, L"IOP" ) );
 
 	s_ee	+= m_panel_RecEE	| StdExpand();
-	s_ee    += m_check_EECacheEnable = &(new pxCheckBox( this, _("Enable EE Cache (Slower)") ))->SetToolTip(_("Interpreter only; provided for diagnostic"));
+	s_ee    += m_check_EECacheEnable = &(new pxCheckBox( this, _("Enable EE Cache (Slower)") ))->SetToolTip(_("Emulates the EE data cache for cached TLB mappings; only a few games need it"));
 	s_iop	+= m_panel_RecIOP	| StdExpand();
 
 	s_recs	+= s_ee				| SubGroup();
@@ -171,7 +171,6 @@ Panels::CpuPanelEE::CpuPanelEE( wxWindow* parent )
 	*this += m_button_RestoreDefaults | StdButton();
 
 	Bind(wxEVT_BUTTON, &CpuPanelEE::OnRestoreDefaults, this, wxID_DEFAULT);
-	Bind(wxEVT_RADIOBUTTON, &CpuPanelEE::EECache_Event, this);
 }
 
 Panels::CpuPanelVU::CpuPanelVU( wxWindow* parent )
@@ -251,9 +250,8 @@ void Panels::CpuPanelEE::ApplyConfigToGui( AppConfig& configToApply, int flags )
 	m_panel_RecEE->Enable(!configToApply.EnablePresets);
 	m_panel_RecIOP->Enable(!configToApply.EnablePresets);
 
-	//EECache option is exclusive to the EE Interpreter.
 	m_check_EECacheEnable->SetValue(recOps.EnableEECache);
-	m_check_EECacheEnable->Enable(!configToApply.EnablePresets && m_panel_RecEE->GetSelection() == 0);
+	m_check_EECacheEnable->Enable(!configToApply.EnablePresets);
 	m_button_RestoreDefaults->Enable(!configToApply.EnablePresets);
 
 	if( flags & AppConfig::APPLY_FLAG_MANUALLY_PROPAGATE )
@@ -416,9 +414,3 @@ void Panels::AdvancedOptionsVU::ApplyConfigToGui( AppConfig& configToApply, int
 
 	this->Enable(!configToApply.EnablePresets);
 }
-
-void Panels::CpuPanelEE::EECache_Event(wxCommandEvent& event)
-{
-	m_check_EECacheEnable->Enable(m_panel_RecEE->GetSelection() == 0);
-	event.Skip();
-}
@@ -251,6 +251,9 @@ Panels::LogOptionsPanel::LogOptionsPanel(wxWindow* parent )
 		_("Trace logs are all written to emulog.txt.  Toggle trace logging at any time using F10.") );
 	m_masterEnabler->SetToolTip( _("Warning: Trace logging is typically very slow, and is a leading cause of 'What happened to my FPS?' problems. :)") );
 
+	m_binaryTrace = new pxCheckBox( this, _("Binary trace"),
+		_("Records the logs to emuLog.trace without formatting them; much faster.  Decode the file with tracedump.") );
+
 	wxFlexGridSizer& topSizer = *new wxFlexGridSizer( 2 );
 
 	topSizer.AddGrowableCol(0);
@@ -260,6 +263,7 @@ Panels::LogOptionsPanel::LogOptionsPanel(wxWindow* parent )
 	topSizer	+= m_iopSection		| StdExpand();
 
 	*this		+= m_masterEnabler				| StdExpand();
+	*this		+= m_binaryTrace				| StdExpand();
 	*this		+= new wxStaticLine( this )		| StdExpand().Border(wxLEFT | wxRIGHT, 20);
 	*this		+= 5;
 	*this		+= topSizer						| StdExpand();
@@ -281,6 +285,7 @@ void Panels::LogOptionsPanel::AppStatusEvent_OnSettingsApplied()
 	TraceLogFilters& conf( g_Conf->EmuOptions.Trace );
 
 	m_masterEnabler->SetValue( conf.Enabled );
+	m_binaryTrace->SetValue( conf.Binary );
 
 	m_eeSection->OnSettingsChanged();
 	m_iopSection->OnSettingsChanged();
@@ -297,6 +302,7 @@ void Panels::LogOptionsPanel::OnUpdateEnableAll()
 {
 	bool enabled( m_masterEnabler->GetValue() );
 
+	m_binaryTrace->Enable( enabled );
 	m_eeSection->Enable( enabled );
 	m_iopSection->Enable( enabled );
 	m_miscSection->GetStaticBox()->Enable( enabled );
@@ -311,6 +317,7 @@ void Panels::LogOptionsPanel::OnCheckBoxClicked(wxCommandEvent &evt)
 void Panels::LogOptionsPanel::Apply()
 {
 	g_Conf->EmuOptions.Trace.Enabled	= m_masterEnabler->GetValue();
+	g_Conf->EmuOptions.Trace.Binary		= m_binaryTrace->GetValue();
 
 	m_eeSection->Apply();
 	m_iopSection->Apply();
@@ -176,12 +176,18 @@ Panels::SpeedHacksPanel::SpeedHacksPanel( wxWindow* parent )
 	m_check_vuThread = new pxCheckBox( vuHacksPanel, _("MTVU (Multi-Threaded microVU1)"),
 		_("Good Speedup and High Compatibility; may cause hanging... [Recommended if 3+ cores]") );
 
+	m_check_vu0Thread = new pxCheckBox( vuHacksPanel, _("MTVU0 (Multi-Threaded microVU0)"),
+		_("Moderate speedup for games that run VU0 micro programs; may cause hanging... [Not Recommended]") );
+
 	m_check_vuFlagHack->SetToolTip( pxEt( L"Updates Status Flags only on blocks which will read them, instead of all the time. This is safe most of the time, and Super VU does something similar by default."
 	) );
 
 	m_check_vuThread->SetToolTip( pxEt( L"Runs VU1 on its own thread (microVU1-only). Generally a speedup on CPUs with 3 or more cores. This is safe for most games, but a few games are incompatible and may hang. In the case of GS limited games, it may be a slowdown (especially on dual core CPUs)."
 	) );
 
+	m_check_vu0Thread->SetToolTip( pxEt( L"Runs VU0 micro programs (VCALLMS/MSCAL) on their own thread (microVU0-only). The EE waits for the program to finish whenever it touches VU0 again, so only games that do other work while VU0 runs will see a speedup. Games which hand data to a running VU0 program around M-bit syncs are incompatible and may hang."
+	) );
+
 	// ------------------------------------------------------------------------
 	// All other hacks Section:
 
@@ -225,6 +231,7 @@ Panels::SpeedHacksPanel::SpeedHacksPanel( wxWindow* parent )
 
 	*vuHacksPanel += m_check_vuFlagHack | StdExpand();
 	*vuHacksPanel += m_check_vuThread | StdExpand();
+	*vuHacksPanel += m_check_vu0Thread | StdExpand();
 	//*vuHacksPanel	+= 57; // Aligns left and right boxes in default language and font size
 
 	*miscHacksPanel	+= m_check_intc | StdExpand();
@@ -284,6 +291,7 @@ void Panels::SpeedHacksPanel::EnableStuff( AppConfig* configToUse )
 
 	// Grayout MTVU on safest preset
 	m_check_vuThread->Enable(hacksEnabled && (!hasPreset || configToUse->PresetIndex != 0));
+	m_check_vu0Thread->Enable(HacksEnabledAndNoPreset);
 
 	// Layout necessary to ensure changed slider text gets re-aligned properly
 	// and to properly gray/ungray pxStaticText stuff (I suspect it causes a
@@ -315,6 +323,7 @@ void Panels::SpeedHacksPanel::ApplyConfigToGui( AppConfig& configToApply, int fl
 	m_check_waitloop->SetValue(opts.WaitLoop);
 	m_check_fastCDVD->SetValue(opts.fastCDVD);
 	m_check_vuThread->SetValue(opts.vuThread);
+	m_check_vu0Thread->SetValue(opts.vu0Thread);
 		
 
 	// Then, lock(gray out)/unlock the widgets as necessary.
@@ -339,6 +348,7 @@ void Panels::SpeedHacksPanel::Apply()
 	opts.IntcStat			= m_check_intc->GetValue();
 	opts.vuFlagHack			= m_check_vuFlagHack->GetValue();
 	opts.vuThread			= m_check_vuThread->GetValue();
+	opts.vu0Thread			= m_check_vu0Thread->GetValue();
 
 	// If the user has a command line override specified, we need to disable it
 	// so that their changes take effect
@@ -18,6 +18,7 @@
 #include "AppCoreThread.h"
 #include "RecentIsoList.h"
 #include "IsoDropTarget.h"
+#include "CDVD/HttpFileReader.h"
 #include "Utilities/IniInterface.h"
 
 extern wxString GetMsg_IsoImageChanged();
@@ -194,7 +195,7 @@ void RecentIsoManager::InsertIntoMenu( int id )
 	filename.Replace("&", "&&", true);
 
 	curitem.ItemPtr = m_Menu->AppendRadioItem( wxid, filename, curitem.Filename );
-	curitem.ItemPtr->Enable(wxFileExists(curitem.Filename) && !g_Conf->AskOnBoot);
+	curitem.ItemPtr->Enable((wxFileExists(curitem.Filename) || HttpFileReader::CanHandle(curitem.Filename)) && !g_Conf->AskOnBoot);
 }
 
 void RecentIsoManager::EnableItems(bool display)
@@ -202,7 +203,7 @@ void RecentIsoManager::EnableItems(bool display)
 	for (const auto& list : m_Items)
 	{
 		// Files which don't exist still need to be grayed out.
-		list.ItemPtr->Enable(display && wxFileExists(list.Filename));
+		list.ItemPtr->Enable(display && (wxFileExists(list.Filename) || HttpFileReader::CanHandle(list.Filename)));
 	}
 }
 
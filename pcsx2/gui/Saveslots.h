@@ -121,6 +121,7 @@ extern Saveslot saveslot_cache[10];
 extern void States_DefrostCurrentSlotBackup();
 extern void States_DefrostCurrentSlot();
 extern void States_FreezeCurrentSlot();
+extern void States_Rewind();
 extern void States_CycleSlotForward();
 extern void States_CycleSlotBackward();
 extern void States_SetCurrentSlot(int slot);
@@ -15,10 +15,13 @@
 
 #include "PrecompiledHeader.h"
 #include "MemoryTypes.h"
+#include "Memory.h"
 #include "App.h"
 
 #include "System/SysThreads.h"
 #include "SaveState.h"
+#include "Rewind.h"
+#include "RunAhead.h"
 #include "VUmicro.h"
 
 #include "ZipTools/ThreadedZipTools.h"
@@ -27,7 +30,10 @@
 #include "ConsoleLogger.h"
 
 #include <wx/wfstream.h>
+#include <wx/mstream.h>
+#include <map>
 #include <memory>
+#include <zlib.h>
 
 #include "Patch.h"
 
@@ -37,6 +43,7 @@
 static const wxChar* EntryFilename_StateVersion			= L"PCSX2 Savestate Version.id";
 static const wxChar* EntryFilename_Screenshot			= L"Screenshot.jpg";
 static const wxChar* EntryFilename_InternalStructures	= L"PCSX2 Internal Structures.dat";
+static const wxChar* EntryFilename_BaseState			= L"PCSX2 Base State.id";
 
 
 // --------------------------------------------------------------------------------------
@@ -54,6 +61,11 @@ public:
 	virtual void FreezeIn( pxInputStream& reader ) const=0;
 	virtual void FreezeOut( SaveStateBase& writer ) const=0;
 	virtual bool IsRequired() const=0;
+
+	// Entries backed by memory that mmap_BeginSnapshot can capture return it here; they are
+	// saved with ReserveOut, and filled in by the snapshot once emulation has resumed.
+	virtual u8* GetCopyOnWriteSource() const { return NULL; }
+	virtual void ReserveOut( SaveStateBase& writer ) const { FreezeOut( writer ); }
 };
 
 class MemorySavestateEntry : public BaseSavestateEntry
@@ -65,6 +77,7 @@ protected:
 public:
 	virtual void FreezeIn( pxInputStream& reader ) const;
 	virtual void FreezeOut( SaveStateBase& writer ) const;
+	virtual void ReserveOut( SaveStateBase& writer ) const;
 	virtual bool IsRequired() const { return true; }
 
 protected:
@@ -115,6 +128,12 @@ void MemorySavestateEntry::FreezeOut( SaveStateBase& writer ) const
 	writer.FreezeMem( GetDataPtr(), GetDataSize() );
 }
 
+void MemorySavestateEntry::ReserveOut( SaveStateBase& writer ) const
+{
+	writer.PrepBlock( GetDataSize() );
+	writer.CommitBlock( GetDataSize() );
+}
+
 wxString PluginSavestateEntry::GetFilename() const
 {
 	return pxsFmt( "Plugin %s.dat", tbl_PluginInfo[m_pid].shortname );
@@ -129,6 +148,12 @@ void PluginSavestateEntry::FreezeOut( SaveStateBase& writer ) const
 {
 	if (uint size = GetCorePlugins().GetFreezeSize( GetPluginId() ))
 	{
+		if (writer.IsSizing())
+		{
+			writer.CommitBlock( size );
+			return;
+		}
+
 		writer.PrepBlock( size );
 		GetCorePlugins().FreezeOut( GetPluginId(), writer.GetBlockPtr() );
 		writer.CommitBlock( size );
@@ -152,6 +177,7 @@ public:
 	wxString GetFilename() const		{ return L"eeMemory.bin"; }
 	u8* GetDataPtr() const				{ return eeMem->Main; }
 	uint GetDataSize() const			{ return sizeof(eeMem->Main); }
+	u8* GetCopyOnWriteSource() const	{ return eeMem->Main; }
 
 	virtual void FreezeIn( pxInputStream& reader ) const
 	{
@@ -168,6 +194,7 @@ public:
 	wxString GetFilename() const		{ return L"iopMemory.bin"; }
 	u8* GetDataPtr() const				{ return iopMem->Main; }
 	uint GetDataSize() const			{ return sizeof(iopMem->Main); }
+	u8* GetCopyOnWriteSource() const	{ return iopMem->Main; }
 };
 
 class SavestateEntry_HwRegs : public MemorySavestateEntry
@@ -298,6 +325,230 @@ static void CheckVersion( pxInputStream& thr )
 			.SetUserMsg(_("Cannot load this savestate. The state is an unsupported version."));
 };
 
+// Entry names are the state component name, optionally followed by DiffEntrySuffix and
+// then ChunkedEntrySuffix.  Returns the (lowercased) component name.
+static wxString GetComponentName( const wxString& entryName, bool* chunked=NULL, bool* diff=NULL )
+{
+	wxString name( entryName.Lower() );
+
+	const bool isChunked = name.EndsWith( ChunkedEntrySuffix, &name );
+	const bool isDiff = name.EndsWith( DiffEntrySuffix, &name );
+
+	if (chunked) *chunked = isChunked;
+	if (diff) *diff = isDiff;
+	return name;
+}
+
+static bool IsEntryNamed( const wxZipEntry& entry, const wxString& name )
+{
+	return GetComponentName( entry.GetName() ) == name.Lower();
+}
+
+static bool IsChunkedEntry( const wxZipEntry& entry )
+{
+	bool chunked;
+	GetComponentName( entry.GetName(), &chunked );
+	return chunked;
+}
+
+static bool IsDiffEntry( const wxZipEntry& entry )
+{
+	bool diff;
+	GetComponentName( entry.GetName(), NULL, &diff );
+	return diff;
+}
+
+// Reads the whole of the currently open zip entry into dest, unpacking chunked entries.
+static void ReadEntry( pxInputStream& reader, const wxZipEntry& entry, ArchiveDataBuffer& dest )
+{
+	const uint size = entry.GetSize();
+
+	if (!IsChunkedEntry(entry))
+	{
+		dest.ExactAlloc( size );
+		reader.Read( dest.GetPtr(), size );
+		return;
+	}
+
+	ScopedAlloc<u8> packed( size );
+	reader.Read( packed.GetPtr(), size );
+	DecompressChunkedEntry( reader.GetStreamName(), packed.GetPtr(), size, dest );
+}
+
+// --------------------------------------------------------------------------------------
+//  Differential savestates
+// --------------------------------------------------------------------------------------
+// With DiffSavestates enabled, the first state saved for a game is also written in full as
+// that game's base state (see SaveStateBase::GetBaseFilename), and every saved state only
+// stores the pages that differ from it.  The base is kept in memory, so that saving and
+// loading don't have to re-read it every time; it is reloaded when the file is replaced.
+//
+// All of this runs on the SysExecutor thread.
+//
+struct BaseStateEntry
+{
+	std::unique_ptr<ArchiveDataBuffer>	data;
+	u32									crc;
+};
+
+static wxString s_baseFilename;
+static time_t s_baseModified = 0;
+static bool s_baseWrittenHere = false;		// saved by us; its compress thread may still be running
+static std::map<wxString, BaseStateEntry> s_baseEntries;
+
+static u32 GetEntryCrc( const ArchiveDataBuffer& data )
+{
+	return data.GetSizeInBytes() ? crc32( 0, data.GetPtr(), data.GetSizeInBytes() ) : 0;
+}
+
+static bool HasBaseState( const wxString& basefile )
+{
+	return (s_baseWrittenHere && s_baseFilename == basefile) || wxFileExists( basefile );
+}
+
+// Makes the given (about to be saved) state the cached base.
+static void SetBaseState( const wxString& basefile, const ArchiveEntryList& list )
+{
+	s_baseEntries.clear();
+
+	for (uint i=0; i<list.GetLength(); ++i)
+	{
+		const uint size = list[i].GetDataSize();
+		if (!size) continue;
+
+		BaseStateEntry& base = s_baseEntries[list[i].GetFilename().Lower()];
+		base.data = std::unique_ptr<ArchiveDataBuffer>(new ArchiveDataBuffer( L"BaseStateEntry" ));
+		base.data->ExactAlloc( size );
+		memcpy( base.data->GetPtr(), list.GetPtr( list[i].GetDataIndex() ), size );
+		base.crc = GetEntryCrc( *base.data );
+	}
+
+	s_baseFilename		= basefile;
+	s_baseModified		= 0;
+	s_baseWrittenHere	= true;
+}
+
+static void LoadBaseState( const wxString& basefile )
+{
+	if (s_baseFilename == basefile && (s_baseWrittenHere || s_baseModified == wxFileModificationTime( basefile )))
+		return;
+
+	s_baseFilename.clear();
+	s_baseEntries.clear();
+
+	std::unique_ptr<wxFFileInputStream> woot(new wxFFileInputStream(basefile));
+	if (!woot->IsOk())
+		throw Exception::SaveStateLoadError( basefile )
+			.SetDiagMsg( L"Cannot open base savestate for reading." )
+			.SetUserMsg(_("This savestate cannot be loaded because the base savestate it was saved against could not be found."));
+
+	std::unique_ptr<pxInputStream> reader(new pxInputStream(basefile, new wxZipInputStream(woot.get())));
+	woot.release();
+
+	wxZipInputStream* gzreader = (wxZipInputStream*)reader->GetWxStreamBase();
+
+	while(true)
+	{
+		std::unique_ptr<wxZipEntry> entry(gzreader->GetNextEntry());
+		if (!entry) break;
+
+		if (entry->GetName().CmpNoCase(EntryFilename_StateVersion) == 0)
+		{
+			CheckVersion(*reader);
+			continue;
+		}
+
+		if (entry->GetName().CmpNoCase(EntryFilename_Screenshot) == 0) continue;
+
+		if (IsDiffEntry(*entry) || entry->GetName().CmpNoCase(EntryFilename_BaseState) == 0)
+			throw Exception::SaveStateLoadError( basefile )
+				.SetDiagMsg( L"Base savestate is itself a differential savestate." );
+
+		BaseStateEntry& base = s_baseEntries[GetComponentName(entry->GetName())];
+		base.data = std::unique_ptr<ArchiveDataBuffer>(new ArchiveDataBuffer( L"BaseStateEntry" ));
+		ReadEntry( *reader, *entry, *base.data );
+		base.crc = GetEntryCrc( *base.data );
+	}
+
+	s_baseFilename		= basefile;
+	s_baseModified		= wxFileModificationTime( basefile );
+	s_baseWrittenHere	= false;
+}
+
+// Base states are looked up next to the state that refers to them, then in the savestates folder.
+static wxString ResolveBaseState( const wxString& statefile, const wxString& baseName )
+{
+	wxFileName local( statefile );
+	local.SetFullName( baseName );
+	if (local.FileExists()) return local.GetFullPath();
+
+	return (g_Conf->Folders.Savestates + baseName).GetFullPath();
+}
+
+// Builds a copy of list where every entry that has a same-sized counterpart in the cached
+// base state is stored as its differential form (when that is any smaller).
+static ArchiveEntryList* MakeDiffList( const ArchiveEntryList& list )
+{
+	std::unique_ptr<ArchiveEntryList> dlist(new ArchiveEntryList(new VmStateBuffer(L"Differential Savestate")));
+	VmStateBuffer& buffer = *dlist->GetBuffer();
+
+	std::vector<u8> diff;
+	uint pos = 0, fullsize = 0;
+
+	for (uint i=0; i<list.GetLength(); ++i)
+	{
+		const ArchiveEntry& src = list[i];
+		if (!src.GetDataSize()) continue;
+
+		wxString name( src.GetFilename() );
+		const u8* data = list.GetPtr( src.GetDataIndex() );
+		uint size = src.GetDataSize();
+
+		auto base = s_baseEntries.find( name.Lower() );
+		if (base != s_baseEntries.end() && base->second.data->GetSizeInBytes() == size
+			&& EncodeDiffEntry( data, base->second.data->GetPtr(), size, base->second.crc, diff ))
+		{
+			name += DiffEntrySuffix;
+			data = diff.data();
+			size = diff.size();
+		}
+
+		buffer.MakeRoomFor( pos + size );
+		memcpy( buffer.GetPtr( pos ), data, size );
+		dlist->Add( ArchiveEntry( name ).SetDataIndex( pos ).SetDataSize( size ) );
+
+		pos += size;
+		fullsize += src.GetDataSize();
+	}
+
+	DevCon.WriteLn( "(Savestate) Differential state is %u KB (%u KB in full).", pos / 1024, fullsize / 1024 );
+	return dlist.release();
+}
+
+// Reads an entry of a state being loaded, rebuilding differential entries from basefile
+// (which must have been loaded with LoadBaseState; empty if the state names no base).
+static void ReadStateEntry( pxInputStream& reader, const wxZipEntry& entry, const wxString& basefile, ArchiveDataBuffer& dest )
+{
+	if (!IsDiffEntry(entry))
+	{
+		ReadEntry( reader, entry, dest );
+		return;
+	}
+
+	auto base = s_baseEntries.find( GetComponentName(entry.GetName()) );
+	if (basefile.IsEmpty() || s_baseFilename != basefile || base == s_baseEntries.end())
+		throw Exception::SaveStateLoadError( reader.GetStreamName() )
+			.SetDiagMsg( pxsFmt( L"Differential entry '%s' has no counterpart in the base savestate.", WX_STR(entry.GetName()) ) )
+			.SetUserMsg(_("This savestate cannot be loaded because the base savestate it was saved against is missing or has been replaced."));
+
+	ArchiveDataBuffer diff( L"StateBuffer_DiffEntry" );
+	ReadEntry( reader, entry, diff );
+
+	const ArchiveDataBuffer& basedata = *base->second.data;
+	ApplyDiffEntry( reader.GetStreamName(), diff.GetPtr(), diff.GetSizeInBytes(),
+		basedata.GetPtr(), basedata.GetSizeInBytes(), base->second.crc, dest );
+}
+
 // --------------------------------------------------------------------------------------
 //  SysExecEvent_DownloadState
 // --------------------------------------------------------------------------------------
@@ -333,6 +584,19 @@ protected:
 				.SetDiagMsg(L"SysExecEvent_DownloadState: Cannot freeze/download an invalid VM state!")
 				.SetUserMsg(_("There is no active virtual machine state to download or save." ));
 
+		// Measure everything first, so that the buffer is allocated once instead of being
+		// reallocated (and copied) as each entry is appended.
+		{
+			memSizingState sizer;
+			sizer.FreezeBios();
+			sizer.FreezeInternals();
+
+			for (uint i=0; i<ArraySize(SavestateEntries); ++i)
+				SavestateEntries[i]->FreezeOut( sizer );
+
+			m_dest_list->GetBuffer()->MakeRoomFor( sizer.GetCurrentPos() );
+		}
+
 		memSavingState saveme( m_dest_list->GetBuffer() );
 		ArchiveEntry internals( EntryFilename_InternalStructures );
 		internals.SetDataIndex( saveme.GetCurrentPos() );
@@ -343,16 +607,36 @@ protected:
 		internals.SetDataSize( saveme.GetCurrentPos() - internals.GetDataIndex() );
 		m_dest_list->Add( internals );
 
+		const bool copyOnWrite = g_Conf->EmuOptions.CopyOnWriteSaves;
+		uint eeIndex = 0, iopIndex = 0;
+
 		for (uint i=0; i<ArraySize(SavestateEntries); ++i)
 		{
 			uint startpos = saveme.GetCurrentPos();
-			SavestateEntries[i]->FreezeOut( saveme );
+			u8* cowsrc = copyOnWrite ? SavestateEntries[i]->GetCopyOnWriteSource() : NULL;
+
+			if (cowsrc)
+			{
+				SavestateEntries[i]->ReserveOut( saveme );
+				if (cowsrc == eeMem->Main) eeIndex = startpos; else iopIndex = startpos;
+			}
+			else
+				SavestateEntries[i]->FreezeOut( saveme );
+
 			m_dest_list->Add( ArchiveEntry( SavestateEntries[i]->GetFilename() )
 				.SetDataIndex( startpos )
 				.SetDataSize( saveme.GetCurrentPos() - startpos )
 			);
 		}
 
+		// The buffer is at its final size (and address) now, so the snapshot can point into it.
+		// (Offset 0 is never a memory entry; the internal structures come first.)
+		if (copyOnWrite)
+		{
+			VmStateBuffer& buffer = *m_dest_list->GetBuffer();
+			mmap_BeginSnapshot( eeIndex ? buffer.GetPtr(eeIndex) : NULL, iopIndex ? buffer.GetPtr(iopIndex) : NULL );
+		}
+
 		UI_EnableStateActions();
 		paused_core.AllowResume();
 	}
@@ -391,6 +675,67 @@ protected:
 	}
 };
 
+// Starts a compress thread writing list to filename (which takes ownership of list).
+// baseName, if given, is recorded as the base state of a differential list.
+static void WriteStateArchive( std::unique_ptr<ArchiveEntryList>& elist, const wxString& filename, const wxString& baseName )
+{
+	wxString tempfile( filename + L".tmp" );
+
+	wxFFileOutputStream* woot = new wxFFileOutputStream(tempfile);
+	if (!woot->IsOk())
+		throw Exception::CannotCreateStream(tempfile);
+
+	// Scheduler hint (yield) -- creating and saving the file is low priority compared to
+	// the emulator/vm thread.  Sleeping the executor thread briefly before doing file
+	// transactions should help reduce overhead. --air
+
+	pxYield(4);
+
+	// Write the version and screenshot:
+	std::unique_ptr<pxOutputStream> out(new pxOutputStream(tempfile, new wxZipOutputStream(woot)));
+	wxZipOutputStream* gzfp = (wxZipOutputStream*)out->GetWxStreamBase();
+
+	{
+		wxZipEntry* vent = new wxZipEntry(EntryFilename_StateVersion);
+		vent->SetMethod( wxZIP_METHOD_STORE );
+		gzfp->PutNextEntry( vent );
+		out->Write(g_SaveVersion);
+		gzfp->CloseEntry();
+	}
+
+	if (!baseName.IsEmpty())
+	{
+		const wxCharBuffer utf8( baseName.ToUTF8() );
+
+		wxZipEntry* vent = new wxZipEntry(EntryFilename_BaseState);
+		vent->SetMethod( wxZIP_METHOD_STORE );
+		gzfp->PutNextEntry( vent );
+		out->Write( utf8.data(), strlen( utf8.data() ) );
+		gzfp->CloseEntry();
+	}
+
+	std::unique_ptr<wxImage> m_screenshot;
+
+	if (m_screenshot)
+	{
+		wxZipEntry* vent = new wxZipEntry(EntryFilename_Screenshot);
+		vent->SetMethod( wxZIP_METHOD_STORE );
+		gzfp->PutNextEntry( vent );
+		m_screenshot->SaveFile( *gzfp, wxBITMAP_TYPE_JPEG );
+		gzfp->CloseEntry();
+	}
+
+	(*new VmStateCompressThread())
+		.SetSource(elist.get())
+		.SetOutStream(out.get())
+		.SetFinishedPath(filename)
+		.Start();
+
+	// No errors?  Release cleanup handlers:
+	elist.release();
+	out.release();
+}
+
 // --------------------------------------------------------------------------------------
 //  SysExecEvent_ZipToDisk
 // --------------------------------------------------------------------------------------
@@ -428,50 +773,42 @@ protected:
 		// Provisionals for scoped cleanup, in case of exception:
 		std::unique_ptr<ArchiveEntryList> elist(m_src_list);
 
-		wxString tempfile( m_filename + L".tmp" );
-
-		wxFFileOutputStream* woot = new wxFFileOutputStream(tempfile);
-		if (!woot->IsOk())
-			throw Exception::CannotCreateStream(tempfile);
-
-		// Scheduler hint (yield) -- creating and saving the file is low priority compared to
-		// the emulator/vm thread.  Sleeping the executor thread briefly before doing file
-		// transactions should help reduce overhead. --air
-
-		pxYield(4);
+		// A copy-on-write download may still be filling in the list's buffer.
+		mmap_WaitSnapshot();
 
-		// Write the version and screenshot:
-		std::unique_ptr<pxOutputStream> out(new pxOutputStream(tempfile, new wxZipOutputStream(woot)));
-		wxZipOutputStream* gzfp = (wxZipOutputStream*)out->GetWxStreamBase();
+		const wxString basefile( SaveStateBase::GetBaseFilename() );
 
+		if (!g_Conf->EmuOptions.DiffSavestates || wxFileName( basefile ).SameAs( m_filename ))
 		{
-			wxZipEntry* vent = new wxZipEntry(EntryFilename_StateVersion);
-			vent->SetMethod( wxZIP_METHOD_STORE );
-			gzfp->PutNextEntry( vent );
-			out->Write(g_SaveVersion);
-			gzfp->CloseEntry();
+			WriteStateArchive( elist, m_filename, wxEmptyString );
+			return;
 		}
 
-		std::unique_ptr<wxImage> m_screenshot;
+		std::unique_ptr<ArchiveEntryList> dlist;
 
-		if (m_screenshot)
+		if (HasBaseState( basefile ))
 		{
-			wxZipEntry* vent = new wxZipEntry(EntryFilename_Screenshot);
-			vent->SetMethod( wxZIP_METHOD_STORE );
-			gzfp->PutNextEntry( vent );
-			m_screenshot->SaveFile( *gzfp, wxBITMAP_TYPE_JPEG );
-			gzfp->CloseEntry();
+			// A broken base must not keep the state from being saved at all.
+			try {
+				LoadBaseState( basefile );
+			}
+			catch (BaseException& ex)
+			{
+				Console.Warning( L"(Savestate) Base state is unusable, saving in full: %s", WX_STR(ex.FormatDiagnosticMessage()) );
+				WriteStateArchive( elist, m_filename, wxEmptyString );
+				return;
+			}
+			dlist.reset( MakeDiffList( *elist ) );
+		}
+		else
+		{
+			Console.WriteLn( Color_StrongGreen, L"(Savestate) Creating base state: %s", WX_STR(basefile) );
+			SetBaseState( basefile, *elist );
+			dlist.reset( MakeDiffList( *elist ) );
+			WriteStateArchive( elist, basefile, wxEmptyString );
 		}
 
-		(*new VmStateCompressThread())
-			.SetSource(elist.get())
-			.SetOutStream(out.get())
-			.SetFinishedPath(m_filename)
-			.Start();
-
-		// No errors?  Release cleanup handlers:
-		elist.release();
-		out.release();
+		WriteStateArchive( dlist, m_filename, wxFileName( basefile ).GetFullName() );
 	}
 
 	void CleanupEvent()
@@ -539,6 +876,7 @@ protected:
 
 		std::unique_ptr<wxZipEntry> foundInternal;
 		std::unique_ptr<wxZipEntry> foundEntry[ArraySize(SavestateEntries)];
+		wxString basefile;
 
 		while(true)
 		{
@@ -555,7 +893,18 @@ protected:
 				continue;
 			}
 
-			if (entry->GetName().CmpNoCase(EntryFilename_InternalStructures) == 0)
+			if (entry->GetName().CmpNoCase(EntryFilename_BaseState) == 0)
+			{
+				ScopedAlloc<char> name( entry->GetSize() + 1 );
+				reader->Read( name.GetPtr(), entry->GetSize() );
+				name[entry->GetSize()] = 0;
+
+				basefile = ResolveBaseState( m_filename, fromUTF8( name.GetPtr() ) );
+				DevCon.WriteLn( Color_Green, L" ... differential state, base is '%s'", WX_STR(basefile) );
+				continue;
+			}
+
+			if (IsEntryNamed(*entry, EntryFilename_InternalStructures))
 			{
 				DevCon.WriteLn( Color_Green, L" ... found '%s'", EntryFilename_InternalStructures);
 				foundInternal = std::move(entry);
@@ -571,7 +920,7 @@ protected:
 
 			for (uint i=0; i<ArraySize(SavestateEntries); ++i)
 			{
-				if (entry->GetName().CmpNoCase(SavestateEntries[i]->GetFilename()) == 0)
+				if (IsEntryNamed(*entry, SavestateEntries[i]->GetFilename()))
 				{
 					DevCon.WriteLn( Color_Green, L" ... found '%s'", WX_STR(SavestateEntries[i]->GetFilename()) );
 					foundEntry[i] = std::move(entry);
@@ -606,6 +955,10 @@ protected:
 				.SetDiagMsg( L"Savestate cannot be loaded: some required components were not found or are incomplete." )
 				.SetUserMsg(_("This savestate cannot be loaded due to missing critical components.  See the log file for details."));
 
+		// Any problem with the base state should surface before the VM is touched.
+		if (!basefile.IsEmpty())
+			LoadBaseState( basefile );
+
 		// We use direct Suspend/Resume control here, since it's desirable that emulation
 		// *ALWAYS* start execution after the new savestate is loaded.
 
@@ -613,6 +966,9 @@ protected:
 
 		GetCoreThread().Pause();
 		SysClearExecutionCache();
+		Rewind::Clear();
+		RunAhead::Clear();
+		mmap_EndSnapshot();
 
 		for (uint i=0; i<ArraySize(SavestateEntries); ++i)
 		{
@@ -621,21 +977,65 @@ protected:
 			Threading::pxTestCancel();
 
 			gzreader->OpenEntry( *foundEntry[i] );
-			SavestateEntries[i]->FreezeIn( *reader );
+
+			if (IsChunkedEntry(*foundEntry[i]) || IsDiffEntry(*foundEntry[i]))
+			{
+				ArchiveDataBuffer unpacked( L"StateBuffer_ChunkedEntry" );
+				ReadStateEntry( *reader, *foundEntry[i], basefile, unpacked );
+
+				pxInputStream memreader( m_filename, new wxMemoryInputStream(unpacked.GetPtr(), unpacked.GetSizeInBytes()) );
+				SavestateEntries[i]->FreezeIn( memreader );
+			}
+			else
+				SavestateEntries[i]->FreezeIn( *reader );
 		}
 
 		// Load all the internal data
 
 		gzreader->OpenEntry( *foundInternal );
 
-		VmStateBuffer buffer( foundInternal->GetSize(), L"StateBuffer_UnzipFromDisk" );		// start with an 8 meg buffer to avoid frequent reallocation.
-		reader->Read( buffer.GetPtr(), foundInternal->GetSize() );
+		VmStateBuffer buffer( L"StateBuffer_UnzipFromDisk" );
+		ReadStateEntry( *reader, *foundInternal, basefile, buffer );
 
 		memLoadingState( buffer ).FreezeBios().FreezeInternals();
 		GetCoreThread().Resume();	// force resume regardless of emulation state earlier.
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  SysExecEvent_Rewind
+// --------------------------------------------------------------------------------------
+// Loads the previous in-memory rewind snapshot.  Unlike a savestate load, this resumes
+// only if emulation was running when the event was posted.
+//
+class SysExecEvent_Rewind : public SysExecEvent
+{
+public:
+	wxString GetEventName() const { return L"VM_Rewind"; }
+
+	virtual ~SysExecEvent_Rewind() = default;
+	SysExecEvent_Rewind* Clone() const { return new SysExecEvent_Rewind( *this ); }
+
+protected:
+	void InvokeEvent()
+	{
+		ScopedCoreThreadPause paused_core;
+
+		if( !SysHasValidState() ) return;
+
+		SysClearExecutionCache();
+
+		RunAhead::Clear();
+
+		if( Rewind::LoadPrevious() )
+			OSDlog( Color_StrongBlue, true, "(Rewind) Rewound." );
+		else
+			OSDlog( Color_StrongRed, true, "(Rewind) Nothing to rewind to." );
+
+		paused_core.AllowResume();
+	}
+};
+
 // =====================================================================================================
 //  StateCopy Public Interface
 // =====================================================================================================
@@ -658,6 +1058,11 @@ void StateCopy_LoadFromFile( const wxString& file )
 	GetSysExecutorThread().PostEvent(new SysExecEvent_UnzipFromDisk( file ));
 }
 
+void StateCopy_Rewind()
+{
+	GetSysExecutorThread().PostEvent(new SysExecEvent_Rewind());
+}
+
 // Saves recovery state info to the given saveslot, or saves the active emulation state
 // (if one exists) and no recovery data was found.  This is needed because when a recovery
 // state is made, the emulation state is usually reset so the only persisting state is
@@ -53,6 +53,7 @@ u32 BiosVersion;
 u32 BiosChecksum;
 wxString BiosDescription;
 const BiosDebugInformation* CurrentBiosInformation;
+u32 BiosRomBytesMapped;
 
 const BiosDebugInformation biosVersions[] = {
 	// USA     v02.00(14/06/2004)  Console
@@ -180,6 +181,22 @@ void ChecksumIt( u32& result, const u8 (&srcdata)[_size] )
 		result ^= ((u32*)srcdata)[i];
 }
 
+// With ShareRomMemory, maps the whole pages of a rom file over its region of PS2 memory instead
+// of reading them, so that every instance running the same bios shares the same physical
+// pages.  The mapping is copy-on-write: anything writing to the rom regions (IRX injection,
+// stray guest stores) just gets a private copy of the page.  Returns the number of bytes
+// mapped; the caller reads the rest of the file as usual.
+static s64 MapRomFile( const wxString& filename, u8* dest, s64 size )
+{
+	if (!EmuConfig.ShareRomMemory) return 0;
+
+	const size_t bytes = (size_t)size & ~(size_t)(__pagesize - 1);
+	if (!bytes || !HostSys::MmapFilePrivatePtr( dest, bytes, filename )) return 0;
+
+	BiosRomBytesMapped += bytes;
+	return bytes;
+}
+
 // Attempts to load a BIOS rom sub-component, by trying multiple combinations of base
 // filename and extension.  The bios specified in the user's configuration is used as
 // the base.
@@ -210,8 +227,12 @@ static void LoadExtraRom( const wxChar* ext, u8 (&dest)[_size] )
 			}
 		}
 
+		const s64 size = std::min<s64>( _size, filesize );
+		const s64 mapped = MapRomFile( Bios1, dest, size );
+
 		wxFile fp( Bios1 );
-		fp.Read( dest, std::min<s64>( _size, filesize ) );
+		fp.Seek( mapped );
+		fp.Read( dest + mapped, size - mapped );
 
 		// Checksum for ROM1, ROM2, EROM?  Rama says no, Gigaherz says yes.  I'm not sure either way.  --air
 		//ChecksumIt( BiosChecksum, dest );
@@ -279,10 +300,15 @@ void LoadBIOS()
 		}
 
 		BiosChecksum = 0;
+		BiosRomBytesMapped = 0;
+
+		const s64 size = std::min<s64>( Ps2MemSize::Rom, filesize );
+		const s64 mapped = MapRomFile( Bios, eeMem->ROM, size );
 
 		wxString biosZone;
 		wxFFile fp( Bios );
-		fp.Read( eeMem->ROM, std::min<s64>( Ps2MemSize::Rom, filesize ) );
+		fp.Seek( mapped );
+		fp.Read( eeMem->ROM + mapped, size - mapped );
 
 		ChecksumIt( BiosChecksum, eeMem->ROM );
 
@@ -299,6 +325,9 @@ void LoadBIOS()
 		LoadExtraRom( L"rom2", eeMem->ROM2 );
 		LoadExtraRom( L"erom", eeMem->EROM );
 
+		if (EmuConfig.ShareRomMemory)
+			Console.WriteLn( Color_Gray, "BIOS: %u KB of rom mapped from file (shared between instances)", BiosRomBytesMapped / 1024 );
+
 		if (g_Conf->CurrentIRX.Length() > 3)
 			LoadIrx(g_Conf->CurrentIRX, &eeMem->ROM[0x3C0000]);
 
@@ -39,6 +39,7 @@ extern u32 BiosVersion;		//  Used by CDVD
 extern u32 BiosChecksum;
 extern wxString BiosDescription;
 extern const BiosDebugInformation* CurrentBiosInformation;
+extern u32 BiosRomBytesMapped;	// rom bytes mapped from file rather than read (ShareRomMemory)
 
 extern void LoadBIOS();
 extern bool IsBIOS(const wxString& filename, wxString& description);
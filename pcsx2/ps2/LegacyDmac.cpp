@@ -120,6 +120,10 @@ __fi tDMA_TAG* SPRdmaGetAddr(u32 addr, bool write)
 			DevCon.Warning("MTVU: SPR Accessing VU1 Memory");
 			vu1Thread.WaitVU();
 		}
+		else if (addr < 0x11008000 && THREAD_VU0)
+		{
+			vu0Thread.WaitVU();
+		}
 		
 		//Access for VU Memory
 
@@ -145,6 +149,7 @@ __fi tDMA_TAG* SPRdmaGetAddr(u32 addr, bool write)
 		if((addr >= 0x11008000) && (addr < 0x1100c000))
 		{
 			//DevCon.Warning("VU1 Micro %x", addr);
+			if (write && THREAD_VU1) vu1Thread.DiscardMicroShadow();
 			return (tDMA_TAG*)(VU1.Micro + (addr & 0x3ff0));
 		}
 		
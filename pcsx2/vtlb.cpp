@@ -55,6 +55,9 @@ static vtlbHandler UnmappedVirtHandler0;
 static vtlbHandler UnmappedVirtHandler1;
 static vtlbHandler UnmappedPhyHandler0;
 static vtlbHandler UnmappedPhyHandler1;
+static vtlbHandler WatchHandler;
+
+bool vtlb_WatchMuted = false;
 
 __inline int CheckCache(u32 addr)
 {
@@ -461,6 +464,137 @@ void __fastcall vtlbUnmappedPWriteSm(u32 addr,OperandType data)			{ vtlb_BusErro
 template<typename OperandType, u32 saddr>
 void __fastcall vtlbUnmappedPWriteLg(u32 addr,const OperandType* data)	{ vtlb_BusError(addr|saddr,1); }
 
+// --------------------------------------------------------------------------------------
+//  VTLB watches
+// --------------------------------------------------------------------------------------
+// A watched page is mapped to WatchHandler, with the index of its slot standing in for the
+// physical address.  The slot keeps the mapping that the watch replaced, so the handler can
+// forward the access exactly as vtlb_memRead/Write would have.
+
+struct WatchSlot
+{
+	u32 vaddr;		// page address
+	sptr vmv;		// vmap entry of the page without the watch
+};
+
+static WatchSlot watchSlots[VTLB_WATCH_ITEMS];
+static uint watchCount = 0;
+static u32 watchBits[VTLB_VMAP_ITEMS / 32];		// watched virtual pages
+static vtlbWatchFP* watchNotify = NULL;
+
+static __fi bool vtlb_IsWatched(u32 vpage)
+{
+	return (watchBits[vpage / 32] & (1u << (vpage & 31))) != 0;
+}
+
+// Sets the vmap entry of a page, or the entry a watch on the page forwards to.
+static __fi void vtlb_SetVMap(u32 vaddr, sptr vmv)
+{
+	const u32 vpage = vaddr >> VTLB_PAGE_BITS;
+
+	if (vtlb_IsWatched(vpage))
+	{
+		for (uint i = 0; i < watchCount; ++i)
+		{
+			if (watchSlots[i].vaddr == vaddr)
+			{
+				watchSlots[i].vmv = vmv;
+				return;
+			}
+		}
+	}
+
+	vtlbdata.vmap[vpage] = vmv;
+}
+
+static __fi void vtlb_ApplyWatch(uint slot)
+{
+	const u32 vaddr = watchSlots[slot].vaddr;
+	sptr pme = WatchHandler | POINTER_SIGN_BIT | (slot << VTLB_PAGE_BITS);
+	vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = pme-vaddr;
+}
+
+static __fi uint vtlb_SizeIndex(uint size)
+{
+	switch (size)
+	{
+		case 1: return 0;
+		case 2: return 1;
+		case 4: return 2;
+		case 8: return 3;
+	}
+	return 4;
+}
+
+// Reports the access and translates it through the replaced mapping.  Returns the host
+// address of the access if the page was mapped directly, or a negative value and the
+// handler and physical address to call.
+static __fi sptr vtlb_WatchAccess(u32 addr, u32 size, bool write, u32& hand, u32& paddr)
+{
+	const WatchSlot& slot = watchSlots[addr >> VTLB_PAGE_BITS];
+	const u32 vaddr = slot.vaddr | (addr & VTLB_PAGE_MASK);
+
+	if (!vtlb_WatchMuted)
+		watchNotify(vaddr, size, write);
+
+	const sptr ppf = vaddr + slot.vmv;
+	hand = (u8)slot.vmv;
+	paddr = ppf - hand + 0x80000000;
+	return ppf;
+}
+
+template<typename OperandType>
+static OperandType __fastcall vtlbWatchReadSm(u32 addr)
+{
+	typedef OperandType __fastcall HandlerType(u32);
+
+	u32 hand, paddr;
+	const sptr ppf = vtlb_WatchAccess(addr, sizeof(OperandType), false, hand, paddr);
+	if (ppf >= 0)
+		return *reinterpret_cast<OperandType*>(ppf);
+
+	return ((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex(sizeof(OperandType))][0][hand])(paddr);
+}
+
+template<typename OperandType>
+static void __fastcall vtlbWatchReadLg(u32 addr, OperandType* data)
+{
+	typedef void __fastcall HandlerType(u32, OperandType*);
+
+	u32 hand, paddr;
+	const sptr ppf = vtlb_WatchAccess(addr, sizeof(OperandType), false, hand, paddr);
+	if (ppf >= 0)
+		*data = *reinterpret_cast<OperandType*>(ppf);
+	else
+		((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex(sizeof(OperandType))][0][hand])(paddr, data);
+}
+
+template<typename OperandType>
+static void __fastcall vtlbWatchWriteSm(u32 addr, OperandType data)
+{
+	typedef void __fastcall HandlerType(u32, OperandType);
+
+	u32 hand, paddr;
+	const sptr ppf = vtlb_WatchAccess(addr, sizeof(OperandType), true, hand, paddr);
+	if (ppf >= 0)
+		*reinterpret_cast<OperandType*>(ppf) = data;
+	else
+		((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex(sizeof(OperandType))][1][hand])(paddr, data);
+}
+
+template<typename OperandType>
+static void __fastcall vtlbWatchWriteLg(u32 addr, const OperandType* data)
+{
+	typedef void __fastcall HandlerType(u32, const OperandType*);
+
+	u32 hand, paddr;
+	const sptr ppf = vtlb_WatchAccess(addr, sizeof(OperandType), true, hand, paddr);
+	if (ppf >= 0)
+		*reinterpret_cast<OperandType*>(ppf) = *data;
+	else
+		((HandlerType*)vtlbdata.RWFT[vtlb_SizeIndex(sizeof(OperandType))][1][hand])(paddr, data);
+}
+
 // --------------------------------------------------------------------------------------
 //  VTLB mapping errors
 // --------------------------------------------------------------------------------------
@@ -687,7 +821,30 @@ void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
 				pme |= paddr;// top bit is set anyway ...
 		}
 
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = pme-vaddr;
+		vtlb_SetVMap(vaddr, pme-vaddr);
+		if (vtlbdata.ppmap)
+			if (!(vaddr & 0x80000000)) // those address are already physical don't change them
+				vtlbdata.ppmap[vaddr>>VTLB_PAGE_BITS] = paddr & ~VTLB_PAGE_MASK;
+
+		vaddr += VTLB_PAGE_SIZE;
+		paddr += VTLB_PAGE_SIZE;
+		size -= VTLB_PAGE_SIZE;
+	}
+}
+
+// Maps vaddr to paddr like vtlb_VMap, but through the given handler regardless of what
+// the physical page is mapped to.  The handler receives the physical address.
+void vtlb_VMapHandler(vtlbHandler handler,u32 vaddr,u32 paddr,u32 size)
+{
+	verify(0==(vaddr&VTLB_PAGE_MASK));
+	verify(0==(paddr&VTLB_PAGE_MASK));
+	verify(0==(size&VTLB_PAGE_MASK) && size>0);
+
+	while (size > 0)
+	{
+		sptr pme = handler | POINTER_SIGN_BIT | paddr;
+
+		vtlb_SetVMap(vaddr, pme-vaddr);
 		if (vtlbdata.ppmap)
 			if (!(vaddr & 0x80000000)) // those address are already physical don't change them
 				vtlbdata.ppmap[vaddr>>VTLB_PAGE_BITS] = paddr & ~VTLB_PAGE_MASK;
@@ -706,7 +863,7 @@ void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
 	uptr bu8 = (uptr)buffer;
 	while (size > 0)
 	{
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = bu8-vaddr;
+		vtlb_SetVMap(vaddr, bu8-vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		bu8 += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
@@ -729,12 +886,43 @@ void vtlb_VMapUnmap(u32 vaddr,u32 size)
 		handl |= vaddr; // top bit is set anyway ...
 		handl |= 0x80000000;
 
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = handl-vaddr;
+		vtlb_SetVMap(vaddr, handl-vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
 	}
 }
 
+bool vtlb_WatchPage(u32 vaddr, vtlbWatchFP* notify)
+{
+	vaddr &= ~VTLB_PAGE_MASK;
+	const u32 vpage = vaddr >> VTLB_PAGE_BITS;
+
+	watchNotify = notify;
+	if (vtlb_IsWatched(vpage))
+		return true;
+	if (watchCount >= VTLB_WATCH_ITEMS)
+		return false;
+
+	const uint slot = watchCount++;
+	watchSlots[slot].vaddr = vaddr;
+	watchSlots[slot].vmv = vtlbdata.vmap[vpage];
+	watchBits[vpage / 32] |= 1u << (vpage & 31);
+
+	vtlb_ApplyWatch(slot);
+	return true;
+}
+
+void vtlb_UnwatchAll()
+{
+	for (uint i = 0; i < watchCount; ++i)
+	{
+		const u32 vpage = watchSlots[i].vaddr >> VTLB_PAGE_BITS;
+		vtlbdata.vmap[vpage] = watchSlots[i].vmv;
+		watchBits[vpage / 32] &= ~(1u << (vpage & 31));
+	}
+	watchCount = 0;
+}
+
 // vtlb_Init -- Clears vtlb handlers and memory mappings.
 void vtlb_Init()
 {
@@ -761,6 +949,14 @@ void vtlb_Init()
 
 	DefaultPhyHandler = vtlb_RegisterHandler(0,0,0,0,0,0,0,0,0,0);
 
+	// Registered at the same index every time, since watches survive a vtlb_Init.
+	WatchHandler = vtlb_RegisterHandler(
+		vtlbWatchReadSm<mem8_t>,	vtlbWatchReadSm<mem16_t>,	vtlbWatchReadSm<mem32_t>,
+		vtlbWatchReadLg<mem64_t>,	vtlbWatchReadLg<mem128_t>,
+		vtlbWatchWriteSm<mem8_t>,	vtlbWatchWriteSm<mem16_t>,	vtlbWatchWriteSm<mem32_t>,
+		vtlbWatchWriteLg<mem64_t>,	vtlbWatchWriteLg<mem128_t>
+	);
+
 	//done !
 
 	//Setup the initial mappings
@@ -771,6 +967,10 @@ void vtlb_Init()
 	//yeah i know, its stupid .. but this code has to be here for now ;p
 	vtlb_VMapUnmap((VTLB_VMAP_ITEMS-1)*VTLB_PAGE_SIZE,VTLB_PAGE_SIZE);
 
+	// The vmap may have been reallocated since the watches were set up.
+	for (uint i = 0; i < watchCount; ++i)
+		vtlb_ApplyWatch(i);
+
 	// The LUT is only used for 1 game so we allocate it only when the gamefix is enabled (save 4MB)
 	if (EmuConfig.Gamefixes.GoemonTlbHack)
 		vtlb_Alloc_Ppmap();
@@ -857,6 +1057,7 @@ void VtlbMemoryReserve::Reserve( sptr hostptr )
 void VtlbMemoryReserve::Commit()
 {
 	if (IsCommitted()) return;
+	m_reserve.SetLargePages( EmuConfig.HostLargePages );
 	if (!m_reserve.Commit())
 	{
 		throw Exception::OutOfMemory( m_reserve.GetName() )
@@ -67,9 +67,20 @@ extern void vtlb_DynV2P();
 
 //virtual mappings
 extern void vtlb_VMap(u32 vaddr,u32 paddr,u32 sz);
+extern void vtlb_VMapHandler(vtlbHandler handler,u32 vaddr,u32 paddr,u32 sz);
 extern void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 sz);
 extern void vtlb_VMapUnmap(u32 vaddr,u32 sz);
 
+// Debugger memory watches.  Loads and stores to a watched virtual page are reported to the
+// notify callback, then carried out as if the page wasn't watched.  Remapping a watched
+// page keeps the watch.  Returns false when no watch slot is left.
+typedef void __fastcall vtlbWatchFP(u32 vaddr, u32 size, bool write);
+extern bool vtlb_WatchPage(u32 vaddr, vtlbWatchFP* notify);
+extern void vtlb_UnwatchAll();
+
+// Accesses aren't reported while this is set (code reads by the recompiler).
+extern bool vtlb_WatchMuted;
+
 //Memory functions
 
 template< typename DataType >
@@ -85,6 +96,7 @@ extern void __fastcall vtlb_memWrite128(u32 mem, const mem128_t* value);
 extern void vtlb_DynGenWrite(u32 sz);
 extern void vtlb_DynGenRead32(u32 bits, bool sign);
 extern void vtlb_DynGenRead64(u32 sz);
+extern void vtlb_DynGenFlushStubs();
 
 extern void vtlb_DynGenWrite_Const( u32 bits, u32 addr_const );
 extern void vtlb_DynGenRead64_Const( u32 bits, u32 addr_const );
@@ -188,6 +200,7 @@ namespace vtlb_private
 	static const uint VTLB_VMAP_ITEMS	= _4gb / VTLB_PAGE_SIZE;
 
 	static const uint VTLB_HANDLER_ITEMS = 128;
+	static const uint VTLB_WATCH_ITEMS = 1024;
 
 	static const uptr POINTER_SIGN_BIT = 1ULL << (sizeof(uptr) * 8 - 1);
 
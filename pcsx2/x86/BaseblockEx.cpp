@@ -19,13 +19,17 @@
 
 BASEBLOCKEX* BaseBlocks::New(u32 startpc, uptr fnptr)
 {
-	std::pair<linkiter_t, linkiter_t> range = links.equal_range(startpc);
-	for (linkiter_t i = range.first; i != range.second; ++i)
-		*(u32*)i->second = fnptr - (i->second + 4);
-	
+	Relink(startpc, fnptr);
 	return blocks.insert(startpc, fnptr);;
 }
 
+void BaseBlocks::Relink(u32 pc, uptr x86)
+{
+	std::pair<linkiter_t, linkiter_t> range = links.equal_range(pc);
+	for (linkiter_t i = range.first; i != range.second; ++i)
+		*(u32*)i->second = x86 - (i->second + 4);
+}
+
 int BaseBlocks::LastIndex(u32 startpc) const
 {
 	if (0 == blocks.size())
@@ -70,6 +74,33 @@ BASEBLOCKEX* BaseBlocks::GetByX86(uptr ip)
 }
 #endif
 
+int BaseBlocks::Evict(uptr begin, uptr end, uptr* reclut)
+{
+	const int count = blocks.size();
+	int kept = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		BASEBLOCKEX& block = blocks[i];
+
+		if (block.fnptr >= begin && block.fnptr < end)
+		{
+			Relink(block.startpc, recompiler);
+			Unlink(block);
+			PC_GETBLOCK_(block.startpc, reclut)->SetFnptr(recompiler);
+		}
+		else
+		{
+			if (kept != i)
+				blocks[kept] = block;
+			kept++;
+		}
+	}
+
+	blocks.erase(kept, count);
+	return count - kept;
+}
+
 void BaseBlocks::Link(u32 pc, s32* jumpptr)
 {
 	BASEBLOCKEX *targetblock = Get(pc);
@@ -78,5 +109,30 @@ void BaseBlocks::Link(u32 pc, s32* jumpptr)
 	else
 		*jumpptr = (s32)(recompiler - (sptr)(jumpptr + 1));
 	links.insert(std::pair<u32, uptr>(pc, (uptr)jumpptr));
+	linkSources[(uptr)jumpptr] = pc;
+}
+
+// Drops all the links whose jump instruction lives inside the given block.  Without this
+// the link table keeps growing with stale entries every time a block is cleared, and
+// New()/Remove() keep rewriting jumps in code that can never run again.
+void BaseBlocks::Unlink(const BASEBLOCKEX& block)
+{
+	std::map<uptr, u32>::iterator first = linkSources.lower_bound(block.fnptr);
+	std::map<uptr, u32>::iterator last = linkSources.lower_bound(block.fnptr + block.x86size);
+
+	for (std::map<uptr, u32>::iterator it = first; it != last; ++it)
+	{
+		std::pair<linkiter_t, linkiter_t> range = links.equal_range(it->second);
+		for (linkiter_t i = range.first; i != range.second; ++i)
+		{
+			if (i->second == it->first)
+			{
+				links.erase(i);
+				break;
+			}
+		}
+	}
+
+	linkSources.erase(first, last);
 }
 
@@ -147,7 +147,12 @@ protected:
 
 	// switch to a hash map later?
 	std::multimap<u32, uptr> links;
+	// Reverse index of the above (jump address -> target pc).  Ordered by x86 address so
+	// that all the links made by a block can be found from its fnptr/x86size range.
+	std::map<uptr, u32> linkSources;
 	uptr recompiler;
+
+	void Unlink(const BASEBLOCKEX& block);
 	BaseBlockArray blocks;
 
 public:
@@ -212,19 +217,31 @@ public:
 				BASEBLOCKEX effu( blocks[idx] );
 				memset( (void*)effu.fnptr, 0xcc, 1 );
 			}
+
+			// The block's own exits are dead code now; don't keep patching them.
+			Unlink(blocks[idx]);
 		}
 		while(idx++ < last);
 
-		// TODO: remove links from this block?
 		blocks.erase(first, last + 1);
 	}
 
 	void Link(u32 pc, s32* jumpptr);
 
+	// Points all the static jumps to the given pc at the given x86 address.
+	void Relink(u32 pc, uptr x86);
+
+	// Removes every block whose code starts in [begin, end), in a single pass over the
+	// block list, and points their entries in reclut back at the recompiler.  Entries
+	// inside the blocks are left alone (they may belong to blocks elsewhere in the cache).
+	// Returns the number of blocks removed.
+	int Evict(uptr begin, uptr end, uptr* reclut);
+
 	__fi void Reset()
 	{
 		blocks.clear();
 		links.clear();
+		linkSources.clear();
 	}
 };
 
@@ -314,8 +314,7 @@ static __aligned16 u64 FPU_FLOAT_TEMP[2];
 __fi void fpuFloat4(int regd) { // +NaN -> +fMax, -NaN -> -fMax, +Inf -> +fMax, -Inf -> -fMax
 	int t1reg = _allocTempXMMreg(XMMT_FPS, -1);
 	if (t1reg >= 0) {
-		xMOVSS(xRegisterSSE(t1reg), xRegisterSSE(regd));
-		xAND.PS(xRegisterSSE(t1reg), ptr[&s_neg[0]]);
+		xAND.PS(xRegisterSSE(t1reg), xRegisterSSE(regd), ptr[&s_neg[0]]);
 		xMIN.SS(xRegisterSSE(regd), ptr[&g_maxvals[0]]);
 		xMAX.SS(xRegisterSSE(regd), ptr[&g_minvals[0]]);
 		xOR.PS(xRegisterSSE(regd), xRegisterSSE(t1reg));
@@ -325,8 +324,7 @@ __fi void fpuFloat4(int regd) { // +NaN -> +fMax, -NaN -> -fMax, +Inf -> +fMax,
 		Console.Error("fpuFloat2() allocation error");
 		t1reg = (regd == 0) ? 1 : 0; // get a temp reg thats not regd
 		xMOVAPS(ptr[&FPU_FLOAT_TEMP[0]], xRegisterSSE(t1reg )); // backup data in t1reg to a temp address
-		xMOVSS(xRegisterSSE(t1reg), xRegisterSSE(regd));
-		xAND.PS(xRegisterSSE(t1reg), ptr[&s_neg[0]]);
+		xAND.PS(xRegisterSSE(t1reg), xRegisterSSE(regd), ptr[&s_neg[0]]);
 		xMIN.SS(xRegisterSSE(regd), ptr[&g_maxvals[0]]);
 		xMAX.SS(xRegisterSSE(regd), ptr[&g_minvals[0]]);
 		xOR.PS(xRegisterSSE(regd), xRegisterSSE(t1reg));
@@ -436,8 +434,7 @@ void FPU_ADD_SUB(int regd, int regt, int issub)
 
 	x86SetJ8(j8Ptr[0]);
 	//diff = 25 .. 255 , expt < expd
-	xMOVAPS(xRegisterSSE(xmmtemp), xRegisterSSE(regt));
-	xAND.PS(xRegisterSSE(xmmtemp), ptr[s_neg]);
+	xAND.PS(xRegisterSSE(xmmtemp), xRegisterSSE(regt), ptr[s_neg]);
 	if (issub)
 		xSUB.SS(xRegisterSSE(regd), xRegisterSSE(xmmtemp));
 	else
@@ -394,6 +394,50 @@ void FPU_ADD_SUB(int tempd, int tempt) //tempd and tempt are overwritten, they a
 	_freeX86reg(tempecx);
 }
 
+//------------------------------------------------------------------
+// Single precision fast path for ADD/SUB/MUL
+//------------------------------------------------------------------
+// Rounding toward zero, IEEE single precision gives the same result as the double precision
+// path whenever the rounded result has an exponent of 1..253: the operands then can't have been
+// inf/NaN for IEEE, and the exact result neither overflowed nor underflowed.  Only results that
+// are zero, tiny, huge or NaN need the conversion through double.
+// Emits the single precision op (sreg and treg are preserved) and returns the jump past the
+// double precision path, or NULL if the rounding mode doesn't allow the shortcut.
+static u32* FPU_SingleOp(int regd, int sreg, int treg, int op, bool acc)
+{
+	if (g_sseMXCSR.GetRoundMode() != SSEround_Chop)
+		return NULL;
+
+	int tempReg = _allocX86reg(xEmptyReg, X86TYPE_TEMP, 0, 0);
+	int t1reg = _allocTempXMMreg(XMMT_FPS, -1);
+
+	xMOVSS(xRegisterSSE(t1reg), xRegisterSSE(sreg));
+	switch (op)
+	{
+		case 0: xADD.SS(xRegisterSSE(t1reg), xRegisterSSE(treg)); break;
+		case 1: xSUB.SS(xRegisterSSE(t1reg), xRegisterSSE(treg)); break;
+		case 2: xMUL.SS(xRegisterSSE(t1reg), xRegisterSSE(treg)); break;
+	}
+
+	xMOVD(xRegister32(tempReg), xRegisterSSE(t1reg));
+	xAND(xRegister32(tempReg), 0x7f800000);
+	xSUB(xRegister32(tempReg), 0x00800000);
+	xCMP(xRegister32(tempReg), 253 << 23); // unsigned: exponent 0 wraps around
+	u8 *to_double = JAE8(0);
+
+	xAND(ptr32[&fpuRegs.fprc[31]], ~(FPUflagO | FPUflagU));
+	if (acc)
+		xAND(ptr32[&fpuRegs.ACCflag], ~1);
+	xMOVSS(xRegisterSSE(regd), xRegisterSSE(t1reg));
+	u32 *end = JMP32(0);
+
+	x86SetJ8(to_double);
+
+	_freeXMMreg(t1reg);
+	_freeX86reg(tempReg);
+	return end;
+}
+
 void FPU_MUL(int info, int regd, int sreg, int treg, bool acc)
 {
 	u8 *noHack;
@@ -411,11 +455,15 @@ void FPU_MUL(int info, int regd, int sreg, int treg, bool acc)
 		x86SetJ8(noHack);
 	}
 
+	u32 *endSingle = FPU_SingleOp(regd, sreg, treg, 2, acc);
+
 	ToDouble(sreg); ToDouble(treg);
 	xMUL.SD(xRegisterSSE(sreg), xRegisterSSE(treg));
 	ToPS2FPU(sreg, true, treg, acc);
 	xMOVSS(xRegisterSSE(regd), xRegisterSSE(sreg));
 
+	if (endSingle)
+		x86SetJ32(endSingle);
 	if (CHECK_FPUMULHACK)
 		x86SetJ32(endMul);
 }
@@ -434,6 +482,8 @@ void recFPUOp(int info, int regd, int op, bool acc)
 	if (FPU_CORRECT_ADD_SUB)
 		FPU_ADD_SUB(sreg, treg);
 
+	u32 *endSingle = FPU_SingleOp(regd, sreg, treg, op, acc);
+
 	ToDouble(sreg); ToDouble(treg);
 
 	recFPUOpXMM_to_XMM[op](sreg, treg);
@@ -441,6 +491,9 @@ void recFPUOp(int info, int regd, int op, bool acc)
 	ToPS2FPU(sreg, true, treg, acc, true);
 	xMOVSS(xRegisterSSE(regd), xRegisterSSE(sreg));
 
+	if (endSingle)
+		x86SetJ32(endSingle);
+
 	_freeXMMreg(sreg); _freeXMMreg(treg);
 }
 //------------------------------------------------------------------
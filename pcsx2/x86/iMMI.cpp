@@ -192,8 +192,7 @@ void recPMFHL()
 				xPSHUF.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_D), 0x72);
 			}
 			else {
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_LO));
-				xPACK.SSDW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_HI));
+				xPACK.SSDW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI));
 
 				// shuffle so a1a0b1b0->a1b1a0b0
 				xPSHUF.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_D), 0xd8);
@@ -405,8 +404,7 @@ void recPMAXW()
 		else if( EEREC_D == EEREC_S ) xPMAX.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		else if ( EEREC_D == EEREC_T ) xPMAX.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPMAX.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPMAX.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
 	}
 	else {
@@ -427,14 +425,12 @@ void recPMAXW()
 			else if( EEREC_D == EEREC_T ) {
 				int t1reg = _allocTempXMMreg(XMMT_INT, -1);
 				xMOVDQA(xRegisterSSE(t1reg), xRegisterSSE(EEREC_T));
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 				xPANDN(xRegisterSSE(t0reg), xRegisterSSE(t1reg));
 				_freeXMMreg(t1reg);
 			}
 			else {
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 				xPANDN(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
 			}
 
@@ -640,8 +636,7 @@ void recPMAXH()
 	if( EEREC_D == EEREC_S ) xPMAX.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPMAX.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPMAX.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPMAX.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -655,14 +650,12 @@ void recPCGTB()
 
 	int info = eeRecompileCodeXMM( XMMINFO_READS|XMMINFO_READT|XMMINFO_WRITED );
 	if( EEREC_D != EEREC_T ) {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.GTB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPCMP.GTB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	else {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.GTB(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPCMP.GTB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	_clearNeededXMMregs();
@@ -677,14 +670,12 @@ void recPCGTH()
 
 	int info = eeRecompileCodeXMM( XMMINFO_READS|XMMINFO_READT|XMMINFO_WRITED );
 	if( EEREC_D != EEREC_T ) {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.GTW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPCMP.GTW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	else {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.GTW(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPCMP.GTW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	_clearNeededXMMregs();
@@ -700,14 +691,12 @@ void recPCGTW()
 
 	int info = eeRecompileCodeXMM( XMMINFO_READS|XMMINFO_READT|XMMINFO_WRITED );
 	if( EEREC_D != EEREC_T ) {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.GTD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPCMP.GTD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	else {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.GTD(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPCMP.GTD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	_clearNeededXMMregs();
@@ -724,8 +713,7 @@ void recPADDSB()
 	if( EEREC_D == EEREC_S ) xPADD.SB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPADD.SB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPADD.SB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPADD.SB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -741,8 +729,7 @@ void recPADDSH()
 	if( EEREC_D == EEREC_S ) xPADD.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPADD.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPADD.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPADD.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -773,8 +760,7 @@ void recPADDSW()
 	if( EEREC_D == EEREC_S ) xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 
 	xPXOR(xRegisterSSE(t0reg), xRegisterSSE(t1reg)); // Sign(Rs) != Sign(Rt)
@@ -812,13 +798,11 @@ void recPSUBSB()
 	else if( EEREC_D == EEREC_T ) {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.SB(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPSUB.SB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.SB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.SB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -835,13 +819,11 @@ void recPSUBSH()
 	else if( EEREC_D == EEREC_T ) {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.SW(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPSUB.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -874,12 +856,10 @@ void recPSUBSW()
 	if( EEREC_D == EEREC_S ) xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) {
 		xMOVDQA(xRegisterSSE(t2reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(t2reg));
+		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t2reg));
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 
 	// overflow check
@@ -915,8 +895,7 @@ void recPADDB()
 	if( EEREC_D == EEREC_S ) xPADD.B(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPADD.B(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPADD.B(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPADD.B(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -940,8 +919,7 @@ void recPADDH()
 		if( EEREC_D == EEREC_S ) xPADD.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		else if( EEREC_D == EEREC_T ) xPADD.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPADD.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPADD.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
 	}
 	_clearNeededXMMregs();
@@ -966,8 +944,7 @@ void recPADDW()
 		if( EEREC_D == EEREC_S ) xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		else if( EEREC_D == EEREC_T ) xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
 	}
 	_clearNeededXMMregs();
@@ -985,13 +962,11 @@ void recPSUBB()
 	else if( EEREC_D == EEREC_T ) {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.B(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPSUB.B(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.B(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.B(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1008,13 +983,11 @@ void recPSUBH()
 	else if( EEREC_D == EEREC_T ) {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.W(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPSUB.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1031,13 +1004,11 @@ void recPSUBW()
 	else if( EEREC_D == EEREC_T ) {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1059,13 +1030,11 @@ void recPEXTLW()
 		else if( EEREC_D == EEREC_S ) {
 			int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 			xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.LDQ(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+			xPUNPCK.LDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(t0reg));
 			_freeXMMreg(t0reg);
 		}
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.LDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
+			xPUNPCK.LDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
 		}
 	}
 	_clearNeededXMMregs();
@@ -1087,13 +1056,11 @@ void recPEXTLB()
 		else if( EEREC_D == EEREC_S ) {
 			int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 			xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.LBW(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+			xPUNPCK.LBW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(t0reg));
 			_freeXMMreg(t0reg);
 		}
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.LBW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
+			xPUNPCK.LBW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
 		}
 	}
 	_clearNeededXMMregs();
@@ -1115,13 +1082,11 @@ void recPEXTLH()
 		else if( EEREC_D == EEREC_S ) {
 			int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 			xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.LWD(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+			xPUNPCK.LWD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(t0reg));
 			_freeXMMreg(t0reg);
 		}
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.LWD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
+			xPUNPCK.LWD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
 		}
 	}
 	_clearNeededXMMregs();
@@ -1233,8 +1198,7 @@ void recPMINW()
 		else if( EEREC_D == EEREC_S ) xPMIN.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		else if ( EEREC_D == EEREC_T ) xPMIN.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPMIN.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPMIN.SD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
 	}
 	else {
@@ -1255,14 +1219,12 @@ void recPMINW()
 			else if( EEREC_D == EEREC_T ) {
 				int t1reg = _allocTempXMMreg(XMMT_INT, -1);
 				xMOVDQA(xRegisterSSE(t1reg), xRegisterSSE(EEREC_T));
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 				xPANDN(xRegisterSSE(t0reg), xRegisterSSE(t1reg));
 				_freeXMMreg(t1reg);
 			}
 			else {
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+				xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 				xPANDN(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
 			}
 
@@ -1300,8 +1262,7 @@ void recPADSBH()
 			xPSUB.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		}
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPSUB.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPSUB.W(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 			xPADD.W(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
 		}
 
@@ -1345,8 +1306,7 @@ void recPADDUW()
 		if( EEREC_D == EEREC_S ) xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		else if( EEREC_D == EEREC_T ) xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPADD.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
 
 		// unsigned 32-bit comparison
@@ -1374,13 +1334,11 @@ void recPSUBUB()
 	else if( EEREC_D == EEREC_T ) {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.USB(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPSUB.USB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.USB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.USB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1397,13 +1355,11 @@ void recPSUBUH()
 	else if( EEREC_D == EEREC_T ) {
 		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 		xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.USW(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+		xPSUB.USW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t0reg));
 		_freeXMMreg(t0reg);
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.USW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.USW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1432,14 +1388,12 @@ void recPSUBUW()
 	}
 	else if( EEREC_D == EEREC_T ) {
 		xMOVDQA(xRegisterSSE(t1reg), xRegisterSSE(EEREC_T));
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(t1reg));
+		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(t1reg));
 		xPXOR(xRegisterSSE(t1reg), xRegisterSSE(t0reg));
 		xPXOR(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPSUB.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		xMOVDQA(xRegisterSSE(t1reg), xRegisterSSE(t0reg));
 		xPXOR(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
 		xPXOR(xRegisterSSE(t1reg), xRegisterSSE(EEREC_T));
@@ -1473,13 +1427,11 @@ void recPEXTUH()
 		else if( EEREC_D == EEREC_S ) {
 			int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 			xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.HWD(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+			xPUNPCK.HWD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(t0reg));
 			_freeXMMreg(t0reg);
 		}
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.HWD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
+			xPUNPCK.HWD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
 		}
 	}
 	_clearNeededXMMregs();
@@ -1532,13 +1484,11 @@ void recPEXTUB()
 		else if( EEREC_D == EEREC_S ) {
 			int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 			xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.HBW(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+			xPUNPCK.HBW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(t0reg));
 			_freeXMMreg(t0reg);
 		}
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.HBW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
+			xPUNPCK.HBW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
 		}
 	}
 	_clearNeededXMMregs();
@@ -1561,13 +1511,11 @@ void recPEXTUW()
 		else if( EEREC_D == EEREC_S ) {
 			int t0reg = _allocTempXMMreg(XMMT_INT, -1);
 			xMOVDQA(xRegisterSSE(t0reg), xRegisterSSE(EEREC_S));
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.HDQ(xRegisterSSE(EEREC_D), xRegisterSSE(t0reg));
+			xPUNPCK.HDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(t0reg));
 			_freeXMMreg(t0reg);
 		}
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			xPUNPCK.HDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
+			xPUNPCK.HDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
 		}
 	}
 	_clearNeededXMMregs();
@@ -1584,8 +1532,7 @@ void recPMINH()
 	if( EEREC_D == EEREC_S ) xPMIN.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPMIN.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPMIN.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPMIN.SW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1601,8 +1548,7 @@ void recPCEQB()
 	if( EEREC_D == EEREC_S ) xPCMP.EQB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPCMP.EQB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.EQB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPCMP.EQB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1618,8 +1564,7 @@ void recPCEQH()
 	if( EEREC_D == EEREC_S ) xPCMP.EQW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPCMP.EQW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.EQW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPCMP.EQW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1635,8 +1580,7 @@ void recPCEQW()
 	if( EEREC_D == EEREC_S ) xPCMP.EQD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPCMP.EQD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPCMP.EQD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPCMP.EQD(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -1653,8 +1597,7 @@ void recPADDUB()
 		if( EEREC_D == EEREC_S ) xPADD.USB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		else if( EEREC_D == EEREC_T ) xPADD.USB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPADD.USB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPADD.USB(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
 	}
 	else xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
@@ -1672,13 +1615,139 @@ void recPADDUH()
 	if( EEREC_D == EEREC_S ) xPADD.USW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	else if( EEREC_D == EEREC_T ) xPADD.USW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPADD.USW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPADD.USW(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
 
 #endif
+////////////////////////////////////////////////////
+// Helpers shared by the word multiplies and divides of MMI2 and MMI3
+
+// to = signed product of the even words of from1 and from2 (pmuldq).  Without SSE4.1 the
+// unsigned product is corrected: a*b = ua*ub - ((a<0 ? b : 0) + (b<0 ? a : 0)) << 32.
+static void recPMULDQ(const xRegisterSSE& to, const xRegisterSSE& from1, const xRegisterSSE& from2)
+{
+	if ( x86caps.hasStreamingSIMD4Extensions ) {
+		xPMUL.DQ(to, from1, from2);
+		return;
+	}
+
+	int t0reg = _allocTempXMMreg(XMMT_INT, -1);
+	int t1reg = _allocTempXMMreg(XMMT_INT, -1);
+
+	xMOVDQA(xRegisterSSE(t0reg), from1);
+	xPSRA.D(xRegisterSSE(t0reg), 31);
+	xPAND(xRegisterSSE(t0reg), from2);
+	xMOVDQA(xRegisterSSE(t1reg), from2);
+	xPSRA.D(xRegisterSSE(t1reg), 31);
+	xPAND(xRegisterSSE(t1reg), from1);
+	xPADD.D(xRegisterSSE(t0reg), xRegisterSSE(t1reg));
+	xPSLL.Q(xRegisterSSE(t0reg), 32);
+
+	xPMUL.UDQ(to, from1, from2);
+	xPSUB.Q(to, xRegisterSSE(t0reg));
+
+	_freeXMMreg(t0reg);
+	_freeXMMreg(t1reg);
+}
+
+// LO = sign extended {src[0], src[2]}, HI = sign extended {src[1], src[3]}: the 64 bit
+// results of the word multiplies, split into LO/HI.  src may be HI.
+static void recWritebackPMULHILO(int info, const xRegisterSSE& src)
+{
+	if ( x86caps.hasStreamingSIMD4Extensions ) {
+		xPSHUF.D(xRegisterSSE(EEREC_LO), src, 0x88);
+		xPSHUF.D(xRegisterSSE(EEREC_HI), src, 0xdd);
+		xPMOVSX.DQ(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO));
+		xPMOVSX.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
+	}
+	else {
+		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
+		xPSHUF.D(xRegisterSSE(t0reg), src, 0xd8);
+		xMOVDQA(xRegisterSSE(EEREC_LO), xRegisterSSE(t0reg));
+		xMOVDQA(xRegisterSSE(EEREC_HI), xRegisterSSE(t0reg));
+		xPSRA.D(xRegisterSSE(t0reg), 31); // get the signs
+
+		xPUNPCK.LDQ(xRegisterSSE(EEREC_LO), xRegisterSSE(t0reg));
+		xPUNPCK.HDQ(xRegisterSSE(EEREC_HI), xRegisterSSE(t0reg));
+		_freeXMMreg(t0reg);
+	}
+}
+
+// Divides eax by ecx with the R5900 results for overflow and for a zero divisor: the
+// quotient is left in eax and the remainder in edx (see recDIVsuper).
+static void recPDIVlane(bool sign)
+{
+	u8 *end1 = NULL;
+	if (sign) //test for overflow (x86 will just throw an exception)
+	{
+		xCMP(eax, 0x80000000 );
+		u8 *cont1 = JNE8(0);
+		xCMP(ecx, 0xffffffff );
+		u8 *cont2 = JNE8(0);
+		//overflow case:
+		xXOR(edx, edx); //EAX remains 0x80000000
+		end1 = JMP8(0);
+
+		x86SetJ8(cont1);
+		x86SetJ8(cont2);
+	}
+
+	xTEST(ecx, ecx);
+	u8 *cont3 = JNZ8(0);
+	//divide by zero
+	xMOV(edx, eax);
+	if (sign) //set EAX to (EAX < 0)?1:-1
+	{
+		xSAR(eax, 31 ); //(EAX < 0)?-1:0
+		xSHL(eax, 1 ); //(EAX < 0)?-2:0
+		xNOT(eax); //(EAX < 0)?1:-1
+	}
+	else
+		xMOV(eax, 0xffffffff );
+	u8 *end2 = JMP8(0);
+
+	x86SetJ8(cont3);
+	if( sign ) {
+		xCDQ();
+		xDIV(ecx);
+	}
+	else {
+		xXOR(edx, edx);
+		xUDIV(ecx);
+	}
+
+	if (sign) x86SetJ8( end1 );
+	x86SetJ8( end2 );
+}
+
+// PDIVW/PDIVUW: LO/HI doubleword n = sign extended quotient/remainder of word 2n.
+static void recPDIVWsuper(bool sign)
+{
+	// The operands are read from memory, and all of LO/HI is overwritten.
+	_flushEEreg(_Rs_);
+	_flushEEreg(_Rt_);
+	_deleteGPRtoXMMreg(XMMGPR_LO, 3);
+	_deleteGPRtoXMMreg(XMMGPR_HI, 3);
+
+	for (int n = 0; n < 2; ++n)
+	{
+		xMOV(eax, ptr32[&cpuRegs.GPR.r[_Rs_].UL[n * 2]]);
+		xMOV(ecx, ptr32[&cpuRegs.GPR.r[_Rt_].UL[n * 2]]);
+		recPDIVlane(sign);
+
+		xMOV(ecx, edx);
+		xCDQ();
+		xMOV(ptr32[&cpuRegs.LO.UL[n * 2]], eax);
+		xMOV(ptr32[&cpuRegs.LO.UL[n * 2 + 1]], edx);
+		xMOV(eax, ecx);
+		xCDQ();
+		xMOV(ptr32[&cpuRegs.HI.UL[n * 2]], eax);
+		xMOV(ptr32[&cpuRegs.HI.UL[n * 2 + 1]], edx);
+	}
+}
+
 /*********************************************************
 *   MMI2 opcodes                                         *
 *                                                        *
@@ -1716,30 +1785,17 @@ void recPMADDW()
 {
 	EE::Profiler.EmitOp(eeOpcode::PMADDW);
 
-	if( !x86caps.hasStreamingSIMD4Extensions ) {
-		_deleteEEreg(_Rd_, 0);
-		recCall(Interp::PMADDW);
-		return;
-	}
-
 	int info = eeRecompileCodeXMM( (((_Rs_)&&(_Rt_))?XMMINFO_READS:0)|(((_Rs_)&&(_Rt_))?XMMINFO_READT:0)|(_Rd_?XMMINFO_WRITED:0)|XMMINFO_WRITELO|XMMINFO_WRITEHI|XMMINFO_READLO|XMMINFO_READHI );
 	xSHUF.PS(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI), 0x88);
 	xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO), 0xd8); // LO = {LO[0], HI[0], LO[2], HI[2]}
 	if( _Rd_ ) {
 		if( !_Rs_ || !_Rt_ ) xPXOR(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_D));
-		else if( EEREC_D == EEREC_S ) xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-		else if( EEREC_D == EEREC_T ) xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-		}
+		else if( EEREC_D == EEREC_T ) recPMULDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
+		else recPMULDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	else {
 		if( !_Rs_ || !_Rt_ ) xPXOR(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
-		else {
-			xMOVDQA(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_S));
-			xPMUL.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_T));
-		}
+		else recPMULDQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 
 	// add from LO/HI
@@ -1747,16 +1803,7 @@ void recPMADDW()
 	else xPADD.Q(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_LO));
 
 	// interleave & sign extend
-	if ( _Rd_ ) {
-		xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_D), 0x88);
-		xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_D), 0xdd);
-	}
-	else {
-		xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI), 0x88);
-		xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI), 0xdd);
-	}
-	xPMOVSX.DQ(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO));
-	xPMOVSX.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
+	recWritebackPMULHILO(info, xRegisterSSE(_Rd_ ? EEREC_D : EEREC_HI));
 	_clearNeededXMMregs();
 }
 
@@ -1901,29 +1948,17 @@ void recPMSUBW()
 {
 	EE::Profiler.EmitOp(eeOpcode::PMSUBW);
 
-	if( !x86caps.hasStreamingSIMD4Extensions ) {
-		_deleteEEreg(_Rd_, 0);
-		recCall(Interp::PMSUBW);
-		return;
-	}
 	int info = eeRecompileCodeXMM( (((_Rs_)&&(_Rt_))?XMMINFO_READS:0)|(((_Rs_)&&(_Rt_))?XMMINFO_READT:0)|(_Rd_?XMMINFO_WRITED:0)|XMMINFO_WRITELO|XMMINFO_WRITEHI|XMMINFO_READLO|XMMINFO_READHI );
 	xSHUF.PS(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI), 0x88);
 	xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO), 0xd8); // LO = {LO[0], HI[0], LO[2], HI[2]}
 	if( _Rd_ ) {
 		if( !_Rs_ || !_Rt_ ) xPXOR(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_D));
-		else if( EEREC_D == EEREC_S ) xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-		else if( EEREC_D == EEREC_T ) xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-		}
+		else if( EEREC_D == EEREC_T ) recPMULDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
+		else recPMULDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	else {
 		if( !_Rs_ || !_Rt_ ) xPXOR(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
-		else {
-			xMOVDQA(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_S));
-			xPMUL.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_T));
-		}
+		else recPMULDQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 
 	// sub from LO/HI
@@ -1937,16 +1972,7 @@ void recPMSUBW()
 	}
 
 	// interleave & sign extend
-	if ( _Rd_ ) {
-		xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_D), 0x88);
-		xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_D), 0xdd);
-	}
-	else {
-		xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI), 0x88);
-		xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI), 0xdd);
-	}
-	xPMOVSX.DQ(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO));
-	xPMOVSX.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
+	recWritebackPMULHILO(info, xRegisterSSE(_Rd_ ? EEREC_D : EEREC_HI));
 	_clearNeededXMMregs();
 }
 
@@ -1955,11 +1981,6 @@ void recPMULTW()
 {
 	EE::Profiler.EmitOp(eeOpcode::PMULTW);
 
-	if( !x86caps.hasStreamingSIMD4Extensions ) {
-		_deleteEEreg(_Rd_, 0);
-		recCall(Interp::PMULTW);
-		return;
-	}
 	int info = eeRecompileCodeXMM( (((_Rs_)&&(_Rt_))?XMMINFO_READS:0)|(((_Rs_)&&(_Rt_))?XMMINFO_READT:0)|(_Rd_?XMMINFO_WRITED:0)|XMMINFO_WRITELO|XMMINFO_WRITEHI );
 	if( !_Rs_ || !_Rt_ ) {
 		if( _Rd_ ) xPXOR(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_D));
@@ -1968,29 +1989,13 @@ void recPMULTW()
 	}
 	else {
 		if( _Rd_ ) {
-			if( EEREC_D == EEREC_S ) xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			else if( EEREC_D == EEREC_T ) xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			else {
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-				xPMUL.DQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
-			}
-		}
-		else {
-			xMOVDQA(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_S));
-			xPMUL.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_T));
+			if( EEREC_D == EEREC_T ) recPMULDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T), xRegisterSSE(EEREC_S));
+			else recPMULDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
+		else recPMULDQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 
 		// interleave & sign extend
-		if ( _Rd_ ) {
-			xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_D), 0x88);
-			xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_D), 0xdd);
-		}
-		else {
-			xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI), 0x88);
-			xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI), 0xdd);
-		}
-		xPMOVSX.DQ(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO));
-		xPMOVSX.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
+		recWritebackPMULHILO(info, xRegisterSSE(_Rd_ ? EEREC_D : EEREC_HI));
 	}
 	_clearNeededXMMregs();
 }
@@ -1999,8 +2004,7 @@ void recPDIVW()
 {
 	EE::Profiler.EmitOp(eeOpcode::PDIVW);
 
-	_deleteEEreg(_Rd_, 0);
-	recCall(Interp::PDIVW);
+	recPDIVWsuper(true);
 }
 
 ////////////////////////////////////////////////////
@@ -2008,8 +2012,20 @@ void recPDIVBW()
 {
 	EE::Profiler.EmitOp(eeOpcode::PDIVBW);
 
-	_deleteEEreg(_Rd_, 0);
-	recCall(Interp::PDIVBW); //--
+	_flushEEreg(_Rs_);
+	_flushEEreg(_Rt_);
+	_deleteGPRtoXMMreg(XMMGPR_LO, 3);
+	_deleteGPRtoXMMreg(XMMGPR_HI, 3);
+
+	// every word of Rs is divided by the (signed) low halfword of Rt
+	for (int n = 0; n < 4; ++n)
+	{
+		xMOV(eax, ptr32[&cpuRegs.GPR.r[_Rs_].UL[n]]);
+		xMOVSX(ecx, ptr16[&cpuRegs.GPR.r[_Rt_].US[0]]);
+		recPDIVlane(true);
+		xMOV(ptr32[&cpuRegs.LO.UL[n]], eax);
+		xMOV(ptr32[&cpuRegs.HI.UL[n]], edx);
+	}
 }
 
 ////////////////////////////////////////////////////
@@ -2301,8 +2317,7 @@ void recPAND()
 		xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPAND(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -2322,8 +2337,7 @@ void recPXOR()
 		xPXOR(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 	}
 	else {
-		xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-		xPXOR(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+		xPXOR(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 	}
 	_clearNeededXMMregs();
 }
@@ -2581,8 +2595,7 @@ void recPMULTUW()
 			if( EEREC_D == EEREC_S ) xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 			else if( EEREC_D == EEREC_T ) xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 			else {
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-				xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+				xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 			}
 			xMOVDQA(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_D));
 		}
@@ -2592,23 +2605,7 @@ void recPMULTUW()
 		}
 
 		// interleave & sign extend
-		if ( x86caps.hasStreamingSIMD4Extensions ) {
-			xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI), 0x88);
-			xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI), 0xdd);
-			xPMOVSX.DQ(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO));
-			xPMOVSX.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
-		}
-		else {
-			int t0reg = _allocTempXMMreg(XMMT_INT, -1);
-			xPSHUF.D(xRegisterSSE(t0reg), xRegisterSSE(EEREC_HI), 0xd8);
-			xMOVDQA(xRegisterSSE(EEREC_LO), xRegisterSSE(t0reg));
-			xMOVDQA(xRegisterSSE(EEREC_HI), xRegisterSSE(t0reg));
-			xPSRA.D(xRegisterSSE(t0reg), 31); // get the signs
-
-			xPUNPCK.LDQ(xRegisterSSE(EEREC_LO), xRegisterSSE(t0reg));
-			xPUNPCK.HDQ(xRegisterSSE(EEREC_HI), xRegisterSSE(t0reg));
-			_freeXMMreg(t0reg);
-		}
+		recWritebackPMULHILO(info, xRegisterSSE(EEREC_HI));
 	}
 	_clearNeededXMMregs();
 }
@@ -2626,8 +2623,7 @@ void recPMADDUW()
 		else if( EEREC_D == EEREC_S ) xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
 		else if( EEREC_D == EEREC_T ) xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
 		else {
-			xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-			xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+			xPMUL.UDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 		}
 	}
 	else {
@@ -2646,23 +2642,7 @@ void recPMADDUW()
 	else xPADD.Q(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_LO));
 
 	// interleave & sign extend
-	if ( x86caps.hasStreamingSIMD4Extensions ) {
-		xPSHUF.D(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_HI), 0x88);
-		xPSHUF.D(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI), 0xdd);
-		xPMOVSX.DQ(xRegisterSSE(EEREC_LO), xRegisterSSE(EEREC_LO));
-		xPMOVSX.DQ(xRegisterSSE(EEREC_HI), xRegisterSSE(EEREC_HI));
-	}
-	else {
-		int t0reg = _allocTempXMMreg(XMMT_INT, -1);
-		xPSHUF.D(xRegisterSSE(t0reg), xRegisterSSE(EEREC_HI), 0xd8);
-		xMOVDQA(xRegisterSSE(EEREC_LO), xRegisterSSE(t0reg));
-		xMOVDQA(xRegisterSSE(EEREC_HI), xRegisterSSE(t0reg));
-		xPSRA.D(xRegisterSSE(t0reg), 31); // get the signs
-
-		xPUNPCK.LDQ(xRegisterSSE(EEREC_LO), xRegisterSSE(t0reg));
-		xPUNPCK.HDQ(xRegisterSSE(EEREC_HI), xRegisterSSE(t0reg));
-		_freeXMMreg(t0reg);
-	}
+	recWritebackPMULHILO(info, xRegisterSSE(EEREC_HI));
 	_clearNeededXMMregs();
 }
 
@@ -2671,8 +2651,7 @@ void recPDIVUW()
 {
 	EE::Profiler.EmitOp(eeOpcode::PDIVUW);
 
-	_deleteEEreg(_Rd_, 0);
-	recCall(Interp::PDIVUW);
+	recPDIVWsuper(false);
 }
 
 ////////////////////////////////////////////////////
@@ -2806,8 +2785,7 @@ void recPCPYUD()
 				xPSHUF.D(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), 0xee);
 			}
 			else {
-				xMOVDQA(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S));
-				xPUNPCK.HQDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_T));
+				xPUNPCK.HQDQ(xRegisterSSE(EEREC_D), xRegisterSSE(EEREC_S), xRegisterSSE(EEREC_T));
 			}
 		}
 	}
@@ -37,6 +37,8 @@
 #include "AppConfig.h"
 
 #include "Utilities/Perf.h"
+#include "DebugTools/RecProfiler.h"
+#include "DebugTools/MIPSAnalyst.h"
 
 using namespace x86Emitter;
 
@@ -514,7 +516,7 @@ static void psxRecompileIrxImport()
 
 	const std::string libname = iopMemReadString(import_table + 12, 8);
 
-	irxHLE hle = irxImportHLE(libname, index);
+	irxHLE hle = irxImportHLE(libname, iopMemRead16(import_table + 8), index);
 #ifdef PCSX2_DEVBUILD
 	const irxDEBUG debug = irxImportDebug(libname, index);
 	const char* funcname = irxImportFuncname(libname, index);
@@ -683,6 +685,7 @@ void recResetIOP()
 	DevCon.WriteLn( "iR3000A Recompiler reset." );
 
 	Perf::iop.reset();
+	RecProfiler::ResetBlocks(RecProfiler::Source_IOP);
 
 	recAlloc();
 	recMem->Reset();
@@ -886,7 +889,14 @@ void psxSetBranchReg(u32 reg)
 	_psxFlushCall(FLUSH_EVERYTHING);
 	iPsxBranchTest(0xffffffff, 1);
 
-	JMP32((uptr)iopDispatcherReg - ( (uptr)x86Ptr + 5 ));
+	// Same lookup as iopDispatcherReg, but done inline: every jr/jalr site then gets its
+	// own indirect jump, so the host branch predictor can learn targets per call site
+	// instead of sharing a single (mostly mispredicted) jump in the dispatcher.
+	xMOV( eax, ptr[&psxRegs.pc] );
+	xMOV( ebx, eax );
+	xSHR( eax, 16 );
+	xMOV( ecx, ptr[psxRecLUT + (eax*4)] );
+	xJMP( ptr32[ecx+ebx] );
 }
 
 void psxSetBranchImm( u32 imm )
@@ -1069,6 +1079,11 @@ static void __fastcall  PreBlockCheck( u32 blockpc )
 #endif
 }
 
+static u32 psxFetchOpcode( u32 pc )
+{
+	return iopMemRead32(pc);
+}
+
 static void __fastcall iopRecRecompile( const u32 startpc )
 {
 	u32 i;
@@ -1192,20 +1207,9 @@ static void __fastcall iopRecRecompile( const u32 startpc )
 
 StartRecomp:
 
-	s_nBlockFF = false;
-	if (s_branchTo == startpc) {
-		s_nBlockFF = true;
-		for (i = startpc; i < s_nEndBlock; i += 4) {
-			if (i != s_nEndBlock - 8) {
-				switch (iopMemRead32(i)) {
-					case 0: // nop
-						break;
-					default:
-						s_nBlockFF = false;
-				}
-			}
-		}
-	}
+	// Detect polling loops (see MIPSAnalyst::IsIdleLoop), so that iPsxBranchTest can
+	// fast forward them to the next event.
+	s_nBlockFF = (s_branchTo == startpc) && MIPSAnalyst::IsIdleLoop(startpc, s_nEndBlock, psxFetchOpcode);
 
 	// rec info //
 	{
@@ -1292,6 +1296,7 @@ StartRecomp:
 	s_pCurBlockEx->x86size = xGetPtr() - recPtr;
 
 	Perf::iop.map(s_pCurBlockEx->fnptr, s_pCurBlockEx->x86size, s_pCurBlockEx->startpc);
+	RecProfiler::MapBlock(RecProfiler::Source_IOP, s_pCurBlockEx->fnptr, s_pCurBlockEx->x86size, s_pCurBlockEx->startpc);
 
 	recPtr = xGetPtr();
 
@@ -47,6 +47,14 @@ static void rgte##f() { \
 /*	branch = 2; */\
 }
 
+// GTE operations only use the COP2 registers: the GPRs (and their constants) stay where they are
+#define REC_GTE_OP(f) \
+static void rgte##f() { \
+	xMOV(ptr32[&psxRegs.code], (u32)psxRegs.code); \
+	_psxFlushCall(0); \
+	xFastCall((void*)(uptr)gte##f); \
+}
+
 extern void psxLWL();
 extern void psxLWR();
 extern void psxSWL();
@@ -1392,28 +1400,34 @@ void rpsxRFE()
 }
 
 //// COP2
-REC_GTE_FUNC(RTPS);
-REC_GTE_FUNC(NCLIP);
-REC_GTE_FUNC(OP);
-REC_GTE_FUNC(DPCS);
-REC_GTE_FUNC(INTPL);
-REC_GTE_FUNC(MVMVA);
-REC_GTE_FUNC(NCDS);
-REC_GTE_FUNC(CDP);
-REC_GTE_FUNC(NCDT);
-REC_GTE_FUNC(NCCS);
-REC_GTE_FUNC(CC);
-REC_GTE_FUNC(NCS);
-REC_GTE_FUNC(NCT);
-REC_GTE_FUNC(SQR);
-REC_GTE_FUNC(DCPL);
-REC_GTE_FUNC(DPCT);
-REC_GTE_FUNC(AVSZ3);
-REC_GTE_FUNC(AVSZ4);
-REC_GTE_FUNC(RTPT);
-REC_GTE_FUNC(GPF);
-REC_GTE_FUNC(GPL);
-REC_GTE_FUNC(NCCT);
+REC_GTE_OP(RTPS);
+REC_GTE_OP(NCLIP);
+REC_GTE_OP(OP);
+REC_GTE_OP(DPCS);
+REC_GTE_OP(INTPL);
+REC_GTE_OP(NCDS);
+REC_GTE_OP(CDP);
+REC_GTE_OP(NCDT);
+REC_GTE_OP(NCCS);
+REC_GTE_OP(CC);
+REC_GTE_OP(NCS);
+REC_GTE_OP(NCT);
+REC_GTE_OP(SQR);
+REC_GTE_OP(DCPL);
+REC_GTE_OP(DPCT);
+REC_GTE_OP(AVSZ3);
+REC_GTE_OP(AVSZ4);
+REC_GTE_OP(RTPT);
+REC_GTE_OP(GPF);
+REC_GTE_OP(GPL);
+REC_GTE_OP(NCCT);
+
+// The opcode fields are known here, the interpreter would decode them on every call
+static void rgteMVMVA() {
+	xMOV(ptr32[&psxRegs.code], (u32)psxRegs.code);
+	_psxFlushCall(0);
+	xFastCall((void*)(uptr)gteMVMVA_Get(psxRegs.code));
+}
 
 REC_GTE_FUNC(MFC2);
 REC_GTE_FUNC(CFC2);
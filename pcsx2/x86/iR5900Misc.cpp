@@ -190,13 +190,11 @@ void recMTSAH()
 	**********************************************************/
 
 	// Suikoden 3 uses it a lot
-	void recCACHE() //Interpreter only!
+	void recCACHE()
 	{
-	   //xMOV(ptr32[&cpuRegs.code], (u32)cpuRegs.code );
-	   //xMOV(ptr32[&cpuRegs.pc], (u32)pc );
-	   //iFlushCall(FLUSH_EVERYTHING);
-	   //xFastCall((void*)(uptr)R5900::Interpreter::OpcodeImpl::CACHE );
-	   //branch = 2;
+		// Data cache writebacks/invalidates only matter when the cache is emulated.
+		if (CHECK_CACHE)
+			recCall(R5900::Interpreter::OpcodeImpl::CACHE);
 	}
 
 	void recTGE()
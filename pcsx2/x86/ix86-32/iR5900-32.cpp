@@ -33,8 +33,12 @@
 #include "Elfheader.h"
 
 #include "../DebugTools/Breakpoints.h"
+#include "../DebugTools/RecProfiler.h"
+#include "../DebugTools/MIPSAnalyst.h"
 #include "Patch.h"
 
+#include "Utilities/Instrumentation.h"
+
 #if !PCSX2_SEH
 #	include <csetjmp>
 #endif
@@ -79,6 +83,15 @@ static const size_t recLutSize = Ps2MemSize::MainRam + Ps2MemSize::Rom + Ps2MemS
 
 static uptr m_ConfiguredCacheReserve = 64;
 
+// The code cache is filled one segment at a time.  Once every segment has been used, the
+// oldest one is evicted and refilled instead of resetting the whole cache, which keeps the
+// rest of the hot code around (full resets stall for several frames in big games).
+static const uint RecCacheSegments = 8;
+static uint s_recSegment = 0;
+static bool s_recCacheWrapped = false;
+static u32 s_recCacheResets = 0;
+static u32 s_recCacheEvictions = 0;
+
 static u32* recConstBuf = NULL;			// 64-bit pseudo-immediates
 static BASEBLOCK *recRAM = NULL;		// and the ptr to the blocks here
 static BASEBLOCK *recROM = NULL;		// and here
@@ -317,6 +330,8 @@ void recCall( void (*func)() )
 static void __fastcall recRecompile( const u32 startpc );
 static void __fastcall dyna_block_discard(u32 start,u32 sz);
 static void __fastcall dyna_page_reset(u32 start,u32 sz);
+static void __fastcall recHotBlock(u32 startpc);
+static void __fastcall recValidatePage(u32 startpc);
 
 // Recompiled code buffer for EE recompiler dispatchers!
 static u8 __pagealigned eeRecDispatchers[__pagesize];
@@ -331,10 +346,18 @@ static DynGenFunc* EnterRecompiledCode	= NULL;
 static DynGenFunc* ExitRecompiledCode	= NULL;
 static DynGenFunc* DispatchBlockDiscard = NULL;
 static DynGenFunc* DispatchPageReset    = NULL;
+static DynGenFunc* DispatchHotBlock     = NULL;
+static DynGenFunc* JITValidate          = NULL;
+
+extern void dynarecMemcheck();
 
 static void recEventTest()
 {
 	_cpuEventTest_Shared();
+
+	// A load or store to a watched memcheck page during the last block.
+	if (CBreakPoints::CheckMemcheckBreak())
+		dynarecMemcheck();
 }
 
 // The address for all cleared blocks.  It recompiles the current pc and then
@@ -426,6 +449,26 @@ static DynGenFunc* _DynGen_DispatchPageReset()
 	return (DynGenFunc*)retval;
 }
 
+// Entered from the prologue of a split block whose execution counter ran out, with the
+// block's startpc in ecx.  The block is thrown away and recompiled as a superblock.
+static DynGenFunc* _DynGen_DispatchHotBlock()
+{
+	u8* retval = xGetPtr();
+	xFastCall((void*)recHotBlock, ecx);
+	xJMP((void*)DispatcherReg);
+	return (DynGenFunc*)retval;
+}
+
+// The address for blocks of a suspended page (see recSuspendPage).  Validates the page and
+// then dispatches to whatever the current pc's block is afterwards.
+static DynGenFunc* _DynGen_JITValidate()
+{
+	u8* retval = xGetPtr();
+	xFastCall((void*)recValidatePage, ptr[&cpuRegs.pc]);
+	xJMP((void*)DispatcherReg);
+	return (DynGenFunc*)retval;
+}
+
 static void _DynGen_Dispatchers()
 {
 	// In case init gets called multiple times:
@@ -446,6 +489,8 @@ static void _DynGen_Dispatchers()
 	EnterRecompiledCode  = _DynGen_EnterRecompiledCode();
 	DispatchBlockDiscard = _DynGen_DispatchBlockDiscard();
 	DispatchPageReset    = _DynGen_DispatchPageReset();
+	DispatchHotBlock     = _DynGen_DispatchHotBlock();
+	JITValidate          = _DynGen_JITValidate();
 
 	HostSys::MemProtectStatic( eeRecDispatchers, PageAccess_ExecOnly() );
 
@@ -578,6 +623,7 @@ static int g_patchesNeedRedo = 0;
 static void recResetRaw()
 {
 	Perf::ee.reset();
+	RecProfiler::ResetBlocks(RecProfiler::Source_EE);
 
 	EE::Profiler.Reset();
 
@@ -607,6 +653,10 @@ static void recResetRaw()
 	recPtr = *recMem;
 	recConstBufPtr = recConstBuf;
 
+	s_recSegment = 0;
+	s_recCacheWrapped = false;
+	s_recCacheResets++;
+
 	g_branch = 0;
 	g_resetEeScalingStats = true;
 	g_patchesNeedRedo = 1;
@@ -720,6 +770,9 @@ static void recExecute()
 	else
 	{
 		pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, &oldstate );
+
+		// The longjmp may have skipped recRecompile's scope.
+		vtlb_WatchMuted = false;
 	}
 
 	if(m_cpuException)	m_cpuException->Rethrow();
@@ -1492,6 +1545,114 @@ void __fastcall dyna_page_reset(u32 start,u32 sz)
 	mmap_MarkCountedRamPage( start );
 }
 
+// --------------------------------------------------------------------------------------
+//  Block tiering
+// --------------------------------------------------------------------------------------
+// Blocks are normally cut short when the scan runs into the start of a block that has
+// already been compiled, which keeps the first compile cheap but leaves hot loops split
+// into a chain of small blocks (each flushing all registers and doing a cycle update at
+// the seam).  With EnableEETiering, such split blocks count down their executions, and
+// once the count runs out they are recompiled as a single block running up to the real
+// branch; the inner blocks stay valid as separate entry points.
+
+static const u32 HotBlockThreshold = 1024;
+
+// HWADDR of the block recHotBlock asked to be recompiled as a superblock, or -1.
+static u32 s_hotRecompilePc = (u32)-1;
+
+void __fastcall recHotBlock(u32 startpc)
+{
+	BASEBLOCKEX* pexblock = recBlocks.Get(HWADDR(startpc));
+	if (!pexblock || pexblock->startpc != HWADDR(startpc))
+		return;
+
+	eeRecPerfLog.Write( "Hot block @ 0x%08X  [size=%d insts]", startpc, pexblock->size );
+
+	// Not compiling anything right now; make sure recClear doesn't skip a stale block.
+	s_pCurBlock = NULL;
+	s_hotRecompilePc = HWADDR(startpc);
+	recClear(startpc, pexblock->size);
+}
+
+// --------------------------------------------------------------------------------------
+//  Suspended pages
+// --------------------------------------------------------------------------------------
+// A write-protected page that took a write outside of its code is suspended instead of
+// cleared: its blocks stay compiled, but their entry points (and any static links to them)
+// go through JITValidate.  The first of them to run checks every suspended block of the
+// page against the code it was compiled from, clears the ones that changed, and puts the
+// page back under write protection.
+
+static void recSuspendPage(u32 addr)
+{
+	u32 page = HWADDR(addr) & ~0xfffUL;
+	int blockidx = recBlocks.LastIndex(page + 0xffc);
+	BASEBLOCKEX* pexblock;
+
+	while (pexblock = recBlocks[blockidx--])
+	{
+		if (pexblock->startpc < page)
+			break;
+		if (pexblock->startpc > page + 0xffc)
+			continue;
+
+		BASEBLOCK* pblock = PC_GETBLOCK(pexblock->startpc);
+		if (pblock->GetFnptr() != pexblock->fnptr)
+			continue;
+
+		pblock->SetFnptr((uptr)JITValidate);
+		recBlocks.Relink(pexblock->startpc, (uptr)JITValidate);
+	}
+
+	eeRecPerfLog.Write( "Suspended page @ 0x%05x", page >> 12 );
+}
+
+void __fastcall recValidatePage(u32 startpc)
+{
+	u32 page = HWADDR(startpc) & ~0xfffUL;
+	int blockidx = recBlocks.LastIndex(page + 0xffc);
+	int cleared = 0;
+	BASEBLOCKEX* pexblock;
+
+	// Not compiling anything right now; make sure recClear doesn't skip a stale block.
+	s_pCurBlock = NULL;
+
+	while (pexblock = recBlocks[blockidx--])
+	{
+		if (pexblock->startpc < page)
+			break;
+		if (pexblock->startpc > page + 0xffc)
+			continue;
+
+		BASEBLOCK* pblock = PC_GETBLOCK(pexblock->startpc);
+		if (pblock->GetFnptr() != (uptr)JITValidate)
+			continue;
+
+		if (memcmp(&recRAMCopy[pexblock->startpc], PSM(pexblock->startpc), pexblock->size * 4) == 0)
+		{
+			pblock->SetFnptr(pexblock->fnptr);
+			recBlocks.Relink(pexblock->startpc, pexblock->fnptr);
+		}
+		else
+		{
+			// recClear shuffles the block list, so start over (validated blocks are skipped).
+			pblock->SetFnptr((uptr)JITCompile);
+			recBlocks.Relink(pexblock->startpc, (uptr)JITCompile);
+			recClear(pexblock->startpc, pexblock->size);
+			blockidx = recBlocks.LastIndex(page + 0xffc);
+			cleared++;
+		}
+	}
+
+	eeRecPerfLog.Write( "Validated page @ 0x%05x : %d blocks cleared", page >> 12, cleared );
+
+	if (mmap_GetRamPageInfo(page) == ProtMode_Manual)
+	{
+		mmap_MarkCountedRamPage(page);
+		manual_page[page >> 12] = 0;
+	}
+}
+
 static void memory_protect_recompiled_code(u32 startpc, u32 size)
 {
 	u32 inpage_ptr = HWADDR(startpc);
@@ -1504,6 +1665,9 @@ static void memory_protect_recompiled_code(u32 startpc, u32 size)
 	// note: blocks are guaranteed to reside within the confines of a single page.
 	const vtlb_ProtectionMode PageType = contains_thread_stack ? ProtMode_Manual : mmap_GetRamPageInfo( inpage_ptr );
 
+	if (PageType != ProtMode_NotRequired && inpage_sz)
+		mmap_MarkCodeRange( inpage_ptr, inpage_sz );
+
     switch (PageType)
     {
         case ProtMode_NotRequired:
@@ -1609,11 +1773,51 @@ void doPlace0Patches()
     ApplyLoadedPatches(PPT_ONCE_ON_LOAD);
 }
 
+static __fi uptr recSegmentSize()
+{
+	return ((recMem->GetPtrEnd() - recMem->GetPtr()) / RecCacheSegments) & ~(__pagesize - 1);
+}
+
+// Moves recPtr to the start of the next cache segment, evicting the blocks it holds.
+static void recNextSegment()
+{
+	s_recSegment = (s_recSegment + 1) % RecCacheSegments;
+	if (s_recSegment == 0)
+		s_recCacheWrapped = true;
+
+	u8* begin = recMem->GetPtr() + s_recSegment * recSegmentSize();
+	recPtr = begin;
+
+	if (!s_recCacheWrapped)
+		return;
+
+	uptr end = (uptr)begin + recSegmentSize();
+
+	RecProfiler::UnmapRange(RecProfiler::Source_EE, (uptr)begin, end);
+
+	int evicted = recBlocks.Evict((uptr)begin, end, recLUT);
+	s_recCacheEvictions++;
+
+	DevCon.WriteLn( Color_StrongBlack, "EE/iR5900-32 Recompiler: evicted cache segment %u (%d blocks)  [%u evictions, %u resets]",
+		s_recSegment, evicted, s_recCacheEvictions, s_recCacheResets );
+}
+
+static u32 recFetchOpcode( u32 pc )
+{
+	return *(u32*)PSM(pc);
+}
+
 static void __fastcall recRecompile( const u32 startpc )
 {
+	Instrumentation::ScopedTimer compileTimer( Instrumentation::Counter_EERecCompile );
+
+	// Reading the code isn't an access that memchecks should see.
+	ScopedBool muteWatches( vtlb_WatchMuted );
+
 	u32 i = 0;
 	u32 willbranch3 = 0;
 	u32 usecop2;
+	bool splitAtBlock = false;
 
 #ifdef PCSX2_DEBUG
     if (dumplog & 4) iDumpRegisters(startpc, 0);
@@ -1621,17 +1825,18 @@ static void __fastcall recRecompile( const u32 startpc )
 
 	pxAssert( startpc );
 
-	// if recPtr reached the mem limit reset whole mem
-	if (recPtr >= (recMem->GetPtrEnd() - _64kb)) {
-		eeRecNeedsReset = true;
-	}
-	else if ((recConstBufPtr - recConstBuf) >= RECCONSTBUF_SIZE - 64) {
+	// if recPtr reached the end of its segment, make room in the next one.  Running out of
+	// 64 bit constants still needs a full reset, since they are shared by all the blocks.
+	if ((recConstBufPtr - recConstBuf) >= RECCONSTBUF_SIZE - 64) {
 		Console.WriteLn("EE recompiler stack reset");
 		eeRecNeedsReset = true;
 	}
 
 	if (eeRecNeedsReset) recResetRaw();
 
+	if (recPtr >= recMem->GetPtr() + (s_recSegment + 1) * recSegmentSize() - _64kb)
+		recNextSegment();
+
 	xSetPtr( recPtr );
 	recPtr = xGetAlignedCallTarget();
 
@@ -1651,12 +1856,7 @@ static void __fastcall recRecompile( const u32 startpc )
 	pxAssert(s_pCurBlockEx);
 
 	if (HWADDR(startpc) == EELOAD_START)
-	{
-		// The EELOAD _start function is the same across all BIOS versions
-		u32 mainjump = memRead32(EELOAD_START + 0x9c);
-		if (mainjump >> 26 == 3) // JAL
-			g_eeloadMain = ((EELOAD_START + 0xa0) & 0xf0000000U) | (mainjump << 2 & 0x0fffffffU);
-	}
+		eeloadFindMain();
 
 	if (g_eeloadMain && HWADDR(startpc) == HWADDR(g_eeloadMain))
 	{
@@ -1702,6 +1902,9 @@ static void __fastcall recRecompile( const u32 startpc )
 
 	g_branch = 0;
 
+	const bool hotRecompile = (HWADDR(startpc) == s_hotRecompilePc);
+	s_hotRecompilePc = (u32)-1;
+
 	// reset recomp state variables
 	s_nBlockCycles = 0;
 	pc = startpc;
@@ -1768,9 +1971,10 @@ static void __fastcall recRecompile( const u32 startpc )
 				break;
 			}
 
-			if (pblock->GetFnptr() != (uptr)JITCompile && pblock->GetFnptr() != (uptr)JITCompileInBlock)
+			if (!hotRecompile && pblock->GetFnptr() != (uptr)JITCompile && pblock->GetFnptr() != (uptr)JITCompileInBlock)
 			{
 				willbranch3 = 1;
+				splitAtBlock = true;
 				s_nEndBlock = i;
 				break;
 			}
@@ -1852,76 +2056,7 @@ StartRecomp:
 	// timeout on a register read.  AFAICS the only way to optimise this for non-const cases
 	// without a significant loss in cycle accuracy is with a division, but games would probably
 	// be happy with time wasting loops completing in 0 cycles and timeouts waiting forever.
-	s_nBlockFF = false;
-	if (s_branchTo == startpc) {
-		s_nBlockFF = true;
-
-		u32 reads = 0, loads = 1;
-
-		for (i = startpc; i < s_nEndBlock; i += 4) {
-			if (i == s_nEndBlock - 8)
-				continue;
-			cpuRegs.code = *(u32*)PSM(i);
-			// nop
-			if (cpuRegs.code == 0)
-				continue;
-			// cache, sync
-			else if (_Opcode_ == 057 || _Opcode_ == 0 && _Funct_ == 017)
-				continue;
-			// imm arithmetic
-			else if ((_Opcode_ & 070) == 010 || (_Opcode_ & 076) == 030)
-			{
-				if (loads & 1 << _Rs_) {
-					loads |= 1 << _Rt_;
-					continue;
-				}
-				else
-					reads |= 1 << _Rs_;
-				if (reads & 1 << _Rt_) {
-					s_nBlockFF = false;
-					break;
-				}
-			}
-			// common register arithmetic instructions
-			else if (_Opcode_ == 0 && (_Funct_ & 060) == 040 && (_Funct_ & 076) != 050)
-			{
-				if (loads & 1 << _Rs_ && loads & 1 << _Rt_) {
-					loads |= 1 << _Rd_;
-					continue;
-				}
-				else
-					reads |= 1 << _Rs_ | 1 << _Rt_;
-				if (reads & 1 << _Rd_) {
-					s_nBlockFF = false;
-					break;
-				}
-			}
-			// loads
-			else if ((_Opcode_ & 070) == 040 || (_Opcode_ & 076) == 032 || _Opcode_ == 067)
-			{
-				if (loads & 1 << _Rs_) {
-					loads |= 1 << _Rt_;
-					continue;
-				}
-				else
-					reads |= 1 << _Rs_;
-				if (reads & 1 << _Rt_) {
-					s_nBlockFF = false;
-					break;
-				}
-			}
-			// mfc*, cfc*
-			else if ((_Opcode_ & 074) == 020 && _Rs_ < 4)
-			{
-				loads |= 1 << _Rt_;
-			}
-			else
-			{
-				s_nBlockFF = false;
-				break;
-			}
-		}
-	}
+	s_nBlockFF = (s_branchTo == startpc) && MIPSAnalyst::IsIdleLoop(startpc, s_nEndBlock, recFetchOpcode);
 
 	// rec info //
 	{
@@ -2015,6 +2150,19 @@ StartRecomp:
 	// Detect and handle self-modified code
 	memory_protect_recompiled_code(startpc, (s_nEndBlock-startpc) >> 2);
 
+	if (splitAtBlock && EmuConfig.Cpu.Recompiler.EnableEETiering)
+	{
+		u32* counter = recConstBufPtr;
+		recConstBufPtr += 2;		// keep the 64 bit constants in the buffer aligned
+		*counter = HotBlockThreshold;
+
+		xSUB(ptr32[counter], 1);
+		xForwardJNZ8 notHot;
+		xMOV(ecx, startpc);
+		xJMP((void*)DispatchHotBlock);
+		notHot.SetTarget();
+	}
+
 	// Skip Recompilation if sceMpegIsEnd Pattern detected
 	bool doRecompilation = !skipMPEG_By_Pattern(startpc);
 
@@ -2046,7 +2194,7 @@ StartRecomp:
 			if ((oldBlock->startpc + oldBlock->size * 4) <= HWADDR(startpc))
 				break;
 
-			if (memcmp(&recRAMCopy[oldBlock->startpc / 4], PSM(oldBlock->startpc),
+			if (memcmp(&recRAMCopy[oldBlock->startpc], PSM(oldBlock->startpc),
 			           oldBlock->size * 4))
 			{
 				recClear(startpc, (pc - startpc) / 4);
@@ -2056,7 +2204,7 @@ StartRecomp:
 			}
 		}
 
-		memcpy(&recRAMCopy[HWADDR(startpc) / 4], PSM(startpc), pc - startpc);
+		memcpy(&recRAMCopy[HWADDR(startpc)], PSM(startpc), pc - startpc);
 	}
 
 	s_pCurBlock->SetFnptr((uptr)recPtr);
@@ -2107,6 +2255,9 @@ StartRecomp:
 		}
 	}
 
+	// Out-of-line stubs for the indirect memory accesses of this block.
+	vtlb_DynGenFlushStubs();
+
 	pxAssert( xGetPtr() < recMem->GetPtrEnd() );
 	pxAssert( recConstBufPtr < recConstBuf + RECCONSTBUF_SIZE );
 
@@ -2120,6 +2271,7 @@ StartRecomp:
 	}
 #endif
 	Perf::ee.map(s_pCurBlockEx->fnptr, s_pCurBlockEx->x86size, s_pCurBlockEx->startpc);
+	RecProfiler::MapBlock(RecProfiler::Source_EE, s_pCurBlockEx->fnptr, s_pCurBlockEx->x86size, s_pCurBlockEx->startpc);
 
 	recPtr = xGetPtr();
 
@@ -2177,6 +2329,7 @@ R5900cpu recCpu =
 	recThrowException,
 	recThrowException,
 	recClear,
+	recSuspendPage,
 
 	recGetCacheReserve,
 	recSetCacheReserve,
@@ -20,6 +20,7 @@
 #include "R5900OpcodeTables.h"
 #include "iR5900LoadStore.h"
 #include "iR5900.h"
+#include "MTVU.h"
 
 using namespace x86Emitter;
 
@@ -573,6 +574,11 @@ void recSWC1()
 
 void recLQC2()
 {
+	if (THREAD_VU0) {
+		iFlushCall(FLUSH_EVERYTHING);
+		xFastCall((void*)vu0ThreadWaitJIT);
+	}
+
 #ifndef DISABLE_SVU
 	_deleteVFtoXMMreg(_Ft_, 0, 2);
 #endif
@@ -606,6 +612,11 @@ void recLQC2()
 
 void recSQC2()
 {
+	if (THREAD_VU0) {
+		iFlushCall(FLUSH_EVERYTHING);
+		xFastCall((void*)vu0ThreadWaitJIT);
+	}
+
 #ifndef DISABLE_SVU
 	_deleteVFtoXMMreg(_Ft_, 0, 1); //Want to flush it but not clear it
 #endif
@@ -23,6 +23,8 @@
 #include "iR5900.h"
 #include "Utilities/Perf.h"
 
+#include <vector>
+
 using namespace vtlb_private;
 using namespace x86Emitter;
 
@@ -143,10 +145,9 @@ static void iMOV64_Smart( const xIndirectVoid& destRm, const xIndirectVoid& srcR
 namespace vtlb_private
 {
 	// ------------------------------------------------------------------------
-	// Prepares eax, ecx, and, ebx for Direct or Indirect operations.
-	// Returns the writeback pointer for ebx (return address from indirect handling)
+	// Prepares eax and ecx for Direct or Indirect operations.
 	//
-	static uptr* DynGen_PrepRegs()
+	static void DynGen_PrepRegs()
 	{
 		// Warning dirty ebx (in case someone got the very bad idea to move this code)
 		EE::Profiler.EmitMem();
@@ -154,11 +155,7 @@ namespace vtlb_private
 		xMOV( eax, ecx );
 		xSHR( eax, VTLB_PAGE_BITS );
 		xMOV( eax, ptr[(eax*4) + vtlbdata.vmap] );
-		xMOV( ebx, 0xcdcdcdcd );
-		uptr* writeback = ((uptr*)xGetPtr()) - 1;
 		xADD( ecx, eax );
-
-		return writeback;
 	}
 
 	// ------------------------------------------------------------------------
@@ -254,10 +251,26 @@ static u8* GetIndirectDispatcherPtr( int mode, int operandsize, int sign = 0 )
 }
 
 // ------------------------------------------------------------------------
-// Generates a JS instruction that targets the appropriate templated instance of
-// the vtlb Indirect Dispatcher.
+// Indirect accesses leave the block through an out-of-line stub that loads the return
+// address into ebx and jumps to the dispatcher.  Keeping that out of the direct access
+// path saves an instruction on every load and store that hits memory directly.  The stubs
+// are emitted after the end of the block, by vtlb_DynGenFlushStubs().
 //
-static void DynGen_IndirectDispatch( int mode, int bits, bool sign = false )
+struct IndirectStub
+{
+	s32* jump;				// rel32 of the JS to patch
+	u8* resume;				// where the dispatcher returns to
+	u8* dispatcher;
+};
+
+static std::vector<IndirectStub> s_indirectStubs;
+
+// ------------------------------------------------------------------------
+// Generates a JS instruction that targets a stub for the appropriate templated
+// instance of the vtlb Indirect Dispatcher.  Returns the stub descriptor, whose
+// resume address must be filled in after the direct access has been emitted.
+//
+static IndirectStub& DynGen_IndirectDispatch( int mode, int bits, bool sign = false )
 {
 	int szidx = 0;
 	switch( bits )
@@ -269,7 +282,29 @@ static void DynGen_IndirectDispatch( int mode, int bits, bool sign = false )
 		case 128:	szidx=4;	break;
 		jNO_DEFAULT;
 	}
-	xJS( GetIndirectDispatcherPtr( mode, szidx, sign ) );
+
+	IndirectStub stub;
+	stub.jump = xJcc32( Jcc_Signed );
+	stub.resume = NULL;
+	stub.dispatcher = GetIndirectDispatcherPtr( mode, szidx, sign );
+
+	s_indirectStubs.push_back( stub );
+	return s_indirectStubs.back();
+}
+
+void vtlb_DynGenFlushStubs()
+{
+	for (size_t i = 0; i < s_indirectStubs.size(); ++i)
+	{
+		const IndirectStub& stub = s_indirectStubs[i];
+		pxAssert( stub.resume );
+
+		*stub.jump = (s32)(xGetPtr() - (u8*)(stub.jump + 1));
+		xMOV( ebx, (uptr)stub.resume );
+		xJMP( stub.dispatcher );
+	}
+
+	s_indirectStubs.clear();
 }
 
 // ------------------------------------------------------------------------
@@ -344,12 +379,12 @@ void vtlb_DynGenRead64(u32 bits)
 {
 	pxAssume( bits == 64 || bits == 128 );
 
-	uptr* writeback = DynGen_PrepRegs();
+	DynGen_PrepRegs();
 
-	DynGen_IndirectDispatch( 0, bits );
+	IndirectStub& stub = DynGen_IndirectDispatch( 0, bits );
 	DynGen_DirectRead( bits, false );
 
-	*writeback = (uptr)xGetPtr();		// return target for indirect's call/ret
+	stub.resume = xGetPtr();		// return target for indirect's call/ret
 }
 
 // ------------------------------------------------------------------------
@@ -360,12 +395,12 @@ void vtlb_DynGenRead32(u32 bits, bool sign)
 {
 	pxAssume( bits <= 32 );
 
-	uptr* writeback = DynGen_PrepRegs();
+	DynGen_PrepRegs();
 
-	DynGen_IndirectDispatch( 0, bits, sign && bits < 32 );
+	IndirectStub& stub = DynGen_IndirectDispatch( 0, bits, sign && bits < 32 );
 	DynGen_DirectRead( bits, sign );
 
-	*writeback = (uptr)xGetPtr();
+	stub.resume = xGetPtr();
 }
 
 // ------------------------------------------------------------------------
@@ -461,10 +496,13 @@ void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const )
 			case 32:	szidx=2;	break;
 		}
 
-		// Shortcut for the INTC_STAT register, which many games like to spin on heavily.
-		if( (bits == 32) && !EmuConfig.Speedhacks.IntcStat && (paddr == INTC_STAT) )
+		// Shortcut for the registers that games like to spin on heavily (INTC_STAT, D_STAT,
+		// the channel and unit status registers), when reading them has no side effects.
+		if( (bits == 32) && ((paddr & 0xffff0000) == 0x10000000) && hwIsPlainRead32(paddr) )
 		{
-			xMOV( eax, ptr[&psHu32( INTC_STAT )] );
+			if( hwReadStatsEnabled )
+				xADD( ptr32[&hwReadStats[(paddr & 0xffff) >> 2]], 1 );
+			xMOV( eax, ptr[&psHu32( paddr )] );
 		}
 		else
 		{
@@ -496,12 +534,12 @@ void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const )
 
 void vtlb_DynGenWrite(u32 sz)
 {
-	uptr* writeback = DynGen_PrepRegs();
+	DynGen_PrepRegs();
 
-	DynGen_IndirectDispatch( 1, sz );
+	IndirectStub& stub = DynGen_IndirectDispatch( 1, sz );
 	DynGen_DirectWrite( sz );
 
-	*writeback = (uptr)xGetPtr();
+	stub.resume = xGetPtr();
 }
 
 
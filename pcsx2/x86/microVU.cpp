@@ -19,6 +19,8 @@
 #include "microVU.h"
 
 #include "Utilities/Perf.h"
+#include "Utilities/Instrumentation.h"
+#include "DebugTools/RecProfiler.h"
 
 //------------------------------------------------------------------
 // Micro VU - Main Functions
@@ -58,6 +60,7 @@ void mVUinit(microVU& mVU, uint vuIndex) {
 	mVU.progSize		= (mVU.index ? 0x4000 : 0x1000) / 4;
 	mVU.progMemMask		=  mVU.progSize-1;
 	mVU.cacheSize		=  vuIndex ? mVU1cacheReserve : mVU0cacheReserve;
+	mVU.prog.memHash.size = mVU.progSize;
 	mVU.cache			= NULL;
 	mVU.dispCache		= NULL;
 	mVU.startFunct		= NULL;
@@ -69,11 +72,18 @@ void mVUinit(microVU& mVU, uint vuIndex) {
 	else mVU.dispCache = vu0_RecDispatchers;
 
 	mVU.regAlloc.reset(new microRegAlloc(mVU.index));
+	mVU.prog.entryHistory = new microEntryHistoryMap();
 }
 
 // Resets Rec Data
 void mVUreset(microVU& mVU, bool resetReserve) {
 
+	RecProfiler::ResetBlocks(mVU.index ? RecProfiler::Source_VU1 : RecProfiler::Source_VU0);
+	mVUprintFlagStats(mVU);
+
+	// Write out the programs of the session that is ending before their code is discarded
+	if (resetReserve) mVUsaveDiskCache(mVU);
+
 	// Restore reserve to uncommitted state
 	if (resetReserve) mVU.cache_reserve->Reset();
 
@@ -96,12 +106,14 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 	mVU.prog.cur		= NULL;
 	mVU.prog.total		=  0;
 	mVU.prog.curFrame	=  0;
+	mVU.prog.memHash.markDirty(0, mVU.microMemSize); // Micro memory may have been loaded from a savestate
 
 	// Setup Dynarec Cache Limits for Each Program
 	u8* z = mVU.cache;
 	mVU.prog.x86start	= z;
 	mVU.prog.x86ptr		= z;
 	mVU.prog.x86end		= z + ((mVU.cacheSize - mVUcacheSafeZone) * _1mb);
+	mVU.prog.x86diskEnd	= z;
 	//memset(mVU.prog.x86start, 0xcc, mVU.cacheSize*_1mb);
 
 	for(u32 i = 0; i < (mVU.progSize / 2); i++) {
@@ -118,6 +130,9 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 		mVU.prog.quick[i].prog  = NULL;
 	}
 
+	// Only restore on hard resets; a full rec-cache would otherwise just be refilled with the same code
+	if (resetReserve) mVUloadDiskCache(mVU);
+
 	HostSys::MemProtect(mVU.dispCache, mVUdispCacheSize, PageAccess_ExecOnly());
 
 	if (mVU.index) Perf::any.map((uptr)&mVU.dispCache, mVUdispCacheSize, "mVU1 Dispatcher");
@@ -127,6 +142,7 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 // Free Allocated Resources
 void mVUclose(microVU& mVU) {
 
+	mVUsaveDiskCache(mVU);
 	safe_delete  (mVU.cache_reserve);
 
 	// Delete Programs and Block Managers
@@ -138,10 +154,12 @@ void mVUclose(microVU& mVU) {
 		}
 		safe_delete(mVU.prog.prog[i]);
 	}
+	safe_delete(mVU.prog.entryHistory);
 }
 
 // Clears Block Data in specified range
 __fi void mVUclear(mV, u32 addr, u32 size) {
+	mVU.prog.memHash.markDirty(addr, size);
 	if(!mVU.prog.cleared) {
 		mVU.prog.cleared = 1;		// Next execution searches/creates a new microprogram
 		memzero(mVU.prog.lpState); // Clear pipeline state
@@ -191,6 +209,7 @@ __ri microProgram* mVUcreateProg(microVU& mVU, int startPC) {
 __ri void mVUcacheProg(microVU& mVU, microProgram& prog) {
 	if (!mVU.index)	memcpy(prog.data, mVU.regs().Micro, 0x1000);
 	else			memcpy(prog.data, mVU.regs().Micro, 0x4000);
+	prog.rangesHashValid = false;
 	mVUdumpProg(mVU, prog);
 }
 
@@ -230,6 +249,28 @@ void mVUprintUniqueRatio(microVU& mVU) {
 	DevCon.WriteLn("%d / %d [%3.1f%%]", v.size(), total, 100.-(double)v.size()/(double)total*100.);
 }
 
+// Prints how many flag instances the recompiled code updates (see mVUcountFlags)
+void mVUprintFlagStats(microVU& mVU) {
+	u32 total[4] = {0, 0, 0, 0}, progs = 0, maxInsts = 0;
+	int maxIdx = -1;
+	for(u32 pc = 0; pc < mProgSize/2; pc++) {
+		microProgramList* list = mVU.prog.prog[pc];
+		if (!list) continue;
+		std::deque<microProgram*>::iterator it(list->begin());
+		for ( ; it != list->end(); ++it) {
+			const u32* stats = it[0]->flagStats;
+			const u32  insts = stats[1] + stats[2] + stats[3];
+			for(int i = 0; i < 4; i++) total[i] += stats[i];
+			if (insts > maxInsts) { maxInsts = insts; maxIdx = it[0]->idx; }
+			progs++;
+		}
+	}
+	if (!total[0]) return;
+	DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta,
+		"microVU%d: Flag instances over %u ops in %u progs: status = %u, mac = %u, clip = %u (most in prog [%03d] = %u)",
+		mVU.index, total[0], progs, total[1], total[2], total[3], maxIdx, maxInsts);
+}
+
 // Compare partial program by only checking compiled ranges...
 __ri bool mVUcmpPartial(microVU& mVU, microProgram& prog) {
 	std::deque<microRange>::const_iterator it(prog.ranges->begin());
@@ -242,6 +283,39 @@ __ri bool mVUcmpPartial(microVU& mVU, microProgram& prog) {
 	return 1;
 }
 
+// Gets the word range of micro memory compared by mVUcmpPartial for a range (false if still being compiled)
+static __fi bool mVUrangeWords(microVU& mVU, const microRange& range, u32& start, u32& end) {
+	if ((range.start < 0) || (range.end < range.start)) return false;
+	start = range.start / 4;
+	end   = std::min<u32>((range.end + 8) / 4, mVU.progSize);
+	return true;
+}
+
+// Returns true if the hash of prog's ranges shows it can't match the current micro memory
+// (mVU.prog.memHash must be refreshed). Unhashable programs are never rejected.
+__fi bool mVUhashRejectProg(microVU& mVU, microProgram& prog) {
+	u32 start, end;
+	if (!prog.rangesHashValid) {
+		u64 hash = 0;
+		std::deque<microRange>::const_iterator it(prog.ranges->begin());
+		for ( ; it != prog.ranges->end(); ++it) {
+			if (!mVUrangeWords(mVU, it[0], start, end)) return false;
+			for (u32 i = start; i < end; i++) {
+				hash += microMemHash::hashWord(i, prog.data[i]);
+			}
+		}
+		prog.rangesHash		 = hash;
+		prog.rangesHashValid = true;
+	}
+	u64 hash = 0;
+	std::deque<microRange>::const_iterator it(prog.ranges->begin());
+	for ( ; it != prog.ranges->end(); ++it) {
+		mVUrangeWords(mVU, it[0], start, end);
+		hash += mVU.prog.memHash.rangeSum(start, end);
+	}
+	return hash != prog.rangesHash;
+}
+
 // Compare Cached microProgram to mVU.regs().Micro
 __fi bool mVUcmpProg(microVU& mVU, microProgram& prog, const bool cmpWholeProg) {
 	if ((cmpWholeProg && !memcmp_mmx((u8*)prog.data, mVU.regs().Micro, mVU.microMemSize))
@@ -254,15 +328,52 @@ __fi bool mVUcmpProg(microVU& mVU, microProgram& prog, const bool cmpWholeProg)
 	return false;
 }
 
+// Records startPC as an entry point of the current micro memory image (mVU.prog.memHash must be
+// refreshed), and gives the other entry points seen for the same image quick-references into
+// mVU.prog.cur, compiling their blocks if the program doesn't have them yet.
+static void mVUspeculateEntries(microVU& mVU, u32 startPC, uptr pState) {
+	if (!doSpeculativeEntries) return;
+	microEntryHistoryMap& map = *mVU.prog.entryHistory;
+	const u64 hash = mVU.prog.memHash.prefix(mVU.progSize);
+	if (map.size() >= mVUentryHistoryMax && map.find(hash) == map.end()) {
+		map.clear();
+	}
+	microEntryHistory& history = map[hash];
+	bool known = false;
+	for (u32 i = 0; i < history.count; i++) {
+		if (history.pc[i] == startPC/8) known = true;
+	}
+	if (!known && history.count < microEntryHistory::maxEntries) {
+		history.pc[history.count++] = startPC/8;
+	}
+
+	// Blocks resuming from a partially executed state only cover one instruction
+	if (((microRegInfo*)pState)->blockType) return;
+
+	microProgram& prog = *mVU.prog.cur;
+	for (u32 i = 0; i < history.count; i++) {
+		const u32 pc = history.pc[i];
+		microProgramQuick& quick = mVU.prog.quick[pc];
+		if (pc == startPC/8 || quick.prog) continue;
+		if (!prog.block[pc]) mVUblockFetch(mVU, pc * 8, pState);
+		quick.block = prog.block[pc];
+		quick.prog  = &prog;
+	}
+}
+
 // Searches for Cached Micro Program and sets prog.cur to it (returns entry-point to program)
 _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 	microVU& mVU = mVUx;
 	microProgramQuick& quick = mVU.prog.quick[startPC/8];
 	microProgramList*  list  = mVU.prog.prog [startPC/8];
 	if(!quick.prog) { // If null, we need to search for new program
+		mVU.prog.memHash.refresh((u32*)mVU.regs().Micro);
+		mVU.profiler.Search();
 		std::deque<microProgram*>::iterator it(list->begin());
 		for ( ; it != list->end(); ++it) {
-			bool b = mVUcmpProg(mVU, *it[0], 0);
+			bool b = false;
+			if (mVUhashRejectProg(mVU, *it[0])) mVU.profiler.HashReject();
+			else { mVU.profiler.Compare(); b = mVUcmpProg(mVU, *it[0], 0); }
 			if (EmuConfig.Gamefixes.ScarfaceIbit) {
 				if (isVU1 && ((((u32*)mVU.regs().Micro)[startPC / 4 + 1]) == 0x80200118) &&
 						     ((((u32*)mVU.regs().Micro)[startPC / 4 + 3]) == 0x81000062)) {
@@ -287,6 +398,7 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 				quick.prog  = it[0];
 				list->erase(it);
 				list->push_front(quick.prog);
+				mVUspeculateEntries(mVU, startPC, pState);
 				return mVUentryGet(mVU, quick.block, startPC, pState);
 			}
 		}
@@ -299,6 +411,7 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 		quick.block			= mVU.prog.cur->block[startPC/8];
 		quick.prog			= mVU.prog.cur;
 		list->push_front(mVU.prog.cur);
+		mVUspeculateEntries(mVU, startPC, pState);
 		//mVUprintUniqueRatio(mVU);
 		return entryPoint;
 	}
@@ -313,12 +426,14 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 //------------------------------------------------------------------
 recMicroVU0::recMicroVU0()		  { m_Idx = 0; IsInterpreter = false; }
 recMicroVU1::recMicroVU1()		  { m_Idx = 1; IsInterpreter = false; }
-void recMicroVU0::Vsync() noexcept { mVUvsyncUpdate(microVU0); }
+void recMicroVU0::Vsync() noexcept { vu0Thread.WaitVU(); mVUvsyncUpdate(microVU0); }
 void recMicroVU1::Vsync() noexcept { mVUvsyncUpdate(microVU1); }
 
 void recMicroVU0::Reserve() {
-	if (m_Reserved.exchange(1) == 0)
+	if (m_Reserved.exchange(1) == 0) {
 		mVUinit(microVU0, 0);
+		vu0Thread.Start();
+	}
 }
 void recMicroVU1::Reserve() {
 	if (m_Reserved.exchange(1) == 0) {
@@ -328,8 +443,10 @@ void recMicroVU1::Reserve() {
 }
 
 void recMicroVU0::Shutdown() noexcept {
-	if (m_Reserved.exchange(0) == 1)
+	if (m_Reserved.exchange(0) == 1) {
+		vu0Thread.WaitVU();
 		mVUclose(microVU0);
+	}
 }
 void recMicroVU1::Shutdown() noexcept {
 	if (m_Reserved.exchange(0) == 1) {
@@ -340,6 +457,7 @@ void recMicroVU1::Shutdown() noexcept {
 
 void recMicroVU0::Reset() {
 	if(!pxAssertDev(m_Reserved, "MicroVU0 CPU Provider has not been reserved prior to reset!")) return;
+	vu0Thread.WaitVU();
 	mVUreset(microVU0, true);
 }
 void recMicroVU1::Reset() {
@@ -351,14 +469,14 @@ void recMicroVU1::Reset() {
 void recMicroVU0::Execute(u32 cycles) {
 	pxAssert(m_Reserved); // please allocate me first! :|
 
-	if(!(VU0.VI[REG_VPU_STAT].UL & 1)) return;
+	if(!(microVU0.getVPUStat() & 1)) return;
 
 	// Sometimes games spin on vu0, so be careful with this value
 	// woody hangs if too high on sVU (untested on mVU)
 	// Edit: Need to test this again, if anyone ever has a "Woody" game :p
 	((mVUrecCall)microVU0.startFunct)(VU0.VI[REG_TPC].UL, cycles);
 
-	if(microVU0.regs().flags & 0x4)
+	if(!THREAD_VU0 && (microVU0.regs().flags & 0x4)) // MTVU0 raises it when the EE syncs
 	{
 		microVU0.regs().flags &= ~0x4;
 		hwIntcIrq(6);
@@ -381,6 +499,7 @@ void recMicroVU1::Execute(u32 cycles) {
 
 void recMicroVU0::Clear(u32 addr, u32 size) {
 	pxAssert(m_Reserved); // please allocate me first! :|
+	vu0Thread.WaitVU();
 	mVUclear(microVU0, addr, size);
 }
 void recMicroVU1::Clear(u32 addr, u32 size) {
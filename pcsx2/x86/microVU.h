@@ -23,6 +23,7 @@ using namespace x86Emitter;
 #include <deque>
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include "Common.h"
 #include "VU.h"
 #include "MTVU.h"
@@ -118,6 +119,10 @@ public:
 		}
 		return NULL;
 	}
+	void getBlocks(std::vector<microBlock*>& blocks) {
+		for(microBlockLink* linkI = qBlockList; linkI != NULL; linkI = linkI->next) blocks.push_back(&linkI->block);
+		for(microBlockLink* linkI = fBlockList; linkI != NULL; linkI = linkI->next) blocks.push_back(&linkI->block);
+	}
 	void printInfo(int pc, bool printQuick) {
 		int listI = printQuick ? qListI : fListI;
 		if (listI < 7) return;
@@ -149,6 +154,9 @@ struct microProgram {
 	std::deque<microRange>* ranges;			   // The ranges of the microProgram that have already been recompiled
 	u32 startPC; // Start PC of this program
 	int idx;	 // Program index
+	u64 rangesHash;		 // microMemHash of 'data' over 'ranges' (only valid if rangesHashValid)
+	bool rangesHashValid; // Cleared whenever 'data' or 'ranges' change
+	u32 flagStats[4];	 // Instructions compiled, and the status/mac/clip flag instances they update
 };
 
 typedef std::deque<microProgram*> microProgramList;
@@ -158,6 +166,63 @@ struct microProgramQuick {
 	microProgram*		  prog;	 // The microProgram who is the owner of 'block'
 };
 
+// Additive hash of the current micro memory: the sum of a per-word hash contribution, kept in a
+// fenwick tree so the hash of any PC range can be summed in O(log n).  mVUsearchProg uses it to
+// reject cached programs without comparing their ranges.  Writes only mark 64-word chunks as
+// dirty (they are reported via mVUclear before the new data is written), and dirty chunks are
+// re-hashed right before each search.
+struct microMemHash {
+	static const u32 chunkShift = 6; // 64 words per dirty chunk
+	u64 word[mProgSize];	// Hash contribution of each word of micro memory
+	u64 tree[mProgSize+1];	// Fenwick tree over word[] (1-based)
+	u64 dirty;				// Bitmask of chunks written since the last refresh
+	u32 size;				// Words of micro memory in use (VU0 = 1024, VU1 = 4096)
+
+	static __fi u64 hashWord(u32 pc, u32 value) {
+		u64 x = ((u64)pc << 32) | value;
+		x ^= x >> 33; x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return x;
+	}
+	void markDirty(u32 addr, u32 bytes) {
+		if (!bytes || addr >= size * 4) return;
+		u32 end	  = std::min(addr + bytes, size * 4);
+		u32 first = (addr / 4) >> chunkShift;
+		u32 last  = ((end - 1) / 4) >> chunkShift;
+		for (u32 c = first; c <= last; c++) dirty |= 1ull << c;
+	}
+	void refresh(const u32* micro) {
+		for (u64 mask = dirty; mask; mask &= mask - 1) {
+			u32 c = 0;
+			while (!(mask & (1ull << c))) c++;
+			for (u32 i = c << chunkShift; i < ((c + 1) << chunkShift); i++) {
+				u64 h = hashWord(i, micro[i]);
+				if (h == word[i]) continue;
+				for (u32 j = i + 1; j <= size; j += j & (0-j)) tree[j] += h - word[i];
+				word[i] = h;
+			}
+		}
+		dirty = 0;
+	}
+	__fi u64 prefix(u32 end) const { // Sum of word[0..end)
+		u64 sum = 0;
+		for (u32 j = end; j > 0; j -= j & (0-j)) sum += tree[j];
+		return sum;
+	}
+	__fi u64 rangeSum(u32 start, u32 end) const { return prefix(end) - prefix(start); }
+};
+
+// Start PCs a micro memory image has been called at (key = microMemHash of the whole image)
+struct microEntryHistory {
+	static const u32 maxEntries = 8;
+	u32 count;
+	u16 pc[maxEntries]; // startPC/8
+};
+
+typedef std::unordered_map<u64, microEntryHistory> microEntryHistoryMap;
+static const uint mVUentryHistoryMax = 4096; // History is cleared when it grows past this many images
+
 struct microProgManager {
 	microIR<mProgSize>	IRinfo;				// IR information
 	microProgramList*	prog [mProgSize/2];	// List of microPrograms indexed by startPC values
@@ -170,7 +235,10 @@ struct microProgManager {
 	u8*					x86ptr;				// Pointer to program's recompilation code
 	u8*					x86start;			// Start of program's rec-cache
 	u8*					x86end;				// Limit of program's rec-cache
+	u8*					x86diskEnd;			// End of the code last restored from/saved to the disk cache
 	microRegInfo		lpState;			// Pipeline state from where program left off (useful for continuing execution)
+	microMemHash		memHash;			// Incremental hash of mVU.regs().Micro
+	microEntryHistoryMap* entryHistory;		// Entry points seen per micro memory image (see doSpeculativeEntries)
 };
 
 static const uint mVUdispCacheSize	= __pagesize; // Dispatcher Cache Size (in bytes)
@@ -226,6 +294,9 @@ struct microVU {
 	__fi VIFregisters& getVifRegs()	const {
 		return (index && THREAD_VU1) ? vu1Thread.vifRegs : regs().GetVifRegs();
 	}
+	__fi u32& getVPUStat() const { // MTVU0 keeps VU0's busy/flag bits in its own copy
+		return (!index && THREAD_VU0) ? vu0Thread.stat : VU0.VI[REG_VPU_STAT].UL;
+	}
 };
 
 // microVU rec structs
@@ -250,6 +321,9 @@ mVUop(mVUopL);
 // Private Functions
 extern void  mVUcacheProg (microVU& mVU, microProgram&  prog);
 extern void  mVUdeleteProg(microVU& mVU, microProgram*& prog);
+extern void  mVUprintFlagStats(microVU& mVU);
+extern void  mVUsaveDiskCache(microVU& mVU);
+extern void  mVUloadDiskCache(microVU& mVU);
 _mVUt extern void* mVUsearchProg(u32 startPC, uptr pState);
 extern void* __fastcall mVUexecuteVU0(u32 startPC, u32 cycles);
 extern void* __fastcall mVUexecuteVU1(u32 startPC, u32 cycles);
@@ -282,3 +356,4 @@ void sortVector(T& v) {
 #include "microVU_Compile.inl"
 #include "microVU_Execute.inl"
 #include "microVU_Macro.inl"
+#include "microVU_Cache.inl"
@@ -79,8 +79,9 @@ void mVUDTendProgram(mV, microFlagCycles* mFC, int isEbit) {
 
 	if (isEbit || isVU1) { // Clear 'is busy' Flags
 		if (!mVU.index || !THREAD_VU1) {
-			xAND(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? ~0x100 : ~0x001)); // VBS0/VBS1 flag
-			xAND(ptr32[&mVU.getVifRegs().stat], ~VIF1_STAT_VEW); // Clear VU 'is busy' signal for vif
+			xAND(ptr32[&mVU.getVPUStat()], (isVU1 ? ~0x100 : ~0x001)); // VBS0/VBS1 flag
+			if (mVU.index || !THREAD_VU0) // MTVU0 clears it when the EE syncs
+				xAND(ptr32[&mVU.getVifRegs().stat], ~VIF1_STAT_VEW); // Clear VU 'is busy' signal for vif
 		}
 	}
 
@@ -140,7 +141,7 @@ void mVUendProgram(mV, microFlagCycles* mFC, int isEbit) {
 
 	if (isEbit || isVU1) { // Clear 'is busy' Flags
 		if (!mVU.index || !THREAD_VU1) {
-			xAND(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? ~0x100 : ~0x001)); // VBS0/VBS1 flag
+			xAND(ptr32[&mVU.getVPUStat()], (isVU1 ? ~0x100 : ~0x001)); // VBS0/VBS1 flag
 			//xAND(ptr32[&mVU.getVifRegs().stat], ~VIF1_STAT_VEW); // Clear VU 'is busy' signal for vif
 		}
 	}
@@ -151,6 +152,17 @@ void mVUendProgram(mV, microFlagCycles* mFC, int isEbit) {
 	}
 }
 
+// Returns the loop entry of the current block if it keeps loop regs, and they are all still
+// cached; the back-edge can then skip their loads. Call before mVUsetupBranch() flushes them.
+__fi u8* mVUloopEntry(mV) {
+	microLoopRegs& loop = mVU.prog.IRinfo.loopRegs;
+	if (!loop.entry) return NULL;
+	for (int i = 0; i < loop.count; i++) {
+		if (!mVU.regAlloc->isCachedReg(loop.xmm[i], loop.VFreg[i])) return NULL;
+	}
+	return loop.entry;
+}
+
 // Recompiles Code for Proper Flags and Q/P regs on Block Linkings
 void mVUsetupBranch(mV, microFlagCycles& mFC) {
 	
@@ -161,11 +173,13 @@ void mVUsetupBranch(mV, microFlagCycles& mFC) {
 	if (mVU.p || mVU.q) { xPSHUF.D(xmmPQ, xmmPQ, shufflePQ); }
 }
 
-void normBranchCompile(microVU& mVU, u32 branchPC) {
+// loopEntry is used instead of the entry point when the branch is to the current block
+void normBranchCompile(microVU& mVU, u32 branchPC, u8* loopEntry = NULL) {
 	microBlock* pBlock;
 	blockCreate(branchPC/8);
 	pBlock = mVUblocks[branchPC/8]->search((microRegInfo*)&mVUregs);
-	if (pBlock)	{ xJMP(pBlock->x86ptrStart); }
+	if (pBlock && loopEntry && (pBlock == mVUpBlock)) { xJMP(loopEntry); }
+	else if (pBlock) { xJMP(pBlock->x86ptrStart); }
 	else		{ mVUcompile(mVU, branchPC, (uptr)&mVUregs); }
 }
 
@@ -182,6 +196,7 @@ void normJumpCompile(mV, microFlagCycles& mFC, bool isEvilJump) {
 	else				xMOV(gprT2, ptr32[&mVU.branch]);
 	if (doJumpCaching)	xMOV(gprT3, (uptr)mVUpBlock);
 	else				xMOV(gprT3, (uptr)&mVUpBlock->pStateEnd);
+	mVUpBlock->jumpFixup = xGetPtr() - sizeof(u32); // Heap pointer, patched when restored from disk
 
 	if(mVUup.eBit && isEvilJump)// E-bit EvilJump
 	{
@@ -207,7 +222,7 @@ void normBranch(mV, microFlagCycles& mFC) {
 		u32 tempPC = iPC;
 		xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x400 : 0x4));
 		xForwardJump32 eJMP(Jcc_Zero);
-		xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x200 : 0x2));
+		xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x200 : 0x2));
 		xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 		iPC = branchAddr(mVU)/4;
 		mVUDTendProgram(mVU, &mFC, 1);
@@ -219,7 +234,7 @@ void normBranch(mV, microFlagCycles& mFC) {
 		u32 tempPC = iPC;
 		xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x800 : 0x8));
 		xForwardJump32 eJMP(Jcc_Zero);
-		xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x400 : 0x4));
+		xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x400 : 0x4));
 		xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 		iPC = branchAddr(mVU)/4;
 		mVUDTendProgram(mVU, &mFC, 1);
@@ -251,8 +266,9 @@ void normBranch(mV, microFlagCycles& mFC) {
 	}
 	
 	// Normal Branch
+	u8* loopEntry = mVUloopEntry(mVU);
 	mVUsetupBranch(mVU, mFC);
-	normBranchCompile(mVU, branchAddr(mVU));
+	normBranchCompile(mVU, branchAddr(mVU), loopEntry);
 }
 
 //Messy handler warning!!
@@ -296,6 +312,7 @@ void condJumpProcessingEvil(mV, microFlagCycles& mFC, int JMPcc) {
 
 }
 void condBranch(mV, microFlagCycles& mFC, int JMPcc) {
+	u8* loopEntry = mVUloopEntry(mVU);
 	mVUsetupBranch(mVU, mFC);
 	
 	if (mVUup.tBit)
@@ -303,7 +320,7 @@ void condBranch(mV, microFlagCycles& mFC, int JMPcc) {
 		u32 tempPC = iPC;
 		xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x800 : 0x8));
 		xForwardJump32 eJMP(Jcc_Zero);
-		xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x400 : 0x4));
+		xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x400 : 0x4));
 		xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 		mVUDTendProgram(mVU, &mFC, 2);
 		xCMP(ptr16[&mVU.branch], 0);
@@ -324,7 +341,7 @@ void condBranch(mV, microFlagCycles& mFC, int JMPcc) {
 		u32 tempPC = iPC;
 		xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x400 : 0x4));
 		xForwardJump32 eJMP(Jcc_Zero);
-		xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x200 : 0x2));
+		xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x200 : 0x2));
 		xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 		mVUDTendProgram(mVU, &mFC, 2);
 		xCMP(ptr16[&mVU.branch], 0);
@@ -379,7 +396,7 @@ void condBranch(mV, microFlagCycles& mFC, int JMPcc) {
 		if (bBlock)	{ // Branch non-taken has already been compiled
 			xJcc(xInvertCond((JccComparisonType)JMPcc), bBlock->x86ptrStart);
 			incPC(-3); // Go back to branch opcode (to get branch imm addr)
-			normBranchCompile(mVU, branchAddr(mVU));
+			normBranchCompile(mVU, branchAddr(mVU), loopEntry);
 		}
 		else { 
 			s32* ajmp = xJcc32((JccComparisonType)JMPcc); 
@@ -393,6 +410,8 @@ void condBranch(mV, microFlagCycles& mFC, int JMPcc) {
 			iPC = bPC;
 			incPC(-3); // Go back to branch opcode (to get branch imm addr)
 			uptr jumpAddr = (uptr)mVUblockFetch(mVU, branchAddr(mVU), (uptr)&pBlock->pStateEnd);
+			if (loopEntry && (jumpAddr == (uptr)pBlock->x86ptrStart))
+				jumpAddr = (uptr)loopEntry; // Back-edge to this block, the loop regs are still loaded
 			*ajmp = (jumpAddr - ((uptr)ajmp + 4));
 		}
 	}
@@ -430,7 +449,7 @@ void normJump(mV, microFlagCycles& mFC) {
 	{
 		xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x400 : 0x4));
 		xForwardJump32 eJMP(Jcc_Zero);
-		xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x200 : 0x2));
+		xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x200 : 0x2));
 		xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 		mVUDTendProgram(mVU, &mFC, 2);
 		xMOV(gprT1, ptr32[&mVU.branch]);
@@ -442,7 +461,7 @@ void normJump(mV, microFlagCycles& mFC) {
 	{
 		xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x800 : 0x8));
 		xForwardJump32 eJMP(Jcc_Zero);
-		xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x400 : 0x4));
+		xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x400 : 0x4));
 		xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 		mVUDTendProgram(mVU, &mFC, 2);
 		xMOV(gprT1, ptr32[&mVU.branch]);
@@ -0,0 +1,264 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "AppConfig.h"
+
+//------------------------------------------------------------------
+// Micro VU - Persistent Program Cache
+//------------------------------------------------------------------
+// The rec-cache is written to disk as-is along with the microPrograms that own it, and copied
+// back to the same address on the next hard reset. Recompiled code references host globals
+// and the dispatchers by absolute address, so the cache is only accepted if the build, the
+// memory layout and the VU settings are identical to the ones it was saved with. The only
+// heap pointers embedded in the code are the block pointers passed to mVUcompileJIT() by
+// JR/JALR blocks; those are recorded in microBlock::jumpFixup and patched on restore.
+
+static const u32 mVUdiskCacheMagic	 = 0x6355566d; // 'mVUc'
+static const u32 mVUdiskCacheVersion = 1;
+
+struct mVUdiskCacheHeader {
+	u32 magic;
+	u32 version;
+	u32 vuIndex;
+	u32 progCount;
+	u64 buildHash;		// Hash of build date/time and the address of key host symbols
+	u64 settingsHash;	// Hash of the clamp/flag/gamefix settings the code was compiled with
+	u64 dispHash;		// Hash of the dispatcher code
+	u64 cacheBase;		// Address of the rec-cache (code is not relocatable)
+	u32 codeSize;		// Bytes of recompiled code following the header
+	u32 reserved;
+};
+
+struct mVUdiskCacheBlock {
+	microRegInfo pState;
+	microRegInfo pStateEnd;
+	u32 x86offset;		// Offset of x86ptrStart from the start of the rec-cache
+	s32 fixupOffset;	// Offset of jumpFixup from the start of the rec-cache (-1 = none)
+	u32 hasJumpCache;
+	u32 pad;
+};
+
+static __fi u64 mVUhashBytes(u64 hash, const void* data, size_t size) {
+	const u8* p = (const u8*)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= p[i];
+		hash *= 0x100000001b3ull; // FNV-1a
+	}
+	return hash;
+}
+
+static u64 mVUdiskCacheBuildHash(microVU& mVU) {
+	const char* build = __DATE__ " " __TIME__;
+	uptr symbols[] = {
+		(uptr)&mVU, (uptr)&mVU.regs(), (uptr)&vu1Thread, (uptr)&vu0Thread, (uptr)&EmuConfig,
+		(uptr)mVU.dispCache, (uptr)mVUsearchXMM, (uptr)(void(*)())mVUcompileJIT<0>
+	};
+	u64 hash = mVUhashBytes(0xcbf29ce484222325ull, build, strlen(build));
+	return     mVUhashBytes(hash, symbols, sizeof(symbols));
+}
+
+static u64 mVUdiskCacheSettingsHash(microVU& mVU) {
+	u32 settings[] = {
+		EmuConfig.Cpu.Recompiler.bitset, EmuConfig.Cpu.sseVUMXCSR.bitmask,
+		EmuConfig.Speedhacks.bitset,     EmuConfig.Gamefixes.bitset, mVU.index
+	};
+	return mVUhashBytes(0xcbf29ce484222325ull, settings, sizeof(settings));
+}
+
+static wxString mVUdiskCacheFile(microVU& mVU) {
+	return Path::Combine(PathDefs::GetCache(), wxsFormat(L"microVU%d.cache", mVU.index));
+}
+
+// Writes all cached microPrograms and the recompiled code they use to disk
+void mVUsaveDiskCache(microVU& mVU) {
+	if (!EmuConfig.Cpu.Recompiler.EnableMicroVUCache || !mVU.prog.total) return;
+	if (mVU.prog.x86ptr == mVU.prog.x86diskEnd) return; // Nothing new since last load/save
+
+	std::vector<microProgram*> progs;
+	for (u32 i = 0; i < (mVU.progSize / 2); i++) {
+		if (!mVU.prog.prog[i]) continue;
+		std::deque<microProgram*>::iterator it(mVU.prog.prog[i]->begin());
+		for ( ; it != mVU.prog.prog[i]->end(); ++it) {
+			progs.push_back(it[0]);
+		}
+	}
+
+	mVUdiskCacheHeader header;
+	memzero(header);
+	header.magic		= mVUdiskCacheMagic;
+	header.version		= mVUdiskCacheVersion;
+	header.vuIndex		= mVU.index;
+	header.progCount	= progs.size();
+	header.buildHash	= mVUdiskCacheBuildHash(mVU);
+	header.settingsHash	= mVUdiskCacheSettingsHash(mVU);
+	header.dispHash		= mVUhashBytes(0xcbf29ce484222325ull, mVU.dispCache, mVUdispCacheSize);
+	header.cacheBase	= (uptr)mVU.prog.x86start;
+	header.codeSize		= (u32)(mVU.prog.x86ptr - mVU.prog.x86start);
+
+	PathDefs::GetCache().Mkdir();
+	wxString fname = mVUdiskCacheFile(mVU);
+	wxFFile fp(fname, L"wb");
+	if (!fp.IsOpened()) {
+		Console.Warning(L"microVU%d: Could not write program cache to %s", mVU.index, WX_STR(fname));
+		return;
+	}
+
+	bool ok = fp.Write(&header, sizeof(header)) == sizeof(header);
+	ok = ok && fp.Write(mVU.prog.x86start, header.codeSize) == header.codeSize;
+
+	for (size_t p = 0; ok && p < progs.size(); p++) {
+		microProgram& prog = *progs[p];
+		u32 info[3] = { prog.startPC, (u32)prog.idx, (u32)prog.ranges->size() };
+		u64 hash	= mVUrangesHash(mVU, prog);
+		ok = ok && fp.Write(info,  sizeof(info))  == sizeof(info);
+		ok = ok && fp.Write(&hash, sizeof(hash))  == sizeof(hash);
+		ok = ok && fp.Write(prog.data, mVU.microMemSize) == mVU.microMemSize;
+		std::deque<microRange>::const_iterator it(prog.ranges->begin());
+		for ( ; ok && it != prog.ranges->end(); ++it) {
+			ok = fp.Write(&it[0], sizeof(microRange)) == sizeof(microRange);
+		}
+		for (u32 i = 0; ok && i < (mVU.progSize / 2); i++) {
+			std::vector<microBlock*> blocks;
+			if (prog.block[i]) prog.block[i]->getBlocks(blocks);
+			u32 count = blocks.size();
+			ok = fp.Write(&count, sizeof(count)) == sizeof(count);
+			for (u32 j = 0; ok && j < count; j++) {
+				mVUdiskCacheBlock b;
+				memcpy(&b.pState,    &blocks[j]->pState,    sizeof(microRegInfo));
+				memcpy(&b.pStateEnd, &blocks[j]->pStateEnd, sizeof(microRegInfo));
+				b.x86offset	   = (u32)(blocks[j]->x86ptrStart - mVU.prog.x86start);
+				b.fixupOffset  = blocks[j]->jumpFixup ? (s32)(blocks[j]->jumpFixup - mVU.prog.x86start) : -1;
+				b.hasJumpCache = blocks[j]->jumpCache != NULL;
+				b.pad		   = 0;
+				ok = fp.Write(&b, sizeof(b)) == sizeof(b);
+			}
+		}
+	}
+
+	if (!ok) {
+		fp.Close();
+		wxRemoveFile(fname);
+		Console.Warning(L"microVU%d: Failed writing program cache to %s", mVU.index, WX_STR(fname));
+		return;
+	}
+	mVU.prog.x86diskEnd = mVU.prog.x86ptr;
+	DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Saved %d programs to disk cache [%3.1fmb]",
+				   mVU.index, header.progCount, (double)header.codeSize / (double)_1mb);
+}
+
+// Restores the microPrograms saved by mVUsaveDiskCache() (must be called on an empty rec-cache)
+void mVUloadDiskCache(microVU& mVU) {
+	if (!EmuConfig.Cpu.Recompiler.EnableMicroVUCache) return;
+	pxAssert(!mVU.prog.total && mVU.prog.x86ptr == mVU.prog.x86start);
+
+	wxString fname = mVUdiskCacheFile(mVU);
+	if (!wxFileExists(fname)) return;
+	wxFFile fp(fname, L"rb");
+	if (!fp.IsOpened()) return;
+
+	mVUdiskCacheHeader header;
+	if (fp.Read(&header, sizeof(header)) != sizeof(header)
+	||  header.magic		!= mVUdiskCacheMagic
+	||  header.version		!= mVUdiskCacheVersion
+	||  header.vuIndex		!= mVU.index
+	||  header.buildHash	!= mVUdiskCacheBuildHash(mVU)
+	||  header.settingsHash	!= mVUdiskCacheSettingsHash(mVU)
+	||  header.dispHash		!= mVUhashBytes(0xcbf29ce484222325ull, mVU.dispCache, mVUdispCacheSize)
+	||  header.cacheBase	!= (uptr)mVU.prog.x86start
+	||  header.codeSize		>  (uptr)(mVU.prog.x86end - mVU.prog.x86start)) {
+		DevCon.WriteLn("microVU%d: Disk cache is stale, ignoring it.", mVU.index);
+		return;
+	}
+
+	bool ok = fp.Read(mVU.prog.x86start, header.codeSize) == header.codeSize;
+	u32 loaded = 0;
+	int maxIdx = -1;
+
+	for ( ; ok && loaded < header.progCount; loaded++) {
+		u32 info[3];
+		u64 hash;
+		ok = fp.Read(info,  sizeof(info)) == sizeof(info) && fp.Read(&hash, sizeof(hash)) == sizeof(hash);
+		if (!ok || info[0] >= (mVU.progSize / 2)) { ok = false; break; }
+
+		microProgram* prog = (microProgram*)_aligned_malloc(sizeof(microProgram), 64);
+		memset(prog, 0, sizeof(microProgram));
+		prog->idx	  = info[1];
+		prog->ranges  = new std::deque<microRange>();
+		prog->startPC = info[0];
+		mVU.prog.prog[prog->startPC]->push_back(prog);
+		mVU.prog.total++;
+		maxIdx = std::max(maxIdx, prog->idx);
+
+		ok = fp.Read(prog->data, mVU.microMemSize) == mVU.microMemSize;
+		for (u32 r = 0; ok && r < info[2]; r++) {
+			microRange range;
+			ok = fp.Read(&range, sizeof(range)) == sizeof(range);
+			prog->ranges->push_back(range);
+		}
+		ok = ok && (mVUrangesHash(mVU, *prog) == hash);
+
+		for (u32 i = 0; ok && i < (mVU.progSize / 2); i++) {
+			u32 count;
+			ok = fp.Read(&count, sizeof(count)) == sizeof(count);
+			for (u32 j = 0; ok && j < count; j++) {
+				mVUdiskCacheBlock b;
+				ok = fp.Read(&b, sizeof(b)) == sizeof(b)
+				  && b.x86offset < header.codeSize
+				  && (b.fixupOffset < 0 || (u32)b.fixupOffset + sizeof(u32) <= header.codeSize);
+				if (!ok) break;
+
+				microBlock block;
+				memcpy(&block.pState,    &b.pState,    sizeof(microRegInfo));
+				memcpy(&block.pStateEnd, &b.pStateEnd, sizeof(microRegInfo));
+				block.x86ptrStart = mVU.prog.x86start + b.x86offset;
+				block.jumpFixup	  = (b.fixupOffset < 0) ? NULL : mVU.prog.x86start + b.fixupOffset;
+				block.jumpCache	  = NULL;
+
+				if (!prog->block[i]) prog->block[i] = new microBlockManager();
+				microBlock* pBlock = prog->block[i]->add(&block);
+				if (b.hasJumpCache && !pBlock->jumpCache) {
+					pBlock->jumpCache = new microJumpCache[mProgSize/2];
+				}
+				if (pBlock->jumpFixup) {
+					*(u32*)pBlock->jumpFixup = doJumpCaching ? (uptr)pBlock : (uptr)&pBlock->pStateEnd;
+				}
+			}
+		}
+	}
+
+	if (!ok) {
+		// Partially restored code may reference blocks we never re-created, so drop everything
+		Console.Warning(L"microVU%d: Program cache %s is corrupt, discarding it.", mVU.index, WX_STR(fname));
+		fp.Close();
+		wxRemoveFile(fname);
+		for (u32 i = 0; i < (mVU.progSize / 2); i++) {
+			std::deque<microProgram*>::iterator it(mVU.prog.prog[i]->begin());
+			for ( ; it != mVU.prog.prog[i]->end(); ++it) {
+				mVUdeleteProg(mVU, it[0]);
+			}
+			mVU.prog.prog[i]->clear();
+		}
+		mVU.prog.total = 0;
+		return;
+	}
+
+	mVU.prog.total		= std::max(mVU.prog.total, maxIdx + 1);
+	mVU.prog.x86ptr		= mVU.prog.x86start + header.codeSize;
+	mVU.prog.x86diskEnd	= mVU.prog.x86ptr;
+	Console.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Restored %d programs from disk cache [%3.1fmb]",
+					mVU.index, loaded, (double)header.codeSize / (double)_1mb);
+}
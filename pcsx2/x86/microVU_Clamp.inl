@@ -51,6 +51,10 @@ void mVUclamp1(const xmm& reg, const xmm& regT1, int xyzw, bool bClampE = 0) {
 
 // Used for Operand Clamping
 // Note 1: If 'preserve sign' mode is on, it will preserve the sign of NaN values.
+//         On SSE4.1 hosts this is done on the integer representation of the floats:
+//         pminsd clamps positive values (and +NaN/+Inf) to +fMax, and pminud clamps
+//         negative ones to -fMax, which is 2 instructions and needs no temp reg.
+//         VEX forms don't help here since the clamp is always done in place.
 // Note 2: Using regalloc here seems to contaminate some regs in certain games.
 // Must be some specific case I've overlooked (or I used regalloc improperly on an opcode)
 // so we just use a temporary mem location for our backup for now... (non-sse4 version only)
@@ -61,6 +61,7 @@ void mVUsetupRange(microVU& mVU, s32 pc, bool isStartPC) {
 	}
 
 	mVUcheckIsSame(mVU);
+	mVUcurProg.rangesHashValid = false;
 
 	if (isStartPC) {
 		microRange mRange = {pc, -1};
@@ -395,6 +396,76 @@ void mVUtestCycles(microVU& mVU) {
 	xSUB(ptr32[&mVU.cycles], mVUcycles);
 }
 
+//------------------------------------------------------------------
+// Loop Reg Alloc
+//------------------------------------------------------------------
+
+// xmm regs that hold the loop regs (mVUsetupFlags() uses xmmT1/xmmT2 on the way to the branch)
+static const int mVUloopXmm[4] = { 2, 3, 4, 5 };
+
+// If the block branches back to its own start, loads the VF regs it reads the most but never
+// writes, and sets the loop entry just past the loads. Called before mVUtestCycles().
+void mVUloopPreload(mV) {
+	microLoopRegs& loop = mVU.prog.IRinfo.loopRegs;
+	loop.entry = NULL;
+	loop.count = 0;
+
+	if (!doLoopRegAlloc || mVUpBlock->pState.blockType || (mVUcount < 2))
+		return;
+
+	// The block has to end in the delay slot of a (non-linking) branch to its start
+	iPC = (mVUstartPC + (mVUcount - 1) * 2) & mVU.progMemMask;
+	if (!mVUinfo.isBdelay)
+		return;
+	incPC(-2);
+	if ((mVUlow.branch != 1 && (mVUlow.branch < 3 || mVUlow.branch > 8))
+	||   mVUlow.badBranch || mVUlow.evilBranch || mVUup.eBit || mVUup.tBit || mVUup.dBit
+	||  (branchAddr(mVU) != mVUstartPC * 4)) {
+		iPC = mVUstartPC;
+		return;
+	}
+
+	int  reads[32] = {};
+	bool written[32] = {};
+	iPC = mVUstartPC;
+	for (u32 i = 0; i < mVUcount; i++) {
+		const microOp& op = mVUinfo;
+		if (op.uOp.VF_write.reg < 32) written[op.uOp.VF_write.reg] = true;
+		if (op.lOp.VF_write.reg < 32) written[op.lOp.VF_write.reg] = true;
+		for (int j = 0; j < 2; j++) {
+			if (op.uOp.VF_read[j].reg < 32) reads[op.uOp.VF_read[j].reg]++;
+			if (op.lOp.VF_read[j].reg < 32) reads[op.lOp.VF_read[j].reg]++;
+		}
+		incPC2(2);
+	}
+	iPC = mVUstartPC;
+
+	while (loop.count < 4) {
+		int best = 0;
+		for (int reg = 1; reg < 32; reg++) {
+			if (!written[reg] && reads[reg] && (!best || (reads[reg] > reads[best]))) best = reg;
+		}
+		if (!best) break;
+
+		xMOVAPS(xmm(mVUloopXmm[loop.count]), ptr128[&mVU.regs().VF[best]]);
+		loop.xmm  [loop.count] = mVUloopXmm[loop.count];
+		loop.VFreg[loop.count] = best;
+		loop.count++;
+		reads[best] = 0;
+	}
+
+	if (loop.count)
+		loop.entry = x86Ptr;
+}
+
+// Tells the regAlloc about the loop regs (after mVUtestCycles(), whose exit path flushes it)
+void mVUloopSeedRegs(mV) {
+	microLoopRegs& loop = mVU.prog.IRinfo.loopRegs;
+	for (int i = 0; i < loop.count; i++) {
+		mVU.regAlloc->setCachedReg(loop.xmm[i], loop.VFreg[i]);
+	}
+}
+
 //------------------------------------------------------------------
 // Initializing
 //------------------------------------------------------------------
@@ -433,6 +504,7 @@ __fi void mVUinitFirstPass(microVU& mVU, uptr pState, u8* thisPtr) {
 		memcpy((u8*)&mVU.prog.lpState, (u8*)pState, sizeof(microRegInfo));
 	}
 	mVUblock.x86ptrStart	= thisPtr;
+	mVUblock.jumpFixup		= NULL;
 	mVUpBlock				= mVUblocks[mVUstartPC/2]->add(&mVUblock); // Add this block to block manager
 	mVUregs.needExactMatch	= (mVUpBlock->pState.blockType)?7:0; // ToDo: Fix 1-Op block flag linking (MGS2:Demo/Sly Cooper)
 	mVUregs.blockType		= 0;
@@ -483,6 +555,7 @@ void* mVUcompileSingleInstruction(microVU& mVU, u32 startPC, uptr pState, microF
 
 
 	mVUsetFlags(mVU, mFC);           // Sets Up Flag instances
+	mVUcountFlags(mVU);              // Flag instance statistics
 	mVUoptimizePipeState(mVU);       // Optimize the End Pipeline State for nicer Block Linking
 	mVUdebugPrintBlocks(mVU, false); // Prints Start/End PC of blocks executed, for debugging...
 	mVUtestCycles(mVU);              // Update VU Cycles and Exit Early if Necessary
@@ -508,7 +581,7 @@ void mVUDoDBit(microVU& mVU, microFlagCycles* mFC)
 {
 	xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x400 : 0x4));
 	xForwardJump32 eJMP(Jcc_Zero);
-	xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x200 : 0x2));
+	xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x200 : 0x2));
 	xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 	incPC(1);
 	mVUDTendProgram(mVU, mFC, 1);
@@ -520,7 +593,7 @@ void mVUDoTBit(microVU& mVU, microFlagCycles* mFC)
 {
 	xTEST(ptr32[&VU0.VI[REG_FBRST].UL], (isVU1 ? 0x800 : 0x8));
 	xForwardJump32 eJMP(Jcc_Zero);
-	xOR(ptr32[&VU0.VI[REG_VPU_STAT].UL], (isVU1 ? 0x400 : 0x4));
+	xOR(ptr32[&mVU.getVPUStat()], (isVU1 ? 0x400 : 0x4));
 	xOR(ptr32[&mVU.regs().flags], VUFLAG_INTCINTERRUPT);
 	incPC(1);
 	mVUDTendProgram(mVU, mFC, 1);
@@ -599,9 +672,12 @@ void* mVUcompile(microVU& mVU, u32 startPC, uptr pState) {
 	mVUregs.vi15v = (doConstProp && mVUconstReg[15].isValid) ? 1 : 0;
 
 	mVUsetFlags(mVU, mFC);           // Sets Up Flag instances
+	mVUcountFlags(mVU);              // Flag instance statistics
 	mVUoptimizePipeState(mVU);       // Optimize the End Pipeline State for nicer Block Linking
 	mVUdebugPrintBlocks(mVU, false); // Prints Start/End PC of blocks executed, for debugging...
+	mVUloopPreload(mVU);             // Load the regs kept across the back-edge (if the block loops to itself)
 	mVUtestCycles(mVU);              // Update VU Cycles and Exit Early if Necessary
+	mVUloopSeedRegs(mVU);
 
 	// Second Pass
 	iPC = mVUstartPC;
@@ -661,6 +737,7 @@ void* mVUcompile(microVU& mVU, u32 startPC, uptr pState) {
 perf_and_return:
 
 	Perf::vu.map((uptr)thisPtr, x86Ptr - thisPtr, startPC);
+	RecProfiler::MapBlock(mVU.index ? RecProfiler::Source_VU1 : RecProfiler::Source_VU0, (uptr)thisPtr, x86Ptr - thisPtr, startPC);
 
 	return thisPtr;
 }
@@ -153,7 +153,7 @@ _mVUt void mVUcleanUp() {
 	mVU.cycles = mVU.totalCycles - mVU.cycles;
 	mVU.regs().cycle += mVU.cycles;
 
-	if (!vuIndex || !THREAD_VU1) {
+	if (vuIndex ? !THREAD_VU1 : !THREAD_VU0) {
 		cpuRegs.cycle += std::min(mVU.cycles, 3000u) * EmuConfig.Speedhacks.EECycleSkip;
 	}
 	mVU.profiler.Print();
@@ -253,6 +253,26 @@ __fi void mVUsetFlags(mV, microFlagCycles& mFC) {
 	}
 }
 
+// Adds the flag instances the block updates to the program's (and the instrumentation) counters
+__fi void mVUcountFlags(mV) {
+	u32* stats	= mVU.prog.cur->flagStats;
+	u32 count[3] = {0, 0, 0};
+	int endPC	= iPC;
+	iPC			= mVUstartPC;
+	for(u32 i = 0; i < mVUcount; i++) {
+		if (sFlagCond)	  count[0]++;
+		if (mFLAG.doFlag) count[1]++;
+		if (cFLAG.doFlag) count[2]++;
+		incPC2(2);
+	}
+	iPC = endPC;
+	stats[0] += mVUcount;
+	stats[1] += count[0];
+	stats[2] += count[1];
+	stats[3] += count[2];
+	Instrumentation::Add(Instrumentation::Counter_VUFlagInsts, count[0] + count[1] + count[2], mVUcount);
+}
+
 #define getFlagReg2(x)	((bStatus[0] == x) ? getFlagReg(x) : gprT1)
 #define getFlagReg3(x)	((gFlag == x) ? gprT1 : getFlagReg(x))
 #define getFlagReg4(x)	((gFlag == x) ? gprT1 : gprT2)
@@ -330,13 +350,16 @@ __fi void mVUsetupFlags(mV, microFlagCycles& mFC) {
 
 #define shortBranch() {											\
 	if ((branch == 3) || (branch == 4)) { /*Branches*/			\
-		_mVUflagPass(mVU, aBranchAddr, sCount+found, found, v);	\
+		_mVUflagPass(mVU, aBranchAddr, sCount+found, found, cCount, v);	\
 		if (branch == 3) break;	/*Non-conditional Branch*/		\
 		branch = 0;												\
 	}															\
 	else if (branch == 5) { /*JR/JARL*/							\
 		if(sCount+found<4) {			\
-			mVUregs.needExactMatch |= 7;						\
+			mVUregs.needExactMatch |= 3;						\
+		}														\
+		if(cCount<4) {											\
+			mVUregs.needExactMatch |= 4;						\
 		}														\
 		break;													\
 	}															\
@@ -344,7 +367,11 @@ __fi void mVUsetupFlags(mV, microFlagCycles& mFC) {
 }
 
 // Scan through instructions and check if flags are read (FSxxx, FMxxx, FCxxx opcodes)
-void _mVUflagPass(mV, u32 startPC, u32 sCount, u32 found, std::vector<u32>& v) {
+// Status and Mac flags are only fully computed when a following read needs them, so they
+// are live until 4 instructions past the first FMAC op that overwrites them (sCount/found).
+// Clip flags are always computed and only their pipeline instances can be stale, so a clip
+// read needs an exact match only within the first 4 instructions past the block (cCount).
+void _mVUflagPass(mV, u32 startPC, u32 sCount, u32 found, u32 cCount, std::vector<u32>& v) {
 
 	for (u32 i = 0; i < v.size(); i++) {
 		if (v[i] == startPC) return; // Prevent infinite recursion
@@ -357,6 +384,7 @@ void _mVUflagPass(mV, u32 startPC, u32 sCount, u32 found, std::vector<u32>& v) {
 	iPC		  = startPC / 4;
 	mVUbranch = 0;
 	for(int branch = 0; sCount < 4; sCount += found) {
+		const u8 clipRead = mVUregs.needExactMatch & 4;
 		mVUregs.needExactMatch &= 7;
 		incPC(1);
 		mVUopU(mVU, 3);
@@ -366,6 +394,7 @@ void _mVUflagPass(mV, u32 startPC, u32 sCount, u32 found, std::vector<u32>& v) {
 		if ( curI & _Tbit_ ) { branch = 6; } 
 		if ( (curI & _Dbit_) && doDBitHandling ) { branch = 6; }
 		if (!(curI & _Ibit_) )	{ incPC(-1); mVUopL(mVU, 3); incPC(1); }
+		if (cCount++ >= 4) { mVUregs.needExactMatch = (mVUregs.needExactMatch & 3) | clipRead; }
 		
 		// if (mVUbranch&&(branch>=3)&&(branch<=5)) { DevCon.Error("Double Branch [%x]", xPC); mVUregs.needExactMatch |= 7; break; }
 		
@@ -383,7 +412,7 @@ void _mVUflagPass(mV, u32 startPC, u32 sCount, u32 found, std::vector<u32>& v) {
 
 void mVUflagPass(mV, u32 startPC, u32 sCount = 0, u32 found = 0) {
 	std::vector<u32> v;
-	_mVUflagPass(mVU, startPC, sCount, found, v);
+	_mVUflagPass(mVU, startPC, sCount, found, 0, v);
 }
 
 __fi void checkFFblock(mV, u32 addr, int& ffOpt) {
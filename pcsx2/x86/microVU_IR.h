@@ -76,6 +76,7 @@ struct __aligned16 microBlock {
 	microRegInfo	pState;		 // Detailed State of Pipeline
 	microRegInfo	pStateEnd;	 // Detailed State of Pipeline at End of Block (needed by JR/JALR opcodes)
 	u8*				x86ptrStart; // Start of code (Entry point for block)
+	u8*				jumpFixup;	 // Location of the imm32 holding this block's address if it ends in JR/JALR (used by the disk cache)
 	microJumpCache* jumpCache;	 // Will point to an array of entry points of size [16k/8] if block ends in JR/JALR
 };
 
@@ -172,6 +173,14 @@ struct microOp {
 	microLowerOp  lOp;	 // Lower Op Info
 };
 
+// VF regs a block that loops back to its own start keeps loaded across the back-edge
+struct microLoopRegs {
+	u8* entry;		// Loop entry point, just past the loads (NULL = block isn't such a loop)
+	int count;		// Number of regs loaded
+	int xmm[4];		// xmm reg holding each VF reg
+	int VFreg[4];	// VF reg loaded
+};
+
 template<u32 pSize>
 struct microIR {
 	microBlock		 block;			// Block/Pipeline info
@@ -179,6 +188,7 @@ struct microIR {
 	microTempRegInfo regsTemp;		// Temp Pipeline info (used so that new pipeline info isn't conflicting between upper and lower instructions in the same cycle)
 	microOp			 info[pSize/2];	// Info for Instructions in current block
 	microConstInfo	 constReg[16];	// Simple Const Propagation Info for VI regs within blocks
+	microLoopRegs	 loopRegs;		// Regs kept loaded across the current block's back-edge
 	u8  branch;
 	u32 cycles;		// Cycles for current block
 	u32 count;		// Number of VU 64bit instructions ran (starts at 0 for each block)
@@ -286,6 +296,18 @@ public:
 		clear.isNeeded	=  0;
 	}
 
+	// Marks reg as a cached (unmodified) copy of VFreg, which the caller has loaded into it
+	void setCachedReg(int regId, int VFreg) {
+		clearReg(regId);
+		xmmMap[regId].VFreg = VFreg;
+		xmmMap[regId].count = counter;
+	}
+
+	// Is reg still a cached (unmodified) copy of VFreg?
+	bool isCachedReg(int regId, int VFreg) const {
+		return (xmmMap[regId].VFreg == VFreg) && !xmmMap[regId].xyzw;
+	}
+
 	void clearRegVF(int VFreg) {
 		for(int i = 0; i < xmmTotal; i++) {
 			if (xmmMap[i].VFreg == VFreg) clearReg(i);
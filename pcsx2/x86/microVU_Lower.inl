@@ -153,8 +153,7 @@ mVUop(mVU_RSQRT) {
 #define EATANhelper(addr) {				\
 	SSE_MULSS(mVU, t2, Fs);				\
 	SSE_MULSS(mVU, t2, Fs);				\
-	xMOVAPS       (t1, t2);				\
-	xMUL.SS       (t1, ptr32[addr]);	\
+	xMUL.SS       (t1, t2, ptr32[addr]);	\
 	SSE_ADDSS(mVU, PQ, t1);				\
 }
 
@@ -238,8 +237,7 @@ mVUop(mVU_EATANxz) {
 
 #define eexpHelper(addr) {				\
 	SSE_MULSS(mVU, t2, Fs);				\
-	xMOVAPS       (t1, t2);				\
-	xMUL.SS       (t1, ptr32[addr]);	\
+	xMUL.SS       (t1, t2, ptr32[addr]);	\
 	SSE_ADDSS(mVU, xmmPQ, t1);			\
 }
 
@@ -403,13 +401,11 @@ mVUop(mVU_ESIN) {
 		SSE_ADDSS(mVU, xmmPQ, Fs); // pq = X + s2 * X^3
 
 		SSE_MULSS(mVU, t2, t1);    // t2 = X^3 * X^2
-		xMOVAPS       (Fs, t2);    // fs = X^5
-		xMUL.SS       (Fs, ptr32[mVUglob.S3]); // ps = s3 * X^5
+		xMUL.SS       (Fs, t2, ptr32[mVUglob.S3]); // fs = s3 * X^5
 		SSE_ADDSS(mVU, xmmPQ, Fs); // pq = X + s2 * X^3 + s3 * X^5
 
 		SSE_MULSS(mVU, t2, t1);    // t2 = X^5 * X^2
-		xMOVAPS       (Fs, t2);    // fs = X^7
-		xMUL.SS       (Fs, ptr32[mVUglob.S4]); // fs = s4 * X^7
+		xMUL.SS       (Fs, t2, ptr32[mVUglob.S4]); // fs = s4 * X^7
 		SSE_ADDSS(mVU, xmmPQ, Fs); // pq = X + s2 * X^3 + s3 * X^5 + s4 * X^7
 
 		SSE_MULSS(mVU, t2, t1);    // t2 = X^7 * X^2
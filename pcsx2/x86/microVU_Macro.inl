@@ -17,6 +17,8 @@
 
 extern void _vu0WaitMicro();
 extern void _vu0FinishMicro();
+extern bool g_recompilingDelaySlot;
+extern u32  s_nEndBlock;
 
 static VURegs& vu0Regs = vuRegs[0];
 
@@ -29,14 +31,24 @@ using namespace R5900::Dynarec;
 #define printCOP2(...) (void)0
 //#define printCOP2 DevCon.Status
 
+// EE pc of the macro op allowed to reuse the VF regs the previous macro op left in xmm
+// regs (-1 = none). Only set when nothing but the EE's per-instruction bookkeeping is
+// recompiled between the two ops, so the xmm regs can't have been touched.
+static u32 macroChainPC = (u32)-1;
+
+static bool mVUmacroCanChain();
+
 void setupMacroOp(int mode, const char* opName) {
 	printCOP2(opName);
 	microVU0.cop2 = 1;
 	microVU0.prog.IRinfo.curPC = 0;
 	microVU0.code = cpuRegs.code;
 	memset(&microVU0.prog.IRinfo.info[0], 0, sizeof(microVU0.prog.IRinfo.info[0]));
-	iFlushCall(FLUSH_EVERYTHING);
-	microVU0.regAlloc->reset();
+	if (macroChainPC != pc - 4 || g_recompilingDelaySlot) {
+		iFlushCall(FLUSH_EVERYTHING);
+		microVU0.regAlloc->reset();
+	}
+	macroChainPC = (u32)-1;
 	if (mode & 0x01) { // Q-Reg will be Read
 		xMOVSSZX(xmmPQ, ptr32[&vu0Regs.VI[REG_Q].UL]);
 	}
@@ -63,7 +75,11 @@ void endMacroOp(int mode) {
 	if (mode & 0x10) { // Status/Mac Flags were Updated
 		xMOV(ptr32[&vu0Regs.VI[REG_STATUS_FLAG].UL], gprF0);
 	}
-	microVU0.regAlloc->flushAll();
+	if (mVUmacroCanChain()) { // Write back, but keep the VF regs cached for the next op
+		microVU0.regAlloc->flushAll(false);
+		macroChainPC = pc;
+	}
+	else microVU0.regAlloc->flushAll();
 	microVU0.cop2 = 0;
 }
 
@@ -80,12 +96,6 @@ void endMacroOp(int mode) {
 		endMacroOp(mode);									\
 	}
 
-#define INTERPRETATE_COP2_FUNC(f)							\
-	void recV##f() {										\
-		recCall(V##f);										\
-		_freeX86regs();										\
-	}
-
 //------------------------------------------------------------------
 // Macro VU - Instructions
 //------------------------------------------------------------------
@@ -222,8 +232,28 @@ REC_COP2_mVU0(RXOR,		"RXOR",		0x00);
 
 void recVNOP()	{}
 void recVWAITQ(){}
-INTERPRETATE_COP2_FUNC(CALLMS);
-INTERPRETATE_COP2_FUNC(CALLMSR);
+
+// Same as the interpreter's VCALLMS/VCALLMSR: finish whatever VU0 is running, then
+// start the micro program (the address for VCALLMSR is read once VU0 has finished)
+void recVCALLMS() {
+	printCOP2("VCALLMS");
+	iFlushCall(FLUSH_EVERYTHING | FLUSH_PC);
+	xFastCall((void*)vu0Finish);
+	xFastCall((void*)vu0ExecMicro, ((cpuRegs.code >> 6) & 0x7FFF) * 8);
+	xAND(ptr32[&vif0Regs.stat._u32], ~VIF0_STAT_VEW);
+	_freeX86regs();
+}
+
+void recVCALLMSR() {
+	printCOP2("VCALLMSR");
+	iFlushCall(FLUSH_EVERYTHING | FLUSH_PC);
+	xFastCall((void*)vu0Finish);
+	xMOVZX(ecx, ptr16[&vu0Regs.VI[REG_CMSAR0].US[0]]);
+	xSHL(ecx, 3);
+	xFastCall((void*)vu0ExecMicro, ecx);
+	xAND(ptr32[&vif0Regs.stat._u32], ~VIF0_STAT_VEW);
+	_freeX86regs();
+}
 
 //------------------------------------------------------------------
 // Macro VU - Branches
@@ -459,9 +489,33 @@ void (*recCOP2SPECIAL2t[128])() = {
 	rec_C2UNK,	rec_C2UNK,	rec_C2UNK,	rec_C2UNK,	rec_C2UNK,	rec_C2UNK,	rec_C2UNK,	rec_C2UNK,
 };
 
+// Can the macro op being recompiled leave its VF regs in xmm regs for the next EE
+// instruction? Only if that is a macro op handled by microVU too (not a transfer, branch,
+// VCALLMS or NOP), in the same block, and not reached through a branch or a VU0 thread sync.
+static bool mVUmacroCanChain() {
+	if (THREAD_VU0 || g_recompilingDelaySlot || pc >= s_nEndBlock) return false;
+	const u32 code = *(u32*)PSM(pc);
+	if ((code >> 26) != 0x12 || !(code & (1 << 25))) return false; // COP2, CO bit set (SPEC1/2)
+
+	void (*recOp)() = recCOP2SPECIAL1t[code & 0x3f];
+	if (recOp == recCOP2_SPEC2)
+		recOp = recCOP2SPECIAL2t[(code & 3) | ((code >> 4) & 0x7c)];
+
+	return recOp != rec_C2UNK && recOp != recVNOP && recOp != recVWAITQ
+		&& recOp != recVCALLMS && recOp != recVCALLMSR;
+}
+
 namespace R5900 {
 namespace Dynarec {
-namespace OpcodeImpl { void recCOP2() { recCOP2t[_Rs_](); }}}}
+namespace OpcodeImpl {
+void recCOP2() {
+	if (THREAD_VU0) { // Every COP2 op waits for the VU0 thread, the compiler shares microVU0 with it too
+		vu0Thread.WaitVU();
+		iFlushCall(FLUSH_EVERYTHING);
+		xFastCall((void*)vu0ThreadWaitJIT);
+	}
+	recCOP2t[_Rs_]();
+}}}}
 void recCOP2_BC2  () { recCOP2_BC2t[_Rt_](); }
 void recCOP2_SPEC1() { recCOP2SPECIAL1t[_Funct_](); }
 void recCOP2_SPEC2() { recCOP2SPECIAL2t[(cpuRegs.code&3)|((cpuRegs.code>>4)&0x7c)](); }
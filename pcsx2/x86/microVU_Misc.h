@@ -276,6 +276,14 @@ static const bool doRegAlloc = true; // Set to false to flush every 32bit Instru
 // Lower and Upper instructions, so in this case it flushes after the full
 // 64bit instruction (lower and upper)
 
+// Loop Reg Alloc
+static const bool doLoopRegAlloc = true; // Set to true to keep loop regs across back-edges
+// Blocks that branch back to their own start (mostly VU1 T&L inner loops) keep up to
+// 4 of the VF regs they read but never write loaded in xmm regs across the back-edge.
+// The block starts by loading them, and the back-edge jumps just past the loads if
+// they are all still cached when the branch is reached. Modified regs are still
+// written back at the end of every block.
+
 // No Flag Optimizations
 static const bool noFlagOpts = false; // Set to true to disable all flag setting optimizations
 // Note: The flag optimizations this disables should all be harmless, so
@@ -332,6 +340,13 @@ static const bool doJumpAsSameProgram = false; // Set to true to treat jumps as
 // constant recompilation problems in certain games.
 // Note: You MUST disable doJumpCaching if you enable this option.
 
+// Speculative Entry Points
+static const bool doSpeculativeEntries = true; // Set to true to precompile known entry points
+// Remembers the start PCs that each micro memory image (by its hash) was called at.
+// When a program is found or created for one of them, the other entry points seen
+// for the same image are compiled into it right away and get quick-references, so
+// the next VCALLMS/MSCAL of that upload doesn't search for (or create) a program.
+
 // Handling of D-Bit in Micro Programs
 static const bool doDBitHandling = false;
 // This flag shouldn't be enabled in released versions of games. Any games which
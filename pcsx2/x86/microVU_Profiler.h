@@ -102,6 +102,9 @@ static const char microOpcodeName[][16] = {
 struct microProfiler {
 	static const u32 progLimit = 10000;
 	u64 opStats[opLastOpcode];
+	u64 searches;	 // mVUsearchProg calls that had to walk a program list
+	u64 hashRejects; // Programs rejected by their ranges hash
+	u64 compares;	 // Programs whose ranges had to be compared
 	u32 progCount;
 	int index;
 	void Reset(int _index) { memzero(*this); index = _index; }
@@ -109,6 +112,9 @@ struct microProfiler {
 		xADD(ptr32[&(((u32*)opStats)[op*2+0])], 1);
 		xADC(ptr32[&(((u32*)opStats)[op*2+1])], 0);
 	}
+	void Search()	  { searches++; }
+	void HashReject() { hashRejects++; }
+	void Compare()	  { compares++; }
 	void Print() {
 		progCount++;
 		if ((progCount % progLimit) == 0) {
@@ -130,6 +136,8 @@ struct microProfiler {
 				DevCon.WriteLn("%s - [%3.4f%%][count=%u]",
 					str.c_str(), stat, (u32)count);
 			}
+			DevCon.WriteLn("Program searches = %u, hash rejects = %u, range compares = %u",
+				(u32)searches, (u32)hashRejects, (u32)compares);
 			DevCon.WriteLn("Total = 0x%x%x\n\n", (u32)(u64)(total>>32),(u32)total);
 		}
 	}
@@ -138,6 +146,9 @@ struct microProfiler {
 struct microProfiler {
 	__fi void Reset(int _index) {}
 	__fi void EmitOp(microOpcode op) {}
+	__fi void Search() {}
+	__fi void HashReject() {}
+	__fi void Compare() {}
 	__fi void Print() {}
 };
 #endif
@@ -375,8 +375,7 @@ static void mVU_FTOIx(mP, const float* addr, microOpcode opEnum) {
 		xCVTTPS2DQ(Fs, Fs);
 		xPXOR(t1, ptr128[mVUglob.signbit]);
 		xPSRA.D(t1, 31);
-		xMOVAPS(t2, Fs);
-		xPCMP.EQD(t2, ptr128[mVUglob.signbit]);
+		xPCMP.EQD(t2, Fs, ptr128[mVUglob.signbit]);
 		xAND.PS(t1, t2);
 		xPADD.D(Fs, t1);
 
@@ -418,15 +417,13 @@ mVUop(mVU_CLIP) {
 		xSHL(gprT1, 6);
 
 		xAND.PS(Ft, ptr128[mVUglob.absclip]);
-		xMOVAPS(t1, Ft);
-		xPOR(t1, ptr128[mVUglob.signbit]);
+		xPOR(t1, Ft, ptr128[mVUglob.signbit]);
 
 		xCMPNLE.PS(t1, Fs); // -w, -z, -y, -x
 		xCMPLT.PS(Ft, Fs);  // +w, +z, +y, +x
 
-		xMOVAPS(Fs, Ft);    // Fs = +w, +z, +y, +x
-		xUNPCK.LPS(Ft, t1); // Ft = -y,+y,-x,+x
-		xUNPCK.HPS(Fs, t1); // Fs = -w,+w,-z,+z
+		xUNPCK.HPS(Fs, Ft, t1); // Fs = -w,+w,-z,+z
+		xUNPCK.LPS(Ft, t1);     // Ft = -y,+y,-x,+x
 
 		xMOVMSKPS(gprT2, Fs); // -w,+w,-z,+z
 		xAND(gprT2, 0x3);
@@ -22,8 +22,31 @@
 #include "MTVU.h"
 #include "Utilities/Perf.h"
 
+// Initial number of slots in the block cache (it grows when half full).  VIF1 sees far
+// more unpack variations than VIF0.
+static const u32 VifBlockCacheSize[2] = { 0x400, 0x1000 };
+
+static void dVifLogStats(int idx) {
+	const HashBucket& blocks = nVif[idx].vifBlocks;
+	if (!blocks.size()) return;
+
+	double avg;
+	u32 longest;
+	blocks.probe_stats(avg, longest);
+
+	DevCon.WriteLn(L"nVif%d: %u cached blocks, %.2f average / %u longest probe",
+		idx, blocks.size(), avg, longest);
+}
+
+static u32 s_compiles[2];
+static u64 s_lastReport[2];
+
+// Linear copy of VU memory for blocks that wrap around its end (VIF0 / VIF1)
+static __aligned16 u8 s_wrapBuffer[2][0x4000];
+
 static void recReset(int idx) {
-	nVif[idx].vifBlocks.reset();
+	dVifLogStats(idx);
+	nVif[idx].vifBlocks.reset(VifBlockCacheSize[idx]);
 
 	nVif[idx].recReserve->Reset();
 
@@ -290,6 +313,20 @@ _vifT __fi nVifBlock* dVifCompile(nVifBlock& block, bool isFill) {
 	block.length = dVifComputeLength(block.cl, block.wl, block.num, isFill);
 	v.vifBlocks.add(block);
 
+	// Compile rate, reported at most once a second (and only while blocks are compiled).
+	const u64 now = GetCPUTicks();
+
+	s_compiles[idx]++;
+	if (now - s_lastReport[idx] >= GetTickFrequency()) {
+		if (s_lastReport[idx] != 0) {
+			DevCon.WriteLn(L"nVif%d: %u blocks compiled in the last %.1f s",
+				idx, s_compiles[idx], (double)(now - s_lastReport[idx]) / GetTickFrequency());
+			dVifLogStats(idx);
+		}
+		s_compiles[idx] = 0;
+		s_lastReport[idx] = now;
+	}
+
 	VifUnpackSSE_Dynarec(v, block).CompileRoutine();
 
 	Perf::vif.map((uptr)v.recWritePtr, xGetPtr() - v.recWritePtr, block.upkType /* FIXME ideally a key*/);
@@ -351,6 +388,19 @@ _vifT __fi void dVifUnpack(const u8* data, bool isFill) {
 		if (likely((startmem + b->length) <= endmem)) {
 			// No wrapping, you can run the fast dynarec
 			((nVifrecCall)b->startPtr)((uptr)startmem, (uptr)data);
+		} else if (b->length <= vuMemLimit) {
+			// The block wraps around the end of VU memory: run it on a linear copy of the
+			// memory it covers, rather than on the per-vector interpreter.  The copy keeps
+			// write protected and skipped vectors intact.
+			u8*        wrap = s_wrapBuffer[idx];
+			const uint head = endmem - startmem;
+			const uint tail = b->length - head;
+
+			memcpy(wrap,        startmem, head);
+			memcpy(wrap + head, VU.Mem,   tail);
+			((nVifrecCall)b->startPtr)((uptr)wrap, (uptr)data);
+			memcpy(startmem, wrap,        head);
+			memcpy(VU.Mem,   wrap + head, tail);
 		} else {
 			VIF_LOG("Running Interpreter Block: nVif%x - VU Mem Ptr Overflow; falling back to interpreter. Start = %x End = %x num = %x, wl = %x, cl = %x",
 					v.idx, vif.tag.addr, vif.tag.addr + (block.num * 16), block.num, block.wl, block.cl);
@@ -15,10 +15,8 @@
 
 #pragma once
 
-#include <array>
-
-// nVifBlock - Ordered for Hashing; the 'num' and 'upkType' fields are
-//             used as the hash bucket selector.
+// nVifBlock - Ordered for Hashing; the 'num' and 'upkType' fields together with the
+//             mask and the cycle/mode fields make up the lookup key.
 union nVifBlock {
 	// Warning: order depends on the newVifDynaRec code
 	struct {
@@ -43,92 +41,132 @@ union nVifBlock {
 
 }; // 16 bytes
 
-// 0x4000 is enough but 0x10000 allow
-// * to skip the compare value of the first double world in lookup
-// * to use a 16 bits move instead of an 'and' mask to compute the hashed key
-#define hSize 0x10000 // [usn*1:mask*1:upk*4:num*8] hash...
-
-// HashBucket is a container which uses a built-in hash function
-// to perform quick searches. It is designed around the nVifBlock structure
+// HashBucket is an open addressed (linear probing) hash table of nVifBlocks.  The
+// blocks are stored in a single flat array, so a lookup usually touches a single cache
+// line, and adding a block never reallocates unless the table has to grow.
 //
-// The hash function is determined by taking the first bytes of data and
-// performing a modulus the size of hSize. So the most diverse-data should
-// be in the first bytes of the struct. (hence why nVifBlock is specifically sorted)
+// All of hash_key, key0 and key1 are mixed into the hash, since games tend to use a few
+// unpack types with many different masks and cycle settings.  The table is kept at most
+// half full; a free slot (startPtr == 0) ends a probe sequence.
 class HashBucket {
 protected:
-	std::array<nVifBlock*, hSize> m_bucket;
+	nVifBlock* m_table;
+	u32 m_mask;			// table size - 1 (table size is a power of two)
+	u32 m_count;		// number of blocks in the table
+
+	static __fi u32 hash(const nVifBlock& dataPtr) {
+		u32 h = dataPtr.hash_key ^ (dataPtr.key0 * 0x85ebca6b) ^ (dataPtr.key1 * 0xc2b2ae35);
+		h ^= h >> 15;
+		h *= 0x2c1b3c6d;
+		h ^= h >> 12;
+		return h;
+	}
+
+	void allocate(u32 size) {
+		safe_aligned_free(m_table);
+
+		// Performance note: 64B align to reduce cache miss penalty in `find`
+		if( (m_table = (nVifBlock*)_aligned_malloc( sizeof(nVifBlock)*size, 64 )) == nullptr ) {
+			throw Exception::OutOfMemory(
+				wxsFormat(L"HashBucket Table (size=%d)", size)
+			);
+		}
+
+		memset(m_table, 0, sizeof(nVifBlock)*size);
+		m_mask = size - 1;
+		m_count = 0;
+	}
+
+	void insert(const nVifBlock& dataPtr) {
+		u32 i = hash(dataPtr);
+
+		while (m_table[i & m_mask].startPtr != 0)
+			i++;
+
+		m_table[i & m_mask] = dataPtr;
+		m_count++;
+	}
+
+	void grow() {
+		nVifBlock* old = m_table;
+		const u32 oldSize = m_mask + 1;
+
+		m_table = nullptr;
+		allocate(oldSize * 2);
+
+		for (u32 i = 0; i < oldSize; i++) {
+			if (old[i].startPtr != 0)
+				insert(old[i]);
+		}
+
+		_aligned_free(old);
+	}
 
 public:
 	HashBucket() {
-		m_bucket.fill(nullptr);
+		m_table = nullptr;
+		m_mask = 0;
+		m_count = 0;
 	}
 
 	~HashBucket() { clear(); }
 
 	__fi nVifBlock* find(const nVifBlock& dataPtr) {
-		nVifBlock* chainpos = m_bucket[dataPtr.hash_key];
+		u32 i = hash(dataPtr);
 
 		while (true) {
-			if (chainpos->key0 == dataPtr.key0 && chainpos->key1 == dataPtr.key1)
-				return chainpos;
+			nVifBlock* slot = &m_table[i & m_mask];
 
-			if (chainpos->startPtr == 0)
+			if (slot->startPtr == 0)
 				return nullptr;
 
-			chainpos++;
+			if (slot->key0 == dataPtr.key0 && slot->key1 == dataPtr.key1 && slot->hash_key == dataPtr.hash_key)
+				return slot;
+
+			i++;
 		}
 	}
 
 	void add(const nVifBlock& dataPtr) {
-		u32 b = dataPtr.hash_key;
+		if ((m_count + 1) * 2 > m_mask + 1)
+			grow();
 
-		u32 size = bucket_size( dataPtr );
-
-		// Warning there is an extra +1 due to the empty cell
-		// Performance note: 64B align to reduce cache miss penalty in `find`
-		if( (m_bucket[b] = (nVifBlock*)pcsx2_aligned_realloc( m_bucket[b], sizeof(nVifBlock)*(size+2), 64, sizeof(nVifBlock)*(size+1) )) == NULL ) {
-			throw Exception::OutOfMemory(
-				wxsFormat(L"HashBucket Chain (bucket size=%d)", size+2)
-			);
-		}
-
-		// Replace the empty cell by the new block and create a new empty cell
-		memcpy(&m_bucket[b][size++], &dataPtr, sizeof(nVifBlock));
-		memset(&m_bucket[b][size], 0, sizeof(nVifBlock));
-
-		if( size > 3 ) DevCon.Warning( "recVifUnpk: Bucket 0x%04x has %d micro-programs", b, size );
+		insert(dataPtr);
 	}
 
-	u32 bucket_size(const nVifBlock& dataPtr) {
-		nVifBlock* chainpos = m_bucket[dataPtr.hash_key];
+	u32 size() const { return m_count; }
+
+	// Average and longest probe sequence of a successful lookup, over all blocks.
+	void probe_stats(double& avg, u32& longest) const {
+		u64 total = 0;
+		longest = 0;
 
-		u32 size = 0;
+		for (u32 i = 0; i <= m_mask; i++) {
+			if (m_table[i].startPtr == 0) continue;
 
-		while (chainpos->startPtr != 0) {
-			size++;
-			chainpos++;
+			const u32 probes = ((i - hash(m_table[i])) & m_mask) + 1;
+			total += probes;
+			longest = std::max(longest, probes);
 		}
 
-		return size;
+		avg = m_count ? (double)total / m_count : 0.0;
 	}
 
 	void clear() {
-		for (auto& bucket : m_bucket)
-			safe_aligned_free(bucket);
+		safe_aligned_free(m_table);
+		m_mask = 0;
+		m_count = 0;
 	}
 
-	void reset() {
-		clear();
-
-		// Allocate an empty cell for all buckets
-		for (auto& bucket : m_bucket) {
-			if( (bucket = (nVifBlock*)_aligned_malloc( sizeof(nVifBlock), 64 )) == nullptr ) {
-				throw Exception::OutOfMemory(
-						wxsFormat(L"HashBucket Chain (bucket size=%d)", 1)
-						);
-			}
+	// Empties the table; size is the initial number of slots (a power of two).
+	void reset(u32 size) {
+		pxAssert((size & (size - 1)) == 0);
 
-			memset(bucket, 0, sizeof(nVifBlock));
+		if (m_table && m_mask + 1 == size) {
+			memset(m_table, 0, sizeof(nVifBlock)*size);
+			m_count = 0;
 		}
+		else
+			allocate(size);
 	}
 };
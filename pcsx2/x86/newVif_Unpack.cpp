@@ -23,6 +23,8 @@
 #include "newVif.h"
 #include "MTVU.h"
 
+#include "Utilities/Instrumentation.h"
+
 __aligned16 nVifStruct	nVif[2];
 
 // Interpreter-style SSE unpacks.  Array layout matches the interpreter C unpacks.
@@ -116,7 +118,10 @@ _vifT int nVifUnpack(const u8* data) {
 			if (!vifRegs.num) vifRegs.num = 256;
 		}
 
+		Instrumentation::Add(Instrumentation::Counter_VifUnpackBytes, size);
+
 		if (!idx || !THREAD_VU1) {
+			if (!idx && THREAD_VU0) vu0Thread.WaitVU(); // A VU0 program may be running since MSCAL
 			if (newVifDynaRec)	dVifUnpack<idx>(data, isFill);
 			else			   _nVifUnpack(idx, data, vifRegs.mode, isFill);
 		}
@@ -47,6 +47,7 @@ static HRESULT s_hr = E_FAIL;
 
 #include <gtk/gtk.h>
 #include <gdk/gdkx.h>
+#include <chrono>
 
 extern bool RunLinuxDialog();
 
@@ -62,6 +63,7 @@ static void (*s_irq)() = NULL;
 static uint8* s_basemem = NULL;
 static int s_vsync = 0;
 static bool s_exclusive = true;
+static bool s_headless = false; // GSopen2 without a window, see _GSopen
 static const char *s_renderer_name = "";
 static const char *s_renderer_type = "";
 bool gsopen_done = false; // crash guard for GSgetTitleInfo2 and GSKeyEvent (replace with lock?)
@@ -206,7 +208,7 @@ EXPORT_C GSclose()
 static int _GSopen(void** dsp, const char* title, GSRendererType renderer, int threads = -1)
 {
 	GSDevice* dev = NULL;
-	bool old_api = *dsp == NULL;
+	bool old_api = *dsp == NULL && !s_headless;
 
 	// Fresh start up or config file changed
 	if(renderer == GSRendererType::Undefined)
@@ -290,6 +292,11 @@ static int _GSopen(void** dsp, const char* title, GSRendererType renderer, int t
 			void *win_handle = *dsp;
 #endif
 
+			if(s_headless)
+			{
+				wnds.assign(1, std::make_shared<GSWndNull>(w, h));
+			}
+
 			for(auto& wnd : wnds)
 			{
 				try
@@ -504,6 +511,12 @@ EXPORT_C_(int) GSopen2(void** dsp, uint32 flags)
 	}
 	stored_toggle_state = toggle_state;
 
+	// The emulator has no window for us (headless), nothing but the null renderer can run then
+	s_headless = !!(flags & 8);
+
+	if(s_headless)
+		renderer = GSRendererType::Null;
+
 	int retval = _GSopen(dsp, "", renderer);
 
 	if (s_gs != NULL)
@@ -550,6 +563,7 @@ EXPORT_C_(int) GSopen(void** dsp, const char* title, int mt)
 	}
 
 	*dsp = NULL;
+	s_headless = false;
 
 	int retval = _GSopen(dsp, title, renderer);
 
@@ -775,6 +789,10 @@ EXPORT_C_(int) GSfreeze(int mode, GSFreezeData* data)
 		{
 			return s_gs->Freeze(data, false);
 		}
+		else if(mode == FREEZE_SAVE_INCREMENTAL)
+		{
+			return s_gs->Freeze(data, false, true);
+		}
 		else if(mode == FREEZE_SIZE)
 		{
 			return s_gs->Freeze(data, true);
@@ -783,6 +801,10 @@ EXPORT_C_(int) GSfreeze(int mode, GSFreezeData* data)
 		{
 			return s_gs->Defrost(data);
 		}
+		else if(mode == FREEZE_LOAD_INCREMENTAL)
+		{
+			return s_gs->Defrost(data, true);
+		}
 	}
 	catch (GSDXRecoverableError)
 	{
@@ -1285,6 +1307,34 @@ EXPORT_C GSBenchmark(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow
 
 				printf("%6d %6d | ", (int)((float)trlen * n / (end - start) / 1000), (int)((float)(w * h) * n / (end - start) / 1000));
 
+				// unaligned: partial blocks on every side
+
+				TRXPOS.DSAX = 5;
+				TRXPOS.DSAY = 3;
+				TRXREG.RRW = w - 10;
+				TRXREG.RRH = h - 6;
+
+				int trlen2 = (w - 10) * (h - 6) * psm.trbpp / 8;
+
+				start = clock();
+
+				for(int j = 0; j < n; j++)
+				{
+					int x = TRXPOS.DSAX;
+					int y = TRXPOS.DSAY;
+
+					(mem->*wi)(x, y, ptr, trlen2, BITBLTBUF, TRXPOS, TRXREG);
+				}
+
+				end = clock();
+
+				printf("%6d %6d | ", (int)((float)trlen2 * n / (end - start) / 1000), (int)((float)((w - 10) * (h - 6)) * n / (end - start) / 1000));
+
+				TRXPOS.DSAX = 0;
+				TRXPOS.DSAY = 0;
+				TRXREG.RRW = w;
+				TRXREG.RRH = h;
+
 				start = clock();
 
 				for(int j = 0; j < n; j++)
@@ -1393,6 +1443,139 @@ inline unsigned long timeGetTime()
 	return (unsigned long)(t.tv_sec*1000 + t.tv_nsec/1000000);
 }
 
+struct ReplayPacket {uint8 type, param; uint32 size, addr; std::vector<uint8> buff;};
+
+// Loads the GS state and registers saved in a dump and queues all its packets.
+// When repack_frames > 0 only that many frames are read, and written to a _repack.gs copy.
+static void ReplayLoadDump(char* lpszCmdLine, uint8* regs, std::list<ReplayPacket*>& packets, long repack_frames)
+{
+	bool repack_dump = (repack_frames > 0);
+	long frame_number = 0;
+
+	std::string f(lpszCmdLine);
+	bool is_xz = (f.size() >= 4) && (f.compare(f.size()-3, 3, ".xz") == 0);
+	if (is_xz)
+		f.replace(f.end()-6, f.end(), "_repack.gs");
+	else
+		f.replace(f.end()-3, f.end(), "_repack.gs");
+
+	GSDumpFile* file = is_xz
+		? (GSDumpFile*) new GSDumpLzma(lpszCmdLine, repack_dump ? f.c_str() : nullptr)
+		: (GSDumpFile*) new GSDumpRaw(lpszCmdLine, repack_dump ? f.c_str() : nullptr);
+
+	uint32 crc;
+	file->Read(&crc, 4);
+	GSsetGameCRC(crc, 0);
+
+	GSFreezeData fd;
+	file->Read(&fd.size, 4);
+	fd.data = new uint8[fd.size];
+	file->Read(fd.data, fd.size);
+
+	GSfreeze(FREEZE_LOAD, &fd);
+	delete [] fd.data;
+
+	file->Read(regs, 0x2000);
+
+	uint8 type;
+	while(file->Read(&type, 1))
+	{
+		ReplayPacket* p = new ReplayPacket();
+
+		p->type = type;
+
+		switch(type)
+		{
+		case 0:
+			file->Read(&p->param, 1);
+			file->Read(&p->size, 4);
+
+			switch(p->param)
+			{
+			case 0:
+				p->buff.resize(0x4000);
+				p->addr = 0x4000 - p->size;
+				file->Read(&p->buff[p->addr], p->size);
+				break;
+			case 1:
+			case 2:
+			case 3:
+				p->buff.resize(p->size);
+				file->Read(&p->buff[0], p->size);
+				break;
+			}
+
+			break;
+
+		case 1:
+			file->Read(&p->param, 1);
+			frame_number++;
+
+			break;
+
+		case 2:
+			file->Read(&p->size, 4);
+
+			break;
+
+		case 3:
+			p->buff.resize(0x2000);
+
+			file->Read(&p->buff[0], 0x2000);
+
+			break;
+		}
+
+		packets.push_back(p);
+
+		if (repack_dump && frame_number > repack_frames)
+			break;
+	}
+
+	delete file;
+}
+
+// Sends one packet to the GS, returns true when it ended a frame
+static bool ReplayPacketSend(ReplayPacket* p, uint8* regs, std::vector<uint8>& buff)
+{
+	switch(p->type)
+	{
+		case 0:
+
+			switch(p->param)
+			{
+				case 0: GSgifTransfer1(&p->buff[0], p->addr); break;
+				case 1: GSgifTransfer2(&p->buff[0], p->size / 16); break;
+				case 2: GSgifTransfer3(&p->buff[0], p->size / 16); break;
+				case 3: GSgifTransfer(&p->buff[0], p->size / 16); break;
+			}
+
+			break;
+
+		case 1:
+
+			GSvsync(p->param);
+
+			return true;
+
+		case 2:
+
+			if(buff.size() < p->size) buff.resize(p->size);
+
+			GSreadFIFO2(&buff[0], p->size / 16);
+
+			break;
+
+		case 3:
+
+			memcpy(regs, &p->buff[0], 0x2000);
+
+			break;
+	}
+
+	return false;
+}
+
 // Note
 EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 {
@@ -1412,9 +1595,7 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 		return;
 	}
 
-	struct Packet {uint8 type, param; uint32 size, addr; std::vector<uint8> buff;};
-
-	std::list<Packet*> packets;
+	std::list<ReplayPacket*> packets;
 	std::vector<uint8> buff;
 	uint8 regs[0x2000];
 
@@ -1439,160 +1620,227 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 	}
 	if (s_gs->m_wnd == NULL) return;
 
-	{ // Read .gs content
-		std::string f(lpszCmdLine);
-		bool is_xz = (f.size() >= 4) && (f.compare(f.size()-3, 3, ".xz") == 0);
-		if (is_xz)
-			f.replace(f.end()-6, f.end(), "_repack.gs");
-		else
-			f.replace(f.end()-3, f.end(), "_repack.gs");
-
-		GSDumpFile* file = is_xz
-			? (GSDumpFile*) new GSDumpLzma(lpszCmdLine, repack_dump ? f.c_str() : nullptr)
-			: (GSDumpFile*) new GSDumpRaw(lpszCmdLine, repack_dump ? f.c_str() : nullptr);
+	ReplayLoadDump(lpszCmdLine, regs, packets, repack_dump ? -finished : 0);
 
-		uint32 crc;
-		file->Read(&crc, 4);
-		GSsetGameCRC(crc, 0);
+	sleep(2);
 
-		GSFreezeData fd;
-		file->Read(&fd.size, 4);
-		fd.data = new uint8[fd.size];
-		file->Read(fd.data, fd.size);
 
-		GSfreeze(FREEZE_LOAD, &fd);
-		delete [] fd.data;
+	frame_number = 0;
 
-		file->Read(regs, 0x2000);
+	// Init vsync stuff
+	GSvsync(1);
 
-		uint8 type;
-		while(file->Read(&type, 1))
+	while(finished > 0)
+	{
+		for(auto i = packets.begin(); i != packets.end(); i++)
 		{
-			Packet* p = new Packet();
-
-			p->type = type;
+			if (ReplayPacketSend(*i, regs, buff))
+				frame_number++;
+		}
 
-			switch(type)
-			{
-			case 0:
-				file->Read(&p->param, 1);
-				file->Read(&p->size, 4);
+		if (finished >= 200) {
+			; // Nop for Nvidia Profiler
+		} else if (finished > 90) {
+			sleep(1);
+		} else {
+			finished--;
+		}
+	}
 
-				switch(p->param)
-				{
-				case 0:
-					p->buff.resize(0x4000);
-					p->addr = 0x4000 - p->size;
-					file->Read(&p->buff[p->addr], p->size);
-					break;
-				case 1:
-				case 2:
-				case 3:
-					p->buff.resize(p->size);
-					file->Read(&p->buff[0], p->size);
-					break;
-				}
+	static_cast<GSDeviceOGL*>(s_gs->m_dev)->GenerateProfilerData();
 
-				break;
+#ifdef ENABLE_OGL_DEBUG_MEM_BW
+	unsigned long total_frame_nb = std::max(1l, frame_number) << 10;
+	fprintf(stderr, "memory bandwith. T: %f KB/f. V: %f KB/f. U: %f KB/f\n",
+			(float)g_real_texture_upload_byte/(float)total_frame_nb,
+			(float)g_vertex_upload_byte/(float)total_frame_nb,
+			(float)g_uniform_upload_byte/(float)total_frame_nb
+		   );
+#endif
 
-			case 1:
-				file->Read(&p->param, 1);
-				frame_number++;
+	for(auto i = packets.begin(); i != packets.end(); i++)
+	{
+		delete *i;
+	}
 
-				break;
+	packets.clear();
 
-			case 2:
-				file->Read(&p->size, 4);
+	sleep(2);
 
-				break;
+	GSclose();
+	GSshutdown();
+}
 
-			case 3:
-				p->buff.resize(0x2000);
+// Replays a dump loops times as fast as possible and reports the per-frame cost.
+// The json file (if any) gets the same numbers in machine readable form, so runs
+// over a corpus of dumps can be compared against each other.
+EXPORT_C GSReplayBenchmark(char* lpszCmdLine, int renderer, int loops, char* json)
+{
+	GLLoader::in_replayer = true;
+	// Required by multithread driver
+	XInitThreads();
 
-				file->Read(&p->buff[0], 0x2000);
+	GSinit();
 
-				break;
-			}
+	GSRendererType m_renderer = static_cast<GSRendererType>(renderer);
 
-			packets.push_back(p);
+	if (m_renderer != GSRendererType::OGL_HW && m_renderer != GSRendererType::OGL_SW && m_renderer != GSRendererType::Null)
+	{
+		fprintf(stderr, "wrong renderer selected %d\n", static_cast<int>(m_renderer));
+		return;
+	}
 
-			if (repack_dump && frame_number > -finished)
-				break;
-		}
+	std::list<ReplayPacket*> packets;
+	std::vector<uint8> buff;
+	uint8 regs[0x2000];
 
-		delete file;
-	}
+	GSsetBaseMem(regs);
 
-	sleep(2);
+	s_vsync = 0; // Don't let the display rate hide the real cost
 
+	void* hWnd = NULL;
+	int err = _GSopen((void**)&hWnd, "", m_renderer);
+	if (err != 0) {
+		fprintf(stderr, "Error failed to GSopen\n");
+		return;
+	}
+	if (s_gs->m_wnd == NULL) return;
 
-	frame_number = 0;
+	ReplayLoadDump(lpszCmdLine, regs, packets, 0);
 
 	// Init vsync stuff
 	GSvsync(1);
 
-	while(finished > 0)
+	static const GSPerfMon::counter_t s_counters[] =
+	{
+		GSPerfMon::Draw, GSPerfMon::DrawMerged, GSPerfMon::Prim,
+		GSPerfMon::TextureHit, GSPerfMon::TextureMiss, GSPerfMon::TextureEvict,
+		GSPerfMon::TargetScan, GSPerfMon::PageHashHit, GSPerfMon::PageHashMiss,
+		GSPerfMon::VertexDedup, GSPerfMon::ClutHit, GSPerfMon::ClutMiss,
+		GSPerfMon::Swizzle, GSPerfMon::Unswizzle,
+	};
+
+	static const char* s_counter_names[] =
+	{
+		"draw", "draw_merged", "prim",
+		"tc_hit", "tc_miss", "tc_evict",
+		"tc_target_scan", "tc_page_hash_hit", "tc_page_hash_miss",
+		"vertex_dedup", "clut_hit", "clut_miss",
+		"swizzle_bytes", "unswizzle_bytes",
+	};
+
+	GSPerfMon& pm = s_gs->m_perfmon;
+
+	std::vector<double> frame_ms;
+	std::vector<double> frame_draws;
+	double start_totals[countof(s_counters)];
+	double draws = pm.GetTotal(GSPerfMon::Draw);
+	double prims = pm.GetTotal(GSPerfMon::Prim);
+	uint64 vt_ticks = pm.GetTimerTotal(GSPerfMon::VertexTraceTime);
+
+	for(size_t c = 0; c < countof(s_counters); c++)
+	{
+		start_totals[c] = pm.GetTotal(s_counters[c]);
+	}
+
+	auto frame_start = std::chrono::high_resolution_clock::now();
+
+	for(int loop = 0; loop < std::max(loops, 1); loop++)
 	{
 		for(auto i = packets.begin(); i != packets.end(); i++)
 		{
-			Packet* p = *i;
+			if (!ReplayPacketSend(*i, regs, buff))
+				continue;
 
-			switch(p->type)
-			{
-				case 0:
+			auto now = std::chrono::high_resolution_clock::now();
 
-					switch(p->param)
-					{
-						case 0: GSgifTransfer1(&p->buff[0], p->addr); break;
-						case 1: GSgifTransfer2(&p->buff[0], p->size / 16); break;
-						case 2: GSgifTransfer3(&p->buff[0], p->size / 16); break;
-						case 3: GSgifTransfer(&p->buff[0], p->size / 16); break;
-					}
+			frame_ms.push_back(std::chrono::duration<double, std::milli>(now - frame_start).count());
+			frame_draws.push_back(pm.GetTotal(GSPerfMon::Draw) - draws);
 
-					break;
+			draws = pm.GetTotal(GSPerfMon::Draw);
+			frame_start = now;
+		}
+	}
 
-				case 1:
+	// Report
 
-					GSvsync(p->param);
-					frame_number++;
+	size_t frames = std::max<size_t>(frame_ms.size(), 1);
+	std::vector<double> sorted(frame_ms);
+	std::sort(sorted.begin(), sorted.end());
 
-					break;
+	double total = 0;
+	for(double ms : frame_ms) total += ms;
 
-				case 2:
+	double min = sorted.empty() ? 0 : sorted.front();
+	double max = sorted.empty() ? 0 : sorted.back();
+	double avg = total / frames;
+	double p99 = sorted.empty() ? 0 : sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
 
-					if(buff.size() < p->size) buff.resize(p->size);
+	double totals[countof(s_counters)];
 
-					GSreadFIFO2(&buff[0], p->size / 16);
+	for(size_t c = 0; c < countof(s_counters); c++)
+	{
+		totals[c] = pm.GetTotal(s_counters[c]) - start_totals[c];
+	}
 
-					break;
+	// GSVertexTrace::Update, the min/max scan of every draw's vertices, in millions of rdtsc ticks
+	double vt_mcycles = (double)(pm.GetTimerTotal(GSPerfMon::VertexTraceTime) - vt_ticks) / 1e6;
 
-				case 3:
+	prims = pm.GetTotal(GSPerfMon::Prim) - prims;
 
-					memcpy(regs, &p->buff[0], 0x2000);
+	fprintf(stderr, "%s: %d frames, %.3f ms/frame (min %.3f, p99 %.3f, max %.3f)\n", lpszCmdLine, (int)frame_ms.size(), avg, min, p99, max);
 
-					break;
+	for(size_t c = 0; c < countof(s_counters); c++)
+	{
+		fprintf(stderr, "  %-16s %14.0f (%.1f/frame)\n", s_counter_names[c], totals[c], totals[c] / frames);
+	}
+
+	fprintf(stderr, "  %-16s %14.3f (%.4f/frame, %.1f cycles/prim)\n", "vt_mcycles", vt_mcycles, vt_mcycles / frames,
+		prims > 0 ? vt_mcycles * 1e6 / prims : 0.0);
+
+	if (json && *json)
+	{
+		FILE* fp = fopen(json, "w");
+
+		if (fp)
+		{
+			std::string dump;
+
+			for(const char* c = lpszCmdLine; *c; c++)
+			{
+				if (*c == '"' || *c == '\\') dump += '\\';
+				dump += *c;
 			}
-		}
 
-		if (finished >= 200) {
-			; // Nop for Nvidia Profiler
-		} else if (finished > 90) {
-			sleep(1);
-		} else {
-			finished--;
-		}
-	}
+			fprintf(fp, "{\n");
+			fprintf(fp, "\t\"dump\": \"%s\",\n", dump.c_str());
+			fprintf(fp, "\t\"renderer\": %d,\n", renderer);
+			fprintf(fp, "\t\"loops\": %d,\n", std::max(loops, 1));
+			fprintf(fp, "\t\"frames\": %d,\n", (int)frame_ms.size());
+			fprintf(fp, "\t\"frame_ms\": {\"min\": %f, \"avg\": %f, \"p99\": %f, \"max\": %f},\n", min, avg, p99, max);
 
-	static_cast<GSDeviceOGL*>(s_gs->m_dev)->GenerateProfilerData();
+			for(size_t c = 0; c < countof(s_counters); c++)
+			{
+				fprintf(fp, "\t\"%s\": %.0f,\n", s_counter_names[c], totals[c]);
+			}
 
-#ifdef ENABLE_OGL_DEBUG_MEM_BW
-	unsigned long total_frame_nb = std::max(1l, frame_number) << 10;
-	fprintf(stderr, "memory bandwith. T: %f KB/f. V: %f KB/f. U: %f KB/f\n",
-			(float)g_real_texture_upload_byte/(float)total_frame_nb,
-			(float)g_vertex_upload_byte/(float)total_frame_nb,
-			(float)g_uniform_upload_byte/(float)total_frame_nb
-		   );
-#endif
+			fprintf(fp, "\t\"vt_mcycles\": %f,\n", vt_mcycles);
+
+			fprintf(fp, "\t\"per_frame\": [");
+
+			for(size_t i = 0; i < frame_ms.size(); i++)
+			{
+				fprintf(fp, "%s\n\t\t{\"ms\": %f, \"draw\": %.0f}", i ? "," : "", frame_ms[i], frame_draws[i]);
+			}
+
+			fprintf(fp, "\n\t]\n}\n");
+			fclose(fp);
+		}
+		else
+		{
+			fprintf(stderr, "Failed to open %s\n", json);
+		}
+	}
 
 	for(auto i = packets.begin(); i != packets.end(); i++)
 	{
@@ -1601,8 +1849,6 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 
 	packets.clear();
 
-	sleep(2);
-
 	GSclose();
 	GSshutdown();
 }
@@ -86,6 +86,8 @@ enum GIF_REG_COMPLEX
 {
 	GIF_REG_STQRGBAXYZF2	= 0x00,
 	GIF_REG_STQRGBAXYZ2		= 0x01,
+	GIF_REG_UVRGBAXYZF2		= 0x02,
+	GIF_REG_UVRGBAXYZ2		= 0x03,
 };
 
 enum GIF_A_D_REG
@@ -1123,7 +1125,7 @@ struct alignas(32) GIFPath
 	uint32 type;
 	GSVector4i regs;
 
-	enum {TYPE_UNKNOWN, TYPE_ADONLY, TYPE_STQRGBAXYZF2, TYPE_STQRGBAXYZ2};
+	enum {TYPE_UNKNOWN, TYPE_ADONLY, TYPE_STQRGBAXYZF2, TYPE_STQRGBAXYZ2, TYPE_UVRGBAXYZF2, TYPE_UVRGBAXYZ2};
 
 	__forceinline void SetTag(const void* mem)
 	{
@@ -1164,7 +1166,8 @@ struct alignas(32) GIFPath
 				case 3:
 					if(regs.u32[0] == 0x00040102) type = TYPE_STQRGBAXYZF2; // many games, TODO: formats mixed with NOPs (xeno2: 040f010f02, 04010f020f, mgs3: 04010f0f02, 0401020f0f, 04010f020f)
 					if(regs.u32[0] == 0x00050102) type = TYPE_STQRGBAXYZ2; // GoW (has other crazy formats, like ...030503050103)
-					// TODO: common types with UV instead
+					if(regs.u32[0] == 0x00040103) type = TYPE_UVRGBAXYZF2; // 2d sprites, fonts (FST=1)
+					if(regs.u32[0] == 0x00050103) type = TYPE_UVRGBAXYZ2;
 					break;
 				case 4: break;
 				case 5: break;
@@ -1405,7 +1408,7 @@ struct GSPrivRegSet
 enum {KEYPRESS=1, KEYRELEASE=2};
 struct GSKeyEventData {uint32 key, type;};
 
-enum {FREEZE_LOAD=0, FREEZE_SAVE=1, FREEZE_SIZE=2};
+enum {FREEZE_LOAD=0, FREEZE_SAVE=1, FREEZE_SIZE=2, FREEZE_SAVE_INCREMENTAL=3, FREEZE_LOAD_INCREMENTAL=4};
 struct GSFreezeData {int size; uint8* data;};
 
 enum stateType {ST_WRITE, ST_TRANSFER, ST_VSYNC};
@@ -2070,7 +2070,30 @@ public:
 	{
 		//printf("ReadAndExpandBlock8H_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		const GSVector8i* s = (const GSVector8i*)src;
+
+		GSVector8i v0, v1;
+
+		for(int i = 0; i < 4; i++)
+		{
+			v0 = s[i * 2 + 0];
+			v1 = s[i * 2 + 1];
+
+			GSVector8i::sw128(v0, v1);
+			GSVector8i::sw64(v0, v1);
+
+			(v0 >> 24).gather32_32<>(pal, (GSVector8i*)dst);
+
+			dst += dstpitch;
+
+			(v1 >> 24).gather32_32<>(pal, (GSVector8i*)dst);
+
+			dst += dstpitch;
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -2113,7 +2136,30 @@ public:
 	{
 		//printf("ReadAndExpandBlock4HL_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		const GSVector8i* s = (const GSVector8i*)src;
+
+		GSVector8i v0, v1;
+
+		for(int i = 0; i < 4; i++)
+		{
+			v0 = s[i * 2 + 0];
+			v1 = s[i * 2 + 1];
+
+			GSVector8i::sw128(v0, v1);
+			GSVector8i::sw64(v0, v1);
+
+			((v0 >> 24) & 0xf).gather32_32<>(pal, (GSVector8i*)dst);
+
+			dst += dstpitch;
+
+			((v1 >> 24) & 0xf).gather32_32<>(pal, (GSVector8i*)dst);
+
+			dst += dstpitch;
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -2156,7 +2202,30 @@ public:
 	{
 		//printf("ReadAndExpandBlock4HH_32\n");
 
-		#if _M_SSE >= 0x401
+		#if _M_SSE >= 0x501
+
+		const GSVector8i* s = (const GSVector8i*)src;
+
+		GSVector8i v0, v1;
+
+		for(int i = 0; i < 4; i++)
+		{
+			v0 = s[i * 2 + 0];
+			v1 = s[i * 2 + 1];
+
+			GSVector8i::sw128(v0, v1);
+			GSVector8i::sw64(v0, v1);
+
+			(v0 >> 28).gather32_32<>(pal, (GSVector8i*)dst);
+
+			dst += dstpitch;
+
+			(v1 >> 28).gather32_32<>(pal, (GSVector8i*)dst);
+
+			dst += dstpitch;
+		}
+
+		#elif _M_SSE >= 0x401
 
 		const GSVector4i* s = (const GSVector4i*)src;
 
@@ -396,6 +396,9 @@ GSCapture::GSCapture()
 	m_threads = theApp.GetConfigI("capture_threads");
 #if defined(__unix__)
 	m_compression_level = theApp.GetConfigI("png_compression_level");
+	m_format = theApp.GetConfigI("capture_format");
+	m_dropped = 0;
+	m_y4m = NULL;
 #endif
 }
 
@@ -498,8 +501,31 @@ bool GSCapture::BeginCapture(float fps, GSVector2i recommendedResolution, float
 	m_size.x = theApp.GetConfigI("CaptureWidth");
 	m_size.y = theApp.GetConfigI("CaptureHeight");
 
-	for(int i = 0; i < m_threads; i++) {
-		m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+	m_dropped = 0;
+
+	if(m_format == FORMAT_Y4M)
+	{
+		std::string out_file = m_out_dir + "/capture.y4m";
+
+		m_y4m = px_fopen(out_file, "wb");
+
+		if(m_y4m == NULL)
+		{
+			fprintf(stderr, "Failed to create %s\n", out_file.c_str());
+
+			return false;
+		}
+
+		fprintf(m_y4m, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C444\n", m_size.x, m_size.y, (int)(fps * 1000 + 0.5f));
+
+		// Frames of a stream must stay in order, a single encoder (the conversion is cheap anyway)
+		m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker([this](std::shared_ptr<GSPng::Transaction>& item) {WriteY4M(item);})));
+	}
+	else
+	{
+		for(int i = 0; i < m_threads; i++) {
+			m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+		}
 	}
 #endif
 
@@ -530,9 +556,22 @@ bool GSCapture::DeliverFrame(const void* bits, int pitch, bool rgba)
 
 #elif defined(__unix__)
 
-	std::string out_file = m_out_dir + format("/frame.%010d.png", m_frame);
+	std::string out_file = m_format == FORMAT_Y4M ? std::string() : m_out_dir + format("/frame.%010d.png", m_frame);
 	//GSPng::Save(GSPng::RGB_PNG, out_file, (uint8*)bits, m_size.x, m_size.y, pitch, m_compression_level);
-	m_workers[m_frame%m_threads]->Push(std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, out_file, static_cast<const uint8*>(bits), m_size.x, m_size.y, pitch, m_compression_level));
+	std::shared_ptr<GSPng::Transaction> item = std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, out_file, static_cast<const uint8*>(bits), m_size.x, m_size.y, pitch, m_compression_level);
+
+	// Never stall the emulation on a slow encoder, skip the frame instead (png numbering keeps the gap)
+	bool queued = false;
+
+	for(size_t i = 0; i < m_workers.size() && !queued; i++)
+	{
+		queued = m_workers[(m_frame + i) % m_workers.size()]->TryPush(item);
+	}
+
+	if(!queued)
+	{
+		m_dropped++;
+	}
 
 	m_frame++;
 
@@ -541,6 +580,41 @@ bool GSCapture::DeliverFrame(const void* bits, int pitch, bool rgba)
 	return false;
 }
 
+#if defined(__unix__)
+// BT.601 limited range, 4:4:4 so that nothing is lost to chroma subsampling
+void GSCapture::WriteY4M(std::shared_ptr<GSPng::Transaction>& item)
+{
+	const int w = item->m_w;
+	const int h = item->m_h;
+	const size_t plane = (size_t)w * h;
+
+	m_y4m_planes.resize(plane * 3);
+
+	uint8* RESTRICT Y = m_y4m_planes.data();
+	uint8* RESTRICT U = Y + plane;
+	uint8* RESTRICT V = U + plane;
+
+	for(int y = 0; y < h; y++)
+	{
+		const uint8* RESTRICT src = item->m_image + y * item->m_pitch;
+
+		for(int x = 0; x < w; x++, src += 4)
+		{
+			int r = src[0];
+			int g = src[1];
+			int b = src[2];
+
+			*Y++ = (uint8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+			*U++ = (uint8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			*V++ = (uint8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+
+	fputs("FRAME\n", m_y4m);
+	fwrite(m_y4m_planes.data(), 1, plane * 3, m_y4m);
+}
+#endif
+
 bool GSCapture::EndCapture()
 {
 	std::lock_guard<std::recursive_mutex> lock(m_lock);
@@ -564,6 +638,22 @@ bool GSCapture::EndCapture()
 #elif defined(__unix__)
 	m_workers.clear();
 
+	if(m_y4m)
+	{
+		fclose(m_y4m);
+
+		m_y4m = NULL;
+	}
+
+	if(m_dropped > 0)
+	{
+		fprintf(stderr, "Capture: %llu of %llu frames dropped, the encoder couldn't keep up\n", (unsigned long long)m_dropped, (unsigned long long)m_frame);
+
+		m_dropped = 0;
+	}
+
+	GSPng::Transaction::ReleasePool();
+
 	m_frame = 0;
 
 #endif
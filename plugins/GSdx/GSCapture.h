@@ -44,8 +44,16 @@ class GSCapture
 
 	#elif defined(__unix__)
 
+	enum {FORMAT_PNG, FORMAT_Y4M};
+
 	std::vector<std::unique_ptr<GSPng::Worker>> m_workers;
 	int m_compression_level;
+	int m_format;
+	uint64 m_dropped;
+	FILE* m_y4m;
+	std::vector<uint8> m_y4m_planes;
+
+	void WriteY4M(std::shared_ptr<GSPng::Transaction>& item);
 
 	#endif
 
@@ -22,17 +22,34 @@
 #include "stdafx.h"
 #include "GSClut.h"
 #include "GSLocalMemory.h"
+#include "GSPerfMon.h"
 
-#define CLUT_ALLOC_SIZE (2 * 4096)
+#define CLUT_ALLOC_SIZE (2048 + ReadCacheSize * 3072)
 
 GSClut::GSClut(GSLocalMemory* mem)
 	: m_mem(mem)
+	, m_perfmon(NULL)
+	, m_read_age(0)
 {
 	uint8* p = (uint8*)vmalloc(CLUT_ALLOC_SIZE, false);
 
 	m_clut = (uint16*)&p[0]; // 1k + 1k for mirrored area simulating wrapping memory
-	m_buff32 = (uint32*)&p[2048]; // 1k
-	m_buff64 = (uint64*)&p[4096]; // 2k
+
+	for(int i = 0; i < ReadCacheSize; i++)
+	{
+		ReadCacheEntry& e = m_read_cache[i];
+
+		e.fmt = 0;
+		e.age = 0;
+		e.buff32 = (uint32*)&p[2048 + i * 3072]; // 1k
+		e.buff64 = (uint64*)&p[2048 + i * 3072 + 1024]; // 2k
+		e.amin = e.amax = 0;
+		e.alpha = false;
+	}
+
+	m_read_entry = &m_read_cache[0];
+	m_buff32 = m_read_entry->buff32;
+	m_buff64 = m_read_entry->buff64;
 	m_write.dirty = true;
 	m_read.dirty = true;
 
@@ -286,6 +303,94 @@ void GSClut::Read(const GIFRegTEX0& TEX0)
 }
 #endif
 
+// Same scheme as the texture cache's page hash, over n entries (a multiple of 16)
+static uint64 HashClut(const uint16* RESTRICT clut, int n, uint64 seed)
+{
+	const uint64* RESTRICT src = (const uint64*)clut;
+
+	uint64 h[4] = {0x9e3779b97f4a7c15ull ^ seed, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull, 0x27d4eb2f165667c5ull};
+
+	for(int i = 0; i < n / 4; i += 4)
+	{
+		for(int j = 0; j < 4; j++)
+		{
+			uint64 x = h[j] ^ src[i + j];
+
+			h[j] = ((x << 31) | (x >> 33)) * 0x9e3779b97f4a7c15ull;
+		}
+	}
+
+	return h[0] ^ ((h[1] << 17) | (h[1] >> 47)) ^ ((h[2] << 34) | (h[2] >> 30)) ^ ((h[3] << 51) | (h[3] >> 13));
+}
+
+bool GSClut::ReadCached(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
+{
+	const uint16* clut = m_clut;
+	int pal = GSLocalMemory::m_psm[TEX0.PSM].pal;
+	uint64 hash;
+
+	if(TEX0.CPSM == PSM_PSMCT32 || TEX0.CPSM == PSM_PSMCT24)
+	{
+		clut += (TEX0.CSA & 15) << 4;
+		hash = HashClut(clut + 256, pal, HashClut(clut, pal, 0)); // both halves of the colors
+	}
+	else
+	{
+		clut += TEX0.CSA << 4;
+		hash = HashClut(clut, pal, 0);
+	}
+
+	// TEXA only changes the expansion of 16 bit colors, but also goes into the alpha range
+	uint32 fmt = TEX0.CPSM | (pal << 8);
+
+	ReadCacheEntry* e = NULL;
+	ReadCacheEntry* oldest = &m_read_cache[0];
+
+	for(int i = 0; i < ReadCacheSize; i++)
+	{
+		ReadCacheEntry& c = m_read_cache[i];
+
+		if(c.fmt == fmt && c.hash == hash && c.TEXA.u64 == TEXA.u64)
+		{
+			e = &c;
+			break;
+		}
+
+		if(c.age < oldest->age)
+		{
+			oldest = &c;
+		}
+	}
+
+	bool hit = e != NULL;
+
+	if(!hit)
+	{
+		e = oldest;
+		e->hash = hash;
+		e->TEXA = TEXA;
+		e->fmt = fmt;
+		e->alpha = false;
+	}
+
+	e->age = ++m_read_age;
+
+	m_read_entry = e;
+	m_buff32 = e->buff32;
+	m_buff64 = e->buff64;
+
+	m_read.adirty = !e->alpha;
+	m_read.amin = e->amin;
+	m_read.amax = e->amax;
+
+	if(m_perfmon)
+	{
+		m_perfmon->Put(hit ? GSPerfMon::ClutHit : GSPerfMon::ClutMiss, 1);
+	}
+
+	return hit;
+}
+
 void GSClut::Read32(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 {
 	if(m_read.IsDirty(TEX0, TEXA))
@@ -293,7 +398,11 @@ void GSClut::Read32(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 		m_read.TEX0 = TEX0;
 		m_read.TEXA = TEXA;
 		m_read.dirty = false;
-		m_read.adirty = true;
+
+		if(ReadCached(TEX0, TEXA))
+		{
+			return;
+		}
 
 		uint16* clut = m_clut;
 
@@ -399,6 +508,10 @@ void GSClut::GetAlphaMinMax32(int& amin_out, int& amax_out)
 			m_read.amin = v0.min_i16(v1).extract16<0>();
 			m_read.amax = v0.max_i16(v1).extract16<1>();
 		}
+
+		m_read_entry->amin = m_read.amin;
+		m_read_entry->amax = m_read.amax;
+		m_read_entry->alpha = true;
 	}
 
 	amin_out = m_read.amin;
@@ -27,6 +27,7 @@
 #include "GSAlignedClass.h"
 
 class GSLocalMemory;
+class GSPerfMon;
 
 class alignas(32) GSClut : public GSAlignedClass<32>
 {
@@ -35,6 +36,7 @@ class alignas(32) GSClut : public GSAlignedClass<32>
 	static GSVector4i m_rm;
 
 	GSLocalMemory* m_mem;
+	GSPerfMon* m_perfmon;
 
 	uint32 m_CBP[2];
 	uint16* m_clut;
@@ -60,6 +62,29 @@ class alignas(32) GSClut : public GSAlignedClass<32>
 		bool IsDirty(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
 	} m_read;
 
+	// Recently read palettes, keyed by a hash of the CLUT entries they were expanded from, so that
+	// a palette loaded again (usually with the same data) doesn't have to be expanded again.
+	// m_buff32/m_buff64 point into the entry that was read last.
+	enum {ReadCacheSize = 8};
+
+	struct ReadCacheEntry
+	{
+		uint64 hash;
+		GIFRegTEXA TEXA;
+		uint32 fmt; // CPSM | pal << 8, 0 if unused
+		uint32 age;
+		uint32* buff32;
+		uint64* buff64;
+		int amin, amax;
+		bool alpha; // amin and amax are known
+	};
+
+	ReadCacheEntry m_read_cache[ReadCacheSize];
+	ReadCacheEntry* m_read_entry;
+	uint32 m_read_age;
+
+	bool ReadCached(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
+
 	typedef void (GSClut::*writeCLUT)(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT);
 
 	writeCLUT m_wc[2][16][64];
@@ -102,6 +127,8 @@ public:
 	GSClut(GSLocalMemory* mem);
 	virtual ~GSClut();
 
+	void SetPerfMon(GSPerfMon* pm) {m_perfmon = pm;}
+
 	void Invalidate();
 	void Invalidate(uint32 block);
 	bool WriteTest(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT);
@@ -117,16 +117,31 @@ void GSDump::AppendRawData(uint8 c)
 // GSDumpXz implementation
 //////////////////////////////////////////////////////////////////////
 
+static const size_t s_xz_block_size = 4 * 1024 * 1024;
+
 GSDumpXz::GSDumpXz(const std::string& fn, uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs)
 	: GSDumpBase(fn + ".gs.xz")
 {
 	m_strm = LZMA_STREAM_INIT;
+
+#if LZMA_VERSION >= 50020002
+	// Each encoder thread needs about 100MB at level 6, keep it to two of them
+	lzma_mt mt;
+	memset(&mt, 0, sizeof(mt));
+	mt.threads = std::min(std::max(std::thread::hardware_concurrency() / 2, 1u), 2u);
+	mt.preset = 6;
+	mt.check = LZMA_CHECK_CRC64;
+	lzma_ret ret = lzma_stream_encoder_mt(&m_strm, &mt);
+#else
 	lzma_ret ret = lzma_easy_encoder(&m_strm, 6 /*level*/, LZMA_CHECK_CRC64);
+#endif
 	if (ret != LZMA_OK) {
 		fprintf(stderr, "GSDumpXz: Error initializing LZMA encoder ! (error code %u)\n", ret);
 		return;
 	}
 
+	m_compressor = std::unique_ptr<Compressor>(new Compressor([this](Block& block) {CompressBlock(block);}));
+
 	AddHeader(crc, fd, regs);
 }
 
@@ -134,6 +149,9 @@ GSDumpXz::~GSDumpXz()
 {
 	Flush();
 
+	// Waits for the queued blocks
+	m_compressor = nullptr;
+
 	// Finish the stream
 	m_strm.avail_in = 0;
 	Compress(LZMA_FINISH, LZMA_STREAM_END);
@@ -143,34 +161,69 @@ GSDumpXz::~GSDumpXz()
 
 void GSDumpXz::AppendRawData(const void *data, size_t size)
 {
-	size_t old_size = m_in_buff.size();
-	m_in_buff.resize(old_size + size);
-	memcpy(&m_in_buff[old_size], data, size);
+	const uint8* src = static_cast<const uint8*>(data);
+
+	// Transfers can be bigger than a block, they are split
+	while (size > 0)
+	{
+		if (!m_in_buff)
+		{
+			std::lock_guard<std::mutex> l(m_pool_lock);
+
+			if (!m_pool.empty())
+			{
+				m_in_buff = m_pool.back();
+				m_pool.pop_back();
+			}
+			else
+			{
+				m_in_buff = std::make_shared<std::vector<uint8>>();
+				m_in_buff->reserve(s_xz_block_size);
+			}
+		}
+
+		size_t len = std::min(size, s_xz_block_size - m_in_buff->size());
+
+		m_in_buff->insert(m_in_buff->end(), src, src + len);
+
+		src += len;
+		size -= len;
 
-	// Enough data was accumulated, time to write/compress it.  If compression
-	// is enabled, it will freeze PCSX2. 1GB should be enough for long dump.
-	//
-	// Note: long dumps are currently not supported so this path won't be executed
-	if (m_in_buff.size() > 1024*1024*1024)
-		Flush();
+		if (m_in_buff->size() >= s_xz_block_size)
+			Flush();
+	}
 }
 
 void GSDumpXz::AppendRawData(uint8 c)
 {
-	m_in_buff.push_back(c);
+	AppendRawData(&c, 1);
 }
 
 void GSDumpXz::Flush()
 {
-	if (m_in_buff.empty())
+	if (!m_in_buff || m_in_buff->empty())
 		return;
 
-	m_strm.next_in = m_in_buff.data();
-	m_strm.avail_in = m_in_buff.size();
+	if (m_compressor)
+		m_compressor->Push(m_in_buff); // waits if the compressor is that far behind
+
+	m_in_buff = nullptr;
+}
+
+// Compressor thread
+void GSDumpXz::CompressBlock(Block& block)
+{
+	m_strm.next_in = block->data();
+	m_strm.avail_in = block->size();
 
 	Compress(LZMA_RUN, LZMA_OK);
 
-	m_in_buff.clear();
+	block->clear();
+
+	std::lock_guard<std::mutex> l(m_pool_lock);
+
+	m_pool.push_back(block);
+	block = nullptr;
 }
 
 void GSDumpXz::Compress(lzma_action action, lzma_ret expected_status)
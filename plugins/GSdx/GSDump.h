@@ -22,6 +22,7 @@
 #pragma once
 
 #include "GS.h"
+#include "GSThread_CXX11.h"
 #include "Renderers/SW/GSVertexSW.h"
 #include <lzma.h>
 
@@ -76,14 +77,25 @@ public:
 	virtual ~GSDump() = default;
 };
 
+// The data is gathered in blocks that a background thread compresses (with the multithreaded
+// encoder where liblzma has it) and writes, so the GS thread only copies.  At most a few
+// blocks are in flight, filling more waits for the compressor; the blocks are reused.
 class GSDumpXz final : public GSDumpBase
 {
+	typedef std::shared_ptr<std::vector<uint8>> Block;
+	typedef GSJobQueue<Block, 8> Compressor;
+
 	lzma_stream m_strm;
 
-	std::vector<uint8> m_in_buff;
+	Block m_in_buff;
+	std::unique_ptr<Compressor> m_compressor;
+
+	std::mutex m_pool_lock;
+	std::vector<Block> m_pool; // m_pool_lock
 
 	void Flush();
 	void Compress(lzma_action action, lzma_ret expected_status);
+	void CompressBlock(Block& block);
 	void AppendRawData(const void *data, size_t size);
 	void AppendRawData(uint8 c);
 
@@ -0,0 +1,176 @@
+/*
+ *	Copyright (C) 2007-2016 PCSX2 Dev Team
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GSInstrumentation.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Instrumentation::SharedHeader: magic, version, counterCount, ringSize, tickFrequency, pid,
+// reserved, then a 24 byte name per counter and the 64-bit ringWrite.  The counter slots
+// (64-bit events and total) follow it.
+
+static const uint32 s_magic = 0x52534e49; // 'INSR'
+static const uint32 s_version = 1;
+static const size_t s_fixed_header = 32;
+static const size_t s_name_size = 24;
+
+static size_t SlotsOffset(uint32 count)
+{
+	return s_fixed_header + count * s_name_size + 8;
+}
+
+GSInstrumentation::GSInstrumentation()
+	: m_segment(NULL)
+	, m_size(0)
+	, m_count(0)
+	, m_frequency(0)
+#ifdef _WIN32
+	, m_mapping(NULL)
+#endif
+{
+}
+
+GSInstrumentation::~GSInstrumentation()
+{
+	Close();
+}
+
+bool GSInstrumentation::Attach()
+{
+	if(m_segment)
+		return true;
+
+	// Mapped writable since the 64-bit loads of a 32-bit build are atomic exchanges
+
+#ifdef _WIN32
+	wchar_t name[64];
+	swprintf(name, countof(name), L"Local\\pcsx2-instr-%u", (uint32)GetCurrentProcessId());
+
+	m_mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, name);
+
+	if(!m_mapping)
+		return false;
+
+	if(void* ptr = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0))
+	{
+		MEMORY_BASIC_INFORMATION info;
+
+		m_segment = (uint8*)ptr;
+		m_size = VirtualQuery(ptr, &info, sizeof(info)) ? info.RegionSize : 0;
+	}
+#else
+	char name[64];
+	snprintf(name, sizeof(name), "/pcsx2-instr-%u", (uint32)getpid());
+
+	int fd = shm_open(name, O_RDWR, 0600);
+
+	if(fd < 0)
+		return false;
+
+	struct stat st;
+
+	if(fstat(fd, &st) == 0 && st.st_size > 0)
+	{
+		void* ptr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+		if(ptr != MAP_FAILED)
+		{
+			m_segment = (uint8*)ptr;
+			m_size = st.st_size;
+		}
+	}
+
+	close(fd);
+#endif
+
+	if(!m_segment || m_size < s_fixed_header)
+	{
+		Close();
+
+		return false;
+	}
+
+	const uint32* header = (const uint32*)m_segment;
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	m_count = header[2];
+	m_frequency = *(const uint64*)&m_segment[16];
+
+	if(header[0] != s_magic || header[1] != s_version || m_frequency == 0 || SlotsOffset(m_count) + m_count * 16 > m_size)
+	{
+		Close();
+
+		return false;
+	}
+
+	return true;
+}
+
+void GSInstrumentation::Close()
+{
+#ifdef _WIN32
+	if(m_segment) UnmapViewOfFile(m_segment);
+	if(m_mapping) CloseHandle(m_mapping);
+
+	m_mapping = NULL;
+#else
+	if(m_segment) munmap(m_segment, m_size);
+#endif
+
+	m_segment = NULL;
+	m_size = 0;
+	m_count = 0;
+}
+
+int GSInstrumentation::Find(const char* name) const
+{
+	for(uint32 i = 0; i < m_count; i++)
+	{
+		const char* s = (const char*)&m_segment[s_fixed_header + i * s_name_size];
+
+		if(strncmp(s, name, s_name_size) == 0)
+			return (int)i;
+	}
+
+	return -1;
+}
+
+uint64 GSInstrumentation::GetEvents(int counter) const
+{
+	if(!m_segment || counter < 0)
+		return 0;
+
+	return ((std::atomic<uint64>*)&m_segment[SlotsOffset(m_count) + counter * 16])->load(std::memory_order_relaxed);
+}
+
+uint64 GSInstrumentation::GetTotal(int counter) const
+{
+	if(!m_segment || counter < 0)
+		return 0;
+
+	return ((std::atomic<uint64>*)&m_segment[SlotsOffset(m_count) + counter * 16 + 8])->load(std::memory_order_relaxed);
+}
@@ -0,0 +1,56 @@
+/*
+ *	Copyright (C) 2007-2016 PCSX2 Dev Team
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+// Reader of the emulator's instrumentation counters (pcsx2 --instrument, see
+// common/include/Utilities/Instrumentation.h).  GSdx doesn't link Utilities, so it maps the
+// segment of its process itself and looks the counters up by name: the offsets only depend
+// on the counter count stored in the header, a newer emulator with more counters still works.
+class GSInstrumentation
+{
+	uint8* m_segment;
+	size_t m_size;
+	uint32 m_count;
+	uint64 m_frequency;
+
+#ifdef _WIN32
+	HANDLE m_mapping;
+#endif
+
+	void Close();
+
+public:
+	GSInstrumentation();
+	virtual ~GSInstrumentation();
+
+	// Maps the segment if the emulator published one, may be retried.
+	bool Attach();
+	bool IsAttached() const {return m_segment != NULL;}
+
+	// Index of the named counter, -1 if the emulator has no such counter
+	int Find(const char* name) const;
+
+	uint64 GetEvents(int counter) const;
+	uint64 GetTotal(int counter) const;
+
+	// Units of the tick counters, per second
+	uint64 GetFrequency() const {return m_frequency;}
+};
@@ -110,6 +110,8 @@ GSLocalMemory::GSLocalMemory()
 
 	memset(m_vm8, 0, m_vmsize);
 
+	SetDirtyPages();
+
 	for(int bp = 0; bp < 32; bp++)
 	{
 		for(int y = 0; y < 32; y++) for(int x = 0; x < 64; x++)
@@ -521,6 +523,29 @@ GSOffset* GSLocalMemory::GetOffset(uint32 bp, uint32 bw, uint32 psm)
 	return off;
 }
 
+void GSLocalMemory::SetDirtyPages(GSOffset* off, const GSVector4i& r)
+{
+	if(r.rempty()) return;
+
+	// the block rows of an offset stop at 2048, transfers can go further and wrap around
+
+	if(r.left < 0 || r.top < 0 || r.right > 2048 || r.bottom > 2048)
+	{
+		SetDirtyPages();
+
+		return;
+	}
+
+	alignas(16) uint32 pages[MAX_PAGES / 32];
+
+	off->GetPagesAsBits(r, pages);
+
+	for(uint32 i = 0; i < MAX_PAGES / 128; i++)
+	{
+		((GSVector4i*)m_dirty_pages)[i] |= ((GSVector4i*)pages)[i];
+	}
+}
+
 GSPixelOffset* GSLocalMemory::GetPixelOffset(const GIFRegFRAME& FRAME, const GIFRegZBUF& ZBUF)
 {
 	uint32 fbp = FRAME.Block();
@@ -775,27 +800,103 @@ void GSLocalMemory::WriteImageBlock(int l, int r, int y, int h, const uint8* src
 template<int psm, int bsx, int bsy>
 void GSLocalMemory::WriteImageLeftRight(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF)
 {
+	// l and r are within one block: each column is read, merged and written back as a whole,
+	// like the incomplete columns of WriteImageTopBottom, instead of addressing every pixel
+
+	alignas(32) uint8 buff[64]; // merge buffer for one column
+
 	uint32 bp = BITBLTBUF.DBP;
 	uint32 bw = BITBLTBUF.DBW;
 
-	for(; h > 0; y++, h--, src += srcpitch)
+	if(psm == PSM_PSMCT32 || psm == PSM_PSMZ32)
 	{
-		for(int x = l; x < r; x++)
+		// a column holds only a few 32 bits pixels of the edge, writing them is faster
+
+		const psm_t& p = m_psm[psm];
+
+		for(; h > 0; y++, h--, src += srcpitch)
 		{
-			switch(psm)
+			uint32 addr = p.pa(0, y, bp, bw);
+			const int* RESTRICT offset = p.rowOffset[y & 7];
+
+			for(int x = l; x < r; x++)
 			{
-			case PSM_PSMCT32: WritePixel32(x, y, *(uint32*)&src[x * 4], bp, bw); break;
-			case PSM_PSMCT16: WritePixel16(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMCT16S: WritePixel16S(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMT8: WritePixel8(x, y, src[x], bp, bw); break;
-			case PSM_PSMT4: WritePixel4(x, y, src[x >> 1] >> ((x & 1) << 2), bp, bw); break;
-			case PSM_PSMZ32: WritePixel32Z(x, y, *(uint32*)&src[x * 4], bp, bw); break;
-			case PSM_PSMZ16: WritePixel16Z(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			case PSM_PSMZ16S: WritePixel16SZ(x, y, *(uint16*)&src[x * 2], bp, bw); break;
-			// TODO
-			default: __assume(0);
+				WritePixel32(addr + offset[x], *(uint32*)&src[x * 4]);
+			}
+		}
+
+		return;
+	}
+
+	const int csy = bsy / 4;
+
+	int x0 = l & ~(bsx - 1);
+
+	for(; h > 0; )
+	{
+		int y2 = y & (csy - 1);
+		int h2 = std::min(h, csy - y2);
+
+		uint8* dst = NULL;
+
+		switch(psm)
+		{
+		case PSM_PSMCT16: dst = BlockPtr16(x0, y, bp, bw); break;
+		case PSM_PSMCT16S: dst = BlockPtr16S(x0, y, bp, bw); break;
+		case PSM_PSMT8: dst = BlockPtr8(x0, y, bp, bw); break;
+		case PSM_PSMT4: dst = BlockPtr4(x0, y, bp, bw); break;
+		case PSM_PSMZ16: dst = BlockPtr16Z(x0, y, bp, bw); break;
+		case PSM_PSMZ16S: dst = BlockPtr16SZ(x0, y, bp, bw); break;
+		// TODO
+		default: __assume(0);
+		}
+
+		switch(psm)
+		{
+		case PSM_PSMCT16:
+		case PSM_PSMCT16S:
+		case PSM_PSMZ16:
+		case PSM_PSMZ16S:
+			GSBlock::ReadColumn16(y, dst, buff, 32);
+			for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 32 + (l - x0) * 2], &src[i * srcpitch + l * 2], (r - l) * 2);
+			GSBlock::WriteColumn16<32>(y, dst, buff, 32);
+			break;
+		case PSM_PSMT8:
+			GSBlock::ReadColumn8(y, dst, buff, 16);
+			for(int i = 0, j = y2; i < h2; i++, j++) memcpy(&buff[j * 16 + (l - x0)], &src[i * srcpitch + l], r - l);
+			GSBlock::WriteColumn8<32>(y, dst, buff, 16);
+			break;
+		case PSM_PSMT4:
+			GSBlock::ReadColumn4(y, dst, buff, 16);
+			for(int i = 0, j = y2; i < h2; i++, j++)
+			{
+				uint8* RESTRICT d = &buff[j * 16 - (x0 >> 1)];
+				const uint8* RESTRICT s = &src[i * srcpitch];
+
+				if(((l | r) & 1) == 0)
+				{
+					memcpy(&d[l >> 1], &s[l >> 1], (r - l) >> 1);
+
+					continue;
+				}
+
+				for(int x = l; x < r; x++)
+				{
+					int shift = (x & 1) << 2;
+
+					d[x >> 1] = (uint8)((d[x >> 1] & (0xf0 >> shift)) | (((s[x >> 1] >> shift) & 0xf) << shift));
+				}
 			}
+			GSBlock::WriteColumn4<32>(y, dst, buff, 16);
+			break;
+		// TODO
+		default:
+			__assume(0);
 		}
+
+		src += srcpitch * h2;
+		y += h2;
+		h -= h2;
 	}
 }
 
@@ -979,7 +1080,18 @@ void GSLocalMemory::WriteImage(int& tx, int& ty, const uint8* src, int len, GIFR
 	int srcpitch = (r - l) * trbpp >> 3;
 	int h = len / srcpitch;
 
-	if(ra - la >= bsx && h > 0) // "transfer width" >= "block width" && there is at least one full row
+	if(h > 0 && la > ra) // narrower than a block and within one, there is at least one full row
+	{
+		const uint8* s = &src[-l * trbpp >> 3];
+
+		src += srcpitch * h;
+		len -= srcpitch * h;
+
+		WriteImageLeftRight<psm, bsx, bsy>(l, r, ty, h, s, srcpitch, BITBLTBUF);
+
+		ty += h;
+	}
+	else if(h > 0) // there is at least one full row
 	{
 		const uint8* s = &src[-l * trbpp >> 3];
 
@@ -1058,6 +1170,10 @@ void GSLocalMemory::WriteImage(int& tx, int& ty, const uint8* src, int len, GIFR
 				// h -= h;
 			}
 		}
+		else
+		{
+			ty += h;
+		}
 	}
 
 	// the rest
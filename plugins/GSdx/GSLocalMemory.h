@@ -127,6 +127,10 @@ public:
 
 	GSClut m_clut;
 
+	// Pages written since the last ResetDirtyPages (one bit per page), for the incremental
+	// freezes.  Set by the transfers, the moves, the draws and the target read backs.
+	alignas(16) uint32 m_dirty_pages[MAX_PAGES / 32];
+
 protected:
 	bool m_use_fifo_alloc;
 
@@ -187,6 +191,10 @@ public:
 	GSPixelOffset4* GetPixelOffset4(const GIFRegFRAME& FRAME, const GIFRegZBUF& ZBUF);
 	std::vector<GSVector2i>* GetPage2TileMap(const GIFRegTEX0& TEX0);
 
+	void SetDirtyPages(GSOffset* off, const GSVector4i& r);
+	void SetDirtyPages() {memset(m_dirty_pages, 0xff, sizeof(m_dirty_pages));}
+	void ResetDirtyPages() {memset(m_dirty_pages, 0, sizeof(m_dirty_pages));}
+
 	// address
 
 	static uint32 BlockNumber32(int x, int y, uint32 bp, uint32 bw)
@@ -672,6 +680,8 @@ public:
 
 	__forceinline void WritePixel32(uint8* RESTRICT src, uint32 pitch, GSOffset* off, const GSVector4i& r)
 	{
+		SetDirtyPages(off, r);
+
 		src -= r.left * sizeof(uint32);
 
 		for(int y = r.top; y < r.bottom; y++, src += pitch)
@@ -689,6 +699,8 @@ public:
 
 	__forceinline void WritePixel24(uint8* RESTRICT src, uint32 pitch, GSOffset* off, const GSVector4i& r)
 	{
+		SetDirtyPages(off, r);
+
 		src -= r.left * sizeof(uint32);
 
 		for(int y = r.top; y < r.bottom; y++, src += pitch)
@@ -706,6 +718,8 @@ public:
 
 	__forceinline void WritePixel16(uint8* RESTRICT src, uint32 pitch, GSOffset* off, const GSVector4i& r)
 	{
+		SetDirtyPages(off, r);
+
 		src -= r.left * sizeof(uint16);
 
 		for(int y = r.top; y < r.bottom; y++, src += pitch)
@@ -24,25 +24,33 @@
 class GSPerfMon
 {
 public:
+	// Upper bound of the SW renderer's extra threads, each one gets its own WorkerDraw timer
+	enum {MaxWorkers = 64};
+
 	enum timer_t 
 	{
 		Main, 
 		Sync, 
-		WorkerDraw0, WorkerDraw1, WorkerDraw2, WorkerDraw3, WorkerDraw4, WorkerDraw5, WorkerDraw6, WorkerDraw7, 
-		WorkerDraw8, WorkerDraw9, WorkerDraw10, WorkerDraw11, WorkerDraw12, WorkerDraw13, WorkerDraw14, WorkerDraw15, 
-		TimerLast,
+		UnswizzleTime,
+		VertexTraceTime,
+		ConvertTime,
+		SetupTime,
+		WorkerDraw0,
+		TimerLast = WorkerDraw0 + MaxWorkers,
 	};
 	
 	enum counter_t 
 	{
-		Frame, Prim, Draw, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint,
+		Frame, Prim, Draw, DrawMerged, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint, TextureHit, TextureMiss, TextureEvict, TargetScan, PageHashHit, PageHashMiss, VertexDedup, ClutHit, ClutMiss, Readback,
 		CounterLast,
 	};
 
 protected:
 	double m_counters[CounterLast];
 	double m_stats[CounterLast];
+	double m_totals[CounterLast]; // never reset, lets the replayer diff them per frame
 	uint64 m_begin[TimerLast], m_total[TimerLast], m_start[TimerLast];
+	uint64 m_timer_totals[TimerLast]; // rdtsc ticks, never reset either
 	uint64 m_frame;
 	clock_t m_lastframe;
 	int m_count;
@@ -57,6 +65,8 @@ public:
 
 	void Put(counter_t c, double val = 0);
 	double Get(counter_t c) {return m_stats[c];}
+	double GetTotal(counter_t c) {return m_totals[c];}
+	uint64 GetTimerTotal(int timer) {return m_timer_totals[timer];}
 	void Update();
 
 	void Start(int timer = Main);
@@ -128,11 +128,77 @@ namespace GSPng {
         return SaveFile(filename, fmt, image, row.get(), w, h, pitch, compression);
     }
 
+    bool Load(const std::string& file, std::vector<uint8>& image, int& w, int& h)
+    {
+        png_image png;
+
+        memset(&png, 0, sizeof(png));
+        png.version = PNG_IMAGE_VERSION;
+
+        if (!png_image_begin_read_from_file(&png, file.c_str())) {
+            fprintf(stderr, "Failed to read image %s (%s)\n", file.c_str(), png.message);
+            return false;
+        }
+
+        png.format = PNG_FORMAT_RGBA;
+
+        image.resize(PNG_IMAGE_SIZE(png));
+
+        if (!png_image_finish_read(&png, nullptr, image.data(), 0, nullptr)) {
+            fprintf(stderr, "Failed to read image %s (%s)\n", file.c_str(), png.message);
+            png_image_free(&png);
+            return false;
+        }
+
+        w = png.width;
+        h = png.height;
+
+        return true;
+    }
+
+    // Capture frames all have the same size, recycle the buffers instead of paying for a fresh
+    // (page faulted) allocation of a few megabytes on the GS thread every frame
+    static std::mutex s_pool_lock;
+    static std::vector<std::pair<size_t, uint8*>> s_pool;
+    static const size_t s_pool_max = 4;
+
+    static uint8* AllocImage(size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> l(s_pool_lock);
+
+            for (auto i = s_pool.begin(); i != s_pool.end(); ++i) {
+                if (i->first == size) {
+                    uint8* image = i->second;
+                    *i = s_pool.back();
+                    s_pool.pop_back();
+                    return image;
+                }
+            }
+        }
+
+        return (uint8*)_aligned_malloc(size, 32);
+    }
+
+    static void FreeImage(uint8* image, size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> l(s_pool_lock);
+
+            if (s_pool.size() < s_pool_max) {
+                s_pool.push_back(std::make_pair(size, image));
+                return;
+            }
+        }
+
+        _aligned_free(image);
+    }
+
     Transaction::Transaction(GSPng::Format fmt, const std::string& file, const uint8* image, int w, int h, int pitch, int compression)
         : m_fmt(fmt), m_file(file), m_w(w), m_h(h), m_pitch(pitch), m_compression(compression)
     {
         // Note: yes it would be better to use shared pointer
-        m_image = (uint8*)_aligned_malloc(pitch*h, 32);
+        m_image = AllocImage(pitch*h);
         if (m_image)
             memcpy(m_image, image, pitch*h);
     }
@@ -140,7 +206,16 @@ namespace GSPng {
     Transaction::~Transaction()
     {
         if (m_image)
-            _aligned_free(m_image);
+            FreeImage(m_image, m_pitch*m_h);
+    }
+
+    void Transaction::ReleasePool()
+    {
+        std::lock_guard<std::mutex> l(s_pool_lock);
+
+        for (auto& i : s_pool)
+            _aligned_free(i.second);
+        s_pool.clear();
     }
 
     void Process(std::shared_ptr<Transaction>& item)
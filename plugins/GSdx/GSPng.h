@@ -48,10 +48,16 @@ namespace GSPng {
 
 			Transaction(GSPng::Format fmt, const std::string& file, const uint8* image, int w, int h, int pitch, int compression);
 			~Transaction();
+
+			// Frees the image buffers kept around for the next transactions
+			static void ReleasePool();
 	};
 
     bool Save(GSPng::Format fmt, const std::string& file, uint8* image, int w, int h, int pitch, int compression, bool rb_swapped = false);
 
+    // Decodes any png as RGBA8, pitch w * 4
+    bool Load(const std::string& file, std::vector<uint8>& image, int& w, int& h);
+
     void Process(std::shared_ptr<Transaction> &item);
 
     using Worker = GSJobQueue<std::shared_ptr<Transaction>, 16>;
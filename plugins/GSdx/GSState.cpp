@@ -30,6 +30,7 @@ int GSState::s_n = 0;
 
 GSState::GSState()
 	: m_version(6)
+	, m_freeze_buffer(NULL)
 	, m_mt(false)
 	, m_irq(NULL)
 	, m_path3hack(0)
@@ -66,6 +67,8 @@ GSState::GSState()
 		m_userhacks_skipdraw_offset = 0;
 	}
 
+	m_mem.m_clut.SetPerfMon(&m_perfmon);
+
 	s_n = 0;
 	s_dump  = theApp.GetConfigB("dump");
 	s_save  = theApp.GetConfigB("save");
@@ -222,6 +225,8 @@ void GSState::SetFrameSkip(int skip)
 
 		m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZF2] = &GSState::GIFPackedRegHandlerNOP;
 		m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZ2] = &GSState::GIFPackedRegHandlerNOP;
+		m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZF2] = &GSState::GIFPackedRegHandlerNOP;
+		m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZ2] = &GSState::GIFPackedRegHandlerNOP;
 	}
 	else
 	{
@@ -301,6 +306,8 @@ void GSState::ResetHandlers()
 		m_fpGIFRegHandlerXYZ[P][3] = &GSState::GIFRegHandlerXYZ2<P, 1, auto_flush>; \
 		m_fpGIFPackedRegHandlerSTQRGBAXYZF2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZF2<P, auto_flush>; \
 		m_fpGIFPackedRegHandlerSTQRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZ2<P, auto_flush>; \
+		m_fpGIFPackedRegHandlerUVRGBAXYZF2[P] = &GSState::GIFPackedRegHandlerUVRGBAXYZF2<P, auto_flush>; \
+		m_fpGIFPackedRegHandlerUVRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerUVRGBAXYZ2<P, auto_flush>; \
 
 	if (m_userhacks_auto_flush) {
 		SetHandlerXYZ(GS_POINTLIST, true);
@@ -695,6 +702,8 @@ void GSState::GIFPackedRegHandlerSTQRGBAXYZF2(const GIFPackedReg* RESTRICT r, ui
 
 	const GIFPackedReg* RESTRICT r_end = r + size;
 
+	const bool batch = BeginVertexBatch<prim, auto_flush>(size / 3);
+
 	while(r < r_end)
 	{
 		GSVector4i st = GSVector4i::loadl(&r[0].u64[0]);
@@ -717,11 +726,14 @@ void GSState::GIFPackedRegHandlerSTQRGBAXYZF2(const GIFPackedReg* RESTRICT r, ui
 
 		m_v.m[1] = xy.upl32(zf); // TODO: only store the last one
 
-		VertexKick<prim, auto_flush>(r[2].XYZF2.Skip());
+		if(batch) VertexKickBatch<prim>(r[2].XYZF2.Skip());
+		else VertexKick<prim, auto_flush>(r[2].XYZF2.Skip());
 
 		r += 3;
 	}
 
+	if(batch) FlushVertexBatch<prim>();
+
 	m_q = r[-3].STQ.Q; // remember the last one, STQ outputs this to the temp Q each time
 }
 
@@ -732,6 +744,8 @@ void GSState::GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, uin
 
 	const GIFPackedReg* RESTRICT r_end = r + size;
 
+	const bool batch = BeginVertexBatch<prim, auto_flush>(size / 3);
+
 	while(r < r_end)
 	{
 		GSVector4i st = GSVector4i::loadl(&r[0].u64[0]);
@@ -753,14 +767,92 @@ void GSState::GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, uin
 
 		m_v.m[1] = xyz.upl64(GSVector4i::loadl(&m_v.UV)); // TODO: only store the last one
 
-		VertexKick<prim, auto_flush>(r[2].XYZ2.Skip());
+		if(batch) VertexKickBatch<prim>(r[2].XYZ2.Skip());
+		else VertexKick<prim, auto_flush>(r[2].XYZ2.Skip());
 
 		r += 3;
 	}
 
+	if(batch) FlushVertexBatch<prim>();
+
 	m_q = r[-3].STQ.Q; // remember the last one, STQ outputs this to the temp Q each time
 }
 
+// UV formats have no STQ in the loop, every RGBA of the batch picks up the same temp Q
+
+template<uint32 prim, bool auto_flush>
+void GSState::GIFPackedRegHandlerUVRGBAXYZF2(const GIFPackedReg* RESTRICT r, uint32 size)
+{
+	ASSERT(size > 0 && size % 3 == 0);
+
+	const GIFPackedReg* RESTRICT r_end = r + size;
+
+	const bool batch = BeginVertexBatch<prim, auto_flush>(size / 3);
+
+	m_v.RGBAQ.Q = m_q;
+
+	while(r < r_end)
+	{
+		GSVector4i uv = GSVector4i::loadl(&r[0]) & GSVector4i::x00003fff();
+		GSVector4i rgba = (GSVector4i::load<false>(&r[1]) & GSVector4i::x000000ff()).ps32().pu16();
+
+		m_v.RGBAQ.u32[0] = (uint32)GSVector4i::store(rgba); // TODO: only store the last one
+
+		GSVector4i xy = GSVector4i::loadl(&r[2].u64[0]);
+		GSVector4i zf = GSVector4i::loadl(&r[2].u64[1]);
+		xy = xy.upl16(xy.srl<4>()).upl32(uv.ps32(uv));
+		zf = zf.srl32(4) & GSVector4i::x00ffffff().upl32(GSVector4i::x000000ff());
+
+		m_v.m[1] = xy.upl32(zf); // also updates m_v.UV
+
+		if(batch) VertexKickBatch<prim>(r[2].XYZF2.Skip());
+		else VertexKick<prim, auto_flush>(r[2].XYZF2.Skip());
+
+		r += 3;
+	}
+
+	if(batch) FlushVertexBatch<prim>();
+
+	if(m_userhacks_wildhack) m_isPackedUV_HackFlag = true; // see GIFPackedRegHandlerUV_Hack
+}
+
+template<uint32 prim, bool auto_flush>
+void GSState::GIFPackedRegHandlerUVRGBAXYZ2(const GIFPackedReg* RESTRICT r, uint32 size)
+{
+	ASSERT(size > 0 && size % 3 == 0);
+
+	const GIFPackedReg* RESTRICT r_end = r + size;
+
+	const bool batch = BeginVertexBatch<prim, auto_flush>(size / 3);
+
+	m_v.RGBAQ.Q = m_q;
+
+	GSVector4i fog = GSVector4i::load((int)m_v.FOG);
+
+	while(r < r_end)
+	{
+		GSVector4i uv = GSVector4i::loadl(&r[0]) & GSVector4i::x00003fff();
+		GSVector4i rgba = (GSVector4i::load<false>(&r[1]) & GSVector4i::x000000ff()).ps32().pu16();
+
+		m_v.RGBAQ.u32[0] = (uint32)GSVector4i::store(rgba); // TODO: only store the last one
+
+		GSVector4i xy = GSVector4i::loadl(&r[2].u64[0]);
+		GSVector4i z = GSVector4i::loadl(&r[2].u64[1]);
+		GSVector4i xyz = xy.upl16(xy.srl<4>()).upl32(z);
+
+		m_v.m[1] = xyz.upl64(uv.ps32(uv).upl32(fog)); // also updates m_v.UV
+
+		if(batch) VertexKickBatch<prim>(r[2].XYZ2.Skip());
+		else VertexKick<prim, auto_flush>(r[2].XYZ2.Skip());
+
+		r += 3;
+	}
+
+	if(batch) FlushVertexBatch<prim>();
+
+	if(m_userhacks_wildhack) m_isPackedUV_HackFlag = true; // see GIFPackedRegHandlerUV_Hack
+}
+
 void GSState::GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, uint32 size)
 {
 }
@@ -772,6 +864,24 @@ void GSState::GIFRegHandlerNull(const GIFReg* RESTRICT r)
 	// ASSERT(0);
 }
 
+// The queued primitives of an untextured batch don't care about sampler state, the batch can
+// keep growing across those writes. A later PRIM (or PRMODE) that enables TME flushes first.
+
+__forceinline bool GSState::IsTextureStateUsed()
+{
+	if(PRIM->TME)
+	{
+		return true;
+	}
+
+	if(m_index.tail > 0)
+	{
+		m_perfmon.Put(GSPerfMon::DrawMerged, 1);
+	}
+
+	return false;
+}
+
 __forceinline void GSState::ApplyPRIM(uint32 prim)
 {
 	// ASSERT(r->PRIM.PRIM < 7);
@@ -907,7 +1017,7 @@ template<int i> void GSState::ApplyTEX0(GIFRegTEX0& TEX0)
 
 	uint64 mask = 0x1f78001c3fffffffull; // TBP0 TBW PSM TW TCC TFX CPSM CSA
 
-	if(wt || PRIM->CTXT == i && ((TEX0.u64 ^ m_env.CTXT[i].TEX0.u64) & mask))
+	if(wt || PRIM->CTXT == i && ((TEX0.u64 ^ m_env.CTXT[i].TEX0.u64) & mask) && IsTextureStateUsed())
 	{
 		Flush();
 	}
@@ -1057,7 +1167,7 @@ template<int i> void GSState::GIFRegHandlerTEX0(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerCLAMP(const GIFReg* RESTRICT r)
 {
 	GL_REG("CLAMP_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
-	if(PRIM->CTXT == i && r->CLAMP != m_env.CTXT[i].CLAMP)
+	if(PRIM->CTXT == i && r->CLAMP != m_env.CTXT[i].CLAMP && IsTextureStateUsed())
 	{
 		Flush();
 	}
@@ -1077,7 +1187,7 @@ void GSState::GIFRegHandlerNOP(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerTEX1(const GIFReg* RESTRICT r)
 {
 	GL_REG("TEX1_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
-	if(PRIM->CTXT == i && r->TEX1 != m_env.CTXT[i].TEX1)
+	if(PRIM->CTXT == i && r->TEX1 != m_env.CTXT[i].TEX1 && IsTextureStateUsed())
 	{
 		Flush();
 	}
@@ -1182,7 +1292,7 @@ void GSState::GIFRegHandlerSCANMSK(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerMIPTBP1(const GIFReg* RESTRICT r)
 {
 	GL_REG("MIPTBP1_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
-	if(PRIM->CTXT == i && r->MIPTBP1 != m_env.CTXT[i].MIPTBP1)
+	if(PRIM->CTXT == i && r->MIPTBP1 != m_env.CTXT[i].MIPTBP1 && IsTextureStateUsed())
 	{
 		Flush();
 	}
@@ -1193,7 +1303,7 @@ template<int i> void GSState::GIFRegHandlerMIPTBP1(const GIFReg* RESTRICT r)
 template<int i> void GSState::GIFRegHandlerMIPTBP2(const GIFReg* RESTRICT r)
 {
 	GL_REG("MIPTBP2_%d = 0x%x_%x", i, r->u32[1], r->u32[0]);
-	if(PRIM->CTXT == i && r->MIPTBP2 != m_env.CTXT[i].MIPTBP2)
+	if(PRIM->CTXT == i && r->MIPTBP2 != m_env.CTXT[i].MIPTBP2 && IsTextureStateUsed())
 	{
 		Flush();
 	}
@@ -1543,6 +1653,8 @@ void GSState::FlushWrite()
 
 	InvalidateVideoMem(m_env.BITBLTBUF, r);
 
+	m_mem.SetDirtyPages(m_mem.GetOffset(m_env.BITBLTBUF.DBP, m_env.BITBLTBUF.DBW, m_env.BITBLTBUF.DPSM), r);
+
 	//int y = m_tr.y;
 
 	GSLocalMemory::writeImage wi = GSLocalMemory::m_psm[m_env.BITBLTBUF.DPSM].wi;
@@ -1649,7 +1761,11 @@ void GSState::FlushPrim()
 
 		if(GSLocalMemory::m_psm[m_context->FRAME.PSM].fmt < 3 && GSLocalMemory::m_psm[m_context->ZBUF.PSM].fmt < 3)
 		{
-			m_vt.Update(m_vertex.buff, m_index.buff, m_vertex.tail, m_index.tail, GSUtil::GetPrimClass(PRIM->PRIM));
+			{
+				GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::VertexTraceTime);
+
+				m_vt.Update(m_vertex.buff, m_index.buff, m_vertex.tail, m_index.tail, GSUtil::GetPrimClass(PRIM->PRIM));
+			}
 
 			m_context->SaveReg();
 
@@ -1758,6 +1874,8 @@ void GSState::Write(const uint8* mem, int len)
 
 		InvalidateVideoMem(blit, r);
 
+		m_mem.SetDirtyPages(m_mem.GetOffset(blit.DBP, blit.DBW, blit.DPSM), r);
+
 		(m_mem.*psm.wi)(m_tr.x, m_tr.y, mem, m_tr.total, blit, m_env.TRXPOS, m_env.TRXREG);
 
 		m_tr.start = m_tr.end = m_tr.total;
@@ -1872,9 +1990,15 @@ void GSState::Move()
 		m_env.TRXPOS.DIRX, m_env.TRXPOS.DIRY,
 		sx, sy, dx, dy, w, h);
 
+	// The renderer may do the whole copy in its own memory (local memory is left as it is)
+	if(MoveVideoMem(m_env.BITBLTBUF, sx, sy, dx, dy, w, h))
+		return;
+
 	InvalidateLocalMem(m_env.BITBLTBUF, GSVector4i(sx, sy, sx + w, sy + h));
 	InvalidateVideoMem(m_env.BITBLTBUF, GSVector4i(dx, dy, dx + w, dy + h));
 
+	m_mem.SetDirtyPages(m_mem.GetOffset(m_env.BITBLTBUF.DBP, m_env.BITBLTBUF.DBW, m_env.BITBLTBUF.DPSM), GSVector4i(dx, dy, dx + w, dy + h));
+
 	int xinc = 1;
 	int yinc = 1;
 
@@ -2212,6 +2336,22 @@ template<int index> void GSState::Transfer(const uint8* mem, uint32 size)
 
 						break;
 
+					case GIFPath::TYPE_UVRGBAXYZF2:
+
+						(this->*m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZF2])((GIFPackedReg*)mem, total);
+
+						mem += total * sizeof(GIFPackedReg);
+
+						break;
+
+					case GIFPath::TYPE_UVRGBAXYZ2:
+
+						(this->*m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZ2])((GIFPackedReg*)mem, total);
+
+						mem += total * sizeof(GIFPackedReg);
+
+						break;
+
 					default:
 
 						__assume(0);
@@ -2353,7 +2493,7 @@ template<class T> static void ReadState(T* dst, uint8*& src, size_t len = sizeof
 	src += len;
 }
 
-int GSState::Freeze(GSFreezeData* fd, bool sizeonly)
+int GSState::Freeze(GSFreezeData* fd, bool sizeonly, bool incremental)
 {
 	if(sizeonly)
 	{
@@ -2368,6 +2508,8 @@ int GSState::Freeze(GSFreezeData* fd, bool sizeonly)
 
 	Flush();
 
+	SyncLocalMem();
+
 	uint8* data = fd->data;
 
 	WriteState(data, &m_version);
@@ -2413,7 +2555,29 @@ int GSState::Freeze(GSFreezeData* fd, bool sizeonly)
 	data += sizeof(GIFReg); // obsolite
 	WriteState(data, &m_tr.x);
 	WriteState(data, &m_tr.y);
-	WriteState(data, m_mem.m_vm8, m_mem.m_vmsize);
+
+	if(incremental && fd->data == m_freeze_buffer)
+	{
+		// the buffer already holds the pages that weren't written since
+
+		for(uint32 i = 0; i < MAX_PAGES; i++)
+		{
+			if(m_mem.m_dirty_pages[i >> 5] & (1u << (i & 31)))
+			{
+				memcpy(data + i * PAGE_SIZE, m_mem.m_vm8 + i * PAGE_SIZE, PAGE_SIZE);
+			}
+		}
+
+		data += m_mem.m_vmsize;
+	}
+	else
+	{
+		WriteState(data, m_mem.m_vm8, m_mem.m_vmsize);
+	}
+
+	m_freeze_buffer = incremental ? fd->data : NULL;
+
+	m_mem.ResetDirtyPages();
 
 	for(size_t i = 0; i < countof(m_path); i++)
 	{
@@ -2432,10 +2596,10 @@ int GSState::Freeze(GSFreezeData* fd, bool sizeonly)
 
 	WriteState(data, &m_q);
 
-	return 0;
+	return incremental ? 1 : 0;
 }
 
-int GSState::Defrost(const GSFreezeData* fd)
+int GSState::Defrost(const GSFreezeData* fd, bool incremental)
 {
 	if(!fd || !fd->data || fd->size == 0)
 	{
@@ -2462,6 +2626,8 @@ int GSState::Defrost(const GSFreezeData* fd)
 
 	Flush();
 
+	SyncLocalMem();
+
 	Reset();
 
 	ReadState(&m_env.PRIM, data);
@@ -2520,7 +2686,29 @@ int GSState::Defrost(const GSFreezeData* fd)
 	data += sizeof(GIFReg); // obsolite
 	ReadState(&m_tr.x, data);
 	ReadState(&m_tr.y, data);
-	ReadState(m_mem.m_vm8, data, m_mem.m_vmsize);
+
+	if(incremental && fd->data == m_freeze_buffer)
+	{
+		// only the pages written since differ from the buffer
+
+		for(uint32 i = 0; i < MAX_PAGES; i++)
+		{
+			if(m_mem.m_dirty_pages[i >> 5] & (1u << (i & 31)))
+			{
+				memcpy(m_mem.m_vm8 + i * PAGE_SIZE, data + i * PAGE_SIZE, PAGE_SIZE);
+			}
+		}
+
+		data += m_mem.m_vmsize;
+	}
+	else
+	{
+		ReadState(m_mem.m_vm8, data, m_mem.m_vmsize);
+	}
+
+	m_freeze_buffer = incremental ? fd->data : NULL;
+
+	m_mem.ResetDirtyPages();
 
 	m_tr.total = 0; // TODO: restore transfer state
 
@@ -2557,7 +2745,7 @@ int GSState::Defrost(const GSFreezeData* fd)
 
 m_perfmon.SetFrame(5000);
 
-	return 0;
+	return incremental ? 1 : 0;
 }
 
 void GSState::SetGameCRC(uint32 crc, int options)
@@ -2612,18 +2800,29 @@ void GSState::UpdateVertexKick()
 
 	m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZF2] = m_fpGIFPackedRegHandlerSTQRGBAXYZF2[prim];
 	m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZ2] = m_fpGIFPackedRegHandlerSTQRGBAXYZ2[prim];
+	m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZF2] = m_fpGIFPackedRegHandlerUVRGBAXYZF2[prim];
+	m_fpGIFPackedRegHandlersC[GIF_REG_UVRGBAXYZ2] = m_fpGIFPackedRegHandlerUVRGBAXYZ2[prim];
 }
 
-void GSState::GrowVertexBuffer()
+void GSState::GrowVertexBuffer(size_t required)
 {
-	int maxcount = std::max<int>(m_vertex.maxcount * 3 / 2, 10000);
+	// doubles, or more when a vertex batch reserves its whole loop up front (BeginVertexBatch);
+	// the buffers are only freed with GSState, a few reallocations reach the vertex count of the
+	// heaviest draws and the following frames don't reallocate anymore
+
+	size_t maxcount = std::max<size_t>((m_vertex.maxcount + 3) * 2, 10000);
+
+	while(maxcount < required + 4)
+	{
+		maxcount *= 2;
+	}
 
 	GSVertex* vertex = (GSVertex*)_aligned_malloc(sizeof(GSVertex) * maxcount, 32);
 	uint32* index = (uint32*)_aligned_malloc(sizeof(uint32) * maxcount * 3, 32); // worst case is slightly less than vertex number * 3
 
 	if(vertex == NULL || index == NULL)
 	{
-		printf("GSdx: failed to allocate %d bytes for verticles and %d for indices.\n", (int)sizeof(GSVertex) * maxcount, (int)sizeof(uint32) * maxcount * 3);
+		printf("GSdx: failed to allocate %d bytes for verticles and %d for indices.\n", (int)(sizeof(GSVertex) * maxcount), (int)(sizeof(uint32) * maxcount * 3));
 		throw GSDXError();
 	}
 
@@ -2646,6 +2845,114 @@ void GSState::GrowVertexBuffer()
 	m_index.buff = index;
 }
 
+template<uint32 prim>
+__forceinline size_t GSState::GetPrimVertexCount()
+{
+	switch(prim)
+	{
+	case GS_POINTLIST: return 1;
+	case GS_LINELIST: return 2;
+	case GS_LINESTRIP: return 2;
+	case GS_TRIANGLELIST: return 3;
+	case GS_TRIANGLESTRIP: return 3;
+	case GS_TRIANGLEFAN: return 3;
+	case GS_SPRITE: return 2;
+	case GS_INVALID: return 1;
+	default: __assume(0);
+	}
+}
+
+__forceinline void GSState::StoreVertexXY(uint64* RESTRICT dst, const GSVector4i& v1) const
+{
+	GSVector4i xy = v1.xxxx().u16to32().sub32(m_ofxy);
+
+	#if _M_SSE >= 0x401
+	GSVector4i::storel(dst, xy.blend16<0xf0>(xy.sra32(4)).ps32());
+	#else
+	GSVector4i::storel(dst, xy.upl64(xy.sra32(4).zwzw()).ps32());
+	#endif
+}
+
+// v0, v1, v2: T-3, T-2, T-1, v3: the head of a fan, from StoreVertexXY.  The 64-bit halves
+// are tested separately (bits 0-3 and 8-11 of the mask), VertexKickBatch tests two vertices
+// at once, smin and smax are m_scissor and m_scissor.zwzwl() repeated in both halves.
+
+template<uint32 prim>
+__forceinline GSVector4i GSState::VertexSkipTest(const GSVector4i& v0, const GSVector4i& v1, const GSVector4i& v2, const GSVector4i& v3, const GSVector4i& smin, const GSVector4i& smax) const
+{
+	GSVector4i pmin, pmax;
+
+	GSVector4 cross;
+
+	switch(prim)
+	{
+	case GS_POINTLIST:
+		pmin = v2;
+		pmax = v2;
+		break;
+	case GS_LINELIST:
+	case GS_LINESTRIP:
+	case GS_SPRITE:
+		pmin = v2.min_i16(v1);
+		pmax = v2.max_i16(v1);
+		break;
+	case GS_TRIANGLELIST:
+	case GS_TRIANGLESTRIP:
+		pmin = v2.min_i16(v1.min_i16(v0));
+		pmax = v2.max_i16(v1.max_i16(v0));
+		break;
+	case GS_TRIANGLEFAN:
+		pmin = v2.min_i16(v1.min_i16(v3));
+		pmax = v2.max_i16(v1.max_i16(v3));
+		break;
+	default:
+		break;
+	}
+
+	GSVector4i test = pmax.lt16(smin) | pmin.gt16(smax); 
+	
+	switch(prim)
+	{
+	case GS_TRIANGLELIST:
+	case GS_TRIANGLESTRIP:
+	case GS_TRIANGLEFAN:
+	case GS_SPRITE:
+		// FIXME: GREG I don't understand the purpose of the m_nativeres check
+		// It impacts badly the number of draw call in the HW renderer.
+		test |= m_nativeres ? pmin.eq16(pmax).zwzwlh() : pmin.eq16(pmax);
+		break;
+	default:
+		break;
+	}
+
+	switch(prim)
+	{
+	case GS_TRIANGLELIST:
+	case GS_TRIANGLESTRIP:
+		// TODO: any way to do a 16-bit integer cross product?
+		// cross product is zero most of the time because either of the vertices are the same
+		/*
+		cross = GSVector4(v2.xyxyl().i16to32().sub32(v0.upl32(v1).i16to32())); // x20, y20, x21, y21
+		cross = cross * cross.wzwz(); // x20 * y21, y20 * x21
+		test |= GSVector4i::cast(cross == cross.yxwz());
+		*/
+		test = (test | v0 == v1) | (v1 == v2 | v0 == v2); 
+		break;
+	case GS_TRIANGLEFAN:
+		/*
+		cross = GSVector4(v2.xyxyl().i16to32().sub32(v3.upl32(v1).i16to32())); // x23, y23, x21, y21
+		cross = cross * cross.wzwz(); // x23 * y21, y23 * x21
+		test |= GSVector4i::cast(cross == cross.yxwz());
+		*/
+		test = (test | v3 == v1) | (v1 == v2 | v3 == v2); 
+		break;
+	default:
+		break;
+	}
+
+	return test;
+}
+
 template<uint32 prim, bool auto_flush>
 __forceinline void GSState::VertexKick(uint32 skip)
 {
@@ -2653,7 +2960,6 @@ __forceinline void GSState::VertexKick(uint32 skip)
 
 	size_t head = m_vertex.head;
 	size_t tail = m_vertex.tail;
-	size_t next = m_vertex.next;
 	size_t xy_tail = m_vertex.xy_tail;
 
 	// callers should write XYZUVF to m_v.m[1] in one piece to have this load store-forwarded, either by the cpu or the compiler when this function is inlined
@@ -2666,30 +2972,12 @@ __forceinline void GSState::VertexKick(uint32 skip)
 	tailptr[0] = v0;
 	tailptr[1] = v1;
 
-	GSVector4i xy = v1.xxxx().u16to32().sub32(m_ofxy);
-
-	#if _M_SSE >= 0x401
-	GSVector4i::storel(&m_vertex.xy[xy_tail & 3], xy.blend16<0xf0>(xy.sra32(4)).ps32());
-	#else
-	GSVector4i::storel(&m_vertex.xy[xy_tail & 3], xy.upl64(xy.sra32(4).zwzw()).ps32());
-	#endif
+	StoreVertexXY(&m_vertex.xy[xy_tail & 3], v1);
 
 	m_vertex.tail = ++tail;
 	m_vertex.xy_tail = ++xy_tail;
 
-	size_t n = 0;
-
-	switch(prim)
-	{
-	case GS_POINTLIST: n = 1; break;
-	case GS_LINELIST: n = 2; break;
-	case GS_LINESTRIP: n = 2; break;
-	case GS_TRIANGLELIST: n = 3; break;
-	case GS_TRIANGLESTRIP: n = 3; break;
-	case GS_TRIANGLEFAN: n = 3; break;
-	case GS_SPRITE: n = 2; break;
-	case GS_INVALID: n = 1; break;
-	}
+	size_t n = GetPrimVertexCount<prim>();
 
 	size_t m = tail - head;
 
@@ -2700,84 +2988,157 @@ __forceinline void GSState::VertexKick(uint32 skip)
 
 	if(skip == 0 && (prim != GS_TRIANGLEFAN || m <= 4)) // m_vertex.xy only knows about the last 4 vertices, head could be far behind for fan
 	{
-		GSVector4i v0, v1, v2, v3, pmin, pmax;
+		GSVector4i v0, v1, v2, v3;
 
 		v0 = GSVector4i::loadl(&m_vertex.xy[(xy_tail + 1) & 3]); // T-3
 		v1 = GSVector4i::loadl(&m_vertex.xy[(xy_tail + 2) & 3]); // T-2
 		v2 = GSVector4i::loadl(&m_vertex.xy[(xy_tail + 3) & 3]); // T-1
 		v3 = GSVector4i::loadl(&m_vertex.xy[(xy_tail - m) & 3]); // H
 
-		GSVector4 cross;
+		skip |= VertexSkipTest<prim>(v0, v1, v2, v3, m_scissor, m_scissor.zwzwl()).mask() & 15;
+	}
 
-		switch(prim)
-		{
-		case GS_POINTLIST:
-			pmin = v2;
-			pmax = v2;
-			break;
-		case GS_LINELIST:
-		case GS_LINESTRIP:
-		case GS_SPRITE:
-			pmin = v2.min_i16(v1);
-			pmax = v2.max_i16(v1);
-			break;
-		case GS_TRIANGLELIST:
-		case GS_TRIANGLESTRIP:
-			pmin = v2.min_i16(v1.min_i16(v0));
-			pmax = v2.max_i16(v1.max_i16(v0));
-			break;
-		case GS_TRIANGLEFAN:
-			pmin = v2.min_i16(v1.min_i16(v3));
-			pmax = v2.max_i16(v1.max_i16(v3));
-			break;
-		default:
-			break;
-		}
+	KickPrimitive<prim, auto_flush>(skip);
+}
 
-		GSVector4i test = pmax.lt16(m_scissor) | pmin.gt16(m_scissor.zwzwl()); 
-		
-		switch(prim)
+// Batched kicks of the packed STQ/UV + RGBA + XYZ loops: the vertices are stored in place and the
+// xy of up to countof(m_batch.skip) of them are tested at once, then the primitives are assembled
+// like VertexKick would have done one by one.  Vertices of skipped list primitives and the gaps of
+// skipped strip primitives are moved down while assembling, it never overwrites a pending vertex
+// since the tail only falls behind.  Fans and the auto flushing draws keep the per vertex kick,
+// the first tests against the head of the fan and the second may flush after any primitive.
+
+template<uint32 prim, bool auto_flush>
+__forceinline bool GSState::BeginVertexBatch(size_t count)
+{
+	if(prim == GS_TRIANGLEFAN || prim == GS_INVALID || count < 4)
+	{
+		return false;
+	}
+
+	if(auto_flush && PRIM->TME && (m_context->FRAME.Block() == m_context->TEX0.TBP0))
+	{
+		return false;
+	}
+
+	// reserved for the whole loop, growing the buffer in the middle would lose the pending vertices
+
+	if(m_vertex.tail + count >= m_vertex.maxcount)
+	{
+		GrowVertexBuffer(m_vertex.tail + count);
+	}
+
+	size_t xy_tail = m_vertex.xy_tail;
+
+	m_batch.xy[0] = m_vertex.xy[(xy_tail + 1) & 3];
+	m_batch.xy[1] = m_vertex.xy[(xy_tail + 2) & 3];
+	m_batch.xy[2] = m_vertex.xy[(xy_tail + 3) & 3];
+
+	m_batch.first = m_vertex.tail;
+	m_batch.count = 0;
+
+	return true;
+}
+
+template<uint32 prim>
+__forceinline void GSState::VertexKickBatch(uint32 skip)
+{
+	size_t i = m_batch.count;
+
+	GSVector4i v0(m_v.m[0]);
+	GSVector4i v1(m_v.m[1]); 
+
+	GSVector4i* RESTRICT tailptr = (GSVector4i*)&m_vertex.buff[m_batch.first + i];
+
+	tailptr[0] = v0;
+	tailptr[1] = v1;
+
+	StoreVertexXY(&m_batch.xy[i + 3], v1);
+
+	m_batch.skip[i] = (uint8)skip;
+
+	m_batch.count = ++i;
+
+	if(i == countof(m_batch.skip))
+	{
+		FlushVertexBatch<prim>();
+	}
+}
+
+template<uint32 prim>
+void GSState::FlushVertexBatch()
+{
+	size_t count = m_batch.count;
+
+	if(count == 0)
+	{
+		return;
+	}
+
+	uint8 test[countof(m_batch.skip) + 1];
+
+	GSVector4i smin = m_scissor.upl64(m_scissor);
+	GSVector4i smax = m_scissor.zwzwl().upl64(m_scissor.zwzwl());
+
+	for(size_t i = 0; i < count; i += 2) // the last odd one tests an unused slot
+	{
+		GSVector4i v0 = GSVector4i::load<false>(&m_batch.xy[i + 1]); // T-3
+		GSVector4i v1 = GSVector4i::load<false>(&m_batch.xy[i + 2]); // T-2
+		GSVector4i v2 = GSVector4i::load<false>(&m_batch.xy[i + 3]); // T-1
+
+		int mask = VertexSkipTest<prim>(v0, v1, v2, v2, smin, smax).mask();
+
+		test[i + 0] = (mask & 0x00f) != 0;
+		test[i + 1] = (mask & 0xf00) != 0;
+	}
+
+	size_t n = GetPrimVertexCount<prim>();
+
+	size_t first = m_batch.first;
+
+	for(size_t i = 0; i < count; i++)
+	{
+		size_t tail = m_vertex.tail;
+
+		if(tail != first + i)
 		{
-		case GS_TRIANGLELIST:
-		case GS_TRIANGLESTRIP:
-		case GS_TRIANGLEFAN:
-		case GS_SPRITE:
-			// FIXME: GREG I don't understand the purpose of the m_nativeres check
-			// It impacts badly the number of draw call in the HW renderer.
-			test |= m_nativeres ? pmin.eq16(pmax).zwzwl() : pmin.eq16(pmax);
-			break;
-		default:
-			break;
+			m_vertex.buff[tail] = m_vertex.buff[first + i];
 		}
 
-		switch(prim)
+		m_vertex.tail = ++tail;
+
+		if(tail - m_vertex.head >= n)
 		{
-		case GS_TRIANGLELIST:
-		case GS_TRIANGLESTRIP:
-			// TODO: any way to do a 16-bit integer cross product?
-			// cross product is zero most of the time because either of the vertices are the same
-			/*
-			cross = GSVector4(v2.xyxyl().i16to32().sub32(v0.upl32(v1).i16to32())); // x20, y20, x21, y21
-			cross = cross * cross.wzwz(); // x20 * y21, y20 * x21
-			test |= GSVector4i::cast(cross == cross.yxwz());
-			*/
-			test = (test | v0 == v1) | (v1 == v2 | v0 == v2); 
-			break;
-		case GS_TRIANGLEFAN:
-			/*
-			cross = GSVector4(v2.xyxyl().i16to32().sub32(v3.upl32(v1).i16to32())); // x23, y23, x21, y21
-			cross = cross * cross.wzwz(); // x23 * y21, y23 * x21
-			test |= GSVector4i::cast(cross == cross.yxwz());
-			*/
-			test = (test | v3 == v1) | (v1 == v2 | v3 == v2); 
-			break;
-		default:
-			break;
+			KickPrimitive<prim, false>(m_batch.skip[i] | test[i]);
 		}
-		
-		skip |= test.mask() & 15;
 	}
 
+	// the last kicks are the history of the next batch and of VertexKick
+
+	size_t xy_tail = m_vertex.xy_tail;
+
+	for(size_t i = count > 4 ? count - 4 : 0; i < count; i++)
+	{
+		m_vertex.xy[(xy_tail + i) & 3] = m_batch.xy[i + 3];
+	}
+
+	m_vertex.xy_tail = xy_tail + count;
+
+	m_batch.xy[0] = m_batch.xy[count + 0];
+	m_batch.xy[1] = m_batch.xy[count + 1];
+	m_batch.xy[2] = m_batch.xy[count + 2];
+
+	m_batch.first = m_vertex.tail;
+	m_batch.count = 0;
+}
+
+template<uint32 prim, bool auto_flush>
+__forceinline void GSState::KickPrimitive(uint32 skip)
+{
+	size_t head = m_vertex.head;
+	size_t tail = m_vertex.tail;
+	size_t next = m_vertex.next;
+
 	if(skip != 0)
 	{
 		switch(prim)
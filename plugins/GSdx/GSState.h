@@ -75,16 +75,21 @@ class GSState : public GSAlignedClass<32>
 
 	typedef void (GSState::*GIFPackedRegHandlerC)(const GIFPackedReg* RESTRICT r, uint32 size);
 
-	GIFPackedRegHandlerC m_fpGIFPackedRegHandlersC[2];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlersC[4];
 	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerSTQRGBAXYZF2[8];
 	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerSTQRGBAXYZ2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerUVRGBAXYZF2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerUVRGBAXYZ2[8];
 
 	template<uint32 prim, bool auto_flush> void GIFPackedRegHandlerSTQRGBAXYZF2(const GIFPackedReg* RESTRICT r, uint32 size);
 	template<uint32 prim, bool auto_flush> void GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, uint32 size);
+	template<uint32 prim, bool auto_flush> void GIFPackedRegHandlerUVRGBAXYZF2(const GIFPackedReg* RESTRICT r, uint32 size);
+	template<uint32 prim, bool auto_flush> void GIFPackedRegHandlerUVRGBAXYZ2(const GIFPackedReg* RESTRICT r, uint32 size);
 	void GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, uint32 size);
 
 	template<int i> void ApplyTEX0(GIFRegTEX0& TEX0);
 	void ApplyPRIM(uint32 prim);
+	bool IsTextureStateUsed();
 
 	void GIFRegHandlerNull(const GIFReg* RESTRICT r);
 	void GIFRegHandlerPRIM(const GIFReg* RESTRICT r);
@@ -131,6 +136,7 @@ class GSState : public GSAlignedClass<32>
 
 	int m_version;
 	int m_sssize;
+	uint8* m_freeze_buffer; // of the last incremental freeze or defrost, local memory minus m_mem.m_dirty_pages
 
 	bool m_mt;
 	void (*m_irq)();
@@ -188,16 +194,39 @@ protected:
 		size_t tail;
 	} m_index;
 
+	struct
+	{
+		size_t first, count; // vertices stored from m_vertex.buff[first] on, not kicked yet
+		uint64 xy[3 + 64 + 1]; // history of the last 3 kicks, then the batch, one more for the last pair
+		uint8 skip[64];
+	} m_batch;
+
 	void UpdateContext();
 	void UpdateScissor();
 
 	void UpdateVertexKick();
 
-	void GrowVertexBuffer();
+	void GrowVertexBuffer(size_t required = 0);
+
+	template<uint32 prim> static size_t GetPrimVertexCount();
+	void StoreVertexXY(uint64* RESTRICT dst, const GSVector4i& v1) const;
+	template<uint32 prim> GSVector4i VertexSkipTest(const GSVector4i& v0, const GSVector4i& v1, const GSVector4i& v2, const GSVector4i& v3, const GSVector4i& smin, const GSVector4i& smax) const;
 
 	template<uint32 prim, bool auto_flush>
 	void VertexKick(uint32 skip);
 
+	template<uint32 prim, bool auto_flush>
+	bool BeginVertexBatch(size_t count);
+
+	template<uint32 prim>
+	void VertexKickBatch(uint32 skip);
+
+	template<uint32 prim>
+	void FlushVertexBatch();
+
+	template<uint32 prim, bool auto_flush>
+	void KickPrimitive(uint32 skip);
+
 	// following functions need m_vt to be initialized
 
 	GSVertexTrace m_vt;
@@ -262,6 +291,8 @@ public:
 	virtual void PurgePool() = 0;
 	virtual void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r) {}
 	virtual void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false) {}
+	virtual bool MoveVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, int sx, int sy, int dx, int dy, int w, int h) {return false;}
+	virtual void SyncLocalMem() {} // waits for the draws still writing to local memory
 
 	void Move();
 	void Write(const uint8* mem, int len);
@@ -272,8 +303,8 @@ public:
 	void WriteCSR(uint32 csr) {m_regs->CSR.u32[1] = csr;}
 	void ReadFIFO(uint8* mem, int size);
 	template<int index> void Transfer(const uint8* mem, uint32 size);
-	int Freeze(GSFreezeData* fd, bool sizeonly);
-	int Defrost(const GSFreezeData* fd);
+	int Freeze(GSFreezeData* fd, bool sizeonly, bool incremental = false);
+	int Defrost(const GSFreezeData* fd, bool incremental = false);
 	void GetLastTag(uint32* tag) {*tag = m_path3hack; m_path3hack = 0;}
 	virtual void SetGameCRC(uint32 crc, int options);
 	void SetFrameSkip(int skip);
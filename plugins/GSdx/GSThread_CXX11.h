@@ -82,6 +82,11 @@ public:
 		m_thread.join();
 	}
 
+	std::thread::native_handle_type GetNativeHandle()
+	{
+		return m_thread.native_handle();
+	}
+
 	bool IsEmpty()
 	{
 		return m_queue.empty();
@@ -97,6 +102,19 @@ public:
 		m_notempty.notify_one();
 	}
 
+	// Same as Push but gives up instead of waiting when the queue is full
+	bool TryPush(const T& item) {
+		if (!m_queue.push(item))
+			return false;
+
+		{
+			std::lock_guard<std::mutex> l(m_lock);
+		}
+		m_notempty.notify_one();
+
+		return true;
+	}
+
 	void Wait()
 	{
 		if (IsEmpty())
@@ -347,6 +347,9 @@ void GSdxApp::Init()
 	// D3D Blending option
 	m_default_configuration["accurate_blending_unit_d3d11"]               = "1";
 
+	// D3D11 draws recorded in command lists, executed by a submission thread
+	m_default_configuration["deferred_context_d3d11"]                     = "0";
+
 	// OpenCL device. Windows only for now.
 	m_default_configuration["ocldev"]                                     = "";
 
@@ -364,8 +367,11 @@ void GSdxApp::Init()
 	m_default_configuration["accurate_date"]                              = "1";
 	m_default_configuration["accurate_blending_unit"]                     = "1";
 	m_default_configuration["AspectRatio"]                                = "1";
+	m_default_configuration["async_shader_compile"]                       = "0";
 	m_default_configuration["autoflush_sw"]                               = "1";
+	m_default_configuration["bindless_texture"]                           = "0";
 	m_default_configuration["capture_enabled"]                            = "0";
+	m_default_configuration["capture_format"]                             = "0";
 	m_default_configuration["capture_out_dir"]                            = "/tmp/GSdx_Capture";
 	m_default_configuration["capture_threads"]                            = "4";
 	m_default_configuration["CaptureHeight"]                              = "480";
@@ -379,9 +385,13 @@ void GSdxApp::Init()
 	m_default_configuration["dump"]                                       = "0";
 	m_default_configuration["extrathreads"]                               = "2";
 	m_default_configuration["extrathreads_height"]                        = "4";
+	m_default_configuration["extrathreads_cpus"]                          = "";
+	m_default_configuration["extrathreads_nosmt"]                         = "0";
+	m_default_configuration["extrathreads_numa_node"]                     = "-1";
 	m_default_configuration["filter"]                                     = std::to_string(static_cast<int8>(BiFiltering::PS2));
 	m_default_configuration["force_texture_clear"]                        = "0";
 	m_default_configuration["fxaa"]                                       = "0";
+	m_default_configuration["gpu_draw_profile"]                           = "0";
 	m_default_configuration["interlace"]                                  = "7";
 	m_default_configuration["large_framebuffer"]                          = "0";
 	m_default_configuration["linear_present"]                             = "1";
@@ -401,11 +411,13 @@ void GSdxApp::Init()
 	m_default_configuration["osd_color_b"]                                = "255";
 	m_default_configuration["osd_color_opacity"]                          = "100";
 	m_default_configuration["osd_fontsize"]                               = "25";
+	m_default_configuration["osd_graph_enabled"]                          = "0";
 	m_default_configuration["osd_log_enabled"]                            = "1";
 	m_default_configuration["osd_log_timeout"]                            = "4";
 	m_default_configuration["osd_monitor_enabled"]                        = "0";
 	m_default_configuration["osd_max_log_messages"]                       = "2";
 	m_default_configuration["override_geometry_shader"]                   = "-1";
+	m_default_configuration["override_GL_ARB_bindless_texture"]           = "-1";
 	m_default_configuration["override_GL_ARB_compute_shader"]             = "-1";
 	m_default_configuration["override_GL_ARB_copy_image"]                 = "-1";
 	m_default_configuration["override_GL_ARB_clear_texture"]              = "-1";
@@ -415,6 +427,7 @@ void GSdxApp::Init()
 	m_default_configuration["override_GL_ARB_get_texture_sub_image"]      = "-1";
 	m_default_configuration["override_GL_ARB_gpu_shader5"]                = "-1";
 	m_default_configuration["override_GL_ARB_multi_bind"]                 = "-1";
+	m_default_configuration["override_GL_ARB_parallel_shader_compile"]    = "-1";
 	m_default_configuration["override_GL_ARB_shader_image_load_store"]    = "-1";
 	m_default_configuration["override_GL_ARB_shader_storage_buffer_object"] = "-1";
 	m_default_configuration["override_GL_ARB_sparse_texture"]             = "-1";
@@ -425,6 +438,7 @@ void GSdxApp::Init()
 	m_default_configuration["paltex"]                                     = "0";
 	m_default_configuration["png_compression_level"]                      = std::to_string(Z_BEST_SPEED);
 	m_default_configuration["preload_frame_with_gs_data"]                 = "0";
+	m_default_configuration["present_mode"]                               = "0";
 	m_default_configuration["Renderer"]                                   = std::to_string(static_cast<int>(GSRendererType::Default));
 	m_default_configuration["resx"]                                       = "1024";
 	m_default_configuration["resy"]                                       = "1024";
@@ -438,10 +452,26 @@ void GSdxApp::Init()
 	m_default_configuration["ShadeBoost_Brightness"]                      = "50";
 	m_default_configuration["ShadeBoost_Contrast"]                        = "50";
 	m_default_configuration["ShadeBoost_Saturation"]                      = "50";
+	m_default_configuration["shader_cache"]                               = "1";
+	m_default_configuration["shader_precompile"]                          = "0";
 	m_default_configuration["shaderfx"]                                   = "0";
 	m_default_configuration["shaderfx_conf"]                              = "shaders/GSdx_FX_Settings.ini";
 	m_default_configuration["shaderfx_glsl"]                              = "shaders/GSdx.fx";
+	m_default_configuration["surface_pool_budget"]                        = "0";
+	m_default_configuration["sw_jit_cache"]                               = "0";
+	m_default_configuration["sw_sync_log"]                                = "0";
+	m_default_configuration["sw_texture_budget"]                          = "0";
+	m_default_configuration["texture_cache_budget"]                       = "0";
+	m_default_configuration["texture_dump"]                               = "0";
+	m_default_configuration["texture_dump_dir"]                           = "textures_dump";
+	m_default_configuration["texture_gpu_move"]                           = "1";
+	m_default_configuration["texture_page_hash"]                          = "0";
+	m_default_configuration["texture_prefetch"]                           = "0";
+	m_default_configuration["texture_replace"]                            = "0";
+	m_default_configuration["texture_replace_dir"]                        = "textures";
+	m_default_configuration["texture_replace_threads"]                    = "2";
 	m_default_configuration["TVShader"]                                   = "0";
+	m_default_configuration["unswizzle_threads"]                          = "0";
 	m_default_configuration["upscale_multiplier"]                         = "1";
 	m_default_configuration["UserHacks"]                                  = "0";
 	m_default_configuration["UserHacks_align_sprite_X"]                   = "0";
@@ -465,6 +495,7 @@ void GSdxApp::Init()
 	m_default_configuration["UserHacks_TextureInsideRt"]                  = "0";
 	m_default_configuration["UserHacks_TriFilter"]                        = std::to_string(static_cast<int8>(TriFiltering::None));
 	m_default_configuration["UserHacks_WildHack"]                         = "0";
+	m_default_configuration["vertex_dedup"]                               = "0";
 	m_default_configuration["wrap_gs_mem"]                                = "0";
 	m_default_configuration["vsync"]                                      = "0";
 	m_default_configuration["disable_ts_half_bottom"]                     = "0";
@@ -534,6 +565,13 @@ void GSdxApp::SetConfigDir(const char* dir)
 	}
 }
 
+std::string GSdxApp::GetConfigDir()
+{
+	size_t pos = m_ini.find_last_of(DIRECTORY_SEPARATOR);
+
+	return (pos == std::string::npos) ? std::string() : m_ini.substr(0, pos + 1);
+}
+
 std::string GSdxApp::GetConfigS(const char* entry)
 {
 	char buff[4096] = {0};
@@ -66,6 +66,10 @@ public:
 	const uint16* GetCLUT(int tp, int cx, int cy);
 	const void* GetTexture(int tp, int tx, int ty);
 
+	// False if GetCLUT/GetTexture have to read the vram again
+	bool IsCLUTValid(int tp, int cx, int cy) const {return !m_clut.dirty && m_clut.tp == tp && m_clut.cx == cx && m_clut.cy == cy;}
+	bool IsTextureValid(int tp, int tx, int ty) const {return tp < 3 && (m_texture.valid[tp][ty] & (1 << tx)) != 0;}
+
 	void Invalidate(const GSVector4i& r);
 
 	void FillRect(const GSVector4i& r, uint16 c);
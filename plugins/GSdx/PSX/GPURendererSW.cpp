@@ -50,6 +50,8 @@ void GPURendererSW::ResetDevice()
 
 GSTexture* GPURendererSW::GetOutput()
 {
+	Sync();
+
 	GSVector4i r = m_env.GetDisplayRect();
 
 	r.left <<= m_scale.x;
@@ -96,6 +98,14 @@ void GPURendererSW::Draw()
 		gd.sel.twin = (env.TWIN.u32 & 0xfffff) != 0;
 		gd.sel.ltf = m_filter == 1 && env.PRIM.TYPE == GPU_POLYGON || m_filter == 2 ? 1 : 0;
 
+		// The page and the clut are read again from the vram that queued draws may still write,
+		// and the workers must be done with the old page
+
+		if(!m_mem.IsTextureValid(env.STATUS.TP, env.STATUS.TX, env.STATUS.TY) || !m_mem.IsCLUTValid(env.STATUS.TP, env.CLUT.X, env.CLUT.Y))
+		{
+			Sync();
+		}
+
 		const void* t = m_mem.GetTexture(env.STATUS.TP, env.STATUS.TX, env.STATUS.TY);
 
 		if(!t) {ASSERT(0); return;}
@@ -165,12 +175,19 @@ void GPURendererSW::Draw()
 
 	Invalidate(r);
 
-	m_rl->Queue(data);
+	// No wait here, the next draws are set up while the workers rasterize this one, until
+	// something else reads or writes the vram (Sync)
 
-	m_rl->Sync();
+	m_rl->Queue(data);
 
 	m_perfmon.Put(GSPerfMon::Draw, 1);
 	m_perfmon.Put(GSPerfMon::Prim, prims);
+}
+
+void GPURendererSW::Sync()
+{
+	m_rl->Sync();
+
 	m_perfmon.Put(GSPerfMon::Fillrate, m_rl->GetPixels());
 }
 
@@ -35,6 +35,7 @@ protected:
 	GSTexture* GetOutput();
 	void VertexKick();
 	void Draw();
+	void Sync();
 
 public:
 	GPURendererSW(GSDevice* dev, int threads);
@@ -210,6 +210,9 @@ uint32 GPUState::ReadStatus()
 
 void GPUState::Freeze(GPUFreezeData* data)
 {
+	Flush();
+	Sync();
+
 	data->status = m_env.STATUS.u32;
 	memcpy(data->control, m_status, 256 * 4);
 	m_mem.ReadRect(GSVector4i(0, 0, 1024, 512), data->vram);
@@ -217,6 +220,9 @@ void GPUState::Freeze(GPUFreezeData* data)
 
 void GPUState::Defrost(const GPUFreezeData* data)
 {
+	Flush();
+	Sync();
+
 	m_env.STATUS.u32 = data->status;
 	memcpy(m_status, data->control, 256 * 4);
 	m_mem.WriteRect(GSVector4i(0, 0, 1024, 512), data->vram);
@@ -337,6 +343,7 @@ int GPUState::PH_Command(GPUReg* r, int size)
 		if(size < 3) return 0;
 
 		Flush();
+		Sync();
 
 		GSVector4i r2;
 
@@ -573,6 +580,7 @@ int GPUState::PH_Move(GPUReg* r, int size)
 	if(size < 4) return 0;
 
 	Flush();
+	Sync();
 
 	int sx = r[1].XY.X;
 	int sy = r[1].XY.Y;
@@ -604,6 +612,7 @@ int GPUState::PH_Write(GPUReg* r, int size)
 	if(size < required) return 0;
 
 	Flush();
+	Sync();
 
 	GSVector4i r2;
 
@@ -628,6 +637,7 @@ int GPUState::PH_Read(GPUReg* r, int size)
 	if(size < 3) return 0;
 
 	Flush();
+	Sync();
 
 	int w = r[2].XY.X;
 	int h = r[2].XY.Y;
@@ -132,6 +132,7 @@ public:
 	virtual void ResetPrim() = 0;
 	virtual void VertexKick() = 0;
 	virtual void Invalidate(const GSVector4i& r);
+	virtual void Sync() {} // before the vram is accessed outside of the renderer
 
 	void WriteData(const uint8* mem, uint32 size);
 	void ReadData(uint8* mem, uint32 size);
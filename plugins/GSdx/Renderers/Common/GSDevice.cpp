@@ -24,7 +24,10 @@
 #include "GSDevice.h"
 
 GSDevice::GSDevice()
-	: m_wnd()
+	: m_pool_bytes(0)
+	, m_pool_hits(0)
+	, m_pool_misses(0)
+	, m_wnd()
 	, m_vsync(false)
 	, m_rbswapped(false)
 	, m_backbuffer(NULL)
@@ -38,11 +41,12 @@ GSDevice::GSDevice()
 	memset(&m_vertex, 0, sizeof(m_vertex));
 	memset(&m_index, 0, sizeof(m_index));
 	m_linear_present = theApp.GetConfigB("linear_present");
+	m_pool_budget = (uint64)std::max<int>(theApp.GetConfigI("surface_pool_budget"), 0) << 20;
 }
 
 GSDevice::~GSDevice()
 {
-	for(auto t : m_pool) delete t;
+	ClearPool();
 
 	delete m_backbuffer;
 	delete m_merge;
@@ -60,9 +64,7 @@ bool GSDevice::Create(const std::shared_ptr<GSWnd>& wnd)
 
 bool GSDevice::Reset(int w, int h)
 {
-	for(auto t : m_pool) delete t;
-
-	m_pool.clear();
+	ClearPool();
 
 	delete m_backbuffer;
 	delete m_merge;
@@ -98,8 +100,16 @@ void GSDevice::Present(const GSVector4i& r, int shader)
 
 	GL_PUSH("Present");
 
+	Compose(m_backbuffer, r, shader);
+
+	Flip();
+}
+
+// Draws the current frame and the osd into dTex, the backbuffer or the frame handed to a present thread
+void GSDevice::Compose(GSTexture* dTex, const GSVector4i& r, int shader)
+{
 	// FIXME is it mandatory, it could be slow
-	ClearRenderTarget(m_backbuffer, 0);
+	ClearRenderTarget(dTex, 0);
 
 	if(m_current)
 	{
@@ -107,11 +117,9 @@ void GSDevice::Present(const GSVector4i& r, int shader)
 			ShaderConvert_DIAGONAL_FILTER, ShaderConvert_TRIANGULAR_FILTER,
 			ShaderConvert_COMPLEX_FILTER}; // FIXME
 
-		Present(m_current, m_backbuffer, GSVector4(r), s_shader[shader]);
-		RenderOsd(m_backbuffer);
+		Present(m_current, dTex, GSVector4(r), s_shader[shader]);
+		RenderOsd(dTex);
 	}
-
-	Flip();
 }
 
 void GSDevice::Present(GSTexture* sTex, GSTexture* dTex, const GSVector4& dRect, int shader)
@@ -119,35 +127,64 @@ void GSDevice::Present(GSTexture* sTex, GSTexture* dTex, const GSVector4& dRect,
 	StretchRect(sTex, dTex, dRect, shader, m_linear_present);
 }
 
+uint64 GSDevice::PoolKey(int type, int w, int h, int format)
+{
+	return ((uint64)type << 56) | ((uint64)(format & 0xffffff) << 32) | ((uint64)(w & 0xffff) << 16) | (uint64)(h & 0xffff);
+}
+
 GSTexture* GSDevice::FetchSurface(int type, int w, int h, int format)
 {
-	const GSVector2i size(w, h);
+	auto i = m_pool_bucket.find(PoolKey(type, w, h, format));
 
-	for(auto i = m_pool.begin(); i != m_pool.end(); ++i)
+	if(i != m_pool_bucket.end() && !i->second.empty())
 	{
-		GSTexture* t = *i;
+		uint16 index = i->second.back();
+		GSTexture* t = m_pool.Data(index);
 
-		if(t->GetType() == type && t->GetFormat() == format && t->GetSize() == size)
-		{
-			m_pool.erase(i);
+		i->second.pop_back();
+		m_pool.EraseIndex(index);
+		m_pool_bytes -= t->GetMemUsage();
+		m_pool_hits++;
 
-			return t;
-		}
+		return t;
 	}
 
+	m_pool_misses++;
+
 	return CreateSurface(type, w, h, format);
 }
 
+// Deletes the least recently recycled surface
+void GSDevice::PopPool()
+{
+	GSTexture* t = m_pool.back();
+	std::deque<uint16>& bucket = m_pool_bucket[PoolKey(t->GetType(), t->GetWidth(), t->GetHeight(), t->GetFormat())];
+
+	ASSERT(!bucket.empty() && bucket.front() == m_pool.LastIndex());
+
+	bucket.pop_front();
+	m_pool_bytes -= t->GetMemUsage();
+
+	delete t;
+
+	m_pool.pop_back();
+}
+
+void GSDevice::ClearPool()
+{
+	for(auto t : m_pool) delete t;
+
+	m_pool.clear();
+	m_pool_bucket.clear();
+	m_pool_bytes = 0;
+}
+
 void GSDevice::PrintMemoryUsage()
 {
 #ifdef ENABLE_OGL_DEBUG
-	uint32 pool = 0;
-	for(auto t : m_pool)
-	{
-		if (t)
-			pool += t->GetMemUsage();
-	}
-	GL_PERF("MEM: Surface Pool %dMB", pool >> 20u);
+	uint64 fetches = m_pool_hits + m_pool_misses;
+	GL_PERF("MEM: Surface Pool %dMB in %d surfaces, %d%% of %llu fetches hit", (int)(m_pool_bytes >> 20u), (int)m_pool.size(),
+		fetches ? (int)(m_pool_hits * 100 / fetches) : 0, fetches);
 #endif
 }
 
@@ -171,15 +208,16 @@ void GSDevice::Recycle(GSTexture* t)
 #endif
 		t->last_frame_used = m_frame;
 
-		m_pool.push_front(t);
+		uint16 index = m_pool.InsertFront(t);
+
+		m_pool_bucket[PoolKey(t->GetType(), t->GetWidth(), t->GetHeight(), t->GetFormat())].push_back(index);
+		m_pool_bytes += t->GetMemUsage();
 
 		//printf("%d\n",m_pool.size());
 
-		while(m_pool.size() > 300)
+		while(m_pool.size() > 300 || m_pool_budget > 0 && m_pool_bytes > m_pool_budget)
 		{
-			delete m_pool.back();
-
-			m_pool.pop_back();
+			PopPool();
 		}
 	}
 }
@@ -190,21 +228,14 @@ void GSDevice::AgePool()
 
 	while(m_pool.size() > 40 && m_frame - m_pool.back()->last_frame_used > 10)
 	{
-		delete m_pool.back();
-
-		m_pool.pop_back();
+		PopPool();
 	}
 }
 
 void GSDevice::PurgePool()
 {
 	// OOM emergency. Let's free this useless pool
-	while(!m_pool.empty())
-	{
-		delete m_pool.back();
-
-		m_pool.pop_back();
-	}
+	ClearPool();
 }
 
 GSTexture* GSDevice::CreateSparseRenderTarget(int w, int h, int format)
@@ -283,15 +314,26 @@ void GSDevice::Merge(GSTexture* sTex[3], GSVector4* sRect, GSVector4* dRect, con
 	m_current = m_merge;
 }
 
-void GSDevice::Interlace(const GSVector2i& ds, int field, int mode, float yoffset)
+bool GSDevice::Interlace(const GSVector2i& ds, int field, int mode, float yoffset, bool shadeboost)
 {
 	ResizeTarget(&m_weavebob, ds.x, ds.y);
 
+	// The shade boost only needs to be applied to the output of the last pass
+
+	bool boosted = false;
+
 	if(mode == 0 || mode == 2) // weave or blend
 	{
 		// weave first
 
-		DoInterlace(m_merge, m_weavebob, field, false, 0);
+		if(mode == 0 && shadeboost && DoInterlaceShadeBoost(m_merge, m_weavebob, field, false, 0))
+		{
+			boosted = true;
+		}
+		else
+		{
+			DoInterlace(m_merge, m_weavebob, field, false, 0);
+		}
 
 		if(mode == 2)
 		{
@@ -299,7 +341,14 @@ void GSDevice::Interlace(const GSVector2i& ds, int field, int mode, float yoffse
 
 			ResizeTarget(&m_blend, ds.x, ds.y);
 
-			DoInterlace(m_weavebob, m_blend, 2, false, 0);
+			if(shadeboost && DoInterlaceShadeBoost(m_weavebob, m_blend, 2, false, 0))
+			{
+				boosted = true;
+			}
+			else
+			{
+				DoInterlace(m_weavebob, m_blend, 2, false, 0);
+			}
 
 			m_current = m_blend;
 		}
@@ -310,7 +359,14 @@ void GSDevice::Interlace(const GSVector2i& ds, int field, int mode, float yoffse
 	}
 	else if(mode == 1) // bob
 	{
-		DoInterlace(m_merge, m_weavebob, 3, true, yoffset * field);
+		if(shadeboost && DoInterlaceShadeBoost(m_merge, m_weavebob, 3, true, yoffset * field))
+		{
+			boosted = true;
+		}
+		else
+		{
+			DoInterlace(m_merge, m_weavebob, 3, true, yoffset * field);
+		}
 
 		m_current = m_weavebob;
 	}
@@ -318,6 +374,8 @@ void GSDevice::Interlace(const GSVector2i& ds, int field, int mode, float yoffse
 	{
 		m_current = m_merge;
 	}
+
+	return boosted;
 }
 
 void GSDevice::ExternalFX()
@@ -350,15 +408,18 @@ void GSDevice::FXAA()
 
 void GSDevice::ShadeBoost()
 {
-	GSVector2i s = m_current->GetSize();
+	// Boost into m_target_tmp and swap it with the target that m_current points to,
+	// instead of copying m_current to m_target_tmp first and boosting it back
+
+	GSTexture** current = m_current == m_blend ? &m_blend : m_current == m_weavebob ? &m_weavebob : &m_merge;
 
 	if(ResizeTarget(&m_target_tmp))
 	{
-		GSVector4 sRect(0, 0, 1, 1);
-		GSVector4 dRect(0, 0, s.x, s.y);
+		DoShadeBoost(m_current, m_target_tmp);
+
+		std::swap(*current, m_target_tmp);
 
-		StretchRect(m_current, sRect, m_target_tmp, dRect, ShaderConvert_COPY, false);
-		DoShadeBoost(m_target_tmp, m_current);
+		m_current = *current;
 	}
 }
 
@@ -116,7 +116,18 @@ public:
 
 class GSDevice : public GSAlignedClass<32>
 {
+	// Free surfaces, from the most to the least recently recycled.  m_pool_bucket indexes them
+	// by PoolKey, every bucket listing its m_pool indexes in the same order (newest last).
 	FastList<GSTexture*> m_pool;
+	std::unordered_map<uint64, std::deque<uint16>> m_pool_bucket;
+	uint64 m_pool_bytes;
+	uint64 m_pool_budget; // surface_pool_budget, 0 for no limit
+	uint64 m_pool_hits;
+	uint64 m_pool_misses;
+
+	static uint64 PoolKey(int type, int w, int h, int format);
+	void PopPool();
+	void ClearPool();
 
 protected:
 	std::shared_ptr<GSWnd> m_wnd;
@@ -140,9 +151,14 @@ protected:
 	virtual void DoInterlace(GSTexture* sTex, GSTexture* dTex, int shader, bool linear, float yoffset) = 0;
 	virtual void DoFXAA(GSTexture* sTex, GSTexture* dTex) {}
 	virtual void DoShadeBoost(GSTexture* sTex, GSTexture* dTex) {}
+	// DoInterlace with the shade boost applied to its output, false if the device has no such pass
+	virtual bool DoInterlaceShadeBoost(GSTexture* sTex, GSTexture* dTex, int shader, bool linear, float yoffset) {return false;}
 	virtual void DoExternalFX(GSTexture* sTex, GSTexture* dTex) {}
 
 public:
+	// Frames handed to a present thread since the last GetPresentStats
+	struct PresentStats {int presented, dropped; float swap_ms, latency_ms, max_latency_ms;};
+
 	GSOsdManager m_osd;
 
 	GSDevice();
@@ -158,6 +174,9 @@ public:
 	virtual void Present(const GSVector4i& r, int shader);
 	virtual void Present(GSTexture* sTex, GSTexture* dTex, const GSVector4& dRect, int shader = 0);
 	virtual void Flip() {}
+	virtual bool GetPresentStats(PresentStats& stats) {return false;}
+	// Shaders built by the driver so far (binary cache hits excluded)
+	virtual uint32 GetShaderCompiles() {return 0;}
 
 	virtual void SetVSync(int vsync) {m_vsync = vsync;}
 
@@ -196,12 +215,15 @@ public:
 	GSTexture* GetCurrent();
 
 	void Merge(GSTexture* sTex[3], GSVector4* sRect, GSVector4* dRect, const GSVector2i& fs, const GSRegPMODE& PMODE, const GSRegEXTBUF& EXTBUF, const GSVector4& c);
-	void Interlace(const GSVector2i& ds, int field, int mode, float yoffset);
+	// Returns true if the shade boost was applied along with the interlace passes
+	bool Interlace(const GSVector2i& ds, int field, int mode, float yoffset, bool shadeboost = false);
 	void FXAA();
 	void ShadeBoost();
 	void ExternalFX();
 	virtual void RenderOsd(GSTexture* dt) {};
 
+	void Compose(GSTexture* dTex, const GSVector4i& r, int shader);
+
 	bool ResizeTexture(GSTexture** t, int type, int w, int h);
 	bool ResizeTexture(GSTexture** t, int w, int h);
 	bool ResizeTarget(GSTexture** t, int w, int h);
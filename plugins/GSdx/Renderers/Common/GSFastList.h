@@ -146,12 +146,16 @@ public:
 		return ++i;
 	}
 
-private:
-	// Accessed by FastListIterator<T> using class friendship
+	// Indexes are stable (see InsertFront), the surface pool keeps them in its buckets
 	__forceinline const T& Data(const uint16 index) const {
 		return m_buffer[index].data;
 	}
 
+	__forceinline uint16 LastIndex() const {
+		return m_buffer[0].prev_index;
+	}
+
+private:
 	// Accessed by FastListIterator<T> using class friendship
 	__forceinline uint16 NextIndex(const uint16 index) const {
 		return m_buffer[index].next_index;
@@ -166,10 +170,6 @@ private:
 		return m_buffer[0].next_index;
 	}
 
-	__forceinline uint16 LastIndex() const {
-		return m_buffer[0].prev_index;
-	}
-
 	__forceinline bool Full() const {
 		// The minus one is due to the presence of the auxiliary element
 		return size() == m_capacity - 1;
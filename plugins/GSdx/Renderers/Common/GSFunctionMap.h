@@ -162,6 +162,8 @@ class GSCodeGeneratorFunctionMap : public GSFunctionMap<KEY, VALUE>
 	std::unordered_map<uint64, VALUE> m_cgmap;
 	GSCodeBuffer m_cb;
 	size_t m_total_code_size;
+	size_t m_prewarmed, m_compiled;
+	bool m_prewarming;
 
 	enum {MAX_SIZE = 8192};
 
@@ -170,6 +172,9 @@ public:
 		: m_name(name)
 		, m_param(param)
 		, m_total_code_size(0)
+		, m_prewarmed(0)
+		, m_compiled(0)
+		, m_prewarming(false)
 	{
 	}
 
@@ -178,6 +183,26 @@ public:
 #ifdef _DEBUG
 		fprintf(stderr, "%s generated %zu bytes of instruction\n", m_name.c_str(), m_total_code_size);
 #endif
+		if(m_prewarmed)
+		{
+			fprintf(stderr, "%s: %zu functions pre-compiled, %zu compiled on demand\n", m_name.c_str(), m_prewarmed, m_compiled);
+		}
+	}
+
+	// Compiles the function of key ahead of its first use
+
+	void Prewarm(KEY key)
+	{
+		if(m_cgmap.find(key) != m_cgmap.end()) return;
+
+		m_prewarming = true;
+		GetDefaultFunction(key);
+		m_prewarming = false;
+	}
+
+	void GetKeys(std::vector<uint64>& keys) const
+	{
+		for(const auto& i : m_cgmap) keys.push_back((uint64)i.first);
 	}
 
 	VALUE GetDefaultFunction(KEY key)
@@ -205,6 +230,9 @@ public:
 
 			m_total_code_size += cg->getSize();
 
+			if(m_prewarming) m_prewarmed++;
+			else m_compiled++;
+
 			m_cb.ReleaseBuffer(cg->getSize());
 
 			ret = (VALUE)cg->getCode();
@@ -56,11 +56,13 @@ GSOsdManager::GSOsdManager() : m_atlas_h(0)
                              , m_atlas_w(0)
                              , m_max_width(0)
                              , m_onscreen_messages(0)
+                             , m_solid_tx(0)
                              , m_texture_dirty(true)
 {
 	m_log_enabled = theApp.GetConfigB("osd_log_enabled");
 	m_log_timeout = std::max(2, std::min(theApp.GetConfigI("osd_log_timeout"), 10));
 	m_monitor_enabled = theApp.GetConfigB("osd_monitor_enabled");
+	m_graph_enabled = theApp.GetConfigB("osd_graph_enabled");
 	m_opacity = std::max(0, std::min(theApp.GetConfigI("osd_color_opacity"), 100));
 	m_max_onscreen_messages = theApp.GetConfigI("osd_max_log_messages");
 	m_size = theApp.GetConfigI("osd_fontsize");
@@ -128,6 +130,11 @@ void GSOsdManager::upload_texture_atlas(GSTexture* t) {
 		x += pair.second.bw;
 	}
 
+	// Keep the last texels opaque for the graph bars
+	std::vector<uint8> solid(2 * m_atlas_h, 0xff);
+	t->Update(GSVector4i(m_atlas_w - 2, 0, m_atlas_w, m_atlas_h), solid.data(), 2);
+	m_solid_tx = (m_atlas_w - 1.0f) / m_atlas_w;
+
 	m_texture_dirty = false;
 }
 
@@ -234,6 +241,48 @@ void GSOsdManager::Monitor(const char *key, const char *value) {
 	}
 }
 
+void GSOsdManager::Graph(const char *key, float value, float range, const char *unit) {
+	if(!m_graph_enabled || !m_face)
+		return;
+
+	auto it = std::find_if(m_graph.begin(), m_graph.end(), [key](const graph_info& g) {return g.key == key;});
+
+	if(it == m_graph.end()) {
+		graph_info g;
+		g.key = key;
+		g.range = range;
+		g.pos = 0;
+		std::fill(std::begin(g.history), std::end(g.history), 0.0f);
+
+		m_graph.push_back(g);
+		it = m_graph.end() - 1;
+	}
+
+	it->history[it->pos] = std::max(value, 0.0f);
+	it->pos = (it->pos + 1) % GraphHistory;
+
+	// Only ascii is expected here, no need for a real conversion
+	std::string s = format(value == floorf(value) ? "%s %.0f%s%s" : "%s %.1f%s%s", key, value, *unit ? " " : "", unit);
+	it->label.assign(s.begin(), s.end());
+	for(auto c : it->label) AddGlyph(c);
+}
+
+void GSOsdManager::RenderRect(GSVertexPT1* dst, float left, float top, float right, float bottom, uint32 color) {
+	const GSVector2 t(m_solid_tx, 0.5f);
+
+	dst[0].p = GSVector4(left , top   , 0.0f, 1.0f);
+	dst[1].p = GSVector4(right, top   , 0.0f, 1.0f);
+	dst[2].p = GSVector4(left , bottom, 0.0f, 1.0f);
+	dst[3].p = GSVector4(right, top   , 0.0f, 1.0f);
+	dst[4].p = GSVector4(left , bottom, 0.0f, 1.0f);
+	dst[5].p = GSVector4(right, bottom, 0.0f, 1.0f);
+
+	for(int i = 0; i < 6; i++) {
+		dst[i].t = t;
+		dst[i].c = color;
+	}
+}
+
 void GSOsdManager::RenderGlyph(GSVertexPT1* dst, const glyph_info g, float x, float y, uint32 color) {
 	float x2 = x + g.bl * (2.0f/m_real_size.x);
 	float y2 = -y - g.bt * (2.0f/m_real_size.y);
@@ -320,6 +369,13 @@ size_t GSOsdManager::Size() {
 		}
 	}
 
+	if(m_graph_enabled) {
+		for(const auto &g : m_graph) {
+			// background and bars
+			sum += g.label.size() + 1 + GraphHistory;
+		}
+	}
+
 	return sum * 6;
 }
 
@@ -422,6 +478,59 @@ size_t GSOsdManager::GeneratePrimitives(GSVertexPT1* dst, size_t count) {
 		}
 	}
 
+	if(m_graph_enabled) {
+		// One row per graph in the top right corner, the oldest frame on the left. All of it
+		// samples the font atlas, so it still goes out with the text in a single draw.
+		static const uint32 colors[] = {0x4040ff, 0x40ff40, 0xff8040, 0x40ffff, 0xff40ff, 0xffff40, 0x4080ff, 0xffffff};
+
+		const float sx = 2.0f / m_real_size.x;
+		const float sy = 2.0f / m_real_size.y;
+		const float bar = 2 * sx;
+		const float h = (m_size + 2) * sy;
+		const float right = 1.0f - 8 * sx;
+		const float left = right - GraphHistory * bar;
+
+		float label_max = 0.0f;
+		for(const auto &g : m_graph)
+			label_max = std::max(label_max, StringSize(g.label));
+
+		uint32 color = m_color;
+		((uint8 *)&color)[3] = (uint8)(((uint8 *)&color)[3] * opacity);
+		const uint32 back = (uint32)(128 * opacity) << 24;
+
+		float top = 1.0f - 8 * sy;
+
+		for(size_t i = 0; i < m_graph.size(); i++) {
+			const graph_info& g = m_graph[i];
+
+			if((g.label.size() + 1 + GraphHistory) * 6 > count - drawn) break;
+
+			const float bottom = top - h;
+			const uint32 c = colors[i % countof(colors)] | (uint32)(255 * opacity) << 24;
+
+			float range = g.range;
+			for(float v : g.history)
+				range = std::max(range, v);
+
+			RenderRect(dst, left, top, right, bottom, back);
+			dst += 6;
+
+			for(size_t x = 0; x < GraphHistory; x++) {
+				float v = g.history[(g.pos + x) % GraphHistory] / range;
+
+				RenderRect(dst, left + x * bar, bottom + v * h, left + (x + 1) * bar, bottom, c);
+				dst += 6;
+			}
+
+			RenderString(dst, g.label, left - 8 * sx - label_max, bottom + 2 * sy, color);
+			dst += g.label.size() * 6;
+
+			drawn += (g.label.size() + 1 + GraphHistory) * 6;
+
+			top = bottom - 4 * sy;
+		}
+	}
+
 	return drawn;
 }
 
@@ -64,7 +64,21 @@ class GSOsdManager {
 
 	std::map<std::u32string, std::u32string> m_monitor;
 
+	enum {GraphHistory = 120}; // frames, one bar each
+
+	struct graph_info {
+		std::string key;
+		std::u32string label; // key, last value and unit
+		float range; // smallest full scale of the bars
+		float history[GraphHistory];
+		size_t pos; // oldest sample
+	};
+	std::vector<graph_info> m_graph;
+
+	float m_solid_tx; // an opaque texel of the atlas, the graph quads sample it
+
 	void AddGlyph(char32_t codepoint);
+	void RenderRect(GSVertexPT1* dst, float left, float top, float right, float bottom, uint32 color);
 	void RenderGlyph(GSVertexPT1* dst, const glyph_info g, float x, float y, uint32 color);
 	void RenderString(GSVertexPT1* dst, const std::u32string msg, float x, float y, uint32 color);
 	float StringSize(const std::u32string msg);
@@ -72,6 +86,7 @@ class GSOsdManager {
 	bool m_log_enabled;
 	int m_log_timeout;
 	bool m_monitor_enabled;
+	bool m_graph_enabled;
 	int m_opacity;
 	uint32 m_color;
 	int m_max_onscreen_messages;
@@ -92,6 +107,10 @@ class GSOsdManager {
 	void Log(const char *utf8);
 	void Monitor(const char *key, const char *value);
 
+	// Appends this frame's value to the graph of key (ascii), created on first use
+	bool IsGraphEnabled() const { return m_graph_enabled; }
+	void Graph(const char *key, float value, float range, const char *unit);
+
 	GSVector2i m_real_size;
 	size_t Size();
 	size_t GeneratePrimitives(GSVertexPT1* dst, size_t count);
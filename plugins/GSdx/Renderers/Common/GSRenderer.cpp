@@ -49,6 +49,8 @@ GSRenderer::GSRenderer()
 	m_fxaa        = theApp.GetConfigB("fxaa");
 	m_shaderfx    = theApp.GetConfigB("shaderfx");
 	m_shadeboost  = theApp.GetConfigB("ShadeBoost");
+
+	memset(m_graph_last, 0, sizeof(m_graph_last));
 }
 
 GSRenderer::~GSRenderer()
@@ -264,23 +266,25 @@ bool GSRenderer::Merge(int field)
 
 		m_dev->Merge(tex, src_hw, dst, fs, m_regs->PMODE, m_regs->EXTBUF, c);
 
+		bool boosted = false;
+
 		if(m_regs->SMODE2.INT && m_interlace > 0)
 		{
 			if(m_interlace == 7 && m_regs->SMODE2.FFMD) // Auto interlace enabled / Odd frame interlace setting
 			{
 				int field2 = 0;
 				int mode = 2;
-				m_dev->Interlace(ds, field ^ field2, mode, tex[1] ? tex[1]->GetScale().y : tex[0]->GetScale().y);
+				boosted = m_dev->Interlace(ds, field ^ field2, mode, tex[1] ? tex[1]->GetScale().y : tex[0]->GetScale().y, m_shadeboost);
 			}
 			else
 			{
 				int field2 = 1 - ((m_interlace - 1) & 1);
 				int mode = (m_interlace - 1) >> 1;
-				m_dev->Interlace(ds, field ^ field2, mode, tex[1] ? tex[1]->GetScale().y : tex[0]->GetScale().y);
+				boosted = m_dev->Interlace(ds, field ^ field2, mode, tex[1] ? tex[1]->GetScale().y : tex[0]->GetScale().y, m_shadeboost);
 			}
 		}
 
-		if(m_shadeboost)
+		if(m_shadeboost && !boosted)
 		{
 			m_dev->ShadeBoost();
 		}
@@ -324,16 +328,22 @@ void GSRenderer::VSync(int field)
 		m_regs->Dump(root_sw + format("%05d_f%lld_gs_reg.txt", s_n, m_perfmon.GetFrame()));
 	}
 
-	if(!m_dev->IsLost(true))
+	// Skipped frames are never presented, so don't bother looking up and merging the
+	// display buffers either.  Local memory is still kept up to date by the transfers.
+
+	if(!m_frameskip)
 	{
-		if(!Merge(field ? 1 : 0))
+		if(!m_dev->IsLost(true))
 		{
-			return;
+			if(!Merge(field ? 1 : 0))
+			{
+				return;
+			}
+		}
+		else
+		{
+			ResetDevice();
 		}
-	}
-	else
-	{
-		ResetDevice();
 	}
 
 	m_dev->AgePool();
@@ -359,7 +369,7 @@ void GSRenderer::VSync(int field)
 			std::string s2 = m_regs->SMODE2.INT ? (std::string("Interlaced ") + (m_regs->SMODE2.FFMD ? "(frame)" : "(field)")) : "Progressive";
 
 			s = format(
-				"%lld | %d x %d | %.2f fps (%d%%) | %s - %s | %s | %d S/%d P/%d D | %d%% CPU | %.2f | %.2f",
+				"%lld | %d x %d | %.2f fps (%d%%) | %s - %s | %s | %d S/%d P/%d D/%d M | %d%% CPU | %.2f | %.2f",
 				m_perfmon.GetFrame(), GetInternalResolution().x, GetInternalResolution().y, fps, (int)(100.0 * fps / GetTvRefreshRate()),
 				s2.c_str(),
 				theApp.m_gs_interlace[m_interlace].name.c_str(),
@@ -367,6 +377,7 @@ void GSRenderer::VSync(int field)
 				(int)m_perfmon.Get(GSPerfMon::SyncPoint),
 				(int)m_perfmon.Get(GSPerfMon::Prim),
 				(int)m_perfmon.Get(GSPerfMon::Draw),
+				(int)m_perfmon.Get(GSPerfMon::DrawMerged),
 				m_perfmon.CPU(),
 				m_perfmon.Get(GSPerfMon::Swizzle) / 1024,
 				m_perfmon.Get(GSPerfMon::Unswizzle) / 1024
@@ -380,12 +391,34 @@ void GSRenderer::VSync(int field)
 
 				int sum = 0;
 
-				for(int i = 0; i < 16; i++)
+				for(int i = 0; i < GSPerfMon::MaxWorkers; i++)
 				{
 					sum += m_perfmon.CPU(GSPerfMon::WorkerDraw0 + i);
 				}
 
 				s += format(" | %d%% CPU", sum);
+
+				// serial work done on the GS thread before a draw is queued to the workers
+
+				int trace = m_perfmon.CPU(GSPerfMon::VertexTraceTime);
+				int convert = m_perfmon.CPU(GSPerfMon::ConvertTime);
+				int setup = m_perfmon.CPU(GSPerfMon::SetupTime);
+
+				s += format(" | prep %d/%d/%d%%", trace, convert, setup);
+			}
+
+			int unswizzle = m_perfmon.CPU(GSPerfMon::UnswizzleTime);
+
+			if(unswizzle > 0)
+			{
+				s += format(" | %d%% unswizzle", unswizzle);
+			}
+
+			GSDevice::PresentStats present;
+
+			if(m_dev->GetPresentStats(present))
+			{
+				s += format(" | present %.1f/%.1f ms (%d dropped)", present.latency_ms, present.max_latency_ms, present.dropped);
 			}
 		}
 		else
@@ -425,6 +458,11 @@ void GSRenderer::VSync(int field)
 		// so let's use actual OSD!
 	}
 
+	if(m_dev->m_osd.IsGraphEnabled())
+	{
+		UpdateGraphs();
+	}
+
 	if(m_frameskip)
 	{
 		return;
@@ -497,6 +535,84 @@ void GSRenderer::VSync(int field)
 	}
 }
 
+// Emulator counters of the osd graphs, see common/include/Utilities/Instrumentation.h
+static const struct {const char* key; const char* name; bool bytes;} s_instr_graphs[] =
+{
+	{"EE", "ee_thread_time", false},
+	{"GS", "mtgs_thread_time", false},
+	{"VU", "mtvu_thread_time", false},
+	{"MTGS queue", "mtgs_queue_bytes", true},
+	{"CDVD read", "cdvd_read", false},
+};
+
+void GSRenderer::UpdateGraphs()
+{
+	GSOsdManager& osd = m_dev->m_osd;
+
+	const float frame_ms = 1000.0f / GetTvRefreshRate();
+
+	// The segment only exists with pcsx2 --instrument, look for it about once a second
+
+	if(!m_instr.IsAttached() && (m_perfmon.GetFrame() % 60) == 0 && m_instr.Attach())
+	{
+		m_instr_graph.clear();
+
+		for(const auto& g : s_instr_graphs)
+		{
+			int index = m_instr.Find(g.name);
+
+			m_instr_graph.push_back(GraphCounter{index, m_instr.GetEvents(index), m_instr.GetTotal(index)});
+		}
+	}
+
+	if(m_instr.IsAttached())
+	{
+		const float ms = 1000.0f / m_instr.GetFrequency();
+
+		for(size_t i = 0; i < m_instr_graph.size(); i++)
+		{
+			GraphCounter& c = m_instr_graph[i];
+
+			if(c.index < 0) continue;
+
+			uint64 events = m_instr.GetEvents(c.index);
+			uint64 total = m_instr.GetTotal(c.index);
+
+			if(s_instr_graphs[i].bytes)
+			{
+				// average of the samples taken during the frame
+				float kb = events > c.events ? (float)(total - c.total) / (events - c.events) / 1024 : 0.0f;
+
+				osd.Graph(s_instr_graphs[i].key, kb, 64.0f, "KB");
+			}
+			else
+			{
+				osd.Graph(s_instr_graphs[i].key, (float)(total - c.total) * ms, frame_ms, "ms");
+			}
+
+			c.events = events;
+			c.total = total;
+		}
+	}
+
+	// GSdx's own, the perfmon totals are never reset
+
+	double now[4] =
+	{
+		m_perfmon.GetTotal(GSPerfMon::Draw),
+		m_perfmon.GetTotal(GSPerfMon::Unswizzle) / 1024,
+		m_perfmon.GetTotal(GSPerfMon::Readback),
+		(double)m_dev->GetShaderCompiles(),
+	};
+
+	osd.Graph("Draws", (float)(now[0] - m_graph_last[0]), 100.0f, "");
+	osd.Graph("Uploads", (float)(now[1] - m_graph_last[1]), 256.0f, "KB");
+	osd.Graph("Readbacks", (float)(now[2] - m_graph_last[2]), 4.0f, "");
+	osd.Graph("Shaders", (float)(now[3] - m_graph_last[3]), 4.0f, "");
+
+	memcpy(m_graph_last, now, sizeof(now));
+}
+
 bool GSRenderer::MakeSnapshot(const std::string& path)
 {
 	if(m_snapshot.empty())
@@ -25,6 +25,7 @@
 #include "Window/GSWnd.h"
 #include "GSState.h"
 #include "GSCapture.h"
+#include "GSInstrumentation.h"
 
 class GSRenderer : public GSState
 {
@@ -37,6 +38,14 @@ class GSRenderer : public GSState
 	bool m_shift_key;
 	bool m_control_key;
 
+	// osd_graph_enabled: the emulator counters (pcsx2 --instrument) and ours, diffed per frame
+	GSInstrumentation m_instr;
+	struct GraphCounter {int index; uint64 events, total;};
+	std::vector<GraphCounter> m_instr_graph;
+	double m_graph_last[4];
+
+	void UpdateGraphs();
+
 protected:
 	int m_interlace;
 	int m_aspectratio;
@@ -30,6 +30,7 @@ GSTexture::GSTexture()
 	, m_type(0)
 	, m_format(0)
 	, m_sparse(false)
+	, m_committed_count(0)
 	, last_frame_used(0)
 	, LikelyOffset(false)
 	, OffsetHack_modx(0.0f)
@@ -37,16 +38,47 @@ GSTexture::GSTexture()
 {
 }
 
-void GSTexture::CommitRegion(const GSVector2i& region)
+void GSTexture::CommitRect(const GSVector4i& r)
 {
 	if (!m_sparse)
 		return;
 
-	GSVector2i aligned_region = RoundUpPage(region);
-	aligned_region.x = std::max(m_committed_size.x, aligned_region.x);
-	aligned_region.y = std::max(m_committed_size.y, aligned_region.y);
-	if (aligned_region != m_committed_size)
-		CommitPages(aligned_region, true);
+	const int pw = m_gpu_page_size.x + 1;
+	const int ph = m_gpu_page_size.y + 1;
+	const int cols = m_size.x / pw;
+	const int rows = m_size.y / ph;
+
+	if (m_committed_pages.empty())
+		m_committed_pages.resize(cols * rows, 0);
+
+	const int left   = std::max(r.left, 0) / pw;
+	const int top    = std::max(r.top, 0) / ph;
+	const int right  = std::min((r.right + pw - 1) / pw, cols);
+	const int bottom = std::min((r.bottom + ph - 1) / ph, rows);
+
+	for (int y = top; y < bottom; y++) {
+		uint8* row = &m_committed_pages[y * cols];
+
+		for (int x = left; x < right; ) {
+			if (row[x]) {
+				x++;
+				continue;
+			}
+
+			// Commit the run of missing pages at once
+			int end = x;
+			while (end < right && !row[end])
+				row[end++] = 1;
+
+			m_committed_count += end - x;
+			m_committed_size.x = std::max(m_committed_size.x, end * pw);
+			m_committed_size.y = std::max(m_committed_size.y, (y + 1) * ph);
+
+			CommitPages(GSVector4i(x * pw, y * ph, end * pw, (y + 1) * ph), true);
+
+			x = end;
+		}
+	}
 }
 
 void GSTexture::Commit()
@@ -54,19 +86,20 @@ void GSTexture::Commit()
 	if (!m_sparse)
 		return;
 
-	if (m_committed_size != m_size)
-		CommitPages(m_size, true);
+	if (m_committed_count == 0 || m_committed_count != m_committed_pages.size())
+		CommitRect(GSVector4i(0, 0, m_size.x, m_size.y));
 }
 
 void GSTexture::Uncommit()
 {
-	if (!m_sparse)
+	if (!m_sparse || m_committed_count == 0)
 		return;
 
-	GSVector2i zero = GSVector2i(0, 0);
+	m_committed_pages.assign(m_committed_pages.size(), 0);
+	m_committed_count = 0;
+	m_committed_size = GSVector2i(0, 0);
 
-	if (m_committed_size != zero)
-		CommitPages(m_committed_size, false);
+	CommitPages(GSVector4i(0, 0, m_size.x, m_size.y), false);
 }
 
 void GSTexture::SetGpuPageSize(const GSVector2i& page_size)
@@ -28,11 +28,13 @@ class GSTexture
 protected:
 	GSVector2 m_scale;
 	GSVector2i m_size;
-	GSVector2i m_committed_size;
+	GSVector2i m_committed_size; // bounding size of the committed pages
 	GSVector2i m_gpu_page_size;
 	int m_type;
 	int m_format;
 	bool m_sparse;
+	std::vector<uint8> m_committed_pages; // sparse: one per gpu page, by rows
+	uint32 m_committed_count;
 
 public:
 	struct GSMap {uint8* bits; int pitch;};
@@ -62,10 +64,15 @@ public:
 	int GetType() const {return m_type;}
 	int GetFormat() const {return m_format;}
 
-	virtual void CommitPages(const GSVector2i& region, bool commit) {};
-	void CommitRegion(const GSVector2i& region);
+	// r is page aligned, the page bookkeeping is already updated when it is called
+	virtual void CommitPages(const GSVector4i& r, bool commit) {};
+	// Commits the pages of r (in texels) that aren't yet, for a sparse texture.  The pages
+	// nothing drew on stay virtual.
+	void CommitRect(const GSVector4i& r);
+	void CommitRegion(const GSVector2i& region) { CommitRect(GSVector4i(0, 0, region.x, region.y)); }
 	void Commit();
 	void Uncommit();
+	bool IsSparse() const { return m_sparse; }
 	GSVector2i GetCommittedSize() const { return m_committed_size; }
 	void SetGpuPageSize(const GSVector2i& page_size);
 	GSVector2i RoundUpPage(GSVector2i v);
@@ -80,4 +87,6 @@ public:
 
 	// Typical size of a RGBA texture
 	virtual uint32 GetMemUsage() { return m_size.x * m_size.y * 4; }
+	// Whole size, committed or not
+	virtual uint32 GetVirtualMemUsage() { return GetMemUsage(); }
 };
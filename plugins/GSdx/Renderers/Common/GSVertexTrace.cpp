@@ -194,7 +194,96 @@ void GSVertexTrace::FindMinMax(const void* vertex, const uint32* index, int coun
 
 	const GSVertex* RESTRICT v = (GSVertex*)vertex;
 
-	for(int i = 0; i < count; i += n)
+	int i = 0;
+
+	#if _M_SSE >= 0x501
+
+	// Unless the color is flat (only the last vertex of a primitive counts) or the
+	// primitive is a sprite (q comes from the second vertex), every vertex is traced
+	// alike and the primitive boundaries don't matter: load two per register and take
+	// four per iteration. The loop stops on a primitive boundary, the rest is left to
+	// the code below.
+
+	if(primclass != GS_SPRITE_CLASS && (primclass == GS_POINT_CLASS || iip || !color))
+	{
+		int count8 = count - count % (n * 4);
+
+		if(count8 > 0)
+		{
+			GSVector8 tmin8(tmin, tmin);
+			GSVector8 tmax8(tmax, tmax);
+			GSVector8i cmin8(cmin, cmin);
+			GSVector8i cmax8(cmax, cmax);
+			GSVector8i pmin8(pmin, pmin);
+			GSVector8i pmax8(pmax, pmax);
+
+			for(; i < count8; i += 4)
+			{
+				GSVector8i c0(v[index[i + 0]].m[0], v[index[i + 1]].m[0]);
+				GSVector8i c1(v[index[i + 2]].m[0], v[index[i + 3]].m[0]);
+
+				if(color)
+				{
+					cmin8 = cmin8.min_u8(c0.min_u8(c1));
+					cmax8 = cmax8.max_u8(c0.max_u8(c1));
+				}
+
+				GSVector8i xyzf0(v[index[i + 0]].m[1], v[index[i + 1]].m[1]);
+				GSVector8i xyzf1(v[index[i + 2]].m[1], v[index[i + 3]].m[1]);
+
+				if(tme)
+				{
+					if(!fst)
+					{
+						GSVector8 stq0 = GSVector8::cast(c0);
+						GSVector8 stq1 = GSVector8::cast(c1);
+
+						GSVector8 q0 = stq0.wwww();
+						GSVector8 q1 = stq1.wwww();
+
+						if(accurate_stq)
+						{
+							stq0 = (stq0.xyww() / q0).xyww(q0);
+							stq1 = (stq1.xyww() / q1).xyww(q1);
+						}
+						else
+						{
+							stq0 = (stq0.xyww() * q0.rcpnr()).xyww(q0);
+							stq1 = (stq1.xyww() * q1.rcpnr()).xyww(q1);
+						}
+
+						tmin8 = tmin8.min(stq0.min(stq1));
+						tmax8 = tmax8.max(stq0.max(stq1));
+					}
+					else
+					{
+						GSVector8 st0 = GSVector8(xyzf0.uph16()).xyxy();
+						GSVector8 st1 = GSVector8(xyzf1.uph16()).xyxy();
+
+						tmin8 = tmin8.min(st0.min(st1));
+						tmax8 = tmax8.max(st0.max(st1));
+					}
+				}
+
+				GSVector8i p0 = xyzf0.upl16().blend16<0xf0>(xyzf0.yyyy().uph32(xyzf0));
+				GSVector8i p1 = xyzf1.upl16().blend16<0xf0>(xyzf1.yyyy().uph32(xyzf1));
+
+				pmin8 = pmin8.min_u32(p0.min_u32(p1));
+				pmax8 = pmax8.max_u32(p0.max_u32(p1));
+			}
+
+			tmin = tmin8.extract<0>().min(tmin8.extract<1>());
+			tmax = tmax8.extract<0>().max(tmax8.extract<1>());
+			cmin = cmin8.extract<0>().min_u8(cmin8.extract<1>());
+			cmax = cmax8.extract<0>().max_u8(cmax8.extract<1>());
+			pmin = pmin8.extract<0>().min_u32(pmin8.extract<1>());
+			pmax = pmax8.extract<0>().max_u32(pmax8.extract<1>());
+		}
+	}
+
+	#endif
+
+	for(; i < count; i += n)
 	{
 		if(primclass == GS_POINT_CLASS)
 		{
@@ -41,13 +41,43 @@ GSDevice11::GSDevice11()
 	FXAA_Compiled = false;
 	ExShader_Compiled = false;
 
+	m_shader_compiles = 0;
+
 	m_state.topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
 	m_state.bf = -1;
 
+	m_deferred.draws = 0;
+	m_deferred.frames = 0;
+	m_deferred.lists = 0;
+	m_deferred.list_draws = 0;
+	m_deferred.syncs = 0;
+	m_deferred.sync_ms = 0;
+	m_deferred.execute_ms = 0;
+
 	m_mipmap = theApp.GetConfigI("mipmap");
 	m_upscale_multiplier = theApp.GetConfigI("upscale_multiplier");
 }
 
+GSDevice11::~GSDevice11()
+{
+	if(m_submit)
+	{
+		SyncDeferred();
+
+		m_submit = nullptr;
+
+		if(m_deferred.lists > 0)
+		{
+			double lists = (double)m_deferred.lists;
+
+			fprintf(stderr, "GSdx: %llu D3D11 command lists, %.1f draws and %.3f ms of execution per list on the submission thread\n",
+				(unsigned long long)m_deferred.lists, m_deferred.list_draws / lists, m_deferred.execute_ms / lists);
+			fprintf(stderr, "GSdx: %.1f ms moved off the GS thread, %.1f ms waited back in %llu syncs for CPU reads\n",
+				m_deferred.execute_ms, m_deferred.sync_ms, (unsigned long long)m_deferred.syncs);
+		}
+	}
+}
+
 bool GSDevice11::LoadD3DCompiler()
 {
 	// Windows 8.1 and later come with the latest d3dcompiler_47.dll, but
@@ -201,6 +231,14 @@ bool GSDevice11::Create(const std::shared_ptr<GSWnd> &wnd)
 
 	uint32 flags = D3D11_CREATE_DEVICE_SINGLETHREADED;
 
+	// The submission thread uses the immediate context while the GS thread creates resources
+	bool deferred = theApp.GetConfigB("deferred_context_d3d11");
+
+	if(deferred)
+	{
+		flags &= ~D3D11_CREATE_DEVICE_SINGLETHREADED;
+	}
+
 #ifdef DEBUG
 	flags |= D3D11_CREATE_DEVICE_DEBUG;
 #endif
@@ -214,10 +252,36 @@ bool GSDevice11::Create(const std::shared_ptr<GSWnd> &wnd)
 		D3D_FEATURE_LEVEL_10_0,
 	};
 
-	hr = D3D11CreateDeviceAndSwapChain(adapter, driver_type, NULL, flags, levels, countof(levels), D3D11_SDK_VERSION, &scd, &m_swapchain, &m_dev, &level, &m_ctx);
+	hr = D3D11CreateDeviceAndSwapChain(adapter, driver_type, NULL, flags, levels, countof(levels), D3D11_SDK_VERSION, &scd, &m_swapchain, &m_dev, &level, &m_imm);
 
 	if(FAILED(hr)) return false;
 
+	m_ctx = m_imm;
+
+	if(deferred)
+	{
+		// Without driver command lists the runtime emulates them on the immediate context,
+		// there is nothing to gain (and UpdateSubresource with a box is broken on those)
+
+		D3D11_FEATURE_DATA_THREADING threading;
+
+		if(SUCCEEDED(m_dev->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading))) && threading.DriverCommandLists)
+		{
+			CComPtr<ID3D11DeviceContext> ctx;
+
+			if(SUCCEEDED(m_dev->CreateDeferredContext(0, &ctx)))
+			{
+				m_ctx = ctx;
+				m_submit = std::unique_ptr<GSJobQueue<DeferredBatch, 16>>(new GSJobQueue<DeferredBatch, 16>([this](DeferredBatch& b) {ExecuteDeferred(b);}));
+			}
+		}
+
+		if(!m_submit)
+		{
+			fprintf(stderr, "GSdx: the driver has no D3D11 command lists, draws are submitted from the GS thread\n");
+		}
+	}
+
 	if(!SetFeatureLevel(level, true))
 	{
 		return false;
@@ -504,6 +568,19 @@ bool GSDevice11::Create(const std::shared_ptr<GSWnd> &wnd)
 
 bool GSDevice11::Reset(int w, int h)
 {
+	if(m_submit)
+	{
+		SyncDeferred();
+
+		// The recording state still references the backbuffer
+		m_ctx->OMSetRenderTargets(0, NULL, NULL);
+
+		m_state.rt_view = NULL;
+		m_state.rt_texture = NULL;
+		m_state.dsv = NULL;
+		m_state.rt_ds = NULL;
+	}
+
 	if(!__super::Reset(w, h))
 		return false;
 
@@ -523,7 +600,7 @@ bool GSDevice11::Reset(int w, int h)
 			return false;
 		}
 
-		m_backbuffer = new GSTexture11(backbuffer);
+		m_backbuffer = new GSTexture11(backbuffer, this);
 	}
 
 	return true;
@@ -543,6 +620,8 @@ void GSDevice11::SetExclusive(bool isExcl)
 	m_swapchain->ResizeTarget(&desc);
 	*/
 
+	SyncDeferred();
+
 	HRESULT hr = m_swapchain->SetFullscreenState(isExcl, NULL);
 
 	if(hr == DXGI_ERROR_NOT_CURRENTLY_AVAILABLE)
@@ -558,7 +637,100 @@ void GSDevice11::SetVSync(int vsync)
 
 void GSDevice11::Flip()
 {
-	m_swapchain->Present(m_vsync, 0);
+	if(m_submit)
+	{
+		{
+			std::lock_guard<std::mutex> l(m_deferred.lock);
+
+			m_deferred.frames++;
+		}
+
+		SubmitDeferred(m_vsync);
+
+		// Record the next frame while this one is presented, but no further ahead
+		std::unique_lock<std::mutex> l(m_deferred.lock);
+
+		m_deferred.cv.wait(l, [this] {return m_deferred.frames <= 1;});
+	}
+	else
+	{
+		m_swapchain->Present(m_vsync, 0);
+	}
+}
+
+void GSDevice11::EndScene()
+{
+	GSDevice::EndScene();
+
+	// Only between scenes, the draws of a scene can share one vertex upload that a new list would lose
+	if(m_submit && m_deferred.draws >= 256)
+	{
+		SubmitDeferred(-1);
+	}
+}
+
+void GSDevice11::SubmitDeferred(int present)
+{
+	DeferredBatch b;
+
+	// Keep the state of the deferred context, the state caches of the device remain valid
+	m_ctx->FinishCommandList(TRUE, &b.cl);
+
+	b.present = present;
+
+	m_deferred.lists++;
+	m_deferred.list_draws += m_deferred.draws;
+	m_deferred.draws = 0;
+
+	m_submit->Push(b);
+
+	// The first map of a dynamic buffer in a command list must discard it
+	m_vertex.start = m_vertex.limit;
+	m_index.start = m_index.limit;
+}
+
+void GSDevice11::ExecuteDeferred(DeferredBatch& b)
+{
+	// Submission thread
+
+	if(b.cl)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		m_imm->ExecuteCommandList(b.cl, FALSE);
+
+		m_deferred.execute_ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		b.cl = nullptr;
+	}
+
+	if(b.present >= 0)
+	{
+		m_swapchain->Present(b.present, 0);
+
+		{
+			std::lock_guard<std::mutex> l(m_deferred.lock);
+
+			m_deferred.frames--;
+		}
+
+		m_deferred.cv.notify_one();
+	}
+}
+
+void GSDevice11::SyncDeferred()
+{
+	if(!m_submit)
+		return;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	SubmitDeferred(-1);
+
+	m_submit->Wait();
+
+	m_deferred.syncs++;
+	m_deferred.sync_ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 }
 
 void GSDevice11::BeforeDraw()
@@ -594,6 +766,8 @@ void GSDevice11::BeforeDraw()
 
 void GSDevice11::AfterDraw()
 {
+	m_deferred.draws++;
+
 	unsigned long i;
 	while (_BitScanForward(&i, m_state.ps_sr_bitfield))
 	{
@@ -712,7 +886,7 @@ GSTexture* GSDevice11::CreateSurface(int type, int w, int h, int format)
 
 	if(SUCCEEDED(hr))
 	{
-		t = new GSTexture11(texture);
+		t = new GSTexture11(texture, this);
 
 		switch(type)
 		{
@@ -1557,6 +1731,8 @@ void GSDevice11::CompileShader(std::vector<char> source, const char* fn, ID3DInc
 
 	hr = s_pD3DCompile(source.data(), source.size(), fn, &m[0], include, entry, shader_model.c_str(), flags, 0, shader, &error);
 
+	m_shader_compiles++;
+
 	if(error)
 	{
 		fprintf(stderr, "%s\n", (const char*)error->GetBufferPointer());
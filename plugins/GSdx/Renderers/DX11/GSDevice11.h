@@ -23,7 +23,9 @@
 
 #include "GSTexture11.h"
 #include "GSVector.h"
+#include "GSThread_CXX11.h"
 #include "Renderers/Common/GSDevice.h"
+#include <chrono>
 
 struct GSVertexShader11
 {
@@ -341,8 +343,41 @@ private:
 	//
 
 	CComPtr<ID3D11Device> m_dev;
-	CComPtr<ID3D11DeviceContext> m_ctx;
+	CComPtr<ID3D11DeviceContext> m_ctx; // immediate, or deferred with deferred_context_d3d11
+	CComPtr<ID3D11DeviceContext> m_imm;
 	CComPtr<IDXGISwapChain> m_swapchain;
+
+	// Deferred mode: the GS thread records into m_ctx, the command list is closed every few
+	// hundred draws and on Flip, then a submission thread executes it on m_imm (and presents).
+	// The GS thread only uses m_imm itself after SyncDeferred, for the CPU reads.
+	struct DeferredBatch
+	{
+		CComPtr<ID3D11CommandList> cl;
+		int present; // sync interval, -1 if the batch isn't the end of a frame
+	};
+
+	std::unique_ptr<GSJobQueue<DeferredBatch, 16>> m_submit;
+
+	struct
+	{
+		int draws; // recorded in the current list
+
+		std::mutex lock;
+		std::condition_variable cv;
+		int frames; // lock, queued and not presented yet
+
+		// Stats, GS thread
+		uint64 lists;
+		uint64 list_draws;
+		uint64 syncs;
+		double sync_ms;
+
+		// Stats, submission thread
+		double execute_ms;
+	} m_deferred;
+
+	void SubmitDeferred(int present);
+	void ExecuteDeferred(DeferredBatch& b);
 	CComPtr<ID3D11Buffer> m_vb;
 	CComPtr<ID3D11Buffer> m_vb_old;
 	CComPtr<ID3D11Buffer> m_ib;
@@ -453,6 +488,7 @@ private:
 
 protected:
 	struct {D3D_FEATURE_LEVEL level; std::string model, vs, gs, ps, cs;} m_shader;
+	uint32 m_shader_compiles;
 
 	static HMODULE s_d3d_compiler_dll;
 	static decltype(&D3DCompile) s_pD3DCompile;
@@ -462,7 +498,7 @@ protected:
 
 public:
 	GSDevice11();
-	virtual ~GSDevice11() {}
+	virtual ~GSDevice11();
 
 	bool SetFeatureLevel(D3D_FEATURE_LEVEL level, bool compat_mode);
 	void GetFeatureLevel(D3D_FEATURE_LEVEL& level) const { level = m_shader.level; }
@@ -473,14 +509,19 @@ public:
 	bool Create(const std::shared_ptr<GSWnd> &wnd);
 	bool Reset(int w, int h);
 	void Flip();
+	uint32 GetShaderCompiles() {return m_shader_compiles;}
 	void SetVSync(int vsync) final;
 
 	void SetExclusive(bool isExcl);
 
+	// Executes everything recorded so far, the immediate context is then free for the GS thread
+	void SyncDeferred();
+
 	void DrawPrimitive() final;
 	void DrawIndexedPrimitive();
 	void DrawIndexedPrimitive(int offset, int count) final;
 	void Dispatch(uint32 x, uint32 y, uint32 z);
+	void EndScene() final;
 
 	void ClearRenderTarget(GSTexture* t, const GSVector4& c) final;
 	void ClearRenderTarget(GSTexture* t, uint32 c) final;
@@ -21,17 +21,19 @@
 
 #include "stdafx.h"
 #include "GSTexture11.h"
+#include "GSDevice11.h"
 #include "GSPng.h"
 
-GSTexture11::GSTexture11(ID3D11Texture2D* texture)
-	: m_texture(texture), m_layer(0)
+GSTexture11::GSTexture11(ID3D11Texture2D* texture, GSDevice11* owner)
+	: m_owner(owner), m_texture(texture), m_layer(0)
 {
 	ASSERT(m_texture);
 
 	m_texture->GetDevice(&m_dev);
 	m_texture->GetDesc(&m_desc);
 
-	m_dev->GetImmediateContext(&m_ctx);
+	m_ctx = (ID3D11DeviceContext*)*owner;
+	m_dev->GetImmediateContext(&m_imm);
 
 	m_size.x = (int)m_desc.Width;
 	m_size.y = (int)m_desc.Height;
@@ -80,7 +82,10 @@ bool GSTexture11::Map(GSMap& m, const GSVector4i* r, int layer)
 		D3D11_MAPPED_SUBRESOURCE map;
 		UINT subresource = layer;
 
-		if(SUCCEEDED(m_ctx->Map(m_texture, subresource, D3D11_MAP_READ_WRITE, 0, &map)))
+		// The copies into the staging texture must have been executed
+		m_owner->SyncDeferred();
+
+		if(SUCCEEDED(m_imm->Map(m_texture, subresource, D3D11_MAP_READ_WRITE, 0, &map)))
 		{
 			m.bits = (uint8*)map.pData;
 			m.pitch = (int)map.RowPitch;
@@ -99,7 +104,7 @@ void GSTexture11::Unmap()
 	if(m_texture)
 	{
 		UINT subresource = m_layer;
-		m_ctx->Unmap(m_texture, subresource);
+		m_imm->Unmap(m_texture, subresource);
 	}
 }
 
@@ -120,7 +125,9 @@ bool GSTexture11::Save(const std::string& fn)
 		return false;
 	}
 
-	m_ctx->CopyResource(res, m_texture);
+	m_owner->SyncDeferred();
+
+	m_imm->CopyResource(res, m_texture);
 
 	if (m_desc.BindFlags & D3D11_BIND_DEPTH_STENCIL)
 	{
@@ -137,15 +144,15 @@ bool GSTexture11::Save(const std::string& fn)
 
 		D3D11_MAPPED_SUBRESOURCE sm, dm;
 
-		hr = m_ctx->Map(res, 0, D3D11_MAP_READ, 0, &sm);
+		hr = m_imm->Map(res, 0, D3D11_MAP_READ, 0, &sm);
 		if (FAILED(hr))
 		{
 			return false;
 		}
-		hr = m_ctx->Map(dst, 0, D3D11_MAP_WRITE, 0, &dm);
+		hr = m_imm->Map(dst, 0, D3D11_MAP_WRITE, 0, &dm);
 		if (FAILED(hr))
 		{
-			m_ctx->Unmap(res, 0);
+			m_imm->Unmap(res, 0);
 			return false;
 		}
 
@@ -160,8 +167,8 @@ bool GSTexture11::Save(const std::string& fn)
 			}
 		}
 
-		m_ctx->Unmap(res, 0);
-		m_ctx->Unmap(dst, 0);
+		m_imm->Unmap(res, 0);
+		m_imm->Unmap(dst, 0);
 
 		res = dst;
 	}
@@ -186,7 +193,7 @@ bool GSTexture11::Save(const std::string& fn)
 	}
 
 	D3D11_MAPPED_SUBRESOURCE sm;
-	hr = m_ctx->Map(res, 0, D3D11_MAP_READ, 0, &sm);
+	hr = m_imm->Map(res, 0, D3D11_MAP_READ, 0, &sm);
 	if (FAILED(hr))
 	{
 		return false;
@@ -195,7 +202,7 @@ bool GSTexture11::Save(const std::string& fn)
 	int compression = theApp.GetConfigI("png_compression_level");
 	bool success = GSPng::Save(format, fn, static_cast<uint8*>(sm.pData), desc.Width, desc.Height, sm.RowPitch, compression);
 
-	m_ctx->Unmap(res, 0);
+	m_imm->Unmap(res, 0);
 
 	return success;
 }
@@ -23,10 +23,14 @@
 
 #include "Renderers/Common/GSTexture.h"
 
+class GSDevice11;
+
 class GSTexture11 : public GSTexture
 {
+	GSDevice11* m_owner;
 	CComPtr<ID3D11Device> m_dev;
-	CComPtr<ID3D11DeviceContext> m_ctx;
+	CComPtr<ID3D11DeviceContext> m_ctx; // recording context of the device
+	CComPtr<ID3D11DeviceContext> m_imm; // immediate context, for the CPU reads
 	CComPtr<ID3D11Texture2D> m_texture;
 	D3D11_TEXTURE2D_DESC m_desc;
 	CComPtr<ID3D11ShaderResourceView> m_srv;
@@ -38,7 +42,7 @@ class GSTexture11 : public GSTexture
 	int m_max_layer;
 
 public:
-	explicit GSTexture11(ID3D11Texture2D* texture);
+	GSTexture11(ID3D11Texture2D* texture, GSDevice11* owner);
 
 	bool Update(const GSVector4i& r, const void* data, int pitch, int layer = 0);
 	bool Map(GSMap& m, const GSVector4i* r = NULL, int layer = 0);
@@ -79,6 +79,8 @@ void GSTextureCache11::Read(Target* t, const GSVector4i& r)
 
 	if (GSTexture* offscreen = m_renderer->m_dev->CopyOffscreen(t->m_texture, src, w, h, format, ps_shader))
 	{
+		m_renderer->m_perfmon.Put(GSPerfMon::Readback, 1);
+
 		GSTexture::GSMap m;
 
 		if (offscreen->Map(m))
@@ -122,6 +124,8 @@ void GSTextureCache11::Read(Source* t, const GSVector4i& r)
 	const GIFRegTEX0& TEX0 = t->m_TEX0;
 
 	if (GSTexture* offscreen  = m_renderer->m_dev->CreateOffscreen(r.width(), r.height())) {
+		m_renderer->m_perfmon.Put(GSPerfMon::Readback, 1);
+
 		m_renderer->m_dev->CopyRect(t->m_texture, offscreen, r);
 
 		GSTexture::GSMap m;
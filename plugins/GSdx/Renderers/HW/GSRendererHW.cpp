@@ -43,6 +43,7 @@ GSRendererHW::GSRendererHW(GSTextureCache* tc)
 	m_large_framebuffer  = theApp.GetConfigB("large_framebuffer");
 	m_accurate_date = theApp.GetConfigI("accurate_date");
 	m_disable_ts_half_bottom = theApp.GetConfigB("disable_ts_half_bottom");
+	m_vertex_dedup = theApp.GetConfigB("vertex_dedup");
 
 	if (theApp.GetConfigB("UserHacks")) {
 		m_userhacks_enabled_gs_mem_clear = !theApp.GetConfigB("UserHacks_Disable_Safe_Features");
@@ -281,7 +282,15 @@ void GSRendererHW::VSync(int field)
 
 	GSRenderer::VSync(field);
 
-	m_tc->IncAge();
+	// Nothing is drawn on skipped frames; aging the cache then would only evict the
+	// targets that the next drawn frame needs.
+
+	if(!m_frameskip)
+	{
+		m_tc->IncAge();
+
+		m_tc->Prefetch();
+	}
 
 	m_tc->PrintMemoryUsage();
 	m_dev->PrintMemoryUsage();
@@ -434,6 +443,71 @@ void GSRendererHW::Lines2Sprites()
 	}
 }
 
+// Merge bit-identical vertices and remap the index buffer to them. Vertices stay in their
+// original (emission) order, which is also the order the indices first reference them, so
+// the post-transform cache sees the same locality as before, just with fewer vertices.
+void GSRendererHW::DeduplicateVertices()
+{
+	const size_t count = m_vertex.next;
+
+	if (count < 6) return;
+
+	size_t size = 64;
+	while (size < count * 2) size <<= 1;
+	const size_t mask = size - 1;
+
+	m_dedup_table.assign(size, UINT32_MAX);
+	m_dedup_remap.resize(count);
+
+	GSVertex* RESTRICT v = m_vertex.buff;
+	uint32* RESTRICT remap = m_dedup_remap.data();
+	uint32* RESTRICT table = m_dedup_table.data();
+	uint32 unique = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		GSVector4i v0(v[i].m[0]);
+		GSVector4i v1(v[i].m[1]);
+
+		GSVector4i h4 = v0 ^ v1;
+		uint32 h = (uint32)(h4.extract32<0>() ^ h4.extract32<1>() * 0x9e3779b1u ^ h4.extract32<2>() * 0x85ebca6bu ^ h4.extract32<3>() * 0xc2b2ae35u);
+		h ^= h >> 15;
+
+		size_t slot = h & mask;
+
+		while (true) {
+			uint32 j = table[slot];
+
+			if (j == UINT32_MAX) {
+				// Writes only go to slots that were already read, so this can be done in place
+				v[unique].m[0] = v0;
+				v[unique].m[1] = v1;
+				table[slot] = unique;
+				remap[i] = unique++;
+				break;
+			}
+
+			if (((GSVector4i(v[j].m[0]) == v0) & (GSVector4i(v[j].m[1]) == v1)).alltrue()) {
+				remap[i] = j;
+				break;
+			}
+
+			slot = (slot + 1) & mask;
+		}
+	}
+
+	if (unique == count) return;
+
+	uint32* RESTRICT index = m_index.buff;
+
+	for (size_t i = 0; i < m_index.tail; i++) {
+		index[i] = remap[index[i]];
+	}
+
+	m_perfmon.Put(GSPerfMon::VertexDedup, (double)(count - unique));
+
+	m_vertex.head = m_vertex.tail = m_vertex.next = unique;
+}
+
 // Fix the vertex position/tex_coordinate from 16 bits color to 32 bits color
 void GSRendererHW::ConvertSpriteTextureShuffle(bool& write_ba, bool& read_ba)
 {
@@ -672,6 +746,11 @@ void GSRendererHW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 	m_tc->InvalidateVideoMem(m_mem.GetOffset(BITBLTBUF.DBP, BITBLTBUF.DBW, BITBLTBUF.DPSM), r);
 }
 
+bool GSRendererHW::MoveVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, int sx, int sy, int dx, int dy, int w, int h)
+{
+	return m_tc->Move(BITBLTBUF, sx, sy, dx, dy, w, h);
+}
+
 void GSRendererHW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut)
 {
 	// printf("[%d] InvalidateLocalMem %d,%d - %d,%d %05x (%d)\n", (int)m_perfmon.GetFrame(), r.left, r.top, r.right, r.bottom, (int)BITBLTBUF.SBP, (int)BITBLTBUF.SPSM);
@@ -1176,6 +1255,13 @@ void GSRendererHW::Draw()
 		}
 	}
 
+	// Triangle lists often resend the shared corners of a mesh, strips and fans already share
+	// them through the index buffer but a game can still restart them on the same vertices.
+
+	if (m_vertex_dedup && m_vt.m_primclass == GS_TRIANGLE_CLASS) {
+		DeduplicateVertices();
+	}
+
 	//
 
 	DrawPrims(rt_tex, ds_tex, m_src);
@@ -1382,6 +1468,7 @@ void GSRendererHW::OI_GsMemClear()
 			return;
 
 		GL_INS("OI_GsMemClear (%d,%d => %d,%d)", r.x, r.y, r.z, r.w);
+		m_mem.SetDirtyPages(off, r);
 		int format = GSLocalMemory::m_psm[m_context->FRAME.PSM].fmt;
 
 		// FIXME: loop can likely be optimized with AVX/SSE. Pixels aren't
@@ -37,6 +37,9 @@ private:
 
 	bool m_large_framebuffer;
 	bool m_disable_ts_half_bottom;
+	bool m_vertex_dedup;
+	std::vector<uint32> m_dedup_remap;
+	std::vector<uint32> m_dedup_table;
 	bool m_userhacks_align_sprite_X;
 	bool m_userhacks_enabled_gs_mem_clear;
 	bool m_userHacks_merge_sprite;
@@ -171,6 +174,7 @@ public:
 	GSVector2i GetCustomResolution();
 	void SetScaling();
 	void Lines2Sprites();
+	void DeduplicateVertices();
 	void ConvertSpriteTextureShuffle(bool& write_ba, bool& read_ba);
 	GSVector4 RealignTargetTextureCoordinate(const GSTextureCache::Source* tex);
 	GSVector4i ComputeBoundingBox(const GSVector2& rtscale, const GSVector2i& rtsize);
@@ -183,6 +187,7 @@ public:
 	GSTexture* GetFeedbackOutput();
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
+	bool MoveVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, int sx, int sy, int dx, int dy, int w, int h);
 	void Draw();
 
 	// Called by the texture cache to know if current texture is useful
@@ -26,11 +26,23 @@
 
 bool GSTextureCache::m_disable_partial_invalidation = false;
 bool GSTextureCache::m_wrap_gs_mem = false;
+bool GSTextureCache::m_page_hash = false;
+std::unique_ptr<GSTextureCache::Unswizzler> GSTextureCache::m_unswizzler;
+
+static uint32 s_source_id = 0;
+
+// Sources whose prefetch was lost that many times to a new upload aren't prefetched anymore
+static const uint8 s_max_prefetch_misses = 2;
 
 GSTextureCache::GSTextureCache(GSRenderer* r)
 	: m_renderer(r)
 	, m_palette_map(r)
+	, m_readback_epoch(0)
+	, m_frame(0)
+	, m_sparse_reported(0)
 {
+	m_budget = (uint64)std::max<int>(theApp.GetConfigI("texture_cache_budget"), 0) << 20;
+
 	if (theApp.GetConfigB("UserHacks")) {
 		m_spritehack                   = theApp.GetConfigI("UserHacks_SpriteHack");
 		UserHacks_HalfPixelOffset      = theApp.GetConfigI("UserHacks_HalfPixelOffset") == 1;
@@ -52,6 +64,9 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 	}
 
 	m_paltex = theApp.GetConfigB("paltex");
+	m_gpu_move = theApp.GetConfigB("texture_gpu_move");
+	m_page_hash = theApp.GetConfigB("texture_page_hash");
+	m_prefetch = theApp.GetConfigB("texture_prefetch");
 	m_crc_hack_level = theApp.GetConfigT<CRCHackLevel>("crc_hack_level");
 	if (m_crc_hack_level == CRCHackLevel::Automatic)
 		m_crc_hack_level = GSUtil::GetRecommendedCRCHackLevel(theApp.GetCurrentRendererType());
@@ -60,12 +75,33 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 	// isn't enough in custom resolution)
 	// Test: onimusha 3 PAL 60Hz
 	m_temp = (uint8*)_aligned_malloc(9 * 1024 * 1024, 32);
+
+	int threads = theApp.GetConfigI("unswizzle_threads");
+
+	if(threads > 0)
+	{
+		m_unswizzler = std::unique_ptr<Unswizzler>(new Unswizzler(threads));
+	}
+
+	bool replace = theApp.GetConfigB("texture_replace");
+	bool dump = theApp.GetConfigB("texture_dump");
+
+	if(replace || dump)
+	{
+		m_replacement = std::unique_ptr<GSTextureReplacement>(new GSTextureReplacement(
+			replace ? theApp.GetConfigS("texture_replace_dir") : "",
+			dump ? theApp.GetConfigS("texture_dump_dir") : "",
+			theApp.GetConfigI("texture_replace_threads")));
+	}
 }
 
 GSTextureCache::~GSTextureCache()
 {
 	RemoveAll();
 
+	m_unswizzler = nullptr;
+	m_replacement = nullptr;
+
 	_aligned_free(m_temp);
 }
 
@@ -75,9 +111,7 @@ void GSTextureCache::RemovePartial()
 
 	for (int type = 0; type < 2; type++)
 	{
-		for (auto t : m_dst[type]) delete t;
-
-		m_dst[type].clear();
+		m_dst[type].RemoveAll();
 	}
 }
 
@@ -85,11 +119,11 @@ void GSTextureCache::RemoveAll()
 {
 	m_src.RemoveAll();
 
+	m_lookups.clear();
+
 	for(int type = 0; type < 2; type++)
 	{
-		for (auto t : m_dst[type]) delete t;
-
-		m_dst[type].clear();
+		m_dst[type].RemoveAll();
 	}
 
 	m_palette_map.Clear();
@@ -389,7 +423,11 @@ GSTextureCache::Source* GSTextureCache::LookupSource(const GIFRegTEX0& TEX0, con
 		src = CreateSource(TEX0, TEXA, dst, half_right, x_offset, y_offset);
 		new_source = true;
 
+		m_renderer->m_perfmon.Put(GSPerfMon::TextureMiss, 1);
+
 	} else {
+		m_renderer->m_perfmon.Put(GSPerfMon::TextureHit, 1);
+
 		GL_CACHE("TC: src hit: %d (0x%x, 0x%x, %s)",
 					src->m_texture ? src->m_texture->GetID() : 0,
 					TEX0.TBP0, psm_s.pal > 0 ? TEX0.CBP : 0,
@@ -400,6 +438,11 @@ GSTextureCache::Source* GSTextureCache::LookupSource(const GIFRegTEX0& TEX0, con
 		AttachPaletteToSource(src, psm_s.pal, true);
 	}
 
+	if(m_prefetch)
+	{
+		RecordLookup(src, r);
+	}
+
 	src->Update(r);
 
 	m_src.m_used = true;
@@ -431,26 +474,37 @@ void GSTextureCache::ScaleTexture(GSTexture* texture)
 
 GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, int w, int h, int type, bool used, uint32 fbmask)
 {
+	m_readback_epoch++;
+
 	const GSLocalMemory::psm_t& psm_s = GSLocalMemory::m_psm[TEX0.PSM];
 	uint32 bp = TEX0.TBP0;
 
 	Target* dst = NULL;
 
-	auto& list = m_dst[type];
-	for(auto i = list.begin(); i != list.end(); ++i) {
-		Target* t = *i;
+	int scanned = 0;
 
-		if(bp == t->m_TEX0.TBP0)
-		{
-			list.MoveFront(i.Index());
+	// The most recently used of the targets at bp
+	auto& map = m_dst[type];
+	auto range = map.m_bp.equal_range(bp);
+	for(auto i = range.first; i != range.second; ++i) {
+		Target* t = i->second;
+
+		scanned++;
 
+		if(dst == NULL || t->m_mru > dst->m_mru)
+		{
 			dst = t;
+		}
+	}
 
-			dst->m_32_bits_fmt |= (psm_s.bpp != 16);
-			dst->m_TEX0 = TEX0;
+	m_renderer->m_perfmon.Put(GSPerfMon::TargetScan, scanned);
 
-			break;
-		}
+	if(dst)
+	{
+		map.MoveFront(dst);
+
+		dst->m_32_bits_fmt |= (psm_s.bpp != 16);
+		dst->m_TEX0 = TEX0;
 	}
 
 	if (dst) {
@@ -543,11 +597,15 @@ GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, int
 		dst->m_used = true;
 	}
 
+	dst->m_lookup_frame = m_frame;
+
 	return dst;
 }
 
 GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, int w, int h, int real_h)
 {
+	m_readback_epoch++;
+
 	uint32 bp = TEX0.TBP0;
 
 	Target* dst = NULL;
@@ -671,7 +729,7 @@ void GSTextureCache::InvalidateVideoMemType(int type, uint32 bp)
 					t->m_texture ? t->m_texture->GetID() : 0,
 					t->m_TEX0.TBP0);
 
-			list.erase(i);
+			list.RemoveAt(t);
 			delete t;
 
 			break;
@@ -686,6 +744,8 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 {
 	if(!off) return; // Fixme. Crashes Dual Hearts, maybe others as well. Was fine before r1549.
 
+	m_readback_epoch++;
+
 	uint32 bp = off->bp;
 	uint32 bw = off->bw;
 	uint32 psm = off->psm;
@@ -775,7 +835,13 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 
 				if(!s->m_target)
 				{
-					if(m_disable_partial_invalidation && s->m_repeating)
+					if(s->m_replaced || s->m_replace_pending)
+					{
+						// The content no longer matches the hash. Start over with a new source,
+						// which may have a replacement of its own.
+						m_src.RemoveAt(s);
+					}
+					else if(m_disable_partial_invalidation && s->m_repeating)
 					{
 						m_src.RemoveAt(s);
 					}
@@ -799,6 +865,13 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 
 						s->m_complete = false;
 
+						if(s->m_prefetched)
+						{
+							// uploaded again before the next frame used it, decoded for nothing
+							s->m_prefetched = false;
+							s->m_prefetch_misses++;
+						}
+
 						found |= b;
 					}
 				}
@@ -818,13 +891,41 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 
 	if(!target) return;
 
+	// Only the targets on the page of bp (starting at bp or containing it) and the ones starting
+	// in the rows written after bp ("Dirty After" below) can be affected
+
+	uint32 bp_page = bp >> 5;
+	uint32 after_bp = bp;
+
+	if(bw > 0 && r.bottom > 0)
+	{
+		after_bp = std::min<uint32>(bp + (r.bottom - 1) / GSLocalMemory::m_psm[psm].pgs.y * bw * 32, MAX_BLOCKS - 1);
+	}
+
 	for(int type = 0; type < 2; type++)
 	{
 		auto& list = m_dst[type];
-		for(auto i = list.begin(); i != list.end(); )
+		auto& targets = m_invalidate_targets;
+
+		targets.clear();
+
+		for(auto t : list.m_map[bp_page])
+		{
+			targets.push_back(t);
+		}
+
+		for(auto i = list.m_bp.upper_bound(bp); i != list.m_bp.end() && i->first <= after_bp; ++i)
+		{
+			if((i->first >> 5) != bp_page) // or it is in m_map[bp_page] already
+			{
+				targets.push_back(i->second);
+			}
+		}
+
+		m_renderer->m_perfmon.Put(GSPerfMon::TargetScan, targets.size());
+
+		for(Target* t : targets)
 		{
-			auto j = i++;
-			Target* t = *j;
 
 			// GH: (I think) this code is completely broken. Typical issue:
 			// EE write an alpha channel into 32 bits texture
@@ -845,7 +946,7 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 				}
 				else
 				{
-					list.erase(j);
+					list.RemoveAt(t);
 					GL_CACHE("TC: Remove Target(%s) %d (0x%x)", to_string(type),
 								t->m_texture ? t->m_texture->GetID() : 0,
 								t->m_TEX0.TBP0);
@@ -914,8 +1015,108 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 	}
 }
 
+bool GSTextureCache::Move(const GIFRegBITBLTBUF& BITBLTBUF, int sx, int sy, int dx, int dy, int w, int h)
+{
+	// Same color format on both sides, the target texels are then copied as they are
+	if(!m_gpu_move || BITBLTBUF.SPSM != BITBLTBUF.DPSM || w <= 0 || h <= 0)
+		return false;
+
+	uint32 psm = BITBLTBUF.SPSM;
+
+	if(psm != PSM_PSMCT32 && psm != PSM_PSMCT24 && psm != PSM_PSMCT16)
+		return false;
+
+	GSVector4i sr(sx, sy, sx + w, sy + h);
+	GSVector4i dr(dx, dy, dx + w, dy + h);
+
+	Target* src = NULL;
+	Target* dst = NULL;
+
+	for(auto t : m_dst[RenderTarget])
+	{
+		if(t->m_TEX0.PSM != psm)
+			continue;
+
+		if(!src && t->m_TEX0.TBP0 == BITBLTBUF.SBP && t->m_TEX0.TBW == BITBLTBUF.SBW)
+			src = t;
+
+		if(!dst && t->m_TEX0.TBP0 == BITBLTBUF.DBP && t->m_TEX0.TBW == BITBLTBUF.DBW)
+			dst = t;
+	}
+
+	// The source must be drawn, the copy be in the destination texture, and an overlapping
+	// copy would depend on DIRX/DIRY
+	if(!src || !dst || !src->m_valid.rintersect(sr).eq(sr))
+		return false;
+
+	if(src == dst && !sr.rintersect(dr).rempty())
+		return false;
+
+	GSTexture* stex = src->m_texture;
+	GSTexture* dtex = dst->m_texture;
+
+	GSVector4 sscale = GSVector4(stex->GetScale()).xyxy();
+	GSVector4 dscale = GSVector4(dtex->GetScale()).xyxy();
+
+	GSVector4i ssr = GSVector4i(GSVector4(sr) * sscale);
+	GSVector4 dsr = GSVector4(dr) * dscale;
+
+	if(dsr.z > dtex->GetWidth() || dsr.w > dtex->GetHeight() || ssr.z > stex->GetWidth() || ssr.w > stex->GetHeight())
+		return false;
+
+	// Pending uploads first, they would otherwise land on top of the copy later
+	src->Update();
+	dst->Update();
+
+	GL_CACHE("TC: Move on GPU %d (0x%x) => %d (0x%x) r(%d,%d,%d,%d) => (%d,%d)",
+		stex->GetID(), src->m_TEX0.TBP0, dtex->GetID(), dst->m_TEX0.TBP0, sr.x, sr.y, sr.z, sr.w, dx, dy);
+
+	// Through a copy of the rect, so that the source and destination may be the same texture
+	GSTexture* tmp = m_renderer->m_dev->CreateRenderTarget(ssr.width(), ssr.height());
+
+	if(!tmp)
+		return false;
+
+	m_renderer->m_dev->CopyRect(stex, tmp, ssr);
+	m_renderer->m_dev->StretchRect(tmp, GSVector4(0, 0, 1, 1), dtex, dsr, ShaderConvert_COPY, false);
+	m_renderer->m_dev->Recycle(tmp);
+
+	// Like a draw: the target now holds the data, local memory is written back when it is read
+	dst->UpdateValidity(dr);
+
+	InvalidateVideoMem(m_renderer->m_mem.GetOffset(BITBLTBUF.DBP, BITBLTBUF.DBW, psm), dr, false);
+
+	return true;
+}
+
 // Goal: retrive the data from the GPU to the GS memory.
 // Called each time you want to read from the GS memory
+// Games often read a target back in several chunks or more than once. If nothing was drawn
+// and nothing was transferred since the last read back covering the area, local memory
+// already holds the target content and the download (a full gpu sync) can be skipped.
+void GSTextureCache::ReadBack(Target* t, const GSVector4i& r)
+{
+	if (t->m_readback_epoch == m_readback_epoch && t->m_readback.rintersect(r).eq(r)) {
+		GL_CACHE("TC: Read Back skipped (0x%x) %d,%d => %d,%d", t->m_TEX0.TBP0, r.x, r.y, r.z, r.w);
+		return;
+	}
+
+	Read(t, r);
+
+	if (!t->m_dirty.empty())
+		return; // nothing was read
+
+	// the write to local memory may overlap what another target read back, only the last one read stays valid
+	bool last = t->m_readback_epoch == m_readback_epoch;
+
+	m_readback_epoch++;
+
+	if (!last || r.rintersect(t->m_readback).eq(t->m_readback))
+		t->m_readback = r;
+
+	t->m_readback_epoch = m_readback_epoch;
+}
+
 void GSTextureCache::InvalidateLocalMem(GSOffset* off, const GSVector4i& r)
 {
 	uint32 bp = off->bp;
@@ -929,7 +1130,7 @@ void GSTextureCache::InvalidateLocalMem(GSOffset* off, const GSVector4i& r)
 			for(auto t : m_dst[DepthStencil]) {
 				if(GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM)) {
 					if (GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM))
-						Read(t, r.rintersect(t->m_valid));
+						ReadBack(t, r.rintersect(t->m_valid));
 				}
 			}
 		}
@@ -957,12 +1158,12 @@ void GSTextureCache::InvalidateLocalMem(GSOffset* off, const GSVector4i& r)
 				// note: r.rintersect breaks Wizardry and Chaos Legion
 				// Read(t, t->m_valid) works in all tested games but is very slow in GUST titles ><
 				if (GSTextureCache::m_disable_partial_invalidation) {
-					Read(t, r.rintersect(t->m_valid));
+					ReadBack(t, r.rintersect(t->m_valid));
 				} else {
 					if (r.x == 0 && r.y == 0) // Full screen read?
-						Read(t, t->m_valid);
+						ReadBack(t, t->m_valid);
 					else // Block level read?
-						Read(t, r.rintersect(t->m_valid));
+						ReadBack(t, r.rintersect(t->m_valid));
 				}
 			}
 		} else {
@@ -1059,7 +1260,8 @@ void GSTextureCache::InvalidateVideoMemSubTarget(GSTextureCache::Target* rt)
 			GL_INS("InvalidateVideoMemSubTarget: rt 0x%x -> 0x%x, sub rt 0x%x -> 0x%x",
 					rt->m_TEX0.TBP0, rt->m_end_block, t->m_TEX0.TBP0, t->m_end_block);
 
-			i = list.erase(i);
+			++i;
+			list.RemoveAt(t);
 			delete t;
 		} else {
 			++i;
@@ -1071,6 +1273,26 @@ void GSTextureCache::IncAge()
 {
 	int maxage = m_src.m_used ? 3 : 30;
 
+	if(m_replacement)
+	{
+		// Upload the replacements decoded since the last frame, a few megabytes at most per
+		// frame, the other pending sources keep their original texture a bit longer
+
+		while(m_replacement->Pop()) {}
+
+		size_t budget = 32 << 20;
+
+		for(auto s : m_src.m_surfaces)
+		{
+			if(s->m_replace_pending && budget > 0 && ReplaceSource(s))
+			{
+				size_t size = (size_t)s->m_texture->GetWidth() * s->m_texture->GetHeight() * 4;
+
+				budget -= std::min(budget, size);
+			}
+		}
+	}
+
 	// You can't use m_map[page] because Source* are duplicated on several pages.
 	for(auto i = m_src.m_surfaces.begin(); i != m_src.m_surfaces.end(); )
 	{
@@ -1115,7 +1337,8 @@ void GSTextureCache::IncAge()
 
 			if(++t->m_age > maxage)
 			{
-				i = list.erase(i);
+				++i;
+				list.RemoveAt(t);
 				GL_CACHE("TC: Remove Target(%s): %d (0x%x) due to age", to_string(type),
 							t->m_texture ? t->m_texture->GetID() : 0,
 							t->m_TEX0.TBP0);
@@ -1126,6 +1349,164 @@ void GSTextureCache::IncAge()
 			}
 		}
 	}
+
+	EnforceBudget();
+}
+
+// Evicts the least recently used surfaces until the cache fits in texture_cache_budget. Only
+// sources not used in the current frame and targets not used in the last two are candidates.
+void GSTextureCache::RecordLookup(Source* src, const GSVector4i& r)
+{
+	src->m_prefetched = false; // used before anything invalidated it
+
+	if(src->m_lookup_frame == m_frame)
+	{
+		Lookup& l = m_lookups[src->m_lookup_index];
+
+		l.r = l.r.runion(r);
+
+		return;
+	}
+
+	src->m_lookup_frame = m_frame;
+	src->m_lookup_index = (uint32)m_lookups.size();
+
+	m_lookups.push_back({src, src->m_id, r});
+}
+
+void GSTextureCache::Prefetch()
+{
+	if(!m_prefetch) return;
+
+	// Games draw with nearly the same textures every frame. Whatever was uploaded over them
+	// since their last use is decoded now, in the order of the last frame, instead of in the
+	// middle of the next one. The decoding is split across the unswizzle_threads if any, the
+	// upload itself needs the device and stays on the GS thread.
+
+	for(const Lookup& l : m_lookups)
+	{
+		Source* s = l.src;
+
+		if(m_src.m_surfaces.find(s) == m_src.m_surfaces.end() || s->m_id != l.id)
+		{
+			continue; // removed by IncAge or an invalidation
+		}
+
+		if(s->m_target || s->m_complete || s->m_shared_texture || s->m_replaced || s->m_replace_pending)
+		{
+			continue;
+		}
+
+		if(s->m_prefetch_misses >= s_max_prefetch_misses)
+		{
+			continue;
+		}
+
+		// A palette texture converted by the cpu needs its clut, which is long gone
+
+		if(GSLocalMemory::m_psm[s->m_TEX0.PSM].pal > 0 && !s->m_palette)
+		{
+			continue;
+		}
+
+		int age = s->m_age;
+
+		if(s->Update(l.r, 0, m_renderer->m_mem.GetOffset(s->m_TEX0.TBP0, s->m_TEX0.TBW, s->m_TEX0.PSM)) > 0)
+		{
+			s->m_prefetched = true;
+		}
+
+		s->m_age = age; // not a use
+	}
+
+	for(auto t : m_dst[RenderTarget])
+	{
+		if(t->m_lookup_frame == m_frame && !t->m_dirty.empty())
+		{
+			int age = t->m_age;
+
+			t->Update();
+
+			t->m_age = age;
+		}
+	}
+
+	m_lookups.clear();
+
+	m_frame++;
+}
+
+void GSTextureCache::EnforceBudget()
+{
+	uint64 src = 0;
+	uint64 dst[2] = {0, 0};
+
+	for(auto s : m_src.m_surfaces) {
+		if(!s->m_shared_texture)
+			src += s->m_texture->GetMemUsage();
+	}
+
+	for(int type = 0; type < 2; type++) {
+		for(auto t : m_dst[type])
+			dst[type] += t->m_texture->GetMemUsage();
+	}
+
+	uint64 total = src + dst[RenderTarget] + dst[DepthStencil];
+
+	if (m_budget > 0 && total > m_budget) {
+		uint32 evicted = 0;
+
+		std::vector<Source*> sources;
+
+		for(auto s : m_src.m_surfaces) {
+			if(!s->m_shared_texture && s->m_age > 0)
+				sources.push_back(s);
+		}
+
+		std::sort(sources.begin(), sources.end(), [](const Source* a, const Source* b) {return a->m_age > b->m_age;});
+
+		for(size_t i = 0; i < sources.size() && total > m_budget; i++, evicted++) {
+			total -= sources[i]->m_texture->GetMemUsage();
+			m_src.RemoveAt(sources[i]);
+		}
+
+		for(int type = 0; type < 2 && total > m_budget; type++) {
+			std::vector<Target*> targets;
+
+			for(auto t : m_dst[type]) {
+				if(t->m_age > 1)
+					targets.push_back(t);
+			}
+
+			std::sort(targets.begin(), targets.end(), [](const Target* a, const Target* b) {return a->m_age > b->m_age;});
+
+			for(size_t i = 0; i < targets.size() && total > m_budget; i++, evicted++) {
+				Target* t = targets[i];
+
+				m_dst[type].RemoveAt(t);
+
+				GL_CACHE("TC: Remove Target(%s): %d (0x%x) due to budget", to_string(type),
+							t->m_texture ? t->m_texture->GetID() : 0,
+							t->m_TEX0.TBP0);
+
+				total -= t->m_texture->GetMemUsage();
+				delete t;
+			}
+		}
+
+		if(evicted > 0) {
+			// Recycled textures are still allocated, don't let the pool keep them
+			m_renderer->m_dev->PurgePool();
+
+			m_renderer->m_perfmon.Put(GSPerfMon::TextureEvict, evicted);
+
+			GL_PERF("TC: %u surfaces evicted, %dMB left (budget %dMB)", evicted, (int)(total >> 20u), (int)(m_budget >> 20u));
+		}
+	}
+
+	std::string s = format("%dMB (src %dMB rt %dMB ds %dMB)", (int)(total >> 20u), (int)(src >> 20u), (int)(dst[RenderTarget] >> 20u), (int)(dst[DepthStencil] >> 20u));
+
+	m_renderer->m_dev->m_osd.Monitor("Texture cache", s.c_str());
 }
 
 //Fixme: Several issues in here. Not handling depth stencil, pitch conversion doesnt work.
@@ -1458,6 +1839,11 @@ GSTextureCache::Source* GSTextureCache::CreateSource(const GIFRegTEX0& TEX0, con
 			if (psm.pal > 0) {
 				AttachPaletteToSource(src, psm.pal, false);
 			}
+
+			// Only fully decoded textures, with paltex the clut is applied by the shader
+			if (m_replacement) {
+				HashSource(src);
+			}
 		}
 	}
 
@@ -1468,6 +1854,66 @@ GSTextureCache::Source* GSTextureCache::CreateSource(const GIFRegTEX0& TEX0, con
 	return src;
 }
 
+// Decodes the whole texture to hash it, for the dumps and the replacements.  Only done when
+// the source is created, it works with whatever the gs memory holds at that point.
+void GSTextureCache::HashSource(Source* src)
+{
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[src->m_TEX0.PSM];
+
+	int tw = 1 << src->m_TEX0.TW;
+	int th = 1 << src->m_TEX0.TH;
+
+	GSVector4i r = GSVector4i(0, 0, tw, th).ralign<Align_Outside>(psm.bs);
+
+	int pitch = r.width() * sizeof(uint32);
+
+	(m_renderer->m_mem.*psm.rtx)(m_renderer->m_context->offset.tex, r, m_temp, pitch, src->m_TEXA);
+
+	uint64 hash = GSTextureReplacement::Hash(m_temp, tw, th, pitch);
+
+	if(m_replacement->IsDumping())
+	{
+		m_replacement->Dump(hash, m_temp, tw, th, pitch);
+	}
+
+	if(m_replacement->IsReplaced(hash))
+	{
+		src->m_replace_hash = hash;
+		src->m_replace_pending = true;
+
+		ReplaceSource(src);
+	}
+}
+
+// Swaps the texture of a pending source for its replacement, if it has been decoded already
+bool GSTextureCache::ReplaceSource(Source* src)
+{
+	std::shared_ptr<GSTextureReplacement::Image> img = m_replacement->Request(src->m_replace_hash);
+
+	if(!img)
+		return false;
+
+	GSTexture* t = m_renderer->m_dev->CreateTexture(img->w, img->h);
+
+	if(t == NULL)
+		return false;
+
+	int tw = 1 << src->m_TEX0.TW;
+	int th = 1 << src->m_TEX0.TH;
+
+	t->Update(GSVector4i(0, 0, img->w, img->h), img->bits.data(), img->w * 4);
+	t->SetScale(GSVector2((float)img->w / tw, (float)img->h / th));
+
+	m_renderer->m_dev->Recycle(src->m_texture);
+
+	src->m_texture = t;
+	src->m_complete = true;
+	src->m_replace_pending = false;
+	src->m_replaced = true;
+
+	return true;
+}
+
 GSTextureCache::Target* GSTextureCache::CreateTarget(const GIFRegTEX0& TEX0, int w, int h, int type)
 {
 	ASSERT(type == RenderTarget || type == DepthStencil);
@@ -1489,13 +1935,30 @@ GSTextureCache::Target* GSTextureCache::CreateTarget(const GIFRegTEX0& TEX0, int
 		t->m_texture = m_renderer->m_dev->CreateSparseDepthStencil(w, h);
 	}
 
-	m_dst[type].push_front(t);
+	m_dst[type].Add(t);
 
 	return t;
 }
 
 void GSTextureCache::PrintMemoryUsage()
 {
+	// Sparse targets only commit the pages that were drawn, report the saving when it moves
+	uint32 committed = 0;
+	uint32 virt      = 0;
+	for(int type = 0; type < 2; type++) {
+		for(auto t : m_dst[type]) {
+			if(t->m_texture && t->m_texture->IsSparse()) {
+				committed += t->m_texture->GetMemUsage();
+				virt      += t->m_texture->GetVirtualMemUsage();
+			}
+		}
+	}
+
+	if(std::abs((int64)committed - (int64)m_sparse_reported) >= (32 << 20)) {
+		printf("GSdx: sparse targets use %uMB of %uMB\n", committed >> 20u, virt >> 20u);
+		m_sparse_reported = committed;
+	}
+
 #ifdef ENABLE_OGL_DEBUG
 	uint32 tex    = 0;
 	uint32 tex_rt = 0;
@@ -1552,6 +2015,7 @@ void GSTextureCache::Surface::UpdateAge()
 
 GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint8* temp, bool dummy_container)
 	: Surface(r, temp)
+	, m_off(NULL)
 	, m_palette_obj(nullptr)
 	, m_palette(nullptr)
 	, m_valid_rect(0, 0)
@@ -1560,6 +2024,15 @@ GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFR
 	, m_spritehack_t(false)
 	, m_p2t(NULL)
 	, m_from_target(NULL)
+	, m_page_hash(NULL)
+	, m_replace_hash(0)
+	, m_replace_pending(false)
+	, m_replaced(false)
+	, m_id(s_source_id++)
+	, m_lookup_frame(~0u)
+	, m_lookup_index(0)
+	, m_prefetched(false)
+	, m_prefetch_misses(0)
 {
 	m_TEX0 = TEX0;
 	m_TEXA = TEXA;
@@ -1595,15 +2068,38 @@ GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFR
 GSTextureCache::Source::~Source()
 {
 	_aligned_free(m_write.rect);
+
+	delete [] m_page_hash;
+}
+
+// Games streaming textures often upload the same data again. Each page is hashed after it is
+// decoded, and an invalidated page that hashes the same is simply made valid again.
+static uint64 HashPage(const uint8* page)
+{
+	const uint64* RESTRICT src = (const uint64*)page;
+
+	uint64 h[4] = {0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull, 0x27d4eb2f165667c5ull};
+
+	for(uint32 i = 0; i < PAGE_SIZE / 8; i += 4)
+	{
+		for(int j = 0; j < 4; j++)
+		{
+			uint64 x = h[j] ^ src[i + j];
+
+			h[j] = ((x << 31) | (x >> 33)) * 0x9e3779b97f4a7c15ull;
+		}
+	}
+
+	return h[0] ^ ((h[1] << 17) | (h[1] >> 47)) ^ ((h[2] << 34) | (h[2] >> 30)) ^ ((h[3] << 51) | (h[3] >> 13));
 }
 
-void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
+uint32 GSTextureCache::Source::Update(const GSVector4i& rect, int layer, const GSOffset* off)
 {
 	Surface::UpdateAge();
 
 	if(layer == 0 && (m_complete || m_target))
 	{
-		return;
+		return 0;
 	}
 
 	const GSVector2i& bs = GSLocalMemory::m_psm[m_TEX0.PSM].bs;
@@ -1618,7 +2114,12 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 		m_complete = true; // lame, but better than nothing
 	}
 
-	const GSOffset* off = m_renderer->m_context->offset.tex;
+	if(off == NULL)
+	{
+		off = m_renderer->m_context->offset.tex;
+	}
+
+	m_off = off;
 
 	uint32 blocks = 0;
 
@@ -1653,6 +2154,26 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 	}
 	else
 	{
+		bool hash = m_page_hash && layer == 0;
+
+		uint32 checked[MAX_PAGES / 32];
+		uint32 decoded[MAX_PAGES / 32];
+
+		if(hash)
+		{
+			if(m_page_hash == NULL)
+			{
+				m_page_hash = new PageHash[MAX_PAGES];
+
+				memset(m_page_hash, 0, sizeof(PageHash) * MAX_PAGES);
+			}
+
+			memset(checked, 0, sizeof(checked));
+			memset(decoded, 0, sizeof(decoded));
+		}
+
+		const uint8* vm = m_renderer->m_mem.m_vm8;
+
 		for(int y = r.top; y < r.bottom; y += bs.y)
 		{
 			uint32 base = off->block.row[y >> 3u];
@@ -1668,6 +2189,22 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 					uint32 row = block >> 5u;
 					uint32 col = 1 << (block & 31u);
 
+					if(hash && m_valid[row] == 0 && m_page_hash[row].valid != 0 && (checked[row >> 5] & (1 << (row & 31))) == 0)
+					{
+						checked[row >> 5] |= 1 << (row & 31);
+
+						if(HashPage(vm + row * PAGE_SIZE) == m_page_hash[row].hash)
+						{
+							m_valid[row] = m_page_hash[row].valid;
+
+							m_renderer->m_perfmon.Put(GSPerfMon::PageHashHit, 1);
+						}
+						else
+						{
+							m_renderer->m_perfmon.Put(GSPerfMon::PageHashMiss, 1);
+						}
+					}
+
 					if((m_valid[row] & col) == 0)
 					{
 						m_valid[row] |= col;
@@ -1675,10 +2212,31 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 						Write(GSVector4i(x, y, x + bs.x, y + bs.y), layer);
 
 						blocks++;
+
+						if(hash)
+						{
+							decoded[row >> 5] |= 1 << (row & 31);
+						}
 					}
 				}
 			}
 		}
+
+		if(hash && blocks > 0)
+		{
+			for(uint32 i = 0; i < countof(decoded); i++)
+			{
+				for(unsigned long mask = decoded[i], j; mask != 0; mask &= mask - 1)
+				{
+					_BitScanForward(&j, mask);
+
+					uint32 row = (i << 5) + j;
+
+					m_page_hash[row].hash = HashPage(vm + row * PAGE_SIZE);
+					m_page_hash[row].valid = m_valid[row];
+				}
+			}
+		}
 	}
 
 	if(blocks > 0)
@@ -1687,6 +2245,8 @@ void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
 
 		Flush(m_write.count, layer);
 	}
+
+	return blocks;
 }
 
 void GSTextureCache::Source::UpdateLayer(const GIFRegTEX0& TEX0, const GSVector4i& rect, int layer)
@@ -1697,6 +2257,9 @@ void GSTextureCache::Source::UpdateLayer(const GIFRegTEX0& TEX0, const GSVector4
 	if (m_target) // Yeah keep dreaming
 		return;
 
+	if (m_replaced) // the levels were generated from the replacement
+		return;
+
 	if (TEX0 == m_layer_TEX0[layer])
 		return;
 
@@ -1761,7 +2324,7 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 	GSLocalMemory& mem = m_renderer->m_mem;
 
-	const GSOffset* off = m_renderer->m_context->offset.tex;
+	const GSOffset* off = m_off;
 
 	GSLocalMemory::readTexture rtx = psm.rtx;
 
@@ -1773,13 +2336,23 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 	uint8* buff = m_temp;
 
+	GSPerfMonAutoTimer pmat(&m_renderer->m_perfmon, GSPerfMon::UnswizzleTime);
+
+	auto read = [&](const GSVector4i& r, uint8* dst, int dstpitch)
+	{
+		if(m_unswizzler)
+			m_unswizzler->Read(mem, rtx, off, r, dst, dstpitch, m_TEXA, psm.bs.y);
+		else
+			(mem.*rtx)(off, r, dst, dstpitch, m_TEXA);
+	};
+
 	for(uint32 i = 0; i < count; i++)
 	{
 		GSVector4i r = m_write.rect[i];
 
 		if((r > tr).mask() & 0xff00)
 		{
-			(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+			read(r, buff, pitch);
 
 			m_texture->Update(r.rintersect(tr), buff, pitch, layer);
 		}
@@ -1789,13 +2362,13 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 			if(m_texture->Map(m, &r, layer))
 			{
-				(mem.*rtx)(off, r, m.bits, m.pitch, m_TEXA);
+				read(r, m.bits, m.pitch);
 
 				m_texture->Unmap();
 			}
 			else
 			{
-				(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+				read(r, buff, pitch);
 
 				m_texture->Update(r, buff, pitch, layer);
 			}
@@ -1811,6 +2384,68 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 	m_write.count -= count;
 }
 
+// GSTextureCache::Unswizzler
+
+GSTextureCache::Unswizzler::Unswizzler(int threads)
+{
+	for(int i = 0; i < threads; i++)
+	{
+		m_workers.push_back(std::unique_ptr<Worker>(new Worker(
+			[](Job& job) { (job.mem->*job.rtx)(job.off, job.r, job.dst, job.pitch, job.TEXA); })));
+	}
+}
+
+void GSTextureCache::Unswizzler::Read(GSLocalMemory& mem, GSLocalMemory::readTexture rtx, const GSOffset* off, const GSVector4i& r, uint8* dst, int pitch, const GIFRegTEXA& TEXA, int bh)
+{
+	// Small rects aren't worth waking the workers up for
+	int rows = r.height() / bh;
+	int bands = std::min<int>(rows, m_workers.size() + 1);
+
+	if(bands <= 1 || r.width() * r.height() < 128 * 128)
+	{
+		(mem.*rtx)(off, r, dst, pitch, TEXA);
+
+		return;
+	}
+
+	// The GS thread reads the first band itself while the workers do the others
+
+	GSVector4i first = r;
+
+	for(int i = 0, top = r.top; i < bands; i++)
+	{
+		GSVector4i band(r.left, top, r.right, r.top + rows * (i + 1) / bands * bh);
+
+		if(i == 0)
+		{
+			first = band;
+		}
+		else
+		{
+			Job job;
+
+			job.r = band;
+			job.mem = &mem;
+			job.rtx = rtx;
+			job.off = off;
+			job.dst = dst + (band.top - r.top) * pitch;
+			job.pitch = pitch;
+			job.TEXA = TEXA;
+
+			m_workers[i - 1]->Push(job);
+		}
+
+		top = band.bottom;
+	}
+
+	(mem.*rtx)(off, first, dst, pitch, TEXA);
+
+	for(int i = 0; i < bands - 1; i++)
+	{
+		m_workers[i]->Wait();
+	}
+}
+
 bool GSTextureCache::Source::ClutMatch(PaletteKey palette_key) {
 	return PaletteKeyEqual()(palette_key, m_palette_obj->GetPaletteKey());
 }
@@ -1823,12 +2458,20 @@ GSTextureCache::Target::Target(GSRenderer* r, const GIFRegTEX0& TEX0, uint8* tem
 	, m_used(false)
 	, m_depth_supported(depth_supported)
 	, m_end_block(0)
+	, m_readback_epoch(0)
+	, m_lookup_frame(~0u)
+	, m_owner(NULL)
+	, m_list_it(0)
+	, m_mru(0)
+	, m_first_page(1)
+	, m_last_page(0)
 {
 	m_TEX0 = TEX0;
 	m_32_bits_fmt |= (GSLocalMemory::m_psm[TEX0.PSM].trbpp != 16);
 	m_dirty_alpha = GSLocalMemory::m_psm[TEX0.PSM].trbpp != 24;
 
 	m_valid = GSVector4i::zero();
+	m_readback = GSVector4i::zero();
 }
 
 void GSTextureCache::Target::Update()
@@ -1932,7 +2575,14 @@ void GSTextureCache::Target::UpdateValidity(const GSVector4i& rect)
 	if (m_TEX0.PSM == PSM_PSMCT16)
 		nb_block >>= 1;
 
-	m_end_block = m_TEX0.TBP0 + nb_block;
+	uint32 end_block = m_TEX0.TBP0 + nb_block;
+
+	if(m_end_block != end_block)
+	{
+		m_end_block = end_block;
+
+		if(m_owner) m_owner->UpdatePages(this);
+	}
 
 	// GL_CACHE("UpdateValidity (0x%x->0x%x) from R:%d,%d Valid: %d,%d", m_TEX0.TBP0, m_end_block, rect.z, rect.w, m_valid.z, m_valid.w);
 }
@@ -1944,6 +2594,86 @@ bool GSTextureCache::Target::Inside(uint32 bp, uint32 bw, uint32 psm, const GSVe
 	return bp > m_TEX0.TBP0 && block < m_end_block;
 }
 
+// GSTextureCache::TargetMap
+
+void GSTextureCache::TargetMap::Add(Target* t)
+{
+	t->m_owner = this;
+	t->m_list_it = m_list.InsertFront(t);
+	t->m_mru = ++m_mru;
+	t->m_bp_it = m_bp.insert(std::make_pair((uint32)t->m_TEX0.TBP0, t));
+
+	UpdatePages(t);
+}
+
+void GSTextureCache::TargetMap::MoveFront(Target* t)
+{
+	m_list.MoveFront(t->m_list_it);
+
+	t->m_mru = ++m_mru;
+}
+
+void GSTextureCache::TargetMap::RemoveAt(Target* t)
+{
+	m_list.EraseIndex(t->m_list_it);
+	m_bp.erase(t->m_bp_it);
+
+	for(uint32 page = t->m_first_page; page <= t->m_last_page; page++)
+	{
+		m_map[page].EraseIndex(t->m_erase_it[page]);
+	}
+
+	t->m_first_page = 1;
+	t->m_last_page = 0;
+	t->m_owner = NULL;
+}
+
+void GSTextureCache::TargetMap::RemoveAll()
+{
+	for(auto t : m_list) delete t;
+
+	m_list.clear();
+	m_bp.clear();
+
+	for(size_t i = 0; i < countof(m_map); i++)
+	{
+		m_map[i].clear();
+	}
+}
+
+void GSTextureCache::TargetMap::UpdatePages(Target* t)
+{
+	// from the page of TBP0 (even if nothing is valid yet) to the one of the last block
+
+	uint32 bp = t->m_TEX0.TBP0;
+	uint32 first = bp >> 5;
+	uint32 last = std::min<uint32>((std::max<uint32>(t->m_end_block, bp + 1) - 1) >> 5, MAX_PAGES - 1);
+
+	if(first == t->m_first_page && last == t->m_last_page)
+	{
+		return;
+	}
+
+	for(uint32 page = t->m_first_page; page <= t->m_last_page; page++)
+	{
+		if(page < first || page > last)
+		{
+			m_map[page].EraseIndex(t->m_erase_it[page]);
+		}
+	}
+
+	for(uint32 page = first; page <= last; page++)
+	{
+		if(page < t->m_first_page || page > t->m_last_page)
+		{
+			t->m_erase_it[page] = m_map[page].InsertFront(t);
+		}
+	}
+
+	t->m_first_page = first;
+	t->m_last_page = last;
+}
+
 // GSTextureCache::SourceMap
 
 void GSTextureCache::SourceMap::Add(Source* s, const GIFRegTEX0& TEX0, GSOffset* off)
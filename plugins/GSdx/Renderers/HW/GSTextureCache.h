@@ -24,6 +24,8 @@
 #include "Renderers/Common/GSRenderer.h"
 #include "Renderers/Common/GSFastList.h"
 #include "Renderers/Common/GSDirtyRect.h"
+#include "GSThread_CXX11.h"
+#include "GSTextureReplacement.h"
 
 class GSTextureCache
 {
@@ -93,9 +95,34 @@ public:
 		bool operator()(const PaletteKey &lhs, const PaletteKey &rhs) const;
 	};
 
+	// Splits the texture reads of big dirty rects by block rows across worker threads
+	class Unswizzler
+	{
+		struct Job
+		{
+			GSVector4i r;
+			GSLocalMemory* mem;
+			GSLocalMemory::readTexture rtx;
+			const GSOffset* off;
+			uint8* dst;
+			int pitch;
+			GIFRegTEXA TEXA;
+		};
+
+		using Worker = GSJobQueue<Job, 16>;
+
+		std::vector<std::unique_ptr<Worker>> m_workers;
+
+	public:
+		Unswizzler(int threads);
+
+		void Read(GSLocalMemory& mem, GSLocalMemory::readTexture rtx, const GSOffset* off, const GSVector4i& r, uint8* dst, int pitch, const GIFRegTEXA& TEXA, int bh);
+	};
+
 	class Source : public Surface
 	{
 		struct {GSVector4i* rect; uint32 count;} m_write;
+		const GSOffset* m_off; // of the Update in progress
 
 		void Write(const GSVector4i& r, int layer);
 		void Flush(uint32 count, int layer);
@@ -118,17 +145,33 @@ public:
 		// Keep a GSTextureCache::SourceMap::m_map iterator to allow fast erase
 		std::array<uint16, MAX_PAGES> m_erase_it;
 		uint32* m_pages_as_bit;
+		// texture_page_hash: content of each page when it was last decoded, with the m_valid bits it had
+		struct PageHash {uint64 hash; uint32 valid;}* m_page_hash;
+		// texture_replace: content hash, m_texture is the replacement once m_replaced is set
+		uint64 m_replace_hash;
+		bool m_replace_pending;
+		bool m_replaced;
+		// texture_prefetch: m_id tells a new source from a deleted one at the same address,
+		// a prefetch that is invalidated before any lookup is a miss
+		uint32 m_id;
+		uint32 m_lookup_frame;
+		uint32 m_lookup_index;
+		bool m_prefetched;
+		uint8 m_prefetch_misses;
 
 	public:
 		Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint8* temp, bool dummy_container = false);
 		virtual ~Source();
 
-		void Update(const GSVector4i& rect, int layer = 0);
+		// off: where the texture is in local memory, the current context's texture by default. Returns the decoded blocks.
+		uint32 Update(const GSVector4i& rect, int layer = 0, const GSOffset* off = NULL);
 		void UpdateLayer(const GIFRegTEX0& TEX0, const GSVector4i& rect, int layer = 0);
 
 		bool ClutMatch(PaletteKey palette_key);
 	};
 
+	class TargetMap;
+
 	class Target : public Surface
 	{
 	public:
@@ -139,6 +182,17 @@ public:
 		bool m_depth_supported;
 		bool m_dirty_alpha;
 		uint32 m_end_block; // Hint of the target area
+		GSVector4i m_readback; // area last written back to local memory, valid while m_readback_epoch matches
+		uint32 m_readback_epoch;
+		uint32 m_lookup_frame; // texture_prefetch
+
+		// Keep the GSTextureCache::TargetMap positions to allow fast erase
+		TargetMap* m_owner;
+		uint16 m_list_it;
+		uint32 m_mru; // TargetMap::m_mru when last moved to the front of the list
+		std::multimap<uint32, Target*>::iterator m_bp_it;
+		uint32 m_first_page, m_last_page; // pages indexed in TargetMap::m_map
+		std::array<uint16, MAX_PAGES> m_erase_it;
 
 	public:
 		Target(GSRenderer* r, const GIFRegTEX0& TEX0, uint8* temp, bool depth_supported);
@@ -185,30 +239,76 @@ public:
 		void RemoveAt(Source* s);
 	};
 
+	// The targets of a type, most recently used first, indexed by TBP0 and by the pages from
+	// TBP0 to m_end_block so that LookupTarget and InvalidateVideoMem don't walk the whole list
+	class TargetMap
+	{
+	public:
+		FastList<Target*> m_list;
+		std::multimap<uint32, Target*> m_bp;
+		std::array<FastList<Target*>, MAX_PAGES> m_map;
+		uint32 m_mru;
+
+		TargetMap() : m_mru(0) {}
+
+		FastListIterator<Target*> begin() const {return m_list.begin();}
+		FastListIterator<Target*> end() const {return m_list.end();}
+		uint16 size() const {return m_list.size();}
+
+		void Add(Target* t);
+		void MoveFront(Target* t);
+		void RemoveAt(Target* t); // doesn't delete it
+		void RemoveAll(); // deletes them
+		void UpdatePages(Target* t); // after m_end_block changed
+	};
+
 protected:
 	GSRenderer* m_renderer;
 	PaletteMap m_palette_map;
 	SourceMap m_src;
-	FastList<Target*> m_dst[2];
+	TargetMap m_dst[2];
 	bool m_paltex;
+	bool m_gpu_move; // texture_gpu_move
 	int m_spritehack;
 	bool m_preload_frame;
 	uint8* m_temp;
+	uint32 m_readback_epoch; // bumped by anything that may change gs memory or a target
+	uint64 m_budget; // texture_cache_budget, 0 = unlimited
 	bool m_can_convert_depth;
 	bool m_cpu_fb_conversion;
 	CRCHackLevel m_crc_hack_level;
 	static bool m_disable_partial_invalidation;
 	bool m_texture_inside_rt;
 	static bool m_wrap_gs_mem;
+	static bool m_page_hash;
+	static std::unique_ptr<Unswizzler> m_unswizzler;
+	std::unique_ptr<GSTextureReplacement> m_replacement; // texture_replace/texture_dump
+
+	// texture_prefetch: the sources looked up during the frame, in order, and their texel rects
+	struct Lookup {Source* src; uint32 id; GSVector4i r;};
+	bool m_prefetch;
+	uint32 m_frame;
+	std::vector<Lookup> m_lookups;
+
+	uint32 m_sparse_reported; // committed bytes of the sparse targets when last printed
+
+	void RecordLookup(Source* src, const GSVector4i& r);
+
+	void HashSource(Source* src);
+	bool ReplaceSource(Source* src);
 
 	virtual Source* CreateSource(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, Target* t = NULL, bool half_right = false, int x_offset = 0, int y_offset = 0);
 	virtual Target* CreateTarget(const GIFRegTEX0& TEX0, int w, int h, int type);
 
 	virtual int Get8bitFormat() = 0;
 
+	void ReadBack(Target* t, const GSVector4i& r);
+
 	// TODO: virtual void Write(Source* s, const GSVector4i& r) = 0;
 	// TODO: virtual void Write(Target* t, const GSVector4i& r) = 0;
 
+	std::vector<Target*> m_invalidate_targets; // InvalidateVideoMem
+
 public:
 	GSTextureCache(GSRenderer* r);
 	virtual ~GSTextureCache();
@@ -228,7 +328,16 @@ public:
 	void InvalidateVideoMem(GSOffset* off, const GSVector4i& r, bool target = true);
 	void InvalidateLocalMem(GSOffset* off, const GSVector4i& r);
 
+	// Local to local transfer between render targets, done on the gpu.  False if the data
+	// isn't all in targets (or the copy can't be done that way), local memory is then used.
+	bool Move(const GIFRegBITBLTBUF& BITBLTBUF, int sx, int sy, int dx, int dy, int w, int h);
+
 	void IncAge();
+	void EnforceBudget();
+
+	// At vsync: brings the sources and render targets used in the last frame up to date with
+	// local memory now, so that the draws of the next one find them ready.
+	void Prefetch();
 	bool UserHacks_HalfPixelOffset;
 	void ScaleTexture(GSTexture* texture);
 
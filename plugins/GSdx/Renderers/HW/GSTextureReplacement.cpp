@@ -0,0 +1,224 @@
+/*
+ *	Copyright (C) 2007-2016 PCSX2 Dev Team
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GSTextureReplacement.h"
+#include "GSUtil.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+
+static const size_t s_cache_max = 256 << 20;
+
+GSTextureReplacement::GSTextureReplacement(const std::string& replace_dir, const std::string& dump_dir, int threads)
+	: m_next_loader(0)
+	, m_compression(0)
+	, m_cache_bytes(0)
+{
+	if(!replace_dir.empty())
+	{
+		BuildIndex(replace_dir);
+
+		printf("GSdx: %d replacement textures in %s\n", (int)m_index.size(), replace_dir.c_str());
+
+		for(int i = 0; i < std::max(threads, 1) && !m_index.empty(); i++)
+		{
+			m_loaders.push_back(std::unique_ptr<Loader>(new Loader([this](uint64& hash) {Load(hash);})));
+		}
+	}
+
+	if(!dump_dir.empty())
+	{
+		GSmkdir(dump_dir.c_str());
+
+		m_dump_dir = dump_dir + DIRECTORY_SEPARATOR;
+		m_compression = theApp.GetConfigI("png_compression_level");
+		m_dumper = std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process));
+	}
+}
+
+GSTextureReplacement::~GSTextureReplacement()
+{
+	// Finish the queued work before the members it uses go away
+
+	m_loaders.clear();
+	m_dumper = nullptr;
+}
+
+void GSTextureReplacement::BuildIndex(const std::string& dir)
+{
+	auto add = [&](const char* name)
+	{
+		// 16 hex digits, then ".png" or "_full.png"
+
+		char* end = NULL;
+		uint64 hash = strtoull(name, &end, 16);
+
+		if(end != name + 16 || (strcmp(end, ".png") != 0 && strcmp(end, "_full.png") != 0))
+			return;
+
+		m_index[hash] = dir + DIRECTORY_SEPARATOR + name;
+	};
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA fd;
+	HANDLE h = FindFirstFileA((dir + "\\*.png").c_str(), &fd);
+
+	if(h != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			add(fd.cFileName);
+		}
+		while(FindNextFileA(h, &fd));
+
+		FindClose(h);
+	}
+#else
+	if(DIR* d = opendir(dir.c_str()))
+	{
+		while(struct dirent* e = readdir(d))
+		{
+			add(e->d_name);
+		}
+
+		closedir(d);
+	}
+#endif
+}
+
+void GSTextureReplacement::Load(uint64 hash)
+{
+	// Worker thread, m_index is not modified anymore
+
+	std::shared_ptr<Image> img = std::make_shared<Image>();
+
+	img->hash = hash;
+
+	if(!GSPng::Load(m_index.find(hash)->second, img->bits, img->w, img->h))
+		return; // stays in m_requested, never retried
+
+	std::lock_guard<std::mutex> l(m_lock);
+
+	m_ready.push_back(img);
+}
+
+uint64 GSTextureReplacement::Hash(const uint8* bits, int w, int h, int pitch)
+{
+	// Same mix as the texture cache page hash, row by row
+
+	uint64 h0 = 0x9e3779b97f4a7c15ull ^ ((uint64)w << 32 | h);
+	uint64 h1 = 0xc2b2ae3d27d4eb4full;
+
+	for(int y = 0; y < h; y++, bits += pitch)
+	{
+		const uint32* RESTRICT row = (const uint32*)bits;
+
+		int x = 0;
+
+		for(; x + 2 <= w; x += 2)
+		{
+			uint64 a = h0 ^ row[x];
+			uint64 b = h1 ^ row[x + 1];
+
+			h0 = ((a << 31) | (a >> 33)) * 0x9e3779b97f4a7c15ull;
+			h1 = ((b << 31) | (b >> 33)) * 0x9e3779b97f4a7c15ull;
+		}
+
+		if(x < w)
+		{
+			uint64 a = h0 ^ row[x];
+
+			h0 = ((a << 31) | (a >> 33)) * 0x9e3779b97f4a7c15ull;
+		}
+	}
+
+	return h0 ^ ((h1 << 29) | (h1 >> 35));
+}
+
+std::shared_ptr<GSTextureReplacement::Image> GSTextureReplacement::Request(uint64 hash)
+{
+	auto i = m_cache.find(hash);
+
+	if(i != m_cache.end())
+		return i->second;
+
+	if(m_requested.insert(hash).second)
+	{
+		// A full queue must not stall the GS thread, the source will ask again
+
+		if(!m_loaders[m_next_loader++ % m_loaders.size()]->TryPush(hash))
+		{
+			m_requested.erase(hash);
+		}
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<GSTextureReplacement::Image> GSTextureReplacement::Pop()
+{
+	std::shared_ptr<Image> img;
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+
+		if(m_ready.empty())
+			return nullptr;
+
+		img = m_ready.front();
+		m_ready.pop_front();
+	}
+
+	m_cache[img->hash] = img;
+	m_cache_order.push_back(img->hash);
+	m_cache_bytes += img->bits.size();
+
+	while(m_cache_bytes > s_cache_max && m_cache_order.size() > 1)
+	{
+		uint64 hash = m_cache_order.front();
+		m_cache_order.pop_front();
+
+		auto i = m_cache.find(hash);
+
+		m_cache_bytes -= i->second->bits.size();
+		m_cache.erase(i);
+
+		m_requested.erase(hash); // loaded again from disk next time
+	}
+
+	return img;
+}
+
+void GSTextureReplacement::Dump(uint64 hash, const uint8* bits, int w, int h, int pitch)
+{
+	if(m_dumped.find(hash) != m_dumped.end())
+		return;
+
+	std::string file = m_dump_dir + format("%016llx.png", (unsigned long long)hash);
+
+	// Don't wait for the writer, the texture is simply dumped again when it is created next time
+
+	if(m_dumper->TryPush(std::make_shared<GSPng::Transaction>(GSPng::RGBA_PNG, file, bits, w, h, pitch, m_compression)))
+	{
+		m_dumped.insert(hash);
+	}
+}
@@ -0,0 +1,83 @@
+/*
+ *	Copyright (C) 2007-2016 PCSX2 Dev Team
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "GSThread_CXX11.h"
+#include "GSPng.h"
+
+// Texture dumping and replacement (HD texture packs).  A texture is identified by the hash of
+// its decoded content, which also covers the clut and TEXA.  The replacements are the
+// "<hash>.png" (or dumped "<hash>_full.png") files of the replacement directory, indexed once
+// when the renderer starts.  Requested files are decoded by worker threads and then wait in a
+// queue for the GS thread to upload them (Pop), the original texture is used in the meantime.
+class GSTextureReplacement
+{
+public:
+	struct Image
+	{
+		uint64 hash;
+		int w, h;
+		std::vector<uint8> bits; // RGBA8, pitch w * 4
+	};
+
+private:
+	using Loader = GSJobQueue<uint64, 256>;
+
+	std::string m_dump_dir; // empty if dumping is disabled
+	std::unordered_map<uint64, std::string> m_index; // read only once built
+
+	std::vector<std::unique_ptr<Loader>> m_loaders;
+	size_t m_next_loader;
+	std::unique_ptr<GSPng::Worker> m_dumper;
+	int m_compression;
+
+	std::unordered_set<uint64> m_requested; // GS thread, loading or in m_cache
+	std::unordered_set<uint64> m_dumped; // GS thread
+
+	std::mutex m_lock;
+	std::deque<std::shared_ptr<Image>> m_ready; // m_lock, decoded and not uploaded yet
+
+	// Decoded images are kept around since sources often come back with the same content
+	std::unordered_map<uint64, std::shared_ptr<Image>> m_cache; // GS thread
+	std::deque<uint64> m_cache_order;
+	size_t m_cache_bytes;
+
+	void BuildIndex(const std::string& dir);
+	void Load(uint64 hash);
+
+public:
+	GSTextureReplacement(const std::string& replace_dir, const std::string& dump_dir, int threads);
+	~GSTextureReplacement();
+
+	static uint64 Hash(const uint8* bits, int w, int h, int pitch);
+
+	bool IsReplaced(uint64 hash) const {return m_index.find(hash) != m_index.end();}
+	bool IsDumping() const {return !m_dump_dir.empty();}
+
+	// The decoded replacement if it is already there, else queues its loading (once) and returns null
+	std::shared_ptr<Image> Request(uint64 hash);
+
+	// Next decoded replacement, null if none
+	std::shared_ptr<Image> Pop();
+
+	// Writes the texture in the background, once per hash
+	void Dump(uint64 hash, const uint8* bits, int w, int h, int pitch);
+};
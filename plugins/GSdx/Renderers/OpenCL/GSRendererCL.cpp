@@ -470,6 +470,8 @@ void GSRendererCL::Draw()
 					m_rw_pages[1][i] |= m_tmp_pages[i];
 
 					dst_pages[i] |= m_tmp_pages[i];
+
+					((GSVector4i*)m_mem.m_dirty_pages)[i] |= m_tmp_pages[i];
 				}
 			}
 		}
@@ -495,6 +497,8 @@ void GSRendererCL::Draw()
 					m_rw_pages[1][i] |= m_tmp_pages[i];
 
 					dst_pages[i] |= m_tmp_pages[i];
+
+					((GSVector4i*)m_mem.m_dirty_pages)[i] |= m_tmp_pages[i];
 				}
 			}
 		}
@@ -257,6 +257,7 @@ protected:
 
 	void Draw();
 	void Sync(int reason);
+	void SyncLocalMem() {Sync(-1);}
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
 
@@ -151,6 +151,8 @@ namespace GLLoader {
 	bool found_geometry_shader = true; // we require GL3.3 so geometry must be supported by default
 	bool found_GL_ARB_clear_texture = false;
 	bool found_GL_ARB_get_texture_sub_image = false; // Not yet used
+	bool found_GL_ARB_parallel_shader_compile = false;
+	bool found_GL_ARB_bindless_texture = false;
 	// DX11 GPU
 	bool found_GL_ARB_gpu_shader5 = false; // Require IvyBridge
 	bool found_GL_ARB_shader_image_load_store = false; // Intel IB. Nvidia/AMD miss Mesa implementation.
@@ -265,9 +267,10 @@ namespace GLLoader {
 			//fprintf(stderr, "DEBUG ext: %s\n", ext.c_str());
 		}
 
-		// Disable sparse by default (Note AMD is completely broken).
+		// Disable sparse by default except on Nvidia (Note AMD is completely broken).
 		// AMD issue tracker https://community.amd.com/thread/237558
-		if (true) {
+		// The override_GL_ARB_sparse_texture option still forces it either way.
+		if (!vendor_id_nvidia) {
 			GLExtension::Set("GL_ARB_sparse_texture", false);
 		}
 
@@ -313,6 +316,10 @@ namespace GLLoader {
 			// Rendering might be corrupted but it could be good enough for test/virtual machine.
 			optional("GL_ARB_texture_barrier");
 			found_GL_ARB_get_texture_sub_image = optional("GL_ARB_get_texture_sub_image");
+			// Bonus: let the driver compile shaders on its own threads
+			found_GL_ARB_parallel_shader_compile = optional("GL_ARB_parallel_shader_compile");
+			// Bonus: pass the HW textures as handles instead of binding them (opt-in, bindless_texture)
+			found_GL_ARB_bindless_texture = optional("GL_ARB_bindless_texture");
 		}
 
 		if (vendor_id_amd) {
@@ -65,7 +65,7 @@ typedef void (APIENTRYP PFNGLTEXTUREPAGECOMMITMENTEXTPROC) (GLuint texture, GLin
 // **********************  End of the extra header ******************* //
 
 // #define ENABLE_GL_ARB_ES3_2_compatibility 1
-// #define ENABLE_GL_ARB_bindless_texture 1
+#define ENABLE_GL_ARB_bindless_texture 1
 // #define ENABLE_GL_ARB_cl_event 1
 // #define ENABLE_GL_ARB_compute_variable_group_size 1
 // #define ENABLE_GL_ARB_debug_output 1
@@ -76,7 +76,7 @@ typedef void (APIENTRYP PFNGLTEXTUREPAGECOMMITMENTEXTPROC) (GLuint texture, GLin
 // #define ENABLE_GL_ARB_gpu_shader_int64 1
 // #define ENABLE_GL_ARB_indirect_parameters 1
 // #define ENABLE_GL_ARB_instanced_arrays 1
-// #define ENABLE_GL_ARB_parallel_shader_compile 1
+#define ENABLE_GL_ARB_parallel_shader_compile 1
 // #define ENABLE_GL_ARB_robustness 1
 // #define ENABLE_GL_ARB_sample_locations 1
 // #define ENABLE_GL_ARB_sample_shading 1
@@ -142,6 +142,8 @@ namespace GLLoader {
 	extern bool found_GL_ARB_gpu_shader5;
 	extern bool found_GL_ARB_shader_image_load_store;
 	extern bool found_GL_ARB_clear_texture;
+	extern bool found_GL_ARB_parallel_shader_compile;
+	extern bool found_GL_ARB_bindless_texture;
 
 	extern bool found_compatible_GL_ARB_sparse_texture2;
 	extern bool found_compatible_sparse_depth;
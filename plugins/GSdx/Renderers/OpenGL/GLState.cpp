@@ -59,6 +59,9 @@ namespace GLState {
 
 	int64 available_vram;
 
+	uint64 state_call[CALL_COUNT];
+	uint64 draw_call;
+
 	void Clear() {
 		fbo = 0;
 		viewport = GSVector2i(0, 0);
@@ -99,5 +102,9 @@ namespace GLState {
 		// Set a max vram limit for texture allocation
 		// (256MB are reserved for PBO/IBO/VBO/UBO buffers)
 		available_vram = (4096u - 256u) * 1024u * 1024u;
+
+		for (size_t i = 0; i < countof(state_call); i++)
+			state_call[i] = 0;
+		draw_call = 0;
 	}
 }
@@ -61,5 +61,10 @@ namespace GLState {
 
 	extern int64 available_vram;
 
+	// Profiler: the GL state calls that got through the filtering above, by kind
+	enum {CALL_FBO, CALL_VIEWPORT, CALL_BLEND, CALL_DEPTH_STENCIL, CALL_SAMPLER, CALL_TEXTURE, CALL_UBO, CALL_PROGRAM, CALL_COUNT};
+	extern uint64 state_call[CALL_COUNT];
+	extern uint64 draw_call;
+
 	extern void Clear();
 }
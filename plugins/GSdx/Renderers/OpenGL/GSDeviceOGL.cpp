@@ -41,6 +41,15 @@ uint64 g_vertex_upload_byte = 0;
 uint64 g_uniform_upload_byte = 0;
 #endif
 
+// Always counted, reported with the frame times by GenerateProfilerData
+uint64 g_texture_upload_call = 0;
+uint64 g_texture_upload_byte = 0;
+uint64 g_geometry_upload_call = 0;
+uint64 g_geometry_upload_vertex_byte = 0;
+uint64 g_geometry_upload_index_byte = 0;
+
+static const uint64 g_draw_profile_other  = UINT64_MAX;
+
 static const uint32 g_merge_cb_index      = 10;
 static const uint32 g_interlace_cb_index  = 11;
 static const uint32 g_fx_cb_index         = 14;
@@ -58,6 +67,8 @@ GSDeviceOGL::GSDeviceOGL()
 	, m_fbo(0)
 	, m_fbo_read(0)
 	, m_va(NULL)
+	, m_present_thread(NULL)
+	, m_present_rt(NULL)
 	, m_apitrace(0)
 	, m_palette_ss(0)
 	, m_vs_cb(NULL)
@@ -73,6 +84,10 @@ GSDeviceOGL::GSDeviceOGL()
 	memset(&m_shadeboost, 0, sizeof(m_shadeboost));
 	memset(&m_om_dss, 0, sizeof(m_om_dss));
 	memset(&m_profiler, 0 , sizeof(m_profiler));
+	m_draw_profiler.enabled = false;
+	m_draw_profiler.ps = 0;
+	m_draw_profiler.current = 0;
+	m_draw_profiler.rt = 0;
 	GLState::Clear();
 
 	m_mipmap = theApp.GetConfigI("mipmap");
@@ -92,6 +107,8 @@ GSDeviceOGL::GSDeviceOGL()
 	m_debug_gl_call =  theApp.GetConfigB("debug_opengl");
 
 	m_disable_hw_gl_draw = theApp.GetConfigB("disable_hw_gl_draw");
+
+	m_bindless = false; // Create knows if the driver supports it
 }
 
 GSDeviceOGL::~GSDeviceOGL()
@@ -107,6 +124,9 @@ GSDeviceOGL::~GSDeviceOGL()
 
 	GL_PUSH("GSDeviceOGL destructor");
 
+	// Before anything it could still be reading
+	delete m_present_thread;
+
 	// Clean vertex buffer state
 	delete m_va;
 
@@ -152,8 +172,82 @@ GSDeviceOGL::~GSDeviceOGL()
 	m_shader = NULL;
 }
 
+void GSDeviceOGL::ResolveDrawTiming(bool wait)
+{
+	// Queries complete in submission order, stop at the first one that isn't ready
+	while (!m_draw_profiler.pending.empty()) {
+		DrawTiming& dt = m_draw_profiler.pending.front();
+
+		if (!wait) {
+			GLuint available = 0;
+			glGetQueryObjectuiv(dt.query[1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				break;
+		}
+
+		GLuint64 start;
+		GLuint64 end;
+		glGetQueryObjectui64v(dt.query[0], GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(dt.query[1], GL_QUERY_RESULT, &end);
+
+		DrawCost& ps = m_draw_profiler.per_ps[dt.ps];
+		ps.draws++;
+		ps.ns += end - start;
+
+		DrawCost& rt = m_draw_profiler.per_rt[dt.rt];
+		rt.draws++;
+		rt.ns += end - start;
+
+		m_draw_profiler.free_query.push_back(dt.query[0]);
+		m_draw_profiler.free_query.push_back(dt.query[1]);
+		m_draw_profiler.pending.pop_front();
+	}
+}
+
+void GSDeviceOGL::WriteDrawProfile()
+{
+	ResolveDrawTiming(true);
+
+	glDeleteQueries(m_draw_profiler.free_query.size(), m_draw_profiler.free_query.data());
+	m_draw_profiler.free_query.clear();
+	m_draw_profiler.enabled = false;
+
+	std::vector<std::pair<uint64, DrawCost>> ps(m_draw_profiler.per_ps.begin(), m_draw_profiler.per_ps.end());
+	std::sort(ps.begin(), ps.end(), [](const std::pair<uint64, DrawCost>& a, const std::pair<uint64, DrawCost>& b) { return a.second.ns > b.second.ns; });
+
+	fprintf(stderr, "\nGPU draw cost by pixel shader (%zu shaders):\n", ps.size());
+	for (size_t i = 0; i < std::min<size_t>(ps.size(), 10); i++) {
+		const DrawCost& c = ps[i].second;
+		if (ps[i].first == g_draw_profile_other)
+			fprintf(stderr, "other           ");
+		else
+			fprintf(stderr, "%016llx", (unsigned long long)ps[i].first);
+		fprintf(stderr, "\t%8llu draws\t%8.2f ms\t%6.2f us/draw\n", (unsigned long long)c.draws, c.ns * 0.000001, c.ns * 0.001 / c.draws);
+	}
+
+	FILE* csv = fopen("GSdx_draw_profile.csv", "w");
+	if (csv) {
+		fprintf(csv, "kind,key,draws,total_ms,mean_us\n");
+		for (const auto& i : ps) {
+			if (i.first == g_draw_profile_other)
+				fprintf(csv, "ps,other");
+			else
+				fprintf(csv, "ps,%016llx", (unsigned long long)i.first);
+			fprintf(csv, ",%llu,%lf,%lf\n", (unsigned long long)i.second.draws, i.second.ns * 0.000001, i.second.ns * 0.001 / i.second.draws);
+		}
+		for (const auto& i : m_draw_profiler.per_rt) {
+			fprintf(csv, "rt,%u,%llu,%lf,%lf\n", i.first, (unsigned long long)i.second.draws, i.second.ns * 0.000001, i.second.ns * 0.001 / i.second.draws);
+		}
+
+		fclose(csv);
+	}
+}
+
 void GSDeviceOGL::GenerateProfilerData()
 {
+	if (m_draw_profiler.enabled)
+		WriteDrawProfile();
+
 	if (m_profiler.last_query < 3) {
 		glDeleteQueries(1 << 16, m_profiler.timer_query);
 		return;
@@ -219,6 +313,26 @@ void GSDeviceOGL::GenerateProfilerData()
 		fprintf(stderr, "%3u ms => %3u ms\t%4u\n", 2 * i, 2 * (i+1), time_repartition[i]);
 	}
 
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Texture uploads %.1f calls\t%.1f KB per frame\n", g_texture_upload_call / frames, g_texture_upload_byte / frames / 1024.0);
+	if (g_geometry_upload_call) {
+		fprintf(stderr, "Geometry uploads %.1f draws\t%.1f KB vertex\t%.1f KB index per frame (%.0f/%.0f bytes per draw)\n",
+				g_geometry_upload_call / frames, g_geometry_upload_vertex_byte / frames / 1024.0, g_geometry_upload_index_byte / frames / 1024.0,
+				(double)g_geometry_upload_vertex_byte / g_geometry_upload_call, (double)g_geometry_upload_index_byte / g_geometry_upload_call);
+	}
+	if (GLState::draw_call) {
+		static const char* name[GLState::CALL_COUNT] = {"fbo", "viewport", "blend", "depth/stencil", "sampler", "texture", "ubo", "program"};
+
+		uint64 total = 0;
+		for (auto c : GLState::state_call) total += c;
+
+		double draws = (double)GLState::draw_call;
+		fprintf(stderr, "GL state calls %.2f per draw (%.1f draws per frame):", total / draws, draws / frames);
+		for (int i = 0; i < GLState::CALL_COUNT; i++)
+			fprintf(stderr, " %s %.2f", name[i], GLState::state_call[i] / draws);
+		fprintf(stderr, "\n");
+	}
+
 	FILE* csv = fopen("GSdx_profile.csv", "w");
 	if (csv) {
 		for (size_t i = 0; i < times.size(); i++) {
@@ -239,11 +353,8 @@ GSTexture* GSDeviceOGL::CreateSurface(int type, int w, int h, int fmt)
 	// NOTE: I'm not sure RenderTarget always need to be cleared. It could be costly for big upscale.
 	// FIXME: it will be more logical to do it in FetchSurface. This code is only called at first creation
 	//  of the texture. However we could reuse a deleted texture.
-	if (m_force_texture_clear == 0) {
-		// Clear won't be done if the texture isn't committed. Commit the full texture to ensure
-		// correct behavior of force clear option (debug option)
-		t->Commit();
-
+	// Sparse textures are left uncommitted, their pages are cleared as they get committed by the draws
+	if (m_force_texture_clear == 0 && !t->IsSparse()) {
 		switch(type)
 		{
 			case GSTexture::RenderTarget:
@@ -315,6 +426,8 @@ bool GSDeviceOGL::Create(const std::shared_ptr<GSWnd> &wnd)
 
 	m_force_texture_clear = theApp.GetConfigI("force_texture_clear");
 
+	m_bindless = GLLoader::found_GL_ARB_bindless_texture && theApp.GetConfigB("bindless_texture");
+
 	// WARNING it must be done after the control setup (at least on MESA)
 	GL_PUSH("GSDeviceOGL::Create");
 
@@ -342,6 +455,7 @@ bool GSDeviceOGL::Create(const std::shared_ptr<GSWnd> &wnd)
 		// Some timers to help profiling
 		if (GLLoader::in_replayer) {
 			glCreateQueries(GL_TIMESTAMP, 1 << 16, m_profiler.timer_query);
+			m_draw_profiler.enabled = theApp.GetConfigB("gpu_draw_profile");
 		}
 	}
 
@@ -466,6 +580,15 @@ bool GSDeviceOGL::Create(const std::shared_ptr<GSWnd> &wnd)
 
 		ps = m_shader->Compile("shadeboost.glsl", "ps_main", GL_FRAGMENT_SHADER, shader.data(), shade_macro);
 		m_shadeboost.ps = m_shader->LinkPipeline("ShadeBoost pipe", vs, 0, ps);
+
+		// Interlace passes that apply the boost to their output, it saves a full screen pass
+		theApp.LoadResource(IDR_INTERLACE_GLSL, shader);
+
+		for(size_t i = 0; i < countof(m_interlace.ps_sb); i++) {
+			ps = m_shader->Compile("interlace.glsl", format("ps_main%d", i), GL_FRAGMENT_SHADER, shader.data(), shade_macro);
+			std::string pretty_name = "Interlace ShadeBoost pipe " + std::to_string(i);
+			m_interlace.ps_sb[i] = m_shader->LinkPipeline(pretty_name, vs, 0, ps);
+		}
 	}
 
 	// ****************************************************************
@@ -577,6 +700,21 @@ bool GSDeviceOGL::Create(const std::shared_ptr<GSWnd> &wnd)
 	static_assert(sizeof(OMDepthStencilSelector) == 4, "Wrong OMDepthStencilSelector size");
 	static_assert(sizeof(OMColorMaskSelector) == 4, "Wrong OMColorMaskSelector size");
 
+	// ****************************************************************
+	// Present thread
+	// ****************************************************************
+	int present_mode = theApp.GetConfigI("present_mode");
+
+	if (present_mode > 0) {
+		m_present_thread = new GSPresentThreadOGL(static_cast<GSWndGL*>(m_wnd.get()), present_mode > 1);
+
+		if (!m_present_thread->Start()) {
+			fprintf(stderr, "Present thread isn't supported by this window, the GS thread will flip it\n");
+			delete m_present_thread;
+			m_present_thread = NULL;
+		}
+	}
+
 	return true;
 }
 
@@ -634,26 +772,99 @@ void GSDeviceOGL::SetVSync(int vsync)
 	m_wnd->SetVSync(vsync);
 }
 
+void GSDeviceOGL::Present(const GSVector4i& r, int shader)
+{
+	if (!m_present_thread) {
+		GSDevice::Present(r, shader);
+		return;
+	}
+
+	GSVector4i cr = m_wnd->GetClientRect();
+
+	int w = std::max<int>(cr.width(), 1);
+	int h = std::max<int>(cr.height(), 1);
+
+	GL_PUSH("Present (thread)");
+
+	// Not pooled, the present thread is the only other user
+	GSTextureOGL*& rt = m_present_thread->BeginFrame();
+
+	if (!rt || rt->GetWidth() != w || rt->GetHeight() != h) {
+		delete rt;
+		rt = static_cast<GSTextureOGL*>(CreateSurface(GSTexture::RenderTarget, w, h, 0));
+		rt->Commit(); // the present thread reads it all
+	}
+
+	m_present_rt = rt;
+
+	Compose(rt, r, shader);
+
+	m_present_thread->EndFrame();
+
+	AfterFlip();
+}
+
+bool GSDeviceOGL::GetPresentStats(PresentStats& stats)
+{
+	if (!m_present_thread)
+		return false;
+
+	m_present_thread->GetStats(stats);
+
+	return true;
+}
+
 void GSDeviceOGL::Flip()
 {
 	m_wnd->Flip();
 
+	AfterFlip();
+}
+
+void GSDeviceOGL::AfterFlip()
+{
 	if (GLLoader::in_replayer) {
 		glQueryCounter(m_profiler.timer(), GL_TIMESTAMP);
 		m_profiler.last_query++;
 	}
+
+	if (m_draw_profiler.enabled)
+		ResolveDrawTiming(false);
 }
 
 void GSDeviceOGL::BeforeDraw()
 {
+	GLState::draw_call++;
+
+	if (m_draw_profiler.enabled) {
+		std::vector<GLuint>& free_query = m_draw_profiler.free_query;
+
+		if (free_query.size() < 2) {
+			GLuint q[64];
+			glCreateQueries(GL_TIMESTAMP, countof(q), q);
+			free_query.insert(free_query.end(), q, q + countof(q));
+		}
+
+		DrawTiming dt;
+		dt.query[1] = free_query.back(); free_query.pop_back();
+		dt.query[0] = free_query.back(); free_query.pop_back();
+		dt.ps = m_draw_profiler.current;
+		dt.rt = m_draw_profiler.rt;
+
+		glQueryCounter(dt.query[0], GL_TIMESTAMP);
+		m_draw_profiler.pending.push_back(dt);
+	}
 }
 
 void GSDeviceOGL::AfterDraw()
 {
+	if (m_draw_profiler.enabled)
+		glQueryCounter(m_draw_profiler.pending.back().query[1], GL_TIMESTAMP);
 }
 
 void GSDeviceOGL::DrawPrimitive()
 {
+	m_draw_profiler.current = g_draw_profile_other;
 	BeforeDraw();
 	m_va->DrawPrimitive();
 	AfterDraw();
@@ -661,6 +872,7 @@ void GSDeviceOGL::DrawPrimitive()
 
 void GSDeviceOGL::DrawPrimitive(int offset, int count)
 {
+	m_draw_profiler.current = g_draw_profile_other;
 	BeforeDraw();
 	m_va->DrawPrimitive(offset, count);
 	AfterDraw();
@@ -668,6 +880,7 @@ void GSDeviceOGL::DrawPrimitive(int offset, int count)
 
 void GSDeviceOGL::DrawIndexedPrimitive()
 {
+	m_draw_profiler.current = m_draw_profiler.ps;
 	BeforeDraw();
 	if (!m_disable_hw_gl_draw)
 		m_va->DrawIndexedPrimitive();
@@ -678,12 +891,25 @@ void GSDeviceOGL::DrawIndexedPrimitive(int offset, int count)
 {
 	//ASSERT(offset + count <= (int)m_index.count);
 
+	m_draw_profiler.current = m_draw_profiler.ps;
 	BeforeDraw();
 	if (!m_disable_hw_gl_draw)
 		m_va->DrawIndexedPrimitive(offset, count);
 	AfterDraw();
 }
 
+// The clears are done with the scissor test disabled, unless the scissor already covers the whole texture
+static bool ScissorCropsClear(const GSVector2i& size)
+{
+	GSVector4i full = GSVector4i(size).zwxy();
+
+	bool crops = !GLState::scissor.rintersect(full).eq(full);
+	if (crops)
+		GLState::state_call[GLState::CALL_VIEWPORT] += 2;
+
+	return crops;
+}
+
 void GSDeviceOGL::ClearRenderTarget(GSTexture* t, const GSVector4& c)
 {
 	if (!t) return;
@@ -701,8 +927,9 @@ void GSDeviceOGL::ClearRenderTarget(GSTexture* t, const GSVector4& c)
 
 	GL_PUSH("Clear RT %d", T->GetID());
 
-	// TODO: check size of scissor before toggling it
-	glDisable(GL_SCISSOR_TEST);
+	bool scissor = ScissorCropsClear(T->GetSize());
+	if (scissor)
+		glDisable(GL_SCISSOR_TEST);
 
 	uint32 old_color_mask = GLState::wrgba;
 	OMSetColorMaskState();
@@ -723,7 +950,8 @@ void GSDeviceOGL::ClearRenderTarget(GSTexture* t, const GSVector4& c)
 
 	OMSetColorMaskState(OMColorMaskSelector(old_color_mask));
 
-	glEnable(GL_SCISSOR_TEST);
+	if (scissor)
+		glEnable(GL_SCISSOR_TEST);
 
 	T->WasCleaned();
 }
@@ -761,8 +989,9 @@ void GSDeviceOGL::ClearDepth(GSTexture* t)
 		OMAttachRt(NULL);
 		OMAttachDs(T);
 
-		// TODO: check size of scissor before toggling it
-		glDisable(GL_SCISSOR_TEST);
+		bool scissor = ScissorCropsClear(T->GetSize());
+		if (scissor)
+			glDisable(GL_SCISSOR_TEST);
 		float c = 0.0f;
 		if (GLState::depth_mask) {
 			glClearBufferfv(GL_DEPTH, 0, &c);
@@ -770,8 +999,10 @@ void GSDeviceOGL::ClearDepth(GSTexture* t)
 			glDepthMask(true);
 			glClearBufferfv(GL_DEPTH, 0, &c);
 			glDepthMask(false);
+			GLState::state_call[GLState::CALL_DEPTH_STENCIL] += 2;
 		}
-		glEnable(GL_SCISSOR_TEST);
+		if (scissor)
+			glEnable(GL_SCISSOR_TEST);
 	}
 }
 
@@ -945,7 +1176,31 @@ GLuint GSDeviceOGL::CompileGS(GSSelector sel)
 		return m_shader->Compile("tfx_vgs.glsl", "gs_main", GL_GEOMETRY_SHADER, m_shader_tfx_vgs.data(), macro);
 }
 
-GLuint GSDeviceOGL::CompilePS(PSSelector sel)
+void GSDeviceOGL::GetPSSelectors(std::vector<uint64>& keys)
+{
+	for (const auto& i : m_ps)
+		keys.push_back(i.first);
+}
+
+// Compile the pixel shaders that a game used in a previous session before it needs them. With
+// parallel shader compile they are only kicked here, the driver threads build them while the
+// game boots.
+void GSDeviceOGL::PrecompilePS(const std::vector<uint64>& keys)
+{
+	GL_PUSH("GSDeviceOGL::PrecompilePS");
+
+	for (uint64 key : keys) {
+		if (m_ps.find(key) != m_ps.end())
+			continue;
+
+		PSSelector sel;
+		sel.key = key;
+
+		m_ps[key] = CompilePS(sel, true);
+	}
+}
+
+GLuint GSDeviceOGL::CompilePS(PSSelector sel, bool async)
 {
 	std::string macro = format("#define PS_FST %d\n", sel.fst)
 		+ format("#define PS_WMS %d\n", sel.wms)
@@ -985,8 +1240,13 @@ GLuint GSDeviceOGL::CompilePS(PSSelector sel)
 		+ format("#define PS_PABE %d\n", sel.pabe);
 	;
 
+	if (m_bindless)
+		macro = "#extension GL_ARB_bindless_texture: require\n#define PS_BINDLESS 1\n" + macro;
+
 	if (GLLoader::buggy_sso_dual_src)
 		return m_shader->CompileShader("tfx.glsl", "ps_main", GL_FRAGMENT_SHADER, m_shader_tfx_fs.data(), macro);
+	else if (async)
+		return m_shader->CompileAsync("tfx.glsl", "ps_main", GL_FRAGMENT_SHADER, m_shader_tfx_fs.data(), macro);
 	else
 		return m_shader->Compile("tfx.glsl", "ps_main", GL_FRAGMENT_SHADER, m_shader_tfx_fs.data(), macro);
 }
@@ -1221,7 +1481,7 @@ void GSDeviceOGL::CopyRectConv(GSTexture* sTex, GSTexture* dTex, const GSVector4
 
 	GL_PUSH(format("CopyRectConv from %d to %d", sid, did).c_str());
 
-	dTex->CommitRegion(GSVector2i(r.z, r.w));
+	dTex->CommitRect(at_origin ? r.rsize() : r);
 
 	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo_read);
 
@@ -1250,7 +1510,7 @@ void GSDeviceOGL::CopyRect(GSTexture* sTex, GSTexture* dTex, const GSVector4i& r
 	PSSetShaderResource(6, sTex);
 #endif
 
-	dTex->CommitRegion(GSVector2i(r.z, r.w));
+	dTex->CommitRect(r.rsize());
 
 	ASSERT(GLExtension::Has("GL_ARB_copy_image") && glCopyImageSubData);
 	glCopyImageSubData( sid, GL_TEXTURE_2D,
@@ -1338,7 +1598,7 @@ void GSDeviceOGL::StretchRect(GSTexture* sTex, const GSVector4& sRect, GSTexture
 	// 2/ in case some GSdx code expect thing in dx order.
 	// Only flipping the backbuffer is transparent (I hope)...
 	GSVector4 flip_sr = sRect;
-	if (static_cast<GSTextureOGL*>(dTex)->IsBackbuffer()) {
+	if (static_cast<GSTextureOGL*>(dTex)->IsBackbuffer() || dTex == m_present_rt) {
 		flip_sr.y = sRect.w;
 		flip_sr.w = sRect.y;
 	}
@@ -1364,7 +1624,7 @@ void GSDeviceOGL::StretchRect(GSTexture* sTex, const GSVector4& sRect, GSTexture
 	// ************************************
 	// Draw
 	// ************************************
-	dTex->CommitRegion(GSVector2i((int)dRect.z + 1, (int)dRect.w + 1));
+	dTex->CommitRect(GSVector4i(dRect.floor()).add32(GSVector4i(0, 0, 1, 1)));
 	DrawPrimitive();
 
 	// ************************************
@@ -1464,6 +1724,20 @@ void GSDeviceOGL::DoInterlace(GSTexture* sTex, GSTexture* dTex, int shader, bool
 {
 	GL_PUSH("DoInterlace");
 
+	InterlacePass(sTex, dTex, m_interlace.ps[shader], linear, yoffset);
+}
+
+bool GSDeviceOGL::DoInterlaceShadeBoost(GSTexture* sTex, GSTexture* dTex, int shader, bool linear, float yoffset)
+{
+	GL_PUSH("DoInterlaceShadeBoost");
+
+	InterlacePass(sTex, dTex, m_interlace.ps_sb[shader], linear, yoffset);
+
+	return true;
+}
+
+void GSDeviceOGL::InterlacePass(GSTexture* sTex, GSTexture* dTex, GLuint ps, bool linear, float yoffset)
+{
 	OMSetColorMaskState();
 
 	GSVector4 s = GSVector4(dTex->GetSize());
@@ -1478,7 +1752,7 @@ void GSDeviceOGL::DoInterlace(GSTexture* sTex, GSTexture* dTex, int shader, bool
 
 	m_interlace.cb->cache_upload(&cb);
 
-	StretchRect(sTex, sRect, dTex, dRect, m_interlace.ps[shader], linear);
+	StretchRect(sTex, sRect, dTex, dRect, ps, linear);
 }
 
 void GSDeviceOGL::DoFXAA(GSTexture* sTex, GSTexture* dTex)
@@ -1594,6 +1868,7 @@ void GSDeviceOGL::SetupDATE(GSTexture* rt, GSTexture* ds, const GSVertexPT1* ver
 	OMSetDepthStencilState(m_date.dss);
 	if (GLState::blend) {
 		glDisable(GL_BLEND);
+		GLState::state_call[GLState::CALL_BLEND] += 2;
 	}
 	OMSetRenderTargets(NULL, ds, &GLState::scissor);
 
@@ -1645,6 +1920,7 @@ void GSDeviceOGL::PSSetShaderResource(int i, GSTexture* sr)
 		GLuint id = static_cast<GSTextureOGL*>(sr)->GetID();
 		if (GLState::tex_unit[i] != id) {
 			GLState::tex_unit[i] = id;
+			GLState::state_call[GLState::CALL_TEXTURE]++;
 			glBindTextureUnit(i, id);
 		}
 	}
@@ -1660,6 +1936,7 @@ void GSDeviceOGL::PSSetSamplerState(GLuint ss)
 {
 	if (GLState::ps_ss != ss) {
 		GLState::ps_ss = ss;
+		GLState::state_call[GLState::CALL_SAMPLER]++;
 		glBindSampler(0, ss);
 	}
 }
@@ -1676,6 +1953,7 @@ void GSDeviceOGL::OMAttachRt(GSTextureOGL* rt)
 
 	if (GLState::rt != id) {
 		GLState::rt = id;
+		GLState::state_call[GLState::CALL_FBO]++;
 		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, id, 0);
 	}
 }
@@ -1692,6 +1970,7 @@ void GSDeviceOGL::OMAttachDs(GSTextureOGL* ds)
 
 	if (GLState::ds != id) {
 		GLState::ds = id;
+		GLState::state_call[GLState::CALL_FBO]++;
 		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, id, 0);
 	}
 }
@@ -1700,6 +1979,7 @@ void GSDeviceOGL::OMSetFBO(GLuint fbo)
 {
 	if (GLState::fbo != fbo) {
 		GLState::fbo = fbo;
+		GLState::state_call[GLState::CALL_FBO]++;
 		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
 	}
 }
@@ -1714,6 +1994,7 @@ void GSDeviceOGL::OMSetColorMaskState(OMColorMaskSelector sel)
 {
 	if (sel.wrgba != GLState::wrgba) {
 		GLState::wrgba = sel.wrgba;
+		GLState::state_call[GLState::CALL_BLEND]++;
 
 		glColorMaski(0, sel.wr, sel.wg, sel.wb, sel.wa);
 	}
@@ -1724,11 +2005,13 @@ void GSDeviceOGL::OMSetBlendState(uint8 blend_index, uint8 blend_factor, bool is
 	if (blend_index) {
 		if (!GLState::blend) {
 			GLState::blend = true;
+			GLState::state_call[GLState::CALL_BLEND]++;
 			glEnable(GL_BLEND);
 		}
 
 		if (is_blend_constant && GLState::bf != blend_factor) {
 			GLState::bf = blend_factor;
+			GLState::state_call[GLState::CALL_BLEND]++;
 			float bf = (float)blend_factor / 128.0f;
 			glBlendColor(bf, bf, bf, bf);
 		}
@@ -1741,18 +2024,21 @@ void GSDeviceOGL::OMSetBlendState(uint8 blend_index, uint8 blend_factor, bool is
 
 		if (GLState::eq_RGB != b.op) {
 			GLState::eq_RGB = b.op;
+			GLState::state_call[GLState::CALL_BLEND]++;
 			glBlendEquationSeparate(b.op, GL_FUNC_ADD);
 		}
 
 		if (GLState::f_sRGB != b.src || GLState::f_dRGB != b.dst) {
 			GLState::f_sRGB = b.src;
 			GLState::f_dRGB = b.dst;
+			GLState::state_call[GLState::CALL_BLEND]++;
 			glBlendFuncSeparate(b.src, b.dst, GL_ONE, GL_ZERO);
 		}
 
 	} else {
 		if (GLState::blend) {
 			GLState::blend = false;
+			GLState::state_call[GLState::CALL_BLEND]++;
 			glDisable(GL_BLEND);
 		}
 	}
@@ -1783,10 +2069,13 @@ void GSDeviceOGL::OMSetRenderTargets(GSTexture* rt, GSTexture* ds, const GSVecto
 	}
 
 
+	m_draw_profiler.rt = rt ? RT->GetID() : 0;
+
 	GSVector2i size = rt ? rt->GetSize() : ds ? ds->GetSize() : GLState::viewport;
 	if(GLState::viewport != size)
 	{
 		GLState::viewport = size;
+		GLState::state_call[GLState::CALL_VIEWPORT]++;
 		// FIXME ViewportIndexedf or ViewportIndexedfv (GL4.1)
 		glViewportIndexedf(0, 0, 0, GLfloat(size.x), GLfloat(size.y));
 	}
@@ -1796,6 +2085,7 @@ void GSDeviceOGL::OMSetRenderTargets(GSTexture* rt, GSTexture* ds, const GSVecto
 	if(!GLState::scissor.eq(r))
 	{
 		GLState::scissor = r;
+		GLState::state_call[GLState::CALL_VIEWPORT]++;
 		// FIXME ScissorIndexedv (GL4.1)
 		glScissorIndexed(0, r.x, r.y, r.width(), r.height());
 	}
@@ -1819,8 +2109,28 @@ void GSDeviceOGL::SetupCBMisc(const GSVector4i& channel)
 	m_convert.cb->cache_upload(&m_misc_cb_cache);
 }
 
+// Kick the compilation of a new pixel shader without waiting for the driver. Return false
+// while the program is still being built so the caller can drop the draw instead of stalling.
+bool GSDeviceOGL::IsPSReady(const PSSelector& psel)
+{
+	if (!m_shader->IsAsync())
+		return true;
+
+	auto i = m_ps.find(psel);
+
+	if (i == m_ps.end()) {
+		GLuint ps = CompilePS(psel, true);
+		m_ps[psel] = ps;
+		return m_shader->IsProgramReady(ps);
+	}
+
+	return m_shader->IsProgramReady(i->second);
+}
+
 void GSDeviceOGL::SetupPipeline(const VSSelector& vsel, const GSSelector& gsel, const PSSelector& psel)
 {
+	m_draw_profiler.ps = psel.key;
+
 	GLuint ps;
 	auto i = m_ps.find(psel);
 
@@ -1897,6 +2207,14 @@ GLuint GSDeviceOGL::GetPaletteSamplerID()
 	return m_palette_ss;
 }
 
+GSVector4i GSDeviceOGL::GetTextureHandles(GSTexture* tex, PSSamplerSelector ssel, GSTexture* pal)
+{
+	GLuint64 t = static_cast<GSTextureOGL*>(tex)->GetHandle(m_ps_ss[ssel]);
+	GLuint64 p = pal ? static_cast<GSTextureOGL*>(pal)->GetHandle(m_palette_ss) : 0;
+
+	return GSVector4i::loadl(&t).upl64(GSVector4i::loadl(&p));
+}
+
 void GSDeviceOGL::SetupOM(OMDepthStencilSelector dssel)
 {
 	OMSetDepthStencilState(m_om_dss[dssel]);
@@ -28,6 +28,7 @@
 #include "GSUniformBufferOGL.h"
 #include "GSShaderOGL.h"
 #include "GLState.h"
+#include "GSPresentThreadOGL.h"
 
 // A couple of flag to determine the blending behavior
 #define BLEND_A_MAX		(0x100) // Impossible blending uses coeff bigger than 1
@@ -40,6 +41,12 @@ extern uint64 g_real_texture_upload_byte;
 extern uint64 g_vertex_upload_byte;
 #endif
 
+extern uint64 g_texture_upload_call;
+extern uint64 g_texture_upload_byte;
+extern uint64 g_geometry_upload_call;
+extern uint64 g_geometry_upload_vertex_byte;
+extern uint64 g_geometry_upload_index_byte;
+
 class GSDepthStencilOGL {
 	bool m_depth_enable;
 	GLenum m_depth_func;
@@ -70,6 +77,7 @@ public:
 	{
 		if (GLState::depth != m_depth_enable) {
 			GLState::depth = m_depth_enable;
+			GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
 			if (m_depth_enable)
 				glEnable(GL_DEPTH_TEST);
 			else
@@ -79,10 +87,12 @@ public:
 		if (m_depth_enable) {
 			if (GLState::depth_func != m_depth_func) {
 				GLState::depth_func = m_depth_func;
+				GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
 				glDepthFunc(m_depth_func);
 			}
 			if (GLState::depth_mask != m_depth_mask) {
 				GLState::depth_mask = m_depth_mask;
+				GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
 				glDepthMask((GLboolean)m_depth_mask);
 			}
 		}
@@ -92,6 +102,7 @@ public:
 	{
 		if (GLState::stencil != m_stencil_enable) {
 			GLState::stencil = m_stencil_enable;
+			GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
 			if (m_stencil_enable)
 				glEnable(GL_STENCIL_TEST);
 			else
@@ -102,10 +113,12 @@ public:
 			// Note: here the mask control which bitplane is considered by the operation
 			if (GLState::stencil_func != m_stencil_func) {
 				GLState::stencil_func = m_stencil_func;
+				GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
 				glStencilFunc(m_stencil_func, 1, 1);
 			}
 			if (GLState::stencil_pass != m_stencil_spass_dpass_op) {
 				GLState::stencil_pass = m_stencil_spass_dpass_op;
+				GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
 				glStencilOp(GL_KEEP, GL_KEEP, m_stencil_spass_dpass_op);
 			}
 		}
@@ -204,6 +217,8 @@ public:
 		GSVector4 MinMax;
 		GSVector4 TC_OH_TS;
 
+		GSVector4i TexHandle; // bindless source and palette
+
 		PSConstantBuffer()
 		{
 			FogColor_AREF = GSVector4::zero();
@@ -214,6 +229,7 @@ public:
 			MskFix        = GSVector4i::zero();
 			TC_OH_TS      = GSVector4::zero();
 			FbMask        = GSVector4i::zero();
+			TexHandle     = GSVector4i::zero();
 		}
 
 		__forceinline bool Update(const PSConstantBuffer* cb)
@@ -223,7 +239,7 @@ public:
 
 			// if WH matches both HalfTexel and TC_OH_TS do too
 			// MinMax depends on WH and MskFix so no need to check it too
-			if(!((a[0] == b[0]) & (a[1] == b[1]) & (a[2] == b[2]) & (a[3] == b[3]) & (a[4] == b[4])).alltrue())
+			if(!((a[0] == b[0]) & (a[1] == b[1]) & (a[2] == b[2]) & (a[3] == b[3]) & (a[4] == b[4]) & (a[8] == b[8])).alltrue())
 			{
 				// Note previous check uses SSE already, a plain copy will be faster than any memcpy
 				a[0] = b[0];
@@ -232,6 +248,7 @@ public:
 				a[3] = b[3];
 				a[4] = b[4];
 				a[5] = b[5];
+				a[8] = b[8];
 
 				return true;
 			}
@@ -418,6 +435,7 @@ public:
 	static FILE* m_debug_gl_file;
 
 	bool m_disable_hw_gl_draw;
+	bool m_bindless;
 
 	// Place holder for the GLSL shader code (to avoid useless reload)
 	std::vector<char> m_shader_tfx_vgs;
@@ -428,6 +446,9 @@ public:
 
 	GSVertexBufferStateOGL* m_va;// state of the vertex buffer/array
 
+	GSPresentThreadOGL* m_present_thread; // present_mode > 0, NULL when the window is flipped here
+	GSTexture* m_present_rt; // frame of the present thread, drawn like the backbuffer
+
 	struct {
 		GLuint ps[2];				 // program object
 		GSUniformBufferOGL* cb;		 // uniform buffer object
@@ -435,6 +456,7 @@ public:
 
 	struct {
 		GLuint ps[4];				// program object
+		GLuint ps_sb[4];			// program object, with the shade boost
 		GSUniformBufferOGL* cb;		// uniform buffer object
 	} m_interlace;
 
@@ -474,6 +496,33 @@ public:
 		GLuint timer() { return timer_query[last_query]; }
 	} m_profiler;
 
+	struct DrawTiming {
+		GLuint query[2];
+		uint64 ps;
+		GLuint rt;
+	};
+
+	struct DrawCost {
+		uint64 draws;
+		uint64 ns;
+	};
+
+	// Replayer only (gpu_draw_profile), timestamps around every draw resolved a few frames later
+	struct {
+		bool enabled;
+		uint64 ps;      // key of the last SetupPipeline
+		uint64 current; // key of the draw in flight, ps or "other" for convert/DATE draws
+		GLuint rt;
+		std::vector<GLuint> free_query;
+		std::deque<DrawTiming> pending;
+		std::map<uint64, DrawCost> per_ps;
+		std::map<GLuint, DrawCost> per_rt;
+	} m_draw_profiler;
+
+	void ResolveDrawTiming(bool wait);
+	void AfterFlip();
+	void WriteDrawProfile();
+
 	GLuint m_vs[1<<1];
 	GLuint m_gs[1<<3];
 	GLuint m_ps_ss[1<<7];
@@ -497,6 +546,8 @@ public:
 
 	void DoMerge(GSTexture* sTex[3], GSVector4* sRect, GSTexture* dTex, GSVector4* dRect, const GSRegPMODE& PMODE, const GSRegEXTBUF& EXTBUF, const GSVector4& c) final;
 	void DoInterlace(GSTexture* sTex, GSTexture* dTex, int shader, bool linear, float yoffset = 0) final;
+	bool DoInterlaceShadeBoost(GSTexture* sTex, GSTexture* dTex, int shader, bool linear, float yoffset) final;
+	void InterlacePass(GSTexture* sTex, GSTexture* dTex, GLuint ps, bool linear, float yoffset);
 	void DoFXAA(GSTexture* sTex, GSTexture* dTex) final;
 	void DoShadeBoost(GSTexture* sTex, GSTexture* dTex) final;
 	void DoExternalFX(GSTexture* sTex, GSTexture* dTex) final;
@@ -519,7 +570,11 @@ public:
 
 	bool Create(const std::shared_ptr<GSWnd> &wnd);
 	bool Reset(int w, int h);
+	using GSDevice::Present;
+	void Present(const GSVector4i& r, int shader);
 	void Flip();
+	bool GetPresentStats(PresentStats& stats);
+	uint32 GetShaderCompiles() { return m_shader->GetCompiles(); }
 	void SetVSync(int vsync);
 
 	void DrawPrimitive() final;
@@ -569,7 +624,7 @@ public:
 	void CreateTextureFX();
 	GLuint CompileVS(VSSelector sel);
 	GLuint CompileGS(GSSelector sel);
-	GLuint CompilePS(PSSelector sel);
+	GLuint CompilePS(PSSelector sel, bool async = false);
 	GLuint CreateSampler(PSSamplerSelector sel);
 	GSDepthStencilOGL* CreateDepthStencil(OMDepthStencilSelector dssel);
 
@@ -577,6 +632,9 @@ public:
 	void SelfShaderTestRun(const std::string& dir, const std::string& file, const PSSelector& sel, int& nb_shader);
 	void SelfShaderTest();
 
+	bool IsPSReady(const PSSelector& psel);
+	void GetPSSelectors(std::vector<uint64>& keys);
+	void PrecompilePS(const std::vector<uint64>& keys);
 	void SetupPipeline(const VSSelector& vsel, const GSSelector& gsel, const PSSelector& psel);
 	void SetupCB(const VSConstantBuffer* vs_cb, const PSConstantBuffer* ps_cb);
 	void SetupCBMisc(const GSVector4i& channel);
@@ -585,5 +643,10 @@ public:
 	GLuint GetSamplerID(PSSamplerSelector ssel);
 	GLuint GetPaletteSamplerID();
 
+	// With bindless textures, the HW draws pass their source and palette in the PS constant
+	// buffer (PSConstantBuffer::TexHandle) instead of binding them with their sampler
+	bool IsBindless() const { return m_bindless; }
+	GSVector4i GetTextureHandles(GSTexture* tex, PSSamplerSelector ssel, GSTexture* pal);
+
 	void Barrier(GLbitfield b);
 };
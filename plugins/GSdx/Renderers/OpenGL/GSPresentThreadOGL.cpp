@@ -0,0 +1,200 @@
+/*
+ *	Copyright (C) 2007-2016 PCSX2 Dev Team
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GSPresentThreadOGL.h"
+
+GSPresentThreadOGL::GSPresentThreadOGL(GSWndGL* wnd, bool mailbox)
+	: m_wnd(wnd)
+	, m_mailbox(mailbox)
+	, m_drawn(0)
+	, m_queued(-1)
+	, m_presenting(-1)
+	, m_exit(false)
+{
+	memset(m_frames, 0, sizeof(m_frames));
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+GSPresentThreadOGL::~GSPresentThreadOGL()
+{
+	if(m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> l(m_lock);
+
+			m_exit = true;
+		}
+
+		m_cv.notify_all();
+		m_thread.join();
+
+		m_wnd->DestroyPresentContext();
+	}
+
+	// The GS thread context is the current one
+	for(Frame& f : m_frames)
+	{
+		if(f.fence) glDeleteSync(f.fence);
+		delete f.tex;
+	}
+}
+
+bool GSPresentThreadOGL::Start()
+{
+	if(!m_wnd->CreatePresentContext())
+		return false;
+
+	m_thread = std::thread(&GSPresentThreadOGL::ThreadProc, this);
+
+	return true;
+}
+
+GSTextureOGL*& GSPresentThreadOGL::BeginFrame()
+{
+	std::lock_guard<std::mutex> l(m_lock);
+
+	for(int i = 0; i < (int)countof(m_frames); i++)
+	{
+		if(i != m_queued && i != m_presenting)
+		{
+			m_drawn = i;
+			break;
+		}
+	}
+
+	return m_frames[m_drawn].tex;
+}
+
+void GSPresentThreadOGL::EndFrame()
+{
+	Frame& f = m_frames[m_drawn];
+
+	// The present context waits for it before reading the texture
+	f.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	f.queued = Clock::now();
+
+	glFlush();
+
+	{
+		std::unique_lock<std::mutex> l(m_lock);
+
+		if(m_queued >= 0)
+		{
+			if(m_mailbox)
+			{
+				Frame& dropped = m_frames[m_queued];
+
+				glDeleteSync(dropped.fence);
+				dropped.fence = 0;
+
+				m_stats.dropped++;
+			}
+			else
+			{
+				m_cv.wait(l, [this] {return m_queued < 0;});
+			}
+		}
+
+		m_queued = m_drawn;
+	}
+
+	m_cv.notify_all();
+}
+
+void GSPresentThreadOGL::GetStats(GSDevice::PresentStats& stats)
+{
+	std::lock_guard<std::mutex> l(m_lock);
+
+	stats = m_stats;
+
+	if(stats.presented > 0)
+	{
+		stats.swap_ms /= stats.presented;
+		stats.latency_ms /= stats.presented;
+	}
+
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void GSPresentThreadOGL::ThreadProc()
+{
+	m_wnd->AttachPresentContext();
+
+	// Framebuffer objects aren't shared between contexts
+	GLuint fbo = 0;
+	glGenFramebuffers(1, &fbo);
+
+	std::unique_lock<std::mutex> l(m_lock);
+
+	while(true)
+	{
+		m_cv.wait(l, [this] {return m_queued >= 0 || m_exit;});
+
+		if(m_exit)
+			break;
+
+		Frame& f = m_frames[m_presenting = m_queued];
+
+		m_queued = -1;
+
+		l.unlock();
+
+		m_cv.notify_all();
+
+		glWaitSync(f.fence, 0, GL_TIMEOUT_IGNORED);
+		glDeleteSync(f.fence);
+		f.fence = 0;
+
+		// The frame is drawn in the backbuffer orientation (see GSDeviceOGL::StretchRect), a plain copy will do.
+		// Attaching the texture after the fence is also what makes its new content visible to this context.
+		int w = f.tex->GetWidth();
+		int h = f.tex->GetHeight();
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, f.tex->GetID(), 0);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+
+		Clock::time_point start = Clock::now();
+
+		m_wnd->Flip();
+
+		Clock::time_point end = Clock::now();
+
+		l.lock();
+
+		float latency = std::chrono::duration<float, std::milli>(end - f.queued).count();
+
+		m_stats.presented++;
+		m_stats.swap_ms += std::chrono::duration<float, std::milli>(end - start).count();
+		m_stats.latency_ms += latency;
+		m_stats.max_latency_ms = std::max(m_stats.max_latency_ms, latency);
+
+		m_presenting = -1;
+	}
+
+	l.unlock();
+
+	glDeleteFramebuffers(1, &fbo);
+
+	m_wnd->DetachPresentContext();
+}
@@ -0,0 +1,76 @@
+/*
+ *	Copyright (C) 2007-2016 PCSX2 Dev Team
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "GSTextureOGL.h"
+#include "Renderers/Common/GSDevice.h"
+#include "Window/GSWnd.h"
+#include <chrono>
+
+// Swaps the window on its own thread, with a second context, so that a swap blocked by the
+// vsync or the compositor doesn't stall the GS thread.  The GS thread draws every frame
+// into a texture of its own (BeginFrame/EndFrame), the present thread copies the latest
+// queued one to the window and flips.  Three frames: one drawn, one queued, one presented.
+class GSPresentThreadOGL
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	struct Frame
+	{
+		GSTextureOGL* tex;
+		GLsync fence;
+		Clock::time_point queued;
+	};
+
+	GSWndGL* m_wnd;
+	bool m_mailbox; // replace the queued frame instead of waiting for the present thread to take it
+
+	std::thread m_thread;
+	std::mutex m_lock;
+	std::condition_variable m_cv;
+
+	Frame m_frames[3];
+	int m_drawn;      // GS thread
+	int m_queued;     // m_lock, -1 if none
+	int m_presenting; // m_lock, -1 if none
+	bool m_exit;
+
+	GSDevice::PresentStats m_stats; // m_lock
+
+	void ThreadProc();
+
+public:
+	GSPresentThreadOGL(GSWndGL* wnd, bool mailbox);
+	~GSPresentThreadOGL();
+
+	// Creates the present context and starts the thread, false if the window can't have one
+	bool Start();
+
+	// The texture that the next frame must be drawn into, it is up to the caller to
+	// (re)allocate it.  Never a frame that is queued or being presented.
+	GSTextureOGL*& BeginFrame();
+
+	// Queues the frame of BeginFrame.  Waits for the present thread to take the queued frame,
+	// or drops it in mailbox mode.
+	void EndFrame();
+
+	void GetStats(GSDevice::PresentStats& stats);
+};
@@ -39,11 +39,76 @@ GSRendererOGL::GSRendererOGL()
 	ResetStates();
 }
 
+GSRendererOGL::~GSRendererOGL()
+{
+	SaveSelectors();
+}
+
 bool GSRendererOGL::CreateDevice(GSDevice* dev)
 {
 	return GSRenderer::CreateDevice(dev);
 }
 
+void GSRendererOGL::SetGameCRC(uint32 crc, int options)
+{
+	if (crc == m_crc) {
+		GSRendererHW::SetGameCRC(crc, options);
+		return;
+	}
+
+	SaveSelectors();
+
+	GSRendererHW::SetGameCRC(crc, options);
+
+	LoadSelectors();
+}
+
+// Same as sw_jit_cache: with shader_precompile the pixel shaders used by a game are recorded
+// per crc, and compiled when the game boots in the next session.
+
+std::string GSRendererOGL::GetSelectorsPath() const
+{
+	return format("%sGSdx_ogl_%08X.sel", theApp.GetConfigDir().c_str(), m_crc);
+}
+
+void GSRendererOGL::LoadSelectors()
+{
+	if (m_crc == 0 || m_dev == NULL || !theApp.GetConfigB("shader_precompile")) return;
+
+	std::vector<uint64> keys;
+
+	if (FILE* fp = fopen(GetSelectorsPath().c_str(), "r")) {
+		unsigned long long key;
+
+		while (fscanf(fp, "%llx", &key) == 1)
+			keys.push_back(key);
+
+		fclose(fp);
+	}
+
+	((GSDeviceOGL*)m_dev)->PrecompilePS(keys);
+}
+
+void GSRendererOGL::SaveSelectors()
+{
+	if (m_crc == 0 || m_dev == NULL || !theApp.GetConfigB("shader_precompile")) return;
+
+	std::vector<uint64> keys;
+
+	((GSDeviceOGL*)m_dev)->GetPSSelectors(keys);
+
+	if (keys.empty()) return;
+
+	std::sort(keys.begin(), keys.end());
+
+	if (FILE* fp = fopen(GetSelectorsPath().c_str(), "w")) {
+		for (uint64 key : keys)
+			fprintf(fp, "%016llx\n", (unsigned long long)key);
+
+		fclose(fp);
+	}
+}
+
 void GSRendererOGL::SetupIA(const float& sx, const float& sy)
 {
 	GL_PUSH("IA");
@@ -117,6 +182,10 @@ void GSRendererOGL::SetupIA(const float& sx, const float& sy)
 	dev->IASetVertexBuffer(m_vertex.buff, m_vertex.next);
 	dev->IASetIndexBuffer(m_index.buff, m_index.tail);
 	dev->IASetPrimitiveTopology(t);
+
+	g_geometry_upload_call++;
+	g_geometry_upload_vertex_byte += m_vertex.next * sizeof(GSVertex);
+	g_geometry_upload_index_byte += m_index.tail * sizeof(uint32);
 }
 
 void GSRendererOGL::EmulateAtst(const int pass, const GSTextureCache::Source* tex)
@@ -807,8 +876,12 @@ void GSRendererOGL::EmulateTextureSampler(const GSTextureCache::Source* tex)
 	}
 
 	// Setup Texture ressources
-	dev->SetupSampler(m_ps_ssel);
-	dev->PSSetShaderResources(tex->m_texture, tex->m_palette);
+	if (dev->IsBindless()) {
+		ps_cb.TexHandle = dev->GetTextureHandles(tex->m_texture, m_ps_ssel, tex->m_palette);
+	} else {
+		dev->SetupSampler(m_ps_ssel);
+		dev->PSSetShaderResources(tex->m_texture, tex->m_palette);
+	}
 }
 
 GSRendererOGL::PRIM_OVERLAP GSRendererOGL::PrimitiveOverlap()
@@ -1127,6 +1200,7 @@ void GSRendererOGL::DrawPrims(GSTexture* rt, GSTexture* ds, GSTextureCache::Sour
 		// Reduce the quantity of clean function
 		glScissor( dRect.x, dRect.y, dRect.width(), dRect.height() );
 		GLState::scissor = dRect;
+		GLState::state_call[GLState::CALL_VIEWPORT]++;
 
 		// Must be done here to avoid any GL state pertubation (clear function...)
 		// Create an r32ui image that will containt primitive ID
@@ -1280,7 +1354,10 @@ void GSRendererOGL::DrawPrims(GSTexture* rt, GSTexture* ds, GSTextureCache::Sour
 			if (!tex->m_palette) {
 				uint16 pal = GSLocalMemory::m_psm[tex->m_TEX0.PSM].pal;
 				m_tc->AttachPaletteToSource(tex, pal, true);
-				dev->PSSetShaderResource(1, tex->m_palette);
+				if (dev->IsBindless())
+					ps_cb.TexHandle = dev->GetTextureHandles(tex->m_texture, m_ps_ssel, tex->m_palette);
+				else
+					dev->PSSetShaderResource(1, tex->m_palette);
 			}
 		}
 	}
@@ -1296,15 +1373,25 @@ void GSRendererOGL::DrawPrims(GSTexture* rt, GSTexture* ds, GSTextureCache::Sour
 
 	dev->SetupCB(&vs_cb, &ps_cb);
 
+	// The pixel shader is still compiled by the driver. Drop the draw rather than stalling
+	// the GS thread, the effect will be missing for a couple of frames at most.
+	if (!dev->IsPSReady(m_ps_sel)) {
+		GL_PERF("Skip draw: pixel shader is not ready");
+		if (DATE_GL42)
+			dev->RecycleDateTexture();
+		dev->EndScene();
+		return;
+	}
+
 	dev->SetupPipeline(m_vs_sel, m_gs_sel, m_ps_sel);
 
 	GSVector4i commitRect = ComputeBoundingBox(rtscale, rtsize);
 
 	if (rt)
-		rt->CommitRegion(GSVector2i(commitRect.z, commitRect.w));
+		rt->CommitRect(commitRect);
 
 	if (ds)
-		ds->CommitRegion(GSVector2i(commitRect.z, commitRect.w));
+		ds->CommitRect(commitRect);
 
 	if (DATE_GL42) {
 		GL_PUSH("Date GL42");
@@ -1321,12 +1408,18 @@ void GSRendererOGL::DrawPrims(GSTexture* rt, GSTexture* ds, GSTextureCache::Sour
 
 		// Don't write anything on the color buffer
 		// Neither in the depth buffer
-		glDepthMask(false);
+		if (GLState::depth_mask) {
+			glDepthMask(false);
+			GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
+		}
 		// Compute primitiveID max that pass the date test (Draw without barrier)
 		dev->DrawIndexedPrimitive();
 
 		// Ask PS to discard shader above the primitiveID max
-		glDepthMask(GLState::depth_mask);
+		if (GLState::depth_mask) {
+			glDepthMask(true);
+			GLState::state_call[GLState::CALL_DEPTH_STENCIL]++;
+		}
 
 		m_ps_sel.date = 3;
 		dev->SetupPipeline(m_vs_sel, m_gs_sel, m_ps_sel);
@@ -78,9 +78,15 @@ class GSRendererOGL final : public GSRendererHW
 		inline void EmulateAtst(const int pass, const GSTextureCache::Source* tex);
 		inline void EmulateZbuffer();
 
+		std::string GetSelectorsPath() const;
+		void LoadSelectors();
+		void SaveSelectors();
+
 	public:
 		GSRendererOGL();
-		virtual ~GSRendererOGL() {};
+		virtual ~GSRendererOGL();
+
+		void SetGameCRC(uint32 crc, int options) final;
 
 		bool CreateDevice(GSDevice* dev);
 
@@ -29,12 +29,51 @@
 #include "GSdxResources.h"
 #endif
 
+static const uint32 s_binary_cache_magic   = 0x4C475347; // "GSGL"
+static const uint32 s_binary_cache_version = 1;
+static const uint32 s_binary_cache_max_blob = 16 * 1024 * 1024; // way above any driver's program
+
+static uint64 HashBytes(uint64 h, const void* data, size_t size)
+{
+	const uint8* p = static_cast<const uint8*>(data);
+	for (size_t i = 0; i < size; i++) {
+		h ^= p[i];
+		h *= 0x100000001b3ull; // FNV-1a
+	}
+	return h;
+}
+
+static uint64 HashString(uint64 h, const char* s)
+{
+	return s ? HashBytes(h, s, strlen(s)) : h;
+}
+
 GSShaderOGL::GSShaderOGL(bool debug) :
 	m_pipeline(0),
-	m_debug_shader(debug)
+	m_debug_shader(debug),
+	m_binary_cache_driver(0),
+	m_binary_cache_dirty(false),
+	m_async(false),
+	m_compiles(0)
 {
 	theApp.LoadResource(IDR_COMMON_GLSL, m_common_header);
 
+	// glProgramBinary is core in GL4.1 but a driver can still expose zero binary formats
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	if (theApp.GetConfigB("shader_cache") && formats > 0 && !GLLoader::in_replayer) {
+		m_binary_cache_file = theApp.GetConfigDir() + "GSdx_gl_shader_cache.bin";
+		LoadBinaryCache();
+	}
+
+	// Let the driver compile the shaders on its own threads. Draws that need a program which
+	// isn't ready yet are skipped by the renderer, so it is only an option.
+	if (theApp.GetConfigB("async_shader_compile") && GLLoader::found_GL_ARB_parallel_shader_compile
+			&& !GLLoader::buggy_sso_dual_src && !GLLoader::in_replayer) {
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+		m_async = true;
+	}
+
 	// Create a default pipeline
 	m_pipeline = LinkPipeline("HW pipe", 0, 0, 0);
 	BindPipeline(m_pipeline);
@@ -42,6 +81,8 @@ GSShaderOGL::GSShaderOGL(bool debug) :
 
 GSShaderOGL::~GSShaderOGL()
 {
+	SaveBinaryCache();
+
 	printf("Delete %zu Shaders, %zu Programs, %zu Pipelines\n",
 			m_shad_to_delete.size(), m_prog_to_delete.size(), m_pipe_to_delete.size());
 
@@ -93,6 +134,7 @@ void GSShaderOGL::BindProgram(GLuint vs, GLuint gs, GLuint ps)
 
 	if (GLState::program != p) {
 		GLState::program = p;
+		GLState::state_call[GLState::CALL_PROGRAM]++;
 		glUseProgram(p);
 	}
 }
@@ -101,6 +143,7 @@ void GSShaderOGL::BindProgram(GLuint p)
 {
 	if (GLState::program != p) {
 		GLState::program = p;
+		GLState::state_call[GLState::CALL_PROGRAM]++;
 		glUseProgram(p);
 	}
 }
@@ -111,11 +154,13 @@ void GSShaderOGL::BindPipeline(GLuint vs, GLuint gs, GLuint ps)
 
 	if (GLState::vs != vs) {
 		GLState::vs = vs;
+		GLState::state_call[GLState::CALL_PROGRAM]++;
 		glUseProgramStages(m_pipeline, GL_VERTEX_SHADER_BIT, vs);
 	}
 
 	if (GLState::gs != gs) {
 		GLState::gs = gs;
+		GLState::state_call[GLState::CALL_PROGRAM]++;
 		glUseProgramStages(m_pipeline, GL_GEOMETRY_SHADER_BIT, gs);
 	}
 
@@ -127,6 +172,7 @@ void GSShaderOGL::BindPipeline(GLuint vs, GLuint gs, GLuint ps)
 #endif
 	{
 		GLState::ps = ps;
+		GLState::state_call[GLState::CALL_PROGRAM]++;
 		glUseProgramStages(m_pipeline, GL_FRAGMENT_SHADER_BIT, ps);
 	}
 }
@@ -135,11 +181,13 @@ void GSShaderOGL::BindPipeline(GLuint pipe)
 {
 	if (GLState::pipeline != pipe) {
 		GLState::pipeline = pipe;
+		GLState::state_call[GLState::CALL_PROGRAM]++;
 		glBindProgramPipeline(pipe);
 	}
 
 	if (GLState::program) {
 		GLState::program = 0;
+		GLState::state_call[GLState::CALL_PROGRAM]++;
 		glUseProgram(0);
 	}
 }
@@ -272,7 +320,25 @@ GLuint GSShaderOGL::Compile(const std::string& glsl_file, const std::string& ent
 	sources[1] = m_common_header.data();
 	sources[2] = glsl_h_code;
 
-	program = glCreateShaderProgramv(type, shader_nb, sources);
+	uint64 key = 0;
+	if (!m_binary_cache_file.empty()) {
+		key = HashBytes(0xcbf29ce484222325ull, &type, sizeof(type));
+		for (int i = 0; i < shader_nb; i++)
+			key = HashString(key, sources[i]);
+
+		program = LoadProgramBinary(key);
+		if (program) {
+			m_prog_to_delete.push_back(program);
+			return program;
+		}
+
+		program = CreateRetrievableProgram(type, shader_nb, sources);
+		StoreProgramBinary(key, program);
+	} else {
+		program = glCreateShaderProgramv(type, shader_nb, sources);
+	}
+
+	m_compiles++;
 
 	bool status = ValidateProgram(program);
 
@@ -310,6 +376,8 @@ GLuint GSShaderOGL::CompileShader(const std::string& glsl_file, const std::strin
 	glShaderSource(shader, shader_nb, sources, NULL);
 	glCompileShader(shader);
 
+	m_compiles++;
+
 	bool status = ValidateShader(shader);
 
 	if (!status) {
@@ -324,6 +392,222 @@ GLuint GSShaderOGL::CompileShader(const std::string& glsl_file, const std::strin
 	return shader;
 }
 
+GLuint GSShaderOGL::CompileAsync(const std::string& glsl_file, const std::string& entry, GLenum type, const char* glsl_h_code, const std::string& macro_sel)
+{
+	if (!m_async)
+		return Compile(glsl_file, entry, type, glsl_h_code, macro_sel);
+
+	ASSERT(glsl_h_code != NULL);
+
+	const int shader_nb = 3;
+	const char* sources[shader_nb];
+
+	std::string header = GenGlslHeader(entry, type, macro_sel);
+
+	sources[0] = header.c_str();
+	sources[1] = m_common_header.data();
+	sources[2] = glsl_h_code;
+
+	uint64 key = 0;
+	if (!m_binary_cache_file.empty()) {
+		key = HashBytes(0xcbf29ce484222325ull, &type, sizeof(type));
+		for (int i = 0; i < shader_nb; i++)
+			key = HashString(key, sources[i]);
+
+		GLuint program = LoadProgramBinary(key);
+		if (program) {
+			m_prog_to_delete.push_back(program);
+			return program;
+		}
+	}
+
+	// Same as CreateRetrievableProgram but without any status query: the compile and
+	// link calls return immediately and the result is polled by IsProgramReady.
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, shader_nb, sources, NULL);
+	glCompileShader(shader);
+
+	m_compiles++;
+
+	GLuint program = glCreateProgram();
+	glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+	if (key)
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	glAttachShader(program, shader);
+	glLinkProgram(program);
+	// Shader is only flagged for deletion, it is released with the program
+	glDeleteShader(shader);
+
+	m_pending[program] = key;
+	m_prog_to_delete.push_back(program);
+
+	return program;
+}
+
+bool GSShaderOGL::IsProgramReady(GLuint p)
+{
+	auto i = m_pending.find(p);
+	if (i == m_pending.end())
+		return true;
+
+	GLint done = 0;
+	glGetProgramiv(p, GL_COMPLETION_STATUS_ARB, &done);
+	if (!done)
+		return false;
+
+	if (!ValidateProgram(p))
+		fprintf(stderr, "Asynchronous compilation of prog %d failed\n", p);
+
+	if (i->second)
+		StoreProgramBinary(i->second, p);
+
+	m_pending.erase(i);
+
+	return true;
+}
+
+// Equivalent of glCreateShaderProgramv but the retrievable hint must be set before the link
+GLuint GSShaderOGL::CreateRetrievableProgram(GLenum type, int count, const char** sources)
+{
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, count, sources, NULL);
+	glCompileShader(shader);
+	ValidateShader(shader);
+
+	GLuint program = glCreateProgram();
+	glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+	glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	GLint compiled = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (compiled) {
+		glAttachShader(program, shader);
+		glLinkProgram(program);
+		glDetachShader(program, shader);
+	}
+	glDeleteShader(shader);
+
+	return program;
+}
+
+GLuint GSShaderOGL::LoadProgramBinary(uint64 key)
+{
+	auto it = m_binary_cache.find(key);
+	if (it == m_binary_cache.end())
+		return 0;
+
+	GLuint program = glCreateProgram();
+	glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+	glProgramBinary(program, it->second.format, it->second.data.data(), it->second.data.size());
+
+	GLint status = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!status) {
+		// The driver rejected it (e.g. updated without changing its version string). Recompile
+		glDeleteProgram(program);
+		m_binary_cache.erase(it);
+		m_binary_cache_dirty = true;
+		return 0;
+	}
+
+	return program;
+}
+
+void GSShaderOGL::StoreProgramBinary(uint64 key, GLuint p)
+{
+	GLint status = 0;
+	GLint length = 0;
+	glGetProgramiv(p, GL_LINK_STATUS, &status);
+	glGetProgramiv(p, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (!status || length <= 0)
+		return;
+
+	ProgramBinary& bin = m_binary_cache[key];
+	bin.data.resize(length);
+	glGetProgramBinary(p, length, NULL, &bin.format, bin.data.data());
+	m_binary_cache_dirty = true;
+}
+
+void GSShaderOGL::LoadBinaryCache()
+{
+	m_binary_cache_driver = HashString(0xcbf29ce484222325ull, (const char*)glGetString(GL_VENDOR));
+	m_binary_cache_driver = HashString(m_binary_cache_driver, (const char*)glGetString(GL_RENDERER));
+	m_binary_cache_driver = HashString(m_binary_cache_driver, (const char*)glGetString(GL_VERSION));
+
+	FILE* fp = px_fopen(m_binary_cache_file, "rb");
+	if (!fp)
+		return;
+
+	fseek(fp, 0, SEEK_END);
+	long remaining = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	uint32 header[2] = {};
+	uint64 driver = 0;
+	if (fread(header, sizeof(header), 1, fp) != 1 || fread(&driver, sizeof(driver), 1, fp) != 1
+		|| header[0] != s_binary_cache_magic || header[1] != s_binary_cache_version || driver != m_binary_cache_driver) {
+		fprintf(stdout, "Shader cache %s is outdated, it will be rebuilt\n", m_binary_cache_file.c_str());
+		fclose(fp);
+		return;
+	}
+
+	remaining -= sizeof(header) + sizeof(driver);
+
+	uint64 key;
+	uint32 entry[2]; // format, size
+	while (fread(&key, sizeof(key), 1, fp) == 1 && fread(entry, sizeof(entry), 1, fp) == 1) {
+		remaining -= sizeof(key) + sizeof(entry);
+
+		// A truncated or corrupted file, don't trust any of it
+		if (entry[1] > s_binary_cache_max_blob || (long)entry[1] > remaining) {
+			fprintf(stderr, "Shader cache %s is corrupted, it will be rebuilt\n", m_binary_cache_file.c_str());
+			m_binary_cache.clear();
+			break;
+		}
+
+		ProgramBinary& bin = m_binary_cache[key];
+		bin.format = entry[0];
+		bin.data.resize(entry[1]);
+		if (entry[1] && fread(bin.data.data(), entry[1], 1, fp) != 1) {
+			m_binary_cache.erase(key);
+			break;
+		}
+
+		remaining -= entry[1];
+	}
+
+	fclose(fp);
+
+	fprintf(stdout, "Loaded %zu programs from shader cache\n", m_binary_cache.size());
+}
+
+void GSShaderOGL::SaveBinaryCache()
+{
+	if (m_binary_cache_file.empty() || !m_binary_cache_dirty)
+		return;
+
+	FILE* fp = px_fopen(m_binary_cache_file, "wb");
+	if (!fp) {
+		fprintf(stderr, "Failed to write shader cache %s\n", m_binary_cache_file.c_str());
+		return;
+	}
+
+	const uint32 header[2] = {s_binary_cache_magic, s_binary_cache_version};
+	fwrite(header, sizeof(header), 1, fp);
+	fwrite(&m_binary_cache_driver, sizeof(m_binary_cache_driver), 1, fp);
+
+	for (const auto& it : m_binary_cache) {
+		const uint32 entry[2] = {it.second.format, static_cast<uint32>(it.second.data.size())};
+		fwrite(&it.first, sizeof(it.first), 1, fp);
+		fwrite(entry, sizeof(entry), 1, fp);
+		fwrite(it.second.data.data(), it.second.data.size(), 1, fp);
+	}
+
+	fclose(fp);
+	m_binary_cache_dirty = false;
+}
+
 // This function will get the binary program. Normally it must be used a caching
 // solution but Nvidia also incorporates the ASM dump. Asm is nice because it allow
 // to have an overview of the program performance based on the instruction number
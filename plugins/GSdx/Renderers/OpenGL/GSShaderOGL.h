@@ -22,10 +22,35 @@
 #pragma once
 
 class GSShaderOGL {
+	struct ProgramBinary {
+		GLenum format;
+		std::vector<char> data;
+	};
+
 	GLuint m_pipeline;
 	std::unordered_map<uint32, GLuint> m_program;
 	const bool m_debug_shader;
 
+	// Persistent cache of separable program binaries, keyed by a hash of the shader sources.
+	// The file is only valid for the driver (vendor/renderer/version) that wrote it.
+	std::unordered_map<uint64, ProgramBinary> m_binary_cache;
+	std::string m_binary_cache_file;
+	uint64 m_binary_cache_driver;
+	bool m_binary_cache_dirty;
+
+	void LoadBinaryCache();
+	void SaveBinaryCache();
+	GLuint LoadProgramBinary(uint64 key);
+	GLuint CreateRetrievableProgram(GLenum type, int count, const char** sources);
+	void StoreProgramBinary(uint64 key, GLuint p);
+
+	// Programs still being built by the driver threads (GL_ARB_parallel_shader_compile).
+	// Value is the binary cache key (0 when the cache is disabled).
+	bool m_async;
+	std::unordered_map<GLuint, uint64> m_pending;
+
+	uint32 m_compiles;
+
 	std::vector<GLuint> m_shad_to_delete;
 	std::vector<GLuint> m_prog_to_delete;
 	std::vector<GLuint> m_pipe_to_delete;
@@ -45,6 +70,10 @@ class GSShaderOGL {
 	void BindPipeline(GLuint pipe);
 
 	GLuint Compile(const std::string& glsl_file, const std::string& entry, GLenum type, const char* glsl_h_code, const std::string& macro_sel = "");
+	GLuint CompileAsync(const std::string& glsl_file, const std::string& entry, GLenum type, const char* glsl_h_code, const std::string& macro_sel = "");
+	bool IsAsync() const { return m_async; }
+	bool IsProgramReady(GLuint p);
+	uint32 GetCompiles() const { return m_compiles; }
 	GLuint LinkPipeline(const std::string& pretty_print, GLuint vs, GLuint gs, GLuint ps);
 
 	// Same as above but for not separated build
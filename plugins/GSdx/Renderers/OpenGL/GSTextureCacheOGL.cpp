@@ -78,6 +78,8 @@ void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
 
 	if(GSTexture* offscreen = m_renderer->m_dev->CopyOffscreen(t->m_texture, src, r.width(), r.height(), fmt, ps_shader))
 	{
+		m_renderer->m_perfmon.Put(GSPerfMon::Readback, 1);
+
 		GSTexture::GSMap m;
 		GSVector4i r_offscreen(0, 0, r.width(), r.height());
 
@@ -124,6 +126,8 @@ void GSTextureCacheOGL::Read(Source* t, const GSVector4i& r)
 	// Note: With openGL 4.5 you can use glGetTextureSubImage
 
 	if (GSTexture* offscreen  = m_renderer->m_dev->CreateOffscreen(r.width(), r.height())) {
+		m_renderer->m_perfmon.Put(GSPerfMon::Readback, 1);
+
 		m_renderer->m_dev->CopyRect(t->m_texture, offscreen, r);
 
 		GSTexture::GSMap m;
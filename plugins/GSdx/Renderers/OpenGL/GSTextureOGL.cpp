@@ -29,6 +29,9 @@
 extern uint64 g_real_texture_upload_byte;
 #endif
 
+extern uint64 g_texture_upload_call;
+extern uint64 g_texture_upload_byte;
+
 // FIXME OGL4: investigate, only 1 unpack buffer always bound
 namespace PboPool {
 
@@ -373,6 +376,9 @@ bool GSTextureOGL::Update(const GSVector4i& r, const void* data, int pitch, int
 	g_real_texture_upload_byte += map_size;
 #endif
 
+	g_texture_upload_call++;
+	g_texture_upload_byte += map_size;
+
 #if 0
 	if (r.height() == 1) {
 		// Palette data. Transfer is small either 64B or 1024B.
@@ -399,12 +405,16 @@ bool GSTextureOGL::Update(const GSVector4i& r, const void* data, int pitch, int
 	char* src = (char*)data;
 	char* map = PboPool::Map(map_size);
 
-	// PERF: slow path of the texture upload. Dunno if we could do better maybe check if TC can keep row_byte == pitch
-	// Note: row_byte != pitch
-	for (int h = 0; h < r.height(); h++) {
-		memcpy(map, src, row_byte);
-		map += row_byte;
-		src += pitch;
+	if (row_byte == (uint32)pitch) {
+		// Full width update (or a tightly packed source), one copy is enough
+		memcpy(map, src, map_size);
+	} else {
+		// PERF: slow path of the texture upload. Dunno if we could do better maybe check if TC can keep row_byte == pitch
+		for (int h = 0; h < r.height(); h++) {
+			memcpy(map, src, row_byte);
+			map += row_byte;
+			src += pitch;
+		}
 	}
 
 	PboPool::Unmap();
@@ -475,6 +485,9 @@ bool GSTextureOGL::Map(GSMap& m, const GSVector4i* _r, int layer)
 	g_real_texture_upload_byte += map_size;
 #endif
 
+		g_texture_upload_call++;
+		g_texture_upload_byte += map_size;
+
 		// Save the area for the unmap
 		m_r_x = r.x;
 		m_r_y = r.y;
@@ -515,36 +528,25 @@ void GSTextureOGL::GenerateMipmap()
 	}
 }
 
-void GSTextureOGL::CommitPages(const GSVector2i& region, bool commit)
+void GSTextureOGL::CommitPages(const GSVector4i& r, bool commit)
 {
 	GLState::available_vram += m_mem_usage;
 
 	if (commit) {
-		if (m_committed_size.x == 0) {
-			// Nothing allocated so far
-			GL_INS("CommitPages initial %dx%d of %u", region.x, region.y, m_texture_id);
-			glTexturePageCommitmentEXT(m_texture_id, GL_TEX_LEVEL_0, 0, 0, 0, region.x, region.y, 1, commit);
-		} else {
-			GL_INS("CommitPages extend %dx%d to %dx%d of %u", m_committed_size.x, m_committed_size.y, region.x, region.y, m_texture_id);
-			int w = region.x - m_committed_size.x;
-			int h = region.y - m_committed_size.y;
-			// Extend width
-			glTexturePageCommitmentEXT(m_texture_id, GL_TEX_LEVEL_0, m_committed_size.x, 0, 0, w, m_committed_size.y, 1, commit);
-			// Extend height
-			glTexturePageCommitmentEXT(m_texture_id, GL_TEX_LEVEL_0, 0, m_committed_size.y, 0, region.x, h, 1, commit);
-		}
-		m_committed_size = region;
+		GL_INS("CommitPages %d,%d => %d,%d of %u", r.x, r.y, r.z, r.w, m_texture_id);
+
+		glTexturePageCommitmentEXT(m_texture_id, GL_TEX_LEVEL_0, r.x, r.y, 0, r.width(), r.height(), 1, commit);
 
+		// Content of freshly committed pages is undefined
+		Clear(NULL, r);
 	} else {
 		// Release everything
 		GL_INS("CommitPages release of %u", m_texture_id);
 
-		glTexturePageCommitmentEXT(m_texture_id, GL_TEX_LEVEL_0, 0, 0, 0, m_committed_size.x, m_committed_size.y, 1, commit);
-
-		m_committed_size = GSVector2i(0, 0);
+		glTexturePageCommitmentEXT(m_texture_id, GL_TEX_LEVEL_0, r.x, r.y, 0, r.width(), r.height(), 1, commit);
 	}
 
-	m_mem_usage = (m_committed_size.x * m_committed_size.y) << m_int_shift;
+	m_mem_usage = (m_committed_count * (m_gpu_page_size.x + 1) * (m_gpu_page_size.y + 1)) << m_int_shift;
 	GLState::available_vram -= m_mem_usage;
 }
 
@@ -603,7 +605,29 @@ bool GSTextureOGL::Save(const std::string& fn)
 	return GSPng::Save(fmt, fn, image.get(), m_committed_size.x, m_committed_size.y, pitch, compression);
 }
 
+GLuint64 GSTextureOGL::GetHandle(GLuint sampler)
+{
+	for (const auto& h : m_handles) {
+		if (h.first == sampler)
+			return h.second;
+	}
+
+	// The texture (and sampler) parameters are frozen from now on. The handle stays resident
+	// until the texture is deleted, which releases it.
+	GLuint64 handle = glGetTextureSamplerHandleARB(m_texture_id, sampler);
+	glMakeTextureHandleResidentARB(handle);
+
+	m_handles.push_back(std::make_pair(sampler, handle));
+
+	return handle;
+}
+
 uint32 GSTextureOGL::GetMemUsage()
 {
 	return m_mem_usage;
 }
+
+uint32 GSTextureOGL::GetVirtualMemUsage()
+{
+	return (m_size.x * m_size.y) << m_int_shift;
+}
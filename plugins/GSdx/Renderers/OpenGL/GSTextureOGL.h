@@ -63,6 +63,9 @@ class GSTextureOGL final : public GSTexture
 		// Allow to track size of allocated memory
 		uint32 m_mem_usage;
 
+		// Bindless handles of the texture, one per sampler it was used with
+		std::vector<std::pair<GLuint, GLuint64>> m_handles;
+
 	public:
 		explicit GSTextureOGL(int type, int w, int h, int format, GLuint fbo_read, bool mipmap);
 		virtual ~GSTextureOGL();
@@ -77,6 +80,7 @@ class GSTextureOGL final : public GSTexture
 		bool IsDss() { return (m_type == GSTexture::DepthStencil || m_type == GSTexture::SparseDepthStencil); }
 
 		uint32 GetID() final { return m_texture_id; }
+		GLuint64 GetHandle(GLuint sampler);
 		bool HasBeenCleaned() { return m_clean; }
 		void WasAttached() { m_clean = false; }
 		void WasCleaned() { m_clean = true; }
@@ -84,7 +88,8 @@ class GSTextureOGL final : public GSTexture
 		void Clear(const void* data);
 		void Clear(const void* data, const GSVector4i& area);
 
-		void CommitPages(const GSVector2i& region, bool commit) final;
+		void CommitPages(const GSVector4i& r, bool commit) final;
 
 		uint32 GetMemUsage();
+		uint32 GetVirtualMemUsage();
 };
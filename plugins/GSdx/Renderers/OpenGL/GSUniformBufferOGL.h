@@ -51,6 +51,7 @@ public:
 	{
 		if (GLState::ubo != m_buffer) {
 			GLState::ubo = m_buffer;
+			GLState::state_call[GLState::CALL_UBO]++;
 			glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
 		}
 	}
@@ -65,6 +66,7 @@ public:
 		// From the opengl manpage:
 		// glBindBufferBase also binds buffer to the generic buffer binding point specified by target
 		GLState::ubo = m_buffer;
+		GLState::state_call[GLState::CALL_UBO]++;
 		glBindBufferBase(GL_UNIFORM_BUFFER, m_index, m_buffer);
 	}
 
@@ -75,6 +77,7 @@ public:
 		// synchronous whereas glBufferSubData could be asynchronous.
 		// TODO: investigate the extension ARB_invalidate_subdata
 		glBufferSubData(GL_UNIFORM_BUFFER, 0, m_size, src);
+		GLState::state_call[GLState::CALL_UBO]++;
 #ifdef ENABLE_OGL_DEBUG_MEM_BW
 		g_uniform_upload_byte += m_size;
 #endif
@@ -118,6 +121,7 @@ public:
 	{
 		if (GLState::ubo != m_buffer) {
 			GLState::ubo = m_buffer;
+			GLState::state_call[GLState::CALL_UBO]++;
 			glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
 		}
 	}
@@ -139,6 +143,7 @@ public:
 		// From the opengl manpage:
 		// glBindBufferBase also binds buffer to the generic buffer binding point specified by target
 		GLState::ubo = m_buffer;
+		GLState::state_call[GLState::CALL_UBO]++;
 		//glBindBufferBase(GL_UNIFORM_BUFFER, m_index, m_buffer);
 		glBindBufferRange(GL_UNIFORM_BUFFER, m_index, m_buffer, m_offset, m_size);
 	}
@@ -153,6 +158,7 @@ public:
 
 		attach();
 		glFlushMappedBufferRange(GL_UNIFORM_BUFFER, m_offset, m_size);
+		GLState::state_call[GLState::CALL_UBO]++;
 
 		m_offset = (m_offset + m_size + 255u) & ~0xFF;
 		if (m_offset >= UBO_BUFFER_SIZE)
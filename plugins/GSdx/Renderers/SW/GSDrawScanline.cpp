@@ -89,24 +89,42 @@ void GSDrawScanline::BeginDraw(const GSRasterizerData* data)
 		m_dr = NULL;
 	}
 
+	m_sp = m_sp_map[GetSetupPrimKey(m_global.sel)];
+}
+
+uint64 GSDrawScanline::GetSetupPrimKey(const GSScanlineSelector& global)
+{
 	// doesn't need all bits => less functions generated
 
 	GSScanlineSelector sel;
 
 	sel.key = 0;
 
-	sel.iip = m_global.sel.iip;
-	sel.tfx = m_global.sel.tfx;
-	sel.tcc = m_global.sel.tcc;
-	sel.fst = m_global.sel.fst;
-	sel.fge = m_global.sel.fge;
-	sel.prim = m_global.sel.prim;
-	sel.fb = m_global.sel.fb;
-	sel.zb = m_global.sel.zb;
-	sel.zoverflow = m_global.sel.zoverflow;
-	sel.notest = m_global.sel.notest;
-
-	m_sp = m_sp_map[sel];
+	sel.iip = global.iip;
+	sel.tfx = global.tfx;
+	sel.tcc = global.tcc;
+	sel.fst = global.fst;
+	sel.fge = global.fge;
+	sel.prim = global.prim;
+	sel.fb = global.fb;
+	sel.zb = global.zb;
+	sel.zoverflow = global.zoverflow;
+	sel.notest = global.notest;
+
+	return sel;
+}
+
+void GSDrawScanline::Prewarm(const std::vector<uint64>& keys)
+{
+	for(uint64 key : keys)
+	{
+		GSScanlineSelector sel;
+
+		sel.key = key;
+
+		m_ds_map.Prewarm(sel);
+		m_sp_map.Prewarm(GetSetupPrimKey(sel));
+	}
 }
 
 void GSDrawScanline::EndDraw(uint64 frame, uint64 ticks, int actual, int total)
@@ -43,6 +43,8 @@ protected:
 	GSCodeGeneratorFunctionMap<GSSetupPrimCodeGenerator, uint64, SetupPrimPtr> m_sp_map;
 	GSCodeGeneratorFunctionMap<GSDrawScanlineCodeGenerator, uint64, DrawScanlinePtr> m_ds_map;
 
+	static uint64 GetSetupPrimKey(const GSScanlineSelector& sel);
+
 	template<class T, bool masked>
 	void DrawRectT(const int* RESTRICT row, const int* RESTRICT col, const GSVector4i& r, uint32 c, uint32 m);
 
@@ -87,4 +89,7 @@ public:
 #endif
 
 	void PrintStats() {m_ds_map.PrintStats();}
+
+	void Prewarm(const std::vector<uint64>& keys);
+	void GetSelectors(std::vector<uint64>& keys) {m_ds_map.GetKeys(keys);}
 };
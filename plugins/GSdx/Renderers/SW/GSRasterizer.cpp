@@ -24,6 +24,16 @@
 #include "stdafx.h"
 #include "GSRasterizer.h"
 
+#include <iterator>
+#include <sstream>
+
+#ifdef __linux__
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
 int GSRasterizerData::s_counter = 0;
 
 static int compute_best_thread_height(int threads) {
@@ -135,6 +145,13 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 {
 	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
 
+	if(!data->prewarm.empty())
+	{
+		m_ds->Prewarm(data->prewarm);
+
+		return;
+	}
+
 	if(data->vertex != NULL && data->vertex_count == 0 || data->index != NULL && data->index_count == 0) return;
 
 	m_pixels.actual = 0;
@@ -435,6 +452,10 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const uint32* index)
 	GSVector4 tbmin = tbf.min(m_fscissor_y);
 	GSVector4i tb = GSVector4i(tbmax.xzyw(tbmin)); // max(y0, t) max(y1, t) min(y1, b) min(y2, b)
 
+	// nothing to draw on this thread's rows, skip the setup (edges may reach further, keep them)
+
+	if(m_threads > 1 && !m_ds->HasEdge() && (tb.x >= tb.w || !IsOneOfMyScanlines(tb.x, tb.w))) return;
+
 	dv[0] = v1 - v0;
 	dv[1] = v2 - v0;
 	dv[2] = v2 - v1;
@@ -622,6 +643,10 @@ void GSRasterizer::DrawTriangle(const GSVertexSW* vertex, const uint32* index)
 	GSVector4 tbmin = tbf.min(m_fscissor_y);
 	GSVector4i tb = GSVector4i(tbmax.xzyw(tbmin)); // max(y0, t) max(y1, t) min(y1, b) min(y2, b)
 
+	// nothing to draw on this thread's rows, skip the setup (edges may reach further, keep them)
+
+	if(m_threads > 1 && !m_ds->HasEdge() && (tb.x >= tb.w || !IsOneOfMyScanlines(tb.x, tb.w))) return;
+
 	dv[0] = v1 - v0;
 	dv[1] = v2 - v0;
 	dv[2] = v2 - v1;
@@ -797,6 +822,8 @@ void GSRasterizer::DrawSprite(const GSVertexSW* vertex, const uint32* index)
 
 	if(r.rempty()) return;
 
+	if(m_threads > 1 && !IsOneOfMyScanlines(r.top, r.bottom)) return;
+
 	GSVertexSW scan = v[0];
 
 	if(m_ds->IsSolidRect())
@@ -1161,6 +1188,228 @@ GSRasterizerList::~GSRasterizerList()
 	_aligned_free(m_scanline);
 }
 
+// cpu lists are comma separated ranges, such as "0-15,32-47" (also the sysfs format)
+
+static std::set<int> ParseCpuList(const std::string& list)
+{
+	std::set<int> cpus;
+	std::istringstream s(list);
+	std::string range;
+
+	while(std::getline(s, range, ','))
+	{
+		int first = 0, last = 0;
+
+		switch(sscanf(range.c_str(), "%d-%d", &first, &last))
+		{
+		case 1: last = first; // fall through
+		case 2: for(int i = first; i <= last; i++) cpus.insert(i); break;
+		default: break;
+		}
+	}
+
+	return cpus;
+}
+
+static std::string FormatCpuList(const std::set<int>& cpus)
+{
+	std::string s;
+
+	for(auto i = cpus.begin(); i != cpus.end(); )
+	{
+		int first = *i, last = first;
+
+		while(++i != cpus.end() && *i == last + 1) last++;
+
+		s += (s.empty() ? "" : ",") + (first == last ? format("%d", first) : format("%d-%d", first, last));
+	}
+
+	return s;
+}
+
+#ifdef __linux__
+
+static std::set<int> ReadCpuList(const std::string& path)
+{
+	std::ifstream file(path);
+	std::string list;
+
+	std::getline(file, list);
+
+	return ParseCpuList(list);
+}
+
+#endif
+
+static std::set<int> GetNumaNodeCpus(int node)
+{
+#ifdef _WIN32
+
+	std::set<int> cpus;
+	ULONGLONG mask = 0;
+
+	if(node <= 255 && GetNumaNodeProcessorMask((UCHAR)node, &mask))
+	{
+		for(int i = 0; i < 64; i++) if(mask & (1ull << i)) cpus.insert(i);
+	}
+
+	return cpus;
+
+#elif defined(__linux__)
+
+	return ReadCpuList(format("/sys/devices/system/node/node%d/cpulist", node));
+
+#else
+
+	return std::set<int>();
+
+#endif
+}
+
+// the first logical cpu of each physical core
+
+static std::set<int> GetCoreCpus()
+{
+	std::set<int> cpus;
+
+#ifdef _WIN32
+
+	DWORD size = 0;
+
+	GetLogicalProcessorInformation(NULL, &size);
+
+	std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+
+	if(!info.empty() && GetLogicalProcessorInformation(info.data(), &size))
+	{
+		for(const auto& i : info)
+		{
+			if(i.Relationship != RelationProcessorCore) continue;
+
+			for(int j = 0; j < 64; j++) if(i.ProcessorMask & (1ull << j)) {cpus.insert(j); break;}
+		}
+	}
+
+#elif defined(__linux__)
+
+	for(int i = 0; i < CPU_SETSIZE; i++)
+	{
+		std::set<int> siblings = ReadCpuList(format("/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", i));
+
+		if(siblings.empty()) break;
+
+		cpus.insert(*siblings.begin());
+	}
+
+#endif
+
+	return cpus;
+}
+
+static std::set<int> GetProcessCpus()
+{
+	std::set<int> cpus;
+
+#ifdef _WIN32
+
+	DWORD_PTR process = 0, system = 0;
+
+	GetProcessAffinityMask(GetCurrentProcess(), &process, &system);
+
+	for(int i = 0; i < (int)sizeof(process) * 8; i++) if(process & ((DWORD_PTR)1 << i)) cpus.insert(i);
+
+#elif defined(__linux__)
+
+	// the main thread's, the GS thread may have been placed by the emulator already
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	if(sched_getaffinity(getpid(), sizeof(set), &set) == 0)
+	{
+		for(int i = 0; i < CPU_SETSIZE; i++) if(CPU_ISSET(i, &set)) cpus.insert(i);
+	}
+
+#endif
+
+	return cpus;
+}
+
+// Where the workers and the calling (GS) thread run.  extrathreads_cpus is a cpu list,
+// extrathreads_numa_node keeps them on the node the GS local memory was first touched from,
+// and extrathreads_nosmt on one logical cpu per core, out of each other's SMT siblings.  Each
+// option narrows the set.  Without any, the workers get the cpus of the process, instead of
+// those of the thread that created them (the emulator's placement of its GS thread).
+
+void GSRasterizerList::SetAffinity()
+{
+	std::set<int> cpus = GetProcessCpus();
+
+	if(cpus.empty()) return;
+
+	bool placed = false;
+
+	auto narrow = [&](const std::set<int>& allowed, const char* what) -> bool
+	{
+		std::set<int> both;
+
+		std::set_intersection(cpus.begin(), cpus.end(), allowed.begin(), allowed.end(), std::inserter(both, both.begin()));
+
+		if(both.empty())
+		{
+			fprintf(stderr, "GSdx: %s leaves no cpu, rasterizer threads are not pinned\n", what);
+
+			return false;
+		}
+
+		cpus.swap(both);
+		placed = true;
+
+		return true;
+	};
+
+	std::string list = theApp.GetConfigS("extrathreads_cpus");
+	int node = theApp.GetConfigI("extrathreads_numa_node");
+
+	if(!list.empty() && !narrow(ParseCpuList(list), format("extrathreads_cpus %s", list.c_str()).c_str())) return;
+	if(node >= 0 && !narrow(GetNumaNodeCpus(node), format("NUMA node %d", node).c_str())) return;
+	if(theApp.GetConfigB("extrathreads_nosmt") && !narrow(GetCoreCpus(), "extrathreads_nosmt")) return;
+
+#ifdef _WIN32
+
+	DWORD_PTR mask = 0;
+
+	for(int i : cpus) if(i < (int)sizeof(mask) * 8) mask |= (DWORD_PTR)1 << i;
+
+	if(placed) SetThreadAffinityMask(GetCurrentThread(), mask);
+
+	for(auto& worker : m_workers)
+	{
+		SetThreadAffinityMask((HANDLE)worker->GetNativeHandle(), mask);
+	}
+
+#elif defined(__linux__)
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	for(int i : cpus) if(i < CPU_SETSIZE) CPU_SET(i, &set);
+
+	if(placed) pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+	for(auto& worker : m_workers)
+	{
+		pthread_setaffinity_np(worker->GetNativeHandle(), sizeof(set), &set);
+	}
+
+#endif
+
+	if(placed)
+	{
+		printf("GSdx: GS and %d rasterizer threads on cpus %s\n", (int)m_workers.size(), FormatCpuList(cpus).c_str());
+	}
+}
+
 void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 {
 	GSVector4i r = data->bbox.rintersect(data->scissor);
@@ -1176,6 +1425,32 @@ void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 	}
 }
 
+void GSRasterizerList::Prewarm(const std::vector<uint64>& keys)
+{
+	if(keys.empty()) return;
+
+	// every worker has its own functions, they compile them while they are still idle
+
+	std::shared_ptr<GSRasterizerData> data(new GSRasterizerData());
+
+	data->prewarm = keys;
+
+	for(size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i]->Push(data);
+	}
+}
+
+void GSRasterizerList::GetSelectors(std::vector<uint64>& keys)
+{
+	Sync();
+
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		m_r[i]->GetSelectors(keys);
+	}
+}
+
 void GSRasterizerList::Sync()
 {
 	if(!IsSynced())
@@ -45,6 +45,7 @@ public:
 	uint64 start;
 	int pixels;
 	int counter;
+	std::vector<uint64> prewarm; // selectors to compile ahead of time, nothing is drawn
 
 	GSRasterizerData() 
 		: scissor(GSVector4i::zero())
@@ -106,6 +107,9 @@ public:
 
 	virtual void PrintStats() = 0;
 
+	virtual void Prewarm(const std::vector<uint64>& keys) {}
+	virtual void GetSelectors(std::vector<uint64>& keys) {}
+
 	__forceinline bool HasEdge() const {return m_de != NULL;}
 	__forceinline bool IsSolidRect() const {return m_dr != NULL;}
 };
@@ -120,6 +124,10 @@ public:
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
 	virtual void PrintStats() = 0;
+
+	// Compiles the scanline functions of a previous session (on the rasterizer threads)
+	virtual void Prewarm(const std::vector<uint64>& keys) = 0;
+	virtual void GetSelectors(std::vector<uint64>& keys) = 0;
 };
 
 class alignas(32) GSRasterizer : public IRasterizer
@@ -176,6 +184,8 @@ public:
 	bool IsSynced() const {return true;}
 	int GetPixels(bool reset);
 	void PrintStats() {m_ds->PrintStats();}
+	void Prewarm(const std::vector<uint64>& keys) {m_ds->Prewarm(keys);}
+	void GetSelectors(std::vector<uint64>& keys) {m_ds->GetSelectors(keys);}
 };
 
 class GSRasterizerList : public IRasterizer
@@ -192,12 +202,14 @@ protected:
 
 	GSRasterizerList(int threads, GSPerfMon* perfmon);
 
+	void SetAffinity();
+
 public:
 	virtual ~GSRasterizerList();
 
 	template<class DS> static IRasterizer* Create(int threads, GSPerfMon* perfmon)
 	{
-		threads = std::max<int>(threads, 0);
+		threads = std::min<int>(std::max<int>(threads, 0), GSPerfMon::MaxWorkers);
 
 		if(threads == 0)
 		{
@@ -214,6 +226,8 @@ public:
 				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); })));
 		}
 
+		rl->SetAffinity();
+
 		return rl;
 	}
 
@@ -224,4 +238,6 @@ public:
 	bool IsSynced() const;
 	int GetPixels(bool reset);
 	void PrintStats() {}
+	void Prewarm(const std::vector<uint64>& keys);
+	void GetSelectors(std::vector<uint64>& keys);
 };
@@ -60,6 +60,12 @@ GSRendererSW::GSRendererSW(int threads)
 		m_tex_pages[i] = 0;
 	}
 
+	memset(m_fzb_blocks, 0, sizeof(m_fzb_blocks));
+	m_fzb_blocks_dirty = false;
+
+	m_sync_log = theApp.GetConfigB("sw_sync_log");
+	memset(m_sync_reasons, 0, sizeof(m_sync_reasons));
+
 	#define InitCVB2(P, Q) \
 		m_cvb[P][0][0][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 0, Q>; \
 		m_cvb[P][0][1][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 1, Q>; \
@@ -94,11 +100,82 @@ GSRendererSW::~GSRendererSW()
 		delete m_texture[i];
 	}
 
+	SaveSelectors();
+
 	delete m_rl;
 
 	_aligned_free(m_output);
 }
 
+void GSRendererSW::SetGameCRC(uint32 crc, int options)
+{
+	if(crc == m_crc)
+	{
+		GSRenderer::SetGameCRC(crc, options);
+
+		return;
+	}
+
+	SaveSelectors();
+
+	GSRenderer::SetGameCRC(crc, options);
+
+	LoadSelectors();
+}
+
+// The scanline selectors a game uses hardly change between sessions, with sw_jit_cache
+// they are recorded per crc, and compiled at the start of the next session.
+
+std::string GSRendererSW::GetSelectorsPath() const
+{
+	return format("%sGSdx_sw_%08X.sel", theApp.GetConfigDir().c_str(), m_crc);
+}
+
+void GSRendererSW::LoadSelectors()
+{
+	if(m_crc == 0 || !theApp.GetConfigB("sw_jit_cache")) return;
+
+	std::vector<uint64> keys;
+
+	if(FILE* fp = fopen(GetSelectorsPath().c_str(), "r"))
+	{
+		unsigned long long key;
+
+		while(fscanf(fp, "%llx", &key) == 1)
+		{
+			keys.push_back(key);
+		}
+
+		fclose(fp);
+	}
+
+	m_rl->Prewarm(keys);
+}
+
+void GSRendererSW::SaveSelectors()
+{
+	if(m_crc == 0 || !theApp.GetConfigB("sw_jit_cache")) return;
+
+	std::vector<uint64> keys;
+
+	m_rl->GetSelectors(keys);
+
+	if(keys.empty()) return;
+
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+	if(FILE* fp = fopen(GetSelectorsPath().c_str(), "w"))
+	{
+		for(uint64 key : keys)
+		{
+			fprintf(fp, "%016llx\n", (unsigned long long)key);
+		}
+
+		fclose(fp);
+	}
+}
+
 void GSRendererSW::Reset()
 {
 	Sync(-1);
@@ -145,6 +222,17 @@ void GSRendererSW::VSync(int field)
 	//
 	*/
 
+	if(m_sync_log)
+	{
+		// 0 vsync, 1 output, 2-3 dump, 4 source, 5 target, 6 upload, 7 download
+
+		int* n = m_sync_reasons;
+
+		printf("GSdx: frame %llu syncs %d %d %d %d %d %d %d %d\n", m_perfmon.GetFrame(), n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]);
+
+		memset(m_sync_reasons, 0, sizeof(m_sync_reasons));
+	}
+
 	GSRenderer::VSync(field);
 
 	m_tc->IncAge();
@@ -376,12 +464,20 @@ void GSRendererSW::Draw()
 {
 	const GSDrawingContext* context = m_context;
 
-	SharedData* sd = new SharedData(this);
+	size_t buff_size = sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1) + sizeof(uint32) * m_index.tail;
+
+	// leave room for the vertices, the clut and dimx in the same slab
+
+	DrawArena::Slab* slab = NULL;
+
+	void* p = m_arena.Begin(sizeof(SharedData), buff_size + sizeof(uint32) * 256 + sizeof(m_env.dimx), slab);
+
+	SharedData* sd = p != NULL ? ::new(p) SharedData(this, slab) : new SharedData(this, NULL);
 
-	std::shared_ptr<GSRasterizerData> data(sd);
+	std::shared_ptr<GSRasterizerData> data(sd, &SharedData::Delete);
 
 	sd->primclass = m_vt.m_primclass;
-	sd->buff = (uint8*)_aligned_malloc(sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1) + sizeof(uint32) * m_index.tail, 64);
+	sd->buff = (uint8*)AllocDrawMemory(sd, buff_size);
 	sd->vertex = (GSVertexSW*)sd->buff;
 	sd->vertex_count = m_vertex.next;
 	sd->index = (uint32*)(sd->buff + sizeof(GSVertexSW) * ((m_vertex.next + 1) & ~1));
@@ -392,9 +488,13 @@ void GSRendererSW::Draw()
 	// If you have both GS_SPRITE_CLASS && m_vt.m_eq.q, it will depends on the first part of the 'OR'
 	uint32 q_div = !IsMipMapActive() && ((m_vt.m_eq.q && m_vt.m_min.t.z != 1.0f) || (!m_vt.m_eq.q && m_vt.m_primclass == GS_SPRITE_CLASS));
 
-	(this->*m_cvb[m_vt.m_primclass][PRIM->TME][PRIM->FST][q_div])(sd->vertex, m_vertex.buff, m_vertex.next);
+	{
+		GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::ConvertTime);
+
+		(this->*m_cvb[m_vt.m_primclass][PRIM->TME][PRIM->FST][q_div])(sd->vertex, m_vertex.buff, m_vertex.next);
 
-	memcpy(sd->index, m_index.buff, sizeof(uint32) * m_index.tail);
+		memcpy(sd->index, m_index.buff, sizeof(uint32) * m_index.tail);
+	}
 
 	GSVector4i scissor = GSVector4i(context->scissor.in);
 	GSVector4i bbox = GSVector4i(m_vt.m_min.p.floor().xyxy(m_vt.m_max.p.ceil()));
@@ -415,9 +515,13 @@ void GSRendererSW::Draw()
 	sd->bbox = bbox;
 	sd->frame = m_perfmon.GetFrame();
 
-	if(!GetScanlineGlobalData(sd))
 	{
-		return;
+		GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::SetupTime);
+
+		if(!GetScanlineGlobalData(sd))
+		{
+			return;
+		}
 	}
 
 	if(0) if(LOG)
@@ -452,11 +556,24 @@ void GSRendererSW::Draw()
 	if(sd->global.sel.fb)
 	{
 		fb_pages = m_context->offset.fb->GetPages(r);
+
+		if(sd->global.sel.fwrite) m_mem.SetDirtyPages(m_context->offset.fb, r);
 	}
 
 	if(sd->global.sel.zb)
 	{
 		zb_pages = m_context->offset.zb->GetPages(r);
+
+		if(sd->global.sel.zwrite) m_mem.SetDirtyPages(m_context->offset.zb, r);
+	}
+
+	// nothing is in flight, forget the target blocks of the previous draws (not in Sync, Queue may sync after this draw added its own)
+
+	if(m_fzb_blocks_dirty && m_rl->IsSynced())
+	{
+		memset(m_fzb_blocks, 0, sizeof(m_fzb_blocks));
+
+		m_fzb_blocks_dirty = false;
 	}
 
 	// check if there is an overlap between this and previous targets
@@ -477,6 +594,18 @@ void GSRendererSW::Draw()
 
 	sd->UsePages(fb_pages, m_context->offset.fb->psm, zb_pages, m_context->offset.zb->psm);
 
+	if(sd->global.sel.fb)
+	{
+		GetBlocks(m_context->offset.fb, r, m_fzb_blocks);
+	}
+
+	if(sd->global.sel.zb)
+	{
+		GetBlocks(m_context->offset.zb, r, m_fzb_blocks);
+	}
+
+	m_fzb_blocks_dirty |= sd->global.sel.fb || sd->global.sel.zb;
+
 	//
 
 	if(s_dump)
@@ -631,10 +760,14 @@ void GSRendererSW::Sync(int reason)
 
 	GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::Sync);
 
+	m_sync_reasons[reason & 7]++;
+
 	uint64 t = __rdtsc();
 
 	m_rl->Sync();
 
+	m_arena.Reclaim();
+
 	if(0) if(LOG)
 	{
 		std::string s;
@@ -753,6 +886,30 @@ void GSRendererSW::ReleasePages(const uint32* pages, const int type)
 	}
 }
 
+void GSRendererSW::GetBlocks(GSOffset* off, const GSVector4i& rect, uint32* blocks)
+{
+	// same walk as GSOffset::GetPages, but one bit per block of each page
+
+	GSVector2i bs = GSLocalMemory::m_psm[off->psm].bs;
+
+	GSVector4i r = rect.ralign<Align_Outside>(bs).sra32(3);
+
+	bs.x >>= 3;
+	bs.y >>= 3;
+
+	for(int y = r.top; y < r.bottom; y += bs.y)
+	{
+		uint32 base = off->block.row[y];
+
+		for(int x = r.left; x < r.right; x += bs.x)
+		{
+			uint32 n = base + off->block.col[x];
+
+			blocks[(n >> 5) % MAX_PAGES] |= 1 << (n & 31);
+		}
+	}
+}
+
 bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r)
 {
 	bool synced = m_rl->IsSynced();
@@ -927,13 +1084,30 @@ bool GSRendererSW::CheckSourcePages(SharedData* sd)
 
 			uint32* pages = m_tmp_pages; // sd->m_tex[i].t->m_pages.n;
 
+			bool blocks = false;
+
 			for(const uint32* p = pages; *p != GSOffset::EOP; p++)
 			{
 				// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
 
-				if(m_fzb_pages[*p]) // currently being drawn to? => sync
+				if(m_fzb_pages[*p]) // currently being drawn to? => check the blocks, games often render to one half of a page and sample the other
 				{
-					return true;
+					if(!blocks)
+					{
+						for(const uint32* q = pages; *q != GSOffset::EOP; q++)
+						{
+							m_tmp_blocks[*q] = 0;
+						}
+
+						GetBlocks(sd->m_tex[i].t->m_offset, sd->m_tex[i].r, m_tmp_blocks);
+
+						blocks = true;
+					}
+
+					if(m_tmp_blocks[*p] & m_fzb_blocks[*p])
+					{
+						return true;
+					}
 				}
 			}
 		}
@@ -1015,6 +1189,25 @@ bool GSRendererSW::GetScanlineGlobalData(SharedData* data)
 
 	bool zwrite = zm != 0xffffffff;
 	bool ztest = context->TEST.ZTE && context->TEST.ZTST > ZTST_ALWAYS;
+
+	if(ztest && (context->TEST.ZTST == ZTST_GEQUAL || context->TEST.ZTST == ZTST_GREATER))
+	{
+		// the stored z can't go above the format maximum, if every vertex is at or past it
+		// the test passes everywhere and the z buffer does not need to be read at all
+
+		int zfmt = GSLocalMemory::m_psm[context->ZBUF.PSM].fmt;
+
+		if(zfmt == 1 || zfmt == 2)
+		{
+			float zmax = zfmt == 1 ? (float)0xffffff : (float)0xffff;
+
+			if(context->TEST.ZTST == ZTST_GEQUAL ? m_vt.m_min.p.z >= zmax : m_vt.m_min.p.z > zmax)
+			{
+				ztest = false;
+			}
+		}
+	}
+
 	/*
 	printf("%05x %d %05x %d %05x %d %dx%d\n", 
 		fwrite || ftest ? m_context->FRAME.Block() : 0xfffff, m_context->FRAME.PSM,
@@ -1046,7 +1239,7 @@ bool GSRendererSW::GetScanlineGlobalData(SharedData* data)
 			{
 				gd.sel.tlu = 1;
 
-				gd.clut = (uint32*)_aligned_malloc(sizeof(uint32) * 256, 32); // FIXME: might address uninitialized data of the texture (0xCD) that is not in 0-15 range for 4-bpp formats
+				gd.clut = (uint32*)AllocDrawMemory(data, sizeof(uint32) * 256); // FIXME: might address uninitialized data of the texture (0xCD) that is not in 0-15 range for 4-bpp formats
 
 				memcpy(gd.clut, (const uint32*)m_mem.m_clut, sizeof(uint32) * GSLocalMemory::m_psm[context->TEX0.PSM].pal);
 			}
@@ -1315,7 +1508,7 @@ bool GSRendererSW::GetScanlineGlobalData(SharedData* data)
 		{
 			gd.sel.dthe = 1;
 
-			gd.dimx = (GSVector4i*)_aligned_malloc(sizeof(env.dimx), 32);
+			gd.dimx = (GSVector4i*)AllocDrawMemory(data, sizeof(env.dimx));
 
 			memcpy(gd.dimx, env.dimx, sizeof(env.dimx));
 		}
@@ -1409,8 +1602,121 @@ bool GSRendererSW::GetScanlineGlobalData(SharedData* data)
 	return true;
 }
 
-GSRendererSW::SharedData::SharedData(GSRendererSW* parent)
+void* GSRendererSW::AllocDrawMemory(SharedData* sd, size_t size)
+{
+	void* p = m_arena.Alloc(sd->m_slab, size);
+
+	return p != NULL ? p : _aligned_malloc(size, DrawArena::Align);
+}
+
+GSRendererSW::DrawArena::DrawArena()
+	: m_cur(0)
+{
+}
+
+GSRendererSW::DrawArena::~DrawArena()
+{
+	for(Slab* slab : m_slabs)
+	{
+		ASSERT(slab->refs == 0);
+
+		_aligned_free(slab->buff);
+
+		delete slab;
+	}
+}
+
+bool GSRendererSW::DrawArena::Fits(Slab* slab, size_t size)
+{
+	return slab->used + size <= SlabSize;
+}
+
+void* GSRendererSW::DrawArena::Begin(size_t size, size_t reserve, Slab*& slab)
+{
+	size = (size + Align - 1) & ~(Align - 1);
+
+	size_t need = size + reserve <= SlabSize ? size + reserve : size;
+
+	slab = NULL;
+
+	if(!m_slabs.empty() && Fits(m_slabs[m_cur], need))
+	{
+		slab = m_slabs[m_cur];
+	}
+	else
+	{
+		// the next slab of the ring whose draws are all done, or a new one
+
+		for(size_t i = 1; i <= m_slabs.size(); i++)
+		{
+			size_t j = (m_cur + i) % m_slabs.size();
+
+			if(m_slabs[j]->refs.load(std::memory_order_acquire) == 0)
+			{
+				m_slabs[j]->used = 0;
+				m_cur = j;
+				slab = m_slabs[j];
+				break;
+			}
+		}
+
+		if(slab == NULL)
+		{
+			if(m_slabs.size() >= MaxSlabs)
+			{
+				return NULL;
+			}
+
+			slab = new Slab();
+			slab->buff = (uint8*)_aligned_malloc(SlabSize, Align);
+			slab->used = 0;
+			slab->refs = 0;
+
+			m_cur = m_slabs.size();
+			m_slabs.push_back(slab);
+		}
+	}
+
+	void* p = slab->buff + slab->used;
+
+	slab->used += size;
+	slab->refs.fetch_add(1, std::memory_order_relaxed);
+
+	return p;
+}
+
+void* GSRendererSW::DrawArena::Alloc(Slab* slab, size_t size)
+{
+	size = (size + Align - 1) & ~(Align - 1);
+
+	// only the current slab grows, a slab can't be rewound while a draw still uses it
+
+	if(slab == NULL || slab != m_slabs[m_cur] || !Fits(slab, size))
+	{
+		return NULL;
+	}
+
+	void* p = slab->buff + slab->used;
+
+	slab->used += size;
+
+	return p;
+}
+
+void GSRendererSW::DrawArena::Reclaim()
+{
+	for(Slab* slab : m_slabs)
+	{
+		if(slab->refs.load(std::memory_order_acquire) == 0)
+		{
+			slab->used = 0;
+		}
+	}
+}
+
+GSRendererSW::SharedData::SharedData(GSRendererSW* parent, DrawArena::Slab* slab)
 	: m_parent(parent)
+	, m_slab(slab)
 	, m_fb_pages(NULL)
 	, m_zb_pages(NULL)
 	, m_fpsm(0)
@@ -1430,8 +1736,10 @@ GSRendererSW::SharedData::~SharedData()
 {
 	ReleasePages();
 
-	if(global.clut) _aligned_free(global.clut);
-	if(global.dimx) _aligned_free(global.dimx);
+	if(global.clut && !DrawArena::Owns(m_slab, global.clut)) _aligned_free(global.clut);
+	if(global.dimx && !DrawArena::Owns(m_slab, global.dimx)) _aligned_free(global.dimx);
+
+	if(DrawArena::Owns(m_slab, buff)) buff = NULL; // not for ~GSRasterizerData to free
 
 	if(LOG) {fprintf(s_fp, "[%d] done t=%lld p=%d | %d %d %d | %08x_%08x\n", 
 		counter, 
@@ -1442,6 +1750,22 @@ GSRendererSW::SharedData::~SharedData()
 	fflush(s_fp);}
 }
 
+void GSRendererSW::SharedData::Delete(SharedData* sd)
+{
+	DrawArena::Slab* slab = sd->m_slab;
+
+	if(slab == NULL)
+	{
+		delete sd;
+
+		return;
+	}
+
+	sd->~SharedData();
+
+	slab->Release();
+}
+
 //static TransactionScope::Lock s_lock;
 
 void GSRendererSW::SharedData::UsePages(const uint32* fb_pages, int fpsm, const uint32* zb_pages, int zpsm)
@@ -31,6 +31,46 @@ class GSRendererSW : public GSRenderer
 	static GSVector8 m_pos_scale2;
 #endif
 
+	// Memory of the draws in flight (the SharedData itself, vertices, indices, clut and dimx).
+	// A draw bumps its allocations out of one of a few large slabs instead of going to the heap
+	// several times.  A slab counts the draws it holds and is rewound once they are all done,
+	// which is the case for all of them after a Sync.  Whatever does not fit goes to the heap.
+	class DrawArena
+	{
+	public:
+		enum {SlabSize = 2 << 20, MaxSlabs = 16, Align = 64};
+
+		struct Slab
+		{
+			uint8* buff;
+			size_t used; // GS thread
+			std::atomic<int> refs; // draws using the slab
+
+			void Release() {refs.fetch_sub(1, std::memory_order_release);}
+		};
+
+	private:
+		std::vector<Slab*> m_slabs;
+		size_t m_cur;
+
+		bool Fits(Slab* slab, size_t size);
+
+	public:
+		DrawArena();
+		~DrawArena();
+
+		// size bytes for a new draw, preferably in a slab that has room for reserve more, NULL if there is no free slab
+		void* Begin(size_t size, size_t reserve, Slab*& slab);
+
+		// more memory for a draw that got its slab from Begin, NULL if it does not fit
+		void* Alloc(Slab* slab, size_t size);
+
+		// rewinds the slabs no draw uses anymore, GS thread
+		void Reclaim();
+
+		static bool Owns(const Slab* slab, const void* p) {return slab != NULL && p >= slab->buff && p < slab->buff + SlabSize;}
+	};
+
 	class SharedData : public GSDrawScanline::SharedData
 	{
 		struct alignas(16) TextureLevel
@@ -41,6 +81,7 @@ class GSRendererSW : public GSRenderer
 
 	public:
 		GSRendererSW* m_parent;
+		DrawArena::Slab* m_slab; // NULL if allocated on the heap
 		const uint32* m_fb_pages;
 		const uint32* m_zb_pages;
 		int m_fpsm;
@@ -50,9 +91,11 @@ class GSRendererSW : public GSRenderer
 		enum {SyncNone, SyncSource, SyncTarget} m_syncpoint;
 
 	public:
-		SharedData(GSRendererSW* parent);
+		SharedData(GSRendererSW* parent, DrawArena::Slab* slab);
 		virtual ~SharedData();
 
+		static void Delete(SharedData* sd); // shared_ptr deleter
+
 		void UsePages(const uint32* fb_pages, int fpsm, const uint32* zb_pages, int zpsm);
 		void ReleasePages();
 
@@ -69,6 +112,7 @@ class GSRendererSW : public GSRenderer
 
 protected:
 	IRasterizer* m_rl;
+	DrawArena m_arena;
 	GSTextureCacheSW* m_tc;
 	GSTexture* m_texture[2];
 	uint8* m_output;
@@ -78,6 +122,11 @@ protected:
 	std::atomic<uint32> m_fzb_pages[512]; // uint16 frame/zbuf pages interleaved
 	std::atomic<uint16> m_tex_pages[512];
 	uint32 m_tmp_pages[512 + 1];
+	uint32 m_fzb_blocks[512]; // blocks of each page used as a target since the last sync
+	uint32 m_tmp_blocks[512];
+	bool m_fzb_blocks_dirty;
+	bool m_sync_log;
+	int m_sync_reasons[8];
 
 	void Reset();
 	void VSync(int field);
@@ -88,20 +137,30 @@ protected:
 	void Draw();
 	void Queue(std::shared_ptr<GSRasterizerData>& item);
 	void Sync(int reason);
+	void SyncLocalMem() {Sync(-1);}
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
 
 	void UsePages(const uint32* pages, const int type);
 	void ReleasePages(const uint32* pages, const int type);
+	void GetBlocks(GSOffset* off, const GSVector4i& rect, uint32* blocks);
 
 	bool CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r);
 	bool CheckSourcePages(SharedData* sd);
 
 	bool GetScanlineGlobalData(SharedData* data);
 
+	void* AllocDrawMemory(SharedData* sd, size_t size); // from the draw's slab or the heap, freed by ~SharedData
+
+	std::string GetSelectorsPath() const;
+	void LoadSelectors();
+	void SaveSelectors();
+
 public:
 	static void InitVectors();
 
 	GSRendererSW(int threads);
 	virtual ~GSRendererSW();
+
+	void SetGameCRC(uint32 crc, int options);
 };
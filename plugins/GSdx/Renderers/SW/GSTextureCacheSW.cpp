@@ -24,12 +24,23 @@
 
 GSTextureCacheSW::GSTextureCacheSW(GSState* state)
 	: m_state(state)
+	, m_pool_bytes(0)
+	, m_bytes(0)
 {
+	m_budget = (size_t)std::max<int>(theApp.GetConfigI("sw_texture_budget"), 0) << 20;
 }
 
 GSTextureCacheSW::~GSTextureCacheSW()
 {
 	RemoveAll();
+
+	TrimPool();
+
+	GSPerfMon& pm = m_state->m_perfmon;
+
+	printf("GSdx: sw texture cache %.0f hits, %.0f misses, %.0f evictions, %.1f MB decoded\n",
+		pm.GetTotal(GSPerfMon::TextureHit), pm.GetTotal(GSPerfMon::TextureMiss),
+		pm.GetTotal(GSPerfMon::TextureEvict), pm.GetTotal(GSPerfMon::Unswizzle) / (1024 * 1024));
 }
 
 GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint32 tw0)
@@ -60,11 +71,13 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 		// Lookup hit
 		m.MoveFront(i.Index());
 		t->m_age = 0;
+		m_state->m_perfmon.Put(GSPerfMon::TextureHit, 1);
 		return t;
 	}
 
 	// Lookup miss
-	Texture* t = new Texture(m_state, tw0, TEX0, TEXA);
+	m_state->m_perfmon.Put(GSPerfMon::TextureMiss, 1);
+	Texture* t = new Texture(m_state, this, tw0, TEX0, TEXA);
 
 	m_textures.insert(t);
 
@@ -129,26 +142,121 @@ void GSTextureCacheSW::IncAge()
 		{
 			i = m_textures.erase(i);
 
-			for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
-			{
-				const uint32 page = *p;
-				m_map[page].EraseIndex(t->m_erase_it[page]);
-			}
-
-			delete t;
+			Remove(t);
 		}
 		else
 		{
 			++i;
 		}
 	}
+
+	if(m_budget > 0 && m_bytes + m_pool_bytes > m_budget)
+	{
+		TrimPool();
+
+		if(m_bytes > m_budget)
+		{
+			// least recently used first, called after a sync so nothing references them
+
+			std::vector<Texture*> lru(m_textures.begin(), m_textures.end());
+
+			std::sort(lru.begin(), lru.end(), [](const Texture* a, const Texture* b) {return a->m_age > b->m_age;});
+
+			for(size_t i = 0; i < lru.size() && m_bytes > m_budget; i++)
+			{
+				m_textures.erase(lru[i]);
+
+				Remove(lru[i]);
+
+				m_state->m_perfmon.Put(GSPerfMon::TextureEvict, 1);
+			}
+		}
+	}
+}
+
+void GSTextureCacheSW::Remove(Texture* t)
+{
+	for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
+	{
+		const uint32 page = *p;
+		m_map[page].EraseIndex(t->m_erase_it[page]);
+	}
+
+	delete t;
+}
+
+void GSTextureCacheSW::TrimPool()
+{
+	for(auto& l : m_pool)
+	{
+		for(void* buff : l) _aligned_free(buff);
+
+		l.clear();
+	}
+
+	m_pool_bytes = 0;
+}
+
+void* GSTextureCacheSW::AllocBuffer(uint32 size)
+{
+	int i = 0;
+
+	while((1u << i) < size) i++;
+
+	ASSERT((1u << i) == size);
+
+	void* buff;
+
+	if(!m_pool[i].empty())
+	{
+		buff = m_pool[i].back();
+
+		m_pool[i].pop_back();
+
+		m_pool_bytes -= size;
+	}
+	else
+	{
+		buff = _aligned_malloc(size, 32);
+
+		if(buff == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	m_bytes += size;
+
+	return buff;
+}
+
+void GSTextureCacheSW::FreeBuffer(void* buff, uint32 size)
+{
+	int i = 0;
+
+	while((1u << i) < size) i++;
+
+	m_bytes -= size;
+
+	if(m_pool_bytes + size <= PoolLimit && (m_budget == 0 || m_bytes + m_pool_bytes + size <= m_budget))
+	{
+		m_pool[i].push_back(buff);
+
+		m_pool_bytes += size;
+	}
+	else
+	{
+		_aligned_free(buff);
+	}
 }
 
 //
 
-GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
+GSTextureCacheSW::Texture::Texture(GSState* state, GSTextureCacheSW* cache, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 	: m_state(state)
+	, m_cache(cache)
 	, m_buff(NULL)
+	, m_size(0)
 	, m_tw(tw0)
 	, m_age(0)
 	, m_complete(false)
@@ -185,7 +293,7 @@ GSTextureCacheSW::Texture::~Texture()
 
 	if(m_buff)
 	{
-		_aligned_free(m_buff);
+		m_cache->FreeBuffer(m_buff, m_size);
 	}
 }
 
@@ -218,7 +326,8 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 	{
 		uint32 pitch = (1 << m_tw) << shift;
 		
-		m_buff = _aligned_malloc(pitch * th * 4, 32);
+		m_size = pitch * th * 4;
+		m_buff = m_cache->AllocBuffer(m_size);
 
 		if(m_buff == NULL)
 		{
@@ -31,10 +31,12 @@ public:
 	{
 	public:
 		GSState* m_state;
+		GSTextureCacheSW* m_cache;
 		GSOffset* m_offset;
 		GIFRegTEX0 m_TEX0;
 		GIFRegTEXA m_TEXA;
 		void* m_buff;
+		uint32 m_size;
 		uint32 m_tw;
 		uint32 m_age;
 		bool m_complete;
@@ -49,7 +51,7 @@ public:
 		// fast mode: each uint32 bits map to the 32 blocks of that page
 		// repeating mode: 1 bpp image of the texture tiles (8x8), also having 512 elements is just a coincidence (worst case: (1024*1024)/(8*8)/(sizeof(uint32)*8))
 
-		Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
+		Texture(GSState* state, GSTextureCacheSW* cache, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
 		virtual ~Texture();
 
 		bool Update(const GSVector4i& r);
@@ -61,6 +63,17 @@ protected:
 	std::unordered_set<Texture*> m_textures;
 	std::array<FastList<Texture*>, MAX_PAGES> m_map;
 
+	// texture buffers are always a power of two in size, freed ones are kept around by size class
+	enum {PoolClasses = 32, PoolLimit = 64 << 20};
+
+	std::vector<void*> m_pool[PoolClasses];
+	size_t m_pool_bytes;
+	size_t m_bytes; // held by live textures
+	size_t m_budget; // sw_texture_budget, 0 = unlimited
+
+	void Remove(Texture* t);
+	void TrimPool();
+
 public:
 	GSTextureCacheSW(GSState* state);
 	virtual ~GSTextureCacheSW();
@@ -71,4 +84,7 @@ public:
 
 	void RemoveAll();
 	void IncAge();
+
+	void* AllocBuffer(uint32 size);
+	void FreeBuffer(void* buff, uint32 size);
 };
@@ -25,6 +25,7 @@
 #include "GSdx.h"
 #include "GSdxResources.h"
 #include "GSSetting.h"
+#include "GSPerfMon.h"
 
 // Port of deprecated GTK2 API to recent GTK3. Those defines
 // could prove handy for testing
@@ -336,7 +337,7 @@ void populate_gl_table(GtkWidget* gl_table)
 void populate_sw_table(GtkWidget* sw_table)
 {
 	GtkWidget* threads_label = left_label("Extra rendering threads:");
-	GtkWidget* threads_spin  = CreateSpinButton(0, 32, "extrathreads");
+	GtkWidget* threads_spin  = CreateSpinButton(0, GSPerfMon::MaxWorkers, "extrathreads");
 
 	GtkWidget* aa_check           = CreateCheckBox("Edge Anti-aliasing (Del)", "aa1");
 	GtkWidget* mipmap_check       = CreateCheckBox("Mipmapping", "mipmap");
@@ -56,6 +56,28 @@ public:
 
 };
 
+// Stands in for the window when the emulator runs headless, only the null device can use it
+class GSWndNull final : public GSWnd
+{
+	GSVector4i m_rect;
+
+public:
+	GSWndNull(int w, int h) : m_rect(0, 0, w, h) {}
+
+	bool Create(const std::string& title, int w, int h) {return true;}
+	bool Attach(void* handle, bool managed = true) {return true;}
+	void Detach() {}
+
+	void* GetDisplay() {return NULL;}
+	void* GetHandle() {return NULL;}
+	GSVector4i GetClientRect() {return m_rect;}
+	bool SetWindowText(const char* title) {return false;}
+
+	void Show() {}
+	void Hide() {}
+	void HideFrame() {}
+};
+
 class GSWndGL : public GSWnd
 {
 protected:
@@ -94,4 +116,11 @@ public:
 	virtual void HideFrame() = 0;
 	virtual void Flip() = 0;
 	virtual void SetVSync(int vsync) final;
+
+	// A second context on the window that shares the objects of the main one, for a thread
+	// that only presents.  Flip() is then called by that thread, with this context attached.
+	virtual bool CreatePresentContext() {return false;}
+	virtual void DestroyPresentContext() {}
+	virtual void AttachPresentContext() {}
+	virtual void DetachPresentContext() {}
 };
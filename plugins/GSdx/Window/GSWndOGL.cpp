@@ -24,7 +24,7 @@
 
 #if defined(__unix__)
 GSWndOGL::GSWndOGL()
-	: m_NativeWindow(0), m_NativeDisplay(nullptr), m_context(0), m_has_late_vsync(false), m_swapinterval_ext(nullptr), m_swapinterval_mesa(nullptr)
+	: m_NativeWindow(0), m_NativeDisplay(nullptr), m_context(0), m_present_context(0), m_fbconfig(0), m_has_late_vsync(false), m_swapinterval_ext(nullptr), m_swapinterval_mesa(nullptr)
 {
 }
 
@@ -89,7 +89,9 @@ void GSWndOGL::CreateContext(int major, int minor)
 		None
 	};
 
-	m_context = glX_CreateContextAttribsARB(m_NativeDisplay, fbc[0], 0, true, context_attribs);
+	// The config itself belongs to the display, only the list is freed
+	m_fbconfig = fbc[0];
+	m_context = glX_CreateContextAttribsARB(m_NativeDisplay, m_fbconfig, 0, true, context_attribs);
 	XFree(fbc);
 
 	// Don't forget to reinstall the older Handler
@@ -122,6 +124,54 @@ void GSWndOGL::DetachContext()
 	}
 }
 
+bool GSWndOGL::CreatePresentContext()
+{
+	PFNGLXCREATECONTEXTATTRIBSARBPROC glX_CreateContextAttribsARB = (PFNGLXCREATECONTEXTATTRIBSARBPROC)glXGetProcAddress((const GLubyte*) "glXCreateContextAttribsARB");
+	if (!glX_CreateContextAttribsARB || !m_context)
+		return false;
+
+	// Same version as the main context (FullContextInit)
+	int context_attribs[] =
+	{
+		GLX_CONTEXT_MAJOR_VERSION_ARB, 3,
+		GLX_CONTEXT_MINOR_VERSION_ARB, 3,
+		GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+		None
+	};
+
+	int (*oldHandler)(Display*, XErrorEvent*) = XSetErrorHandler(&ctxErrorHandler);
+	XSync(m_NativeDisplay, false);
+
+	m_present_context = glX_CreateContextAttribsARB(m_NativeDisplay, m_fbconfig, m_context, true, context_attribs);
+
+	XSync(m_NativeDisplay, false);
+	XSetErrorHandler(oldHandler);
+
+	if (!m_present_context || ctxError) {
+		ctxError = false;
+		DestroyPresentContext();
+		return false;
+	}
+
+	return true;
+}
+
+void GSWndOGL::DestroyPresentContext()
+{
+	if (m_present_context) glXDestroyContext(m_NativeDisplay, m_present_context);
+	m_present_context = 0;
+}
+
+void GSWndOGL::AttachPresentContext()
+{
+	glXMakeCurrent(m_NativeDisplay, m_NativeWindow, m_present_context);
+}
+
+void GSWndOGL::DetachPresentContext()
+{
+	glXMakeCurrent(m_NativeDisplay, None, NULL);
+}
+
 void GSWndOGL::PopulateWndGlFunction()
 {
 	m_swapinterval_ext  = (PFNGLXSWAPINTERVALEXTPROC) glXGetProcAddress((const GLubyte*) "glXSwapIntervalEXT");
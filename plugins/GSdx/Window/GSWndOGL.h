@@ -30,6 +30,8 @@ class GSWndOGL final : public GSWndGL
 	Window     m_NativeWindow;
 	Display*   m_NativeDisplay;
 	GLXContext m_context;
+	GLXContext m_present_context;
+	GLXFBConfig m_fbconfig;
 	bool       m_has_late_vsync;
 
 	PFNGLXSWAPINTERVALEXTPROC  m_swapinterval_ext;
@@ -62,6 +64,11 @@ public:
 	void Hide();
 	void HideFrame();
 	void Flip();
+
+	bool CreatePresentContext();
+	void DestroyPresentContext();
+	void AttachPresentContext();
+	void DetachPresentContext();
 };
 
 #endif
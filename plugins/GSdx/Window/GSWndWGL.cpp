@@ -40,7 +40,7 @@ static void win_error(const char* msg, bool fatal = true)
 
 
 GSWndWGL::GSWndWGL()
-	: m_NativeWindow(nullptr), m_NativeDisplay(nullptr), m_context(nullptr), m_has_late_vsync(false)
+	: m_NativeWindow(nullptr), m_NativeDisplay(nullptr), m_context(nullptr), m_present_context(nullptr), m_has_late_vsync(false)
 {
 }
 
@@ -123,6 +123,43 @@ void GSWndWGL::CreateContext(int major, int minor)
 	fprintf(stderr, "3.x GL context successfully created\n");
 }
 
+bool GSWndWGL::CreatePresentContext()
+{
+	PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB = (PFNWGLCREATECONTEXTATTRIBSARBPROC)wglGetProcAddress("wglCreateContextAttribsARB");
+	if (!wglCreateContextAttribsARB || !m_context)
+		return false;
+
+	// Same version as the main context (FullContextInit)
+	int context_attribs[] =
+	{
+		WGL_CONTEXT_MAJOR_VERSION_ARB, 3,
+		WGL_CONTEXT_MINOR_VERSION_ARB, 3,
+		WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
+		WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+		0
+	};
+
+	m_present_context = wglCreateContextAttribsARB(m_NativeDisplay, m_context, context_attribs);
+
+	return m_present_context != NULL;
+}
+
+void GSWndWGL::DestroyPresentContext()
+{
+	if (m_present_context) wglDeleteContext(m_present_context);
+	m_present_context = NULL;
+}
+
+void GSWndWGL::AttachPresentContext()
+{
+	wglMakeCurrent(m_NativeDisplay, m_present_context);
+}
+
+void GSWndWGL::DetachPresentContext()
+{
+	wglMakeCurrent(NULL, NULL);
+}
+
 void GSWndWGL::AttachContext()
 {
 	if (!IsContextAttached()) {
@@ -28,6 +28,7 @@ class GSWndWGL : public GSWndGL
 	HWND	 m_NativeWindow;
 	HDC		 m_NativeDisplay;
 	HGLRC	 m_context;
+	HGLRC	 m_present_context;
 	bool	 m_has_late_vsync;
 
 	PFNWGLSWAPINTERVALEXTPROC m_swapinterval;
@@ -64,6 +65,11 @@ public:
 	void Hide();
 	void HideFrame();
 	void Flip();
+
+	bool CreatePresentContext();
+	void DestroyPresentContext();
+	void AttachPresentContext();
+	void DetachPresentContext();
 };
 
 #endif
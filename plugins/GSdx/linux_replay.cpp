@@ -19,6 +19,7 @@
  */
 
 #include <dlfcn.h>
+#include <unistd.h>
 #include <cstdlib>
 #include <cstdio>
 #include <string>
@@ -31,6 +32,10 @@ void help()
 	fprintf(stderr, "ARG1 GSdx plugin\n");
 	fprintf(stderr, "ARG2 .gs file\n");
 	fprintf(stderr, "ARG3 Ini directory\n");
+	fprintf(stderr, "Options (before the args)\n");
+	fprintf(stderr, "-b N     benchmark: replay the dump N times without vsync and print frame stats\n");
+	fprintf(stderr, "-r R     benchmark renderer: ogl (default), sw or null\n");
+	fprintf(stderr, "-j FILE  benchmark: also write the stats as json to FILE\n");
 	if (handle) {
 		dlclose(handle);
 	}
@@ -48,7 +53,31 @@ char* read_env(const char* var) {
 
 int main ( int argc, char *argv[] )
 {
-	if (argc < 1) help();
+	int loops = 0;
+	int renderer = 12; // OGL_HW
+	char* json = nullptr;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "b:r:j:")) != -1) {
+		switch (opt) {
+			case 'b': loops = atoi(optarg); break;
+			case 'j': json = optarg; break;
+			case 'r':
+				if (std::string(optarg) == "ogl") renderer = 12;
+				else if (std::string(optarg) == "sw") renderer = 13;
+				else if (std::string(optarg) == "null") renderer = 11;
+				else help();
+				break;
+			default: help();
+		}
+	}
+
+	// Keep argv[0] so the positional args below are unchanged
+	argv[optind - 1] = argv[0];
+	argc -= optind - 1;
+	argv += optind - 1;
+
+	if (argc < 2) help();
 
 	char* plugin;
 	char* gs;
@@ -68,9 +97,11 @@ int main ( int argc, char *argv[] )
 
 	__attribute__((stdcall)) void (*GSsetSettingsDir_ptr)(const char*);
 	__attribute__((stdcall)) void (*GSReplay_ptr)(char*, int);
+	__attribute__((stdcall)) void (*GSReplayBenchmark_ptr)(char*, int, int, char*);
 
 	GSsetSettingsDir_ptr = reinterpret_cast<decltype(GSsetSettingsDir_ptr)>(dlsym(handle, "GSsetSettingsDir"));
 	GSReplay_ptr = reinterpret_cast<decltype(GSReplay_ptr)>(dlsym(handle, "GSReplay"));
+	GSReplayBenchmark_ptr = reinterpret_cast<decltype(GSReplayBenchmark_ptr)>(dlsym(handle, "GSReplayBenchmark"));
 
 	if (argc == 2) {
 		char *ini = read_env("GSDUMP_CONF");
@@ -94,7 +125,15 @@ int main ( int argc, char *argv[] )
 #endif
 	}
 
-	GSReplay_ptr(gs, 12);
+	if (loops > 0) {
+		if (!GSReplayBenchmark_ptr) {
+			fprintf(stderr, "Plugin %s has no benchmark support\n", plugin);
+			help();
+		}
+		GSReplayBenchmark_ptr(gs, renderer, loops, json);
+	} else {
+		GSReplay_ptr(gs, 12);
+	}
 
 	if (handle) {
 		dlclose(handle);
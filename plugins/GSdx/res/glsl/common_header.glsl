@@ -94,6 +94,8 @@ layout(std140, binding = 21) uniform cb21
 
     vec2 TextureScale;
     vec2 TC_OffsetHack;
+
+    uvec4 TexHandle; // PS_BINDLESS: source (xy) and palette (zw)
 };
 #endif
 
@@ -107,6 +109,51 @@ layout(std140, binding = 21) uniform cb21
 //////////////////////////////////////////////////////////////////////
 #ifdef FRAGMENT_SHADER
 
+#ifdef PS_BINDLESS
+#define TextureSampler sampler2D(TexHandle.xy)
+#else
 layout(binding = 0) uniform sampler2D TextureSampler;
+#endif
+
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Shade boost (shadeboost.glsl, and the interlace passes that apply it)
+//////////////////////////////////////////////////////////////////////
+#if defined(FRAGMENT_SHADER) && defined(SB_SATURATION)
+
+/*
+** Contrast, saturation, brightness
+** Code of this function is from TGM's shader pack
+** http://irrlicht.sourceforge.net/phpBB2/viewtopic.php?t=21057
+** TGM's author comment about the license (included in the previous link)
+** "do with it, what you want! its total free!
+** (but would be nice, if you say that you used my shaders  :wink: ) but not necessary"
+*/
+
+// For all settings: 1.0 = 100% 0.5=50% 1.5 = 150%
+vec4 ContrastSaturationBrightness(vec4 color)
+{
+    const float sat = SB_SATURATION / 50.0;
+    const float brt = SB_BRIGHTNESS / 50.0;
+    const float con = SB_CONTRAST / 50.0;
+
+    // Increase or decrease these values to adjust r, g and b color channels separately
+    const float AvgLumR = 0.5;
+    const float AvgLumG = 0.5;
+    const float AvgLumB = 0.5;
+
+    const vec3 LumCoeff = vec3(0.2125, 0.7154, 0.0721);
+
+    vec3 AvgLumin = vec3(AvgLumR, AvgLumG, AvgLumB);
+    vec3 brtColor = color.rgb * brt;
+    float dot_intensity = dot(brtColor, LumCoeff);
+    vec3 intensity = vec3(dot_intensity, dot_intensity, dot_intensity);
+    vec3 satColor = mix(intensity, brtColor, sat);
+    vec3 conColor = mix(AvgLumin, satColor, con);
+
+    color.rgb = conColor;
+    return color;
+}
 
 #endif
@@ -17,6 +17,13 @@ layout(std140, binding = 11) uniform cb11
 
 layout(location = 0) out vec4 SV_Target0;
 
+// Compiled with the shade boost macros for the last pass, when the shade boost is enabled
+#ifdef SB_SATURATION
+#define INTERLACE_OUT(c) ContrastSaturationBrightness(c)
+#else
+#define INTERLACE_OUT(c) (c)
+#endif
+
 // TODO ensure that clip (discard) is < 0 and not <= 0 ???
 void ps_main0()
 {
@@ -26,7 +33,7 @@ void ps_main0()
     // see: http://www.opengl.org/wiki/GLSL_Sampler#Non-uniform_flow_control
     vec4 c = texture(TextureSampler, PSin.t);
 
-    SV_Target0 = c;
+    SV_Target0 = INTERLACE_OUT(c);
 }
 
 void ps_main1()
@@ -37,7 +44,7 @@ void ps_main1()
     // see: http://www.opengl.org/wiki/GLSL_Sampler#Non-uniform_flow_control
     vec4 c = texture(TextureSampler, PSin.t);
 
-    SV_Target0 = c;
+    SV_Target0 = INTERLACE_OUT(c);
 }
 
 void ps_main2()
@@ -46,12 +53,12 @@ void ps_main2()
     vec4 c1 = texture(TextureSampler, PSin.t);
     vec4 c2 = texture(TextureSampler, PSin.t + ZrH);
 
-    SV_Target0 = (c0 + c1 * 2.0f + c2) / 4.0f;
+    SV_Target0 = INTERLACE_OUT((c0 + c1 * 2.0f + c2) / 4.0f);
 }
 
 void ps_main3()
 {
-    SV_Target0 = texture(TextureSampler, PSin.t);
+    SV_Target0 = INTERLACE_OUT(texture(TextureSampler, PSin.t));
 }
 
 #endif
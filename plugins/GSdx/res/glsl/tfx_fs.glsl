@@ -41,7 +41,11 @@ in SHADER
 layout(location = 0, index = 0) out vec4 SV_Target0;
 layout(location = 0, index = 1) out vec4 SV_Target1;
 
+#ifdef PS_BINDLESS
+#define PaletteSampler sampler2D(TexHandle.zw)
+#else
 layout(binding = 1) uniform sampler2D PaletteSampler;
+#endif
 layout(binding = 3) uniform sampler2D RtSampler; // note 2 already use by the image below
 layout(binding = 4) uniform sampler2D RawTextureSampler;
 
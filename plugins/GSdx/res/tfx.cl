@@ -598,11 +598,30 @@ __kernel void KERNEL_PRIM(
 	}
 	else if(PRIM == GS_LINE_CLASS)
 	{
-		int2 p0 = convert_int2_rte(v0->p.xy);
-		int2 p1 = convert_int2_rte(v1->p.xy);
+		// the pixels are truncated positions (see the tile kernel), floor/ceil covers them all
 
-		pmin = min(p0, p1);
-		pmax = max(p0, p1);
+		pmin = convert_int2_rtn(min(v0->p.xy, v1->p.xy));
+		pmax = convert_int2_rtp(max(v0->p.xy, v1->p.xy));
+
+		// same as triangles, z is interpolated relative to zmin
+
+		uint zmin = min(v0->z, v1->z);
+		uint zmax = max(v0->z, v1->z);
+
+		prim->v[0].p = (float4)(v0->p.x, v0->p.y, as_float(v0->z - zmin), v0->p.w);
+		prim->v[0].tc = v0->tc;
+		prim->v[1].p = (float4)(v1->p.x, v1->p.y, as_float(v1->z - zmin), v1->p.w);
+		prim->v[1].tc = v1->tc;
+
+		prim->zmin = zmin;
+		prim->zmax = zmax;
+
+		int2 dpi = convert_int2(fabs(v1->p.xy - v0->p.xy));
+
+		if(dpi.x == 0 && dpi.y == 0) // GSRasterizer::DrawLine draws nothing either
+		{
+			pmax = -1;
+		}
 	}
 	else if(PRIM == GS_TRIANGLE_CLASS)
 	{
@@ -1388,11 +1407,74 @@ __kernel __attribute__((reqd_work_group_size(8, 8, 1))) void KERNEL_TFX(
 			}
 			else if(PRIM == GS_LINE_CLASS)
 			{
-				// TODO: find point on line prependicular to (x,y), distance.x < 0.5f || distance.y < 0.5f
+				// the pixels of GSRasterizer::DrawLine: a span on one row if |dy| < 1, else one pixel
+				// per step along the major axis, truncated, and the last pixel is not drawn
+
 				// TODO: aa1: coverage ~ distance.x/y, slope selects x or y, zwrite disabled
-				// TODO: do not draw last pixel of the line
 
-				continue;
+				if(!ZTest(prim->zmax, zd))
+				{
+					continue;
+				}
+
+				float2 p0 = prim->v[0].p.xy;
+				float2 dp = prim->v[1].p.xy - p0;
+				float2 adp = fabs(dp);
+
+				float k; // 0 at v0, 1 at v1
+
+				if(convert_int(adp.y) == 0)
+				{
+					float y = dp.x >= 0 ? p0.y : prim->v[1].p.y; // row of the left end
+
+					if(pi.y != convert_int(y) || pf.x < ceil(min(p0.x, p0.x + dp.x)) || pf.x >= ceil(max(p0.x, p0.x + dp.x)))
+					{
+						continue;
+					}
+
+					k = (pf.x - p0.x) / dp.x;
+				}
+				else
+				{
+					int major = adp.x < adp.y ? 1 : 0;
+
+					float d = major ? dp.y : dp.x;
+					float ad = major ? adp.y : adp.x;
+					float s = major ? p0.y - pf.y : p0.x - pf.x;
+
+					// the step whose truncated position lands on this pixel along the major axis
+
+					float step = d > 0 ? ceil(-s) : floor(s);
+
+					if(step < 0 || step >= (float)convert_int(ad))
+					{
+						continue;
+					}
+
+					k = step / ad;
+
+					if(any(convert_int2(p0 + dp / ad * step) != pi))
+					{
+						continue;
+					}
+				}
+
+				float2 zf0 = convert_float2(as_uint2(prim->v[0].p.zw));
+				float2 zf1 = convert_float2(as_uint2(prim->v[1].p.zw));
+
+				zf.x = convert_uint_rte(mix(zf0.x, zf1.x, k)) + prim->zmin;
+				zf.y = convert_uint_rte(mix(zf0.y, zf1.y, k));
+
+				t = mix(prim->v[0].tc.xyz, prim->v[1].tc.xyz, k);
+
+				if(IIP)
+				{
+					c = convert_int4_rte(mix(convert_float4(prim->v[0].c), convert_float4(prim->v[1].c), k));
+				}
+				else
+				{
+					c = convert_int4(prim->v[1].c);
+				}
 			}
 			else if(PRIM == GS_TRIANGLE_CLASS)
 			{
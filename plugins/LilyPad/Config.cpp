@@ -880,6 +880,7 @@ int SaveSettings(wchar_t *file = 0)
         noError &= WritePrivateProfileInt(L"General Settings", BoolOptionsInfo[i].name, config.bools[i], file);
     }
     WritePrivateProfileInt(L"General Settings", L"Close Hack", config.closeHack, file);
+    WritePrivateProfileInt(L"General Settings", L"Poll Rate", config.pollRate, file);
 
     WritePrivateProfileInt(L"General Settings", L"Keyboard Mode", config.keyboardApi, file);
     WritePrivateProfileInt(L"General Settings", L"Mouse Mode", config.mouseApi, file);
@@ -992,6 +993,7 @@ int LoadSettings(int force, wchar_t *file)
         config.bools[i] = GetPrivateProfileBool(L"General Settings", BoolOptionsInfo[i].name, BoolOptionsInfo[i].defaultValue, file);
     }
     config.closeHack = (u8)GetPrivateProfileIntW(L"General Settings", L"Close Hack", 0, file);
+    config.pollRate = GetPrivateProfileIntW(L"General Settings", L"Poll Rate", 0, file);
 
     config.keyboardApi = (DeviceAPI)GetPrivateProfileIntW(L"General Settings", L"Keyboard Mode", WM, file);
     if (!config.keyboardApi)
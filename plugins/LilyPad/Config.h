@@ -37,6 +37,9 @@ public:
 
     u8 closeHack;
 
+    // Rate of the input polling thread, in Hz.  0 polls on demand from PADpoll.
+    int pollRate;
+
     DeviceAPI keyboardApi;
     DeviceAPI mouseApi;
 
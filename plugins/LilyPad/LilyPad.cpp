@@ -19,6 +19,10 @@
 
 // For escape timer, so as not to break GSDX+DX9.
 #include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -68,6 +72,14 @@ static std::mutex updateLock;
 CRITICAL_SECTION updateLock;
 #endif
 
+// Optional polling thread (config.pollRate).  While it runs, only it (or, on Windows, the
+// window thread it asks to poll) updates the pads, and PADpoll just reads the sums it leaves.
+static std::thread pollThread;
+static std::atomic<bool> pollThreadRunning(false);
+
+// Odd while Update() is writing the pad sums, so PADpoll can read them without the lock.
+static std::atomic<unsigned int> sumSequence(0);
+
 // Used to toggle mouse listening.
 u8 miceEnabled;
 
@@ -485,6 +497,10 @@ void Update(unsigned int port, unsigned int slot)
         return;
     }
 
+    // Port 5 (the WMA_FORCE_UPDATE slot) is the one the poll thread uses.
+    if (pollThreadRunning && port != 5)
+        return;
+
 // Lock prior to timecheck code to avoid pesky race conditions.
 #ifdef __linux__
     std::lock_guard<std::mutex> lock(updateLock);
@@ -492,9 +508,10 @@ void Update(unsigned int port, unsigned int slot)
     EnterScopedSection padlock(updateLock);
 #endif
 
+    // The poll thread paces itself.
     static unsigned int LastCheck = 0;
     unsigned int t = timeGetTime();
-    if (t - LastCheck < 15 || !openCount)
+    if (t - LastCheck < (pollThreadRunning ? 0u : 15u) || !openCount)
         return;
 
 #ifdef _MSC_VER
@@ -694,9 +711,12 @@ void Update(unsigned int port, unsigned int slot)
             }
         }
     }
+    sumSequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
     for (i = 0; i < 8; i++) {
         pads[i & 1][i >> 1].sum = s[i & 1][i >> 1];
     }
+    sumSequence.fetch_add(1, std::memory_order_release);
 
     padReadKeyUpdated[0] = padReadKeyUpdated[1] = padReadKeyUpdated[2] = 1;
 
@@ -709,6 +729,55 @@ void CALLBACK PADupdate(int port)
     Update(port + 3, 0);
 }
 
+// Consistent copy of a pad's sum, even while another thread is updating it.
+static void ReadSum(ButtonSum *out, int port, int slot)
+{
+    unsigned int seq;
+    do {
+        seq = sumSequence.load(std::memory_order_acquire);
+        *out = pads[port][slot].sum;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || seq != sumSequence.load(std::memory_order_relaxed));
+}
+
+static void PollThreadProc(int rate)
+{
+#ifdef _MSC_VER
+    // Sleeps have the resolution of the system timer.
+    timeBeginPeriod(1);
+#endif
+    const std::chrono::microseconds interval(1000000 / rate);
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    while (pollThreadRunning) {
+        Update(5, 0);
+
+        next += interval;
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (next < now)
+            next = now; // Fell behind, don't try to catch up.
+        std::this_thread::sleep_until(next);
+    }
+#ifdef _MSC_VER
+    timeEndPeriod(1);
+#endif
+}
+
+static void StartPollThread()
+{
+    if (config.pollRate <= 0 || pollThreadRunning)
+        return;
+    pollThreadRunning = true;
+    pollThread = std::thread(PollThreadProc, std::min(config.pollRate, 1000));
+}
+
+static void StopPollThread()
+{
+    if (!pollThreadRunning)
+        return;
+    pollThreadRunning = false;
+    pollThread.join();
+}
+
 inline void SetVibrate(int port, int slot, int motor, u8 val)
 {
     pads[port][slot].nextVibrate[motor] = val;
@@ -1158,6 +1227,7 @@ s32 CALLBACK PADopen(void *pDsp)
 #endif
     activeWindow = 1;
     UpdateEnabledDevices();
+    StartPollThread();
     return 0;
 }
 
@@ -1165,6 +1235,7 @@ void CALLBACK PADclose()
 {
     if (openCount && !--openCount) {
         DEBUG_TEXT_OUT("LilyPad closed\n\n");
+        StopPollThread();
 #ifdef _MSC_VER
         updateQueued = 0;
         hWndGSProc.Release();
@@ -1257,7 +1328,9 @@ u8 CALLBACK PADpoll(u8 value)
                 query.response[2] = 0x5A;
                 {
                     Update(query.port, query.slot);
-                    ButtonSum *sum = &pad->sum;
+                    ButtonSum snapshot;
+                    ReadSum(&snapshot, query.port, query.slot);
+                    ButtonSum *sum = &snapshot;
 
                     if (padtype == MousePad) {
                         u8 b1 = 0xFC;
@@ -229,6 +229,7 @@ int SaveSettings(wchar_t *file = 0)
         cfg.WriteBool(L"General Settings", BoolOptionsInfo[i].name, config.bools[i]);
     }
     cfg.WriteInt(L"General Settings", L"Close Hack", config.closeHack);
+    cfg.WriteInt(L"General Settings", L"Poll Rate", config.pollRate);
 
     cfg.WriteInt(L"General Settings", L"Keyboard Mode", config.keyboardApi);
     cfg.WriteInt(L"General Settings", L"Mouse Mode", config.mouseApi);
@@ -319,6 +320,7 @@ int LoadSettings(int force, wchar_t *file)
     }
 
     config.closeHack = (u8)cfg.ReadInt(L"General Settings", L"Close Hack");
+    config.pollRate = cfg.ReadInt(L"General Settings", L"Poll Rate");
 
     config.keyboardApi = (DeviceAPI)cfg.ReadInt(L"General Settings", L"Keyboard Mode", LNX_KEYBOARD);
     if (!config.keyboardApi)
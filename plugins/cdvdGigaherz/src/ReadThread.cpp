@@ -15,10 +15,14 @@
 
 #include "CDVD.h"
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdlib>
 #include <limits>
+#include <new>
 #include <queue>
 #include <thread>
+#include <unordered_map>
 
 const u32 sectors_per_read = 16;
 
@@ -28,6 +32,9 @@ static_assert(sectors_per_read > 1 && !(sectors_per_read & (sectors_per_read - 1
 struct SectorInfo
 {
     u32 lsn;
+    // LRU list links (entry indices)
+    u32 prev;
+    u32 next;
     // Sectors are read in blocks, not individually
     u8 data[2352 * sectors_per_read];
 };
@@ -44,71 +51,183 @@ static std::mutex s_cache_lock;
 
 static std::atomic<bool> cdvd_is_open;
 
-//bits: 12 would use 1<<12 entries, or 4096*16 sectors ~ 128MB
-#define CACHE_SIZE 12
+// Blocks ahead of a request which are prefetched, for random access and while
+// streaming. Physical drives are slow to seek but fast to keep reading.
+const u32 prefetch_blocks_random = 4;
+const u32 prefetch_blocks_streaming = 64;
+// Consecutive blocks requested before the access counts as streaming
+const u32 streaming_threshold = 3;
+
+// Cache size in MB, "cache_size" in the ini. The cache is one allocation in a 32-bit
+// process, it must still fit in a fragmented address space
+const u32 default_cache_size = 128;
+const u32 min_cache_size = 4;
+const u32 max_cache_size = 256;
+
+const u32 invalid_lsn = std::numeric_limits<u32>::max();
+const u32 no_entry = std::numeric_limits<u32>::max();
+
+// LRU cache of sector blocks, keyed by the lsn of the first sector
+static std::vector<SectorInfo> s_cache;
+static std::unordered_map<u32, u32> s_cache_index;
+static u32 s_lru_head; // most recently used
+static u32 s_lru_tail; // next to be evicted
+
+// Streaming detection, updated by the requests from the emulator
+static u32 s_last_request_block = invalid_lsn;
+static std::atomic<u32> s_stream_run;
+static std::atomic<u32> s_stream_lsn;
+
+// Stats
+static std::atomic<u32> s_cache_hits;
+static std::atomic<u32> s_cache_misses;
+static std::atomic<u32> s_seeks;
+static std::atomic<u32> s_next_physical_lsn;
+
+static void cdvdLruUnlink(u32 entry)
+{
+    SectorInfo &info = s_cache[entry];
+
+    if (info.prev != no_entry)
+        s_cache[info.prev].next = info.next;
+    else
+        s_lru_head = info.next;
 
-const u32 CacheSize = 1U << CACHE_SIZE;
-SectorInfo Cache[CacheSize];
+    if (info.next != no_entry)
+        s_cache[info.next].prev = info.prev;
+    else
+        s_lru_tail = info.prev;
+}
 
-u32 cdvdSectorHash(u32 lsn)
+static void cdvdLruPushFront(u32 entry)
 {
-    u32 t = 0;
+    SectorInfo &info = s_cache[entry];
+
+    info.prev = no_entry;
+    info.next = s_lru_head;
+    if (s_lru_head != no_entry)
+        s_cache[s_lru_head].prev = entry;
+    s_lru_head = entry;
+    if (s_lru_tail == no_entry)
+        s_lru_tail = entry;
+}
 
-    int i = 32;
-    u32 m = CacheSize - 1;
+static void cdvdLruTouch(u32 entry)
+{
+    if (entry == s_lru_head)
+        return;
+    cdvdLruUnlink(entry);
+    cdvdLruPushFront(entry);
+}
 
-    while (i >= 0) {
-        t ^= lsn & m;
-        lsn >>= CACHE_SIZE;
-        i -= CACHE_SIZE;
+static u32 cdvdCacheBlocksFromSettings()
+{
+    u32 size = default_cache_size;
+
+    std::string value;
+    if (g_settings.Get("cache_size", value)) {
+        size = std::strtoul(value.c_str(), nullptr, 10);
+        size = std::min(std::max(size, min_cache_size), max_cache_size);
     }
 
-    return t & m;
+    return static_cast<u32>((static_cast<u64>(size) << 20) / sizeof(SectorInfo));
 }
 
 void cdvdCacheUpdate(u32 lsn, u8 *data)
 {
     std::lock_guard<std::mutex> guard(s_cache_lock);
-    u32 entry = cdvdSectorHash(lsn);
 
-    memcpy(Cache[entry].data, data, 2352 * sectors_per_read);
-    Cache[entry].lsn = lsn;
+    // Running without a cache (see cdvdCacheResize)
+    if (s_cache.empty())
+        return;
+
+    u32 entry;
+    auto it = s_cache_index.find(lsn);
+    if (it != s_cache_index.end()) {
+        entry = it->second;
+        cdvdLruTouch(entry);
+    } else {
+        // Recycle the least recently used block
+        entry = s_lru_tail;
+        if (s_cache[entry].lsn != invalid_lsn)
+            s_cache_index.erase(s_cache[entry].lsn);
+        cdvdLruTouch(entry);
+
+        s_cache[entry].lsn = lsn;
+        s_cache_index[lsn] = entry;
+    }
+
+    memcpy(s_cache[entry].data, data, 2352 * sectors_per_read);
 }
 
 bool cdvdCacheCheck(u32 lsn)
 {
     std::lock_guard<std::mutex> guard(s_cache_lock);
-    u32 entry = cdvdSectorHash(lsn);
 
-    return Cache[entry].lsn == lsn;
+    return s_cache_index.count(lsn) != 0;
 }
 
 bool cdvdCacheFetch(u32 lsn, u8 *data)
 {
     std::lock_guard<std::mutex> guard(s_cache_lock);
-    u32 entry = cdvdSectorHash(lsn);
 
-    if (Cache[entry].lsn == lsn) {
-        memcpy(data, Cache[entry].data, 2352 * sectors_per_read);
-        return true;
+    auto it = s_cache_index.find(lsn);
+    if (it == s_cache_index.end()) {
+        ++s_cache_misses;
+        return false;
     }
-    //printf("NOT IN CACHE\n");
-    return false;
+
+    ++s_cache_hits;
+    cdvdLruTouch(it->second);
+    memcpy(data, s_cache[it->second].data, 2352 * sectors_per_read);
+    return true;
 }
 
 void cdvdCacheReset()
 {
     std::lock_guard<std::mutex> guard(s_cache_lock);
-    for (u32 i = 0; i < CacheSize; i++) {
-        Cache[i].lsn = std::numeric_limits<u32>::max();
+
+    s_cache_index.clear();
+    s_lru_head = s_lru_tail = no_entry;
+    for (u32 i = 0; i < s_cache.size(); i++) {
+        s_cache[i].lsn = invalid_lsn;
+        cdvdLruPushFront(i);
     }
 }
 
+static void cdvdCacheResize(u32 blocks)
+{
+    {
+        std::lock_guard<std::mutex> guard(s_cache_lock);
+        s_cache.clear();
+        s_cache.shrink_to_fit();
+
+        // Halve it until it fits, and run without a cache if even the minimum doesn't,
+        // rather than failing the plugin
+        const u32 min_blocks = static_cast<u32>((static_cast<u64>(min_cache_size) << 20) / sizeof(SectorInfo));
+        for (;;) {
+            try {
+                s_cache = std::vector<SectorInfo>(blocks);
+                break;
+            } catch (const std::bad_alloc &) {
+                if (blocks <= min_blocks)
+                    break;
+                blocks = std::max(blocks / 2, min_blocks);
+            }
+        }
+    }
+    cdvdCacheReset();
+}
+
 bool cdvdReadBlockOfSectors(u32 sector, u8 *data)
 {
     u32 count = std::min(sectors_per_read, src->GetSectorCount() - sector);
     const s32 media = src->GetMediaType();
 
+    // Anything but carrying on from the last read moves the head
+    if (s_next_physical_lsn.exchange(sector + count) != sector)
+        ++s_seeks;
+
     // TODO: Is it really necessary to retry if it fails? I'm not sure the
     // second time is really going to be any better.
     for (int tries = 0; tries < 2; ++tries) {
@@ -123,6 +242,19 @@ bool cdvdReadBlockOfSectors(u32 sector, u8 *data)
     return false;
 }
 
+static void cdvdPrintStats(std::chrono::steady_clock::time_point since)
+{
+    const u32 hits = s_cache_hits.exchange(0);
+    const u32 misses = s_cache_misses.exchange(0);
+    const u32 seeks = s_seeks.exchange(0);
+    if (hits + misses + seeks == 0)
+        return;
+
+    const double minutes = std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count() / 60;
+    printf(" * CDVD: cache %u hits, %u misses (%.1f%% hit rate), %.1f seeks/min\n",
+           hits, misses, 100.0 * hits / std::max(hits + misses, 1U), seeks / std::max(minutes, 1.0 / 60));
+}
+
 void cdvdCallNewDiscCB()
 {
     weAreInNewDiskCB = true;
@@ -163,7 +295,9 @@ bool cdvdUpdateDiscStatus()
 void cdvdThread()
 {
     u8 buffer[2352 * sectors_per_read];
-    u32 prefetches_left = 0;
+    u32 next_prefetch_lsn = 0;
+    u32 prefetch_end_lsn = 0;
+    auto stats_start = std::chrono::steady_clock::now();
 
     printf(" * CDVD: IO thread started...\n");
     std::unique_lock<std::mutex> guard(s_notify_lock);
@@ -172,17 +306,32 @@ void cdvdThread()
         if (cdvdUpdateDiscStatus()) {
             // Need to sleep some to avoid an aggressive spin that sucks the cpu dry.
             s_notify_cv.wait_for(guard, std::chrono::milliseconds(10));
-            prefetches_left = 0;
+            prefetch_end_lsn = next_prefetch_lsn;
             continue;
         }
 
-        if (prefetches_left == 0)
+        if (next_prefetch_lsn >= prefetch_end_lsn)
             s_notify_cv.wait_for(guard, std::chrono::milliseconds(250));
 
         // check again to make sure we're not done here...
         if (!cdvd_is_open)
             break;
 
+        if (std::chrono::steady_clock::now() - stats_start >= std::chrono::minutes(1)) {
+            cdvdPrintStats(stats_start);
+            stats_start = std::chrono::steady_clock::now();
+        }
+
+        // While the emulator streams through cached blocks, keep reading ahead of it
+        if (s_stream_run >= streaming_threshold) {
+            const u32 stream_lsn = s_stream_lsn;
+            const u32 window_end = std::min(stream_lsn + sectors_per_read * (prefetch_blocks_streaming + 1),
+                                            src->GetSectorCount());
+            if (next_prefetch_lsn <= stream_lsn || next_prefetch_lsn > window_end)
+                next_prefetch_lsn = stream_lsn + sectors_per_read;
+            prefetch_end_lsn = window_end;
+        }
+
         // Read request
         bool handling_request = false;
         u32 request_lsn;
@@ -197,13 +346,13 @@ void cdvdThread()
         }
 
         if (!handling_request) {
-            if (prefetches_left == 0)
+            if (next_prefetch_lsn >= prefetch_end_lsn || next_prefetch_lsn >= src->GetSectorCount()) {
+                prefetch_end_lsn = next_prefetch_lsn;
                 continue;
+            }
 
-            --prefetches_left;
-
-            u32 next_prefetch_lsn = g_last_sector_block_lsn + sectors_per_read;
             request_lsn = next_prefetch_lsn;
+            next_prefetch_lsn += sectors_per_read;
         }
 
         // Handle request
@@ -212,7 +361,7 @@ void cdvdThread()
                 cdvdCacheUpdate(request_lsn, buffer);
             } else {
                 // If the read fails, further reads are likely to fail too.
-                prefetches_left = 0;
+                prefetch_end_lsn = next_prefetch_lsn;
                 continue;
             }
         }
@@ -222,21 +371,30 @@ void cdvdThread()
         if (!handling_request)
             continue;
 
-        // Prefetch
-        u32 next_prefetch_lsn = g_last_sector_block_lsn + sectors_per_read;
-        if (next_prefetch_lsn >= src->GetSectorCount()) {
-            prefetches_left = 0;
-        } else {
-            const u32 max_prefetches = 16;
-            u32 remaining = src->GetSectorCount() - next_prefetch_lsn;
-            prefetches_left = std::min((remaining + sectors_per_read - 1) / sectors_per_read, max_prefetches);
-        }
+        // Prefetch the extent after the request, much further when streaming
+        const u32 blocks = s_stream_run >= streaming_threshold ? prefetch_blocks_streaming : prefetch_blocks_random;
+        next_prefetch_lsn = request_lsn + sectors_per_read;
+        prefetch_end_lsn = std::min(next_prefetch_lsn + sectors_per_read * blocks, src->GetSectorCount());
     }
+
+    cdvdPrintStats(stats_start);
     printf(" * CDVD: IO thread finished.\n");
 }
 
 bool cdvdStartThread()
 {
+    cdvdCacheResize(cdvdCacheBlocksFromSettings());
+    if (s_cache.empty())
+        printf(" * CDVD: out of memory, running without a sector cache\n");
+    else
+        printf(" * CDVD: %u MB sector cache\n", static_cast<u32>((s_cache.size() * sizeof(SectorInfo)) >> 20));
+
+    s_last_request_block = invalid_lsn;
+    s_stream_run = 0;
+    s_stream_lsn = 0;
+    s_cache_hits = s_cache_misses = s_seeks = 0;
+    s_next_physical_lsn = invalid_lsn;
+
     cdvd_is_open = true;
     try {
         s_thread = std::thread(cdvdThread);
@@ -245,8 +403,6 @@ bool cdvdStartThread()
         return false;
     }
 
-    cdvdCacheReset();
-
     return true;
 }
 
@@ -255,6 +411,23 @@ void cdvdStopThread()
     cdvd_is_open = false;
     s_notify_cv.notify_one();
     s_thread.join();
+
+    cdvdCacheResize(0);
+}
+
+static void cdvdTrackStreaming(u32 sector_block)
+{
+    // Only the emulator thread requests sectors
+    if (sector_block == s_last_request_block)
+        return;
+
+    if (s_last_request_block != invalid_lsn && sector_block == s_last_request_block + sectors_per_read)
+        ++s_stream_run;
+    else
+        s_stream_run = 0;
+
+    s_last_request_block = sector_block;
+    s_stream_lsn = sector_block;
 }
 
 s32 cdvdRequestSector(u32 sector, s32 mode)
@@ -262,11 +435,21 @@ s32 cdvdRequestSector(u32 sector, s32 mode)
     if (sector >= src->GetSectorCount())
         return -1;
 
+    // Without a cache, cdvdGetSector reads the sectors itself
+    if (s_cache.empty())
+        return 0;
+
     // Align to cache block
     sector &= ~(sectors_per_read - 1);
 
-    if (cdvdCacheCheck(sector))
+    cdvdTrackStreaming(sector);
+
+    if (cdvdCacheCheck(sector)) {
+        // Let the thread keep its read-ahead going
+        if (s_stream_run >= streaming_threshold)
+            s_notify_cv.notify_one();
         return 0;
+    }
 
     {
         std::lock_guard<std::mutex> guard(s_request_lock);
@@ -52,8 +52,6 @@
 #define DEV9_LOG(...)
 #endif
 
-void rx_process(NetPacket* pk);
-bool rx_fifo_can_rx();
 
 #define ETH_DEF		"eth0"
 #define HDD_DEF		"DEV9hdd.raw"
@@ -26,14 +26,14 @@ volatile bool RxRunning=false;
 
 void *NetRxThread(void *arg)
 {
-    NetPacket tmp;
+    //only the queue is touched here, smap_async moves the packets into the SMAP on the EE thread
     while(RxRunning)
     {
-        while(rx_fifo_can_rx() && nif->recv(&tmp))
-        {
-            rx_process(&tmp);
-        }
-
+        u32 room=rx_queue.room();
+        if(room)
+            nif->recvBatch(room);   //blocks for up to the pcap read timeout
+        else
+            usleep(1000);           //the EE side is behind, let the host buffer the packets
     }
 
     return 0;
@@ -45,9 +45,17 @@ void tx_put(NetPacket* pkt)
     //pkt must be copied if its not processed by here, since it can be allocated on the callers stack
 }
 
+void tx_put_frames(const NetFrame* frames, int count)
+{
+    nif->sendBatch(frames, count);
+    //same as above, the frames point into the tx fifo
+}
+
 void InitNet(NetAdapter* ad)
 {
     nif=ad;
+    rx_queue.clear();
+    rx_stats.clear();
     RxRunning=true;
 
        pthread_attr_t thAttr;
@@ -73,6 +81,7 @@ void TermNet()
         emu_printf("Waiting for RX-net thread to terminate..");
             pthread_join(rx_thread,NULL);
         emu_printf(".done\n");
+        rx_log_stats();
 
         delete nif;
     }
@@ -26,15 +26,12 @@ volatile bool RxRunning=false;
 //rx thread
 DWORD WINAPI NetRxThread(LPVOID lpThreadParameter)
 {	
-	NetPacket tmp;
+	//only the queue is touched here, smap_async moves the packets into the SMAP on the EE thread
 	while(RxRunning)
 	{
-		while(rx_fifo_can_rx() && nif->recv(&tmp))
-		{
-			rx_process(&tmp);
-		}
-		
-		Sleep(10);
+		u32 room=rx_queue.room();
+		if(!room || !nif->recvBatch(room))
+			Sleep(10);
 	}
 
 	return 0;
@@ -46,9 +43,18 @@ void tx_put(NetPacket* pkt)
 		nif->send(pkt);
 	//pkt must be copied if its not processed by here, since it can be allocated on the callers stack
 }
+
+void tx_put_frames(const NetFrame* frames, int count)
+{
+	if (nif!=NULL)
+		nif->sendBatch(frames, count);
+	//same as above, the frames point into the tx fifo
+}
 void InitNet(NetAdapter* ad)
 {
 	nif=ad;
+	rx_queue.clear();
+	rx_stats.clear();
 	RxRunning=true;
 
 	rx_thread=CreateThread(0,0,NetRxThread,0,CREATE_SUSPENDED,0);
@@ -64,6 +70,7 @@ void TermNet()
 		emu_printf("Waiting for RX-net thread to terminate..");
 		WaitForSingleObject(rx_thread, -1);
 		emu_printf(".done\n");
+		rx_log_stats();
 
 		delete nif;
 		nif = NULL;
@@ -16,6 +16,9 @@
 #pragma once
 #include <stdlib.h>
 #include <string.h>  //uh isnt memcpy @ stdlib ?
+#include <atomic>
+#include <chrono>
+#include "Pcsx2Types.h"
 
 struct NetPacket
 {
@@ -25,6 +28,13 @@ struct NetPacket
 	int size;
 	char buffer[2048-sizeof(int)];//1536 is realy needed, just pad up to 2048 bytes :)
 };
+
+//a frame to send, left where it already is (usually the SMAP TX fifo)
+struct NetFrame
+{
+	const char* data;
+	int size;
+};
 /*
 extern mtfifo<NetPacket*> rx_fifo;
 extern mtfifo<NetPacket*> tx_fifo;
@@ -37,9 +47,126 @@ public:
 	virtual bool isInitialised() = 0;
 	virtual bool recv(NetPacket* pkt)=0;	//gets a packet
 	virtual bool send(NetPacket* pkt)=0;	//sends the packet and deletes it when done
+	virtual int recvBatch(int max);			//hands up to max packets to rx_put, returns how many
+	virtual int sendBatch(const NetFrame* frames, int count);	//sends the frames in order, returns how many were sent
 	virtual ~NetAdapter(){}
 };
 
+//Packets from the host wait here until smap_async (on the EE thread) moves them into the SMAP
+//rx fifo.  Single producer (the rx thread), single consumer.
+class NetRxQueue
+{
+public:
+	static const u32 Size=64;	//power of two, as many as the SMAP has rx buffer descriptors
+
+	struct Entry
+	{
+		NetPacket pkt;
+		std::chrono::steady_clock::time_point received;
+	};
+
+	NetRxQueue() : head(0), tail(0) {}
+
+	//rx thread
+	u32 room() const
+	{
+		return Size-(head.load(std::memory_order_relaxed)-tail.load(std::memory_order_acquire));
+	}
+	bool push(const char* data, int size)
+	{
+		const u32 h=head.load(std::memory_order_relaxed);
+		if(h-tail.load(std::memory_order_acquire)==Size)
+			return false;
+
+		Entry& e=slots[h&(Size-1)];
+		e.pkt.size=size;
+		memcpy(e.pkt.buffer,data,size);
+		e.received=std::chrono::steady_clock::now();
+		head.store(h+1,std::memory_order_release);
+		return true;
+	}
+
+	//EE thread
+	const Entry* front() const
+	{
+		const u32 t=tail.load(std::memory_order_relaxed);
+		return (head.load(std::memory_order_acquire)==t) ? NULL : &slots[t&(Size-1)];
+	}
+	void pop()
+	{
+		tail.store(tail.load(std::memory_order_relaxed)+1,std::memory_order_release);
+	}
+
+	u32 depth() const
+	{
+		return head.load(std::memory_order_acquire)-tail.load(std::memory_order_acquire);
+	}
+
+	//only while the rx thread isn't running
+	void clear()
+	{
+		head=0;
+		tail=0;
+	}
+
+private:
+	Entry slots[Size];
+	std::atomic<u32> head;
+	std::atomic<u32> tail;
+};
+
+//since InitNet, for monitoring online play
+struct NetRxStats
+{
+	std::atomic<u32> received;		//packets queued by the rx thread
+	std::atomic<u32> delivered;		//packets moved into the SMAP rx fifo
+	std::atomic<u32> dropped;		//packets lost because the queue or an rx buffer descriptor was full
+	std::atomic<u32> maxDepth;		//most packets waiting in the queue at once
+	std::atomic<u64> waitUs;		//total time the delivered packets spent in the queue
+
+	void clear()
+	{
+		received=0;
+		delivered=0;
+		dropped=0;
+		maxDepth=0;
+		waitUs=0;
+	}
+};
+
+extern NetRxQueue rx_queue;
+extern NetRxStats rx_stats;
+
+void rx_put(const char* data, int size);	//rx thread
+void rx_drain();							//EE thread, moves queued packets into the rx fifo
+void rx_log_stats();
+
+//adapters that have their own packet buffers override these to skip the copy through NetPacket
+inline int NetAdapter::recvBatch(int max)
+{
+	NetPacket pkt;
+	int n=0;
+	while(n<max && recv(&pkt))
+	{
+		rx_put(pkt.buffer,pkt.size);
+		n++;
+	}
+	return n;
+}
+
+inline int NetAdapter::sendBatch(const NetFrame* frames, int count)
+{
+	int n=0;
+	for(;n<count;n++)
+	{
+		NetPacket pkt((void*)frames[n].data,frames[n].size);
+		if(!send(&pkt))
+			break;
+	}
+	return n;
+}
+
 void tx_put(NetPacket* ptr);
+void tx_put_frames(const NetFrame* frames, int count);
 void InitNet(NetAdapter* adapter);
 void TermNet();
\ No newline at end of file
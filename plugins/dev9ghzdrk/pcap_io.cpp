@@ -15,6 +15,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <algorithm>
 #include "pcap.h"
 #include "pcap_io.h"
 
@@ -25,6 +26,7 @@
 #include <Iphlpapi.h>
 #elif defined(__linux__)
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <net/if.h>
 #endif
 
@@ -197,11 +199,8 @@ int gettimeofday (struct timeval *tv, void* tz)
 } 
 #endif
 
-int pcap_io_send(void* packet, int plen)
+static void pcap_io_dump(const void* packet, int plen)
 {
-	if(pcap_io_running<=0)
-		return -1;
-
 	if(dump_pcap)
 	{
 		static struct pcap_pkthdr ph;
@@ -210,10 +209,83 @@ int pcap_io_send(void* packet, int plen)
 		ph.len=plen;
 		pcap_dump((u_char*)dump_pcap,&ph,(u_char*)packet);
 	}
+}
+
+int pcap_io_send(void* packet, int plen)
+{
+	if(pcap_io_running<=0)
+		return -1;
+
+	pcap_io_dump(packet, plen);
 
 	return pcap_sendpacket(adhandle, (u_char*)packet, plen);
 }
 
+//sends the frames with as few syscalls as possible, returns how many were sent
+int pcap_io_send_batch(const NetFrame* frames, int count)
+{
+	if(pcap_io_running<=0)
+		return -1;
+
+	for(int i=0;i<count;i++)
+		pcap_io_dump(frames[i].data, frames[i].size);
+
+	int sent=0;
+
+#ifdef __linux__
+	//pcap_sendpacket is a send() on the packet socket, so several frames can go in one sendmmsg()
+	const int fd=pcap_fileno(adhandle);
+	while(fd>=0 && sent<count)
+	{
+		struct mmsghdr msgs[64];
+		struct iovec iov[64];
+		const int n=std::min(count-sent,64);
+
+		memset(msgs,0,sizeof(msgs[0])*n);
+		for(int i=0;i<n;i++)
+		{
+			iov[i].iov_base=(void*)frames[sent+i].data;
+			iov[i].iov_len=frames[sent+i].size;
+			msgs[i].msg_hdr.msg_iov=&iov[i];
+			msgs[i].msg_hdr.msg_iovlen=1;
+		}
+
+		const int rv=sendmmsg(fd,msgs,n,0);
+		if(rv<=0)
+			break; //let pcap have a go at the rest
+		sent+=rv;
+	}
+#endif
+
+	for(;sent<count;sent++)
+	{
+		if(pcap_sendpacket(adhandle,(u_char*)frames[sent].data,frames[sent].size))
+			break;
+	}
+
+	return sent;
+}
+
+static void pcap_io_deliver(u_char* user, const struct pcap_pkthdr* header, const u_char* pkt_data)
+{
+	if(header->caplen>sizeof(NetPacket::buffer))
+		return;
+
+	if(dump_pcap)
+		pcap_dump((u_char*)dump_pcap,header,pkt_data);
+
+	rx_put((const char*)pkt_data,header->caplen);
+}
+
+//hands up to max packets from pcap's buffer to rx_put, returns how many
+int pcap_io_recv_batch(int max)
+{
+	if(pcap_io_running<=0)
+		return -1;
+
+	return pcap_dispatch(adhandle,max,pcap_io_deliver,NULL);
+}
+
 int pcap_io_recv(void* packet, int max_len)
 {
 	static struct pcap_pkthdr *header;
@@ -348,6 +420,14 @@ bool PCAPAdapter::recv(NetPacket* pkt)
 		return true;
 	}
 }
+int PCAPAdapter::recvBatch(int max)
+{
+	return std::max(pcap_io_recv_batch(max),0);
+}
+int PCAPAdapter::sendBatch(const NetFrame* frames, int count)
+{
+	return std::max(pcap_io_send_batch(frames,count),0);
+}
 //sends the packet .rv :true success
 bool PCAPAdapter::send(NetPacket* pkt)
 {
@@ -171,5 +171,8 @@ public:
 	virtual bool recv(NetPacket* pkt);
 	//sends the packet and deletes it when done (if successful).rv :true success
 	virtual bool send(NetPacket* pkt);
+	//from and to pcap's buffers, without going through a NetPacket
+	virtual int recvBatch(int max);
+	virtual int sendBatch(const NetFrame* frames, int count);
 	virtual ~PCAPAdapter();
 };
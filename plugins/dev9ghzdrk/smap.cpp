@@ -26,6 +26,7 @@
 #include <fcntl.h>
 #include <stdarg.h>
 #include <mutex>
+#include <algorithm>
 
 #include "smap.h"
 #include "net.h"
@@ -34,6 +35,8 @@
 
 bool has_link=true;
 volatile bool fireIntR = false;
+NetRxQueue rx_queue;
+NetRxStats rx_stats;
 std::mutex frame_counter_mutex;
 std::mutex reset_mutex;
 /*
@@ -62,14 +65,15 @@ void test()
 	printf ("EMAC3R 0x%08X raw read 0x%08X\n",EMAC3REG_READ(SMAP_EMAC3_STA_CTRL),SMAP_REG32(SMAP_EMAC3_STA_CTRL));
 }*/
 
-//this can return a false positive, but its not problem since it may say it cant recv while it can (no harm done, just delay on packets)
-bool rx_fifo_can_rx()
+//how many full sized frames can be received right now. this can be too low, but its not problem since it may say it cant recv while it can (no harm done, just delay on packets)
+static int rx_fifo_free_frames()
 {
 	//check if RX is on & stuff like that here
 	
 	//Check if there is space on RXBD
-	if (dev9Ru8(SMAP_R_RXFIFO_FRAME_CNT)==64)
-		return false;
+	int frames = 64 - dev9Ru8(SMAP_R_RXFIFO_FRAME_CNT);
+	if (frames<=0)
+		return 0;
 	
 	//Check if there is space on fifo
 	int rd_ptr = dev9Ru32(SMAP_R_RXFIFO_RD_PTR);
@@ -81,31 +85,32 @@ bool rx_fifo_can_rx()
 		space = sizeof(dev9.rxfifo);
 
 	if (space<1514)
-		return false;
+		return 0;
 
-	//we can recv a packet !
-	return true;
+	//we can recv a packet ! the ones after it take 1516 bytes, padded to a word
+	return std::min(frames, 1 + (space-1514)/1516);
 }
 
-void rx_process(NetPacket* pk)
+static bool rx_process(const char* data, int size)
 {
 	smap_bd_t *pbd= ((smap_bd_t *)&dev9.dev9R[SMAP_BD_RX_BASE & 0xffff])+dev9.rxbdi;
 
-	int bytes=(pk->size+3)&(~3);
+	int bytes=(size+3)&(~3);
 
 	if (!(pbd->ctrl_stat & SMAP_BD_RX_EMPTY)) 
 	{
 		emu_printf("ERROR : Discarding %d bytes (RX%d not ready)\n", bytes, dev9.rxbdi);
-		return;
+		return false;
 	}
 
+	//copy in (at most) two pieces since the fifo wraps around, and clear the padding
 	int pstart=(dev9.rxfifo_wr_ptr)&16383;
-	int i=0;
-	while(i<bytes)
-	{
-		dev9_rxfifo_write(pk->buffer[i++]);
-		dev9.rxfifo_wr_ptr&=16383;
-	}
+	int first=std::min(size, 16384-pstart);
+	memcpy(dev9.rxfifo+pstart, data, first);
+	memcpy(dev9.rxfifo, data+first, size-first);
+	for (int i=size;i<bytes;i++)
+		dev9.rxfifo[(pstart+i)&16383]=0;
+	dev9.rxfifo_wr_ptr=(pstart+bytes)&16383;
 
 	//increase RXBD
 	std::unique_lock<std::mutex> reset_lock(reset_mutex);
@@ -113,7 +118,7 @@ void rx_process(NetPacket* pk)
 	dev9.rxbdi&=(SMAP_BD_SIZE/8)-1;
 
 	//Fill the BD with info !
-	pbd->length = pk->size;
+	pbd->length = size;
 	pbd->pointer = 0x4000 + pstart;
 	pbd->ctrl_stat&= ~SMAP_BD_RX_EMPTY;
 
@@ -122,10 +127,60 @@ void rx_process(NetPacket* pk)
 	dev9Ru8(SMAP_R_RXFIFO_FRAME_CNT)++;
 	counter_lock.unlock();
 	reset_lock.unlock();
-	//spams// emu_printf("Got packet, %d bytes (%d fifo)\n", pk->size,bytes);
+	//spams// emu_printf("Got packet, %d bytes (%d fifo)\n", size,bytes);
 	fireIntR = true;
 	//_DEV9irq(SMAP_INTR_RXEND,0);//now ? or when the fifo is full ? i guess now atm
-								//note that this _is_ wrong since the IOP interrupt system is not thread safe.. but nothing i can do about that
+	return true;
+}
+
+void rx_put(const char* data, int size)
+{
+	if (!rx_queue.push(data, size))
+	{
+		rx_stats.dropped++;
+		return;
+	}
+
+	rx_stats.received++;
+
+	//the rx thread is the only writer
+	const u32 depth = rx_queue.depth();
+	if (depth > rx_stats.maxDepth)
+		rx_stats.maxDepth = depth;
+}
+
+void rx_drain()
+{
+	int room = rx_fifo_free_frames();
+	const NetRxQueue::Entry* e;
+
+	while (room > 0 && (e = rx_queue.front()) != NULL)
+	{
+		const bool placed = rx_process(e->pkt.buffer, e->pkt.size);
+		if (placed)
+		{
+			const auto wait = std::chrono::steady_clock::now() - e->received;
+			rx_stats.waitUs += std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+			rx_stats.delivered++;
+			room--;
+		}
+		else
+			rx_stats.dropped++;
+
+		rx_queue.pop();
+
+		//the rx buffer descriptors are busy, try the rest next time
+		if (!placed)
+			break;
+	}
+}
+
+void rx_log_stats()
+{
+	const u32 delivered = rx_stats.delivered;
+	emu_printf("RX: %u received, %u delivered, %u dropped, max queue depth %u, average wait %u us\n",
+		(u32)rx_stats.received, delivered, (u32)rx_stats.dropped, (u32)rx_stats.maxDepth,
+		delivered ? (u32)(rx_stats.waitUs / delivered) : 0);
 }
 
 u32 wswap(u32 d)
@@ -140,6 +195,9 @@ void tx_process()
 	//spams// printf("tx_process : %u cnt frames !\n",cnt);
 
 	NetPacket pk;
+	//frames that don't wrap around the fifo are sent from it directly, in one batch
+	NetFrame frames[SMAP_BD_SIZE/8];
+	int queued=0;
 	u32 fc=0;
 	for (fc=0;fc<cnt;fc++)
 	{
@@ -212,12 +270,23 @@ void tx_process()
 				memcpy(pk.buffer,dev9.txfifo+base,was);
 				memcpy(pk.buffer+was,dev9.txfifo,pbd->length-was);
 				printf("Warped read, was=%u, sz=%u, sz-was=%u\n", was, pbd->length, pbd->length-was);
+
+				//keep the order
+				if(queued)
+					tx_put_frames(frames,queued);
+				queued=0;
+				tx_put(&pk);
 			}
 			else
 			{
-				memcpy(pk.buffer,dev9.txfifo+base,pbd->length);
+				frames[queued].data=(const char*)dev9.txfifo+base;
+				frames[queued].size=pbd->length;
+				if(++queued==SMAP_BD_SIZE/8)
+				{
+					tx_put_frames(frames,queued);
+					queued=0;
+				}
 			}
-			tx_put(&pk);
 		}
 
 
@@ -231,6 +300,9 @@ void tx_process()
 		dev9Ru8(SMAP_R_TXFIFO_FRAME_CNT)--;
 	}
 
+	if(queued)
+		tx_put_frames(frames,queued);
+
 	//spams// emu_printf("processed %u frames, %u count, cnt = %u\n",fc,dev9Ru8(SMAP_R_TXFIFO_FRAME_CNT),cnt);
 	//if some error/early exit signal TXDNV
 	if (fc!=cnt || cnt==0)
@@ -865,6 +937,8 @@ smap_writeDMA8Mem(u32* pMem, int size)
 EXPORT_C_(void)
 smap_async(u32 cycles)
 {
+	rx_drain();
+
 	if (fireIntR)
 	{
 		fireIntR = false;
@@ -82,6 +82,8 @@ extern int dplLevel;
 extern u32 OutputModule;
 extern int SndOutLatencyMS;
 extern int SynchMode;
+extern bool ThreadedTimeStretch;
+extern int TimeStretchBatch;
 
 #ifndef __POSIX__
 extern wchar_t dspPlugin[];
@@ -24,178 +24,209 @@
 #include "Global.h"
 #include "Alsa.h"
 #include "SndOut.h"
+#include "Dialogs.h"
 
-// Does not work, except as effectively a null plugin.
+#include <atomic>
+#include <thread>
+
+// Blocking writer thread, one SndOutPacketSize period per write.  Uses mmap access when
+// the device supports it, which avoids an extra copy through the kernel on hw devices.
 class AlsaMod : public SndOutModule
 {
 protected:
-    static const int PacketsPerBuffer = 1; // increase this if ALSA can't keep up with 512-sample packets
-    static const int MAX_BUFFER_COUNT = 4;
-    static const int NumBuffers = 4; // TODO: this should be configurable someday -- lower values reduce latency.
+    static const int PeriodsMin = 2;
+    static const int PeriodsMax = 16;
+
     unsigned int pspeed;
 
     snd_pcm_t *handle;
-    snd_pcm_uframes_t buffer_size;
-    snd_async_handler_t *pcm_callback;
-
-    uint period_time;
-    uint buffer_time;
-
-protected:
-    // Invoked by the static ExternalCallback method below.
-    void _InternalCallback()
-    {
-        snd_pcm_sframes_t avail;
-        fprintf(stderr, "* SPU2-X:Iz in your internal callback.\n");
+    bool m_mmap;
 
-        avail = snd_pcm_avail_update(handle);
-        while (avail >= (int)period_time) {
-            StereoOut16 buff[PacketsPerBuffer * SndOutPacketSize];
-            StereoOut16 *p1 = buff;
+    std::thread m_thread;
+    std::atomic<bool> m_exit;
 
-            for (int p = 0; p < PacketsPerBuffer; p++, p1 += SndOutPacketSize)
-                SndBuffer::ReadSamples(p1);
+    // Written by the writer thread only; the pcm handle is not touched from other threads.
+    std::atomic<int> m_avail;
+    std::atomic<u32> m_xruns;
 
-            snd_pcm_writei(handle, buff, period_time);
-            avail = snd_pcm_avail_update(handle);
-        }
-    }
+    wxString m_Device;
+    int m_Periods;
 
-    // Preps and invokes the _InternalCallback above.  This provides a cdecl-compliant
-    // entry point for our C++ified object state. :)
-    static void ExternalCallback(snd_async_handler_t *pcm_call)
+protected:
+    void WriterThread()
     {
-        fprintf(stderr, "* SPU2-X:Iz in your external callback.\n");
-        AlsaMod *data = (AlsaMod *)snd_async_handler_get_callback_private(pcm_call);
+        StereoOut16 buff[SndOutPacketSize];
 
-        pxAssume(data != NULL);
-        //pxAssume( data->handle == snd_async_handler_get_pcm(pcm_call) );
+        while (!m_exit.load(std::memory_order_relaxed)) {
+            SndBuffer::ReadSamples(buff);
 
-        // Not sure if we just need an assert, or something like this:
-        if (data->handle != snd_async_handler_get_pcm(pcm_call)) {
-            fprintf(stderr, "* SPU2-X: Failed to handle sound.\n");
-            return;
-        }
+            const StereoOut16 *p = buff;
+            snd_pcm_uframes_t left = SndOutPacketSize;
 
-        data->_InternalCallback();
-    }
+            while (left > 0 && !m_exit.load(std::memory_order_relaxed)) {
+                snd_pcm_sframes_t written = m_mmap ? snd_pcm_mmap_writei(handle, p, left) : snd_pcm_writei(handle, p, left);
 
-public:
-    s32 Init()
-    {
-        //fprintf(stderr,"* SPU2-X: Initing Alsa\n");
-        snd_pcm_hw_params_t *hwparams;
-        snd_pcm_sw_params_t *swparams;
-        snd_pcm_status_t *status;
-        int pchannels = 2;
-        snd_pcm_format_t format = SND_PCM_FORMAT_S16_LE;
+                if (written == -EAGAIN)
+                    continue;
 
-        handle = NULL;
-        pcm_callback = NULL;
-        pspeed = SAMPLE_RATE;
+                if (written < 0) {
+                    if (written == -EPIPE)
+                        m_xruns.fetch_add(1, std::memory_order_relaxed);
 
-        // buffer time and period time are in microseconds...
-        // (don't simplify the equation below -- it'll just cause integer rounding errors.
-        period_time = (SndOutPacketSize * 1000) / (SampleRate / 1000);
-        buffer_time = period_time * NumBuffers;
+                    if (snd_pcm_recover(handle, written, 1) < 0) {
+                        fprintf(stderr, "* SPU2-X: Alsa write error: %s\n", snd_strerror(written));
+                        return;
+                    }
+                    continue;
+                }
 
-        int err;
+                p += written;
+                left -= written;
+            }
 
-        err = snd_pcm_open(&handle, "default", SND_PCM_STREAM_PLAYBACK, SND_PCM_ASYNC /*| SND_PCM_NONBLOCK*/);
-        if (err < 0) {
-            fprintf(stderr, "Audio open error: %s\n", snd_strerror(err));
-            return -1;
-        }
-
-        err = snd_pcm_nonblock(handle, 0);
-        if (err < 0) {
-            fprintf(stderr, "Can't set blocking mode: %s\n", snd_strerror(err));
-            return -1;
+            const snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
+            m_avail.store(avail < 0 ? 0 : (int)avail, std::memory_order_relaxed);
         }
+    }
 
+    bool SetHwParams(snd_pcm_access_t access)
+    {
+        snd_pcm_hw_params_t *hwparams;
         snd_pcm_hw_params_alloca(&hwparams);
-        snd_pcm_sw_params_alloca(&swparams);
 
-        err = snd_pcm_hw_params_any(handle, hwparams);
+        int err = snd_pcm_hw_params_any(handle, hwparams);
         if (err < 0) {
             fprintf(stderr, "Broken configuration for this PCM: %s\n", snd_strerror(err));
-            return -1;
+            return false;
         }
 
-        err = snd_pcm_hw_params_set_access(handle, hwparams, SND_PCM_ACCESS_RW_INTERLEAVED);
-        if (err < 0) {
-            fprintf(stderr, "Access type not available: %s\n", snd_strerror(err));
-            return -1;
-        }
+        err = snd_pcm_hw_params_set_access(handle, hwparams, access);
+        if (err < 0)
+            return false;
 
-        err = snd_pcm_hw_params_set_format(handle, hwparams, format);
+        err = snd_pcm_hw_params_set_format(handle, hwparams, SND_PCM_FORMAT_S16_LE);
         if (err < 0) {
             fprintf(stderr, "Sample format not available: %s\n", snd_strerror(err));
-            return -1;
+            return false;
         }
 
-        err = snd_pcm_hw_params_set_channels(handle, hwparams, pchannels);
+        err = snd_pcm_hw_params_set_channels(handle, hwparams, 2);
         if (err < 0) {
             fprintf(stderr, "Channels count not available: %s\n", snd_strerror(err));
-            return -1;
+            return false;
         }
+
         err = snd_pcm_hw_params_set_rate_near(handle, hwparams, &pspeed, 0);
         if (err < 0) {
             fprintf(stderr, "Rate not available: %s\n", snd_strerror(err));
-            return -1;
+            return false;
         }
 
-        err = snd_pcm_hw_params_set_buffer_time_near(handle, hwparams, &buffer_time, 0);
+        snd_pcm_uframes_t period = SndOutPacketSize;
+        err = snd_pcm_hw_params_set_period_size_near(handle, hwparams, &period, 0);
         if (err < 0) {
-            fprintf(stderr, "Buffer time error: %s\n", snd_strerror(err));
-            return -1;
+            fprintf(stderr, "Period size error: %s\n", snd_strerror(err));
+            return false;
         }
 
-        err = snd_pcm_hw_params_set_period_time_near(handle, hwparams, &period_time, 0);
+        unsigned int periods = m_Periods;
+        err = snd_pcm_hw_params_set_periods_near(handle, hwparams, &periods, 0);
         if (err < 0) {
-            fprintf(stderr, "Period time error: %s\n", snd_strerror(err));
-            return -1;
+            fprintf(stderr, "Period count error: %s\n", snd_strerror(err));
+            return false;
         }
 
         err = snd_pcm_hw_params(handle, hwparams);
         if (err < 0) {
             fprintf(stderr, "Unable to install hw params: %s\n", snd_strerror(err));
-            return -1;
+            return false;
         }
 
-        snd_pcm_status_alloca(&status);
-        err = snd_pcm_status(handle, status);
+        fprintf(stderr, "* SPU2-X: Alsa %s access, %lu frames x %u periods (%.1f ms)\n",
+                access == SND_PCM_ACCESS_MMAP_INTERLEAVED ? "mmap" : "rw",
+                (unsigned long)period, periods, period * periods * 1000.0 / pspeed);
+
+        return true;
+    }
+
+    bool SetSwParams()
+    {
+        snd_pcm_sw_params_t *swparams;
+        snd_pcm_sw_params_alloca(&swparams);
+
+        int err = snd_pcm_sw_params_current(handle, swparams);
+        if (err < 0)
+            return false;
+
+        // Start as soon as the first period is in, and wake up once per period.
+        snd_pcm_sw_params_set_start_threshold(handle, swparams, SndOutPacketSize);
+        snd_pcm_sw_params_set_avail_min(handle, swparams, SndOutPacketSize);
+
+        err = snd_pcm_sw_params(handle, swparams);
         if (err < 0) {
-            fprintf(stderr, "Unable to get status: %s\n", snd_strerror(err));
-            return -1;
+            fprintf(stderr, "Unable to install sw params: %s\n", snd_strerror(err));
+            return false;
         }
 
-        // Bind our asynchronous callback magic:
+        return true;
+    }
 
-        if (handle == NULL)
-            fprintf(stderr, "No handle.");
+public:
+    AlsaMod()
+        : handle(NULL)
+        , m_mmap(false)
+        , m_exit(false)
+        , m_avail(0)
+        , m_xruns(0)
+        , m_Periods(PeriodsMin)
+    {
+    }
 
-        //fprintf(stderr,"* SPU2-X:Iz setting your internal callback.\n");
-        // The external handler never seems to get called after this.
-        snd_async_add_pcm_handler(&pcm_callback, handle, ExternalCallback, this);
-        err = snd_pcm_start(handle);
+    s32 Init()
+    {
+        ReadSettings();
+
+        pspeed = SAMPLE_RATE;
+        m_xruns = 0;
+        m_avail = 0;
+
+        int err = snd_pcm_open(&handle, m_Device.utf8_str(), SND_PCM_STREAM_PLAYBACK, 0);
         if (err < 0) {
-            fprintf(stderr, "Pcm start failed: %s\n", snd_strerror(err));
+            fprintf(stderr, "Audio open error: %s\n", snd_strerror(err));
+            handle = NULL;
+            return -1;
+        }
+
+        m_mmap = SetHwParams(SND_PCM_ACCESS_MMAP_INTERLEAVED);
+        if (!m_mmap && !SetHwParams(SND_PCM_ACCESS_RW_INTERLEAVED)) {
+            fprintf(stderr, "Access type not available\n");
+            Close();
             return -1;
         }
-        // Diagnostic code:
-        //buffer_size = snd_pcm_status_get_avail(status);
 
-        //fprintf(stderr,"All set up.\n");
+        if (!SetSwParams()) {
+            Close();
+            return -1;
+        }
+
+        m_exit = false;
+        m_thread = std::thread(&AlsaMod::WriterThread, this);
+
         return 0;
     }
 
     void Close()
     {
-        //fprintf(stderr,"* SPU2-X: Closing Alsa\n");
         if (handle == NULL)
             return;
 
+        m_exit = true;
+        if (m_thread.joinable())
+            m_thread.join();
+
+        if (m_xruns != 0)
+            fprintf(stderr, "* SPU2-X: Alsa had %u xruns\n", m_xruns.load());
+
         snd_pcm_drop(handle);
         snd_pcm_close(handle);
         handle = NULL;
@@ -214,16 +245,8 @@ public:
 
     int GetEmptySampleCount()
     {
-        if (handle == NULL) {
-            fprintf(stderr, "Handle is NULL!\n");
-            return 0;
-        }
-
-        // Returns the amount of free buffer space, in samples.
-        int l = snd_pcm_avail_update(handle);
-        if (l < 0)
-            return 0;
-        return (l / 1000) * (SampleRate / 1000);
+        // Returns the amount of free buffer space, in samples, as of the last write.
+        return m_avail.load(std::memory_order_relaxed);
     }
 
     const wchar_t *GetIdent() const
@@ -238,6 +261,9 @@ public:
 
     void ReadSettings()
     {
+        CfgReadStr(L"ALSA", L"Device", m_Device, L"default");
+        m_Periods = CfgReadInt(L"ALSA", L"Periods", PeriodsMin);
+        Clampify(m_Periods, PeriodsMin, PeriodsMax);
     }
 
     void SetApiSettings(wxString api)
@@ -246,6 +272,8 @@ public:
 
     void WriteSettings() const
     {
+        CfgWriteStr(L"ALSA", L"Device", m_Device);
+        CfgWriteInt(L"ALSA", L"Periods", m_Periods);
     }
 } static Alsa;
 
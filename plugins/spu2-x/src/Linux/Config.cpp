@@ -76,6 +76,8 @@ bool _visual_debug_enabled = false; // windows only feature
 u32 OutputModule = 0;
 int SndOutLatencyMS = 300;
 int SynchMode = 0; // Time Stretch, Async or Disabled
+bool ThreadedTimeStretch = false; // Time Stretch runs on its own thread instead of the emulator's
+int TimeStretchBatch = 1;         // Packets handed to SoundTouch per call
 static u32 OutputAPI = 0;
 static u32 SdlOutputAPI = 0;
 
@@ -157,6 +159,9 @@ void ReadSettings()
 
     SndOutLatencyMS = CfgReadInt(L"OUTPUT", L"Latency", 300);
     SynchMode = CfgReadInt(L"OUTPUT", L"Synch_Mode", 0);
+    ThreadedTimeStretch = CfgReadBool(L"OUTPUT", L"Threaded_TimeStretch", false);
+    TimeStretchBatch = CfgReadInt(L"OUTPUT", L"TimeStretch_Batch", 1);
+    Clampify(TimeStretchBatch, 1, 8);
 
     PortaudioOut->ReadSettings();
 #ifdef __unix__
@@ -201,6 +206,8 @@ void WriteSettings()
     CfgWriteStr(L"OUTPUT", L"Output_Module", mods[OutputModule]->GetIdent());
     CfgWriteInt(L"OUTPUT", L"Latency", SndOutLatencyMS);
     CfgWriteInt(L"OUTPUT", L"Synch_Mode", SynchMode);
+    CfgWriteBool(L"OUTPUT", L"Threaded_TimeStretch", ThreadedTimeStretch);
+    CfgWriteInt(L"OUTPUT", L"TimeStretch_Batch", TimeStretchBatch);
     CfgWriteInt(L"DEBUG", L"DelayCycles", delayCycles);
 
     PortaudioOut->WriteSettings();
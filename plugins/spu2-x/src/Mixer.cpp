@@ -16,6 +16,9 @@
  */
 
 #include "Global.h"
+#include "Spu2replay.h"
+
+#include <emmintrin.h>
 
 // Games have turned out to be surprisingly sensitive to whether a parked, silent voice is being fully emulated.
 // With Silent Hill: Shattered Memories requiring full processing for no obvious reason, we've decided to
@@ -77,11 +80,50 @@ __forceinline
         GetClamped(sample.Right, -(0x7f00 << bitshift), 0x7f00 << bitshift));
 }
 
+int g_counter_decode_unfiltered = 0;
+
+// Filter 0 has no prediction, so the samples don't depend on each other and the whole block
+// can be decoded at once: (nibble << 28) >> (16 + k) is (nibble << 12) >> k in 16 bits, which
+// can't overflow, hence no clamping either.
+static void __forceinline XA_decode_block_unfiltered(s16 *buffer, const s16 *block, s32 &prev1, s32 &prev2)
+{
+    const __m128i count = _mm_cvtsi32_si128(*block & 0xF);
+    const __m128i himask = _mm_set1_epi16((s16)0xF000);
+    const __m128i zero = _mm_setzero_si128();
+
+    // Load the whole 16 byte block (not from &block[1], that could read past the end of spu ram)
+    const __m128i data = _mm_srli_si128(_mm_loadu_si128((const __m128i *)block), 2);
+
+    const __m128i w0 = _mm_unpacklo_epi8(data, zero); // bytes 0-7
+    const __m128i w1 = _mm_unpackhi_epi8(data, zero); // bytes 8-13 (and two zero bytes)
+
+    const __m128i lo0 = _mm_slli_epi16(w0, 12);
+    const __m128i hi0 = _mm_and_si128(_mm_slli_epi16(w0, 8), himask);
+    const __m128i lo1 = _mm_slli_epi16(w1, 12);
+    const __m128i hi1 = _mm_and_si128(_mm_slli_epi16(w1, 8), himask);
+
+    // low nibble first, then high nibble
+    _mm_storeu_si128((__m128i *)&buffer[0], _mm_sra_epi16(_mm_unpacklo_epi16(lo0, hi0), count));
+    _mm_storeu_si128((__m128i *)&buffer[8], _mm_sra_epi16(_mm_unpackhi_epi16(lo0, hi0), count));
+    _mm_storeu_si128((__m128i *)&buffer[16], _mm_sra_epi16(_mm_unpacklo_epi16(lo1, hi1), count));
+    _mm_storel_epi64((__m128i *)&buffer[24], _mm_sra_epi16(_mm_unpackhi_epi16(lo1, hi1), count));
+
+    prev2 = buffer[26];
+    prev1 = buffer[27];
+
+    if (IsDevBuild)
+        g_counter_decode_unfiltered++;
+}
+
 static void __forceinline XA_decode_block(s16 *buffer, const s16 *block, s32 &prev1, s32 &prev2)
 {
     const s32 header = *block;
     const s32 shift = (header & 0xF) + 16;
     const int id = header >> 4 & 0xF;
+    if (id == 0) {
+        XA_decode_block_unfiltered(buffer, block, prev1, prev2);
+        return;
+    }
     if (id > 4 && MsgToConsole())
         ConLog("* SPU2-X: Unknown ADPCM coefficients table id %d\n", id);
     const s32 pred1 = tbl_XA_Factor[id][0];
@@ -495,6 +537,7 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 }
 
 
+template <int InterpType>
 static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 {
     V_Core &thiscore(Cores[coreidx]);
@@ -521,30 +564,8 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
         if (vc.Noise)
             Value = GetNoiseValues(thiscore, voiceidx);
-        else {
-            // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
-            // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
-
-            switch (Interpolation) {
-                case 0:
-                    Value = GetVoiceValues<0>(thiscore, voiceidx);
-                    break;
-                case 1:
-                    Value = GetVoiceValues<1>(thiscore, voiceidx);
-                    break;
-                case 2:
-                    Value = GetVoiceValues<2>(thiscore, voiceidx);
-                    break;
-                case 3:
-                    Value = GetVoiceValues<3>(thiscore, voiceidx);
-                    break;
-                case 4:
-                    Value = GetVoiceValues<4>(thiscore, voiceidx);
-                    break;
-
-                    jNO_DEFAULT;
-            }
-        }
+        else
+            Value = GetVoiceValues<InterpType>(thiscore, voiceidx);
 
         // Update and Apply ADSR  (applies to normal and noise sources)
         //
@@ -601,19 +622,50 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
+// The voices themselves have to be run one after the other (pitch modulation reads the
+// previous voice's output, and IRQs must fire in order), but the gating and the summing
+// into the four dry/wet accumulators is done on all four lanes at once.
+//
+// Keyed-off voices whose envelope has finished only need to be advanced (for NAX/ENDX and
+// IRQs), so they're run in a second pass and left out of the accumulation.  Splitting the
+// passes doesn't change anything they can observe: a dormant voice never updates OutX, so
+// the voice it modulates sees the same value either way.
+template <int InterpType>
 static __forceinline void MixCoreVoices(VoiceMixSet &dest, const uint coreidx)
 {
     V_Core &thiscore(Cores[coreidx]);
 
-    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx) {
-        StereoOut32 VVal(MixVoice(coreidx, voiceidx));
+    static_assert(sizeof(VoiceMixSet) == 16, "VoiceMixSet is expected to be Dry.L, Dry.R, Wet.L, Wet.R");
+    static_assert(sizeof(V_VoiceGates) == 8, "V_VoiceGates is expected to be DryL, DryR, WetL, WetR");
+
+    u32 active = 0;
+    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+        active |= (thiscore.Voices[voiceidx].ADSR.Phase > 0) << voiceidx;
+
+    __m128i acc = _mm_loadu_si128((const __m128i *)&dest);
+
+    for (uint voiceidx = 0, mask = active; mask != 0; ++voiceidx, mask >>= 1) {
+        if (!(mask & 1))
+            continue;
+
+        StereoOut32 VVal(MixVoice<InterpType>(coreidx, voiceidx));
 
         // Note: Results from MixVoice are ranged at 16 bits.
 
-        dest.Dry.Left += VVal.Left & thiscore.VoiceGates[voiceidx].DryL;
-        dest.Dry.Right += VVal.Right & thiscore.VoiceGates[voiceidx].DryR;
-        dest.Wet.Left += VVal.Left & thiscore.VoiceGates[voiceidx].WetL;
-        dest.Wet.Right += VVal.Right & thiscore.VoiceGates[voiceidx].WetR;
+        __m128i val = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)&VVal), _mm_loadl_epi64((const __m128i *)&VVal));
+        __m128i gate = _mm_loadl_epi64((const __m128i *)&thiscore.VoiceGates[voiceidx]);
+        gate = _mm_srai_epi32(_mm_unpacklo_epi16(gate, gate), 16); // s16 gates sign extended, as in the scalar '&'
+
+        acc = _mm_add_epi32(acc, _mm_and_si128(val, gate));
+    }
+
+    _mm_storeu_si128((__m128i *)&dest, acc);
+
+    // Dormant voices: MixVoice only advances them and returns silence.
+    const u32 dormant = ~active & ((1u << V_Core::NumVoices) - 1);
+    for (uint voiceidx = 0, mask = dormant; mask != 0; ++voiceidx, mask >>= 1) {
+        if (mask & 1)
+            MixVoice<InterpType>(coreidx, voiceidx);
     }
 }
 
@@ -694,7 +746,10 @@ StereoOut32 V_Core::Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, c
 
     WaveDump::WriteCore(Index, CoreSrc_PreReverb, TW);
 
+    const u64 reverbStart = replay_profile ? GetCPUTicks() : 0;
     StereoOut32 RV = DoReverb(TW);
+    if (replay_profile)
+        replay_stage_ticks[S2R_Stage_Reverb] += GetCPUTicks() - reverbStart;
 
     WaveDump::WriteCore(Index, CoreSrc_PostReverb, RV);
 
@@ -784,13 +839,10 @@ StereoOut32 Apply_Dealias_Filter(StereoOut32 &SoundStream)
 // used to throttle the output rate of cache stat reports
 static int p_cachestat_counter = 0;
 
-// Gcc does not want to inline it when lto is enabled because some functions growth too much.
-// The function is big enought to see any speed impact. -- Gregory
-#ifndef __POSIX__
-__forceinline
-#endif
-    void
-    Mix()
+// Instantiated per interpolation mode, so that TimeUpdate can resolve the mode once for
+// a whole run of samples instead of once per sample.
+template <int InterpType>
+void Mix()
 {
     // Note: Playmode 4 is SPDIF, which overrides other inputs.
     StereoOut32 InputData[2] =
@@ -809,8 +861,14 @@ __forceinline
 
     // Todo: Replace me with memzero initializer!
     VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty}; // mixed voice data for each core.
-    MixCoreVoices(VoiceData[0], 0);
-    MixCoreVoices(VoiceData[1], 1);
+
+    const u64 voicesStart = replay_profile ? GetCPUTicks() : 0;
+
+    MixCoreVoices<InterpType>(VoiceData[0], 0);
+    MixCoreVoices<InterpType>(VoiceData[1], 1);
+
+    if (replay_profile)
+        replay_stage_ticks[S2R_Stage_Voices] += GetCPUTicks() - voicesStart;
 
     StereoOut32 Ext(Cores[0].Mix(VoiceData[0], InputData[0], StereoOut32::Empty));
 
@@ -877,14 +935,22 @@ __forceinline
         if (p_cachestat_counter > (48000 * 10)) {
             p_cachestat_counter = 0;
             if (MsgCache())
-                ConLog(" * SPU2 > CacheStats > Hits: %d  Misses: %d  Ignores: %d\n",
+                ConLog(" * SPU2 > CacheStats > Hits: %d  Misses: %d  Ignores: %d  Unfiltered decodes: %d\n",
                        g_counter_cache_hits,
                        g_counter_cache_misses,
-                       g_counter_cache_ignores);
+                       g_counter_cache_ignores,
+                       g_counter_decode_unfiltered);
 
             g_counter_cache_hits =
                 g_counter_cache_misses =
-                    g_counter_cache_ignores = 0;
+                    g_counter_cache_ignores =
+                        g_counter_decode_unfiltered = 0;
         }
     }
 }
+
+template void Mix<0>();
+template void Mix<1>();
+template void Mix<2>();
+template void Mix<3>();
+template void Mix<4>();
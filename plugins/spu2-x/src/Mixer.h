@@ -129,6 +129,7 @@ struct FrequencyResponseFilter
     }
 };
 
+template <int InterpType>
 extern void Mix();
 extern s32 clamp_mix(s32 x, u8 bitshift = 0);
 
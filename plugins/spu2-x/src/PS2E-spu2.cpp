@@ -20,6 +20,8 @@
 #include "Dma.h"
 #include "Dialogs.h"
 
+#include "Utilities/Instrumentation.h"
+
 #ifdef __APPLE__
 #include "PS2Eext.h"
 #endif
@@ -432,6 +434,9 @@ SPU2open(void *pDsp)
     IsOpened = true;
     lClocks = (cyclePtr != NULL) ? *cyclePtr : 0;
 
+    // Picks up the emulator's counters segment, if it publishes one.
+    Instrumentation::Attach();
+
     try {
         SndBuffer::Init();
 
@@ -648,6 +653,18 @@ SPU2setupRecording(int start, void *pData)
     return 0;
 }
 
+EXPORT_C_(void)
+SPU2setFastForward(int enable)
+{
+    SndBuffer::SetFastForward(enable != 0);
+}
+
+EXPORT_C_(void)
+SPU2setMute(int mute)
+{
+    SndBuffer::SetMuted(mute != 0);
+}
+
 EXPORT_C_(s32)
 SPU2freeze(int mode, freezeData *data)
 {
@@ -81,6 +81,12 @@ SPU2irqCallback(void (*SPU2callback)(), void (*DMA4callback)(), void (*DMA7callb
 EXPORT_C_(int)
 SPU2setupRecording(int start, void *pData);
 
+EXPORT_C_(void)
+SPU2setFastForward(int enable);
+
+EXPORT_C_(void)
+SPU2setMute(int mute);
+
 EXPORT_C_(void)
 SPU2setClockPtr(u32 *ptr);
 
@@ -17,6 +17,8 @@
 
 #include "Global.h"
 
+#include <emmintrin.h>
+
 __forceinline s32 V_Core::RevbGetIndexer(s32 offset)
 {
     u32 pos = ReverbX + offset;
@@ -56,24 +58,52 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
     bool R = Cycles & 1;
 
     // Calculate the read/write addresses we'll be needing for this session of reverb.
-
-    const u32 same_src = RevbGetIndexer(R ? RevBuffers.SAME_R_SRC : RevBuffers.SAME_L_SRC);
-    const u32 same_dst = RevbGetIndexer(R ? RevBuffers.SAME_R_DST : RevBuffers.SAME_L_DST);
-    const u32 same_prv = RevbGetIndexer(R ? RevBuffers.SAME_R_PRV : RevBuffers.SAME_L_PRV);
-
-    const u32 diff_src = RevbGetIndexer(R ? RevBuffers.DIFF_L_SRC : RevBuffers.DIFF_R_SRC);
-    const u32 diff_dst = RevbGetIndexer(R ? RevBuffers.DIFF_R_DST : RevBuffers.DIFF_L_DST);
-    const u32 diff_prv = RevbGetIndexer(R ? RevBuffers.DIFF_R_PRV : RevBuffers.DIFF_L_PRV);
-
-    const u32 comb1_src = RevbGetIndexer(R ? RevBuffers.COMB1_R_SRC : RevBuffers.COMB1_L_SRC);
-    const u32 comb2_src = RevbGetIndexer(R ? RevBuffers.COMB2_R_SRC : RevBuffers.COMB2_L_SRC);
-    const u32 comb3_src = RevbGetIndexer(R ? RevBuffers.COMB3_R_SRC : RevBuffers.COMB3_L_SRC);
-    const u32 comb4_src = RevbGetIndexer(R ? RevBuffers.COMB4_R_SRC : RevBuffers.COMB4_L_SRC);
-
-    const u32 apf1_src = RevbGetIndexer(R ? RevBuffers.APF1_R_SRC : RevBuffers.APF1_L_SRC);
-    const u32 apf1_dst = RevbGetIndexer(R ? RevBuffers.APF1_R_DST : RevBuffers.APF1_L_DST);
-    const u32 apf2_src = RevbGetIndexer(R ? RevBuffers.APF2_R_SRC : RevBuffers.APF2_L_SRC);
-    const u32 apf2_dst = RevbGetIndexer(R ? RevBuffers.APF2_R_DST : RevBuffers.APF2_L_DST);
+    // Same as RevbGetIndexer, four taps at a time; the last two slots just repeat same_src.
+
+    enum {
+        TAP_SAME_SRC, TAP_SAME_DST, TAP_SAME_PRV,
+        TAP_DIFF_SRC, TAP_DIFF_DST, TAP_DIFF_PRV,
+        TAP_COMB1_SRC, TAP_COMB2_SRC, TAP_COMB3_SRC, TAP_COMB4_SRC,
+        TAP_APF1_SRC, TAP_APF1_DST, TAP_APF2_SRC, TAP_APF2_DST,
+        TAP_COUNT = 16
+    };
+
+    __aligned16 s32 taps[TAP_COUNT] = {
+        R ? RevBuffers.SAME_R_SRC : RevBuffers.SAME_L_SRC,
+        R ? RevBuffers.SAME_R_DST : RevBuffers.SAME_L_DST,
+        R ? RevBuffers.SAME_R_PRV : RevBuffers.SAME_L_PRV,
+
+        R ? RevBuffers.DIFF_L_SRC : RevBuffers.DIFF_R_SRC,
+        R ? RevBuffers.DIFF_R_DST : RevBuffers.DIFF_L_DST,
+        R ? RevBuffers.DIFF_R_PRV : RevBuffers.DIFF_L_PRV,
+
+        R ? RevBuffers.COMB1_R_SRC : RevBuffers.COMB1_L_SRC,
+        R ? RevBuffers.COMB2_R_SRC : RevBuffers.COMB2_L_SRC,
+        R ? RevBuffers.COMB3_R_SRC : RevBuffers.COMB3_L_SRC,
+        R ? RevBuffers.COMB4_R_SRC : RevBuffers.COMB4_L_SRC,
+
+        R ? RevBuffers.APF1_R_SRC : RevBuffers.APF1_L_SRC,
+        R ? RevBuffers.APF1_R_DST : RevBuffers.APF1_L_DST,
+        R ? RevBuffers.APF2_R_SRC : RevBuffers.APF2_L_SRC,
+        R ? RevBuffers.APF2_R_DST : RevBuffers.APF2_L_DST,
+
+        R ? RevBuffers.SAME_R_SRC : RevBuffers.SAME_L_SRC,
+        R ? RevBuffers.SAME_R_SRC : RevBuffers.SAME_L_SRC,
+    };
+
+    // All addresses fit in 21 bits, so the signed compares are fine here.
+    const __m128i x = _mm_set1_epi32(ReverbX);
+    const __m128i end = _mm_set1_epi32(EffectsEndA);
+    const __m128i wrap = _mm_set1_epi32(EffectsEndA + 1 - EffectsStartA);
+
+    __m128i pos[TAP_COUNT / 4];
+
+    for (int i = 0; i < TAP_COUNT / 4; i++) {
+        __m128i p = _mm_add_epi32(_mm_load_si128((const __m128i *)&taps[i * 4]), x);
+        p = _mm_sub_epi32(p, _mm_and_si128(_mm_cmpgt_epi32(p, end), wrap));
+        _mm_store_si128((__m128i *)&taps[i * 4], p);
+        pos[i] = p;
+    }
 
     // -----------------------------------------
     //          Optimized IRQ Testing !
@@ -86,21 +116,36 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
 
     for (int i = 0; i < 2; i++) {
         if (Cores[i].IRQEnable && ((Cores[i].IRQA >= EffectsStartA) && (Cores[i].IRQA <= EffectsEndA))) {
-            if ((Cores[i].IRQA == same_src) || (Cores[i].IRQA == diff_src) ||
-                (Cores[i].IRQA == same_dst) || (Cores[i].IRQA == diff_dst) ||
-                (Cores[i].IRQA == same_prv) || (Cores[i].IRQA == diff_prv) ||
+            const __m128i irqa = _mm_set1_epi32(Cores[i].IRQA);
+            const __m128i hit = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(pos[0], irqa), _mm_cmpeq_epi32(pos[1], irqa)),
+                _mm_or_si128(_mm_cmpeq_epi32(pos[2], irqa), _mm_cmpeq_epi32(pos[3], irqa)));
 
-                (Cores[i].IRQA == comb1_src) || (Cores[i].IRQA == comb2_src) ||
-                (Cores[i].IRQA == comb3_src) || (Cores[i].IRQA == comb4_src) ||
-
-                (Cores[i].IRQA == apf1_dst) || (Cores[i].IRQA == apf1_src) ||
-                (Cores[i].IRQA == apf2_dst) || (Cores[i].IRQA == apf2_src)) {
+            if (_mm_movemask_epi8(hit)) {
                 //printf("Core %d IRQ Called (Reverb). IRQA = %x\n",i,addr);
                 SetIrqCall(i);
             }
         }
     }
 
+    const u32 same_src = taps[TAP_SAME_SRC];
+    const u32 same_dst = taps[TAP_SAME_DST];
+    const u32 same_prv = taps[TAP_SAME_PRV];
+
+    const u32 diff_src = taps[TAP_DIFF_SRC];
+    const u32 diff_dst = taps[TAP_DIFF_DST];
+    const u32 diff_prv = taps[TAP_DIFF_PRV];
+
+    const u32 comb1_src = taps[TAP_COMB1_SRC];
+    const u32 comb2_src = taps[TAP_COMB2_SRC];
+    const u32 comb3_src = taps[TAP_COMB3_SRC];
+    const u32 comb4_src = taps[TAP_COMB4_SRC];
+
+    const u32 apf1_src = taps[TAP_APF1_SRC];
+    const u32 apf1_dst = taps[TAP_APF1_DST];
+    const u32 apf2_src = taps[TAP_APF2_SRC];
+    const u32 apf2_dst = taps[TAP_APF2_DST];
+
     // Reverb algorithm pretty much directly ripped from http://drhell.web.fc2.com/ps1/
     // minus the 35 step FIR which just seems to break things.
 
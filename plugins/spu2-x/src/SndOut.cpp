@@ -16,7 +16,7 @@
  */
 
 #include "Global.h"
-
+#include "Spu2replay.h"
 
 StereoOut32 StereoOut32::Empty(0, 0);
 
@@ -111,8 +111,11 @@ int FindOutputModuleById(const wchar_t *omodid)
 
 StereoOut32 *SndBuffer::m_buffer;
 s32 SndBuffer::m_size;
-__aligned(4) volatile s32 SndBuffer::m_rpos;
-__aligned(4) volatile s32 SndBuffer::m_wpos;
+std::atomic<s32> SndBuffer::m_rpos(0);
+std::atomic<s32> SndBuffer::m_wpos(0);
+
+std::atomic<u32> SndBuffer::m_underruns(0);
+std::atomic<u32> SndBuffer::m_overruns(0);
 
 bool SndBuffer::m_underrun_freeze;
 StereoOut32 *SndBuffer::sndTempBuffer = NULL;
@@ -150,6 +153,7 @@ bool SndBuffer::CheckUnderrunStatus(int &nSamples, int &quietSampleCount)
         nSamples = data;
         quietSampleCount = SndOutPacketSize - data;
         m_underrun_freeze = true;
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
 
         if (SynchMode == 0) // TimeStrech on
             timeStretchUnderrun();
@@ -171,7 +175,9 @@ void SndBuffer::_InitFail()
 int SndBuffer::_GetApproximateDataInBuffer()
 {
     // WARNING: not necessarily 100% up to date by the time it's used, but it will have to do.
-    return (m_wpos + m_size - m_rpos) % m_size;
+    const s32 wpos = m_wpos.load(std::memory_order_acquire);
+    const s32 rpos = m_rpos.load(std::memory_order_acquire);
+    return (wpos + m_size - rpos) % m_size;
 }
 
 void SndBuffer::_WriteSamples_Internal(StereoOut32 *bData, int nSamples)
@@ -179,28 +185,31 @@ void SndBuffer::_WriteSamples_Internal(StereoOut32 *bData, int nSamples)
     // WARNING: This assumes the write will NOT wrap around,
     // and also assumes there's enough free space in the buffer.
 
-    memcpy(m_buffer + m_wpos, bData, nSamples * sizeof(StereoOut32));
-    m_wpos = (m_wpos + nSamples) % m_size;
+    const s32 wpos = m_wpos.load(std::memory_order_relaxed);
+    memcpy(m_buffer + wpos, bData, nSamples * sizeof(StereoOut32));
+    m_wpos.store((wpos + nSamples) % m_size, std::memory_order_release);
 }
 
 void SndBuffer::_DropSamples_Internal(int nSamples)
 {
-    m_rpos = (m_rpos + nSamples) % m_size;
+    const s32 rpos = m_rpos.load(std::memory_order_relaxed);
+    m_rpos.store((rpos + nSamples) % m_size, std::memory_order_release);
 }
 
 void SndBuffer::_ReadSamples_Internal(StereoOut32 *bData, int nSamples)
 {
     // WARNING: This assumes the read will NOT wrap around,
     // and also assumes there's enough data in the buffer.
-    memcpy(bData, m_buffer + m_rpos, nSamples * sizeof(StereoOut32));
+    memcpy(bData, m_buffer + m_rpos.load(std::memory_order_relaxed), nSamples * sizeof(StereoOut32));
     _DropSamples_Internal(nSamples);
 }
 
 void SndBuffer::_WriteSamples_Safe(StereoOut32 *bData, int nSamples)
 {
     // WARNING: This code assumes there's only ONE writing process.
-    if ((m_size - m_wpos) < nSamples) {
-        int b1 = m_size - m_wpos;
+    const s32 wpos = m_wpos.load(std::memory_order_relaxed);
+    if ((m_size - wpos) < nSamples) {
+        int b1 = m_size - wpos;
         int b2 = nSamples - b1;
 
         _WriteSamples_Internal(bData, b1);
@@ -213,8 +222,9 @@ void SndBuffer::_WriteSamples_Safe(StereoOut32 *bData, int nSamples)
 void SndBuffer::_ReadSamples_Safe(StereoOut32 *bData, int nSamples)
 {
     // WARNING: This code assumes there's only ONE reading process.
-    if ((m_size - m_rpos) < nSamples) {
-        int b1 = m_size - m_rpos;
+    const s32 rpos = m_rpos.load(std::memory_order_relaxed);
+    if ((m_size - rpos) < nSamples) {
+        int b1 = m_size - rpos;
         int b2 = nSamples - b1;
 
         _ReadSamples_Internal(bData, b1);
@@ -251,7 +261,8 @@ void SndBuffer::ReadSamples(T *bData)
         pxAssume(nSamples <= SndOutPacketSize);
 
         // WARNING: This code assumes there's only ONE reading process.
-        int b1 = m_size - m_rpos;
+        const s32 rpos = m_rpos.load(std::memory_order_relaxed);
+        int b1 = m_size - rpos;
 
         if (b1 > nSamples)
             b1 = nSamples;
@@ -259,7 +270,7 @@ void SndBuffer::ReadSamples(T *bData)
         if (AdvancedVolumeControl) {
             // First part
             for (int i = 0; i < b1; i++)
-                bData[i].AdjustFrom(m_buffer[i + m_rpos]);
+                bData[i].AdjustFrom(m_buffer[i + rpos]);
 
             // Second part
             int b2 = nSamples - b1;
@@ -268,7 +279,7 @@ void SndBuffer::ReadSamples(T *bData)
         } else {
             // First part
             for (int i = 0; i < b1; i++)
-                bData[i].ResampleFrom(m_buffer[i + m_rpos]);
+                bData[i].ResampleFrom(m_buffer[i + rpos]);
 
             // Second part
             int b2 = nSamples - b1;
@@ -348,6 +359,7 @@ void SndBuffer::_WriteSamples(StereoOut32 *bData, int nSamples)
 			ConLog(" * SPU2 > Overrun Compensation (%d packets tossed)\n", comp / SndOutPacketSize );
 		lastPct = 0.0;		// normalize the timestretcher
 #else
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
         if (MsgOverruns())
             ConLog(" * SPU2 > Overrun! 1 packet tossed)\n");
         lastPct = 0.0; // normalize the timestretcher
@@ -371,6 +383,8 @@ void SndBuffer::Init()
 
     m_rpos = 0;
     m_wpos = 0;
+    m_underruns = 0;
+    m_overruns = 0;
 
     try {
         const float latencyMS = SndOutLatencyMS * 16;
@@ -392,6 +406,9 @@ void SndBuffer::Init()
 
     soundtouchInit(); // initializes the timestretching
 
+    if (ThreadedTimeStretch && SynchMode == 0)
+        stretchStart();
+
     // initialize module
     if (mods[OutputModule]->Init() == -1)
         _InitFail();
@@ -399,8 +416,13 @@ void SndBuffer::Init()
 
 void SndBuffer::Cleanup()
 {
+    stretchStop(); // before the output module goes away, the worker writes to it
+
     mods[OutputModule]->Close();
 
+    if (m_underruns != 0 || m_overruns != 0)
+        ConLog("* SPU2-X: %u underruns, %u overruns during this session.\n", GetUnderrunCount(), GetOverrunCount());
+
     soundtouchCleanup();
 
     safe_delete_array(m_buffer);
@@ -412,24 +434,57 @@ int SndBuffer::m_dsp_progress = 0;
 
 int SndBuffer::m_timestretch_progress = 0;
 int SndBuffer::ssFreeze = 0;
+bool SndBuffer::m_fast_forward = false;
+bool SndBuffer::m_muted = false;
 
 void SndBuffer::ClearContents()
 {
+    SndBuffer::stretchFlush();
     SndBuffer::soundtouchClearContents();
     SndBuffer::ssFreeze = 256; //Delays sound output for about 1 second.
 }
 
+void SndBuffer::SetFastForward(bool enable)
+{
+    if (m_fast_forward == enable)
+        return;
+
+    m_fast_forward = enable;
+
+    // Drop the half-filled packet and whatever the timestretcher held on to, so that
+    // playback resumes cleanly instead of with a fragment from before the fast-forward.
+    if (!enable) {
+        sndTempProgress = 0;
+        ClearContents();
+    }
+}
+
+// Unlike fast-forward, the buffered output keeps playing across the muted stretch: it is
+// meant for the frames that are emulated and then rolled back (run-ahead), which must not
+// be heard, nor break up the audio of the frames that are kept.
+void SndBuffer::SetMuted(bool mute)
+{
+    m_muted = mute;
+}
+
 void SndBuffer::Write(const StereoOut32 &Sample)
 {
     // Log final output to wavefile.
     WaveDump::WriteCore(1, CoreSrc_External, Sample.DownSample());
 
+    if (replay_profile)
+        s2r_bench_sample(Sample);
+
     if (WavRecordEnabled)
         RecordWrite(Sample.DownSample());
 
     if (mods[OutputModule] == &NullOut) // null output doesn't need buffering or stretching! :p
         return;
 
+    // Muted while fast-forwarding; the output module just underruns into silence.
+    if (m_fast_forward || m_muted)
+        return;
+
     sndTempBuffer[sndTempProgress++] = Sample;
 
     // If we haven't accumulated a full packet yet, do nothing more:
@@ -461,7 +516,7 @@ void SndBuffer::Write(const StereoOut32 &Sample)
             }
 
             if (SynchMode == 0) // TimeStrech on
-                timeStretchWrite();
+                timeStretchWrite(sndTempBuffer);
             else
                 _WriteSamples(sndTempBuffer, SndOutPacketSize);
 
@@ -476,10 +531,99 @@ void SndBuffer::Write(const StereoOut32 &Sample)
     }
 #endif
     else {
-        if (SynchMode == 0) // TimeStrech on
-            timeStretchWrite();
-        else
+        if (SynchMode == 0 && m_stretch_ring) // TimeStrech on, threaded
+            stretchQueue(sndTempBuffer);
+        else if (SynchMode == 0) // TimeStrech on
+            timeStretchWrite(sndTempBuffer);
+        else {
+            stretchFlush(); // only does something right after a hot switch away from threaded timestretch
             _WriteSamples(sndTempBuffer, SndOutPacketSize);
+        }
+    }
+}
+
+std::thread SndBuffer::m_stretch_thread;
+std::mutex SndBuffer::m_stretch_lock;
+std::condition_variable SndBuffer::m_stretch_cv;
+StereoOut32 *SndBuffer::m_stretch_ring = NULL;
+int SndBuffer::m_stretch_rpos = 0;
+int SndBuffer::m_stretch_wpos = 0;
+bool SndBuffer::m_stretch_busy = false;
+bool SndBuffer::m_stretch_exit = false;
+
+void SndBuffer::stretchStart()
+{
+    m_stretch_ring = new StereoOut32[SndOutPacketSize * StretchRingPackets];
+    m_stretch_rpos = 0;
+    m_stretch_wpos = 0;
+    m_stretch_busy = false;
+    m_stretch_exit = false;
+
+    m_stretch_thread = std::thread(&SndBuffer::stretchThreadProc);
+}
+
+void SndBuffer::stretchStop()
+{
+    if (!m_stretch_ring)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_stretch_lock);
+        m_stretch_exit = true;
+    }
+    m_stretch_cv.notify_all();
+
+    m_stretch_thread.join();
+
+    safe_delete_array(m_stretch_ring);
+}
+
+// Waits until every queued packet went through the timestretcher (which the caller
+// can then safely reset).
+void SndBuffer::stretchFlush()
+{
+    if (!m_stretch_ring)
+        return;
+
+    std::unique_lock<std::mutex> lock(m_stretch_lock);
+    m_stretch_cv.wait(lock, [] { return m_stretch_rpos == m_stretch_wpos && !m_stretch_busy; });
+}
+
+void SndBuffer::stretchQueue(const StereoOut32 *packet)
+{
+    std::unique_lock<std::mutex> lock(m_stretch_lock);
+
+    // A full ring means the worker is seconds behind, waiting is the only sane option left
+    m_stretch_cv.wait(lock, [] { return m_stretch_wpos - m_stretch_rpos < StretchRingPackets; });
+
+    memcpy(&m_stretch_ring[(m_stretch_wpos % StretchRingPackets) * SndOutPacketSize], packet, sizeof(StereoOut32) * SndOutPacketSize);
+    m_stretch_wpos++;
+
+    lock.unlock();
+    m_stretch_cv.notify_all();
+}
+
+void SndBuffer::stretchThreadProc()
+{
+    std::unique_lock<std::mutex> lock(m_stretch_lock);
+
+    while (true) {
+        m_stretch_cv.wait(lock, [] { return m_stretch_exit || m_stretch_rpos != m_stretch_wpos; });
+
+        if (m_stretch_rpos == m_stretch_wpos)
+            return; // exit requested and nothing left to do
+
+        StereoOut32 *packet = &m_stretch_ring[(m_stretch_rpos % StretchRingPackets) * SndOutPacketSize];
+        m_stretch_busy = true;
+
+        // The slot stays owned by the worker until rpos moves past it
+        lock.unlock();
+        timeStretchWrite(packet);
+        lock.lock();
+
+        m_stretch_rpos++;
+        m_stretch_busy = false;
+        m_stretch_cv.notify_all();
     }
 }
 
@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 // Number of stereo samples per SndOut block.
 // All drivers must work in units of this size when communicating with
 // SndOut.
@@ -581,21 +586,48 @@ private:
     static StereoOut32 *m_buffer;
     static s32 m_size;
 
-    static __aligned(4) volatile s32 m_rpos;
-    static __aligned(4) volatile s32 m_wpos;
+    // Single producer (the mixer) / single consumer (the output module) ring; each side
+    // only ever stores its own index, so no lock is needed as long as the stores are
+    // release and the loads of the other side's index are acquire.
+    static std::atomic<s32> m_rpos;
+    static std::atomic<s32> m_wpos;
+
+    static std::atomic<u32> m_underruns;
+    static std::atomic<u32> m_overruns;
 
     static float lastEmergencyAdj;
     static float cTempo;
     static float eTempo;
     static int ssFreeze;
+    static bool m_fast_forward;
+    static bool m_muted;
 
     static void _InitFail();
     static bool CheckUnderrunStatus(int &nSamples, int &quietSampleCount);
 
+    // Threaded_TimeStretch: packets are handed to a worker that runs the timestretcher,
+    // so that SoundTouch doesn't eat into the emulator thread's time.
+    static const int StretchRingPackets = 32;
+
+    static std::thread m_stretch_thread;
+    static std::mutex m_stretch_lock;
+    static std::condition_variable m_stretch_cv;
+    static StereoOut32 *m_stretch_ring;
+    static int m_stretch_rpos;
+    static int m_stretch_wpos;
+    static bool m_stretch_busy;
+    static bool m_stretch_exit;
+
+    static void stretchStart();
+    static void stretchStop();
+    static void stretchFlush();
+    static void stretchQueue(const StereoOut32 *packet);
+    static void stretchThreadProc();
+
     static void soundtouchInit();
     static void soundtouchClearContents();
     static void soundtouchCleanup();
-    static void timeStretchWrite();
+    static void timeStretchWrite(StereoOut32 *packet);
     static void timeStretchUnderrun();
     static s32 timeStretchOverrun();
 
@@ -623,6 +655,16 @@ public:
     static s32 Test();
     static void ClearContents();
 
+    // Mutes the output while the emulator is fast-forwarding.  Mixing and recording still
+    // happen as usual.
+    static void SetFastForward(bool enable);
+    static void SetMuted(bool mute);
+    static bool IsMuted() { return m_muted; }
+
+    // Number of packets the output ran dry / the mixer had to toss since Init().
+    static u32 GetUnderrunCount() { return m_underruns.load(std::memory_order_relaxed); }
+    static u32 GetOverrunCount() { return m_overruns.load(std::memory_order_relaxed); }
+
     // Note: When using with 32 bit output buffers, the user of this function is responsible
     // for shifting the values to where they need to be manually.  The fixed point depth of
     // the sample output is determined by the SndOutVolumeShift, which is the number of bits
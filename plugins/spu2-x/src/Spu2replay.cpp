@@ -101,6 +101,28 @@ void s2r_close()
 
 bool replay_mode = false;
 
+bool replay_profile = false;
+u64 replay_stage_ticks[S2R_Stage_Count];
+
+static u64 s2r_output_hash;
+static u64 s2r_output_samples;
+
+void s2r_bench_sample(const StereoOut32 &sample)
+{
+    // FNV-1a over the final output, for comparing against a golden run.
+    const u32 words[2] = {(u32)sample.Left, (u32)sample.Right};
+    const u8 *bytes = (const u8 *)words;
+    for (size_t i = 0; i < sizeof(words); i++)
+        s2r_output_hash = (s2r_output_hash ^ bytes[i]) * 0x100000001b3ULL;
+    s2r_output_samples++;
+
+    // The output module is bypassed, so run the DPLII decoder here to keep it in the profile.
+    const u64 start = GetCPUTicks();
+    Stereo51Out32DplII dpl;
+    dpl.ResampleFrom(sample);
+    replay_stage_ticks[S2R_Stage_DplII] += GetCPUTicks() - start;
+}
+
 u16 dmabuffer[0xFFFFF];
 
 const u32 IOP_CLK = 768 * 48000;
@@ -215,6 +237,70 @@ BOOL WINAPI HandlerRoutine(DWORD dwCtrlType)
 }
 #endif
 
+#define TryRead(dest, size, count, file)                                           \
+    if (fread(dest, size, count, file) < count) {                                  \
+        conprintf("Error reading from file.");                                     \
+        goto Finish; /* Need to exit the while() loop and maybe also the switch */ \
+    }
+
+// Feeds the recorded events to the plugin.  In realtime mode the stream is paced by
+// WaitSync, otherwise the clock jumps straight to each event and the mixer runs flat out.
+static int ReplayEvents(FILE *file, bool realtime)
+{
+    int events = 0;
+
+    while (!feof(file) && Running) {
+        u32 ccycle = 0;
+        u32 evid = 0;
+        u32 sval = 0;
+        u32 tval = 0;
+
+        TryRead(&ccycle, 4, 1, file);
+        TryRead(&sval, 4, 1, file);
+
+        evid = sval >> 29;
+        sval &= 0x1FFFFFFF;
+
+        u32 TargetCycle = ccycle * 768;
+
+        if (realtime) {
+            while (TargetCycle > CurrentIOPCycle) {
+                u32 delta = WaitSync(TargetCycle);
+                SPU2async(delta);
+            }
+        } else if (TargetCycle > CurrentIOPCycle) {
+            u32 delta = TargetCycle - CurrentIOPCycle;
+            CurrentIOPCycle = TargetCycle;
+            SPU2async(delta);
+        }
+
+        switch (evid) {
+            case 0:
+                SPU2read(sval);
+                break;
+            case 1:
+                TryRead(&tval, 2, 1, file);
+                SPU2write(sval, tval);
+                break;
+            case 2:
+                TryRead(dmabuffer, sval, 2, file);
+                SPU2writeDMA4Mem(dmabuffer, sval);
+                break;
+            case 3:
+                TryRead(dmabuffer, sval, 2, file);
+                SPU2writeDMA7Mem(dmabuffer, sval);
+                break;
+            default:
+                // not implemented
+                goto Finish;
+        }
+        events++;
+    }
+
+Finish:
+    return events;
+}
+
 #include "Windows/Dialogs.h"
 EXPORT_C_(void)
 s2r_replay(HWND hwnd, HINSTANCE hinst, LPSTR filename, int nCmdShow)
@@ -249,12 +335,6 @@ s2r_replay(HWND hwnd, HINSTANCE hinst, LPSTR filename, int nCmdShow)
     }
 // if successful, init the plugin
 
-#define TryRead(dest, size, count, file)                                           \
-    if (fread(dest, size, count, file) < count) {                                  \
-        conprintf("Error reading from file.");                                     \
-        goto Finish; /* Need to exit the while() loop and maybe also the switch */ \
-    }
-
     TryRead(&CurrentIOPCycle, 4, 1, file);
 
     replay_mode = true;
@@ -270,48 +350,7 @@ s2r_replay(HWND hwnd, HINSTANCE hinst, LPSTR filename, int nCmdShow)
 
     SPU2async(0);
 
-    while (!feof(file) && Running) {
-        u32 ccycle = 0;
-        u32 evid = 0;
-        u32 sval = 0;
-        u32 tval = 0;
-
-        TryRead(&ccycle, 4, 1, file);
-        TryRead(&sval, 4, 1, file);
-
-        evid = sval >> 29;
-        sval &= 0x1FFFFFFF;
-
-        u32 TargetCycle = ccycle * 768;
-
-        while (TargetCycle > CurrentIOPCycle) {
-            u32 delta = WaitSync(TargetCycle);
-            SPU2async(delta);
-        }
-
-        switch (evid) {
-            case 0:
-                SPU2read(sval);
-                break;
-            case 1:
-                TryRead(&tval, 2, 1, file);
-                SPU2write(sval, tval);
-                break;
-            case 2:
-                TryRead(dmabuffer, sval, 2, file);
-                SPU2writeDMA4Mem(dmabuffer, sval);
-                break;
-            case 3:
-                TryRead(dmabuffer, sval, 2, file);
-                SPU2writeDMA7Mem(dmabuffer, sval);
-                break;
-            default:
-                // not implemented
-                return;
-                break;
-        }
-        events++;
-    }
+    events = ReplayEvents(file, true);
 
 Finish:
 
@@ -328,4 +367,102 @@ Finish:
 
     replay_mode = false;
 }
+
+// rundll32 entry point for benchmarking: "<stream.s2r> [golden.txt]" (no spaces in paths).
+// The stream is replayed as fast as possible with no output device, and the time spent in
+// each mixer stage is reported.  If a golden file is given it is created on the first run,
+// and later runs compare their output hash against it and exit with code 1 on a mismatch.
+EXPORT_C_(void)
+s2r_benchmark(HWND hwnd, HINSTANCE hinst, LPSTR cmdline, int nCmdShow)
+{
+    static const char *const StageNames[S2R_Stage_Count] = {"voices", "reverb", "dplii"};
+
+    char filename[MAX_PATH] = {0};
+    char golden[MAX_PATH] = {0};
+    sscanf(cmdline, "%259s %259s", filename, golden);
+
+    Running = true;
+    bool mismatch = false;
+
+    AllocConsole();
+    SetConsoleCtrlHandler(HandlerRoutine, TRUE);
+
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        conprintf("Could not open the replay file.\n");
+        FreeConsole();
+        return;
+    }
+
+    u32 ticks;
+    if (fread(&ticks, 4, 1, file) < 1) {
+        conprintf("Error reading from file.\n");
+        fclose(file);
+        FreeConsole();
+        return;
+    }
+
+    replay_mode = true;
+    replay_profile = true;
+    memzero(replay_stage_ticks);
+    s2r_output_hash = 0xcbf29ce484222325ULL;
+    s2r_output_samples = 0;
+
+    SPU2init();
+    SPU2irqCallback(dummy1, dummy4, dummy7);
+    SPU2setClockPtr(&CurrentIOPCycle);
+
+    // Output only goes to s2r_bench_sample.
+    OutputModule = FindOutputModuleById(L"nullout");
+    SPU2open(&hwnd);
+
+    CurrentIOPCycle = 0;
+    SPU2async(0);
+
+    const u64 start = GetCPUTicks();
+    const int events = ReplayEvents(file, false);
+    const u64 total = GetCPUTicks() - start;
+
+    SPU2close();
+    SPU2shutdown();
+    fclose(file);
+
+    replay_profile = false;
+    replay_mode = false;
+
+    const double freq = (double)GetTickFrequency();
+    const double seconds = total / freq;
+
+    conprintf("%s: %d events, %llu samples in %.3f s (%.0f samples/s, %.1fx realtime)\n",
+              filename, events, s2r_output_samples, seconds, s2r_output_samples / seconds,
+              s2r_output_samples / (double)SampleRate / seconds);
+
+    for (int i = 0; i < S2R_Stage_Count; i++)
+        conprintf("  %-8s %8.3f s %6.1f%%\n", StageNames[i], replay_stage_ticks[i] / freq,
+                  replay_stage_ticks[i] * 100.0 / total);
+
+    conprintf("  output   %016llx (%llu samples)\n", s2r_output_hash, s2r_output_samples);
+
+    if (golden[0]) {
+        unsigned long long expectedHash = 0, expectedSamples = 0;
+
+        if (FILE *gf = fopen(golden, "r")) {
+            const bool valid = fscanf(gf, "%llx %llu", &expectedHash, &expectedSamples) == 2;
+            fclose(gf);
+
+            mismatch = !valid || expectedHash != s2r_output_hash || expectedSamples != s2r_output_samples;
+            conprintf(mismatch ? "  MISMATCH against %s (%016llx, %llu samples)\n" : "  matches %s\n",
+                      golden, expectedHash, expectedSamples);
+        } else if (FILE *gf = fopen(golden, "w")) {
+            fprintf(gf, "%016llx %llu\n", s2r_output_hash, s2r_output_samples);
+            fclose(gf);
+            conprintf("  golden file %s written\n", golden);
+        }
+    }
+
+    FreeConsole();
+
+    if (mismatch)
+        ExitProcess(1);
+}
 #endif
@@ -29,3 +29,19 @@ void s2r_writedma7(u32 ticks, u16 *data, u32 len);
 void s2r_close();
 
 extern bool replay_mode;
+
+// Per-stage mixer timing, only collected while s2r_benchmark runs.
+enum S2R_Stage {
+    S2R_Stage_Voices, // ADPCM decode, ADSR and interpolation (interleaved per voice)
+    S2R_Stage_Reverb,
+    S2R_Stage_DplII,
+    S2R_Stage_Count
+};
+
+struct StereoOut32;
+
+extern bool replay_profile;
+extern u64 replay_stage_ticks[S2R_Stage_Count];
+
+// Called from SndBuffer::Write with every output sample while profiling.
+void s2r_bench_sample(const StereoOut32 &sample);
@@ -19,12 +19,20 @@
 #include "soundtouch/SoundTouch.h"
 #include <wx/datetime.h>
 #include <algorithm>
+#include <chrono>
+
+#include <emmintrin.h>
 
 //Uncomment the next line to use the old time stretcher
 //#define SPU2X_USE_OLD_STRETCHER
 
 static soundtouch::SoundTouch *pSoundTouch = NULL;
 
+// TimeStretch_Batch packets are collected here before being handed to SoundTouch, which
+// has a noticeable fixed cost per putSamples/receiveSamples round.
+static StereoOut32 *s_stretch_batch = NULL;
+static int s_stretch_batch_packets = 0;
+
 // data prediction amount, used to "commit" data that hasn't
 // finished timestretch processing.
 s32 SndBuffer::m_predictData;
@@ -444,27 +452,33 @@ s32 SndBuffer::timeStretchOverrun()
     return SndOutPacketSize * 2;
 }
 
-static void CvtPacketToFloat(StereoOut32 *srcdest)
+// Same results as the StereoOutFloat/StereoOut32 conversion constructors, two stereo
+// samples per iteration.  size is in stereo samples and must be even.
+static void CvtPacketToFloat(StereoOut32 *srcdest, uint size)
 {
-    StereoOutFloat *dest = (StereoOutFloat *)srcdest;
-    const StereoOut32 *src = (StereoOut32 *)srcdest;
-    for (uint i = 0; i < SndOutPacketSize; ++i, ++dest, ++src)
-        *dest = (StereoOutFloat)*src;
+    const __m128 scale = _mm_set1_ps(2147483647.0f);
+
+    for (uint i = 0; i < size; i += 2) {
+        __m128i *p = (__m128i *)&srcdest[i];
+        _mm_storeu_ps((float *)p, _mm_div_ps(_mm_cvtepi32_ps(_mm_loadu_si128(p)), scale));
+    }
 }
 
-// Parameter note: Size should always be a multiple of 128, thanks!
 static void CvtPacketToInt(StereoOut32 *srcdest, uint size)
 {
-    //pxAssume( (size & 127) == 0 );
+    const __m128 scale = _mm_set1_ps(2147483647.0f);
 
-    const StereoOutFloat *src = (StereoOutFloat *)srcdest;
-    StereoOut32 *dest = srcdest;
+    uint i = 0;
+    for (; i + 2 <= size; i += 2) {
+        __m128i *p = (__m128i *)&srcdest[i];
+        _mm_storeu_si128(p, _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps((float *)p), scale)));
+    }
 
-    for (uint i = 0; i < size; ++i, ++dest, ++src)
-        *dest = (StereoOut32)*src;
+    if (i < size)
+        srcdest[i] = StereoOut32(*(StereoOutFloat *)&srcdest[i]);
 }
 
-void SndBuffer::timeStretchWrite()
+void SndBuffer::timeStretchWrite(StereoOut32 *packet)
 {
     // data prediction helps keep the tempo adjustments more accurate.
     // The timestretcher returns packets in belated "clump" form.
@@ -473,18 +487,43 @@ void SndBuffer::timeStretchWrite()
     // data prediction to make the timestretcher more responsive.
 
     PredictDataWrite((int)(SndOutPacketSize / eTempo));
-    CvtPacketToFloat(sndTempBuffer);
 
-    pSoundTouch->putSamples((float *)sndTempBuffer, SndOutPacketSize);
+    StereoOut32 *batch = s_stretch_batch + s_stretch_batch_packets * SndOutPacketSize;
+    memcpy(batch, packet, SndOutPacketSize * sizeof(StereoOut32));
+    CvtPacketToFloat(batch, SndOutPacketSize);
+
+    if (++s_stretch_batch_packets < TimeStretchBatch)
+        return;
+
+    const uint batchSize = s_stretch_batch_packets * SndOutPacketSize;
+    s_stretch_batch_packets = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    pSoundTouch->putSamples((float *)s_stretch_batch, batchSize);
 
     int tempProgress;
-    while (tempProgress = pSoundTouch->receiveSamples((float *)sndTempBuffer, SndOutPacketSize),
+    while (tempProgress = pSoundTouch->receiveSamples((float *)s_stretch_batch, batchSize),
            tempProgress != 0) {
-        // Hint: It's assumed that pSoundTouch will return chunks of 128 bytes (it always does as
-        // long as the SSE optimizations are enabled), which means we can do our own SSE opts here.
+        CvtPacketToInt(s_stretch_batch, tempProgress);
+        _WriteSamples(s_stretch_batch, tempProgress);
+    }
 
-        CvtPacketToInt(sndTempBuffer, tempProgress);
-        _WriteSamples(sndTempBuffer, tempProgress);
+    if (MsgOverruns()) {
+        // Report the stretcher's cost as cpu time per second of audio fed to it.
+        static std::chrono::steady_clock::duration spent;
+        static uint samples = 0;
+
+        spent += std::chrono::steady_clock::now() - start;
+        samples += batchSize;
+
+        if (samples >= (uint)SampleRate * 4) {
+            const double ms = std::chrono::duration<double, std::milli>(spent).count();
+            ConLog("* SPU2 > TimeStretch: %.2f ms cpu per second of audio (batch of %d packets)\n",
+                   ms * SampleRate / samples, TimeStretchBatch);
+            spent = std::chrono::steady_clock::duration::zero();
+            samples = 0;
+        }
     }
 
 #ifdef SPU2X_USE_OLD_STRETCHER
@@ -507,6 +546,12 @@ void SndBuffer::soundtouchInit()
 
     pSoundTouch->setTempo(1);
 
+    s_stretch_batch = new StereoOut32[SndOutPacketSize * TimeStretchBatch];
+    s_stretch_batch_packets = 0;
+
+    // The tempo tuning is derived from the rate at which it gets called, see targetIPS.
+    targetIPS = 750 / TimeStretchBatch;
+
     // some timestretch management vars:
 
     cTempo = 1.0;
@@ -525,6 +570,7 @@ void SndBuffer::soundtouchClearContents()
 
     pSoundTouch->clear();
     pSoundTouch->setTempo(1);
+    s_stretch_batch_packets = 0;
 
     cTempo = 1.0;
     eTempo = 1.0;
@@ -537,4 +583,5 @@ void SndBuffer::soundtouchClearContents()
 void SndBuffer::soundtouchCleanup()
 {
     safe_delete(pSoundTouch);
+    safe_delete_array(s_stretch_batch);
 }
@@ -97,39 +97,162 @@ void WriteCore(uint coreidx, CoreSourceType src, s16 left, s16 right)
 
 #include "Utilities/Threading.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 using namespace Threading;
 
 bool WavRecordEnabled = false;
 
+// The mixer only copies samples into pooled blocks; a writer thread does the file I/O, so
+// a slow disk can't stall emulation.  When the writer falls behind and the pool runs dry,
+// samples are dropped (and counted) instead of waiting.
+static const int RecordBlockSamples = 4096; // ~85ms
+static const int RecordBlockCount = 16;
+
+struct RecordBlock
+{
+    StereoOut16 samples[RecordBlockSamples];
+    int count;
+};
+
 static WavOutFile *m_wavrecord = NULL;
-static Mutex WavRecordMutex;
+static Mutex WavRecordMutex; // guards the mixer side: s_record_active and s_record_fill
+
+static bool s_record_active = false;
+static RecordBlock *s_record_fill = NULL;
+static u32 s_record_dropped = 0;
+
+static RecordBlock *s_record_pool = NULL;
+static std::vector<RecordBlock *> s_record_free;
+static std::deque<RecordBlock *> s_record_queue;
+static std::mutex s_record_queue_lock;
+static std::condition_variable s_record_cv;
+static std::thread s_record_thread;
+static bool s_record_exit = false;
+
+static void RecordThreadProc()
+{
+    std::unique_lock<std::mutex> lock(s_record_queue_lock);
+
+    for (;;) {
+        s_record_cv.wait(lock, [] { return s_record_exit || !s_record_queue.empty(); });
+
+        if (s_record_queue.empty())
+            break; // exit requested, and everything has been written
+
+        RecordBlock *block = s_record_queue.front();
+        s_record_queue.pop_front();
+
+        lock.unlock();
+        m_wavrecord->write((s16 *)block->samples, block->count * 2);
+        lock.lock();
+
+        s_record_free.push_back(block);
+    }
+}
+
+static RecordBlock *RecordTakeBlock()
+{
+    std::lock_guard<std::mutex> lock(s_record_queue_lock);
+
+    if (s_record_free.empty())
+        return NULL;
+
+    RecordBlock *block = s_record_free.back();
+    s_record_free.pop_back();
+    block->count = 0;
+    return block;
+}
+
+static void RecordQueueBlock(RecordBlock *block)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_record_queue_lock);
+        s_record_queue.push_back(block);
+    }
+    s_record_cv.notify_one();
+}
 
 void RecordStart()
 {
-    WavRecordEnabled = false;
+    RecordStop();
 
     try {
-        ScopedLock lock(WavRecordMutex);
-        safe_delete(m_wavrecord);
         m_wavrecord = new WavOutFile("recording.wav", 48000, 16, 2);
-        WavRecordEnabled = true;
     } catch (std::runtime_error &) {
         m_wavrecord = NULL; // not needed, but what the heck. :)
         SysMessage("SPU2-X couldn't open file for recording: %s.\nRecording to wavfile disabled.", "recording.wav");
+        return;
     }
+
+    s_record_pool = new RecordBlock[RecordBlockCount];
+    s_record_free.clear();
+    for (int i = 0; i < RecordBlockCount; i++)
+        s_record_free.push_back(&s_record_pool[i]);
+
+    s_record_exit = false;
+    s_record_thread = std::thread(RecordThreadProc);
+
+    ScopedLock lock(WavRecordMutex);
+    s_record_fill = NULL;
+    s_record_dropped = 0;
+    s_record_active = true;
+    WavRecordEnabled = true;
 }
 
 void RecordStop()
 {
     WavRecordEnabled = false;
-    ScopedLock lock(WavRecordMutex);
+
+    {
+        ScopedLock lock(WavRecordMutex);
+        if (!s_record_active)
+            return;
+
+        s_record_active = false;
+        if (s_record_fill != NULL && s_record_fill->count > 0)
+            RecordQueueBlock(s_record_fill);
+        s_record_fill = NULL;
+    }
+
+    // Lets the writer finish what's queued before the file gets closed.
+    {
+        std::lock_guard<std::mutex> lock(s_record_queue_lock);
+        s_record_exit = true;
+    }
+    s_record_cv.notify_one();
+    s_record_thread.join();
+
     safe_delete(m_wavrecord);
+    safe_delete_array(s_record_pool);
+    s_record_free.clear();
+
+    if (s_record_dropped != 0)
+        ConLog("* SPU2-X: Recording dropped %u samples (disk too slow).\n", s_record_dropped);
 }
 
 void RecordWrite(const StereoOut16 &sample)
 {
     ScopedLock lock(WavRecordMutex);
-    if (m_wavrecord == NULL)
+    if (!s_record_active)
         return;
-    m_wavrecord->write((s16 *)&sample, 2);
+
+    if (s_record_fill == NULL) {
+        s_record_fill = RecordTakeBlock();
+        if (s_record_fill == NULL) {
+            s_record_dropped++;
+            return;
+        }
+    }
+
+    s_record_fill->samples[s_record_fill->count++] = sample;
+
+    if (s_record_fill->count == RecordBlockSamples) {
+        RecordQueueBlock(s_record_fill);
+        s_record_fill = NULL;
+    }
 }
@@ -66,6 +66,8 @@ bool postprocess_filter_dealias = false;
 // OUTPUT
 int SndOutLatencyMS = 100;
 int SynchMode = 0; // Time Stretch, Async or Disabled
+bool ThreadedTimeStretch = false; // Time Stretch runs on its own thread instead of the emulator's
+int TimeStretchBatch = 1;         // Packets handed to SoundTouch per call
 
 u32 OutputModule = 0;
 
@@ -113,6 +115,9 @@ void ReadSettings()
     VolumeAdjustLFE = powf(10, VolumeAdjustLFEdb / 10);
 
     SynchMode = CfgReadInt(L"OUTPUT", L"Synch_Mode", 0);
+    ThreadedTimeStretch = CfgReadBool(L"OUTPUT", L"Threaded_TimeStretch", false);
+    TimeStretchBatch = CfgReadInt(L"OUTPUT", L"TimeStretch_Batch", 1);
+    Clampify(TimeStretchBatch, 1, 8);
     numSpeakers = CfgReadInt(L"OUTPUT", L"SpeakerConfiguration", 0);
     dplLevel = CfgReadInt(L"OUTPUT", L"DplDecodingLevel", 0);
     SndOutLatencyMS = CfgReadInt(L"OUTPUT", L"Latency", 100);
@@ -186,6 +191,8 @@ void WriteSettings()
     CfgWriteStr(L"OUTPUT", L"Output_Module", mods[OutputModule]->GetIdent());
     CfgWriteInt(L"OUTPUT", L"Latency", SndOutLatencyMS);
     CfgWriteInt(L"OUTPUT", L"Synch_Mode", SynchMode);
+    CfgWriteBool(L"OUTPUT", L"Threaded_TimeStretch", ThreadedTimeStretch);
+    CfgWriteInt(L"OUTPUT", L"TimeStretch_Batch", TimeStretchBatch);
     CfgWriteInt(L"OUTPUT", L"SpeakerConfiguration", numSpeakers);
     CfgWriteInt(L"OUTPUT", L"DplDecodingLevel", dplLevel);
     CfgWriteInt(L"DEBUG", L"DelayCycles", delayCycles);
@@ -100,7 +100,9 @@ s32 __fastcall Savestate::ThawIt(DataBlock &spud)
 
         wipe_the_cache();
     } else {
-        SndBuffer::ClearContents();
+        // A rollback of muted frames continues the same audio stream
+        if (!SndBuffer::IsMuted())
+            SndBuffer::ClearContents();
 
         pxAssertMsg(spu2regs && _spu2mem, "Looks like PCSX2 is trying to loadstate while pluigns are shut down.  That's a no-no!  It shouldn't crash, but the savestate will probably be corrupted.");
 
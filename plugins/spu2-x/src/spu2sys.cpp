@@ -27,6 +27,8 @@
 
 #include "PS2E-spu2.h" // needed until I figure out a nice solution for irqcallback dependencies.
 
+#include "Utilities/Instrumentation.h"
+
 s16 *spu2regs = NULL;
 s16 *_spu2mem = NULL;
 
@@ -370,39 +372,12 @@ uint TickInterval = 768;
 static const int SanityInterval = 4800;
 extern void UpdateDebugDialog();
 
-__forceinline void TimeUpdate(u32 cClocks)
+// Runs every whole tick in dClocks.  The per-tick bookkeeping (IRQ and DMA callbacks,
+// pending key-ons) still happens between samples exactly as before; only the choice of
+// mixer is resolved once per call.
+template <int InterpType>
+static __forceinline void MixTicks(u32 dClocks)
 {
-    u32 dClocks = cClocks - lClocks;
-
-    // Sanity Checks:
-    //  It's not totally uncommon for the IOP's clock to jump backwards a cycle or two, and in
-    //  such cases we just want to ignore the TimeUpdate call.
-
-    if (dClocks > (u32)-15)
-        return;
-
-    //  But if for some reason our clock value seems way off base (typically due to bad dma
-    //  timings from PCSX2), just mix out a little bit, skip the rest, and hope the ship
-    //  "rights" itself later on.
-
-    if (dClocks > (u32)(TickInterval * SanityInterval)) {
-        if (MsgToConsole())
-            ConLog(" * SPU2 > TimeUpdate Sanity Check (Tick Delta: %d) (PS2 Ticks: %d)\n", dClocks / TickInterval, cClocks / TickInterval);
-        dClocks = TickInterval * SanityInterval;
-        lClocks = cClocks - dClocks;
-    }
-
-// Visual debug display showing all core's activity! Disabled via #define on release builds.
-#ifdef _WIN32
-    UpdateDebugDialog();
-#endif
-
-    if (SynchMode == 1) // AsyncMix on
-        SndBuffer::UpdateTempoChangeAsyncMixing();
-    else
-        TickInterval = 768; // Reset to default, in case the user hotswitched from async to something else.
-
-    //Update Mixing Progress
     while (dClocks >= TickInterval) {
         if (has_to_call_irq) {
             //ConLog("* SPU2-X: Irq Called (%04x) at cycle %d.\n", Spdif.Info, Cycles);
@@ -452,11 +427,66 @@ __forceinline void TimeUpdate(u32 cClocks)
 
         // Note: IOP does not use MMX regs, so no need to save them.
         //SaveMMXRegs();
-        Mix();
+        Mix<InterpType>();
         //RestoreMMXRegs();
     }
 }
 
+__forceinline void TimeUpdate(u32 cClocks)
+{
+    u32 dClocks = cClocks - lClocks;
+
+    // Sanity Checks:
+    //  It's not totally uncommon for the IOP's clock to jump backwards a cycle or two, and in
+    //  such cases we just want to ignore the TimeUpdate call.
+
+    if (dClocks > (u32)-15)
+        return;
+
+    //  But if for some reason our clock value seems way off base (typically due to bad dma
+    //  timings from PCSX2), just mix out a little bit, skip the rest, and hope the ship
+    //  "rights" itself later on.
+
+    if (dClocks > (u32)(TickInterval * SanityInterval)) {
+        if (MsgToConsole())
+            ConLog(" * SPU2 > TimeUpdate Sanity Check (Tick Delta: %d) (PS2 Ticks: %d)\n", dClocks / TickInterval, cClocks / TickInterval);
+        dClocks = TickInterval * SanityInterval;
+        lClocks = cClocks - dClocks;
+    }
+
+// Visual debug display showing all core's activity! Disabled via #define on release builds.
+#ifdef _WIN32
+    UpdateDebugDialog();
+#endif
+
+    if (SynchMode == 1) // AsyncMix on
+        SndBuffer::UpdateTempoChangeAsyncMixing();
+    else
+        TickInterval = 768; // Reset to default, in case the user hotswitched from async to something else.
+
+    //Update Mixing Progress
+    Instrumentation::ScopedTimer mixTimer(Instrumentation::Counter_SPU2Mix);
+    switch (Interpolation) {
+        case 0:
+            MixTicks<0>(dClocks);
+            break;
+        case 1:
+            MixTicks<1>(dClocks);
+            break;
+        case 2:
+            MixTicks<2>(dClocks);
+            break;
+        case 3:
+            MixTicks<3>(dClocks);
+            break;
+        case 4:
+            MixTicks<4>(dClocks);
+            break;
+
+            jNO_DEFAULT;
+    }
+}
+
 __forceinline void UpdateSpdifMode()
 {
     int OPM = PlayMode;
@@ -0,0 +1,208 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// emitbench - measures how fast the x86 emitter encodes the instruction forms the
+// recompilers use the most.  That code is only written, never run.  The microVU operand
+// clamps (see microVU_Clamp.inl) are then emitted and run, to compare their host variants.
+//
+//    emitbench [seconds per form]
+//
+
+#include "Utilities/Dependencies.h"
+#include "x86emitter/x86emitter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace x86Emitter;
+
+// Every form is emitted this many times between two buffer resets.
+static const int BatchSize = 1024;
+// Longest encoding of any form below, rounded up.
+static const int MaxFormSize = 16;
+
+static __aligned16 u32 s_mem32[4];
+static __aligned16 u128 s_mem128[2];
+
+struct EmitForm
+{
+	const char* name;
+	void (*emit)();
+};
+
+static const EmitForm s_forms[] =
+{
+	{ "mov r32, r32",            [] { xMOV(eax, ecx); } },
+	{ "mov r32, imm32",          [] { xMOV(edx, 0x12345678); } },
+	{ "mov r32, [disp32]",       [] { xMOV(eax, ptr32[&s_mem32[1]]); } },
+	{ "mov [disp32], r32",       [] { xMOV(ptr32[&s_mem32[1]], ebx); } },
+	{ "mov r32, [base+disp8]",   [] { xMOV(eax, ptr32[ecx + 8]); } },
+	{ "mov r32, [base+idx*4]",   [] { xMOV(eax, ptr32[ecx + edx * 4 + 0x100]); } },
+	{ "mov [disp32], imm32",     [] { xMOV(ptr32[&s_mem32[2]], 0x3f800000); } },
+	{ "movzx r32, m16",          [] { xMOVZX(eax, ptr16[&s_mem32[0]]); } },
+	{ "add r32, r32",            [] { xADD(eax, ecx); } },
+	{ "add r32, imm8",           [] { xADD(eax, 4); } },
+	{ "and r32, imm32",          [] { xAND(esi, 0x0C0C0C0C); } },
+	{ "sub [disp32], imm32",     [] { xSUB(ptr32[&s_mem32[3]], 0x1000); } },
+	{ "cmp r32, [disp32]",       [] { xCMP(edi, ptr32[&s_mem32[0]]); } },
+	{ "test r32, imm32",         [] { xTEST(eax, 0x200); } },
+	{ "shl r32, imm8",           [] { xSHL(ecx, 3); } },
+	{ "lea r32, [base+idx*8]",   [] { xLEA(eax, ptr[ecx + edx * 8 + 4]); } },
+	{ "push r32",                [] { xPUSH(ebx); } },
+	{ "movaps xmm, xmm",         [] { xMOVAPS(xmm0, xmm1); } },
+	{ "movaps xmm, [disp32]",    [] { xMOVAPS(xmm2, ptr128[&s_mem128[0]]); } },
+	{ "movaps [disp32], xmm",    [] { xMOVAPS(ptr128[&s_mem128[1]], xmm3); } },
+	{ "movss xmm, [base+disp8]", [] { xMOVSSZX(xmm4, ptr32[eax + 0x10]); } },
+	{ "addps xmm, xmm",          [] { xADD.PS(xmm0, xmm5); } },
+	{ "mulps xmm, [disp32]",     [] { xMUL.PS(xmm6, ptr128[&s_mem128[0]]); } },
+	{ "shufps xmm, xmm, imm8",   [] { xSHUF.PS(xmm1, xmm1, 0x1b); } },
+	{ "pand xmm, xmm",           [] { xPAND(xmm7, xmm0); } },
+	{ "paddd xmm, xmm, xmm",     [] { xPADD.D(xmm1, xmm2, xmm3); } }, // VEX with AVX, else movdqa+paddd
+	{ "pshufd xmm, xmm, imm8",   [] { xPSHUF.D(xmm2, xmm3, 0xe4); } },
+};
+
+// Same constants as mVUglob.maxvals/minvals/signbit, full xyzw
+static const __aligned16 u32 s_clamp_max[4]  = { 0x7f7fffff, 0x7f7fffff, 0x7f7fffff, 0x7f7fffff };
+static const __aligned16 u32 s_clamp_min[4]  = { 0xff7fffff, 0xff7fffff, 0xff7fffff, 0xff7fffff };
+static const __aligned16 u32 s_clamp_sign[4] = { 0x80000000, 0x80000000, 0x80000000, 0x80000000 };
+
+struct ClampForm
+{
+	const char* name;
+	bool sse4;
+	void (*emit)(const xRegisterSSE& reg, const xRegisterSSE& temp);
+};
+
+// The sequences mVUclamp1 and mVUclamp2 emit
+static const ClampForm s_clamps[] =
+{
+	{ "clamp extra", false, [](const xRegisterSSE& reg, const xRegisterSSE& temp) {
+		xMIN.PS(reg, ptr128[&s_clamp_max[0]]);
+		xMAX.PS(reg, ptr128[&s_clamp_min[0]]);
+	} },
+	{ "clamp sign, sse4.1", true, [](const xRegisterSSE& reg, const xRegisterSSE& temp) {
+		xPMIN.SD(reg, ptr128[&s_clamp_max[0]]);
+		xPMIN.UD(reg, ptr128[&s_clamp_min[0]]);
+	} },
+	{ "clamp sign, sse2", false, [](const xRegisterSSE& reg, const xRegisterSSE& temp) {
+		xMOVAPS(temp, reg);
+		xAND.PS(temp, ptr128[&s_clamp_sign[0]]);
+		xMIN.PS(reg, ptr128[&s_clamp_max[0]]);
+		xMAX.PS(reg, ptr128[&s_clamp_min[0]]);
+		xOR.PS(reg, temp);
+	} },
+};
+
+// Longest clamp sequence above, rounded up.
+static const int MaxClampSize = 40;
+// Executable buffer holding one batch of clamps.
+static const size_t ClampCodeSize = 0x10000;
+
+static_assert((size_t)(BatchSize * MaxClampSize + 64) <= ClampCodeSize, "clamp batch doesn't fit the code buffer");
+
+// Runs BatchSize clamps per call, on four registers in turn so that they don't all wait
+// on each other, as the clamps of the xyzw operands of a VU program mostly don't.
+static void RunClamps(double seconds)
+{
+	u8* code = (u8*)HostSys::Mmap(0, ClampCodeSize);
+	if (!code)
+	{
+		fprintf(stderr, "Unable to allocate the clamp code buffer\n");
+		return;
+	}
+
+	printf("\n%-24s %8s %14s %10s\n", "clamp (run)", "bytes", "clamps/sec", "ns/clamp");
+
+	for (const ClampForm& form : s_clamps)
+	{
+		if (form.sse4 && !x86caps.hasStreamingSIMD4Extensions)
+		{
+			printf("%-24s %8s\n", form.name, "n/a");
+			continue;
+		}
+
+		xSetPtr(code);
+		for (int i = 0; i < 4; ++i)
+			xMOVAPS(xRegisterSSE(i), ptr128[&s_mem128[0]]);
+		u8* start = xGetPtr();
+		for (int i = 0; i < BatchSize; ++i)
+			form.emit(xRegisterSSE(i & 3), xmm4);
+		const double bytes = (double)(xGetPtr() - start) / BatchSize;
+		xRET();
+
+		void (*run)() = (void (*)())code;
+
+		typedef std::chrono::steady_clock Clock;
+		const Clock::time_point begin = Clock::now();
+		double elapsed = 0;
+		u64 count = 0;
+
+		do {
+			run();
+			count += BatchSize;
+			elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+		} while (elapsed < seconds);
+
+		printf("%-24s %8.1f %14.0f %10.3f\n", form.name, bytes, count / elapsed, elapsed * 1e9 / count);
+	}
+
+	HostSys::Munmap(code, ClampCodeSize);
+}
+
+int main(int argc, char* argv[])
+{
+	const double seconds = (argc > 1) ? atof(argv[1]) : 0.2;
+	if (argc > 2 || seconds <= 0)
+	{
+		fprintf(stderr, "Usage: emitbench [seconds per form]\n");
+		return 1;
+	}
+
+	x86caps.Identify();
+
+	std::vector<u8> buffer(BatchSize * MaxFormSize * 2);
+	double total = 0;
+
+	printf("%-24s %8s %14s %10s\n", "form", "bytes", "insts/sec", "MB/sec");
+
+	for (const EmitForm& form : s_forms)
+	{
+		typedef std::chrono::steady_clock Clock;
+		const Clock::time_point start = Clock::now();
+		double elapsed = 0;
+		u64 count = 0;
+		u64 bytes = 0;
+
+		do {
+			xSetPtr(buffer.data());
+			for (int i = 0; i < BatchSize; ++i)
+				form.emit();
+			bytes += xGetPtr() - buffer.data();
+			count += BatchSize;
+			elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		} while (elapsed < seconds);
+
+		printf("%-24s %8.1f %14.0f %10.1f\n", form.name, (double)bytes / count,
+			count / elapsed, bytes / elapsed / (1024 * 1024));
+		total += count / elapsed;
+	}
+
+	printf("%-24s %8s %14.0f\n", "average", "", total / ArraySize(s_forms));
+
+	RunClamps(seconds);
+	return 0;
+}
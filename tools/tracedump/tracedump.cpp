@@ -0,0 +1,323 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// tracedump - formats a binary trace (emuLog.trace) into the lines the text trace log
+// would have written to emuLog.txt.  See pcsx2/DebugTools/BinaryTrace.h for the layout.
+//
+//    tracedump emuLog.trace [output.txt]
+//
+
+#include "BinaryTrace.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if _MSC_VER
+#	pragma warning(disable:4996)	// The POSIX name for this item is deprecated.
+#endif
+
+using namespace BinaryTrace;
+
+struct EventDef
+{
+	bool defined;
+	u8 cpu;
+	std::vector<u8> args;
+	std::string prefix;
+	std::string format;
+
+	EventDef() : defined(false), cpu(Cpu_None) {}
+};
+
+// Reads the arguments of an event record as they are consumed.
+class ArgReader
+{
+	const u8* m_pos;
+	const u8* m_end;
+
+public:
+	ArgReader(const u8* pos, const u8* end) : m_pos(pos), m_end(end) {}
+
+	bool Read(void* dest, size_t size)
+	{
+		if ((size_t)(m_end - m_pos) < size) return false;
+		memcpy(dest, m_pos, size);
+		m_pos += size;
+		return true;
+	}
+
+	bool ReadString(std::string& dest)
+	{
+		u16 size;
+		if (!Read(&size, 2) || (size_t)(m_end - m_pos) < size) return false;
+		dest.assign((const char*)m_pos, size);
+		m_pos += size;
+		return true;
+	}
+};
+
+static void AppendInt(std::string& dest, u32 value)
+{
+	char buf[16];
+	snprintf(buf, sizeof(buf), "%d", (int)value);
+	dest += buf;
+}
+
+// Formats one event; false if the record doesn't match its definition.
+static bool FormatEvent(const EventDef& def, ArgReader& reader, std::string& out)
+{
+	char buf[1024];
+	size_t arg = 0;
+
+	for (const char* pos = def.format.c_str(); *pos; ++pos)
+	{
+		if (*pos != '%')
+		{
+			out += *pos;
+			continue;
+		}
+		if (pos[1] == '%')
+		{
+			out += '%';
+			++pos;
+			continue;
+		}
+
+		Conversion conv;
+		if (!ParseConversion(pos + 1, conv)) return false;
+
+		// Rebuild the conversion for this compiler's argument sizes, with the '*' widths
+		// and precisions filled in.
+		std::string spec("%");
+		for (const char* ch = pos + 1; ch < conv.modifiers; ++ch)
+		{
+			if (*ch != '*')
+			{
+				spec += *ch;
+				continue;
+			}
+
+			u32 value;
+			if (arg >= def.args.size() || def.args[arg++] != Arg_Int32 || !reader.Read(&value, 4)) return false;
+			AppendInt(spec, value);
+		}
+
+		if (arg >= def.args.size()) return false;
+		const u8 type = def.args[arg++];
+
+		switch (type)
+		{
+			case Arg_Int32:
+			{
+				u32 value;
+				if (!reader.Read(&value, 4)) return false;
+				spec += conv.conversion;
+				snprintf(buf, sizeof(buf), spec.c_str(), value);
+			}
+			break;
+
+			case Arg_Int64:
+			{
+				u64 value;
+				if (!reader.Read(&value, 8)) return false;
+				spec += "ll";
+				spec += conv.conversion;
+				snprintf(buf, sizeof(buf), spec.c_str(), (unsigned long long)value);
+			}
+			break;
+
+			case Arg_Double:
+			{
+				double value;
+				if (!reader.Read(&value, 8)) return false;
+				spec += conv.conversion;
+				snprintf(buf, sizeof(buf), spec.c_str(), value);
+			}
+			break;
+
+			case Arg_Pointer:
+			{
+				u64 value;
+				if (!reader.Read(&value, 8)) return false;
+				spec += conv.conversion;
+				snprintf(buf, sizeof(buf), spec.c_str(), (void*)(uptr)value);
+			}
+			break;
+
+			case Arg_String:
+			case Arg_Text:
+			{
+				std::string value;
+				if (!reader.ReadString(value)) return false;
+
+				// Plain text can be longer than the buffer.
+				if (spec == "%")
+				{
+					out += value;
+					pos = conv.end - 1;
+					continue;
+				}
+				spec += conv.conversion;
+				snprintf(buf, sizeof(buf), spec.c_str(), value.c_str());
+			}
+			break;
+
+			default: return false;
+		}
+
+		out += buf;
+		pos = conv.end - 1;
+	}
+
+	return arg == def.args.size();
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "Usage: tracedump <emuLog.trace> [output.txt]\n");
+		return 1;
+	}
+
+	FILE* in = fopen(argv[1], "rb");
+	if (!in)
+	{
+		fprintf(stderr, "tracedump: could not open %s\n", argv[1]);
+		return 1;
+	}
+
+	FILE* out = (argc == 3) ? fopen(argv[2], "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "tracedump: could not create %s\n", argv[2]);
+		return 1;
+	}
+
+	FileHeader header;
+	if (fread(&header, sizeof(header), 1, in) != 1 || header.magic != FileMagic)
+	{
+		fprintf(stderr, "tracedump: %s is not a binary trace\n", argv[1]);
+		return 1;
+	}
+	if (header.version > FileVersion)
+	{
+		fprintf(stderr, "tracedump: %s is version %u; this tool only reads up to %u\n", argv[1], header.version, FileVersion);
+		return 1;
+	}
+
+	std::vector<EventDef> events;
+	std::string line;
+	u8 record[MaxRecord];
+	u64 count = 0, bad = 0, dropped = 0;
+
+	RecordHeader rec;
+	while (fread(&rec, sizeof(rec), 1, in) == 1)
+	{
+		if (rec.size < sizeof(rec) || rec.size > MaxRecord || fread(record, rec.size - sizeof(rec), 1, in) != 1)
+		{
+			fprintf(stderr, "tracedump: truncated or corrupt record after %llu events\n", (unsigned long long)count);
+			break;
+		}
+
+		const u8* data = record;
+		const u8* end = record + rec.size - sizeof(rec);
+
+		switch (rec.type)
+		{
+			case Record_Define:
+			{
+				u32 id;
+				u8 counts[2];
+				u16 formatSize;
+				if (end - data < (ptrdiff_t)(DefineRecordSize - sizeof(rec))) { ++bad; break; }
+				memcpy(&id, data, 4);
+				memcpy(counts, data + 4, 2);
+				memcpy(&formatSize, data + 6, 2);
+				data += 8;
+
+				if (end - data != (ptrdiff_t)(counts[0] + counts[1] + formatSize)) { ++bad; break; }
+				if (id >= events.size()) events.resize(id + 1);
+
+				EventDef& def = events[id];
+				def.defined = true;
+				def.cpu = rec.cpu;
+				def.args.assign(data, data + counts[0]);
+				def.prefix.assign((const char*)data + counts[0], counts[1]);
+				def.format.assign((const char*)data + counts[0] + counts[1], formatSize);
+			}
+			break;
+
+			case Record_Event:
+			{
+				u32 id, pc, cycle;
+				if (end - data < (ptrdiff_t)(EventRecordSize - sizeof(rec))) { ++bad; break; }
+				memcpy(&id, data, 4);
+				memcpy(&pc, data + 4, 4);
+				memcpy(&cycle, data + 8, 4);
+				data += 12;
+
+				++count;
+				line.clear();
+
+				if (id >= events.size() || !events[id].defined)
+				{
+					fprintf(out, "<undefined trace event %u>\n", id);
+					++bad;
+					break;
+				}
+
+				const EventDef& def = events[id];
+				if (def.cpu != Cpu_None)
+				{
+					char prefix[64];
+					snprintf(prefix, sizeof(prefix), "%-4s(%08x %08x): ", def.prefix.c_str(), pc, cycle);
+					line = prefix;
+				}
+
+				ArgReader reader(data, end);
+				if (!FormatEvent(def, reader, line))
+				{
+					line += " <bad arguments>";
+					++bad;
+				}
+				fprintf(out, "%s\n", line.c_str());
+			}
+			break;
+
+			case Record_Dropped:
+			{
+				u32 lost;
+				if (end - data < 4) { ++bad; break; }
+				memcpy(&lost, data, 4);
+				fprintf(out, "*** %u trace records dropped ***\n", lost);
+				dropped += lost;
+			}
+			break;
+
+			default:
+				++bad;
+			break;
+		}
+	}
+
+	fprintf(stderr, "tracedump: %llu events, %llu dropped, %llu bad records\n",
+		(unsigned long long)count, (unsigned long long)dropped, (unsigned long long)bad);
+
+	fclose(in);
+	if (out != stdout) fclose(out);
+	return 0;
+}